@@ -76,6 +76,9 @@
 #include "crstrtgy.h"
 #include "engine.h"
 #include "envrnmnt.h"
+#if EVENT_TRACE_FUNCTIONS
+#include "evtrace.h"
+#endif
 #include "extnfunc.h"
 #include "memalloc.h"
 #include "moduldef.h"
@@ -201,6 +204,12 @@ void AddActivation(
      }
 #endif
 
+#if EVENT_TRACE_FUNCTIONS
+   if (EventTraceData(theEnv)->Tracing &&
+       (! ConstructData(theEnv)->ClearInProgress))
+     { RecordTraceEvent(theEnv,TRACE_ACTIVATE,(long long) newActivation->timetag,newActivation->theRule); }
+#endif
+
     /*=====================================*/
     /* Place the activation on the agenda. */
     /*=====================================*/
@@ -212,6 +221,71 @@ void AddActivation(
     PlaceActivation(theEnv,&(theModuleItem->agenda),newActivation,theGroup);
    }
 
+/*****************************************************************/
+/* RestoreActivation: Recreates an activation saved in a working */
+/*   memory snapshot. The salience, time tag and random ID of    */
+/*   the saved activation are kept and the activation is placed  */
+/*   at the end of its salience group, so restoring activations  */
+/*   in agenda order rebuilds the agenda without reapplying the  */
+/*   conflict resolution strategy.                               */
+/*****************************************************************/
+Activation *RestoreActivation(
+  Environment *theEnv,
+  Defrule *theRule,
+  PartialMatch *binds,
+  int salience,
+  unsigned long long timetag,
+  int randomID)
+  {
+   Activation *newActivation, *lastActivation;
+   struct defruleModule *theModuleItem;
+   struct salienceGroup *theGroup;
+
+   newActivation = get_struct(theEnv,activation);
+   newActivation->theRule = theRule;
+   newActivation->basis = binds;
+   newActivation->timetag = timetag;
+   newActivation->salience = salience;
+   newActivation->randomID = randomID;
+
+   AgendaData(theEnv)->NumberOfActivations++;
+   binds->marker = newActivation;
+
+   theModuleItem = (struct defruleModule *) theRule->header.whichModule;
+   theGroup = ReuseOrCreateSalienceGroup(theEnv,theModuleItem,salience);
+
+   if (theGroup->last != NULL)
+     { lastActivation = theGroup->last; }
+   else if (theGroup->prev != NULL)
+     { lastActivation = theGroup->prev->last; }
+   else
+     { lastActivation = NULL; }
+
+   if (lastActivation == NULL)
+     {
+      newActivation->prev = NULL;
+      newActivation->next = theModuleItem->agenda;
+      theModuleItem->agenda = newActivation;
+     }
+   else
+     {
+      newActivation->prev = lastActivation;
+      newActivation->next = lastActivation->next;
+      lastActivation->next = newActivation;
+     }
+
+   if (newActivation->next != NULL)
+     { newActivation->next->prev = newActivation; }
+
+   if (theGroup->first == NULL)
+     { theGroup->first = newActivation; }
+   theGroup->last = newActivation;
+
+   AgendaData(theEnv)->AgendaChanged = true;
+
+   return newActivation;
+  }
+
 /*******************************/
 /* ReuseOrCreateSalienceGroup: */
 /*******************************/
@@ -694,6 +768,12 @@ void RemoveActivation(
         }
 #endif
 
+#if EVENT_TRACE_FUNCTIONS
+      if (EventTraceData(theEnv)->Tracing &&
+          (! ConstructData(theEnv)->ClearInProgress))
+        { RecordTraceEvent(theEnv,TRACE_DEACTIVATE,(long long) theActivation->timetag,theActivation->theRule); }
+#endif
+
       /*=============================*/
       /* Mark the agenda as changed. */
       /*=============================*/
@@ -127,19 +127,12 @@ bool Bload(
   Environment *theEnv,
   const char *fileName)
   {
-   unsigned long numberOfFunctions;
-   unsigned long space;
-   bool error;
-   char IDbuffer[20];
-   char sizesBuffer[20];
-   char constructBuffer[CONSTRUCT_HEADER_SIZE];
-   struct BinaryItem *biPtr;
-   struct voidCallFunctionItem *bfPtr;
-   
+   bool rv;
+
    /*=====================================*/
    /* If embedded, clear the error flags. */
    /*=====================================*/
-   
+
    if (EvaluationData(theEnv)->CurrentExpression == NULL)
      { ResetErrorFlags(theEnv); }
 
@@ -153,6 +146,69 @@ bool Bload(
       return false;
      }
 
+   rv = BloadOpenedBinary(theEnv,fileName);
+   GenCloseBinary(theEnv);
+
+   return rv;
+  }
+
+/**********************************************************/
+/* BloadImage: C access routine for loading a binary      */
+/*   image created by the bsave command which is already  */
+/*   in memory, such as a flash partition mapped into the */
+/*   address space. The image is only read during the     */
+/*   call and can be unmapped once it returns.            */
+/**********************************************************/
+bool BloadImage(
+  Environment *theEnv,
+  const void *theImage,
+  size_t imageSize)
+  {
+   bool rv;
+
+   /*=====================================*/
+   /* If embedded, clear the error flags. */
+   /*=====================================*/
+
+   if (EvaluationData(theEnv)->CurrentExpression == NULL)
+     { ResetErrorFlags(theEnv); }
+
+   /*=================*/
+   /* Open the image. */
+   /*=================*/
+
+   if (GenOpenReadBinaryImage(theEnv,theImage,imageSize) == false)
+     {
+      OpenErrorMessage(theEnv,"bload","<image>");
+      return false;
+     }
+
+   rv = BloadOpenedBinary(theEnv,"<image>");
+   GenCloseBinary(theEnv);
+
+   return rv;
+  }
+
+/**********************************************************/
+/* BloadOpenedBinary: Loads the constructs from a binary  */
+/*   file or image opened with GenOpenReadBinary or       */
+/*   GenOpenReadBinaryImage. The binary file is left open */
+/*   so that the caller can read any data which follows   */
+/*   the constructs (such as a working memory snapshot).  */
+/**********************************************************/
+bool BloadOpenedBinary(
+  Environment *theEnv,
+  const char *fileName)
+  {
+   unsigned long numberOfFunctions;
+   unsigned long space;
+   bool error;
+   char IDbuffer[20];
+   char sizesBuffer[20];
+   char constructBuffer[CONSTRUCT_HEADER_SIZE];
+   struct BinaryItem *biPtr;
+   struct voidCallFunctionItem *bfPtr;
+
    /*=====================================*/
    /* Determine if this is a binary file. */
    /*=====================================*/
@@ -164,7 +220,6 @@ bool Bload(
       WriteString(theEnv,STDERR,"File '");
       WriteString(theEnv,STDERR,fileName);
       WriteString(theEnv,STDERR,"' is not a binary construct file.\n");
-      GenCloseBinary(theEnv);
       return false;
      }
 
@@ -180,7 +235,6 @@ bool Bload(
       WriteString(theEnv,STDERR,"File '");
       WriteString(theEnv,STDERR,fileName);
       WriteString(theEnv,STDERR,"' is an incompatible binary construct file.\n");
-      GenCloseBinary(theEnv);
       return false;
      }
 
@@ -196,7 +250,6 @@ bool Bload(
       WriteString(theEnv,STDERR,"File '");
       WriteString(theEnv,STDERR,fileName);
       WriteString(theEnv,STDERR,"' is an incompatible binary construct file.\n");
-      GenCloseBinary(theEnv);
       return false;
      }
 
@@ -207,10 +260,7 @@ bool Bload(
    if (BloadData(theEnv)->BloadActive)
      {
       if (ClearBload(theEnv) == false)
-        {
-         GenCloseBinary(theEnv);
-         return false;
-        }
+        { return false; }
      }
 
    /*=================================*/
@@ -220,7 +270,6 @@ bool Bload(
 
    if (ClearReady(theEnv) == false)
      {
-      GenCloseBinary(theEnv);
       PrintErrorID(theEnv,"BLOAD",4,false);
       WriteString(theEnv,STDERR,"The ");
       WriteString(theEnv,STDERR,APPLICATION_NAME);
@@ -249,7 +298,6 @@ bool Bload(
    BloadData(theEnv)->FunctionArray = ReadNeededFunctions(theEnv,&numberOfFunctions,&error);
    if (error)
      {
-      GenCloseBinary(theEnv);
       AbortBload(theEnv);
       return false;
      }
@@ -375,12 +423,6 @@ bool Bload(
         }
      }
 
-   /*=================*/
-   /* Close the file. */
-   /*=================*/
-
-   GenCloseBinary(theEnv);
-
    /*========================================*/
    /* Free up temporary storage used for the */
    /* function and atomic value information. */
@@ -448,6 +490,20 @@ void BloadandRefresh(
 
    if (objcnt == 0L) return;
 
+   /*===================================================*/
+   /* If the binary file is in memory, the objects are  */
+   /* refreshed directly from the image without copying */
+   /* them to a temporary buffer.                       */
+   /*===================================================*/
+
+   buf = (char *) GenReadBinaryInPlace(theEnv,objcnt * objsz,BLOAD_IMAGE_ALIGNMENT);
+   if (buf != NULL)
+     {
+      for (i = 0L ; i < objcnt ; i++)
+        (*objupdate)(theEnv,buf + objsz * i,i);
+      return;
+     }
+
    oldOutOfMemoryFunction = SetOutOfMemoryFunction(theEnv,BloadOutOfMemoryFunction);
    objsmaxread = objcnt;
    do
@@ -493,7 +549,8 @@ static struct functionDefinition **ReadNeededFunctions(
   unsigned long *numberOfFunctions,
   bool *error)
   {
-   char *functionNames, *namePtr;
+   char *functionNames;
+   const char *imageNames, *namePtr;
    unsigned long space;
    size_t temp;
    unsigned long i;
@@ -517,8 +574,15 @@ static struct functionDefinition **ReadNeededFunctions(
    /* Allocate area for strings to be read. */
    /*=======================================*/
 
-   functionNames = (char *) genalloc(theEnv,space);
-   GenReadBinary(theEnv,functionNames,space);
+   imageNames = (const char *) GenReadBinaryInPlace(theEnv,space,1);
+   if (imageNames != NULL)
+     { functionNames = NULL; }
+   else
+     {
+      functionNames = (char *) genalloc(theEnv,space);
+      GenReadBinary(theEnv,functionNames,space);
+      imageNames = functionNames;
+     }
 
    /*====================================================*/
    /* Store the function pointers in the function array. */
@@ -526,7 +590,7 @@ static struct functionDefinition **ReadNeededFunctions(
 
    temp = sizeof(struct functionDefinition *) * *numberOfFunctions;
    newFunctionArray = (struct functionDefinition **) genalloc(theEnv,temp);
-   namePtr = functionNames;
+   namePtr = imageNames;
    functionPtr = NULL;
    for (i = 0; i < *numberOfFunctions; i++)
      {
@@ -553,7 +617,8 @@ static struct functionDefinition **ReadNeededFunctions(
    /* Free the memory used by the name buffer. */
    /*==========================================*/
 
-   genfree(theEnv,functionNames,space);
+   if (functionNames != NULL)
+     { genfree(theEnv,functionNames,space); }
 
    /*==================================================*/
    /* If any of the required functions were not found, */
@@ -55,6 +55,7 @@
 
 #include "argacces.h"
 #include "bload.h"
+#include "cstrcpsr.h"
 #include "cstrnbin.h"
 #include "envrnmnt.h"
 #include "exprnpsr.h"
@@ -63,6 +64,7 @@
 #include "prntutil.h"
 #include "router.h"
 #include "symblbin.h"
+#include "symbol.h"
 
 #include "bsave.h"
 
@@ -148,9 +150,6 @@ bool Bsave(
   const char *fileName)
   {
    FILE *fp;
-   struct BinaryItem *biPtr;
-   char constructBuffer[CONSTRUCT_HEADER_SIZE];
-   unsigned long saveExpressionCount;
    
    /*=====================================*/
    /* If embedded, clear the error flags. */
@@ -172,6 +171,22 @@ bool Bsave(
       return false;
      }
 
+   /*===========================================*/
+   /* The atoms of a shared base layer can't be */
+   /* marked and renumbered for the save.       */
+   /*===========================================*/
+
+   if (SharedAtomBaseError(theEnv,"bsave"))
+     { return false; }
+
+   /*=================================================*/
+   /* The actions of constructs loaded in lazy mode   */
+   /* which have not been called yet must be parsed.  */
+   /*=================================================*/
+
+   if (! ParseLazyConstructs(theEnv))
+     { return false; }
+
    /*================*/
    /* Open the file. */
    /*================*/
@@ -182,6 +197,36 @@ bool Bsave(
       return false;
      }
 
+   /*=============================*/
+   /* Save the constructs to the  */
+   /* file and then close it.     */
+   /*=============================*/
+
+   BsaveOpenedBinary(theEnv,fp);
+
+   GenClose(theEnv,fp);
+
+   /*==================================*/
+   /* Return true to indicate success. */
+   /*==================================*/
+
+   return true;
+  }
+
+/**********************************************************/
+/* BsaveOpenedBinary: Writes the binary image of the      */
+/*   constructs to a file which has already been opened.  */
+/*   The file is left open so that other data (such as a  */
+/*   working memory snapshot) can follow the image.       */
+/**********************************************************/
+void BsaveOpenedBinary(
+  Environment *theEnv,
+  FILE *fp)
+  {
+   struct BinaryItem *biPtr;
+   char constructBuffer[CONSTRUCT_HEADER_SIZE];
+   unsigned long saveExpressionCount;
+
    /*==============================*/
    /* Remember the current module. */
    /*==============================*/
@@ -288,23 +333,11 @@ bool Bsave(
 
    RestoreAtomicValueBuckets(theEnv);
 
-   /*=================*/
-   /* Close the file. */
-   /*=================*/
-
-   GenClose(theEnv,fp);
-
    /*=============================*/
    /* Restore the current module. */
    /*=============================*/
 
    RestoreCurrentModule(theEnv);
-
-   /*==================================*/
-   /* Return true to indicate success. */
-   /*==================================*/
-
-   return true;
   }
 
 /*********************************************/
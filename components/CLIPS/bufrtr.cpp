@@ -0,0 +1,901 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*               BUFFERED ROUTER MODULE                */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Output routers which collect the fragments       */
+/*   written to them in a ring buffer and pass them to a     */
+/*   sink function in bulk.                                  */
+/*                                                           */
+/*   Pretty printing and the watch output write many short   */
+/*   fragments, often a single character, and on a serial    */
+/*   link each one becomes a separate driver call. The       */
+/*   fragments are kept until a newline is written, the      */
+/*   buffer reaches a threshold, the prompt is printed, or   */
+/*   the oldest byte has waited longer than an interval. The */
+/*   sink may accept fewer bytes than it is given: with the  */
+/*   block policy it is allowed to wait for the host, with   */
+/*   the drop policy it must not, and the output which no    */
+/*   longer fits in the buffer is discarded.                 */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if BUFFERED_ROUTER_FUNCTIONS
+
+#if (LINUX || DARWIN) && (! defined(ESP_PLATFORM))
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+#define BUFFERED_FILE_SINK 1
+#else
+#define BUFFERED_FILE_SINK 0
+#endif
+
+#include "argacces.h"
+#include "envrnmnt.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "multifld.h"
+#include "prntutil.h"
+#include "router.h"
+#include "sysdep.h"
+#include "utility.h"
+
+#include "bufrtr.h"
+
+#define BUFFERED_FILE_PRIORITY 10
+
+struct bufferedRouter
+  {
+   char *name;
+   RouterQueryFunction *queryCallback;
+   BufferedSinkFunction *sinkCallback;
+   void *context;
+   char *buffer;
+   size_t capacity;
+   size_t head;
+   size_t count;
+   size_t threshold;
+   double interval;
+   double pendingSince;
+   double started;
+   bool flushOnNewline;
+   bool flushing;
+   BufferPolicy policy;
+   unsigned long long writes;
+   unsigned long long bytes;
+   unsigned long long sinkCalls;
+   unsigned long long dropped;
+   BufferedRouter *next;
+  };
+
+struct bufferedRouterData
+  {
+   BufferedRouter *ListOfBufferedRouters;
+  };
+
+#if BUFFERED_FILE_SINK
+struct bufferedFileSink
+  {
+   int fd;
+  };
+#endif
+
+#define BufferedRouterData(theEnv) ((struct bufferedRouterData *) GetEnvironmentData(theEnv,BUFFERED_ROUTER_DATA))
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    DeallocateBufferedRouterData(Environment *);
+   static void                    ReleaseBufferedRouter(Environment *,BufferedRouter *);
+   static bool                    QueryBufferedCallback(Environment *,const char *,void *);
+   static void                    WriteBufferedCallback(Environment *,const char *,const char *,void *);
+   static void                    ExitBufferedCallback(Environment *,int,void *);
+   static void                    PeriodicBufferedCallback(Environment *,void *);
+   static void                    AppendBufferedBytes(Environment *,BufferedRouter *,const char *,size_t);
+   static void                    SinkBufferedBytes(Environment *,BufferedRouter *,const char *,size_t);
+   static BufferedRouter         *BufferedRouterArgument(UDFContext *);
+   static bool                    PolicyArgument(UDFContext *,UDFValue *,BufferPolicy *);
+#if BUFFERED_FILE_SINK
+   static size_t                  FileSinkCallback(Environment *,const char *,size_t,bool,void *);
+#endif
+
+/*********************************************************/
+/* BufferedRouterCommandDefinitions: Initializes the     */
+/*   data and the commands used for buffered routers.    */
+/*********************************************************/
+void BufferedRouterCommandDefinitions(
+  Environment *theEnv)
+  {
+   AllocateEnvironmentData(theEnv,BUFFERED_ROUTER_DATA,sizeof(struct bufferedRouterData),DeallocateBufferedRouterData);
+
+#if ! RUN_TIME
+   AddUDF(theEnv,"buffered-output-stats","bm",1,1,"y",BufferedOutputStatsCommand,"BufferedOutputStatsCommand",NULL);
+   AddUDF(theEnv,"set-buffered-output-policy","y",2,2,"y",SetBufferedOutputPolicyCommand,"SetBufferedOutputPolicyCommand",NULL);
+#if BUFFERED_FILE_SINK
+   AddUDF(theEnv,"open-buffered-output","b",2,4,"*;y;sy;y;l",OpenBufferedOutputCommand,"OpenBufferedOutputCommand",NULL);
+   AddUDF(theEnv,"close-buffered-output","b",1,1,"y",CloseBufferedOutputCommand,"CloseBufferedOutputCommand",NULL);
+#endif
+#endif
+  }
+
+/*******************************************************/
+/* DeallocateBufferedRouterData: Deallocates the data  */
+/*   for buffered routers, passing any output still    */
+/*   in the buffers to the sinks.                      */
+/*******************************************************/
+static void DeallocateBufferedRouterData(
+  Environment *theEnv)
+  {
+   BufferedRouter *theRouter, *nextRouter;
+
+   for (theRouter = BufferedRouterData(theEnv)->ListOfBufferedRouters;
+        theRouter != NULL;
+        theRouter = nextRouter)
+     {
+      nextRouter = theRouter->next;
+      FlushBufferedRouter(theEnv,theRouter);
+      ReleaseBufferedRouter(theEnv,theRouter);
+     }
+  }
+
+/*********************************************************/
+/* AddBufferedRouter: Adds an output router which keeps  */
+/*   the output for the logical names recognized by the  */
+/*   query function in a buffer of the given capacity    */
+/*   and passes it to the sink function. A capacity of 0 */
+/*   passes each write to the sink as it is made.        */
+/*********************************************************/
+BufferedRouter *AddBufferedRouter(
+  Environment *theEnv,
+  const char *routerName,
+  int priority,
+  RouterQueryFunction *queryFunction,
+  BufferedSinkFunction *sinkFunction,
+  size_t capacity,
+  BufferPolicy policy,
+  void *context)
+  {
+   BufferedRouter *theRouter;
+
+   if ((sinkFunction == NULL) || (FindRouter(theEnv,routerName) != NULL))
+     { return NULL; }
+
+   theRouter = get_struct(theEnv,bufferedRouter);
+   memset(theRouter,0,sizeof(BufferedRouter));
+
+   theRouter->name = (char *) genalloc(theEnv,strlen(routerName) + 1);
+   genstrcpy(theRouter->name,routerName);
+   theRouter->queryCallback = queryFunction;
+   theRouter->sinkCallback = sinkFunction;
+   theRouter->context = context;
+   theRouter->capacity = capacity;
+   if (capacity > 0)
+     { theRouter->buffer = (char *) genalloc(theEnv,capacity); }
+   theRouter->threshold = (capacity + 1) / 2;
+   theRouter->interval = BUFFERED_ROUTER_INTERVAL / 1000.0;
+   theRouter->flushOnNewline = true;
+   theRouter->policy = policy;
+   theRouter->started = gentime();
+
+   if (! AddRouter(theEnv,routerName,priority,QueryBufferedCallback,WriteBufferedCallback,
+                   NULL,NULL,ExitBufferedCallback,theRouter))
+     {
+      ReleaseBufferedRouter(theEnv,theRouter);
+      return NULL;
+     }
+
+   /*==================================================*/
+   /* The interval is checked by a periodic function,  */
+   /* added along with the first buffered router.      */
+   /*==================================================*/
+
+   if (BufferedRouterData(theEnv)->ListOfBufferedRouters == NULL)
+     { AddPeriodicFunction(theEnv,"buffered-routers",PeriodicBufferedCallback,0,NULL); }
+
+   theRouter->next = BufferedRouterData(theEnv)->ListOfBufferedRouters;
+   BufferedRouterData(theEnv)->ListOfBufferedRouters = theRouter;
+
+   return theRouter;
+  }
+
+/*******************************************************/
+/* DeleteBufferedRouter: Flushes and removes a router  */
+/*   created with AddBufferedRouter.                   */
+/*******************************************************/
+bool DeleteBufferedRouter(
+  Environment *theEnv,
+  const char *routerName)
+  {
+   BufferedRouter *theRouter, *lastRouter = NULL;
+
+   for (theRouter = BufferedRouterData(theEnv)->ListOfBufferedRouters;
+        theRouter != NULL;
+        theRouter = theRouter->next)
+     {
+      if (strcmp(theRouter->name,routerName) == 0)
+        { break; }
+      lastRouter = theRouter;
+     }
+
+   if (theRouter == NULL)
+     { return false; }
+
+   FlushBufferedRouter(theEnv,theRouter);
+
+   if (lastRouter == NULL)
+     { BufferedRouterData(theEnv)->ListOfBufferedRouters = theRouter->next; }
+   else
+     { lastRouter->next = theRouter->next; }
+
+   if (BufferedRouterData(theEnv)->ListOfBufferedRouters == NULL)
+     { RemovePeriodicFunction(theEnv,"buffered-routers"); }
+
+   DeleteRouter(theEnv,routerName);
+   ReleaseBufferedRouter(theEnv,theRouter);
+
+   return true;
+  }
+
+/*******************************************************/
+/* ReleaseBufferedRouter: Returns the memory used by a */
+/*   buffered router (and closes the file of a router  */
+/*   created with open-buffered-output).               */
+/*******************************************************/
+static void ReleaseBufferedRouter(
+  Environment *theEnv,
+  BufferedRouter *theRouter)
+  {
+#if BUFFERED_FILE_SINK
+   if (theRouter->sinkCallback == FileSinkCallback)
+     {
+      close(((struct bufferedFileSink *) theRouter->context)->fd);
+      genfree(theEnv,theRouter->context,sizeof(struct bufferedFileSink));
+     }
+#endif
+
+   if (theRouter->buffer != NULL)
+     { genfree(theEnv,theRouter->buffer,theRouter->capacity); }
+
+   genfree(theEnv,theRouter->name,strlen(theRouter->name) + 1);
+   rtn_struct(theEnv,bufferedRouter,theRouter);
+  }
+
+/****************************************************/
+/* FindBufferedRouter: Returns the buffered router  */
+/*   with the specified name.                       */
+/****************************************************/
+BufferedRouter *FindBufferedRouter(
+  Environment *theEnv,
+  const char *routerName)
+  {
+   BufferedRouter *theRouter;
+
+   for (theRouter = BufferedRouterData(theEnv)->ListOfBufferedRouters;
+        theRouter != NULL;
+        theRouter = theRouter->next)
+     {
+      if (strcmp(theRouter->name,routerName) == 0)
+        { return theRouter; }
+     }
+
+   return NULL;
+  }
+
+/**************************************************************/
+/* SetBufferedRouterFlush: Sets when the output of a buffered */
+/*   router is passed to its sink: when a newline is written, */
+/*   when the number of bytes buffered reaches the threshold  */
+/*   (0 for a full buffer), and when the oldest byte has been */
+/*   buffered for the interval in milliseconds (negative to   */
+/*   only flush for the other reasons).                       */
+/**************************************************************/
+void SetBufferedRouterFlush(
+  BufferedRouter *theRouter,
+  bool onNewline,
+  size_t threshold,
+  long interval)
+  {
+   theRouter->flushOnNewline = onNewline;
+
+   if ((threshold == 0) || (threshold > theRouter->capacity))
+     { theRouter->threshold = theRouter->capacity; }
+   else
+     { theRouter->threshold = threshold; }
+
+   if (interval < 0)
+     { theRouter->interval = -1.0; }
+   else
+     { theRouter->interval = interval / 1000.0; }
+  }
+
+/***********************************************************/
+/* SetBufferedRouterPolicy: Sets whether the sink may wait */
+/*   for the output to be accepted, returning the old      */
+/*   policy.                                               */
+/***********************************************************/
+BufferPolicy SetBufferedRouterPolicy(
+  BufferedRouter *theRouter,
+  BufferPolicy policy)
+  {
+   BufferPolicy oldPolicy = theRouter->policy;
+
+   theRouter->policy = policy;
+
+   return oldPolicy;
+  }
+
+/***********************************************************/
+/* GetBufferedRouterStats: Returns the number of writes    */
+/*   made to a buffered router, the bytes and the calls    */
+/*   passed to its sink, the bytes dropped, and the        */
+/*   seconds elapsed since the router was added.           */
+/***********************************************************/
+void GetBufferedRouterStats(
+  BufferedRouter *theRouter,
+  BufferedRouterStats *theStats)
+  {
+   theStats->writes = theRouter->writes;
+   theStats->bytes = theRouter->bytes;
+   theStats->sinkCalls = theRouter->sinkCalls;
+   theStats->dropped = theRouter->dropped;
+   theStats->seconds = gentime() - theRouter->started;
+  }
+
+/************************************************************/
+/* FlushBufferedRouter: Passes the buffered output of a     */
+/*   router to its sink. Returns true if the sink accepted  */
+/*   all of it.                                             */
+/************************************************************/
+bool FlushBufferedRouter(
+  Environment *theEnv,
+  BufferedRouter *theRouter)
+  {
+   size_t length, written;
+
+   /*==================================================*/
+   /* A sink writing to its own router only adds the   */
+   /* output to the buffer.                            */
+   /*==================================================*/
+
+   if (theRouter->flushing)
+     { return false; }
+
+   theRouter->flushing = true;
+
+   while (theRouter->count > 0)
+     {
+      length = theRouter->capacity - theRouter->head;
+      if (length > theRouter->count)
+        { length = theRouter->count; }
+
+      written = (*theRouter->sinkCallback)(theEnv,theRouter->buffer + theRouter->head,length,
+                                           (theRouter->policy == BUFFER_BLOCK),theRouter->context);
+      theRouter->sinkCalls++;
+
+      if (written > length)
+        { written = length; }
+
+      theRouter->bytes += written;
+      theRouter->head = (theRouter->head + written) % theRouter->capacity;
+      theRouter->count -= written;
+
+      if ((written == 0) ||
+          ((written < length) && (theRouter->policy == BUFFER_DROP)))
+        { break; }
+     }
+
+   theRouter->flushing = false;
+
+   /*=================================================*/
+   /* Output the sink didn't accept is tried again    */
+   /* after another interval or the next flush.       */
+   /*=================================================*/
+
+   if (theRouter->count == 0)
+     {
+      theRouter->head = 0;
+      return true;
+     }
+
+   theRouter->pendingSince = gentime();
+   return false;
+  }
+
+/************************************************************/
+/* FlushBufferedOutput: Flushes the buffered routers which  */
+/*   recognize a logical name. Returns true if one of them  */
+/*   does and all of its output was accepted.               */
+/************************************************************/
+bool FlushBufferedOutput(
+  Environment *theEnv,
+  const char *logicalName)
+  {
+   BufferedRouter *theRouter;
+   bool rv = false;
+
+   for (theRouter = BufferedRouterData(theEnv)->ListOfBufferedRouters;
+        theRouter != NULL;
+        theRouter = theRouter->next)
+     {
+      if (QueryBufferedCallback(theEnv,logicalName,theRouter))
+        {
+         if (FlushBufferedRouter(theEnv,theRouter))
+           { rv = true; }
+        }
+     }
+
+   return rv;
+  }
+
+/**************************************************************/
+/* FlushAllBufferedRouters: Flushes every buffered router. It */
+/*   can be passed to SetAfterPromptFunction so the output is */
+/*   flushed each time the prompt is printed.                 */
+/**************************************************************/
+void FlushAllBufferedRouters(
+  Environment *theEnv)
+  {
+   BufferedRouter *theRouter;
+
+   for (theRouter = BufferedRouterData(theEnv)->ListOfBufferedRouters;
+        theRouter != NULL;
+        theRouter = theRouter->next)
+     { FlushBufferedRouter(theEnv,theRouter); }
+  }
+
+/**************************************************************/
+/* PollBufferedRouters: Flushes the buffered routers whose    */
+/*   oldest byte has been buffered longer than the interval.  */
+/*   Called by the periodic functions while rules are running */
+/*   and meant to be called by the main loop when idle.       */
+/**************************************************************/
+void PollBufferedRouters(
+  Environment *theEnv)
+  {
+   BufferedRouter *theRouter;
+   double now = -1.0;
+
+   for (theRouter = BufferedRouterData(theEnv)->ListOfBufferedRouters;
+        theRouter != NULL;
+        theRouter = theRouter->next)
+     {
+      if ((theRouter->count == 0) || (theRouter->interval < 0.0))
+        { continue; }
+
+      if (now < 0.0)
+        { now = gentime(); }
+
+      if ((now - theRouter->pendingSince) >= theRouter->interval)
+        { FlushBufferedRouter(theEnv,theRouter); }
+     }
+  }
+
+/*******************************************************/
+/* PeriodicBufferedCallback: Periodic function polling */
+/*   the buffered routers.                             */
+/*******************************************************/
+static void PeriodicBufferedCallback(
+  Environment *theEnv,
+  void *context)
+  {
+#if MAC_XCD
+#pragma unused(context)
+#endif
+
+   PollBufferedRouters(theEnv);
+  }
+
+/**********************************************************/
+/* QueryBufferedCallback: Query callback for a buffered   */
+/*   router. Without a query function, the router only    */
+/*   recognizes its own name as a logical name.           */
+/**********************************************************/
+static bool QueryBufferedCallback(
+  Environment *theEnv,
+  const char *logicalName,
+  void *context)
+  {
+   BufferedRouter *theRouter = (BufferedRouter *) context;
+
+   if (theRouter->queryCallback == NULL)
+     { return (strcmp(logicalName,theRouter->name) == 0); }
+
+   return (*theRouter->queryCallback)(theEnv,logicalName,theRouter->context);
+  }
+
+/*******************************************************/
+/* WriteBufferedCallback: Write callback for a         */
+/*   buffered router.                                  */
+/*******************************************************/
+static void WriteBufferedCallback(
+  Environment *theEnv,
+  const char *logicalName,
+  const char *str,
+  void *context)
+  {
+#if MAC_XCD
+#pragma unused(logicalName)
+#endif
+   BufferedRouter *theRouter = (BufferedRouter *) context;
+   size_t length = strlen(str);
+
+   theRouter->writes++;
+
+   if (length == 0)
+     { return; }
+
+   if (theRouter->capacity == 0)
+     {
+      SinkBufferedBytes(theEnv,theRouter,str,length);
+      return;
+     }
+
+   AppendBufferedBytes(theEnv,theRouter,str,length);
+
+   if ((theRouter->count >= theRouter->threshold) ||
+       (theRouter->flushOnNewline && (memchr(str,'\n',length) != NULL)))
+     { FlushBufferedRouter(theEnv,theRouter); }
+  }
+
+/*******************************************************/
+/* ExitBufferedCallback: Exit callback for a buffered  */
+/*   router.                                           */
+/*******************************************************/
+static void ExitBufferedCallback(
+  Environment *theEnv,
+  int num,
+  void *context)
+  {
+#if MAC_XCD
+#pragma unused(num)
+#endif
+
+   FlushBufferedRouter(theEnv,(BufferedRouter *) context);
+  }
+
+/*************************************************************/
+/* AppendBufferedBytes: Copies output into the ring buffer,  */
+/*   flushing it when it is full. The output which still     */
+/*   doesn't fit is dropped.                                 */
+/*************************************************************/
+static void AppendBufferedBytes(
+  Environment *theEnv,
+  BufferedRouter *theRouter,
+  const char *str,
+  size_t length)
+  {
+   size_t tail, room;
+
+   while (length > 0)
+     {
+      if (theRouter->count == theRouter->capacity)
+        {
+         FlushBufferedRouter(theEnv,theRouter);
+         if (theRouter->count == theRouter->capacity)
+           {
+            theRouter->dropped += length;
+            return;
+           }
+        }
+
+      if (theRouter->count == 0)
+        { theRouter->pendingSince = gentime(); }
+
+      tail = (theRouter->head + theRouter->count) % theRouter->capacity;
+
+      room = theRouter->capacity - tail;
+      if (room > (theRouter->capacity - theRouter->count))
+        { room = theRouter->capacity - theRouter->count; }
+      if (room > length)
+        { room = length; }
+
+      memcpy(theRouter->buffer + tail,str,room);
+      theRouter->count += room;
+      str += room;
+      length -= room;
+     }
+  }
+
+/**********************************************************/
+/* SinkBufferedBytes: Passes a write directly to the sink */
+/*   of a router without a buffer.                        */
+/**********************************************************/
+static void SinkBufferedBytes(
+  Environment *theEnv,
+  BufferedRouter *theRouter,
+  const char *str,
+  size_t length)
+  {
+   size_t written;
+
+   while (length > 0)
+     {
+      written = (*theRouter->sinkCallback)(theEnv,str,length,
+                                           (theRouter->policy == BUFFER_BLOCK),theRouter->context);
+      theRouter->sinkCalls++;
+
+      if (written > length)
+        { written = length; }
+
+      theRouter->bytes += written;
+      str += written;
+      length -= written;
+
+      if ((written == 0) ||
+          ((length > 0) && (theRouter->policy == BUFFER_DROP)))
+        {
+         theRouter->dropped += length;
+         return;
+        }
+     }
+  }
+
+/**************************************************************/
+/* BufferedOutputStatsCommand: H/L access routine for the     */
+/*   buffered-output-stats command. Returns the writes, the   */
+/*   bytes and calls passed to the sink, the bytes dropped,   */
+/*   and the bytes and sink calls per second.                 */
+/**************************************************************/
+void BufferedOutputStatsCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   BufferedRouter *theRouter;
+   BufferedRouterStats theStats;
+   MultifieldBuilder *theMB;
+
+   theRouter = BufferedRouterArgument(context);
+   if (theRouter == NULL)
+     {
+      returnValue->lexemeValue = FalseSymbol(theEnv);
+      return;
+     }
+
+   GetBufferedRouterStats(theRouter,&theStats);
+   if (theStats.seconds <= 0.0)
+     { theStats.seconds = 1.0; }
+
+   theMB = CreateMultifieldBuilder(theEnv,6);
+   MBAppendInteger(theMB,(long long) theStats.writes);
+   MBAppendInteger(theMB,(long long) theStats.bytes);
+   MBAppendInteger(theMB,(long long) theStats.sinkCalls);
+   MBAppendInteger(theMB,(long long) theStats.dropped);
+   MBAppendFloat(theMB,theStats.bytes / theStats.seconds);
+   MBAppendFloat(theMB,theStats.sinkCalls / theStats.seconds);
+   returnValue->multifieldValue = MBCreate(theMB);
+   MBDispose(theMB);
+  }
+
+/*****************************************************************/
+/* SetBufferedOutputPolicyCommand: H/L access routine for the    */
+/*   set-buffered-output-policy command. Returns the old policy. */
+/*****************************************************************/
+void SetBufferedOutputPolicyCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   BufferedRouter *theRouter;
+   BufferPolicy policy;
+   UDFValue theArg;
+
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+
+   theRouter = BufferedRouterArgument(context);
+   if (theRouter == NULL)
+     { return; }
+
+   if (! PolicyArgument(context,&theArg,&policy))
+     { return; }
+
+   if (SetBufferedRouterPolicy(theRouter,policy) == BUFFER_BLOCK)
+     { returnValue->lexemeValue = CreateSymbol(theEnv,"block"); }
+   else
+     { returnValue->lexemeValue = CreateSymbol(theEnv,"drop"); }
+  }
+
+/*******************************************************/
+/* BufferedRouterArgument: Returns the buffered router */
+/*   named by the next argument of a command.          */
+/*******************************************************/
+static BufferedRouter *BufferedRouterArgument(
+  UDFContext *context)
+  {
+   Environment *theEnv = context->environment;
+   BufferedRouter *theRouter;
+   UDFValue theArg;
+
+   if (! UDFNextArgument(context,SYMBOL_BIT,&theArg))
+     { return NULL; }
+
+   theRouter = FindBufferedRouter(theEnv,theArg.lexemeValue->contents);
+   if (theRouter == NULL)
+     {
+      CantFindItemErrorMessage(theEnv,"buffered router",theArg.lexemeValue->contents,false);
+      SetEvaluationError(theEnv,true);
+      return NULL;
+     }
+
+   return theRouter;
+  }
+
+/*******************************************************/
+/* PolicyArgument: Converts the next argument of a     */
+/*   command to a buffer policy.                       */
+/*******************************************************/
+static bool PolicyArgument(
+  UDFContext *context,
+  UDFValue *theArg,
+  BufferPolicy *policy)
+  {
+   if (! UDFNextArgument(context,SYMBOL_BIT,theArg))
+     { return false; }
+
+   if (strcmp(theArg->lexemeValue->contents,"block") == 0)
+     { *policy = BUFFER_BLOCK; }
+   else if (strcmp(theArg->lexemeValue->contents,"drop") == 0)
+     { *policy = BUFFER_DROP; }
+   else
+     {
+      UDFInvalidArgumentMessage(context,"symbol with value block or drop");
+      return false;
+     }
+
+   return true;
+  }
+
+#if BUFFERED_FILE_SINK
+
+/**************************************************************/
+/* OpenBufferedOutputCommand: H/L access routine for the      */
+/*   open-buffered-output command. Adds a buffered router for */
+/*   the logical name which writes to a file, standing in for */
+/*   the serial link when measuring the output rates.         */
+/**************************************************************/
+void OpenBufferedOutputCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   const char *logicalName, *fileName;
+   BufferPolicy policy = BUFFER_BLOCK;
+   long long capacity = BUFFERED_ROUTER_CAPACITY;
+   struct bufferedFileSink *theSink;
+   int fd;
+
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+
+   if (! UDFFirstArgument(context,SYMBOL_BIT,&theArg))
+     { return; }
+   logicalName = theArg.lexemeValue->contents;
+
+   if (! UDFNextArgument(context,LEXEME_BITS,&theArg))
+     { return; }
+   fileName = theArg.lexemeValue->contents;
+
+   if (UDFHasNextArgument(context))
+     {
+      if (! PolicyArgument(context,&theArg,&policy))
+        { return; }
+     }
+
+   if (UDFHasNextArgument(context))
+     {
+      if (! UDFNextArgument(context,INTEGER_BIT,&theArg))
+        { return; }
+
+      capacity = theArg.integerValue->contents;
+      if (capacity < 0)
+        {
+         UDFInvalidArgumentMessage(context,"integer greater than or equal to 0");
+         return;
+        }
+     }
+
+   if (FindRouter(theEnv,logicalName) != NULL)
+     { return; }
+
+   fd = open(fileName,O_WRONLY | O_CREAT | O_TRUNC,0644);
+   if (fd < 0)
+     {
+      OpenErrorMessage(theEnv,"open-buffered-output",fileName);
+      return;
+     }
+
+   theSink = (struct bufferedFileSink *) genalloc(theEnv,sizeof(struct bufferedFileSink));
+   theSink->fd = fd;
+
+   if (AddBufferedRouter(theEnv,logicalName,BUFFERED_FILE_PRIORITY,NULL,FileSinkCallback,
+                         (size_t) capacity,policy,theSink) == NULL)
+     {
+      close(fd);
+      genfree(theEnv,theSink,sizeof(struct bufferedFileSink));
+      return;
+     }
+
+   returnValue->lexemeValue = TrueSymbol(theEnv);
+  }
+
+/*************************************************************/
+/* CloseBufferedOutputCommand: H/L access routine for the    */
+/*   close-buffered-output command.                          */
+/*************************************************************/
+void CloseBufferedOutputCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   BufferedRouter *theRouter;
+
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+
+   theRouter = BufferedRouterArgument(context);
+   if ((theRouter == NULL) || (theRouter->sinkCallback != FileSinkCallback))
+     { return; }
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,DeleteBufferedRouter(theEnv,theRouter->name));
+  }
+
+/**************************************************************/
+/* FileSinkCallback: Sink of the routers added by the         */
+/*   open-buffered-output command. When it may not block, it  */
+/*   only writes if the file is ready, and no more than the   */
+/*   amount a pipe accepts at once.                           */
+/**************************************************************/
+static size_t FileSinkCallback(
+  Environment *theEnv,
+  const char *buffer,
+  size_t length,
+  bool mayBlock,
+  void *context)
+  {
+#if MAC_XCD
+#pragma unused(theEnv)
+#endif
+   struct bufferedFileSink *theSink = (struct bufferedFileSink *) context;
+   struct pollfd thePoll;
+   ssize_t written;
+
+   if (! mayBlock)
+     {
+      thePoll.fd = theSink->fd;
+      thePoll.events = POLLOUT;
+      thePoll.revents = 0;
+
+      if ((poll(&thePoll,1,0) <= 0) || ((thePoll.revents & POLLOUT) == 0))
+        { return 0; }
+
+      if (length > PIPE_BUF)
+        { length = PIPE_BUF; }
+     }
+
+   written = write(theSink->fd,buffer,length);
+   if (written < 0)
+     { return 0; }
+
+   return (size_t) written;
+  }
+
+#endif /* BUFFERED_FILE_SINK */
+
+#endif /* BUFFERED_ROUTER_FUNCTIONS */
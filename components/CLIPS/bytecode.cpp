@@ -0,0 +1,1216 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                   BYTECODE MODULE                   */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Compiles the actions of deffunctions, methods,   */
+/*   message-handlers and the right hand side of rules into  */
+/*   a compact instruction sequence which is run by a small  */
+/*   stack machine instead of walking the expression tree.   */
+/*                                                           */
+/*   The actions are compiled the first time they run and    */
+/*   the program is attached to the construct as user data,  */
+/*   so it is discarded along with the construct. The        */
+/*   progn, if and while functions and the binding of local  */
+/*   variables become jumps and stores in the program. The   */
+/*   basic arithmetic, comparison, eq, neq and not functions */
+/*   applied to constants, parameters and local variables    */
+/*   form pure expressions which are computed on a stack     */
+/*   without creating the intermediate numbers. Every other  */
+/*   function call is evaluated by the interpreter, which    */
+/*   remains the reference for the behavior of the machine.  */
+/*                                                           */
+/*   A pure expression has no side effects until its value   */
+/*   is stored, so when one of its arguments has the wrong   */
+/*   type, a local variable is unbound or a division by zero */
+/*   is attempted, the machine abandons it and hands the     */
+/*   whole expression to the interpreter, which then reports */
+/*   the error exactly as it would have otherwise.           */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if EXPRESSION_BYTECODE
+
+#include "argacces.h"
+#include "bmathfun.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "prccode.h"
+#include "prcdrfun.h"
+#include "prdctfun.h"
+#if PROFILING_FUNCTIONS
+#include "proflfun.h"
+#endif
+#include "utility.h"
+
+#include "bytecode.h"
+
+#define NO_JUMP UINT32_MAX
+
+/*======================================================*/
+/* The functions computed directly in pure expressions. */
+/* A maximum of zero allows any number of arguments,    */
+/* which are combined from left to right.               */
+/*======================================================*/
+
+struct bytecodeFunction
+  {
+   void (*functionPointer)(Environment *,UDFContext *,UDFValue *);
+   BytecodeOperation operation;
+   unsigned short minimum;
+   unsigned short maximum;
+  };
+
+static const struct bytecodeFunction BytecodeFunctions[] =
+  {
+   { AdditionFunction, BC_ADD, 2, 0 },
+   { SubtractionFunction, BC_SUBTRACT, 2, 0 },
+   { MultiplicationFunction, BC_MULTIPLY, 2, 0 },
+   { DivisionFunction, BC_DIVIDE, 2, 0 },
+   { NumericEqualFunction, BC_NUMERIC_EQUAL, 2, 2 },
+   { NumericNotEqualFunction, BC_NUMERIC_NOT_EQUAL, 2, 2 },
+   { LessThanFunction, BC_LESS_THAN, 2, 2 },
+   { LessThanOrEqualFunction, BC_LESS_THAN_OR_EQUAL, 2, 2 },
+   { GreaterThanFunction, BC_GREATER_THAN, 2, 2 },
+   { GreaterThanOrEqualFunction, BC_GREATER_THAN_OR_EQUAL, 2, 2 },
+   { EqFunction, BC_EQ, 2, 2 },
+   { NeqFunction, BC_NEQ, 2, 2 },
+   { NotFunction, BC_NOT, 1, 1 }
+  };
+
+struct bytecodeCompiler
+  {
+   struct bytecodeInstruction *code;
+   unsigned int length;
+   unsigned int capacity;
+   unsigned int depth;
+   unsigned short loops;
+   bool direct;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                   *CreateBytecodeProgram(Environment *);
+   static void                    DeleteBytecodeProgram(Environment *,void *);
+   static void                    CompileBytecode(Environment *,struct bytecodeProgram *,Expression *);
+   static unsigned int            EmitInstruction(Environment *,struct bytecodeCompiler *,BytecodeOperation,
+                                                  unsigned int,Expression *,Expression *);
+   static void                    EmitJump(Environment *,struct bytecodeCompiler *,BytecodeOperation,
+                                           Expression *,unsigned int *);
+   static void                    PatchJumps(struct bytecodeCompiler *,unsigned int);
+   static bool                    ConstantArgument(Expression *);
+   static const struct bytecodeFunction
+                                 *FindBytecodeFunction(Expression *);
+   static void                    CompileAction(Environment *,struct bytecodeCompiler *,Expression *,Expression *);
+   static void                    CompileProgn(Environment *,struct bytecodeCompiler *,Expression *);
+   static void                    CompileIf(Environment *,struct bytecodeCompiler *,Expression *);
+   static void                    CompileWhile(Environment *,struct bytecodeCompiler *,Expression *);
+   static bool                    CompilePureAction(Environment *,struct bytecodeCompiler *,Expression *,Expression *);
+   static bool                    CompilePureExpression(Environment *,struct bytecodeCompiler *,Expression *);
+   static bool                    EmitPush(Environment *,struct bytecodeCompiler *,BytecodeOperation,
+                                           unsigned int,Expression *);
+   static void                    RunBytecode(Environment *,const struct bytecodeInstruction *,UDFValue *);
+   static bool                    LoadSlot(struct bytecodeSlot *,void *);
+   static bool                    CoerceSlots(struct bytecodeSlot *,struct bytecodeSlot *,double *,double *);
+   static bool                    SlotsEqual(Environment *,struct bytecodeSlot *,struct bytecodeSlot *);
+
+/*************************************************/
+/* BytecodeDefinitions: Initializes the bytecode */
+/*   compiler and its commands.                  */
+/*************************************************/
+void BytecodeDefinitions(
+  Environment *theEnv)
+  {
+   struct userDataRecord programDataInfo = { 0, CreateBytecodeProgram, DeleteBytecodeProgram };
+
+   AllocateEnvironmentData(theEnv,BYTECODE_DATA,sizeof(struct bytecodeData),NULL);
+
+   BytecodeData(theEnv)->Enabled = true;
+   memcpy(&BytecodeData(theEnv)->ProgramDataInfo,&programDataInfo,sizeof(struct userDataRecord));
+   BytecodeData(theEnv)->ProgramDataID = InstallUserDataRecord(theEnv,&BytecodeData(theEnv)->ProgramDataInfo);
+
+#if ! RUN_TIME
+   AddUDF(theEnv,"set-bytecode-execution","b",1,1,NULL,SetBytecodeExecutionCommand,"SetBytecodeExecutionCommand",NULL);
+   AddUDF(theEnv,"get-bytecode-execution","b",0,0,NULL,GetBytecodeExecutionCommand,"GetBytecodeExecutionCommand",NULL);
+#endif
+  }
+
+/**************************************************/
+/* CreateBytecodeProgram: Allocates an uncompiled */
+/*   program for a construct.                     */
+/**************************************************/
+static void *CreateBytecodeProgram(
+  Environment *theEnv)
+  {
+   struct bytecodeProgram *theProgram;
+
+   theProgram = (struct bytecodeProgram *) genalloc(theEnv,sizeof(struct bytecodeProgram));
+   memset(theProgram,0,sizeof(struct bytecodeProgram));
+
+   return theProgram;
+  }
+
+/****************************************************/
+/* DeleteBytecodeProgram: Returns the memory of the */
+/*   program compiled for a construct.              */
+/****************************************************/
+static void DeleteBytecodeProgram(
+  Environment *theEnv,
+  void *theData)
+  {
+   struct bytecodeProgram *theProgram = (struct bytecodeProgram *) theData;
+
+   if (theProgram->code != NULL)
+     { genfree(theEnv,theProgram->code,sizeof(struct bytecodeInstruction) * theProgram->length); }
+
+   genfree(theEnv,theProgram,sizeof(struct bytecodeProgram));
+  }
+
+/*********************************************************/
+/* EvaluateBytecode: Evaluates the actions of the        */
+/*   construct owning the user data list, compiling them */
+/*   the first time they are run. Returns the same value */
+/*   as EvaluateExpression.                              */
+/*********************************************************/
+bool EvaluateBytecode(
+  Environment *theEnv,
+  struct userData **theList,
+  Expression *actions,
+  UDFValue *returnValue)
+  {
+   struct bytecodeProgram *theProgram;
+
+   /*=====================================================*/
+   /* Function calls are only profiled by the interpreter */
+   /* so the machine steps aside while they are.          */
+   /*=====================================================*/
+
+   if ((! BytecodeData(theEnv)->Enabled) || (actions == NULL))
+     { return EvaluateExpression(theEnv,actions,returnValue); }
+
+#if PROFILING_FUNCTIONS
+   if (ProfileFunctionData(theEnv)->ProfileUserFunctions)
+     { return EvaluateExpression(theEnv,actions,returnValue); }
+#endif
+
+   theProgram = (struct bytecodeProgram *)
+                FetchUserData(theEnv,BytecodeData(theEnv)->ProgramDataID,theList);
+
+   if (theProgram->source != actions)
+     { CompileBytecode(theEnv,theProgram,actions); }
+
+   if (theProgram->code == NULL)
+     { return EvaluateExpression(theEnv,actions,returnValue); }
+
+   RunBytecode(theEnv,theProgram->code,returnValue);
+
+   return EvaluationData(theEnv)->EvaluationError;
+  }
+
+/******************************************************/
+/* DiscardBytecode: Removes the program compiled for  */
+/*   a construct whose actions are being replaced.    */
+/******************************************************/
+void DiscardBytecode(
+  Environment *theEnv,
+  struct userData **theList)
+  {
+   *theList = DeleteUserData(theEnv,BytecodeData(theEnv)->ProgramDataID,*theList);
+  }
+
+/************************************************************/
+/* CompileBytecode: Compiles the actions of a construct. If */
+/*   nothing in them can be run by the machine, no code is  */
+/*   kept and the interpreter evaluates them directly.      */
+/************************************************************/
+static void CompileBytecode(
+  Environment *theEnv,
+  struct bytecodeProgram *theProgram,
+  Expression *actions)
+  {
+   struct bytecodeCompiler theCompiler;
+
+   if (theProgram->code != NULL)
+     {
+      genfree(theEnv,theProgram->code,sizeof(struct bytecodeInstruction) * theProgram->length);
+      theProgram->code = NULL;
+      theProgram->length = 0;
+     }
+
+   theProgram->source = actions;
+
+   memset(&theCompiler,0,sizeof(struct bytecodeCompiler));
+   CompileAction(theEnv,&theCompiler,actions,NULL);
+   EmitInstruction(theEnv,&theCompiler,BC_RETURN,0,NULL,NULL);
+
+   if (theCompiler.direct)
+     {
+      theProgram->length = theCompiler.length;
+      theProgram->code = (struct bytecodeInstruction *)
+                         genalloc(theEnv,sizeof(struct bytecodeInstruction) * theCompiler.length);
+      memcpy(theProgram->code,theCompiler.code,sizeof(struct bytecodeInstruction) * theCompiler.length);
+     }
+
+   genfree(theEnv,theCompiler.code,sizeof(struct bytecodeInstruction) * theCompiler.capacity);
+  }
+
+/******************************************************/
+/* EmitInstruction: Appends an instruction to the     */
+/*   code being compiled and returns its index.       */
+/******************************************************/
+static unsigned int EmitInstruction(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  BytecodeOperation operation,
+  unsigned int operand,
+  Expression *node,
+  Expression *parent)
+  {
+   struct bytecodeInstruction *theInstruction;
+   unsigned int newCapacity;
+
+   if (theCompiler->length == theCompiler->capacity)
+     {
+      newCapacity = (theCompiler->capacity == 0) ? 16 : (theCompiler->capacity * 2);
+      theCompiler->code = (struct bytecodeInstruction *)
+                          genrealloc(theEnv,theCompiler->code,
+                                     sizeof(struct bytecodeInstruction) * theCompiler->capacity,
+                                     sizeof(struct bytecodeInstruction) * newCapacity);
+      theCompiler->capacity = newCapacity;
+     }
+
+   theInstruction = &theCompiler->code[theCompiler->length];
+   theInstruction->operation = (unsigned short) operation;
+   theInstruction->operand = operand;
+   theInstruction->node = node;
+   theInstruction->parent = parent;
+
+   return theCompiler->length++;
+  }
+
+/*********************************************************/
+/* EmitJump: Appends a jump whose target is not yet      */
+/*   known. The operands of the pending jumps to the     */
+/*   same target link them into a list until patched.    */
+/*********************************************************/
+static void EmitJump(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  BytecodeOperation operation,
+  Expression *node,
+  unsigned int *pending)
+  {
+   *pending = EmitInstruction(theEnv,theCompiler,operation,*pending,node,NULL);
+  }
+
+/********************************************************/
+/* PatchJumps: Points a list of pending jumps at the    */
+/*   next instruction to be emitted.                    */
+/********************************************************/
+static void PatchJumps(
+  struct bytecodeCompiler *theCompiler,
+  unsigned int pending)
+  {
+   unsigned int next;
+
+   while (pending != NO_JUMP)
+     {
+      next = theCompiler->code[pending].operand;
+      theCompiler->code[pending].operand = theCompiler->length;
+      pending = next;
+     }
+  }
+
+/********************************************************/
+/* ConstantArgument: Returns true for the argument      */
+/*   types which a function receives without their      */
+/*   being evaluated (and so without the evaluation     */
+/*   error being checked).                              */
+/********************************************************/
+static bool ConstantArgument(
+  Expression *theExpression)
+  {
+   switch (theExpression->type)
+     {
+      case INTEGER_TYPE:
+      case FLOAT_TYPE:
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+        return true;
+     }
+
+   return false;
+  }
+
+/********************************************************/
+/* FindBytecodeFunction: Returns the entry for a call   */
+/*   to a function computed in pure expressions.        */
+/********************************************************/
+static const struct bytecodeFunction *FindBytecodeFunction(
+  Expression *theExpression)
+  {
+   unsigned int i;
+
+   if (theExpression->type != FCALL)
+     { return NULL; }
+
+   for (i = 0 ; i < (sizeof(BytecodeFunctions) / sizeof(struct bytecodeFunction)) ; i++)
+     {
+      if (BytecodeFunctions[i].functionPointer == ExpressionFunctionPointer(theExpression))
+        { return &BytecodeFunctions[i]; }
+     }
+
+   return NULL;
+  }
+
+/*************************************************************/
+/* CompileAction: Compiles an expression whose value is left */
+/*   in the result of the machine. The parent is the call    */
+/*   which the interpreter would be executing at this point. */
+/*************************************************************/
+static void CompileAction(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  Expression *parent)
+  {
+   unsigned int argumentCount;
+
+   if (ConstantArgument(theExpression))
+     {
+      EmitInstruction(theEnv,theCompiler,BC_CONSTANT,0,theExpression,parent);
+      return;
+     }
+
+   if (theExpression->type == FCALL)
+     {
+      argumentCount = CountArguments(theExpression->argList);
+
+      if (ExpressionFunctionPointer(theExpression) == PrognFunction)
+        {
+         CompileProgn(theEnv,theCompiler,theExpression);
+         return;
+        }
+
+      if ((ExpressionFunctionPointer(theExpression) == IfFunction) &&
+          ((argumentCount == 2) || (argumentCount == 3)))
+        {
+         CompileIf(theEnv,theCompiler,theExpression);
+         return;
+        }
+
+      if ((ExpressionFunctionPointer(theExpression) == WhileFunction) &&
+          (argumentCount == 2) &&
+          (theCompiler->loops < BYTECODE_LOOP_DEPTH))
+        {
+         CompileWhile(theEnv,theCompiler,theExpression);
+         return;
+        }
+
+      if (CompilePureAction(theEnv,theCompiler,theExpression,parent))
+        { return; }
+     }
+
+   /*===========================================*/
+   /* A bind of a local variable to one value   */
+   /* stores the value computed by its argument */
+   /* (see PutProcBind).                        */
+   /*===========================================*/
+
+   else if ((theExpression->type == PROC_BIND) &&
+            (theExpression->argList != NULL) &&
+            (theExpression->argList->nextArg == NULL))
+     {
+      CompileAction(theEnv,theCompiler,theExpression->argList,theExpression);
+      EmitInstruction(theEnv,theCompiler,BC_STORE_LOCAL,
+                      (unsigned int) (*((const int *) theExpression->bitMapValue->contents) - 1),
+                      theExpression,parent);
+      theCompiler->direct = true;
+      return;
+     }
+
+   EmitInstruction(theEnv,theCompiler,BC_EVALUATE,0,theExpression,parent);
+  }
+
+/*******************************************************/
+/* CompileProgn: Compiles a progn call. The halt check */
+/*   precedes each action and the break and return     */
+/*   check follows it (see PrognFunction).             */
+/*******************************************************/
+static void CompileProgn(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression)
+  {
+   Expression *theAction;
+   unsigned int done = NO_JUMP;
+
+   if (theExpression->argList == NULL)
+     {
+      EmitInstruction(theEnv,theCompiler,BC_FALSE,0,theExpression,NULL);
+      return;
+     }
+
+   for (theAction = theExpression->argList;
+        theAction != NULL;
+        theAction = theAction->nextArg)
+     {
+      EmitJump(theEnv,theCompiler,BC_JUMP_IF_HALTED,theExpression,&done);
+      CompileAction(theEnv,theCompiler,theAction,theExpression);
+      if (theAction->nextArg != NULL)
+        { EmitJump(theEnv,theCompiler,BC_JUMP_IF_STOPPED,theExpression,&done); }
+     }
+
+   PatchJumps(theCompiler,done);
+   EmitInstruction(theEnv,theCompiler,BC_FALSE_IF_HALTED,theCompiler->length + 1,theExpression,NULL);
+   theCompiler->direct = true;
+  }
+
+/*********************************************************/
+/* CompileIf: Compiles an if call. An evaluated argument */
+/*   which leaves an evaluation error makes the result   */
+/*   FALSE, as it does when IfFunction gets it.          */
+/*********************************************************/
+static void CompileIf(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression)
+  {
+   Expression *theCondition = theExpression->argList;
+   Expression *thenActions = theCondition->nextArg;
+   Expression *elseActions = thenActions->nextArg;
+   unsigned int done = NO_JUMP, otherwise = NO_JUMP;
+
+   CompileAction(theEnv,theCompiler,theCondition,theExpression);
+   if (! ConstantArgument(theCondition))
+     { EmitJump(theEnv,theCompiler,BC_FALSE_IF_ERROR,theExpression,&done); }
+   EmitJump(theEnv,theCompiler,BC_FALSE_IF_STOPPED,theExpression,&done);
+   EmitJump(theEnv,theCompiler,BC_JUMP_IF_FALSE,theExpression,&otherwise);
+
+   CompileAction(theEnv,theCompiler,thenActions,theExpression);
+   if (! ConstantArgument(thenActions))
+     { EmitJump(theEnv,theCompiler,BC_FALSE_IF_ERROR,theExpression,&done); }
+   EmitJump(theEnv,theCompiler,BC_JUMP,theExpression,&done);
+
+   PatchJumps(theCompiler,otherwise);
+   if (elseActions != NULL)
+     {
+      CompileAction(theEnv,theCompiler,elseActions,theExpression);
+      if (! ConstantArgument(elseActions))
+        { EmitJump(theEnv,theCompiler,BC_FALSE_IF_ERROR,theExpression,&done); }
+     }
+   else
+     { EmitInstruction(theEnv,theCompiler,BC_FALSE,0,theExpression,NULL); }
+
+   PatchJumps(theCompiler,done);
+   theCompiler->direct = true;
+  }
+
+/**********************************************************/
+/* CompileWhile: Compiles a while call. Each loop nested  */
+/*   in the program has its own garbage frame (see        */
+/*   WhileFunction).                                      */
+/**********************************************************/
+static void CompileWhile(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression)
+  {
+   unsigned int top, done = NO_JUMP;
+   unsigned short depth = theCompiler->loops++;
+
+   EmitInstruction(theEnv,theCompiler,BC_LOOP_BEGIN,depth,theExpression,NULL);
+
+   top = theCompiler->length;
+   CompileAction(theEnv,theCompiler,theExpression->argList,theExpression);
+   EmitJump(theEnv,theCompiler,BC_JUMP_IF_FALSE,theExpression,&done);
+   EmitJump(theEnv,theCompiler,BC_JUMP_IF_HALTED,theExpression,&done);
+   EmitJump(theEnv,theCompiler,BC_JUMP_IF_STOPPED,theExpression,&done);
+   CompileAction(theEnv,theCompiler,theExpression->argList->nextArg,theExpression);
+   EmitJump(theEnv,theCompiler,BC_JUMP_IF_STOPPED,theExpression,&done);
+   EmitInstruction(theEnv,theCompiler,BC_LOOP_STEP,depth,theExpression,NULL);
+   EmitInstruction(theEnv,theCompiler,BC_JUMP,top,theExpression,NULL);
+
+   PatchJumps(theCompiler,done);
+   EmitInstruction(theEnv,theCompiler,BC_LOOP_END,depth,theExpression,NULL);
+
+   theCompiler->loops--;
+   theCompiler->direct = true;
+  }
+
+/**************************************************************/
+/* CompilePureAction: Compiles a call to one of the functions */
+/*   computed directly as a pure expression, followed by the  */
+/*   evaluation of the call by the interpreter to which the   */
+/*   machine falls back. Returns false, leaving the code      */
+/*   unchanged, if the call cannot be compiled this way.      */
+/**************************************************************/
+static bool CompilePureAction(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  Expression *parent)
+  {
+   unsigned int start, end, fallback;
+
+   if (FindBytecodeFunction(theExpression) == NULL)
+     { return false; }
+
+   start = EmitInstruction(theEnv,theCompiler,BC_PURE_BEGIN,0,theExpression,parent);
+   theCompiler->depth = 0;
+
+   if (! CompilePureExpression(theEnv,theCompiler,theExpression))
+     {
+      theCompiler->length = start;
+      return false;
+     }
+
+   end = EmitInstruction(theEnv,theCompiler,BC_PURE_END,0,theExpression,parent);
+   fallback = EmitInstruction(theEnv,theCompiler,BC_EVALUATE,0,theExpression,parent);
+
+   theCompiler->code[start].operand = fallback;
+   theCompiler->code[end].operand = theCompiler->length;
+   theCompiler->direct = true;
+
+   return true;
+  }
+
+/***************************************************************/
+/* CompilePureExpression: Compiles an expression which leaves  */
+/*   its value on the stack. Returns false if the expression   */
+/*   is not built only from constants, parameters, local       */
+/*   variables and the functions computed directly, or if it   */
+/*   needs more than the stack holds.                          */
+/***************************************************************/
+static bool CompilePureExpression(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression)
+  {
+   const struct bytecodeFunction *theFunction;
+   unsigned int argumentCount;
+   unsigned int first = 1;
+   Expression *theArgument;
+
+   switch (theExpression->type)
+     {
+      case INTEGER_TYPE:
+      case FLOAT_TYPE:
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+        return EmitPush(theEnv,theCompiler,BC_PUSH_CONSTANT,0,theExpression);
+
+      case PROC_PARAM:
+        return EmitPush(theEnv,theCompiler,BC_PUSH_PARAMETER,
+                        (unsigned int) (*((const int *) theExpression->bitMapValue->contents) - 1),
+                        theExpression);
+
+      case PROC_GET_BIND:
+        return EmitPush(theEnv,theCompiler,BC_PUSH_LOCAL,
+                        (unsigned int) (((const PACKED_PROC_VAR *) theExpression->bitMapValue->contents)->first - 1),
+                        theExpression);
+     }
+
+   theFunction = FindBytecodeFunction(theExpression);
+   if (theFunction == NULL)
+     { return false; }
+
+   argumentCount = CountArguments(theExpression->argList);
+   if ((argumentCount < theFunction->minimum) ||
+       ((theFunction->maximum != 0) && (argumentCount > theFunction->maximum)))
+     { return false; }
+
+   theArgument = theExpression->argList;
+   if (! CompilePureExpression(theEnv,theCompiler,theArgument))
+     { return false; }
+
+   if (argumentCount == 1)
+     {
+      EmitInstruction(theEnv,theCompiler,theFunction->operation,0,theExpression,NULL);
+      return true;
+     }
+
+   /*=============================================*/
+   /* The operand marks the first pair, for which */
+   /* the addition starts from an integer zero.   */
+   /*=============================================*/
+
+   for (theArgument = theArgument->nextArg;
+        theArgument != NULL;
+        theArgument = theArgument->nextArg)
+     {
+      if (! CompilePureExpression(theEnv,theCompiler,theArgument))
+        { return false; }
+
+      EmitInstruction(theEnv,theCompiler,theFunction->operation,first,theExpression,NULL);
+      theCompiler->depth--;
+      first = 0;
+     }
+
+   return true;
+  }
+
+/***************************************************/
+/* EmitPush: Appends an instruction which pushes a */
+/*   value, failing if the stack would overflow.   */
+/***************************************************/
+static bool EmitPush(
+  Environment *theEnv,
+  struct bytecodeCompiler *theCompiler,
+  BytecodeOperation operation,
+  unsigned int operand,
+  Expression *theExpression)
+  {
+   if (theCompiler->depth == BYTECODE_STACK_SIZE)
+     { return false; }
+
+   theCompiler->depth++;
+   EmitInstruction(theEnv,theCompiler,operation,operand,theExpression,NULL);
+
+   return true;
+  }
+
+/*************************************************************/
+/* LoadSlot: Stores a value in a stack slot. Returns false   */
+/*   for a multifield, which pure expressions do not handle. */
+/*************************************************************/
+static bool LoadSlot(
+  struct bytecodeSlot *theSlot,
+  void *theValue)
+  {
+   theSlot->type = ((TypeHeader *) theValue)->type;
+   theSlot->value = theValue;
+
+   switch (theSlot->type)
+     {
+      case INTEGER_TYPE:
+        theSlot->number.integer = ((CLIPSInteger *) theValue)->contents;
+        return true;
+
+      case FLOAT_TYPE:
+        theSlot->number.real = ((CLIPSFloat *) theValue)->contents;
+        return true;
+
+      case MULTIFIELD_TYPE:
+        return false;
+     }
+
+   return true;
+  }
+
+/**************************************************************/
+/* CoerceSlots: Converts two numbers to floats. Returns false */
+/*   if either slot does not hold a number.                   */
+/**************************************************************/
+static bool CoerceSlots(
+  struct bytecodeSlot *left,
+  struct bytecodeSlot *right,
+  double *leftNumber,
+  double *rightNumber)
+  {
+   if (left->type == INTEGER_TYPE)
+     { *leftNumber = (double) left->number.integer; }
+   else if (left->type == FLOAT_TYPE)
+     { *leftNumber = left->number.real; }
+   else
+     { return false; }
+
+   if (right->type == INTEGER_TYPE)
+     { *rightNumber = (double) right->number.integer; }
+   else if (right->type == FLOAT_TYPE)
+     { *rightNumber = right->number.real; }
+   else
+     { return false; }
+
+   return true;
+  }
+
+/*************************************************************/
+/* SlotsEqual: Compares two values as the eq function does.  */
+/*   Integers are equal when their contents are, since they  */
+/*   are hashed by value, but a computed float is created    */
+/*   first so that it compares as the interpreter's would.   */
+/*************************************************************/
+static bool SlotsEqual(
+  Environment *theEnv,
+  struct bytecodeSlot *left,
+  struct bytecodeSlot *right)
+  {
+   if (left->type != right->type)
+     { return false; }
+
+   if (left->type == INTEGER_TYPE)
+     { return (left->number.integer == right->number.integer); }
+
+   if (left->value == NULL)
+     { left->value = CreateFloat(theEnv,left->number.real); }
+
+   if (right->value == NULL)
+     { right->value = CreateFloat(theEnv,right->number.real); }
+
+   return (left->value == right->value);
+  }
+
+/*=========================================================*/
+/* Each instruction ends by dispatching the one at ip. A   */
+/* pure expression which cannot be computed continues at   */
+/* its fallback, the interpreter's evaluation of the call. */
+/*=========================================================*/
+
+#if BYTECODE_THREADED_DISPATCH
+#define OPERATION(name) name##_LABEL:
+#define DISPATCH() goto *dispatchTable[ip->operation]
+#else
+#define OPERATION(name) case name:
+#define DISPATCH() goto dispatch
+#endif
+
+#define NEXT() { ip++; DISPATCH(); }
+#define JUMP() { ip = code + ip->operand; DISPATCH(); }
+#define ABANDON() { ip = fallback; DISPATCH(); }
+
+/*************************************************************/
+/* RunBytecode: Runs a compiled program, leaving the value   */
+/*   of the actions in the caller's buffer.                  */
+/*************************************************************/
+static void RunBytecode(
+  Environment *theEnv,
+  const struct bytecodeInstruction *code,
+  UDFValue *returnValue)
+  {
+   const struct bytecodeInstruction *ip = code;
+   const struct bytecodeInstruction *fallback = code;
+   struct bytecodeSlot stack[BYTECODE_STACK_SIZE];
+   struct bytecodeSlot *top = stack;
+   GCBlock loops[BYTECODE_LOOP_DEPTH];
+   struct expr *outerExpression = EvaluationData(theEnv)->CurrentExpression;
+   UDFValue *theVariable;
+   double left, right;
+   bool truth;
+#if BYTECODE_THREADED_DISPATCH
+   static void *const dispatchTable[] =
+     {
+      &&BC_EVALUATE_LABEL, &&BC_CONSTANT_LABEL, &&BC_FALSE_LABEL,
+      &&BC_STORE_LOCAL_LABEL, &&BC_JUMP_LABEL, &&BC_JUMP_IF_FALSE_LABEL,
+      &&BC_JUMP_IF_HALTED_LABEL, &&BC_JUMP_IF_STOPPED_LABEL,
+      &&BC_FALSE_IF_HALTED_LABEL, &&BC_FALSE_IF_STOPPED_LABEL,
+      &&BC_FALSE_IF_ERROR_LABEL, &&BC_LOOP_BEGIN_LABEL, &&BC_LOOP_STEP_LABEL,
+      &&BC_LOOP_END_LABEL, &&BC_PURE_BEGIN_LABEL, &&BC_PURE_END_LABEL,
+      &&BC_PUSH_CONSTANT_LABEL, &&BC_PUSH_LOCAL_LABEL, &&BC_PUSH_PARAMETER_LABEL,
+      &&BC_ADD_LABEL, &&BC_SUBTRACT_LABEL, &&BC_MULTIPLY_LABEL, &&BC_DIVIDE_LABEL,
+      &&BC_NUMERIC_EQUAL_LABEL, &&BC_NUMERIC_NOT_EQUAL_LABEL,
+      &&BC_LESS_THAN_LABEL, &&BC_LESS_THAN_OR_EQUAL_LABEL,
+      &&BC_GREATER_THAN_LABEL, &&BC_GREATER_THAN_OR_EQUAL_LABEL,
+      &&BC_EQ_LABEL, &&BC_NEQ_LABEL, &&BC_NOT_LABEL, &&BC_RETURN_LABEL
+     };
+#endif
+
+   returnValue->voidValue = VoidConstant(theEnv);
+   returnValue->begin = 0;
+   returnValue->range = SIZE_MAX;
+
+#if BYTECODE_THREADED_DISPATCH
+   DISPATCH();
+#else
+  dispatch:
+   switch (ip->operation)
+     {
+#endif
+
+      /*==========================================*/
+      /* Actions evaluated by the interpreter and */
+      /* values left in the result.               */
+      /*==========================================*/
+
+      OPERATION(BC_EVALUATE)
+        EvaluationData(theEnv)->CurrentExpression = (ip->parent != NULL) ? ip->parent : outerExpression;
+        EvaluateExpression(theEnv,ip->node,returnValue);
+        NEXT();
+
+      OPERATION(BC_CONSTANT)
+        returnValue->value = ip->node->value;
+        returnValue->begin = 0;
+        returnValue->range = SIZE_MAX;
+        NEXT();
+
+      OPERATION(BC_FALSE)
+        returnValue->value = FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_STORE_LOCAL)
+        theVariable = &ProceduralPrimitiveData(theEnv)->LocalVarArray[ip->operand];
+        if (theVariable->supplementalInfo == TrueSymbol(theEnv))
+          { ReleaseUDFV(theEnv,theVariable); }
+        theVariable->supplementalInfo = TrueSymbol(theEnv);
+        theVariable->value = returnValue->value;
+        theVariable->begin = returnValue->begin;
+        theVariable->range = returnValue->range;
+        RetainUDFV(theEnv,theVariable);
+        NEXT();
+
+      /*===============*/
+      /* Control flow. */
+      /*===============*/
+
+      OPERATION(BC_JUMP)
+        JUMP();
+
+      OPERATION(BC_JUMP_IF_FALSE)
+        if (returnValue->value == FalseSymbol(theEnv))
+          { JUMP(); }
+        NEXT();
+
+      OPERATION(BC_JUMP_IF_HALTED)
+        if (EvaluationData(theEnv)->HaltExecution)
+          { JUMP(); }
+        NEXT();
+
+      OPERATION(BC_JUMP_IF_STOPPED)
+        if (ProcedureFunctionData(theEnv)->BreakFlag || ProcedureFunctionData(theEnv)->ReturnFlag)
+          { JUMP(); }
+        NEXT();
+
+      OPERATION(BC_FALSE_IF_HALTED)
+        if (EvaluationData(theEnv)->HaltExecution)
+          {
+           returnValue->value = FalseSymbol(theEnv);
+           JUMP();
+          }
+        NEXT();
+
+      OPERATION(BC_FALSE_IF_STOPPED)
+        if (ProcedureFunctionData(theEnv)->BreakFlag || ProcedureFunctionData(theEnv)->ReturnFlag)
+          {
+           returnValue->value = FalseSymbol(theEnv);
+           JUMP();
+          }
+        NEXT();
+
+      OPERATION(BC_FALSE_IF_ERROR)
+        if (EvaluationData(theEnv)->EvaluationError)
+          {
+           returnValue->value = FalseSymbol(theEnv);
+           JUMP();
+          }
+        NEXT();
+
+      OPERATION(BC_LOOP_BEGIN)
+        GCBlockStart(theEnv,&loops[ip->operand]);
+        NEXT();
+
+      OPERATION(BC_LOOP_STEP)
+        CleanCurrentGarbageFrame(theEnv,NULL);
+        CallPeriodicTasks(theEnv);
+        NEXT();
+
+      OPERATION(BC_LOOP_END)
+        ProcedureFunctionData(theEnv)->BreakFlag = false;
+        if (! ProcedureFunctionData(theEnv)->ReturnFlag)
+          {
+           returnValue->value = FalseSymbol(theEnv);
+           returnValue->begin = 0;
+           returnValue->range = SIZE_MAX;
+          }
+        GCBlockEndUDF(theEnv,&loops[ip->operand],returnValue);
+        CallPeriodicTasks(theEnv);
+        NEXT();
+
+      /*===================*/
+      /* Pure expressions. */
+      /*===================*/
+
+      OPERATION(BC_PURE_BEGIN)
+        fallback = code + ip->operand;
+        top = stack;
+        NEXT();
+
+      OPERATION(BC_PURE_END)
+        top--;
+        if (top->value != NULL)
+          { returnValue->value = top->value; }
+        else if (top->type == INTEGER_TYPE)
+          { returnValue->integerValue = CreateInteger(theEnv,top->number.integer); }
+        else
+          { returnValue->floatValue = CreateFloat(theEnv,top->number.real); }
+        returnValue->begin = 0;
+        returnValue->range = SIZE_MAX;
+        JUMP();
+
+      OPERATION(BC_PUSH_CONSTANT)
+        LoadSlot(top,ip->node->value);
+        top++;
+        NEXT();
+
+      OPERATION(BC_PUSH_LOCAL)
+        theVariable = &ProceduralPrimitiveData(theEnv)->LocalVarArray[ip->operand];
+        if ((theVariable->supplementalInfo != TrueSymbol(theEnv)) ||
+            (! LoadSlot(top,theVariable->value)))
+          { ABANDON(); }
+        top++;
+        NEXT();
+
+      OPERATION(BC_PUSH_PARAMETER)
+        if (! LoadSlot(top,ProceduralPrimitiveData(theEnv)->ProcParamArray[ip->operand].value))
+          { ABANDON(); }
+        top++;
+        NEXT();
+
+      /*=================================================*/
+      /* Integer arithmetic wraps as the interpreter's   */
+      /* does in practice, but without overflowing a     */
+      /* signed integer. A float operand makes the       */
+      /* result a float, as it does for the rest of the  */
+      /* arguments of AdditionFunction and the others.   */
+      /*=================================================*/
+
+      OPERATION(BC_ADD)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          {
+           top[-1].number.integer = (long long) ((unsigned long long) top[-1].number.integer +
+                                                 (unsigned long long) top->number.integer);
+          }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          {
+           if (ip->operand)
+             { left = 0.0 + left; }
+           top[-1].type = FLOAT_TYPE;
+           top[-1].number.real = left + right;
+          }
+        else
+          { ABANDON(); }
+        top[-1].value = NULL;
+        NEXT();
+
+      OPERATION(BC_SUBTRACT)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          {
+           top[-1].number.integer = (long long) ((unsigned long long) top[-1].number.integer -
+                                                 (unsigned long long) top->number.integer);
+          }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          {
+           top[-1].type = FLOAT_TYPE;
+           top[-1].number.real = left - right;
+          }
+        else
+          { ABANDON(); }
+        top[-1].value = NULL;
+        NEXT();
+
+      OPERATION(BC_MULTIPLY)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          {
+           top[-1].number.integer = (long long) ((unsigned long long) top[-1].number.integer *
+                                                 (unsigned long long) top->number.integer);
+          }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          {
+           top[-1].type = FLOAT_TYPE;
+           top[-1].number.real = left * right;
+          }
+        else
+          { ABANDON(); }
+        top[-1].value = NULL;
+        NEXT();
+
+      OPERATION(BC_DIVIDE)
+        top--;
+        if ((! CoerceSlots(&top[-1],top,&left,&right)) || (right == 0.0))
+          { ABANDON(); }
+        top[-1].type = FLOAT_TYPE;
+        top[-1].number.real = left / right;
+        top[-1].value = NULL;
+        NEXT();
+
+      /*=================================================*/
+      /* Each comparison is the negation of the test for */
+      /* which the interpreter's function returns FALSE, */
+      /* so that unordered floats give the same answer.  */
+      /*=================================================*/
+
+      OPERATION(BC_NUMERIC_EQUAL)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          { truth = ! (top[-1].number.integer != top->number.integer); }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          { truth = ! (left != right); }
+        else
+          { ABANDON(); }
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_NUMERIC_NOT_EQUAL)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          { truth = ! (top[-1].number.integer == top->number.integer); }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          { truth = ! (left == right); }
+        else
+          { ABANDON(); }
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_LESS_THAN)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          { truth = ! (top[-1].number.integer >= top->number.integer); }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          { truth = ! (left >= right); }
+        else
+          { ABANDON(); }
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_LESS_THAN_OR_EQUAL)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          { truth = ! (top[-1].number.integer > top->number.integer); }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          { truth = ! (left > right); }
+        else
+          { ABANDON(); }
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_GREATER_THAN)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          { truth = ! (top[-1].number.integer <= top->number.integer); }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          { truth = ! (left <= right); }
+        else
+          { ABANDON(); }
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_GREATER_THAN_OR_EQUAL)
+        top--;
+        if ((top[-1].type == INTEGER_TYPE) && (top->type == INTEGER_TYPE))
+          { truth = ! (top[-1].number.integer < top->number.integer); }
+        else if (CoerceSlots(&top[-1],top,&left,&right))
+          { truth = ! (left < right); }
+        else
+          { ABANDON(); }
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_EQ)
+        top--;
+        truth = SlotsEqual(theEnv,&top[-1],top);
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_NEQ)
+        top--;
+        truth = ! SlotsEqual(theEnv,&top[-1],top);
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_NOT)
+        truth = (top[-1].value == FalseSymbol(theEnv));
+        top[-1].type = SYMBOL_TYPE;
+        top[-1].value = truth ? TrueSymbol(theEnv) : FalseSymbol(theEnv);
+        NEXT();
+
+      OPERATION(BC_RETURN)
+        goto finished;
+
+#if ! BYTECODE_THREADED_DISPATCH
+     }
+#endif
+
+  finished:
+   EvaluationData(theEnv)->CurrentExpression = outerExpression;
+  }
+
+/***************************************************/
+/* SetBytecodeExecution: Sets whether the actions  */
+/*   of constructs are run as bytecode. Returns    */
+/*   the previous setting.                         */
+/***************************************************/
+bool SetBytecodeExecution(
+  Environment *theEnv,
+  bool value)
+  {
+   bool ov;
+
+   ov = BytecodeData(theEnv)->Enabled;
+   BytecodeData(theEnv)->Enabled = value;
+
+   return ov;
+  }
+
+/*****************************************************/
+/* GetBytecodeExecution: Returns whether the actions */
+/*   of constructs are run as bytecode.              */
+/*****************************************************/
+bool GetBytecodeExecution(
+  Environment *theEnv)
+  {
+   return BytecodeData(theEnv)->Enabled;
+  }
+
+/***************************************************/
+/* SetBytecodeExecutionCommand: H/L access routine */
+/*   for the set-bytecode-execution command.       */
+/***************************************************/
+void SetBytecodeExecutionCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetBytecodeExecution(theEnv));
+
+   if (! UDFFirstArgument(context,ANY_TYPE_BITS,&theArg))
+     { return; }
+
+   SetBytecodeExecution(theEnv,theArg.value != FalseSymbol(theEnv));
+  }
+
+/***************************************************/
+/* GetBytecodeExecutionCommand: H/L access routine */
+/*   for the get-bytecode-execution command.       */
+/***************************************************/
+void GetBytecodeExecutionCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetBytecodeExecution(theEnv));
+  }
+
+#endif /* EXPRESSION_BYTECODE */
@@ -818,6 +818,9 @@ void RemoveDefclass(
       hnd = &cls->handlers[i];
       if (hnd->actions != NULL)
         ReturnPackedExpression(theEnv,hnd->actions);
+#if ! BLOAD_ONLY
+      ReturnLazyConstructBody(theEnv,hnd->lazyBody);
+#endif
       if (hnd->header.ppForm != NULL)
         rm(theEnv,(void *) hnd->header.ppForm,(sizeof(char) * (strlen(hnd->header.ppForm)+1)));
       if (hnd->header.usrData != NULL)
@@ -915,6 +918,9 @@ void DestroyDefclass(
       hnd = &cls->handlers[i];
       if (hnd->actions != NULL)
         ReturnPackedExpression(theEnv,hnd->actions);
+#if ! BLOAD_ONLY
+      ReturnLazyConstructBody(theEnv,hnd->lazyBody);
+#endif
 
       if (hnd->header.ppForm != NULL)
         rm(theEnv,(void *) hnd->header.ppForm,(sizeof(char) * (strlen(hnd->header.ppForm)+1)));
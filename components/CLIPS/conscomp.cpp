@@ -91,6 +91,7 @@
 #include "constant.h"
 #include "constrct.h"
 #include "cstrccom.h"
+#include "cstrcpsr.h"
 #include "cstrncmp.h"
 #include "exprnpsr.h"
 #include "envrnmnt.h"
@@ -168,6 +169,7 @@ const char *SecondaryCodes[] = { "A" , "B", "C", "D", "E" , "F" , "G" , "H", "I"
    static bool                        FunctionsToCode(Environment *theEnv,const char *,const char *,char *);
    static bool                        WriteInitializationFunction(Environment *,const char *,const char *,char *);
    static void                        DumpExpression(Environment *,struct expr *);
+   static void                        CloseExpressionFile(Environment *);
    static void                        MarkConstruct(Environment *,ConstructHeader *,void *);
    static void                        HashedExpressionsToCode(Environment *);
    static void                        DeallocateConstructCompilerData(Environment *);
@@ -329,6 +331,14 @@ void ConstructsToCCommand(
    else
      { max = 10000; }
 
+   /*=================================================*/
+   /* The actions of constructs loaded in lazy mode   */
+   /* which have not been called yet must be parsed.  */
+   /*=================================================*/
+
+   if (! ParseLazyConstructs(theEnv))
+     { return; }
+
    /*============================*/
    /* Call the driver routine to */
    /* generate the C code.       */
@@ -356,6 +366,9 @@ static bool ConstructsToC(
    unsigned fileVersion;
    struct CodeGeneratorItem *cgPtr;
 
+   if (SharedAtomBaseError(theEnv,"constructs-to-c"))
+     { return false; }
+
    /*===============================================*/
    /* Set the global MaxIndices variable indicating */
    /* the maximum number of data structures to save */
@@ -408,6 +421,7 @@ static bool ConstructsToC(
    ConstructCompilerData(theEnv)->ExpressionVersion = 1;
    ConstructCompilerData(theEnv)->ExpressionHeader = true;
    ConstructCompilerData(theEnv)->ExpressionCount = 0;
+   ConstructCompilerData(theEnv)->ExpressionFixups = false;
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"#ifndef _CONSTRUCT_COMPILER_HEADER_\n");
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"#define _CONSTRUCT_COMPILER_HEADER_\n\n");
@@ -418,6 +432,7 @@ static bool ConstructsToC(
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"#include \"extnfunc.h\"\n");
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"#include \"%s\"\n",API_HEADER);
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"\n#define VS (void *)\n");
+   fprintf(ConstructCompilerData(theEnv)->HeaderFP,"#define ES (struct expr *)\n");
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"\n");
 
    /*=========================================================*/
@@ -493,10 +508,7 @@ static bool ConstructsToC(
    /*============================*/
 
    if (ConstructCompilerData(theEnv)->ExpressionFP != NULL)
-     {
-      fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"};\n");
-      GenClose(theEnv,ConstructCompilerData(theEnv)->ExpressionFP);
-     }
+     { CloseExpressionFile(theEnv); }
 
    /*=======================*/
    /* Close the fixup file. */
@@ -843,7 +855,7 @@ void PrintHashedExpressionReference(
      {
       theIDValue = HashedExpressionIndex(theEnv,theExpression);
 
-      fprintf(theFile,"&E%d_%ld[%ld]",
+      fprintf(theFile,"ES &E%d_%ld[%ld]",
                       imageID,
                       theIDValue / maxIndices,
                       theIDValue % maxIndices);
@@ -870,7 +882,7 @@ int ExpressionToCode(
       return 0;
      }
    else if (fp != NULL)
-     { fprintf(fp,"&E%d_%d[%ld]",ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion,ConstructCompilerData(theEnv)->ExpressionCount); }
+     { fprintf(fp,"ES &E%d_%d[%ld]",ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion,ConstructCompilerData(theEnv)->ExpressionCount); }
 
    /*==================================================*/
    /* Create a new expression code file, if necessary. */
@@ -884,8 +896,9 @@ int ExpressionToCode(
                                                                   3,ConstructCompilerData(theEnv)->ExpressionVersion,false)) == NULL)
         { return(-1); }
 
-      fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"struct expr E%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion);
-      fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern struct expr E%d_%d[];\n",ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion);
+      fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"E%d_%d_CONST struct expr E%d_%d[] = {\n",
+              ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion,
+              ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion);
       ConstructCompilerData(theEnv)->ExpressionHeader = false;
      }
    else
@@ -903,10 +916,9 @@ int ExpressionToCode(
 
    if (ConstructCompilerData(theEnv)->ExpressionCount >= ConstructCompilerData(theEnv)->MaxIndices)
      {
+      CloseExpressionFile(theEnv);
       ConstructCompilerData(theEnv)->ExpressionCount = 0;
       ConstructCompilerData(theEnv)->ExpressionVersion++;
-      fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"};\n");
-      GenClose(theEnv,ConstructCompilerData(theEnv)->ExpressionFP);
       ConstructCompilerData(theEnv)->ExpressionFP = NULL;
       ConstructCompilerData(theEnv)->ExpressionHeader = true;
      }
@@ -920,6 +932,37 @@ int ExpressionToCode(
    return 1;
   }
 
+/*************************************************************/
+/* CloseExpressionFile: Ends the expression array written to */
+/*   the current expression file and declares it in the      */
+/*   header file. The array is declared const, so that it    */
+/*   can be placed in read only memory (the flash of an      */
+/*   embedded target) and used in place, unless one of its   */
+/*   expressions must be fixed up by the FixupCImage         */
+/*   function when the image is loaded. The size is given so */
+/*   that a C++ compiler can resolve the references between  */
+/*   the expressions of the array at compile time.           */
+/*************************************************************/
+static void CloseExpressionFile(
+  Environment *theEnv)
+  {
+   unsigned imageID = ConstructCompilerData(theEnv)->ImageID;
+   unsigned version = ConstructCompilerData(theEnv)->ExpressionVersion;
+
+   fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"};\n");
+   GenClose(theEnv,ConstructCompilerData(theEnv)->ExpressionFP);
+
+   if (ConstructCompilerData(theEnv)->ExpressionFixups)
+     { fprintf(ConstructCompilerData(theEnv)->HeaderFP,"#define E%d_%d_CONST\n",imageID,version); }
+   else
+     { fprintf(ConstructCompilerData(theEnv)->HeaderFP,"#define E%d_%d_CONST const\n",imageID,version); }
+
+   fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern E%d_%d_CONST struct expr E%d_%d[%ld];\n",
+           imageID,version,imageID,version,ConstructCompilerData(theEnv)->ExpressionCount);
+
+   ConstructCompilerData(theEnv)->ExpressionFixups = false;
+  }
+
 /**********************************************************/
 /* DumpExpression: Writes the C code representation of an */
 /*   expression data structure to the expression file.    */
@@ -1001,6 +1044,7 @@ static void DumpExpression(
                    ConstructCompilerData(theEnv)->ImageID,
                    ConstructCompilerData(theEnv)->ExpressionVersion,
                    ConstructCompilerData(theEnv)->ExpressionCount);
+           ConstructCompilerData(theEnv)->ExpressionFixups = true;
 #else
            fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"NULL");
 #endif
@@ -1014,6 +1058,7 @@ static void DumpExpression(
                    ConstructCompilerData(theEnv)->ImageID,
                    ConstructCompilerData(theEnv)->ExpressionVersion,
                    ConstructCompilerData(theEnv)->ExpressionCount);
+           ConstructCompilerData(theEnv)->ExpressionFixups = true;
 #else
            fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"NULL");
 #endif
@@ -1047,7 +1092,7 @@ static void DumpExpression(
         { fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"NULL,"); }
       else
         {
-         fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"&E%d_%d[%ld],",ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion,
+         fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"ES &E%d_%d[%ld],",ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion,
                                                        ConstructCompilerData(theEnv)->ExpressionCount);
         }
 
@@ -1055,7 +1100,7 @@ static void DumpExpression(
         { fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"NULL}"); }
       else
         {
-         fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"&E%d_%d[%ld]}",ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion,
+         fprintf(ConstructCompilerData(theEnv)->ExpressionFP,"ES &E%d_%d[%ld]}",ConstructCompilerData(theEnv)->ImageID,ConstructCompilerData(theEnv)->ExpressionVersion,
                               ConstructCompilerData(theEnv)->ExpressionCount + ExpressionSize(exprPtr->argList));
         }
 
@@ -138,6 +138,7 @@ static void DeallocateConstructData(
 
 #if (! RUN_TIME) && (! BLOAD_ONLY)
    DeallocateSaveCallList(theEnv,ConstructData(theEnv)->ListOfSaveFunctions);
+   DeallocateBoolCallList(theEnv,ConstructData(theEnv)->ListOfLazyParseFunctions);
 #endif
    DeallocateVoidCallList(theEnv,ConstructData(theEnv)->ListOfResetFunctions);
    DeallocateVoidCallList(theEnv,ConstructData(theEnv)->ListOfClearFunctions);
@@ -260,6 +261,16 @@ bool Save(
    if (EvaluationData(theEnv)->CurrentExpression == NULL)
      { ResetErrorFlags(theEnv); }
 
+   /*=================================================*/
+   /* Parse the actions deferred by lazy construct    */
+   /* loading so that the constructs are saved as if  */
+   /* they had been loaded with it turned off. A      */
+   /* construct with errors in its actions is saved   */
+   /* as it was read.                                 */
+   /*=================================================*/
+
+   ParseLazyConstructs(theEnv);
+
    /*=====================*/
    /* Open the save file. */
    /*=====================*/
@@ -449,6 +460,11 @@ void InitializeConstructs(
    AddUDF(theEnv,"clear","v",0,0,NULL,ClearCommand,"ClearCommand",NULL);
    AddUDF(theEnv,"reset","v",0,0,NULL,ResetCommand,"ResetCommand",NULL);
 
+#if (! BLOAD_ONLY)
+   AddUDF(theEnv,"get-lazy-construct-loading","b",0,0,NULL,GetLazyConstructLoadingCommand,"GetLazyConstructLoadingCommand",NULL);
+   AddUDF(theEnv,"set-lazy-construct-loading","b",1,1,NULL,SetLazyConstructLoadingCommand,"SetLazyConstructLoadingCommand",NULL);
+#endif
+
 #if DEBUGGING_FUNCTIONS && (! BLOAD_ONLY)
    AddWatchItem(theEnv,"compilations",0,&ConstructData(theEnv)->WatchCompilations,30,NULL,NULL);
 #endif
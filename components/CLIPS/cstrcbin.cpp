@@ -38,6 +38,7 @@
 #endif
 
 #include "moduldef.h"
+#include "userdata.h"
 
 #include "cstrcbin.h"
 
@@ -168,10 +169,12 @@ void UpdateConstructHeader(
 /*******************************************************
   NAME         : UnmarkConstructHeader
   DESCRIPTION  : Releases any ephemerals (symbols, etc.)
-                 of a construct header for removal
+                 and the user data of a construct header
+                 for removal
   INPUTS       : The construct header
   RETURNS      : Nothing useful
   SIDE EFFECTS : Busy counts fo ephemerals decremented
+                 and user data deallocated
   NOTES        : None
  *******************************************************/
 void UnmarkConstructHeader(
@@ -179,6 +182,8 @@ void UnmarkConstructHeader(
   ConstructHeader *theConstruct)
   {
    ReleaseLexeme(theEnv,theConstruct->name);
+   ClearUserDataList(theEnv,theConstruct->usrData);
+   theConstruct->usrData = NULL;
   }
 
 #endif /* BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE */
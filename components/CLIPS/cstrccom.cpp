@@ -279,10 +279,12 @@ ConstructHeader *FindNamedConstructInModule(
    /*===============================================*/
    /* If we find the symbol for the construct name, */
    /* but it has a count of 0, then it can't be for */
-   /* a construct that's currently defined.         */
+   /* a construct that's currently defined. The     */
+   /* counts of shared permanent symbols aren't     */
+   /* kept, so those have to be searched for.       */
    /*===============================================*/
 
-   if (findValue->count == 0)
+   if ((findValue->count == 0) && (! findValue->permanent))
      {
       RestoreCurrentModule(theEnv);
       return NULL;
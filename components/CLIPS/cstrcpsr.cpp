@@ -74,6 +74,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "argacces.h"
 #include "envrnmnt.h"
 #include "router.h"
 #include "watch.h"
@@ -85,6 +86,7 @@
 #include "modulpsr.h"
 #include "pprint.h"
 #include "prntutil.h"
+#include "scanner.h"
 #include "strngrtr.h"
 #include "sysdep.h"
 #include "utility.h"
@@ -96,6 +98,7 @@
 /***************************************/
 
    static bool                    FindConstructBeginning(Environment *,const char *,struct token *,bool,bool *);
+   static char                   *ReadLoadBuffer(Environment *,FILE *,size_t *);
 
 /**********************************************************/
 /* Load: C access routine for the load command. Returns   */
@@ -112,6 +115,11 @@ LoadError Load(
    FILE *theFile;
    char *oldParsingFileName;
    int noErrorsDetected;
+   char *fileBuffer;
+   size_t bufferSize = 0;
+   const char *oldRouter = NULL;
+   const char *oldString = NULL;
+   long oldIndex = 0;
 
    /*=======================================*/
    /* Open the file specified by file name. */
@@ -123,10 +131,24 @@ LoadError Load(
    /*===================================================*/
    /* Read in the constructs. Enabling fast load allows */
    /* the router system to be bypassed for quicker load */
-   /* times.                                            */
+   /* times. A file small enough to be held in memory   */
+   /* is read through a fast get string instead, so the */
+   /* scanner can take its characters a span at a time. */
    /*===================================================*/
 
-   SetFastLoad(theEnv,theFile);
+   fileBuffer = ReadLoadBuffer(theEnv,theFile,&bufferSize);
+   if (fileBuffer != NULL)
+     {
+      oldRouter = RouterData(theEnv)->FastCharGetRouter;
+      oldString = RouterData(theEnv)->FastCharGetString;
+      oldIndex = RouterData(theEnv)->FastCharGetIndex;
+
+      RouterData(theEnv)->FastCharGetRouter = (char *) theFile;
+      RouterData(theEnv)->FastCharGetString = fileBuffer;
+      RouterData(theEnv)->FastCharGetIndex = 0;
+     }
+   else
+     { SetFastLoad(theEnv,theFile); }
 
    oldParsingFileName = CopyString(theEnv,GetParsingFileName(theEnv));
    SetParsingFileName(theEnv,fileName);
@@ -141,7 +163,15 @@ LoadError Load(
    SetWarningFileName(theEnv,NULL);
    SetErrorFileName(theEnv,NULL);
 
-   SetFastLoad(theEnv,NULL);
+   if (fileBuffer != NULL)
+     {
+      RouterData(theEnv)->FastCharGetRouter = oldRouter;
+      RouterData(theEnv)->FastCharGetString = oldString;
+      RouterData(theEnv)->FastCharGetIndex = oldIndex;
+      genfree(theEnv,fileBuffer,bufferSize);
+     }
+   else
+     { SetFastLoad(theEnv,NULL); }
 
    /*=================*/
    /* Close the file. */
@@ -160,6 +190,55 @@ LoadError Load(
    return LE_PARSING_ERROR;
   }
 
+/***************************************************/
+/* ReadLoadBuffer: Reads the contents of a file to */
+/*   be loaded into a null terminated buffer. NULL */
+/*   is returned (with the file rewound) if the    */
+/*   file is empty, larger than LOAD_BUFFER_LIMIT, */
+/*   contains a null character, or couldn't be     */
+/*   read. A file with a null is left to getc, so  */
+/*   it doesn't end the input early.               */
+/***************************************************/
+static char *ReadLoadBuffer(
+  Environment *theEnv,
+  FILE *theFile,
+  size_t *bufferSize)
+  {
+   long fileSize;
+   size_t count;
+   char *buffer;
+
+   if (LOAD_BUFFER_LIMIT == 0)
+     { return NULL; }
+
+   if (fseek(theFile,0,SEEK_END) != 0)
+     {
+      rewind(theFile);
+      return NULL;
+     }
+
+   fileSize = ftell(theFile);
+   rewind(theFile);
+
+   if ((fileSize <= 0) || (fileSize > LOAD_BUFFER_LIMIT))
+     { return NULL; }
+
+   *bufferSize = (size_t) fileSize + 1;
+   buffer = (char *) genalloc(theEnv,*bufferSize);
+
+   count = fread(buffer,1,(size_t) fileSize,theFile);
+   if (ferror(theFile) || (memchr(buffer,EOS,count) != NULL))
+     {
+      genfree(theEnv,buffer,*bufferSize);
+      rewind(theFile);
+      return NULL;
+     }
+
+   buffer[count] = EOS;
+
+   return buffer;
+  }
+
 /*******************/
 /* LoadFromString: */
 /*******************/
@@ -346,6 +425,31 @@ bool LoadConstructsFromLogicalName(
 
    while ((foundConstruct == true) && (GetHaltExecution(theEnv) == false))
      {
+      /*========================================================*/
+      /* If the load filter rejects the construct, then skip it */
+      /* in the same way as a construct containing an error,    */
+      /* but without generating any error messages.             */
+      /*========================================================*/
+
+      if ((ConstructData(theEnv)->LoadFilter != NULL) &&
+          (! (*ConstructData(theEnv)->LoadFilter)(theEnv,theToken.lexemeValue->contents,
+                                                  ConstructData(theEnv)->LoadFilterContext)))
+        {
+         GetToken(theEnv,readSource,&theToken);
+         foundConstruct = FindConstructBeginning(theEnv,readSource,&theToken,true,&noErrors);
+
+         if (foundConstruct)
+           { IncrementLexemeCount(theToken.value); }
+
+         CleanCurrentGarbageFrame(theEnv,NULL);
+         CallPeriodicTasks(theEnv);
+
+         if (foundConstruct)
+           { ReleaseLexeme(theEnv,theToken.lexemeValue); }
+
+         continue;
+        }
+
       /*===========================================================*/
       /* Clear the pretty print buffer in preparation for parsing. */
       /*===========================================================*/
@@ -723,6 +827,26 @@ void FlushParsingMessages(
    ConstructData(theEnv)->MaxWrnChars = 0;
   }
 
+/*************************************************************/
+/* SetConstructLoadFilter: Sets the function called with the */
+/*   name of each construct found while loading constructs.  */
+/*   Constructs for which the function returns false are     */
+/*   skipped without being parsed. Returns the old filter.   */
+/*************************************************************/
+ConstructLoadFilterFunction *SetConstructLoadFilter(
+  Environment *theEnv,
+  ConstructLoadFilterFunction *theFunction,
+  void *context)
+  {
+   ConstructLoadFilterFunction *oldFunction;
+
+   oldFunction = ConstructData(theEnv)->LoadFilter;
+   ConstructData(theEnv)->LoadFilter = theFunction;
+   ConstructData(theEnv)->LoadFilterContext = context;
+
+   return oldFunction;
+  }
+
 /***************************************/
 /* ParseConstruct: Parses a construct. */
 /***************************************/
@@ -830,6 +954,307 @@ void ImportExportConflictMessage(
      }
   }
 
+/*****************************************************/
+/* GetLazyConstructLoading: C access routine for the */
+/*   get-lazy-construct-loading command.             */
+/*****************************************************/
+bool GetLazyConstructLoading(
+  Environment *theEnv)
+  {
+   return ConstructData(theEnv)->LazyConstructLoading;
+  }
+
+/*****************************************************/
+/* SetLazyConstructLoading: C access routine for the */
+/*   set-lazy-construct-loading command.             */
+/*****************************************************/
+bool SetLazyConstructLoading(
+  Environment *theEnv,
+  bool value)
+  {
+   bool ov;
+
+   ov = ConstructData(theEnv)->LazyConstructLoading;
+
+   ConstructData(theEnv)->LazyConstructLoading = value;
+
+   return ov;
+  }
+
+/************************************************************/
+/* GetLazyConstructLoadingCommand: H/L access routine for   */
+/*   the get-lazy-construct-loading command.                */
+/************************************************************/
+void GetLazyConstructLoadingCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetLazyConstructLoading(theEnv));
+  }
+
+/************************************************************/
+/* SetLazyConstructLoadingCommand: H/L access routine for   */
+/*   the set-lazy-construct-loading command.                */
+/************************************************************/
+void SetLazyConstructLoadingCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetLazyConstructLoading(theEnv));
+
+   /*===================================================*/
+   /* The symbol FALSE disables lazy construct loading. */
+   /* Any other value enables lazy construct loading.   */
+   /*===================================================*/
+
+   if (! UDFFirstArgument(context,ANY_TYPE_BITS,&theArg))
+     { return; }
+
+   if (theArg.value == FalseSymbol(theEnv))
+     { SetLazyConstructLoading(theEnv,false); }
+   else
+     { SetLazyConstructLoading(theEnv,true); }
+  }
+
+/*************************************************/
+/* AddLazyParseFunction: Adds a function to the  */
+/*   ListOfLazyParseFunctions. The function is   */
+/*   called by ParseLazyConstructs and must      */
+/*   parse all of the actions of its constructs  */
+/*   which have not been parsed yet.             */
+/*************************************************/
+bool AddLazyParseFunction(
+  Environment *theEnv,
+  const char *name,
+  BoolCallFunction *functionPtr,
+  int priority,
+  void *context)
+  {
+   ConstructData(theEnv)->ListOfLazyParseFunctions =
+     AddBoolFunctionToCallList(theEnv,name,priority,functionPtr,
+                               ConstructData(theEnv)->ListOfLazyParseFunctions,context);
+   return true;
+  }
+
+/***************************************************************/
+/* ParseLazyConstructs: Parses the actions of all constructs   */
+/*   loaded in lazy construct loading mode which have not been */
+/*   called yet. Used before the constructs are saved with     */
+/*   bsave or constructs-to-c. Returns false if the actions of */
+/*   a construct contain errors.                               */
+/***************************************************************/
+bool ParseLazyConstructs(
+  Environment *theEnv)
+  {
+   struct boolCallFunctionItem *theFunction;
+   bool rv = true;
+
+   for (theFunction = ConstructData(theEnv)->ListOfLazyParseFunctions;
+        theFunction != NULL;
+        theFunction = theFunction->next)
+     {
+      if ((*theFunction->func)(theEnv,theFunction->context) == false)
+        { rv = false; }
+     }
+
+   return rv;
+  }
+
+/****************************************************************/
+/* ReadLazyConstructBody: Reads the actions of a deffunction,   */
+/*   method or message-handler up to and including the closing  */
+/*   parenthesis of the construct without parsing them. The     */
+/*   text returned starts with the parameter list so that the   */
+/*   variable references can be resolved when the actions are   */
+/*   parsed by ParseLazyProcActions. The actions are saved flat */
+/*   to the pretty print buffer, so its state is also returned  */
+/*   for ParseLazyProcActions to lay them out as the parser     */
+/*   would have. Returns NULL on errors.                        */
+/****************************************************************/
+struct lazyConstructBody *ReadLazyConstructBody(
+  Environment *theEnv,
+  const char *readSource,
+  struct token *inputToken,
+  const char *constructName,
+  Expression *parameterList,
+  CLIPSLexeme *wildcard)
+  {
+   char *theString = NULL;
+   struct lazyConstructBody *theBody;
+   size_t pos = 0, max = 0;
+   unsigned int depth = 0;
+   bool addSpace = false;
+   char floatString[40];
+
+   theBody = get_struct(theEnv,lazyConstructBody);
+   theBody->ppOffset = PrettyPrintData(theEnv)->PPBufferPos;
+   theBody->ppBackupOnce = PrettyPrintData(theEnv)->PPBackupOnce;
+   theBody->ppBackupTwice = PrettyPrintData(theEnv)->PPBackupTwice;
+   theBody->indentationDepth = PrettyPrintData(theEnv)->IndentationDepth;
+   theBody->parseFailed = false;
+
+   /*=================================*/
+   /* Rebuild the parameter variables */
+   /* from the parsed parameter list. */
+   /*=================================*/
+
+   theString = AppendToString(theEnv,"(",theString,&pos,&max);
+   for (; parameterList != NULL ; parameterList = parameterList->nextArg)
+     {
+      if (addSpace)
+        { theString = AppendToString(theEnv," ",theString,&pos,&max); }
+
+      if ((parameterList->nextArg == NULL) && (wildcard != NULL))
+        { theString = AppendToString(theEnv,"$?",theString,&pos,&max); }
+      else
+        { theString = AppendToString(theEnv,"?",theString,&pos,&max); }
+
+      theString = AppendToString(theEnv,parameterList->lexemeValue->contents,theString,&pos,&max);
+      addSpace = true;
+     }
+   theString = AppendToString(theEnv,")",theString,&pos,&max);
+
+   /*=======================================================*/
+   /* Copy the tokens of the actions. Each action starts a  */
+   /* new line of the pretty print form and the arguments   */
+   /* are separated by spaces as done by the action parser. */
+   /*=======================================================*/
+
+   addSpace = false;
+   while (true)
+     {
+      if (addSpace)
+        {
+         if (depth == 0)
+           { PPCRAndIndent(theEnv); }
+         else
+           { SavePPBuffer(theEnv," "); }
+        }
+
+      GetToken(theEnv,readSource,inputToken);
+
+      if (inputToken->tknType == STOP_TOKEN)
+        {
+         SyntaxErrorMessage(theEnv,constructName);
+         genfree(theEnv,theString,max);
+         rtn_struct(theEnv,lazyConstructBody,theBody);
+         return NULL;
+        }
+
+      if (inputToken->tknType == RIGHT_PARENTHESIS_TOKEN)
+        {
+         theString = AppendToString(theEnv,")",theString,&pos,&max);
+         if (depth == 0) break;
+         depth--;
+
+         if (addSpace)
+           {
+            PPBackup(theEnv);
+            PPBackup(theEnv);
+            SavePPBuffer(theEnv,")");
+           }
+
+         addSpace = true;
+         continue;
+        }
+
+      theString = AppendToString(theEnv," ",theString,&pos,&max);
+
+      if (inputToken->tknType == LEFT_PARENTHESIS_TOKEN)
+        {
+         theString = AppendToString(theEnv,"(",theString,&pos,&max);
+         depth++;
+         addSpace = false;
+         continue;
+        }
+
+      if (inputToken->tknType == FLOAT_TOKEN)
+        {
+         gensnprintf(floatString,sizeof(floatString),"%.17g",inputToken->floatValue->contents);
+         if ((strchr(floatString,'.') == NULL) && (strchr(floatString,'e') == NULL))
+           { genstrcat(floatString,".0"); }
+         theString = AppendToString(theEnv,floatString,theString,&pos,&max);
+        }
+      else if (inputToken->tknType == INSTANCE_NAME_TOKEN)
+        {
+         theString = AppendToString(theEnv,"[",theString,&pos,&max);
+         theString = AppendToString(theEnv,inputToken->printForm,theString,&pos,&max);
+         theString = AppendToString(theEnv,"]",theString,&pos,&max);
+        }
+      else
+        { theString = AppendToString(theEnv,inputToken->printForm,theString,&pos,&max); }
+
+      addSpace = true;
+     }
+
+   /*==================================================*/
+   /* Keep only the memory needed for the text so that */
+   /* it can be released knowing only its length.      */
+   /*==================================================*/
+
+   theBody->text = (char *) gm2(theEnv,pos + 1);
+   genstrcpy(theBody->text,theString);
+   genfree(theEnv,theString,max);
+
+   return theBody;
+  }
+
+/***************************************************/
+/* ReturnLazyConstructBody: Releases the text read */
+/*   by ReadLazyConstructBody.                     */
+/***************************************************/
+void ReturnLazyConstructBody(
+  Environment *theEnv,
+  struct lazyConstructBody *theBody)
+  {
+   if (theBody == NULL) return;
+
+   rm(theEnv,theBody->text,strlen(theBody->text) + 1);
+   rtn_struct(theEnv,lazyConstructBody,theBody);
+  }
+
 #endif /* (! RUN_TIME) && (! BLOAD_ONLY) */
 
+#if RUN_TIME
+
+#include "envrnmnt.h"
+#include "symbol.h"
+
+/************************************************************/
+/* GetLazyConstructLoadingCommand: Run-time version of the  */
+/*   command. A constructs-to-c image refers to it although */
+/*   constructs can't be loaded into a run-time program.    */
+/************************************************************/
+void GetLazyConstructLoadingCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+#if MAC_XCD
+#pragma unused(context)
+#endif
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+  }
+
+/************************************************************/
+/* SetLazyConstructLoadingCommand: Run-time version of the  */
+/*   command.                                               */
+/************************************************************/
+void SetLazyConstructLoadingCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+#if MAC_XCD
+#pragma unused(context)
+#endif
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+  }
+
+#endif /* RUN_TIME */
+
 
@@ -327,7 +327,7 @@ void ValidateFactIntegrityCommand(
              (theSegment->contents[i].header->type == INSTANCE_NAME_TYPE))
            {
             theSymbol = theSegment->contents[i].lexemeValue;
-            if (theSymbol->count <= 0)
+            if ((theSymbol->count <= 0) && (! theSymbol->permanent))
               {
                returnValue->lexemeValue = FalseSymbol(theEnv);
                return;
@@ -337,7 +337,7 @@ void ValidateFactIntegrityCommand(
          if (theSegment->contents[i].header->type == INTEGER_TYPE)
            {
             theInteger = theSegment->contents[i].integerValue;
-            if (theInteger->count <= 0)
+            if ((theInteger->count <= 0) && (! theInteger->permanent))
               {
                returnValue->lexemeValue = FalseSymbol(theEnv);
                return;
@@ -347,7 +347,7 @@ void ValidateFactIntegrityCommand(
          if (theSegment->contents[i].header->type == FLOAT_TYPE)
            {
             theFloat = theSegment->contents[i].floatValue;
-            if (theFloat->count <= 0)
+            if ((theFloat->count <= 0) && (! theFloat->permanent))
               {
                returnValue->lexemeValue = FalseSymbol(theEnv);
                return;
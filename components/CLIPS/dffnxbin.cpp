@@ -47,6 +47,7 @@
 #include "envrnmnt.h"
 #include "memalloc.h"
 #include "modulbin.h"
+#include "userdata.h"
 
 #include "dffnxbin.h"
 
@@ -136,8 +137,12 @@ static void DeallocateDeffunctionBloadData(
   Environment *theEnv)
   {
    size_t space;
+   unsigned long i;
 
 #if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+   for (i = 0; i < DeffunctionBinaryData(theEnv)->DeffunctionCount; i++)
+     { ClearUserDataList(theEnv,DeffunctionBinaryData(theEnv)->DeffunctionArray[i].header.usrData); }
+
    space = DeffunctionBinaryData(theEnv)->DeffunctionCount * sizeof(Deffunction);
    if (space != 0) genfree(theEnv,DeffunctionBinaryData(theEnv)->DeffunctionArray,space);
 
@@ -481,6 +486,9 @@ static void UpdateDeffunction(
    dptr->minNumberOfParameters = bdptr->minNumberOfParameters;
    dptr->maxNumberOfParameters = bdptr->maxNumberOfParameters;
    dptr->numberOfLocalVars = bdptr->numberOfLocalVars;
+#if (! BLOAD_ONLY)
+   dptr->lazyBody = NULL;
+#endif
   }
 
 /***************************************************************
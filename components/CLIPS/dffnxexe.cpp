@@ -53,6 +53,9 @@
 
 #include "constrct.h"
 #include "envrnmnt.h"
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+#include "dffnxpsr.h"
+#endif
 #include "prcdrfun.h"
 #include "prccode.h"
 #include "prntutil.h"
@@ -118,6 +121,14 @@ void CallDeffunction(
    if (EvaluationData(theEnv)->HaltExecution)
      return;
 
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   if ((dptr->lazyBody != NULL) && (! ParseLazyDeffunction(theEnv,dptr)))
+     {
+      SetEvaluationError(theEnv,true);
+      return;
+     }
+#endif
+
    GCBlockStart(theEnv,&gcb);
 
    oldce = ExecutingConstruct(theEnv);
@@ -152,9 +163,9 @@ void CallDeffunction(
                 ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-   EvaluateProcActions(theEnv,dptr->header.whichModule->theModule,
-                       dptr->code,dptr->numberOfLocalVars,
-                       returnValue,UnboundDeffunctionErr);
+   EvaluateConstructActions(theEnv,dptr->header.whichModule->theModule,
+                            &dptr->header.usrData,dptr->code,dptr->numberOfLocalVars,
+                            returnValue,UnboundDeffunctionErr);
 
 #if PROFILING_FUNCTIONS
     EndProfile(theEnv,&profileFrame);
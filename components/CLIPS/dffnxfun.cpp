@@ -209,7 +209,8 @@ void SetupDeffunctions(
                                        NULL,
 #endif
                                        (FindConstructFunction *) FindDeffunction,
-                                       GetConstructNamePointer,GetConstructPPForm,
+                                       GetConstructNamePointer,
+                                       (const char *(*)(ConstructHeader *)) DeffunctionPPForm,
                                        GetConstructModuleItem,
                                        (GetNextConstructFunction *) GetNextDeffunction,
                                        SetNextConstruct,
@@ -231,6 +232,7 @@ void SetupDeffunctions(
 #endif
    AddSaveFunction(theEnv,"deffunction-headers",SaveDeffunctionHeaders,1000,NULL);
    AddSaveFunction(theEnv,"deffunctions",SaveDeffunctions,0,NULL);
+   AddLazyParseFunction(theEnv,"deffunctions",ParseLazyDeffunctions,0,NULL);
    AddUDF(theEnv,"undeffunction","v",1,1,"y",UndeffunctionCommand,"UndeffunctionCommand",NULL);
 #endif
 
@@ -313,6 +315,7 @@ static void DestroyDeffunctionAction(
    if (theDeffunction == NULL) return;
 
    ReturnPackedExpression(theEnv,theDeffunction->code);
+   ReturnLazyConstructBody(theEnv,theDeffunction->lazyBody);
 
    DestroyConstructHeader(theEnv,&theDeffunction->header);
 
@@ -507,6 +510,7 @@ void RemoveDeffunction(
    ReleaseLexeme(theEnv,GetDeffunctionNamePointer(theEnv,theDeffunction));
    ExpressionDeinstall(theEnv,theDeffunction->code);
    ReturnPackedExpression(theEnv,theDeffunction->code);
+   ReturnLazyConstructBody(theEnv,theDeffunction->lazyBody);
    SetDeffunctionPPForm(theEnv,theDeffunction,NULL);
    ClearUserDataList(theEnv,theDeffunction->header.usrData);
    rtn_struct(theEnv,deffunction,theDeffunction);
@@ -1169,6 +1173,17 @@ const char *DeffunctionName(
 const char *DeffunctionPPForm(
   Deffunction *theDeffunction)
   {
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   /*============================================*/
+   /* Actions deferred by lazy construct loading */
+   /* are parsed first so that they are laid out */
+   /* as they would have been by the parser.     */
+   /*============================================*/
+
+   if (theDeffunction->lazyBody != NULL)
+     { ParseLazyDeffunction(theDeffunction->header.env,theDeffunction); }
+#endif
+
    return GetConstructPPForm(&theDeffunction->header);
   }
 
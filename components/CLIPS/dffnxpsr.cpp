@@ -76,6 +76,10 @@
 #include "genrccom.h"
 #endif
 
+#if EXPRESSION_BYTECODE
+#include "bytecode.h"
+#endif
+
 #include "constant.h"
 #include "cstrccom.h"
 #include "cstrcpsr.h"
@@ -128,6 +132,7 @@ bool ParseDeffunction(
    unsigned short owMin = 0, owMax = 0;
    Deffunction *dptr;
    struct token inputToken;
+   struct lazyConstructBody *lazyBody = NULL;
    
    SetPPBufferStatus(theEnv,true);
 
@@ -200,10 +205,25 @@ bool ParseDeffunction(
 
    PPCRAndIndent(theEnv);
 
-   ExpressionData(theEnv)->ReturnContext = true;
-   actions = ParseProcActions(theEnv,"deffunction",readSource,
-                              &inputToken,parameterList,wildcard,
-                              NULL,NULL,&lvars,NULL);
+   /*================================================*/
+   /* In lazy construct loading mode the actions are */
+   /* only read here and parsed when first called.   */
+   /*================================================*/
+
+   if (GetLazyConstructLoading(theEnv) && (! ConstructData(theEnv)->CheckSyntaxMode))
+     {
+      actions = NULL;
+      lvars = 0;
+      lazyBody = ReadLazyConstructBody(theEnv,readSource,&inputToken,"deffunction",
+                                       parameterList,wildcard);
+     }
+   else
+     {
+      ExpressionData(theEnv)->ReturnContext = true;
+      actions = ParseProcActions(theEnv,"deffunction",readSource,
+                                 &inputToken,parameterList,wildcard,
+                                 NULL,NULL,&lvars,NULL);
+     }
 
    /*=============================================================*/
    /* Check for the closing right parenthesis of the deffunction. */
@@ -232,7 +252,7 @@ bool ParseDeffunction(
       return true;
      }
 
-   if (actions == NULL)
+   if ((actions == NULL) && (lazyBody == NULL))
      {
       ReturnExpression(theEnv,parameterList);
       if (overwrite)
@@ -284,13 +304,105 @@ bool ParseDeffunction(
    /* Add the deffunction. */
    /*======================*/
 
-   AddDeffunction(theEnv,deffunctionName,actions,min,max,lvars,false);
+   dptr = AddDeffunction(theEnv,deffunctionName,actions,min,max,lvars,false);
+   dptr->lazyBody = lazyBody;
 
    ReturnExpression(theEnv,parameterList);
 
    return(deffunctionError);
   }
 
+/***************************************************
+  NAME         : ParseLazyDeffunction
+  DESCRIPTION  : Parses the actions of a deffunction
+                 loaded in lazy construct loading
+                 mode
+  INPUTS       : The deffunction
+  RETURNS      : True if successful, false otherwise
+  SIDE EFFECTS : Actions installed and text released
+  NOTES        : The busy count is preserved since
+                 a recursive deffunction can be
+                 executing when it is parsed. The
+                 errors of actions which can not be
+                 parsed are only reported once.
+ ***************************************************/
+bool ParseLazyDeffunction(
+  Environment *theEnv,
+  Deffunction *dptr)
+  {
+   Expression *actions;
+   unsigned short lvars;
+   unsigned oldbusy;
+
+   if (dptr->lazyBody->parseFailed)
+     { return false; }
+
+   actions = ParseLazyProcActions(theEnv,"deffunction",dptr->header.whichModule->theModule,
+                                  dptr->lazyBody,&dptr->header,NULL,NULL,NULL,&lvars,NULL);
+   if (actions == NULL)
+     {
+      dptr->lazyBody->parseFailed = true;
+      PrintErrorID(theEnv,"DFFNXPSR",6,false);
+      WriteString(theEnv,STDERR,"The actions of deffunction '");
+      WriteString(theEnv,STDERR,DeffunctionName(dptr));
+      WriteString(theEnv,STDERR,"' could not be parsed.\n");
+      return false;
+     }
+
+   oldbusy = dptr->busy;
+   ExpressionInstall(theEnv,actions);
+   dptr->busy = oldbusy;
+   dptr->code = actions;
+   dptr->numberOfLocalVars = lvars;
+
+   ReturnLazyConstructBody(theEnv,dptr->lazyBody);
+   dptr->lazyBody = NULL;
+
+   return true;
+  }
+
+/***************************************************
+  NAME         : ParseLazyDeffunctions
+  DESCRIPTION  : Parses the actions of all the
+                 deffunctions which have not been
+                 called since they were loaded in
+                 lazy construct loading mode
+  INPUTS       : Not used
+  RETURNS      : False if the actions of any
+                 deffunction contain errors
+  SIDE EFFECTS : Actions installed
+  NOTES        : Called by ParseLazyConstructs
+ ***************************************************/
+bool ParseLazyDeffunctions(
+  Environment *theEnv,
+  void *context)
+  {
+   Defmodule *theModule;
+   Deffunction *dptr;
+   bool rv = true;
+#if MAC_XCD
+#pragma unused(context)
+#endif
+
+   SaveCurrentModule(theEnv);
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+      for (dptr = GetNextDeffunction(theEnv,NULL);
+           dptr != NULL;
+           dptr = GetNextDeffunction(theEnv,dptr))
+        {
+         if ((dptr->lazyBody != NULL) && (! ParseLazyDeffunction(theEnv,dptr)))
+           { rv = false; }
+        }
+     }
+   RestoreCurrentModule(theEnv);
+
+   return rv;
+  }
+
 /* =========================================
    *****************************************
           INTERNALLY VISIBLE FUNCTIONS
@@ -452,6 +564,7 @@ static Deffunction *AddDeffunction(
       dfuncPtr->numberOfLocalVars = lvars;
       dfuncPtr->busy = 0;
       dfuncPtr->executing = 0;
+      dfuncPtr->lazyBody = NULL;
      }
    else
      {
@@ -466,7 +579,12 @@ static Deffunction *AddDeffunction(
       dfuncPtr->busy = oldbusy;
       ReturnPackedExpression(theEnv,dfuncPtr->code);
       dfuncPtr->code = NULL;
+      ReturnLazyConstructBody(theEnv,dfuncPtr->lazyBody);
+      dfuncPtr->lazyBody = NULL;
       SetDeffunctionPPForm(theEnv,dfuncPtr,NULL);
+#if EXPRESSION_BYTECODE
+      DiscardBytecode(theEnv,&dfuncPtr->header.usrData);
+#endif
 
       /*======================================*/
       /* Remove the deffunction from the list */
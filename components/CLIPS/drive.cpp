@@ -64,6 +64,7 @@
 #include "lgcldpnd.h"
 #include "memalloc.h"
 #include "prntutil.h"
+#include "rangemem.h"
 #include "reteutil.h"
 #include "retract.h"
 #include "router.h"
@@ -76,6 +77,11 @@
 
    static void                    EmptyDrive(Environment *,struct joinNode *,struct partialMatch *,int);
    static void                    JoinNetErrorMessage(Environment *,struct joinNode *);
+   static bool                    EvaluateJoinComparison(Environment *,struct expr *,bool *);
+   static bool                    EvaluateJoinComparisonArgument(Environment *,struct expr *,UDFValue *);
+#if JOIN_STATISTICS
+   static void                    RecordJoinScan(struct joinNode *,long long);
+#endif
 
 /************************************************/
 /* NetworkAssert: Primary routine for filtering */
@@ -130,6 +136,11 @@ void NetworkAssertRight(
    struct partialMatch *oldLHSBinds = NULL;
    struct partialMatch *oldRHSBinds = NULL;
    struct joinNode *oldJoin = NULL;
+   struct rangeEntry *candidates = NULL;
+   unsigned long candidateCount = 0, nextCandidate = 0;
+#if JOIN_STATISTICS
+   long long comparesBefore;
+#endif
 
    /*=========================================================*/
    /* If an incremental reset is being performed and the join */
@@ -146,6 +157,10 @@ void NetworkAssertRight(
       return;
      }
 
+#if JOIN_STATISTICS
+   join->statistics.rightActivations++;
+#endif
+
    /*=====================================================*/
    /* The partial matches entering from the LHS of a join */
    /* are stored in the left beta memory of the join.     */
@@ -153,11 +168,35 @@ void NetworkAssertRight(
 
    lhsBinds = GetLeftBetaMemory(join,rhsBinds->hashValue);
 
+   /*=====================================================*/
+   /* If the left memory is sorted on the value compared  */
+   /* with the RHS, then only the partial matches in the  */
+   /* range satisfying the comparison need to be checked. */
+   /*=====================================================*/
+
+   if ((lhsBinds != NULL) && (join->rangeIndex != NULL) &&
+       GetRangeMemoryCandidates(theEnv,join,rhsBinds,RHS,&candidates,&candidateCount))
+     {
+      if (candidateCount == 0)
+        { lhsBinds = NULL; }
+      else
+        {
+         lhsBinds = candidates[0].theMatch;
+         nextCandidate = 1;
+        }
+     }
+
 #if DEVELOPER
    if (lhsBinds != NULL)
      { EngineData(theEnv)->rightToLeftLoops++; }
 #endif
 
+#if JOIN_STATISTICS
+   if (lhsBinds != NULL)
+     { join->statistics.memoryScans++; }
+   comparesBefore = join->memoryCompares;
+#endif
+
    /*====================================*/
    /* Set up the evaluation environment. */
    /*====================================*/
@@ -181,7 +220,13 @@ void NetworkAssertRight(
 
    while (lhsBinds != NULL)
      {
-      nextBind = lhsBinds->nextInMemory;
+      if (candidates == NULL)
+        { nextBind = lhsBinds->nextInMemory; }
+      else if (nextCandidate < candidateCount)
+        { nextBind = candidates[nextCandidate++].theMatch; }
+      else
+        { nextBind = NULL; }
+
       join->memoryCompares++;
 
       /*===========================================================*/
@@ -299,6 +344,12 @@ void NetworkAssertRight(
       lhsBinds = nextBind;
      }
 
+#if JOIN_STATISTICS
+   RecordJoinScan(join,comparesBefore);
+#endif
+
+   ReturnRangeMemoryCandidates(theEnv,candidates,candidateCount);
+
    /*=========================================*/
    /* Restore the old evaluation environment. */
    /*=========================================*/
@@ -324,12 +375,17 @@ void NetworkAssertLeft(
   struct joinNode *join,
   int operation)
   {
-   struct partialMatch *rhsBinds;
+   struct partialMatch *rhsBinds, *nextBind;
    bool exprResult, restore = false;
    unsigned long entryHashValue;
    struct partialMatch *oldLHSBinds = NULL;
    struct partialMatch *oldRHSBinds = NULL;
    struct joinNode *oldJoin = NULL;
+   struct rangeEntry *candidates = NULL;
+   unsigned long candidateCount = 0, nextCandidate = 0;
+#if JOIN_STATISTICS
+   long long comparesBefore;
+#endif
 
    if ((operation == NETWORK_RETRACT) && PartialMatchWillBeDeleted(theEnv,lhsBinds))
      { return; }
@@ -343,6 +399,10 @@ void NetworkAssertLeft(
    if (EngineData(theEnv)->IncrementalResetInProgress && (join->initialize == false)) return;
 #endif
 
+#if JOIN_STATISTICS
+   join->statistics.leftActivations++;
+#endif
+
    /*===================================*/
    /* The only action for the last join */
    /* of a rule is to activate it.      */
@@ -350,6 +410,9 @@ void NetworkAssertLeft(
 
    if (join->ruleToActivate != NULL)
      {
+#if JOIN_STATISTICS
+      join->statistics.matchesOut++;
+#endif
       AddActivation(theEnv,join->ruleToActivate,lhsBinds);
       return;
      }
@@ -397,13 +460,39 @@ void NetworkAssertLeft(
    if (join->joinFromTheRight)
      { rhsBinds = GetRightBetaMemory(join,entryHashValue); }
    else
-     { rhsBinds = GetAlphaMemory(theEnv,(struct patternNodeHeader *) join->rightSideEntryStructure,entryHashValue); }
+     {
+      rhsBinds = GetAlphaMemory(theEnv,(struct patternNodeHeader *) join->rightSideEntryStructure,entryHashValue);
+
+      /*=====================================================*/
+      /* If the alpha memory is sorted on the value compared */
+      /* with the LHS, then only the partial matches within  */
+      /* the bounds computed from the LHS need be checked.   */
+      /*=====================================================*/
+
+      if ((rhsBinds != NULL) && (join->rangeIndex != NULL) &&
+          GetRangeMemoryCandidates(theEnv,join,lhsBinds,LHS,&candidates,&candidateCount))
+        {
+         if (candidateCount == 0)
+           { rhsBinds = NULL; }
+         else
+           {
+            rhsBinds = candidates[0].theMatch;
+            nextCandidate = 1;
+           }
+        }
+     }
 
 #if DEVELOPER
    if (rhsBinds != NULL)
      { EngineData(theEnv)->leftToRightLoops++; }
 #endif
 
+#if JOIN_STATISTICS
+   if (rhsBinds != NULL)
+     { join->statistics.memoryScans++; }
+   comparesBefore = join->memoryCompares;
+#endif
+
    /*====================================*/
    /* Set up the evaluation environment. */
    /*====================================*/
@@ -427,9 +516,16 @@ void NetworkAssertLeft(
 
    while (rhsBinds != NULL)
      {
+      if (candidates == NULL)
+        { nextBind = rhsBinds->nextInMemory; }
+      else if (nextCandidate < candidateCount)
+        { nextBind = candidates[nextCandidate++].theMatch; }
+      else
+        { nextBind = NULL; }
+
       if ((operation == NETWORK_RETRACT) && PartialMatchWillBeDeleted(theEnv,rhsBinds))
         {
-         rhsBinds = rhsBinds->nextInMemory;
+         rhsBinds = nextBind;
          continue;
         }
 
@@ -511,6 +607,10 @@ void NetworkAssertLeft(
            {
             AddBlockedLink(lhsBinds,rhsBinds);
             PPDrive(theEnv,lhsBinds,NULL,join,operation);
+#if JOIN_STATISTICS
+            RecordJoinScan(join,comparesBefore);
+#endif
+            ReturnRangeMemoryCandidates(theEnv,candidates,candidateCount);
             EngineData(theEnv)->GlobalLHSBinds = oldLHSBinds;
             EngineData(theEnv)->GlobalRHSBinds = oldRHSBinds;
             EngineData(theEnv)->GlobalJoin = oldJoin;
@@ -539,9 +639,15 @@ void NetworkAssertLeft(
       /* Move on to the next partial match. */
       /*====================================*/
 
-      rhsBinds = rhsBinds->nextInMemory;
+      rhsBinds = nextBind;
      }
 
+#if JOIN_STATISTICS
+   RecordJoinScan(join,comparesBefore);
+#endif
+
+   ReturnRangeMemoryCandidates(theEnv,candidates,candidateCount);
+
    /*==================================================================*/
    /* If a join with an associated not CE or join from the right was   */
    /* entered from the LHS side of the join, and the join expression   */
@@ -596,7 +702,6 @@ bool EvaluateJoinExpression(
   struct expr *joinExpr,
   struct joinNode *joinPtr)
   {
-   UDFValue theResult;
    bool andLogic, result = true;
 
    /*======================================*/
@@ -605,6 +710,15 @@ bool EvaluateJoinExpression(
 
    if (joinExpr == NULL) return true;
 
+   /*=====================================================*/
+   /* If constructs-to-c generated a C function for the   */
+   /* network test of the join, use it to evaluate it.    */
+   /*=====================================================*/
+
+   if ((joinExpr == joinPtr->networkTest) &&
+       (joinPtr->networkTestFunction != NULL))
+     { return (*joinPtr->networkTestFunction)(theEnv,joinPtr); }
+
    /*====================================================*/
    /* Initialize some variables which allow this routine */
    /* to avoid calling the "and" and "or" functions if   */
@@ -634,98 +748,315 @@ bool EvaluateJoinExpression(
 
    while (joinExpr != NULL)
      {
-      /*================================*/
-      /* Evaluate a primitive function. */
-      /*================================*/
+      if (! EvaluateJoinTest(theEnv,joinExpr,joinPtr,&result))
+        { return false; }
 
-      if ((EvaluationData(theEnv)->PrimitivesArray[joinExpr->type] == NULL) ?
-          false :
-          EvaluationData(theEnv)->PrimitivesArray[joinExpr->type]->evaluateFunction != NULL)
-        {
-         struct expr *oldArgument;
+      /*====================================*/
+      /* Handle the short cut evaluation of */
+      /* the "and" and "or" functions.      */
+      /*====================================*/
 
-         oldArgument = EvaluationData(theEnv)->CurrentExpression;
-         EvaluationData(theEnv)->CurrentExpression = joinExpr;
-         result = (*EvaluationData(theEnv)->PrimitivesArray[joinExpr->type]->evaluateFunction)(theEnv,joinExpr->value,&theResult);
-         EvaluationData(theEnv)->CurrentExpression = oldArgument;
-        }
+      if ((andLogic == true) && (result == false))
+        { return false; }
+      else if ((andLogic == false) && (result == true))
+        { return true; }
+
+      /*==============================================*/
+      /* Move to the next expression to be evaluated. */
+      /*==============================================*/
+
+      joinExpr = joinExpr->nextArg;
+     }
+
+   /*=================================================*/
+   /* Return the result of evaluating the expression. */
+   /*=================================================*/
 
-      /*=============================*/
-      /* Evaluate the "or" function. */
-      /*=============================*/
+   return(result);
+  }
 
-      else if (joinExpr->value == ExpressionData(theEnv)->PTR_OR)
+/*******************************************************/
+/* EvaluateJoinTest: Evaluates one of the expressions  */
+/*   linked together in a join expression and stores   */
+/*   its value in result. Returns false if an error    */
+/*   occurred, in which case the join expression is    */
+/*   false. Also used by the functions generated by    */
+/*   constructs-to-c for the join network tests.       */
+/*******************************************************/
+bool EvaluateJoinTest(
+  Environment *theEnv,
+  struct expr *joinExpr,
+  struct joinNode *joinPtr,
+  bool *result)
+  {
+   UDFValue theResult;
+
+   /*================================*/
+   /* Evaluate a primitive function. */
+   /*================================*/
+
+   if ((EvaluationData(theEnv)->PrimitivesArray[joinExpr->type] == NULL) ?
+       false :
+       EvaluationData(theEnv)->PrimitivesArray[joinExpr->type]->evaluateFunction != NULL)
+     {
+      struct expr *oldArgument;
+
+      oldArgument = EvaluationData(theEnv)->CurrentExpression;
+      EvaluationData(theEnv)->CurrentExpression = joinExpr;
+      *result = (*EvaluationData(theEnv)->PrimitivesArray[joinExpr->type]->evaluateFunction)(theEnv,joinExpr->value,&theResult);
+      EvaluationData(theEnv)->CurrentExpression = oldArgument;
+     }
+
+   /*=============================*/
+   /* Evaluate the "or" function. */
+   /*=============================*/
+
+   else if (joinExpr->value == ExpressionData(theEnv)->PTR_OR)
+     {
+      *result = false;
+      if (EvaluateJoinExpression(theEnv,joinExpr,joinPtr) == true)
         {
-         result = false;
-         if (EvaluateJoinExpression(theEnv,joinExpr,joinPtr) == true)
-           {
-            if (EvaluationData(theEnv)->EvaluationError)
-              { return false; }
-            result = true;
-           }
-         else if (EvaluationData(theEnv)->EvaluationError)
+         if (EvaluationData(theEnv)->EvaluationError)
            { return false; }
+         *result = true;
         }
+      else if (EvaluationData(theEnv)->EvaluationError)
+        { return false; }
+     }
 
-      /*==============================*/
-      /* Evaluate the "and" function. */
-      /*==============================*/
+   /*==============================*/
+   /* Evaluate the "and" function. */
+   /*==============================*/
 
-      else if (joinExpr->value == ExpressionData(theEnv)->PTR_AND)
+   else if (joinExpr->value == ExpressionData(theEnv)->PTR_AND)
+     {
+      *result = true;
+      if (EvaluateJoinExpression(theEnv,joinExpr,joinPtr) == false)
         {
-         result = true;
-         if (EvaluateJoinExpression(theEnv,joinExpr,joinPtr) == false)
-           {
-            if (EvaluationData(theEnv)->EvaluationError)
-              { return false; }
-            result = false;
-           }
-         else if (EvaluationData(theEnv)->EvaluationError)
+         if (EvaluationData(theEnv)->EvaluationError)
            { return false; }
+         *result = false;
         }
+      else if (EvaluationData(theEnv)->EvaluationError)
+        { return false; }
+     }
 
-      /*==========================================================*/
-      /* Evaluate all other expressions using EvaluateExpression. */
-      /*==========================================================*/
+   /*================================================*/
+   /* Evaluate simple comparisons of join variables  */
+   /* and constants without the function call layer. */
+   /*================================================*/
 
-      else
-        {
-         EvaluateExpression(theEnv,joinExpr,&theResult);
+   else if (EvaluateJoinComparison(theEnv,joinExpr,result))
+     { /* Do Nothing */ }
 
-         if (EvaluationData(theEnv)->EvaluationError)
-           {
-            JoinNetErrorMessage(theEnv,joinPtr);
-            return false;
-           }
+   /*==========================================================*/
+   /* Evaluate all other expressions using EvaluateExpression. */
+   /*==========================================================*/
 
-         if (theResult.value == FalseSymbol(theEnv))
-           { result = false; }
-         else
-           { result = true; }
+   else
+     {
+      EvaluateExpression(theEnv,joinExpr,&theResult);
+
+      if (EvaluationData(theEnv)->EvaluationError)
+        {
+         JoinNetErrorMessage(theEnv,joinPtr);
+         return false;
         }
 
-      /*====================================*/
-      /* Handle the short cut evaluation of */
-      /* the "and" and "or" functions.      */
-      /*====================================*/
+      if (theResult.value == FalseSymbol(theEnv))
+        { *result = false; }
+      else
+        { *result = true; }
+     }
 
-      if ((andLogic == true) && (result == false))
+   return true;
+  }
+
+/*******************************************************/
+/* EvaluateJoinComparison: Directly evaluates a join   */
+/*   test of the form (<op> <arg1> <arg2>) where <op>  */
+/*   is one of the numeric comparison functions or eq/ */
+/*   neq and each argument is a constant or a join     */
+/*   network variable reference. These are the most    */
+/*   common join tests and handling them here avoids   */
+/*   the argument checking and coercion performed by   */
+/*   the general function call. Returns false if the   */
+/*   expression is not of this form or if the values   */
+/*   retrieved are not valid for the comparison, in    */
+/*   which case the expression is evaluated (and any   */
+/*   error reported) using EvaluateExpression.         */
+/*******************************************************/
+static bool EvaluateJoinComparison(
+  Environment *theEnv,
+  struct expr *joinExpr,
+  bool *result)
+  {
+   FunctionDefinition *theFunction;
+   struct expr *arg1, *arg2;
+   UDFValue rv1, rv2;
+
+   /*==========================================*/
+   /* Determine if the expression is a call to */
+   /* one of the comparison functions.         */
+   /*==========================================*/
+
+   if (joinExpr->type != FCALL)
+     { return false; }
+
+   theFunction = joinExpr->functionValue;
+
+   if ((theFunction != ExpressionData(theEnv)->PTR_EQ) &&
+       (theFunction != ExpressionData(theEnv)->PTR_NEQ) &&
+       (theFunction != ExpressionData(theEnv)->PTR_LT) &&
+       (theFunction != ExpressionData(theEnv)->PTR_LE) &&
+       (theFunction != ExpressionData(theEnv)->PTR_GT) &&
+       (theFunction != ExpressionData(theEnv)->PTR_GE) &&
+       (theFunction != ExpressionData(theEnv)->PTR_NUM_EQ) &&
+       (theFunction != ExpressionData(theEnv)->PTR_NUM_NEQ))
+     { return false; }
+
+   /*=====================================*/
+   /* The comparison must have exactly    */
+   /* two arguments, each of which can be */
+   /* retrieved without side effects.     */
+   /*=====================================*/
+
+   arg1 = joinExpr->argList;
+   if (arg1 == NULL)
+     { return false; }
+
+   arg2 = arg1->nextArg;
+   if ((arg2 == NULL) || (arg2->nextArg != NULL))
+     { return false; }
+
+   if (! EvaluateJoinComparisonArgument(theEnv,arg1,&rv1))
+     { return false; }
+
+   if (! EvaluateJoinComparisonArgument(theEnv,arg2,&rv2))
+     { return false; }
+
+   /*==================================================*/
+   /* The eq and neq functions compare the values. The */
+   /* multifield comparison is left to the functions.  */
+   /*==================================================*/
+
+   if ((theFunction == ExpressionData(theEnv)->PTR_EQ) ||
+       (theFunction == ExpressionData(theEnv)->PTR_NEQ))
+     {
+      if ((rv1.header->type == MULTIFIELD_TYPE) ||
+          (rv2.header->type == MULTIFIELD_TYPE))
         { return false; }
-      else if ((andLogic == false) && (result == true))
-        { return true; }
 
-      /*==============================================*/
-      /* Move to the next expression to be evaluated. */
-      /*==============================================*/
+      if (theFunction == ExpressionData(theEnv)->PTR_EQ)
+        { *result = (rv1.value == rv2.value); }
+      else
+        { *result = (rv1.value != rv2.value); }
 
-      joinExpr = joinExpr->nextArg;
+      return true;
      }
 
-   /*=================================================*/
-   /* Return the result of evaluating the expression. */
-   /*=================================================*/
+   /*================================================*/
+   /* The numeric comparisons are performed exactly  */
+   /* as they are by the functions: as integers when */
+   /* both values are integers, otherwise as floats. */
+   /* Non-numeric values are left to the functions   */
+   /* so that the type error is reported.            */
+   /*================================================*/
 
-   return(result);
+   if (((rv1.header->type != INTEGER_TYPE) && (rv1.header->type != FLOAT_TYPE)) ||
+       ((rv2.header->type != INTEGER_TYPE) && (rv2.header->type != FLOAT_TYPE)))
+     { return false; }
+
+   if ((rv1.header->type == INTEGER_TYPE) && (rv2.header->type == INTEGER_TYPE))
+     {
+      long long i1 = rv1.integerValue->contents;
+      long long i2 = rv2.integerValue->contents;
+
+      if (theFunction == ExpressionData(theEnv)->PTR_LT)
+        { *result = ! (i1 >= i2); }
+      else if (theFunction == ExpressionData(theEnv)->PTR_LE)
+        { *result = ! (i1 > i2); }
+      else if (theFunction == ExpressionData(theEnv)->PTR_GT)
+        { *result = ! (i1 <= i2); }
+      else if (theFunction == ExpressionData(theEnv)->PTR_GE)
+        { *result = ! (i1 < i2); }
+      else if (theFunction == ExpressionData(theEnv)->PTR_NUM_EQ)
+        { *result = ! (i1 != i2); }
+      else
+        { *result = ! (i1 == i2); }
+     }
+   else
+     {
+      double f1 = CVCoerceToFloat(&rv1);
+      double f2 = CVCoerceToFloat(&rv2);
+
+      if (theFunction == ExpressionData(theEnv)->PTR_LT)
+        { *result = ! (f1 >= f2); }
+      else if (theFunction == ExpressionData(theEnv)->PTR_LE)
+        { *result = ! (f1 > f2); }
+      else if (theFunction == ExpressionData(theEnv)->PTR_GT)
+        { *result = ! (f1 <= f2); }
+      else if (theFunction == ExpressionData(theEnv)->PTR_GE)
+        { *result = ! (f1 < f2); }
+      else if (theFunction == ExpressionData(theEnv)->PTR_NUM_EQ)
+        { *result = ! (f1 != f2); }
+      else
+        { *result = ! (f1 == f2); }
+     }
+
+   return true;
+  }
+
+/*******************************************************/
+/* EvaluateJoinComparisonArgument: Retrieves the value */
+/*   of an argument to a comparison evaluated by the   */
+/*   EvaluateJoinComparison function. Only constants   */
+/*   and join network variable references, which have  */
+/*   no side effects, are retrieved. Returns false for */
+/*   any other kind of argument.                       */
+/*******************************************************/
+static bool EvaluateJoinComparisonArgument(
+  Environment *theEnv,
+  struct expr *theArgument,
+  UDFValue *returnValue)
+  {
+   struct expr *oldArgument;
+   struct entityRecord *thePrimitive;
+
+   switch (theArgument->type)
+     {
+      case FLOAT_TYPE:
+      case INTEGER_TYPE:
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+        returnValue->value = theArgument->value;
+        return true;
+
+      case FACT_JN_VAR1:
+      case FACT_JN_VAR2:
+      case FACT_JN_VAR3:
+      case OBJ_GET_SLOT_JNVAR1:
+      case OBJ_GET_SLOT_JNVAR2:
+        break;
+
+      default:
+        return false;
+     }
+
+   thePrimitive = EvaluationData(theEnv)->PrimitivesArray[theArgument->type];
+   if ((thePrimitive == NULL) || (thePrimitive->evaluateFunction == NULL))
+     { return false; }
+
+   oldArgument = EvaluationData(theEnv)->CurrentExpression;
+   EvaluationData(theEnv)->CurrentExpression = theArgument;
+   (*thePrimitive->evaluateFunction)(theEnv,theArgument->value,returnValue);
+   EvaluationData(theEnv)->CurrentExpression = oldArgument;
+
+   if (EvaluationData(theEnv)->EvaluationError)
+     { return false; }
+
+   return true;
   }
 
 /*********************************/
@@ -910,6 +1241,10 @@ void PPDrive(
    struct joinLink *listOfJoins;
    unsigned long hashValue;
 
+#if JOIN_STATISTICS
+   join->statistics.matchesOut++;
+#endif
+
    /*================================================*/
    /* Send the new partial match to all child joins. */
    /*================================================*/
@@ -980,6 +1315,10 @@ void EPMDrive(
    struct partialMatch *linker;
    struct joinLink *listOfJoins;
 
+#if JOIN_STATISTICS
+   join->statistics.matchesOut++;
+#endif
+
    listOfJoins = join->nextLinks;
    if (listOfJoins == NULL) return;
 
@@ -1017,6 +1356,10 @@ static void EmptyDrive(
    struct partialMatch *oldRHSBinds;
    struct joinNode *oldJoin;
 
+#if JOIN_STATISTICS
+   join->statistics.rightActivations++;
+#endif
+
    /*======================================================*/
    /* Determine if the alpha memory partial match satifies */
    /* the join expression. If it doesn't then no further   */
@@ -1109,6 +1452,10 @@ static void EmptyDrive(
    /* Send the partial match to all child joins. */
    /*============================================*/
 
+#if JOIN_STATISTICS
+   join->statistics.matchesOut++;
+#endif
+
    listOfJoins = join->nextLinks;
    if (listOfJoins == NULL) return;
 
@@ -1172,6 +1519,25 @@ static void EmptyDrive(
      }
   }
 
+#if JOIN_STATISTICS
+
+/********************************************************/
+/* RecordJoinScan: Keeps the largest number of partial  */
+/*   matches compared in one scan of a join's opposite  */
+/*   memory, given the compare count before the scan.   */
+/********************************************************/
+static void RecordJoinScan(
+  struct joinNode *join,
+  long long comparesBefore)
+  {
+   unsigned long scanLength = (unsigned long) (join->memoryCompares - comparesBefore);
+
+   if (scanLength > join->statistics.longestScan)
+     { join->statistics.longestScan = scanLength; }
+  }
+
+#endif
+
 /********************************************************************/
 /* JoinNetErrorMessage: Prints an informational message indicating  */
 /*   which join of a rule generated an error when a join expression */
@@ -105,6 +105,9 @@
 #include "commline.h"
 #include "constant.h"
 #include "envrnmnt.h"
+#if EVENT_TRACE_FUNCTIONS
+#include "evtrace.h"
+#endif
 #include "factmngr.h"
 #include "inscom.h"
 #include "memalloc.h"
@@ -117,6 +120,9 @@
 #include "retract.h"
 #include "router.h"
 #include "ruledlt.h"
+#if RULE_LATENCY_FUNCTIONS
+#include "rulelat.h"
+#endif
 #include "sysdep.h"
 #include "utility.h"
 #include "watch.h"
@@ -128,6 +134,7 @@
 /***************************************/
 
    static Defmodule              *RemoveFocus(Environment *,Defmodule *);
+   static bool                    RunDeadlinePassed(Environment *);
    static void                    DeallocateEngineData(Environment *);
 
 /*****************************************************************************/
@@ -200,6 +207,10 @@ long long Run(
    int danglingConstructs;
    GCBlock gcb;
    bool error = false;
+#if RULE_LATENCY_FUNCTIONS
+   bool timeFiring;
+   long long firingStart = 0;
+#endif
 
    /*=====================================================*/
    /* Make sure the run command is not already executing. */
@@ -266,14 +277,18 @@ long long Run(
 
    /*=====================================================*/
    /* Fire rules until the agenda is empty, the run limit */
-   /* has been reached, or a rule execution error occurs. */
+   /* has been reached, a rule execution error occurs, or */
+   /* the deadline of a time sliced run has passed. At    */
+   /* least one rule is fired in each slice so that a     */
+   /* slice shorter than one firing still makes progress. */
    /*=====================================================*/
 
    theActivation = NextActivationToFire(theEnv);
    while ((theActivation != NULL) &&
           (runLimit != 0) &&
           (EvaluationData(theEnv)->HaltExecution == false) &&
-          (EngineData(theEnv)->HaltRules == false))
+          (EngineData(theEnv)->HaltRules == false) &&
+          ((rulesFired == 0) || (RunDeadlinePassed(theEnv) == false)))
      {
       /*========================================*/
       /* Execute the list of functions that are */
@@ -324,6 +339,11 @@ long long Run(
         }
 #endif
 
+#if EVENT_TRACE_FUNCTIONS
+      if (EventTraceData(theEnv)->Tracing)
+        { RecordTraceEvent(theEnv,TRACE_FIRE,(long long) theActivation->timetag,theActivation->theRule); }
+#endif
+
       /*=================================================*/
       /* Remove the link between the activation and the  */
       /* completed match for the rule. Set the busy flag */
@@ -385,9 +405,16 @@ long long Run(
                    ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-      EvaluateProcActions(theEnv,EngineData(theEnv)->ExecutingRule->header.whichModule->theModule,
-                          EngineData(theEnv)->ExecutingRule->actions,EngineData(theEnv)->ExecutingRule->localVarCnt,
-                          &returnValue,NULL);
+#if RULE_LATENCY_FUNCTIONS
+      timeFiring = RuleLatencyData(theEnv)->Tracking;
+      if (timeFiring)
+        { firingStart = genmicrotime(); }
+#endif
+
+      EvaluateConstructActions(theEnv,EngineData(theEnv)->ExecutingRule->header.whichModule->theModule,
+                               &EngineData(theEnv)->ExecutingRule->header.usrData,
+                               EngineData(theEnv)->ExecutingRule->actions,EngineData(theEnv)->ExecutingRule->localVarCnt,
+                               &returnValue,NULL);
 
 #if PROFILING_FUNCTIONS
       EndProfile(theEnv,&profileFrame);
@@ -486,6 +513,12 @@ long long Run(
       /*==================================*/
 
       CleanCurrentGarbageFrame(theEnv,NULL);
+
+#if RULE_LATENCY_FUNCTIONS
+      if (timeFiring)
+        { RecordRuleLatency(theEnv,EngineData(theEnv)->ExecutingRule,genmicrotime() - firingStart); }
+#endif
+
       CallPeriodicTasks(theEnv);
 
       /*==========================*/
@@ -550,6 +583,16 @@ long long Run(
         }
      }
 
+   /*=========================================*/
+   /* Remember whether activations were left  */
+   /* on the agenda when the deadline passed. */
+   /*=========================================*/
+
+   EngineData(theEnv)->RunSlicePending = ((theActivation != NULL) &&
+                                          (runLimit != 0) &&
+                                          (EvaluationData(theEnv)->HaltExecution == false) &&
+                                          (EngineData(theEnv)->HaltRules == false));
+
    /*=====================================================*/
    /* Make sure run functions are executed at least once. */
    /*=====================================================*/
@@ -701,6 +744,55 @@ long long Run(
    return rulesFired;
   }
 
+/**************************************************************/
+/* RunFor: Fires rules until the agenda is empty or the given */
+/*   number of microseconds has passed, so that the caller    */
+/*   can yield to other tasks between the slices of a long    */
+/*   run. Returns the number of rules fired. RunSlicePending  */
+/*   tells whether activations were left to fire.             */
+/**************************************************************/
+long long RunFor(
+  Environment *theEnv,
+  long long microseconds)
+  {
+   long long rulesFired;
+
+   if (EngineData(theEnv)->AlreadyRunning)
+     { return 0; }
+
+   if (microseconds < 1)
+     { microseconds = 1; }
+
+   EngineData(theEnv)->RunDeadline = genmicrotime() + microseconds;
+   rulesFired = Run(theEnv,-1);
+   EngineData(theEnv)->RunDeadline = 0;
+
+   return rulesFired;
+  }
+
+/*************************************************************/
+/* RunSlicePending: Returns true if the last time sliced run */
+/*   stopped at its deadline with activations left to fire.  */
+/*************************************************************/
+bool RunSlicePending(
+  Environment *theEnv)
+  {
+   return EngineData(theEnv)->RunSlicePending;
+  }
+
+/****************************************************/
+/* RunDeadlinePassed: Returns true if the deadline  */
+/*   of a time sliced run has passed.               */
+/****************************************************/
+static bool RunDeadlinePassed(
+  Environment *theEnv)
+  {
+   if (EngineData(theEnv)->RunDeadline == 0)
+     { return false; }
+
+   return (genmicrotime() >= EngineData(theEnv)->RunDeadline);
+  }
+
 /***********************************************************/
 /* NextActivationToFire: Returns the next activation which */
 /*   should be executed based on the current focus.        */
@@ -1172,6 +1264,30 @@ void RunCommand(
    Run(theEnv,runLimit);
   }
 
+/*************************************/
+/* RunForCommand: H/L access routine */
+/*   for the run-for command.        */
+/*************************************/
+void RunForCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   if (! UDFFirstArgument(context,INTEGER_BIT,&theArg))
+     { return; }
+
+   if (theArg.integerValue->contents < 1)
+     {
+      UDFInvalidArgumentMessage(context,"integer greater than or equal to 1");
+      returnValue->integerValue = CreateInteger(theEnv,-1);
+      return;
+     }
+
+   returnValue->integerValue = CreateInteger(theEnv,RunFor(theEnv,theArg.integerValue->contents));
+  }
+
 /***********************************************/
 /* HaltCommand: Causes rule execution to halt. */
 /***********************************************/
@@ -1191,6 +1307,7 @@ void Halt(
   Environment *theEnv)
   {
    EngineData(theEnv)->HaltRules = true;
+   EngineData(theEnv)->RunSlicePending = false;
   }
 
 #if DEBUGGING_FUNCTIONS
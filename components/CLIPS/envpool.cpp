@@ -0,0 +1,675 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*               ENVIRONMENT POOL MODULE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Runs a set of environments loaded from the same  */
+/*   binary image in worker threads pinned to the available  */
+/*   cores, dispatching tasks to them through work-stealing  */
+/*   queues.                                                 */
+/*                                                           */
+/*   Environments are independent of each other, but an      */
+/*   environment can only be used by one thread at a time.   */
+/*   Each environment is therefore owned by a worker thread  */
+/*   and is only used by the tasks run by that worker. The   */
+/*   binary image is only read while the environments are    */
+/*   created, so it can be shared by all of them (for        */
+/*   example a flash partition mapped into memory).          */
+/*                                                           */
+/*   Each worker has its own queue of tasks. A task can be   */
+/*   submitted to a specific worker, for example to keep the */
+/*   fact batches of an inference session in the same        */
+/*   working memory, or to any worker. Tasks for any worker  */
+/*   are distributed among the queues in turn. A worker runs */
+/*   the tasks of its own queue from the front, in the order */
+/*   they were submitted. When its queue is empty, it steals */
+/*   the last task for any worker from the queues of the     */
+/*   other workers. The queues are protected by a single     */
+/*   lock: a task is a complete inference run, so the time   */
+/*   spent holding the lock is negligible.                   */
+/*                                                           */
+/*   The environments can also share the atoms of the image: */
+/*   a template environment is loaded first, its atoms are   */
+/*   frozen into a shared base layer, and the environments   */
+/*   of the workers are then created with that base, so each */
+/*   one only stores the atoms created after it was loaded.  */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if ENVIRONMENT_POOL_FUNCTIONS
+
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "esp_pthread.h"
+#elif LINUX
+#include <sched.h>
+#endif
+
+#if BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE
+#include "bload.h"
+#endif
+#include "constrct.h"
+#include "engine.h"
+#include "envrnbld.h"
+#include "envrnmnt.h"
+#include "factfile.h"
+#include "symbol.h"
+
+#include "envpool.h"
+
+struct poolTask
+  {
+   EnvironmentPoolTaskFunction *taskFunction;
+   void *context;
+   bool anyWorker;
+   struct poolTask *previous;
+   struct poolTask *next;
+  };
+
+struct poolWorker
+  {
+   EnvironmentPool *pool;
+   unsigned int id;
+   Environment *theEnv;
+   pthread_t thread;
+   bool started;
+   struct poolTask *head;
+   struct poolTask *tail;
+   unsigned long queued;
+   unsigned long stolen;
+  };
+
+struct environmentPool
+  {
+   unsigned int size;
+   struct poolWorker *workers;
+   pthread_mutex_t lock;
+   pthread_cond_t workAvailable;
+   pthread_cond_t workDone;
+   unsigned long anyWorkerQueued;
+   unsigned long pending;
+   unsigned int nextWorker;
+   bool stopping;
+   SharedAtomBase *sharedBase;
+  };
+
+struct poolFactBatch
+  {
+   char *facts;
+   size_t length;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                   *PoolWorkerThread(void *);
+   static struct poolTask        *NextPoolTask(struct poolWorker *);
+   static void                    RemovePoolTask(struct poolWorker *,struct poolTask *);
+   static bool                    StartPoolWorker(struct poolWorker *);
+   static void                    PoolFactBatchTask(Environment *,void *);
+   static unsigned int            PoolProcessorCount(void);
+   static Environment            *LoadPoolEnvironment(SharedAtomBase *,const void *,size_t,
+                                                      EnvironmentPoolInitFunction *,void *);
+   static void                    FreeEnvironmentPool(EnvironmentPool *);
+
+/****************************************************************/
+/* LoadPoolEnvironment: Creates an environment (using a shared  */
+/*   base of atoms if there's one), calls the init function and */
+/*   loads the image. Returns NULL if any of the steps fail.    */
+/****************************************************************/
+static Environment *LoadPoolEnvironment(
+  SharedAtomBase *sharedBase,
+  const void *image,
+  size_t imageSize,
+  EnvironmentPoolInitFunction *initFunction,
+  void *context)
+  {
+   Environment *theEnv;
+
+   if (sharedBase != NULL)
+     { theEnv = CreateEnvironmentWithBase(sharedBase); }
+   else
+     { theEnv = CreateEnvironment(); }
+
+   if (theEnv == NULL)
+     { return NULL; }
+
+   if ((initFunction != NULL) &&
+       (! (*initFunction)(theEnv,context)))
+     {
+      DestroyEnvironment(theEnv);
+      return NULL;
+     }
+
+#if BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE
+   if ((image != NULL) &&
+       (! BloadImage(theEnv,image,imageSize)))
+     {
+      DestroyEnvironment(theEnv);
+      return NULL;
+     }
+#else
+   if (image != NULL)
+     {
+      DestroyEnvironment(theEnv);
+      return NULL;
+     }
+#endif
+
+   return theEnv;
+  }
+
+/*****************************************************************/
+/* CreateEnvironmentPool: Creates size environments (one for     */
+/*   each core if size is 0) and a worker thread for each one.   */
+/*   The init function (if any) is called for each environment   */
+/*   before the image is loaded, so user defined functions used  */
+/*   by the constructs can be added. The bsave image (if any) is */
+/*   then loaded with BloadImage and each environment is reset.  */
+/*   If shareAtoms is true, the environments share the atoms of  */
+/*   the image (see CreateSharedAtomBase). Returns NULL if an    */
+/*   environment or thread can't be created.                     */
+/*****************************************************************/
+EnvironmentPool *CreateEnvironmentPool(
+  unsigned int size,
+  const void *image,
+  size_t imageSize,
+  EnvironmentPoolInitFunction *initFunction,
+  void *context,
+  bool shareAtoms)
+  {
+   EnvironmentPool *thePool;
+   struct poolWorker *theWorker;
+   Environment *templateEnv;
+   unsigned int i;
+
+   if (size == 0)
+     { size = PoolProcessorCount(); }
+
+   thePool = (EnvironmentPool *) malloc(sizeof(EnvironmentPool));
+   if (thePool == NULL) return NULL;
+
+   thePool->workers = (struct poolWorker *) calloc(size,sizeof(struct poolWorker));
+   if (thePool->workers == NULL)
+     {
+      free(thePool);
+      return NULL;
+     }
+
+   thePool->size = size;
+   thePool->anyWorkerQueued = 0;
+   thePool->pending = 0;
+   thePool->nextWorker = 0;
+   thePool->stopping = false;
+   thePool->sharedBase = NULL;
+   pthread_mutex_init(&thePool->lock,NULL);
+   pthread_cond_init(&thePool->workAvailable,NULL);
+   pthread_cond_init(&thePool->workDone,NULL);
+
+   /*=====================================================*/
+   /* The shared atoms are taken from a template loaded   */
+   /* the same way as the environments of the workers.    */
+   /*=====================================================*/
+
+   if (shareAtoms)
+     {
+      templateEnv = LoadPoolEnvironment(NULL,image,imageSize,initFunction,context);
+      if (templateEnv == NULL)
+        {
+         FreeEnvironmentPool(thePool);
+         return NULL;
+        }
+
+      thePool->sharedBase = CreateSharedAtomBase(templateEnv);
+      DestroyEnvironment(templateEnv);
+
+      if (thePool->sharedBase == NULL)
+        {
+         FreeEnvironmentPool(thePool);
+         return NULL;
+        }
+     }
+
+   /*==================================================*/
+   /* Create and load the environments on this thread. */
+   /*==================================================*/
+
+   for (i = 0; i < size; i++)
+     {
+      theWorker = &thePool->workers[i];
+      theWorker->pool = thePool;
+      theWorker->id = i;
+
+      theWorker->theEnv = LoadPoolEnvironment(thePool->sharedBase,image,imageSize,
+                                              initFunction,context);
+      if (theWorker->theEnv == NULL)
+        {
+         FreeEnvironmentPool(thePool);
+         return NULL;
+        }
+
+      Reset(theWorker->theEnv);
+     }
+
+   /*=============================================*/
+   /* Start a worker thread for each environment. */
+   /*=============================================*/
+
+   for (i = 0; i < size; i++)
+     {
+      if (! StartPoolWorker(&thePool->workers[i]))
+        {
+         FreeEnvironmentPool(thePool);
+         return NULL;
+        }
+     }
+
+   return thePool;
+  }
+
+/************************************************************/
+/* DestroyEnvironmentPool: Waits for the submitted tasks to */
+/*   complete, stops the worker threads, and destroys the   */
+/*   environments.                                          */
+/************************************************************/
+void DestroyEnvironmentPool(
+  EnvironmentPool *thePool)
+  {
+   if (thePool == NULL) return;
+
+   WaitEnvironmentPool(thePool);
+   FreeEnvironmentPool(thePool);
+  }
+
+/*****************************************************************/
+/* SubmitPoolTask: Queues a task to be run with the environment  */
+/*   of the given worker, or of any worker if the worker is      */
+/*   POOL_ANY_WORKER. The tasks submitted to a worker are run in */
+/*   the order they were submitted. Returns false if the worker  */
+/*   does not exist or the task can't be allocated.              */
+/*****************************************************************/
+bool SubmitPoolTask(
+  EnvironmentPool *thePool,
+  int worker,
+  EnvironmentPoolTaskFunction *taskFunction,
+  void *context)
+  {
+   struct poolTask *theTask;
+   struct poolWorker *theWorker;
+
+   if ((worker != POOL_ANY_WORKER) &&
+       ((worker < 0) || ((unsigned int) worker >= thePool->size)))
+     { return false; }
+
+   theTask = (struct poolTask *) malloc(sizeof(struct poolTask));
+   if (theTask == NULL) return false;
+
+   theTask->taskFunction = taskFunction;
+   theTask->context = context;
+   theTask->anyWorker = (worker == POOL_ANY_WORKER);
+   theTask->next = NULL;
+
+   pthread_mutex_lock(&thePool->lock);
+
+   if (worker == POOL_ANY_WORKER)
+     {
+      worker = (int) thePool->nextWorker;
+      thePool->nextWorker = (thePool->nextWorker + 1) % thePool->size;
+      thePool->anyWorkerQueued++;
+     }
+
+   theWorker = &thePool->workers[worker];
+   theTask->previous = theWorker->tail;
+   if (theWorker->tail == NULL)
+     { theWorker->head = theTask; }
+   else
+     { theWorker->tail->next = theTask; }
+   theWorker->tail = theTask;
+   theWorker->queued++;
+   thePool->pending++;
+
+   /*====================================================*/
+   /* Any worker may be able to run (or steal) the task. */
+   /*====================================================*/
+
+   pthread_cond_broadcast(&thePool->workAvailable);
+   pthread_mutex_unlock(&thePool->lock);
+
+   return true;
+  }
+
+/*****************************************************************/
+/* SubmitPoolFacts: Queues a batch of facts, in the format read  */
+/*   by load-facts, to be asserted into the environment of the   */
+/*   given worker (or any worker), followed by a run of the      */
+/*   rules. The text is copied, so it can be released as soon    */
+/*   as the function returns.                                    */
+/*****************************************************************/
+bool SubmitPoolFacts(
+  EnvironmentPool *thePool,
+  int worker,
+  const char *facts,
+  size_t length)
+  {
+   struct poolFactBatch *theBatch;
+
+   theBatch = (struct poolFactBatch *) malloc(sizeof(struct poolFactBatch));
+   if (theBatch == NULL) return false;
+
+   theBatch->facts = (char *) malloc(length + 1);
+   if (theBatch->facts == NULL)
+     {
+      free(theBatch);
+      return false;
+     }
+
+   memcpy(theBatch->facts,facts,length);
+   theBatch->facts[length] = '\0';
+   theBatch->length = length;
+
+   if (! SubmitPoolTask(thePool,worker,PoolFactBatchTask,theBatch))
+     {
+      free(theBatch->facts);
+      free(theBatch);
+      return false;
+     }
+
+   return true;
+  }
+
+/*****************************************************/
+/* WaitEnvironmentPool: Waits until all of the tasks */
+/*   submitted to the pool have been run.            */
+/*****************************************************/
+void WaitEnvironmentPool(
+  EnvironmentPool *thePool)
+  {
+   pthread_mutex_lock(&thePool->lock);
+
+   while (thePool->pending != 0)
+     { pthread_cond_wait(&thePool->workDone,&thePool->lock); }
+
+   pthread_mutex_unlock(&thePool->lock);
+  }
+
+/***********************************************/
+/* GetEnvironmentPoolSize: Returns the number  */
+/*   of environments in the pool.              */
+/***********************************************/
+unsigned int GetEnvironmentPoolSize(
+  EnvironmentPool *thePool)
+  {
+   return thePool->size;
+  }
+
+/**************************************************************/
+/* GetPoolEnvironment: Returns the environment of a worker.   */
+/*   It should only be used by the tasks run by the worker or */
+/*   while no tasks are pending.                              */
+/**************************************************************/
+Environment *GetPoolEnvironment(
+  EnvironmentPool *thePool,
+  unsigned int worker)
+  {
+   if (worker >= thePool->size) return NULL;
+
+   return thePool->workers[worker].theEnv;
+  }
+
+/*************************************************/
+/* GetPoolTasksStolen: Returns the number of     */
+/*   tasks a worker has taken from the queues of */
+/*   the other workers.                          */
+/*************************************************/
+unsigned long GetPoolTasksStolen(
+  EnvironmentPool *thePool,
+  unsigned int worker)
+  {
+   unsigned long stolen;
+
+   if (worker >= thePool->size) return 0;
+
+   pthread_mutex_lock(&thePool->lock);
+   stolen = thePool->workers[worker].stolen;
+   pthread_mutex_unlock(&thePool->lock);
+
+   return stolen;
+  }
+
+/*************************************************/
+/* PoolWorkerThread: Thread routine of a worker. */
+/*************************************************/
+static void *PoolWorkerThread(
+  void *context)
+  {
+   struct poolWorker *theWorker = (struct poolWorker *) context;
+   EnvironmentPool *thePool = theWorker->pool;
+   struct poolTask *theTask;
+
+   pthread_mutex_lock(&thePool->lock);
+
+   while (true)
+     {
+      theTask = NextPoolTask(theWorker);
+
+      if (theTask == NULL)
+        {
+         if (thePool->stopping) break;
+
+         pthread_cond_wait(&thePool->workAvailable,&thePool->lock);
+         continue;
+        }
+
+      pthread_mutex_unlock(&thePool->lock);
+
+      (*theTask->taskFunction)(theWorker->theEnv,theTask->context);
+      free(theTask);
+
+      pthread_mutex_lock(&thePool->lock);
+
+      thePool->pending--;
+      if (thePool->pending == 0)
+        { pthread_cond_broadcast(&thePool->workDone); }
+     }
+
+   pthread_mutex_unlock(&thePool->lock);
+
+   return NULL;
+  }
+
+/*****************************************************************/
+/* NextPoolTask: Removes the next task to be run by a worker.    */
+/*   The first task of its own queue is taken if there is one,   */
+/*   otherwise the last task for any worker in the queue of one  */
+/*   of the other workers. Called with the pool lock held.       */
+/*****************************************************************/
+static struct poolTask *NextPoolTask(
+  struct poolWorker *theWorker)
+  {
+   EnvironmentPool *thePool = theWorker->pool;
+   struct poolWorker *victim;
+   struct poolTask *theTask;
+   unsigned int i;
+
+   if (theWorker->head != NULL)
+     {
+      theTask = theWorker->head;
+      RemovePoolTask(theWorker,theTask);
+      return theTask;
+     }
+
+   if (thePool->anyWorkerQueued == 0)
+     { return NULL; }
+
+   for (i = 1; i < thePool->size; i++)
+     {
+      victim = &thePool->workers[(theWorker->id + i) % thePool->size];
+
+      for (theTask = victim->tail;
+           theTask != NULL;
+           theTask = theTask->previous)
+        {
+         if (theTask->anyWorker)
+           {
+            RemovePoolTask(victim,theTask);
+            theWorker->stolen++;
+            return theTask;
+           }
+        }
+     }
+
+   return NULL;
+  }
+
+/**************************************************/
+/* RemovePoolTask: Removes a task from the queue  */
+/*   of a worker. Called with the pool lock held. */
+/**************************************************/
+static void RemovePoolTask(
+  struct poolWorker *theWorker,
+  struct poolTask *theTask)
+  {
+   if (theTask->previous == NULL)
+     { theWorker->head = theTask->next; }
+   else
+     { theTask->previous->next = theTask->next; }
+
+   if (theTask->next == NULL)
+     { theWorker->tail = theTask->previous; }
+   else
+     { theTask->next->previous = theTask->previous; }
+
+   theWorker->queued--;
+   if (theTask->anyWorker)
+     { theWorker->pool->anyWorkerQueued--; }
+  }
+
+/*****************************************************************/
+/* StartPoolWorker: Starts the thread of a worker, pinned to one */
+/*   of the cores. On the ESP32 the core and the stack size are  */
+/*   set through the pthread configuration of ESP-IDF.           */
+/*****************************************************************/
+static bool StartPoolWorker(
+  struct poolWorker *theWorker)
+  {
+#if defined(ESP_PLATFORM)
+   esp_pthread_cfg_t threadConfig = esp_pthread_get_default_config();
+
+   threadConfig.stack_size = ENVIRONMENT_POOL_STACK_SIZE;
+   threadConfig.pin_to_core = (int) (theWorker->id % portNUM_PROCESSORS);
+   threadConfig.thread_name = "clips-pool";
+   esp_pthread_set_cfg(&threadConfig);
+#endif
+
+   if (pthread_create(&theWorker->thread,NULL,PoolWorkerThread,theWorker) != 0)
+     { return false; }
+
+   theWorker->started = true;
+
+#if LINUX && (! defined(ESP_PLATFORM))
+   {
+    cpu_set_t cpuSet;
+
+    CPU_ZERO(&cpuSet);
+    CPU_SET(theWorker->id % PoolProcessorCount(),&cpuSet);
+    pthread_setaffinity_np(theWorker->thread,sizeof(cpu_set_t),&cpuSet);
+   }
+#endif
+
+   return true;
+  }
+
+/******************************************************/
+/* PoolFactBatchTask: Task which loads a fact batch   */
+/*   into the environment of the worker and runs the  */
+/*   rules.                                           */
+/******************************************************/
+static void PoolFactBatchTask(
+  Environment *theEnv,
+  void *context)
+  {
+   struct poolFactBatch *theBatch = (struct poolFactBatch *) context;
+
+   LoadFactsFromString(theEnv,theBatch->facts,theBatch->length);
+   Run(theEnv,-1);
+
+   free(theBatch->facts);
+   free(theBatch);
+  }
+
+/***************************************************/
+/* PoolProcessorCount: Returns the number of cores */
+/*   available to the worker threads.              */
+/***************************************************/
+static unsigned int PoolProcessorCount(void)
+  {
+#if defined(ESP_PLATFORM)
+   return portNUM_PROCESSORS;
+#else
+   long processors;
+
+   processors = sysconf(_SC_NPROCESSORS_ONLN);
+   if (processors < 1)
+     { return 1; }
+
+   return (unsigned int) processors;
+#endif
+  }
+
+/*****************************************************************/
+/* FreeEnvironmentPool: Stops the worker threads which have been */
+/*   started, destroys the environments which have been created, */
+/*   and releases the pool.                                      */
+/*****************************************************************/
+static void FreeEnvironmentPool(
+  EnvironmentPool *thePool)
+  {
+   unsigned int i;
+
+   pthread_mutex_lock(&thePool->lock);
+   thePool->stopping = true;
+   pthread_cond_broadcast(&thePool->workAvailable);
+   pthread_mutex_unlock(&thePool->lock);
+
+   for (i = 0; i < thePool->size; i++)
+     {
+      if (thePool->workers[i].started)
+        { pthread_join(thePool->workers[i].thread,NULL); }
+     }
+
+   for (i = 0; i < thePool->size; i++)
+     {
+      if (thePool->workers[i].theEnv != NULL)
+        { DestroyEnvironment(thePool->workers[i].theEnv); }
+     }
+
+   DestroySharedAtomBase(thePool->sharedBase);
+
+   pthread_cond_destroy(&thePool->workDone);
+   pthread_cond_destroy(&thePool->workAvailable);
+   pthread_mutex_destroy(&thePool->lock);
+
+   free(thePool->workers);
+   free(thePool);
+  }
+
+#endif /* ENVIRONMENT_POOL_FUNCTIONS */
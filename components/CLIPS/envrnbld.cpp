@@ -86,6 +86,42 @@
 #include "developr.h"
 #endif
 
+#if SNAPSHOT_FUNCTIONS
+#include "snapshot.h"
+#endif
+
+#if FACT_JOURNAL_FUNCTIONS
+#include "factjrnl.h"
+#endif
+
+#if PARALLEL_CHECK_FUNCTIONS
+#include "parcheck.h"
+#endif
+
+#if FACT_BATCH_FUNCTIONS
+#include "factbtch.h"
+#endif
+
+#if BUFFERED_ROUTER_FUNCTIONS
+#include "bufrtr.h"
+#endif
+
+#if JOIN_STATISTICS
+#include "joinstat.h"
+#endif
+
+#if RULE_LATENCY_FUNCTIONS
+#include "rulelat.h"
+#endif
+
+#if EVENT_TRACE_FUNCTIONS
+#include "evtrace.h"
+#endif
+
+#if EXPRESSION_BYTECODE
+#include "bytecode.h"
+#endif
+
 #include "envrnbld.h"
 
 /****************************************/
@@ -102,12 +138,14 @@
    static Environment            *CreateEnvironmentDriver(CLIPSLexeme **,CLIPSFloat **,
                                                           CLIPSInteger **,CLIPSBitMap **,
                                                           CLIPSExternalAddress **,
-                                                          struct functionDefinition *);
+                                                          struct functionDefinition *,
+                                                          SharedAtomBase *);
    static void                    SystemFunctionDefinitions(Environment *);
    static void                    InitializeEnvironment(Environment *,CLIPSLexeme **,CLIPSFloat **,
 					   								       CLIPSInteger **,CLIPSBitMap **,
 														   CLIPSExternalAddress **,
-                                                           struct functionDefinition *);
+                                                           struct functionDefinition *,
+                                                           SharedAtomBase *);
 
 /************************************************************/
 /* CreateEnvironment: Creates an environment data structure */
@@ -115,7 +153,19 @@
 /************************************************************/
 Environment *CreateEnvironment(void)
   {
-   return CreateEnvironmentDriver(NULL,NULL,NULL,NULL,NULL,NULL);
+   return CreateEnvironmentDriver(NULL,NULL,NULL,NULL,NULL,NULL,NULL);
+  }
+
+/************************************************************/
+/* CreateEnvironmentWithBase: Creates an environment which  */
+/*   finds atoms in a base layer shared with other          */
+/*   environments before its own hash tables. New atoms are */
+/*   still added to the environment's own tables.           */
+/************************************************************/
+Environment *CreateEnvironmentWithBase(
+  SharedAtomBase *sharedBase)
+  {
+   return CreateEnvironmentDriver(NULL,NULL,NULL,NULL,NULL,NULL,sharedBase);
   }
 
 /**********************************************************/
@@ -129,7 +179,7 @@ Environment *CreateRuntimeEnvironment(
   CLIPSBitMap **bitmapTable,
   struct functionDefinition *functions)
   {
-   return CreateEnvironmentDriver(symbolTable,floatTable,integerTable,bitmapTable,NULL,functions);
+   return CreateEnvironmentDriver(symbolTable,floatTable,integerTable,bitmapTable,NULL,functions,NULL);
   }
 
 /*********************************************************/
@@ -142,7 +192,8 @@ Environment *CreateEnvironmentDriver(
   CLIPSInteger **integerTable,
   CLIPSBitMap **bitmapTable,
   CLIPSExternalAddress **externalAddressTable,
-  struct functionDefinition *functions)
+  struct functionDefinition *functions,
+  SharedAtomBase *sharedBase)
   {
    struct environmentData *theEnvironment;
    void *theData;
@@ -190,7 +241,7 @@ Environment *CreateEnvironmentDriver(
    theEnvironment->cleanupFunctions = (void (**)(Environment *))theData;
 
    InitializeEnvironment(theEnvironment,symbolTable,floatTable,integerTable,
-                         bitmapTable,externalAddressTable,functions);
+                         bitmapTable,externalAddressTable,functions,sharedBase);
       
    CleanCurrentGarbageFrame(theEnvironment,NULL);
 
@@ -286,7 +337,8 @@ static void InitializeEnvironment(
   CLIPSInteger **integerTable,
   CLIPSBitMap **bitmapTable,
   CLIPSExternalAddress **externalAddressTable,
-  struct functionDefinition *functions)
+  struct functionDefinition *functions,
+  SharedAtomBase *sharedBase)
   {
    /*================================================*/
    /* Don't allow the initialization to occur twice. */
@@ -325,7 +377,7 @@ static void InitializeEnvironment(
    /* Initialize the hash tables for atomic values. */
    /*===============================================*/
 
-   InitializeAtomTables(theEnvironment,symbolTable,floatTable,integerTable,bitmapTable,externalAddressTable);
+   InitializeAtomTables(theEnvironment,symbolTable,floatTable,integerTable,bitmapTable,externalAddressTable,sharedBase);
 
    /*=========================================*/
    /* Initialize file and string I/O routers. */
@@ -513,6 +565,42 @@ static void SystemFunctionDefinitions(
    ConstructProfilingFunctionDefinitions(theEnv);
 #endif
 
+#if SNAPSHOT_FUNCTIONS
+   SnapshotCommandDefinitions(theEnv);
+#endif
+
+#if FACT_JOURNAL_FUNCTIONS
+   FactJournalCommandDefinitions(theEnv);
+#endif
+
+#if PARALLEL_CHECK_FUNCTIONS
+   ParallelCheckCommandDefinitions(theEnv);
+#endif
+
+#if FACT_BATCH_FUNCTIONS
+   FactBatchCommandDefinitions(theEnv);
+#endif
+
+#if BUFFERED_ROUTER_FUNCTIONS
+   BufferedRouterCommandDefinitions(theEnv);
+#endif
+
+#if JOIN_STATISTICS
+   JoinStatisticsCommandDefinitions(theEnv);
+#endif
+
+#if RULE_LATENCY_FUNCTIONS
+   RuleLatencyDefinitions(theEnv);
+#endif
+
+#if EVENT_TRACE_FUNCTIONS
+   EventTraceDefinitions(theEnv);
+#endif
+
+#if EXPRESSION_BYTECODE
+   BytecodeDefinitions(theEnv);
+#endif
+
    ParseFunctionDefinitions(theEnv);
   }
 
@@ -0,0 +1,485 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                 EVENT TRACE MODULE                  */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Records fact, activation and rule firing events  */
+/*   as fixed size binary records in a ring buffer which is  */
+/*   formatted by a separate consumer.                       */
+/*                                                           */
+/*   Unlike the watch output, recording an event does not    */
+/*   format any text or call the routers: the time, the fact */
+/*   index or activation timetag and the deftemplate or      */
+/*   defrule are stored in the next record of the ring and   */
+/*   the count of events written is then published. A        */
+/*   consumer (the event-trace command, or another task      */
+/*   calling ReadTraceEvents with its own cursor) copies the */
+/*   records and checks afterwards that the writer has not   */
+/*   overwritten them in the meantime, so neither side takes */
+/*   a lock. When the consumer falls behind, the oldest      */
+/*   events are lost rather than slowing the engine down.    */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <string.h>
+
+#include "setup.h"
+
+#if EVENT_TRACE_FUNCTIONS
+
+#include "argacces.h"
+#include "constrct.h"
+#include "envrnmnt.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "moduldef.h"
+#include "prntutil.h"
+#include "router.h"
+#include "ruledef.h"
+#include "sysdep.h"
+#include "tmpltdef.h"
+
+#include "evtrace.h"
+
+#define TRACE_BATCH_SIZE 32
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    DeallocateEventTraceData(Environment *);
+   static const char             *TraceEventConstructName(Environment *,TraceEvent *);
+#if ! RUN_TIME
+   static void                    EventTraceClearFunction(Environment *,void *);
+#endif
+
+/****************************************************/
+/* EventTraceDefinitions: Initializes the event     */
+/*   trace ring and commands.                       */
+/****************************************************/
+void EventTraceDefinitions(
+  Environment *theEnv)
+  {
+   AllocateEnvironmentData(theEnv,EVENT_TRACE_DATA,sizeof(struct eventTraceData),DeallocateEventTraceData);
+
+#if ! RUN_TIME
+   AddUDF(theEnv,"event-trace","v",0,1,"l",EventTraceCommand,"EventTraceCommand",NULL);
+   AddUDF(theEnv,"event-trace-reset","v",0,0,NULL,EventTraceResetCommand,"EventTraceResetCommand",NULL);
+   AddUDF(theEnv,"set-event-tracing","b",1,1,NULL,SetEventTracingCommand,"SetEventTracingCommand",NULL);
+   AddUDF(theEnv,"get-event-tracing","b",0,0,NULL,GetEventTracingCommand,"GetEventTracingCommand",NULL);
+
+   AddClearFunction(theEnv,"event-trace",EventTraceClearFunction,0,NULL);
+#endif
+  }
+
+/*****************************************************/
+/* DeallocateEventTraceData: Deallocates environment */
+/*    data for the event trace.                      */
+/*****************************************************/
+static void DeallocateEventTraceData(
+  Environment *theEnv)
+  {
+   if (EventTraceData(theEnv)->Ring != NULL)
+     { genfree(theEnv,EventTraceData(theEnv)->Ring,sizeof(TraceEvent) * EVENT_TRACE_CAPACITY); }
+  }
+
+/********************************************************/
+/* RecordTraceEvent: Stores an event in the next record */
+/*   of the ring and publishes it to the consumers.     */
+/*   Only the thread running the environment writes.    */
+/********************************************************/
+void RecordTraceEvent(
+  Environment *theEnv,
+  TraceEventType type,
+  long long id,
+  const void *construct)
+  {
+   struct eventTraceData *theData = EventTraceData(theEnv);
+   unsigned long position = theData->Head;
+   TraceEvent *theEvent;
+
+   if (theData->Ring == NULL)
+     { return; }
+
+   theEvent = &theData->Ring[position & (EVENT_TRACE_CAPACITY - 1)];
+   theEvent->time = genmicrotime();
+   theEvent->id = id;
+   theEvent->construct = construct;
+   theEvent->type = (unsigned short) type;
+
+   __atomic_store_n(&theData->Head,position + 1,__ATOMIC_RELEASE);
+  }
+
+/************************************************************/
+/* TraceEventCursor: Returns a cursor for ReadTraceEvents   */
+/*   positioned on the last count events recorded, or on    */
+/*   the oldest event still in the ring if count is 0.      */
+/************************************************************/
+unsigned long TraceEventCursor(
+  Environment *theEnv,
+  long long count)
+  {
+   struct eventTraceData *theData = EventTraceData(theEnv);
+   unsigned long head, oldest;
+
+   head = __atomic_load_n(&theData->Head,__ATOMIC_ACQUIRE);
+
+   oldest = theData->Start;
+   if ((head - oldest) > EVENT_TRACE_CAPACITY)
+     { oldest = head - EVENT_TRACE_CAPACITY; }
+
+   if ((count > 0) && ((unsigned long long) count < (head - oldest)))
+     { return head - (unsigned long) count; }
+
+   return oldest;
+  }
+
+/***************************************************************/
+/* ReadTraceEvents: Copies up to max events recorded from the  */
+/*   cursor on into the buffer and advances the cursor past    */
+/*   them. Events overwritten before they could be read are    */
+/*   skipped. Returns the number of events copied.             */
+/***************************************************************/
+size_t ReadTraceEvents(
+  Environment *theEnv,
+  unsigned long *cursor,
+  TraceEvent *buffer,
+  size_t max)
+  {
+   struct eventTraceData *theData = EventTraceData(theEnv);
+   unsigned long head, oldest;
+   size_t count = 0;
+
+   if (theData->Ring == NULL)
+     { return 0; }
+
+   head = __atomic_load_n(&theData->Head,__ATOMIC_ACQUIRE);
+
+   oldest = theData->Start;
+   if ((head - oldest) > EVENT_TRACE_CAPACITY)
+     { oldest = head - EVENT_TRACE_CAPACITY; }
+
+   if ((*cursor < oldest) || (*cursor > head))
+     { *cursor = oldest; }
+
+   while ((*cursor < head) && (count < max))
+     {
+      buffer[count] = theData->Ring[*cursor & (EVENT_TRACE_CAPACITY - 1)];
+
+      /*================================================*/
+      /* If the writer has reached the record while it  */
+      /* was copied, it may be torn, so skip ahead to   */
+      /* the oldest record which is still intact.       */
+      /*================================================*/
+
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      oldest = __atomic_load_n(&theData->Head,__ATOMIC_ACQUIRE);
+      if ((oldest - *cursor) >= EVENT_TRACE_CAPACITY)
+        {
+         *cursor = oldest - EVENT_TRACE_CAPACITY + 1;
+         continue;
+        }
+
+      (*cursor)++;
+      count++;
+     }
+
+   return count;
+  }
+
+/**************************************************************/
+/* TraceEventConstructName: Returns the name of the defrule   */
+/*   or deftemplate of an event, or NULL if it has since been */
+/*   deleted.                                                 */
+/**************************************************************/
+static const char *TraceEventConstructName(
+  Environment *theEnv,
+  TraceEvent *theEvent)
+  {
+   Defmodule *theModule;
+   Defrule *theRule, *theDisjunct;
+   Deftemplate *theTemplate;
+   const char *theName = NULL;
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        (theModule != NULL) && (theName == NULL);
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+
+      if ((theEvent->type == TRACE_ASSERT) || (theEvent->type == TRACE_RETRACT))
+        {
+         for (theTemplate = GetNextDeftemplate(theEnv,NULL);
+              (theTemplate != NULL) && (theName == NULL);
+              theTemplate = GetNextDeftemplate(theEnv,theTemplate))
+           {
+            if (theTemplate == theEvent->construct)
+              { theName = DeftemplateName(theTemplate); }
+           }
+        }
+      else
+        {
+         for (theRule = GetNextDefrule(theEnv,NULL);
+              (theRule != NULL) && (theName == NULL);
+              theRule = GetNextDefrule(theEnv,theRule))
+           {
+            for (theDisjunct = theRule; theDisjunct != NULL; theDisjunct = theDisjunct->disjunct)
+              {
+               if (theDisjunct == theEvent->construct)
+                 {
+                  theName = DefruleName(theRule);
+                  break;
+                 }
+              }
+           }
+        }
+     }
+
+   RestoreCurrentModule(theEnv);
+
+   return theName;
+  }
+
+/************************************************************/
+/* PrintTraceEvent: Formats an event like the watch output, */
+/*   with its time in microseconds from the given start.    */
+/************************************************************/
+void PrintTraceEvent(
+  Environment *theEnv,
+  const char *logicalName,
+  TraceEvent *theEvent,
+  long long startTime)
+  {
+   const char *theName;
+   char printSpace[60];
+
+   gensnprintf(printSpace,sizeof(printSpace),"%10lld ",theEvent->time - startTime);
+   WriteString(theEnv,logicalName,printSpace);
+
+   switch (theEvent->type)
+     {
+      case TRACE_ASSERT:
+        WriteString(theEnv,logicalName,"==> ");
+        break;
+
+      case TRACE_RETRACT:
+        WriteString(theEnv,logicalName,"<== ");
+        break;
+
+      case TRACE_ACTIVATE:
+        WriteString(theEnv,logicalName,"==> Activation ");
+        break;
+
+      case TRACE_DEACTIVATE:
+        WriteString(theEnv,logicalName,"<== Activation ");
+        break;
+
+      case TRACE_FIRE:
+        WriteString(theEnv,logicalName,"FIRE ");
+        break;
+     }
+
+   if ((theEvent->type == TRACE_ASSERT) || (theEvent->type == TRACE_RETRACT))
+     {
+      gensnprintf(printSpace,sizeof(printSpace),"f-%lld ",theEvent->id);
+      WriteString(theEnv,logicalName,printSpace);
+     }
+
+   theName = TraceEventConstructName(theEnv,theEvent);
+   if (theName == NULL)
+     { WriteString(theEnv,logicalName,"<deleted>"); }
+   else
+     { WriteString(theEnv,logicalName,theName); }
+
+   if ((theEvent->type != TRACE_ASSERT) && (theEvent->type != TRACE_RETRACT))
+     {
+      gensnprintf(printSpace,sizeof(printSpace)," [%lld]",theEvent->id);
+      WriteString(theEnv,logicalName,printSpace);
+     }
+
+   WriteString(theEnv,logicalName,"\n");
+  }
+
+/**************************************************************/
+/* ListTraceEvents: Prints the last count events recorded (or */
+/*   all of those still in the ring if count is 0), oldest    */
+/*   first, with their times from the first one printed.      */
+/**************************************************************/
+void ListTraceEvents(
+  Environment *theEnv,
+  const char *logicalName,
+  long long count)
+  {
+   TraceEvent theEvents[TRACE_BATCH_SIZE];
+   unsigned long cursor;
+   size_t i, read;
+   long long startTime = 0;
+   bool first = true;
+
+   cursor = TraceEventCursor(theEnv,count);
+
+   while ((read = ReadTraceEvents(theEnv,&cursor,theEvents,TRACE_BATCH_SIZE)) > 0)
+     {
+      for (i = 0; i < read; i++)
+        {
+         if (first)
+           {
+            startTime = theEvents[i].time;
+            first = false;
+           }
+
+         PrintTraceEvent(theEnv,logicalName,&theEvents[i],startTime);
+        }
+
+      if (GetHaltExecution(theEnv) == true)
+        { break; }
+     }
+  }
+
+/********************************************/
+/* ResetEventTrace: Discards the events in  */
+/*   the ring.                              */
+/********************************************/
+void ResetEventTrace(
+  Environment *theEnv)
+  {
+   EventTraceData(theEnv)->Start = EventTraceData(theEnv)->Head;
+  }
+
+#if ! RUN_TIME
+
+/**************************************************/
+/* EventTraceClearFunction: Discards the events   */
+/*   of the constructs removed by a clear.        */
+/**************************************************/
+static void EventTraceClearFunction(
+  Environment *theEnv,
+  void *context)
+  {
+   ResetEventTrace(theEnv);
+  }
+
+#endif
+
+/*********************************************/
+/* SetEventTracing: C access routine for the */
+/*   set-event-tracing command. The ring is  */
+/*   allocated the first time it is enabled. */
+/*********************************************/
+bool SetEventTracing(
+  Environment *theEnv,
+  bool value)
+  {
+   bool oldValue;
+
+   oldValue = EventTraceData(theEnv)->Tracing;
+
+   if (value && (EventTraceData(theEnv)->Ring == NULL))
+     {
+      EventTraceData(theEnv)->Ring = (TraceEvent *)
+         genalloc(theEnv,sizeof(TraceEvent) * EVENT_TRACE_CAPACITY);
+      memset(EventTraceData(theEnv)->Ring,0,sizeof(TraceEvent) * EVENT_TRACE_CAPACITY);
+     }
+
+   EventTraceData(theEnv)->Tracing = value;
+
+   return oldValue;
+  }
+
+/*********************************************/
+/* GetEventTracing: C access routine for the */
+/*   get-event-tracing command.              */
+/*********************************************/
+bool GetEventTracing(
+  Environment *theEnv)
+  {
+   return EventTraceData(theEnv)->Tracing;
+  }
+
+/*****************************************/
+/* EventTraceCommand: H/L access routine */
+/*   for the event-trace command.        */
+/*****************************************/
+void EventTraceCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   long long count = 0;
+
+   if (UDFHasNextArgument(context))
+     {
+      if (! UDFFirstArgument(context,INTEGER_BIT,&theArg))
+        { return; }
+
+      count = theArg.integerValue->contents;
+      if (count < 0)
+        {
+         UDFInvalidArgumentMessage(context,"integer greater than or equal to 0");
+         return;
+        }
+     }
+
+   ListTraceEvents(theEnv,STDOUT,count);
+  }
+
+/**********************************************/
+/* EventTraceResetCommand: H/L access routine */
+/*   for the event-trace-reset command.       */
+/**********************************************/
+void EventTraceResetCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   ResetEventTrace(theEnv);
+  }
+
+/**********************************************/
+/* SetEventTracingCommand: H/L access routine */
+/*   for the set-event-tracing command.       */
+/**********************************************/
+void SetEventTracingCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetEventTracing(theEnv));
+
+   if (! UDFFirstArgument(context,ANY_TYPE_BITS,&theArg))
+     { return; }
+
+   if (theArg.value == FalseSymbol(theEnv))
+     { SetEventTracing(theEnv,false); }
+   else
+     { SetEventTracing(theEnv,true); }
+  }
+
+/**********************************************/
+/* GetEventTracingCommand: H/L access routine */
+/*   for the get-event-tracing command.       */
+/**********************************************/
+void GetEventTracingCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetEventTracing(theEnv));
+  }
+
+#endif /* EVENT_TRACE_FUNCTIONS */
@@ -138,7 +138,8 @@ static void DeallocateExpressionData(
 
 /****************************************************/
 /* InitExpressionPointers: Initializes the function */
-/*   pointers used in generating some expressions.  */
+/*   pointers used in generating some expressions   */
+/*   and in the fast evaluation of join tests.      */
 /****************************************************/
 void InitExpressionPointers(
   Environment *theEnv)
@@ -148,6 +149,12 @@ void InitExpressionPointers(
    ExpressionData(theEnv)->PTR_EQ = FindFunction(theEnv,"eq");
    ExpressionData(theEnv)->PTR_NEQ = FindFunction(theEnv,"neq");
    ExpressionData(theEnv)->PTR_NOT = FindFunction(theEnv,"not");
+   ExpressionData(theEnv)->PTR_LT = FindFunction(theEnv,"<");
+   ExpressionData(theEnv)->PTR_LE = FindFunction(theEnv,"<=");
+   ExpressionData(theEnv)->PTR_GT = FindFunction(theEnv,">");
+   ExpressionData(theEnv)->PTR_GE = FindFunction(theEnv,">=");
+   ExpressionData(theEnv)->PTR_NUM_EQ = FindFunction(theEnv,"=");
+   ExpressionData(theEnv)->PTR_NUM_NEQ = FindFunction(theEnv,"<>");
 
    if ((ExpressionData(theEnv)->PTR_AND == NULL) || (ExpressionData(theEnv)->PTR_OR == NULL) ||
        (ExpressionData(theEnv)->PTR_EQ == NULL) || (ExpressionData(theEnv)->PTR_NEQ == NULL) || (ExpressionData(theEnv)->PTR_NOT == NULL))
@@ -46,6 +46,7 @@
 #include "pattern.h"
 #include "reteutil.h"
 #include "rulebin.h"
+#include "symblbin.h"
 #include "tmpltdef.h"
 
 #include "factbin.h"
@@ -65,6 +66,7 @@ struct bsaveFactPatternNode
    unsigned long lastLevel;
    unsigned long leftNode;
    unsigned long rightNode;
+   unsigned long slotBitMap;
   };
 
 #define BSAVE_FIND         0
@@ -199,6 +201,8 @@ static void BsaveDriver(
         {
          case BSAVE_FIND:
            thePattern->bsaveID = FactBinaryData(theEnv)->NumberOfPatterns++;
+           if (thePattern->slotBitMap != NULL)
+             { thePattern->slotBitMap->neededBitMap = true; }
            break;
 
          case BSAVE_PATTERNS:
@@ -310,6 +314,10 @@ static void BsavePatternNode(
    tempNode.lastLevel =  BsaveFactPatternIndex(thePattern->lastLevel);
    tempNode.leftNode =  BsaveFactPatternIndex(thePattern->leftNode);
    tempNode.rightNode =  BsaveFactPatternIndex(thePattern->rightNode);
+   if (thePattern->slotBitMap != NULL)
+     { tempNode.slotBitMap = thePattern->slotBitMap->bucket; }
+   else
+     { tempNode.slotBitMap = ULONG_MAX; }
 
    GenWrite(&tempNode,sizeof(struct bsaveFactPatternNode),fp);
   }
@@ -379,10 +387,9 @@ static void BloadBinaryItem(
       if ((FactBinaryData(theEnv)->FactPatternArray[i].lastLevel != NULL) &&
           (FactBinaryData(theEnv)->FactPatternArray[i].lastLevel->header.selector))
         {
-         AddHashedPatternNode(theEnv,FactBinaryData(theEnv)->FactPatternArray[i].lastLevel,
-                                     &FactBinaryData(theEnv)->FactPatternArray[i],
-                                     FactBinaryData(theEnv)->FactPatternArray[i].networkTest->type,
-                                     FactBinaryData(theEnv)->FactPatternArray[i].networkTest->value);
+         AddHashedPatternNodes(theEnv,FactBinaryData(theEnv)->FactPatternArray[i].lastLevel,
+                               &FactBinaryData(theEnv)->FactPatternArray[i],
+                               FactBinaryData(theEnv)->FactPatternArray[i].networkTest);
         }
      }
   }
@@ -412,6 +419,14 @@ static void UpdateFactPatterns(
    FactBinaryData(theEnv)->FactPatternArray[obji].nextLevel = BloadFactPatternPointer(bp->nextLevel);
    FactBinaryData(theEnv)->FactPatternArray[obji].lastLevel = BloadFactPatternPointer(bp->lastLevel);
    FactBinaryData(theEnv)->FactPatternArray[obji].leftNode  = BloadFactPatternPointer(bp->leftNode);
+
+   if (bp->slotBitMap != ULONG_MAX)
+     {
+      FactBinaryData(theEnv)->FactPatternArray[obji].slotBitMap = BitMapPointer(bp->slotBitMap);
+      IncrementBitMapCount(FactBinaryData(theEnv)->FactPatternArray[obji].slotBitMap);
+     }
+   else
+     { FactBinaryData(theEnv)->FactPatternArray[obji].slotBitMap = NULL; }
   }
 
 /***************************************************/
@@ -429,13 +444,14 @@ static void ClearBload(
       if ((FactBinaryData(theEnv)->FactPatternArray[i].lastLevel != NULL) &&
           (FactBinaryData(theEnv)->FactPatternArray[i].lastLevel->header.selector))
         {
-         RemoveHashedPatternNode(theEnv,FactBinaryData(theEnv)->FactPatternArray[i].lastLevel,
-                                        &FactBinaryData(theEnv)->FactPatternArray[i],
-                                        FactBinaryData(theEnv)->FactPatternArray[i].networkTest->type,
-                                        FactBinaryData(theEnv)->FactPatternArray[i].networkTest->value);
+         RemoveHashedPatternNodes(theEnv,FactBinaryData(theEnv)->FactPatternArray[i].lastLevel,
+                                  &FactBinaryData(theEnv)->FactPatternArray[i],
+                                  FactBinaryData(theEnv)->FactPatternArray[i].networkTest);
         }
-     }
 
+      if (FactBinaryData(theEnv)->FactPatternArray[i].slotBitMap != NULL)
+        { DecrementBitMapReferenceCount(theEnv,FactBinaryData(theEnv)->FactPatternArray[i].slotBitMap); }
+     }
 
    space = FactBinaryData(theEnv)->NumberOfPatterns * sizeof(struct factPatternNode);
    if (space != 0) genfree(theEnv,FactBinaryData(theEnv)->FactPatternArray,space);
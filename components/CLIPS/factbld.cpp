@@ -56,6 +56,7 @@
 #include "reteutil.h"
 #include "router.h"
 #include "tmpltdef.h"
+#include "tmpltutl.h"
 
 #include "factbld.h"
 
@@ -73,6 +74,11 @@
    static struct patternNodeHeader  *PlaceFactPattern(Environment *,struct lhsParseNode *);
    static struct lhsParseNode       *RemoveUnneededSlots(Environment *,struct lhsParseNode *);
    static void                       FindAndSetDeftemplatePatternNetwork(Environment *,struct factPatternNode *,struct factPatternNode *);
+   static void                       MarkReferencedSlots(Deftemplate *,struct lhsParseNode *,char *);
+   static void                       UpdateSlotBitMap(Environment *,struct factPatternNode *,char *,unsigned short);
+   static void                       ReleaseSlotBitMap(Environment *,struct factPatternNode *);
+   static void                       VerifyConstantSelector(Environment *,struct factPatternNode *,
+                                                            struct lhsParseNode *,bool);
 #endif
 
 /*********************************************************/
@@ -160,6 +166,8 @@ static struct patternNodeHeader *PlaceFactPattern(
    bool endSlot;
    unsigned int count;
    const char *deftemplateName;
+   char *slotMap = NULL;
+   unsigned short slotMapSize = 0;
 
    /*======================================================================*/
    /* Get the name of the deftemplate associated with the pattern being    */
@@ -168,6 +176,38 @@ static struct patternNodeHeader *PlaceFactPattern(
 
    deftemplateName = thePattern->right->bottom->lexemeValue->contents;
 
+   /*============================================================*/
+   /* Get a pointer to the deftemplate data structure associated */
+   /* with the pattern (use the deftemplate name extracted from  */
+   /* the first field of the pattern).                           */
+   /*============================================================*/
+
+   FactData(theEnv)->CurrentDeftemplate = (Deftemplate *)
+                        FindImportedConstruct(theEnv,"deftemplate",NULL,
+                                              deftemplateName,&count,
+                                              true,NULL);
+
+   /*==================================================*/
+   /* Remember which slots are referenced by a pattern */
+   /* before slots that have no tests are removed, so  */
+   /* that modify can determine if a slot change is    */
+   /* visible to the rule network. The slots are also  */
+   /* recorded in a bitmap attached to the stop node   */
+   /* of the pattern so that a modify only re-matches  */
+   /* the patterns which reference a changed slot.     */
+   /*==================================================*/
+
+   if ((FactData(theEnv)->CurrentDeftemplate != NULL) &&
+       (! FactData(theEnv)->CurrentDeftemplate->implied) &&
+       (FactData(theEnv)->CurrentDeftemplate->numberOfSlots > 0))
+     {
+      slotMapSize = (unsigned short) CountToBitMapSize(FactData(theEnv)->CurrentDeftemplate->numberOfSlots);
+      slotMap = (char *) gm2(theEnv,slotMapSize);
+      ClearBitString(slotMap,slotMapSize);
+     }
+
+   MarkReferencedSlots(FactData(theEnv)->CurrentDeftemplate,thePattern->right->right,slotMap);
+
    /*=====================================================*/
    /* Remove any slot tests that test only for existance. */
    /*=====================================================*/
@@ -224,17 +264,6 @@ static struct patternNodeHeader *PlaceFactPattern(
 
    tempPattern = NULL;
 
-   /*============================================================*/
-   /* Get a pointer to the deftemplate data structure associated */
-   /* with the pattern (use the deftemplate name extracted from  */
-   /* the first field of the pattern).                           */
-   /*============================================================*/
-
-   FactData(theEnv)->CurrentDeftemplate = (Deftemplate *)
-                        FindImportedConstruct(theEnv,"deftemplate",NULL,
-                                              deftemplateName,&count,
-                                              true,NULL);
-
    /*================================================*/
    /* Initialize some pointers to indicate where the */
    /* pattern is being added to the pattern network. */
@@ -272,6 +301,13 @@ static struct patternNodeHeader *PlaceFactPattern(
       else
         { endSlot = false; }
 
+      /*===============================================*/
+      /* Determine if the constant values of the field */
+      /* can be hashed under the selector node.        */
+      /*===============================================*/
+
+      VerifyConstantSelector(theEnv,currentLevel,thePattern,endSlot);
+
       /*========================================*/
       /* Is there a node in the pattern network */
       /* that can be reused (shared)?           */
@@ -328,6 +364,17 @@ static struct patternNodeHeader *PlaceFactPattern(
       currentLevel = newNode->nextLevel;
      }
 
+   /*=================================================*/
+   /* Merge the slots referenced by the pattern into  */
+   /* the slot bitmap of the stop node.               */
+   /*=================================================*/
+
+   if (slotMap != NULL)
+     {
+      UpdateSlotBitMap(theEnv,newNode,slotMap,slotMapSize);
+      rm(theEnv,slotMap,slotMapSize);
+     }
+
    /*==================================================*/
    /* Return the leaf node of the newly added pattern. */
    /*==================================================*/
@@ -335,6 +382,127 @@ static struct patternNodeHeader *PlaceFactPattern(
    return((struct patternNodeHeader *) newNode);
   }
 
+/***********************************************************/
+/* MarkReferencedSlots: Flags each deftemplate slot that   */
+/*   appears in a pattern. Slots are never unflagged when  */
+/*   a rule is removed, so the flags can overestimate the  */
+/*   set of slots visible to the rule network, but never   */
+/*   underestimate it. If a slot map is supplied, the bit  */
+/*   for each referenced slot is also set in the map.      */
+/***********************************************************/
+static void MarkReferencedSlots(
+  Deftemplate *theDeftemplate,
+  struct lhsParseNode *slotNodes,
+  char *slotMap)
+  {
+   struct templateSlot *theSlot;
+
+   if ((theDeftemplate == NULL) || theDeftemplate->implied)
+     { return; }
+
+   for (;
+        slotNodes != NULL;
+        slotNodes = slotNodes->right)
+     {
+      if ((slotNodes->slotNumber == 0) ||
+          (slotNodes->slotNumber == UNSPECIFIED_SLOT))
+        { continue; }
+
+      theSlot = GetNthSlot(theDeftemplate,slotNodes->slotNumber - 1);
+      if (theSlot != NULL)
+        { theSlot->patternReferenced = true; }
+
+      if (slotMap != NULL)
+        { SetBitMap(slotMap,slotNodes->slotNumber - 1); }
+     }
+  }
+
+/**********************************************************/
+/* UpdateSlotBitMap: Merges the slots referenced by a new */
+/*   pattern with the slots referenced by the patterns    */
+/*   already sharing the same stop node.                  */
+/**********************************************************/
+static void UpdateSlotBitMap(
+  Environment *theEnv,
+  struct factPatternNode *stopNode,
+  char *slotMap,
+  unsigned short slotMapSize)
+  {
+   CLIPSBitMap *oldMap;
+   unsigned short i;
+
+   oldMap = stopNode->slotBitMap;
+
+   if (oldMap != NULL)
+     {
+      for (i = 0; (i < slotMapSize) && (i < oldMap->size); i++)
+        { slotMap[i] |= oldMap->contents[i]; }
+     }
+
+   stopNode->slotBitMap = (CLIPSBitMap *) AddBitMap(theEnv,slotMap,slotMapSize);
+   IncrementBitMapCount(stopNode->slotBitMap);
+
+   if (oldMap != NULL)
+     { DecrementBitMapReferenceCount(theEnv,oldMap); }
+  }
+
+/*******************************************************/
+/* ReleaseSlotBitMap: Releases the slot bitmap of a    */
+/*   pattern node which is no longer used as a stop    */
+/*   node or which is being removed from the network.  */
+/*******************************************************/
+static void ReleaseSlotBitMap(
+  Environment *theEnv,
+  struct factPatternNode *thePattern)
+  {
+   if (thePattern->slotBitMap == NULL) return;
+
+   DecrementBitMapReferenceCount(theEnv,thePattern->slotBitMap);
+   thePattern->slotBitMap = NULL;
+  }
+
+/**************************************************************/
+/* VerifyConstantSelector: Determines if the constant values  */
+/*   of a pattern field can be hashed under the selector node */
+/*   shared with other patterns. A value can only be hashed   */
+/*   to one pattern node, so if one of the values is already  */
+/*   hashed to a node testing a different set of values (for  */
+/*   example, red | blue and red), then the field is tested   */
+/*   by a pattern node which is not hashed.                   */
+/**************************************************************/
+static void VerifyConstantSelector(
+  Environment *theEnv,
+  struct factPatternNode *currentLevel,
+  struct lhsParseNode *thePattern,
+  bool endSlot)
+  {
+   struct factPatternNode *selectorNode, *nodeBeforeMatch, *hashedNode;
+   struct expr *theValue;
+
+   if (thePattern->constantSelector == NULL) return;
+
+   selectorNode = FindPatternNode(currentLevel,thePattern,&nodeBeforeMatch,endSlot,false);
+   if (selectorNode == NULL) return;
+
+   for (theValue = thePattern->constantValue;
+        theValue != NULL;
+        theValue = theValue->nextArg)
+     {
+      hashedNode = (struct factPatternNode *)
+                   FindHashedPatternNode(theEnv,selectorNode,theValue->type,theValue->value);
+
+      if ((hashedNode != NULL) &&
+          (! IdenticalExpression(hashedNode->networkTest,thePattern->constantValue)))
+        {
+         ReturnExpression(theEnv,thePattern->constantSelector);
+         ReturnExpression(theEnv,thePattern->constantValue);
+         thePattern->constantSelector = NULL;
+         thePattern->constantValue = NULL;
+         return;
+        }
+     }
+  }
+
 /*************************************************************/
 /* FindPatternNode: Looks for a pattern node at a specified  */
 /*  level in the pattern network that can be reused (shared) */
@@ -611,6 +779,7 @@ static struct factPatternNode *CreateNewPatternNode(
    newNode->nextLevel = NULL;
    newNode->rightNode = NULL;
    newNode->leftNode = NULL;
+   newNode->slotBitMap = NULL;
    newNode->leaveFields = thePattern->singleFieldsAfter;
    InitializePatternHeader(theEnv,(struct patternNodeHeader *) &newNode->header);
 
@@ -662,7 +831,7 @@ static struct factPatternNode *CreateNewPatternNode(
    newNode->lastLevel = upperLevel;
 
    if ((upperLevel != NULL) && (upperLevel->header.selector))
-     { AddHashedPatternNode(theEnv,upperLevel,newNode,newNode->networkTest->type,newNode->networkTest->value); }
+     { AddHashedPatternNodes(theEnv,upperLevel,newNode,newNode->networkTest); }
 
    /*======================================================*/
    /* If there are no nodes on this level, then attach the */
@@ -752,7 +921,11 @@ static void DetachFactPattern(
    /* not be removed since other patterns make use of it.   */
    /*=======================================================*/
 
-   if (patternPtr->header.entryJoin == NULL) patternPtr->header.stopNode = false;
+   if (patternPtr->header.entryJoin == NULL)
+     {
+      patternPtr->header.stopNode = false;
+      ReleaseSlotBitMap(theEnv,patternPtr);
+     }
    if (patternPtr->nextLevel != NULL) return;
 
    /*==============================================================*/
@@ -780,7 +953,7 @@ static void DetachFactPattern(
          else
            {
             if (upperLevel->header.selector)
-              { RemoveHashedPatternNode(theEnv,upperLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+              { RemoveHashedPatternNodes(theEnv,upperLevel,patternPtr,patternPtr->networkTest); }
 
             upperLevel->nextLevel = NULL;
             if (upperLevel->header.stopNode) upperLevel = NULL;
@@ -788,6 +961,7 @@ static void DetachFactPattern(
 
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
+         ReleaseSlotBitMap(theEnv,patternPtr);
          rtn_struct(theEnv,factPatternNode,patternPtr);
         }
       else if (upperLevel->leftNode != NULL)
@@ -802,7 +976,7 @@ static void DetachFactPattern(
 
          if ((patternPtr->lastLevel != NULL) &&
              (patternPtr->lastLevel->header.selector))
-           { RemoveHashedPatternNode(theEnv,patternPtr->lastLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+           { RemoveHashedPatternNodes(theEnv,patternPtr->lastLevel,patternPtr,patternPtr->networkTest); }
 
          upperLevel->leftNode->rightNode = upperLevel->rightNode;
          if (upperLevel->rightNode != NULL)
@@ -810,6 +984,7 @@ static void DetachFactPattern(
 
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
+         ReleaseSlotBitMap(theEnv,patternPtr);
          rtn_struct(theEnv,factPatternNode,patternPtr);
          upperLevel = NULL;
         }
@@ -828,7 +1003,7 @@ static void DetachFactPattern(
          else
            {
            if (upperLevel->header.selector)
-              { RemoveHashedPatternNode(theEnv,upperLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+              { RemoveHashedPatternNodes(theEnv,upperLevel,patternPtr,patternPtr->networkTest); }
 
             upperLevel->nextLevel = patternPtr->rightNode;
            }
@@ -836,6 +1011,7 @@ static void DetachFactPattern(
 
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
+         ReleaseSlotBitMap(theEnv,patternPtr);
          rtn_struct(theEnv,factPatternNode,patternPtr);
          upperLevel = NULL;
         }
@@ -866,7 +1042,7 @@ void DestroyFactPatternNetwork(
 
       if ((thePattern->lastLevel != NULL) &&
           (thePattern->lastLevel->header.selector))
-        { RemoveHashedPatternNode(theEnv,thePattern->lastLevel,thePattern,thePattern->networkTest->type,thePattern->networkTest->value); }
+        { RemoveHashedPatternNodes(theEnv,thePattern->lastLevel,thePattern,thePattern->networkTest); }
 
 #if (! BLOAD_ONLY) && (! RUN_TIME)
       rtn_struct(theEnv,factPatternNode,thePattern);
@@ -0,0 +1,504 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                  FACT BATCH MODULE                  */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Asserts a batch of facts after matching them     */
+/*   against the fact pattern network in several threads.    */
+/*                                                           */
+/*   Until a match reaches an alpha memory, pattern matching */
+/*   a fact only reads the fact and the pattern network, so  */
+/*   the facts of a batch are first traversed in parallel by */
+/*   a set of threads owned by the environment, each one     */
+/*   recording the stop nodes reached by the facts it takes  */
+/*   (see CollectFactAlphaMatches). The facts are then       */
+/*   asserted one after another by the calling thread and    */
+/*   AssertDriver replays the recorded matches in place of   */
+/*   traversing the network, so the alpha memories, the join */
+/*   network, and the agenda are updated in the same order   */
+/*   as if the facts had been asserted one at a time. Facts  */
+/*   whose patterns can't be matched without changing the    */
+/*   environment are matched as usual when asserted.         */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdlib.h>
+
+#include "setup.h"
+
+#if FACT_BATCH_FUNCTIONS
+
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "esp_pthread.h"
+#endif
+
+#include "argacces.h"
+#include "engine.h"
+#include "envrnmnt.h"
+#include "extnfunc.h"
+#include "factmch.h"
+#include "factmngr.h"
+#include "proflfun.h"
+
+#include "factbtch.h"
+
+#define FACT_BATCH_MAX_THREADS 64
+#define FACT_BATCH_CHUNK_SIZE 8
+#define FACT_BATCH_MINIMUM 16
+
+struct factBatchData
+  {
+   unsigned int threadCount;
+   unsigned int started;
+   pthread_t *threads;
+   pthread_mutex_t lock;
+   pthread_cond_t workAvailable;
+   pthread_cond_t workDone;
+   unsigned long generation;
+   unsigned int busy;
+   bool stopping;
+   Fact **facts;
+   size_t factCount;
+   size_t nextFact;
+   struct factAlphaMatches *matches;
+   size_t matchesMax;
+  };
+
+#define FactBatchData(theEnv) ((struct factBatchData *) GetEnvironmentData(theEnv,FACT_BATCH_DATA))
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    DeallocateFactBatchData(Environment *);
+   static void                   *FactBatchThread(void *);
+   static void                    MatchFactBatch(Environment *);
+   static bool                    StartFactBatchThreads(Environment *);
+   static void                    StopFactBatchThreads(Environment *);
+   static bool                    GrowFactBatchMatches(struct factBatchData *,size_t);
+   static unsigned int            FactBatchProcessorCount(void);
+
+/********************************************************/
+/* FactBatchCommandDefinitions: Initializes the data    */
+/*   and the commands used for batches of facts.        */
+/********************************************************/
+void FactBatchCommandDefinitions(
+  Environment *theEnv)
+  {
+   struct factBatchData *theData;
+
+   AllocateEnvironmentData(theEnv,FACT_BATCH_DATA,sizeof(struct factBatchData),DeallocateFactBatchData);
+
+   theData = FactBatchData(theEnv);
+   theData->threadCount = FactBatchProcessorCount();
+   pthread_mutex_init(&theData->lock,NULL);
+   pthread_cond_init(&theData->workAvailable,NULL);
+   pthread_cond_init(&theData->workDone,NULL);
+
+#if ! RUN_TIME
+   AddUDF(theEnv,"set-fact-batch-threads","l",1,1,"l",SetFactBatchThreadsCommand,"SetFactBatchThreadsCommand",NULL);
+   AddUDF(theEnv,"get-fact-batch-threads","l",0,0,NULL,GetFactBatchThreadsCommand,"GetFactBatchThreadsCommand",NULL);
+#endif
+  }
+
+/*******************************************************/
+/* DeallocateFactBatchData: Deallocates environment    */
+/*   data for batches of facts, stopping the threads.  */
+/*******************************************************/
+static void DeallocateFactBatchData(
+  Environment *theEnv)
+  {
+   struct factBatchData *theData = FactBatchData(theEnv);
+   size_t i;
+
+   StopFactBatchThreads(theEnv);
+
+   for (i = 0; i < theData->matchesMax; i++)
+     { free(theData->matches[i].nodes); }
+   free(theData->matches);
+
+   pthread_cond_destroy(&theData->workDone);
+   pthread_cond_destroy(&theData->workAvailable);
+   pthread_mutex_destroy(&theData->lock);
+  }
+
+/*******************************************************/
+/* SetFactBatchThreadsCommand: H/L access routine for  */
+/*   the set-fact-batch-threads command.               */
+/*******************************************************/
+void SetFactBatchThreadsCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   long long threadCount;
+
+   returnValue->integerValue = CreateInteger(theEnv,GetFactBatchThreads(theEnv));
+
+   if (! UDFFirstArgument(context,INTEGER_BIT,&theArg))
+     { return; }
+
+   threadCount = theArg.integerValue->contents;
+   if ((threadCount < 1) || (threadCount > FACT_BATCH_MAX_THREADS))
+     {
+      UDFInvalidArgumentMessage(context,"integer (between 1 and 64)");
+      SetEvaluationError(theEnv,true);
+      return;
+     }
+
+   SetFactBatchThreads(theEnv,(unsigned int) threadCount);
+  }
+
+/*******************************************************/
+/* GetFactBatchThreadsCommand: H/L access routine for  */
+/*   the get-fact-batch-threads command.               */
+/*******************************************************/
+void GetFactBatchThreadsCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+#if MAC_XCD
+#pragma unused(context)
+#endif
+
+   returnValue->integerValue = CreateInteger(theEnv,GetFactBatchThreads(theEnv));
+  }
+
+/*************************************************************/
+/* SetFactBatchThreads: C access routine for setting the     */
+/*   number of threads (including the calling thread) which  */
+/*   match the facts of a batch. The facts of a batch are    */
+/*   matched as they are asserted if the number is 1.        */
+/*   Returns the previous number.                            */
+/*************************************************************/
+unsigned int SetFactBatchThreads(
+  Environment *theEnv,
+  unsigned int threadCount)
+  {
+   struct factBatchData *theData = FactBatchData(theEnv);
+   unsigned int oldCount = theData->threadCount;
+
+   if (threadCount < 1)
+     { threadCount = 1; }
+   else if (threadCount > FACT_BATCH_MAX_THREADS)
+     { threadCount = FACT_BATCH_MAX_THREADS; }
+
+   if (threadCount != oldCount)
+     {
+      StopFactBatchThreads(theEnv);
+      theData->threadCount = threadCount;
+     }
+
+   return oldCount;
+  }
+
+/*************************************************************/
+/* GetFactBatchThreads: C access routine for retrieving the  */
+/*   number of threads which match the facts of a batch.     */
+/*************************************************************/
+unsigned int GetFactBatchThreads(
+  Environment *theEnv)
+  {
+   return FactBatchData(theEnv)->threadCount;
+  }
+
+/******************************************************************/
+/* AssertFactBatch: Asserts an array of facts created with        */
+/*   CreateFact (or the fact builder functions) in order, with    */
+/*   the same results as calling Assert for each one. Each entry  */
+/*   of the array is replaced with the value returned by Assert.  */
+/*   If an assert halts execution, the remaining facts are        */
+/*   released without being asserted and their entries are set    */
+/*   to NULL. Returns the number of facts asserted.               */
+/******************************************************************/
+size_t AssertFactBatch(
+  Environment *theEnv,
+  Fact **theFacts,
+  size_t count)
+  {
+   struct factBatchData *theData = FactBatchData(theEnv);
+   bool parallel;
+   size_t i, asserted = 0;
+
+   /*=======================================================*/
+   /* Small batches aren't worth waking the threads for.    */
+   /* Profiling counts the calls of the functions evaluated */
+   /* in the pattern network, so it requires the usual      */
+   /* evaluation.                                           */
+   /*=======================================================*/
+
+   parallel = (count >= FACT_BATCH_MINIMUM) &&
+              (theData->threadCount > 1) &&
+              (! EngineData(theEnv)->JoinOperationInProgress);
+
+#if PROFILING_FUNCTIONS
+   if (ProfileFunctionData(theEnv)->ProfileUserFunctions)
+     { parallel = false; }
+#endif
+
+   if (parallel)
+     { parallel = GrowFactBatchMatches(theData,count) && StartFactBatchThreads(theEnv); }
+
+   /*==============================================*/
+   /* Let the threads collect the alpha matches of */
+   /* the facts, take part in it, then wait until  */
+   /* all the facts have been traversed.           */
+   /*==============================================*/
+
+   if (parallel)
+     {
+      pthread_mutex_lock(&theData->lock);
+      theData->facts = theFacts;
+      theData->factCount = count;
+      theData->nextFact = 0;
+      theData->busy = theData->started;
+      theData->generation++;
+      pthread_cond_broadcast(&theData->workAvailable);
+      pthread_mutex_unlock(&theData->lock);
+
+      MatchFactBatch(theEnv);
+
+      pthread_mutex_lock(&theData->lock);
+      while (theData->busy > 0)
+        { pthread_cond_wait(&theData->workDone,&theData->lock); }
+      theData->facts = NULL;
+      pthread_mutex_unlock(&theData->lock);
+     }
+
+   /*====================================================*/
+   /* Assert the facts in order, replaying the matches.  */
+   /*====================================================*/
+
+   for (i = 0; i < count; i++)
+     {
+      if (parallel && (! theData->matches[i].serial))
+        { FactData(theEnv)->CurrentAlphaMatches = &theData->matches[i]; }
+
+      theFacts[i] = Assert(theFacts[i]);
+      FactData(theEnv)->CurrentAlphaMatches = NULL;
+
+      if (theFacts[i] != NULL)
+        { asserted++; }
+
+      if (EvaluationData(theEnv)->HaltExecution)
+        {
+         for (i++; i < count; i++)
+           {
+            ReturnFact(theEnv,theFacts[i]);
+            theFacts[i] = NULL;
+           }
+        }
+     }
+
+   return asserted;
+  }
+
+/*****************************************************/
+/* FactBatchThread: Thread routine which collects    */
+/*   the alpha matches of each batch of facts.       */
+/*****************************************************/
+static void *FactBatchThread(
+  void *context)
+  {
+   Environment *theEnv = (Environment *) context;
+   struct factBatchData *theData = FactBatchData(theEnv);
+   unsigned long generation = 0;
+
+   pthread_mutex_lock(&theData->lock);
+
+   while (true)
+     {
+      while ((! theData->stopping) && (theData->generation == generation))
+        { pthread_cond_wait(&theData->workAvailable,&theData->lock); }
+
+      if (theData->stopping) break;
+
+      generation = theData->generation;
+      pthread_mutex_unlock(&theData->lock);
+
+      MatchFactBatch(theEnv);
+
+      pthread_mutex_lock(&theData->lock);
+      theData->busy--;
+      if (theData->busy == 0)
+        { pthread_cond_broadcast(&theData->workDone); }
+     }
+
+   pthread_mutex_unlock(&theData->lock);
+
+   return NULL;
+  }
+
+/*****************************************************************/
+/* MatchFactBatch: Collects the alpha matches of the facts of    */
+/*   the current batch, taking a few facts at a time until every */
+/*   fact has been taken by one of the threads.                  */
+/*****************************************************************/
+static void MatchFactBatch(
+  Environment *theEnv)
+  {
+   struct factBatchData *theData = FactBatchData(theEnv);
+   struct factAlphaMatches *theMatches;
+   size_t i, first, last;
+
+   while (true)
+     {
+      pthread_mutex_lock(&theData->lock);
+      first = theData->nextFact;
+      last = first + FACT_BATCH_CHUNK_SIZE;
+      if (last > theData->factCount)
+        { last = theData->factCount; }
+      theData->nextFact = last;
+      pthread_mutex_unlock(&theData->lock);
+
+      if (first >= last) return;
+
+      for (i = first; i < last; i++)
+        {
+         theMatches = &theData->matches[i];
+         theMatches->serial = ! CollectFactAlphaMatches(theEnv,theData->facts[i],theMatches);
+        }
+     }
+  }
+
+/******************************************************************/
+/* StartFactBatchThreads: Starts the threads of the environment   */
+/*   the first time a batch is matched with more than one thread. */
+/*   Returns false if no thread could be started.                 */
+/******************************************************************/
+static bool StartFactBatchThreads(
+  Environment *theEnv)
+  {
+   struct factBatchData *theData = FactBatchData(theEnv);
+   unsigned int i, wanted;
+#if defined(ESP_PLATFORM)
+   esp_pthread_cfg_t threadConfig = esp_pthread_get_default_config();
+#endif
+
+   if (theData->threads != NULL)
+     { return (theData->started > 0); }
+
+   wanted = theData->threadCount - 1;
+   theData->threads = (pthread_t *) malloc(sizeof(pthread_t) * wanted);
+   if (theData->threads == NULL)
+     { return false; }
+
+   theData->stopping = false;
+
+   for (i = 0; i < wanted; i++)
+     {
+#if defined(ESP_PLATFORM)
+      threadConfig.stack_size = FACT_BATCH_STACK_SIZE;
+      threadConfig.pin_to_core = (int) ((i + 1) % portNUM_PROCESSORS);
+      threadConfig.thread_name = "clips-batch";
+      esp_pthread_set_cfg(&threadConfig);
+#endif
+      if (pthread_create(&theData->threads[i],NULL,FactBatchThread,theEnv) != 0)
+        { break; }
+
+      theData->started++;
+     }
+
+   return (theData->started > 0);
+  }
+
+/*************************************************/
+/* StopFactBatchThreads: Stops the threads which */
+/*   have been started for the environment.      */
+/*************************************************/
+static void StopFactBatchThreads(
+  Environment *theEnv)
+  {
+   struct factBatchData *theData = FactBatchData(theEnv);
+   unsigned int i;
+
+   if (theData->threads == NULL)
+     { return; }
+
+   pthread_mutex_lock(&theData->lock);
+   theData->stopping = true;
+   pthread_cond_broadcast(&theData->workAvailable);
+   pthread_mutex_unlock(&theData->lock);
+
+   for (i = 0; i < theData->started; i++)
+     { pthread_join(theData->threads[i],NULL); }
+
+   free(theData->threads);
+   theData->threads = NULL;
+   theData->started = 0;
+  }
+
+/*******************************************************************/
+/* GrowFactBatchMatches: Makes room for the matches of a batch.    */
+/*   The node arrays of the entries are grown by the threads which */
+/*   fill them, so malloc is used rather than the memory functions */
+/*   of the environment (which are not thread safe).               */
+/*******************************************************************/
+static bool GrowFactBatchMatches(
+  struct factBatchData *theData,
+  size_t count)
+  {
+   struct factAlphaMatches *newMatches;
+   size_t i;
+
+   if (count <= theData->matchesMax)
+     { return true; }
+
+   newMatches = (struct factAlphaMatches *)
+                realloc(theData->matches,sizeof(struct factAlphaMatches) * count);
+   if (newMatches == NULL)
+     { return false; }
+
+   for (i = theData->matchesMax; i < count; i++)
+     {
+      newMatches[i].theFact = NULL;
+      newMatches[i].serial = true;
+      newMatches[i].nodes = NULL;
+      newMatches[i].count = 0;
+      newMatches[i].max = 0;
+     }
+
+   theData->matches = newMatches;
+   theData->matchesMax = count;
+
+   return true;
+  }
+
+/*********************************************************/
+/* FactBatchProcessorCount: Returns the number of cores, */
+/*   used as the default number of matching threads.     */
+/*********************************************************/
+static unsigned int FactBatchProcessorCount(void)
+  {
+#if defined(ESP_PLATFORM)
+   return portNUM_PROCESSORS;
+#else
+   long processors;
+
+   processors = sysconf(_SC_NPROCESSORS_ONLN);
+   if (processors < 1)
+     { return 1; }
+   if (processors > FACT_BATCH_MAX_THREADS)
+     { return FACT_BATCH_MAX_THREADS; }
+
+   return (unsigned int) processors;
+#endif
+  }
+
+#endif /* FACT_BATCH_FUNCTIONS */
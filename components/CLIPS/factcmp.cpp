@@ -47,6 +47,7 @@
 #include "factcmp.h"
 #include "tmpltdef.h"
 #include "envrnmnt.h"
+#include "symblcmp.h"
 
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
@@ -350,13 +351,21 @@ static void PatternNodeToCode(
    /*============*/
 
    if (thePatternNode->rightNode == NULL)
-     { fprintf(theFile,"NULL}"); }
+     { fprintf(theFile,"NULL,"); }
    else
      {
-      fprintf(theFile,"&%s%d_%ld[%ld]}",FactPrefix(),
+      fprintf(theFile,"&%s%d_%ld[%ld],",FactPrefix(),
             imageID,(thePatternNode->rightNode->bsaveID / maxIndices) + 1,
                 thePatternNode->rightNode->bsaveID % maxIndices);
      }
+
+   /*==============*/
+   /* Slot Bit Map */
+   /*==============*/
+
+   PrintBitMapReference(theEnv,theFile,thePatternNode->slotBitMap);
+
+   fprintf(theFile,"}");
   }
 
 /**********************************************************/
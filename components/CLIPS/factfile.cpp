@@ -47,7 +47,7 @@
 #endif
 #include "cstrcpsr.h"
 #include "factmngr.h"
-#include "factrhs.h"
+#include "factstrm.h"
 #include "insmngr.h"
 #include "memalloc.h"
 #include "modulpsr.h"
@@ -57,6 +57,7 @@
 #include "scanner.h"
 #include "strngrtr.h"
 #include "symblbin.h"
+#include "symbol.h"
 #include "sysdep.h"
 #include "tmpltdef.h"
 #include "tmpltutl.h"
@@ -84,7 +85,6 @@ struct bsaveSlotValueAtom
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
 
-   static struct expr            *StandardLoadFact(Environment *,const char *,struct token *);
    static Deftemplate           **GetSaveFactsDeftemplateNames(Environment *,const char *,struct expr *,SaveScope,
                                                                unsigned int *,bool *);
 
@@ -219,6 +219,7 @@ long SaveFactsDriver(
    bool tempValue1, tempValue2, tempValue3;
    Fact *theFact;
    FILE *filePtr;
+   FactStreamWriter *theWriter;
    Defmodule *theModule;
    Deftemplate **deftemplateArray;
    unsigned int count, i;
@@ -270,6 +271,7 @@ long SaveFactsDriver(
    /*=================*/
 
    theModule = GetCurrentModule(theEnv);
+   theWriter = CreateFactStreamWriter(theEnv,filePtr);
 
    for (theFact = GetNextFactInScope(theEnv,NULL);
         theFact != NULL;
@@ -321,11 +323,25 @@ long SaveFactsDriver(
       if (printFact)
         {
          factCount++;
-         PrintFact(theEnv,(char *) filePtr,theFact,false,false,NULL);
-         WriteString(theEnv,(char *) filePtr,"\n");
+         StreamSaveFact(theWriter,theFact);
         }
      }
 
+   /*=======================================*/
+   /* Write the text remaining in the       */
+   /* writer's buffer and check that all of */
+   /* the writes to the file succeeded.     */
+   /*=======================================*/
+
+   if (! DeleteFactStreamWriter(theWriter))
+     {
+      PrintErrorID(theEnv,"FACTFILE",4,false);
+      WriteString(theEnv,STDERR,"Function 'save-facts' could not write to file '");
+      WriteString(theEnv,STDERR,fileName);
+      WriteString(theEnv,STDERR,"'.\n");
+      factCount = -1;
+     }
+
    /*==========================*/
    /* Restore the print flags. */
    /*==========================*/
@@ -525,12 +541,7 @@ long LoadFacts(
   const char *fileName)
   {
    FILE *filePtr;
-   struct token theToken;
-   struct expr *testPtr;
-   UDFValue rv;
-   int danglingConstructs;
-   GCBlock gcb;
-   long factCount = 0;
+   long factCount;
 
    /*=====================================*/
    /* If embedded, clear the error flags. */
@@ -539,9 +550,9 @@ long LoadFacts(
    if (EvaluationData(theEnv)->CurrentExpression == NULL)
      { ResetErrorFlags(theEnv); }
 
-   /*======================================================*/
-   /* Open the file. Use either "fast save" or I/O Router. */
-   /*======================================================*/
+   /*================*/
+   /* Open the file. */
+   /*================*/
 
    if ((filePtr = GenOpen(theEnv,fileName,"r")) == NULL)
      {
@@ -549,50 +560,20 @@ long LoadFacts(
       return -1;
      }
 
-   SetFastLoad(theEnv,filePtr);
-
-   /*========================================*/
-   /* Set up the frame for tracking garbage. */
-   /*========================================*/
-   
-   GCBlockStart(theEnv,&gcb);
-
-   /*=================*/
-   /* Load the facts. */
-   /*=================*/
-   
-   danglingConstructs = ConstructData(theEnv)->DanglingConstructs;
-
-   theToken.tknType = LEFT_PARENTHESIS_TOKEN;
-   while (theToken.tknType != STOP_TOKEN)
-     {
-      testPtr = StandardLoadFact(theEnv,(char *) filePtr,&theToken);
-      if (testPtr == NULL) theToken.tknType = STOP_TOKEN;
-      else
-        {
-         factCount++;
-         ExpressionInstall(theEnv,testPtr);
-         EvaluateExpression(theEnv,testPtr,&rv);
-         ExpressionDeinstall(theEnv,testPtr);
-        }
-      ReturnExpression(theEnv,testPtr);
-     }
-     
-   /*================================*/
-   /* Restore the old garbage frame. */
-   /*================================*/
+   /*==========================================*/
+   /* Load the facts. The file is read through */
+   /* a fixed size buffer and each fact is     */
+   /* built directly from the values read.     */
+   /*==========================================*/
    
-   GCBlockEnd(theEnv,&gcb);
+   factCount = StreamLoadFacts(theEnv,filePtr,NULL,0);
 
    /*===============================================*/
    /* If embedded, clean the topmost garbage frame. */
    /*===============================================*/
 
    if (EvaluationData(theEnv)->CurrentExpression == NULL)
-     {
-      CleanCurrentGarbageFrame(theEnv,NULL);
-      ConstructData(theEnv)->DanglingConstructs = danglingConstructs;
-     }
+     { CleanCurrentGarbageFrame(theEnv,NULL); }
 
    /*======================*/
    /* Call periodic tasks. */
@@ -604,7 +585,6 @@ long LoadFacts(
    /* Close the file. */
    /*=================*/
 
-   SetFastLoad(theEnv,NULL);
    GenClose(theEnv,filePtr);
 
    /*================================================*/
@@ -624,11 +604,7 @@ long LoadFactsFromString(
   const char *theString,
   size_t theMax)
   {
-   const char *theStrRouter = "*** load-facts-from-string ***";
-   struct token theToken;
-   struct expr *testPtr;
-   UDFValue rv;
-   long factCount = 0;
+   long factCount;
    
    /*=====================================*/
    /* If embedded, clear the error flags. */
@@ -637,36 +613,11 @@ long LoadFactsFromString(
    if (EvaluationData(theEnv)->CurrentExpression == NULL)
      { ResetErrorFlags(theEnv); }
 
-   /*==========================*/
-   /* Initialize string router */
-   /*==========================*/
-
-   if ((theMax == SIZE_MAX) ? (! OpenStringSource(theEnv,theStrRouter,theString,0)) :
-                              (! OpenTextSource(theEnv,theStrRouter,theString,0,theMax)))
-     { return -1; }
-
    /*=================*/
    /* Load the facts. */
    /*=================*/
 
-   theToken.tknType = LEFT_PARENTHESIS_TOKEN;
-   while (theToken.tknType != STOP_TOKEN)
-     {
-      testPtr = StandardLoadFact(theEnv,theStrRouter,&theToken);
-      if (testPtr == NULL) theToken.tknType = STOP_TOKEN;
-      else
-        {
-         factCount++;
-         EvaluateExpression(theEnv,testPtr,&rv);
-        }
-      ReturnExpression(theEnv,testPtr);
-     }
-
-   /*=================*/
-   /* Close router.   */
-   /*=================*/
-
-   CloseStringSource(theEnv,theStrRouter);
+   factCount = StreamLoadFacts(theEnv,NULL,theString,theMax);
 
    /*==================================================*/
    /* Return the fact count if no error occurred while */
@@ -677,41 +628,6 @@ long LoadFactsFromString(
    return factCount;
   }
 
-/**************************************************************************/
-/* StandardLoadFact: Loads a single fact from the specified logical name. */
-/**************************************************************************/
-static struct expr *StandardLoadFact(
-  Environment *theEnv,
-  const char *logicalName,
-  struct token *theToken)
-  {
-   bool error = false;
-   struct expr *temp;
-
-   GetToken(theEnv,logicalName,theToken);
-   if (theToken->tknType != LEFT_PARENTHESIS_TOKEN) return NULL;
-
-   temp = GenConstant(theEnv,FCALL,FindFunction(theEnv,"assert"));
-   temp->argList = GetRHSPattern(theEnv,logicalName,theToken,&error,
-                                  true,false,true,RIGHT_PARENTHESIS_TOKEN);
-
-   if (error == true)
-     {
-      WriteString(theEnv,STDERR,"Function load-facts encountered an error\n");
-      SetEvaluationError(theEnv,true);
-      ReturnExpression(theEnv,temp);
-      return NULL;
-     }
-
-   if (ExpressionContainsVariables(temp,true))
-     {
-      ReturnExpression(theEnv,temp);
-      return NULL;
-     }
-
-   return(temp);
-  }
-
 /**********************************************/
 /* BinaryLoadFactsCommand: H/L access routine */
 /*   for the bload-facts command.             */
@@ -1266,7 +1182,10 @@ long BinarySaveFactsDriver(
 
    if (EvaluationData(theEnv)->CurrentExpression == NULL)
      { ResetErrorFlags(theEnv); }
-     
+
+   if (SharedAtomBaseError(theEnv,"bsave-facts"))
+     { return -1; }
+
    /*======================================================*/
    /* Open the file. Use either "fast save" or I/O Router. */
    /*======================================================*/
@@ -0,0 +1,1769 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                 FACT JOURNAL MODULE                 */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Keeps an append-only log of the changes made to  */
+/*   the fact-list so the facts can be restored after a      */
+/*   restart without saving the whole fact-list each time.   */
+/*                                                           */
+/*   The journal begins with a base holding an assert record */
+/*   for each fact, followed by a record for each fact that  */
+/*   is asserted, retracted, or modified afterwards. Each    */
+/*   record is written and flushed as the change is made.    */
+/*   A record holds its type, the length of its contents,    */
+/*   the contents, and a checksum, so a record which was not */
+/*   completely written when power was lost is detected and  */
+/*   the journal is restored up to the previous record.      */
+/*   Facts are identified by their fact index. A modify      */
+/*   record holds only the slots that were changed.          */
+/*                                                           */
+/*   The journal is compacted by writing a new base for the  */
+/*   current facts to a temporary file which then replaces   */
+/*   the journal. This is done when journaling starts, after */
+/*   a reset, and when the records added since the last base */
+/*   are larger than both the base and the size given by     */
+/*   FACT_JOURNAL_COMPACT_SIZE.                              */
+/*                                                           */
+/*   When a journal is replayed, the facts are first built   */
+/*   without being asserted, so facts retracted later in the */
+/*   journal are never pattern matched. The facts remaining  */
+/*   at the end are asserted in the order of their original  */
+/*   fact indices.                                           */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if FACT_JOURNAL_FUNCTIONS
+
+#include "argacces.h"
+#if BLOAD || BLOAD_AND_BSAVE || BLOAD_ONLY
+#include "bload.h"
+#endif
+#include "constant.h"
+#include "constrct.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "factmngr.h"
+#include "memalloc.h"
+#include "moduldef.h"
+#include "multifld.h"
+#include "prntutil.h"
+#include "router.h"
+#include "symbol.h"
+#include "sysdep.h"
+#include "tmpltdef.h"
+#include "tmpltutl.h"
+#include "utility.h"
+
+#if OBJECT_SYSTEM
+#include "object.h"
+#endif
+
+#include "factjrnl.h"
+
+#define FACT_JOURNAL_PREFIX_ID "\1\2\3\4CLIPS-FACT-JOURNAL"
+
+#define FACT_JOURNAL_HASH_SIZE 257
+
+#define ASSERT_RECORD           'A'
+#define RETRACT_RECORD          'R'
+#define MODIFY_RECORD           'M'
+
+#define SYMBOL_CODE             'y'
+#define STRING_CODE             's'
+#define INSTANCE_NAME_CODE      'n'
+#define INTEGER_CODE            'i'
+#define FLOAT_CODE              'f'
+#define MULTIFIELD_CODE         'm'
+
+/*****************************************************************/
+/* journalReader: Reads the journal through a block buffer. The  */
+/*   contents of the current record are copied to the payload    */
+/*   buffer, which only grows to the size of the largest record. */
+/*****************************************************************/
+struct journalReader
+  {
+   FILE *filePtr;
+   size_t bufferPosition;
+   size_t bufferLength;
+   unsigned char *payload;
+   size_t payloadLength;
+   size_t payloadMax;
+   size_t position;
+   bool error;
+   unsigned char buffer[FACT_JOURNAL_BUFFER_SIZE];
+  };
+
+/*************************************************************/
+/* journalEntry: A fact built from the journal which has not */
+/*   been asserted yet, hashed by its original fact index.   */
+/*************************************************************/
+struct journalEntry
+  {
+   long long id;
+   Fact *theFact;
+   struct journalEntry *next;
+  };
+
+struct journalReplay
+  {
+   const char *fileName;
+   struct journalEntry **table;
+   unsigned long tableSize;
+   unsigned long count;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    DeallocateFactJournalData(Environment *);
+   static void                    JournalAssertCallback(Environment *,void *,void *);
+   static void                    JournalRetractCallback(Environment *,void *,void *);
+   static void                    JournalModifyCallback(Environment *,Fact *,Fact *,void *);
+   static void                    JournalResetStart(Environment *,void *);
+   static void                    JournalResetEnd(Environment *,void *);
+   static void                    BeginJournalRecord(Environment *,int);
+   static void                    AddJournalBytes(Environment *,const void *,size_t);
+   static void                    AddJournalNumber(Environment *,unsigned long long);
+   static void                    AddJournalString(Environment *,const char *);
+   static void                    AddJournalValue(Environment *,unsigned short,void *);
+   static void                    AddJournalFact(Environment *,Fact *);
+   static bool                    WriteJournalRecord(Environment *,FILE *);
+   static void                    AppendJournalRecord(Environment *);
+   static void                    CheckJournalCompaction(Environment *);
+   static bool                    WriteJournalBase(Environment *);
+   static unsigned long           JournalChecksum(unsigned long,const unsigned char *,size_t);
+   static long                    ReplayFactJournal(Environment *,const char *);
+   static int                     ReadJournalByte(struct journalReader *);
+   static int                     ReadJournalRecord(Environment *,struct journalReader *);
+   static bool                    GetJournalNumber(struct journalReader *,unsigned long long *);
+   static const char             *GetJournalString(struct journalReader *);
+   static bool                    GetJournalValue(Environment *,struct journalReader *,CLIPSValue *,bool);
+   static int                     ReplayAssertRecord(Environment *,struct journalReader *,struct journalReplay *);
+   static bool                    ReplayRetractRecord(Environment *,struct journalReader *,struct journalReplay *);
+   static bool                    ReplayModifyRecord(Environment *,struct journalReader *,struct journalReplay *);
+   static Deftemplate            *FindJournalDeftemplate(Environment *,const char *,const char *,bool);
+   static struct journalEntry   **FindJournalEntry(struct journalReplay *,long long);
+   static void                    AddJournalEntry(Environment *,struct journalReplay *,long long,Fact *);
+   static void                    DiscardJournalFact(Environment *,Fact *);
+   static long                    AssertJournalFacts(Environment *,struct journalReplay *);
+   static void                    FreeJournalReplay(Environment *,struct journalReplay *);
+   static int                     CompareJournalEntries(const void *,const void *);
+   static void                    JournalFormatError(Environment *,const char *,const char *,const char *,const char *);
+
+/**********************************************************/
+/* FactJournalCommandDefinitions: Initializes the journal */
+/*   data and the fact journal commands.                  */
+/**********************************************************/
+void FactJournalCommandDefinitions(
+  Environment *theEnv)
+  {
+   AllocateEnvironmentData(theEnv,FACT_JOURNAL_DATA,sizeof(struct factJournalData),DeallocateFactJournalData);
+
+#if ! RUN_TIME
+   AddUDF(theEnv,"journal-facts","l",1,1,"sy",JournalFactsCommand,"JournalFactsCommand",NULL);
+   AddUDF(theEnv,"close-fact-journal","b",0,0,NULL,CloseFactJournalCommand,"CloseFactJournalCommand",NULL);
+   AddUDF(theEnv,"compact-fact-journal","b",0,0,NULL,CompactFactJournalCommand,"CompactFactJournalCommand",NULL);
+#endif
+
+   /*===================================================*/
+   /* The facts removed by a reset are not journaled.   */
+   /* The journal is compacted instead once the facts   */
+   /* have been removed and before the deffacts are     */
+   /* asserted (the facts are reset with priority 60).  */
+   /*===================================================*/
+
+   AddResetFunction(theEnv,"fact-journal-start",JournalResetStart,65,NULL);
+   AddResetFunction(theEnv,"fact-journal-end",JournalResetEnd,55,NULL);
+  }
+
+/*************************************************/
+/* DeallocateFactJournalData: Closes the journal */
+/*   and releases its buffers.                   */
+/*************************************************/
+static void DeallocateFactJournalData(
+  Environment *theEnv)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+
+   if (theData->filePtr != NULL)
+     { GenClose(theEnv,theData->filePtr); }
+
+   if (theData->fileName != NULL)
+     { rm(theEnv,theData->fileName,theData->fileNameLength); }
+
+   if (theData->record != NULL)
+     { rm(theEnv,theData->record,theData->recordMax); }
+
+   if (theData->modifiedValues != NULL)
+     { rm(theEnv,theData->modifiedValues,sizeof(void *) * theData->modifiedMax); }
+  }
+
+/**********************************************/
+/* JournalFactsCommand: H/L access routine    */
+/*   for the journal-facts command.           */
+/**********************************************/
+void JournalFactsCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *fileName;
+
+   if ((fileName = GetFileName(context)) == NULL)
+     {
+      returnValue->integerValue = CreateInteger(theEnv,-1);
+      return;
+     }
+
+   returnValue->integerValue = CreateInteger(theEnv,JournalFacts(theEnv,fileName));
+  }
+
+/**********************************************/
+/* CloseFactJournalCommand: H/L access        */
+/*   routine for the close-fact-journal       */
+/*   command.                                 */
+/**********************************************/
+void CloseFactJournalCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,CloseFactJournal(theEnv));
+  }
+
+/**********************************************/
+/* CompactFactJournalCommand: H/L access      */
+/*   routine for the compact-fact-journal     */
+/*   command.                                 */
+/**********************************************/
+void CompactFactJournalCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,CompactFactJournal(theEnv));
+  }
+
+/*************************************************************/
+/* JournalFacts: C access routine for the journal-facts      */
+/*   command. The facts in the journal (if the file exists)  */
+/*   are restored, the journal is compacted to hold all of   */
+/*   the current facts, and the changes made to the facts    */
+/*   are then appended to it. Returns the number of facts    */
+/*   restored, or -1 if an error occurred.                   */
+/*************************************************************/
+long JournalFacts(
+  Environment *theEnv,
+  const char *fileName)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+   long factCount;
+
+   /*=====================================*/
+   /* If embedded, clear the error flags. */
+   /*=====================================*/
+
+   if (EvaluationData(theEnv)->CurrentExpression == NULL)
+     { ResetErrorFlags(theEnv); }
+
+   CloseFactJournal(theEnv);
+
+   /*============================================*/
+   /* Restore the facts. The journal is not open */
+   /* so the facts asserted are not journaled.   */
+   /*============================================*/
+
+   factCount = ReplayFactJournal(theEnv,fileName);
+   if (factCount < 0)
+     { return -1; }
+
+   theData->fileNameLength = strlen(fileName) + 1;
+   theData->fileName = (char *) gm2(theEnv,theData->fileNameLength);
+   genstrcpy(theData->fileName,fileName);
+
+   /*=====================================================*/
+   /* Replace the journal with a base for the facts. The  */
+   /* restored facts now have new fact indices, so the    */
+   /* old records no longer refer to the right facts.     */
+   /*=====================================================*/
+
+   if (! WriteJournalBase(theEnv))
+     {
+      CloseFactJournal(theEnv);
+      return -1;
+     }
+
+   if ((theData->filePtr = GenOpen(theEnv,fileName,"ab")) == NULL)
+     {
+      OpenErrorMessage(theEnv,"journal-facts",fileName);
+      CloseFactJournal(theEnv);
+      return -1;
+     }
+
+   /*======================================================*/
+   /* The callbacks stay registered once they are added,   */
+   /* and do nothing when no journal is open. Removing     */
+   /* them from within a callback (after a write error)    */
+   /* would change the lists while they are being called.  */
+   /*======================================================*/
+
+   if (! theData->callbacksAdded)
+     {
+      AddAssertFunction(theEnv,"fact-journal",JournalAssertCallback,0,NULL);
+      AddRetractFunction(theEnv,"fact-journal",JournalRetractCallback,0,NULL);
+      AddModifyFunction(theEnv,"fact-journal",JournalModifyCallback,0,NULL);
+      theData->callbacksAdded = true;
+     }
+
+   return factCount;
+  }
+
+/***************************************************/
+/* CloseFactJournal: C access routine for the      */
+/*   close-fact-journal command. Returns false if  */
+/*   no journal was open.                          */
+/***************************************************/
+bool CloseFactJournal(
+  Environment *theEnv)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+
+   if (theData->fileName == NULL)
+     { return false; }
+
+   if (theData->filePtr != NULL)
+     {
+      GenClose(theEnv,theData->filePtr);
+      theData->filePtr = NULL;
+     }
+
+   rm(theEnv,theData->fileName,theData->fileNameLength);
+   theData->fileName = NULL;
+   theData->modifiedFact = NULL;
+   theData->resetInProgress = false;
+
+   return true;
+  }
+
+/***************************************************/
+/* CompactFactJournal: C access routine for the    */
+/*   compact-fact-journal command. Replaces the    */
+/*   journal with a base for the current facts.    */
+/*   Returns false if no journal is open or if the */
+/*   new base could not be written, in which case  */
+/*   records are still appended to the old one.    */
+/***************************************************/
+bool CompactFactJournal(
+  Environment *theEnv)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+   bool rv;
+
+   if ((theData->filePtr == NULL) ||
+       (theData->modifiedFact != NULL))
+     { return false; }
+
+   GenClose(theEnv,theData->filePtr);
+   theData->filePtr = NULL;
+
+   rv = WriteJournalBase(theEnv);
+
+   if ((theData->filePtr = GenOpen(theEnv,theData->fileName,"ab")) == NULL)
+     {
+      OpenErrorMessage(theEnv,"compact-fact-journal",theData->fileName);
+      return false;
+     }
+
+   return rv;
+  }
+
+/*****************************************************/
+/* JournalAssertCallback: Appends an assert record   */
+/*   for a fact which is not the result of a modify. */
+/*****************************************************/
+static void JournalAssertCallback(
+  Environment *theEnv,
+  void *theValue,
+  void *context)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+   Fact *theFact = (Fact *) theValue;
+
+   if ((theData->filePtr == NULL) ||
+       (theFact == theData->modifiedFact))
+     { return; }
+
+   BeginJournalRecord(theEnv,ASSERT_RECORD);
+   AddJournalFact(theEnv,theFact);
+   AppendJournalRecord(theEnv);
+
+   CheckJournalCompaction(theEnv);
+  }
+
+/*******************************************************/
+/* JournalRetractCallback: Appends a retract record    */
+/*   for a fact which is not being modified or removed */
+/*   by a reset.                                       */
+/*******************************************************/
+static void JournalRetractCallback(
+  Environment *theEnv,
+  void *theValue,
+  void *context)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+   Fact *theFact = (Fact *) theValue;
+
+   if ((theData->filePtr == NULL) ||
+       theData->resetInProgress ||
+       (theFact == theData->modifiedFact))
+     { return; }
+
+   BeginJournalRecord(theEnv,RETRACT_RECORD);
+   AddJournalNumber(theEnv,(unsigned long long) theFact->factIndex);
+   AppendJournalRecord(theEnv);
+  }
+
+/***************************************************************/
+/* JournalModifyCallback: Called with the old fact before a    */
+/*   modify and with the new fact after it. The slot values of */
+/*   the old fact are remembered so that the modify record     */
+/*   holds only the slots which were changed. Since values are */
+/*   shared, a changed slot holds a different value pointer.   */
+/*   If the modify produced a duplicate of another fact or     */
+/*   lost its logical support, the old fact no longer exists   */
+/*   and a retract record is written instead.                  */
+/***************************************************************/
+static void JournalModifyCallback(
+  Environment *theEnv,
+  Fact *oldFact,
+  Fact *newFact,
+  void *context)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+   size_t i, length, changed;
+   CLIPSValue *theContents;
+
+   if (theData->filePtr == NULL)
+     { return; }
+
+   /*===================================*/
+   /* Remember the values of the fact.  */
+   /*===================================*/
+
+   if (oldFact != NULL)
+     {
+      length = oldFact->theProposition.length;
+      if (length > theData->modifiedMax)
+        {
+         if (theData->modifiedValues != NULL)
+           { rm(theEnv,theData->modifiedValues,sizeof(void *) * theData->modifiedMax); }
+         theData->modifiedValues = (void **) gm2(theEnv,sizeof(void *) * length);
+         theData->modifiedMax = length;
+        }
+
+      for (i = 0; i < length; i++)
+        { theData->modifiedValues[i] = oldFact->theProposition.contents[i].value; }
+
+      theData->modifiedFact = oldFact;
+      theData->modifiedIndex = oldFact->factIndex;
+      return;
+     }
+
+   if (theData->modifiedFact == NULL)
+     { return; }
+
+   /*====================================================*/
+   /* Write the changed slots if the modified fact still */
+   /* exists, otherwise write a retract record for it.   */
+   /*====================================================*/
+
+   if ((newFact == theData->modifiedFact) &&
+       (newFact->factIndex == theData->modifiedIndex))
+     {
+      theContents = newFact->theProposition.contents;
+      length = newFact->theProposition.length;
+
+      for (i = 0, changed = 0; i < length; i++)
+        {
+         if (theContents[i].value != theData->modifiedValues[i])
+           { changed++; }
+        }
+
+      if (changed > 0)
+        {
+         BeginJournalRecord(theEnv,MODIFY_RECORD);
+         AddJournalNumber(theEnv,(unsigned long long) theData->modifiedIndex);
+         AddJournalNumber(theEnv,changed);
+         for (i = 0; i < length; i++)
+           {
+            if (theContents[i].value != theData->modifiedValues[i])
+              {
+               AddJournalNumber(theEnv,i);
+               AddJournalValue(theEnv,theContents[i].header->type,theContents[i].value);
+              }
+           }
+         AppendJournalRecord(theEnv);
+        }
+     }
+   else
+     {
+      BeginJournalRecord(theEnv,RETRACT_RECORD);
+      AddJournalNumber(theEnv,(unsigned long long) theData->modifiedIndex);
+      AppendJournalRecord(theEnv);
+     }
+
+   theData->modifiedFact = NULL;
+
+   CheckJournalCompaction(theEnv);
+  }
+
+/*****************************************************/
+/* JournalResetStart: Stops retract records from     */
+/*   being written for the facts removed by a reset. */
+/*****************************************************/
+static void JournalResetStart(
+  Environment *theEnv,
+  void *context)
+  {
+   if (FactJournalData(theEnv)->filePtr != NULL)
+     { FactJournalData(theEnv)->resetInProgress = true; }
+  }
+
+/*******************************************************/
+/* JournalResetEnd: Compacts the journal once a reset  */
+/*   has removed the facts. If the new base can not be */
+/*   written, journaling is stopped since the journal  */
+/*   does not hold the retractions made by the reset.  */
+/*******************************************************/
+static void JournalResetEnd(
+  Environment *theEnv,
+  void *context)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+
+   if (! theData->resetInProgress)
+     { return; }
+
+   theData->resetInProgress = false;
+
+   if (! CompactFactJournal(theEnv))
+     { CloseFactJournal(theEnv); }
+  }
+
+/*******************************************************/
+/* CheckJournalCompaction: Compacts the journal if the */
+/*   records appended since the last base are larger   */
+/*   than the base and FACT_JOURNAL_COMPACT_SIZE, so   */
+/*   each compaction costs at most a constant amount   */
+/*   of work for each record appended before it.       */
+/*******************************************************/
+static void CheckJournalCompaction(
+  Environment *theEnv)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+
+   if ((theData->filePtr == NULL) ||
+       (theData->appendedSize <= FACT_JOURNAL_COMPACT_SIZE) ||
+       (theData->appendedSize <= theData->baseSize))
+     { return; }
+
+   /*=============================================*/
+   /* If the base can't be written, wait for as   */
+   /* many records again before the next attempt. */
+   /*=============================================*/
+
+   if (! CompactFactJournal(theEnv))
+     { theData->appendedSize = 0; }
+  }
+
+/*************************************************/
+/* BeginJournalRecord: Starts a record of the    */
+/*   specified type in the record buffer.        */
+/*************************************************/
+static void BeginJournalRecord(
+  Environment *theEnv,
+  int recordType)
+  {
+   unsigned char theType = (unsigned char) recordType;
+
+   FactJournalData(theEnv)->recordLength = 0;
+   AddJournalBytes(theEnv,&theType,1);
+  }
+
+/**************************************************/
+/* AddJournalBytes: Adds bytes to the record      */
+/*   buffer, expanding it if necessary.           */
+/**************************************************/
+static void AddJournalBytes(
+  Environment *theEnv,
+  const void *theBytes,
+  size_t length)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+   unsigned char *newRecord;
+   size_t newMax;
+
+   if (theData->recordLength + length > theData->recordMax)
+     {
+      newMax = theData->recordMax * 2;
+      if (newMax < FACT_JOURNAL_BUFFER_SIZE)
+        { newMax = FACT_JOURNAL_BUFFER_SIZE; }
+      while (newMax < theData->recordLength + length)
+        { newMax *= 2; }
+
+      newRecord = (unsigned char *) gm2(theEnv,newMax);
+      if (theData->record != NULL)
+        {
+         memcpy(newRecord,theData->record,theData->recordLength);
+         rm(theEnv,theData->record,theData->recordMax);
+        }
+
+      theData->record = newRecord;
+      theData->recordMax = newMax;
+     }
+
+   memcpy(theData->record + theData->recordLength,theBytes,length);
+   theData->recordLength += length;
+  }
+
+/****************************************************/
+/* AddJournalNumber: Adds an unsigned number to the */
+/*   record using seven bits for each byte.         */
+/****************************************************/
+static void AddJournalNumber(
+  Environment *theEnv,
+  unsigned long long theNumber)
+  {
+   unsigned char theBytes[10];
+   size_t length = 0;
+
+   while (theNumber >= 0x80)
+     {
+      theBytes[length++] = (unsigned char) ((theNumber & 0x7F) | 0x80);
+      theNumber >>= 7;
+     }
+   theBytes[length++] = (unsigned char) theNumber;
+
+   AddJournalBytes(theEnv,theBytes,length);
+  }
+
+/*****************************************************/
+/* AddJournalString: Adds the length of a string and */
+/*   its characters including the terminating null.  */
+/*****************************************************/
+static void AddJournalString(
+  Environment *theEnv,
+  const char *theString)
+  {
+   size_t length = strlen(theString);
+
+   AddJournalNumber(theEnv,length);
+   AddJournalBytes(theEnv,theString,length + 1);
+  }
+
+/************************************************************/
+/* AddJournalValue: Adds a slot value to the record. As in  */
+/*   save-facts, fact and external addresses are saved as   */
+/*   strings and instance addresses as instance names.      */
+/************************************************************/
+static void AddJournalValue(
+  Environment *theEnv,
+  unsigned short theType,
+  void *theValue)
+  {
+   unsigned char theCode;
+   long long theInteger;
+   double theFloat;
+   Multifield *theMultifield;
+   char buffer[60];
+   size_t i;
+
+   switch (theType)
+     {
+      case SYMBOL_TYPE:
+        theCode = SYMBOL_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        AddJournalString(theEnv,((CLIPSLexeme *) theValue)->contents);
+        break;
+
+      case STRING_TYPE:
+        theCode = STRING_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        AddJournalString(theEnv,((CLIPSLexeme *) theValue)->contents);
+        break;
+
+      case INSTANCE_NAME_TYPE:
+        theCode = INSTANCE_NAME_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        AddJournalString(theEnv,((CLIPSLexeme *) theValue)->contents);
+        break;
+
+      case INTEGER_TYPE:
+        theCode = INTEGER_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        theInteger = ((CLIPSInteger *) theValue)->contents;
+        AddJournalNumber(theEnv,(((unsigned long long) theInteger) << 1) ^
+                                (unsigned long long) (theInteger >> 63));
+        break;
+
+      case FLOAT_TYPE:
+        theCode = FLOAT_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        theFloat = ((CLIPSFloat *) theValue)->contents;
+        AddJournalBytes(theEnv,&theFloat,sizeof(double));
+        break;
+
+      case MULTIFIELD_TYPE:
+        theCode = MULTIFIELD_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        theMultifield = (Multifield *) theValue;
+        AddJournalNumber(theEnv,theMultifield->length);
+        for (i = 0; i < theMultifield->length; i++)
+          {
+           AddJournalValue(theEnv,theMultifield->contents[i].header->type,
+                           theMultifield->contents[i].value);
+          }
+        break;
+
+      case FACT_ADDRESS_TYPE:
+        theCode = STRING_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        gensnprintf(buffer,sizeof(buffer),"<Fact-%lld>",((Fact *) theValue)->factIndex);
+        AddJournalString(theEnv,buffer);
+        break;
+
+#if OBJECT_SYSTEM
+      case INSTANCE_ADDRESS_TYPE:
+        theCode = INSTANCE_NAME_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        AddJournalString(theEnv,((Instance *) theValue)->name->contents);
+        break;
+#endif
+
+      default:
+        theCode = STRING_CODE;
+        AddJournalBytes(theEnv,&theCode,1);
+        if (theType == EXTERNAL_ADDRESS_TYPE)
+          {
+           gensnprintf(buffer,sizeof(buffer),"<Pointer-%d-%p>",
+                       ((CLIPSExternalAddress *) theValue)->type,
+                       ((CLIPSExternalAddress *) theValue)->contents);
+           AddJournalString(theEnv,buffer);
+          }
+        else
+          { AddJournalString(theEnv,"<unknown atom type>"); }
+        break;
+     }
+  }
+
+/*****************************************************/
+/* AddJournalFact: Adds the contents of an assert    */
+/*   record for a fact: its fact index, the module   */
+/*   and name of its deftemplate, and its values.    */
+/*****************************************************/
+static void AddJournalFact(
+  Environment *theEnv,
+  Fact *theFact)
+  {
+   Deftemplate *theDeftemplate = theFact->whichDeftemplate;
+   unsigned char implied = theDeftemplate->implied ? 1 : 0;
+   size_t i;
+
+   AddJournalNumber(theEnv,(unsigned long long) theFact->factIndex);
+   AddJournalString(theEnv,theDeftemplate->header.whichModule->theModule->header.name->contents);
+   AddJournalString(theEnv,theDeftemplate->header.name->contents);
+   AddJournalBytes(theEnv,&implied,1);
+   AddJournalNumber(theEnv,theFact->theProposition.length);
+
+   for (i = 0; i < theFact->theProposition.length; i++)
+     {
+      AddJournalValue(theEnv,theFact->theProposition.contents[i].header->type,
+                      theFact->theProposition.contents[i].value);
+     }
+  }
+
+/****************************************************************/
+/* WriteJournalRecord: Writes the record in the record buffer   */
+/*   as its type, the length of its contents, the contents, and */
+/*   the checksum of the type and contents. Returns false if a  */
+/*   write failed.                                              */
+/****************************************************************/
+static bool WriteJournalRecord(
+  Environment *theEnv,
+  FILE *filePtr)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+   unsigned char header[11], trailer[4];
+   size_t headerLength = 1, contentLength;
+   unsigned long checksum;
+   bool rv = true;
+
+   contentLength = theData->recordLength - 1;
+   header[0] = theData->record[0];
+   while (contentLength >= 0x80)
+     {
+      header[headerLength++] = (unsigned char) ((contentLength & 0x7F) | 0x80);
+      contentLength >>= 7;
+     }
+   header[headerLength++] = (unsigned char) contentLength;
+
+   checksum = JournalChecksum(2166136261UL,theData->record,theData->recordLength);
+   trailer[0] = (unsigned char) (checksum & 0xFF);
+   trailer[1] = (unsigned char) ((checksum >> 8) & 0xFF);
+   trailer[2] = (unsigned char) ((checksum >> 16) & 0xFF);
+   trailer[3] = (unsigned char) ((checksum >> 24) & 0xFF);
+
+   if (GenWrite(header,headerLength,filePtr) != headerLength) rv = false;
+   if (GenWrite(theData->record + 1,theData->recordLength - 1,filePtr) != theData->recordLength - 1) rv = false;
+   if (GenWrite(trailer,sizeof(trailer),filePtr) != sizeof(trailer)) rv = false;
+
+   return rv;
+  }
+
+/***************************************************************/
+/* AppendJournalRecord: Appends the record in the buffer to    */
+/*   the journal and flushes it. If the write fails, an error  */
+/*   is printed and journaling is stopped: later records would */
+/*   otherwise follow an incomplete one and be lost on replay. */
+/***************************************************************/
+static void AppendJournalRecord(
+  Environment *theEnv)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+
+   if (WriteJournalRecord(theEnv,theData->filePtr) &&
+       (GenFlush(theEnv,theData->filePtr) == 0))
+     {
+      theData->appendedSize += (unsigned long) theData->recordLength + 5;
+      return;
+     }
+
+   PrintErrorID(theEnv,"FACTJRNL",4,false);
+   WriteString(theEnv,STDERR,"Unable to write to the fact journal '");
+   WriteString(theEnv,STDERR,theData->fileName);
+   WriteString(theEnv,STDERR,"'. Journaling has been stopped.\n");
+
+   GenClose(theEnv,theData->filePtr);
+   theData->filePtr = NULL;
+   theData->modifiedFact = NULL;
+  }
+
+/**************************************************************/
+/* WriteJournalBase: Writes the journal header and an assert  */
+/*   record for each fact to a temporary file which then      */
+/*   replaces the journal, so the previous journal is kept if */
+/*   the base is not completely written.                      */
+/**************************************************************/
+static bool WriteJournalBase(
+  Environment *theEnv)
+  {
+   struct factJournalData *theData = FactJournalData(theEnv);
+   FILE *fp;
+   char *tempName;
+   size_t tempLength;
+   unsigned long baseSize;
+   Fact *theFact;
+   bool rv = true;
+
+   tempLength = strlen(theData->fileName) + 5;
+   tempName = (char *) genalloc(theEnv,tempLength);
+   gensnprintf(tempName,tempLength,"%s.tmp",theData->fileName);
+
+   if ((fp = GenOpen(theEnv,tempName,"wb")) == NULL)
+     {
+      OpenErrorMessage(theEnv,"journal-facts",tempName);
+      genfree(theEnv,tempName,tempLength);
+      return false;
+     }
+
+   baseSize = sizeof(FACT_JOURNAL_PREFIX_ID);
+   if (GenWrite((void *) FACT_JOURNAL_PREFIX_ID,sizeof(FACT_JOURNAL_PREFIX_ID),fp) != sizeof(FACT_JOURNAL_PREFIX_ID))
+     { rv = false; }
+
+   for (theFact = GetNextFact(theEnv,NULL);
+        (theFact != NULL) && rv;
+        theFact = GetNextFact(theEnv,theFact))
+     {
+      BeginJournalRecord(theEnv,ASSERT_RECORD);
+      AddJournalFact(theEnv,theFact);
+      rv = WriteJournalRecord(theEnv,fp);
+      baseSize += (unsigned long) theData->recordLength + 5;
+     }
+
+   if (GenClose(theEnv,fp) != 0)
+     { rv = false; }
+
+   if (! rv)
+     {
+      PrintErrorID(theEnv,"FACTJRNL",4,false);
+      WriteString(theEnv,STDERR,"Unable to write to the fact journal '");
+      WriteString(theEnv,STDERR,tempName);
+      WriteString(theEnv,STDERR,"'.\n");
+     }
+   else
+     {
+      genremove(theEnv,theData->fileName);
+      if (! genrename(theEnv,tempName,theData->fileName))
+        {
+         OpenErrorMessage(theEnv,"journal-facts",theData->fileName);
+         rv = false;
+        }
+     }
+
+   if (rv)
+     {
+      theData->baseSize = baseSize;
+      theData->appendedSize = 0;
+     }
+   else
+     { genremove(theEnv,tempName); }
+
+   genfree(theEnv,tempName,tempLength);
+
+   return rv;
+  }
+
+/****************************************************/
+/* JournalChecksum: Updates a 32 bit FNV-1a hash of */
+/*   the bytes of a record.                         */
+/****************************************************/
+static unsigned long JournalChecksum(
+  unsigned long checksum,
+  const unsigned char *theBytes,
+  size_t length)
+  {
+   size_t i;
+
+   for (i = 0; i < length; i++)
+     {
+      checksum ^= theBytes[i];
+      checksum = (checksum * 16777619UL) & 0xFFFFFFFFUL;
+     }
+
+   return checksum;
+  }
+
+/****************************************************************/
+/* ReplayFactJournal: Builds the facts described by a journal   */
+/*   and asserts those remaining at its end. Returns the number */
+/*   of facts asserted, 0 if the journal does not exist, or -1  */
+/*   if the journal could not be restored.                      */
+/****************************************************************/
+static long ReplayFactJournal(
+  Environment *theEnv,
+  const char *fileName)
+  {
+   struct journalReader *theReader;
+   struct journalReplay theReplay;
+   char prefix[sizeof(FACT_JOURNAL_PREFIX_ID)];
+   GCBlock gcb;
+   FILE *fp;
+   size_t prefixLength;
+   unsigned long recordCount = 0;
+   long factCount;
+   int recordType, rv = 1;
+
+   if ((fp = GenOpen(theEnv,fileName,"rb")) == NULL)
+     { return 0; }
+
+   /*==============================================*/
+   /* An empty file is a journal without any facts */
+   /* (for example when power was lost while its   */
+   /* first base was being written).               */
+   /*==============================================*/
+
+   prefixLength = fread(prefix,1,sizeof(FACT_JOURNAL_PREFIX_ID),fp);
+   if (prefixLength == 0)
+     {
+      GenClose(theEnv,fp);
+      return 0;
+     }
+
+   if ((prefixLength != sizeof(FACT_JOURNAL_PREFIX_ID)) ||
+       (memcmp(prefix,FACT_JOURNAL_PREFIX_ID,sizeof(FACT_JOURNAL_PREFIX_ID)) != 0))
+     {
+      PrintErrorID(theEnv,"FACTJRNL",3,false);
+      WriteString(theEnv,STDERR,"The file '");
+      WriteString(theEnv,STDERR,fileName);
+      WriteString(theEnv,STDERR,"' is not a fact journal.\n");
+      GenClose(theEnv,fp);
+      return -1;
+     }
+
+   theReader = (struct journalReader *) gm2(theEnv,sizeof(struct journalReader));
+   theReader->filePtr = fp;
+   theReader->bufferPosition = 0;
+   theReader->bufferLength = 0;
+   theReader->payload = NULL;
+   theReader->payloadLength = 0;
+   theReader->payloadMax = 0;
+
+   theReplay.fileName = fileName;
+   theReplay.tableSize = FACT_JOURNAL_HASH_SIZE;
+   theReplay.table = (struct journalEntry **) gm2(theEnv,sizeof(struct journalEntry *) * theReplay.tableSize);
+   memset(theReplay.table,0,sizeof(struct journalEntry *) * theReplay.tableSize);
+   theReplay.count = 0;
+
+   /*=========================================================*/
+   /* The values of the facts being built are retained, so    */
+   /* the garbage frame is cleaned after each batch of        */
+   /* records to release the values that were replaced.       */
+   /*=========================================================*/
+
+   GCBlockStart(theEnv,&gcb);
+
+   while ((recordType = ReadJournalRecord(theEnv,theReader)) > 0)
+     {
+      theReader->position = 0;
+      theReader->error = false;
+
+      switch (recordType)
+        {
+         case ASSERT_RECORD:
+           rv = ReplayAssertRecord(theEnv,theReader,&theReplay);
+           break;
+
+         case RETRACT_RECORD:
+           rv = ReplayRetractRecord(theEnv,theReader,&theReplay) ? 1 : 0;
+           break;
+
+         case MODIFY_RECORD:
+           rv = ReplayModifyRecord(theEnv,theReader,&theReplay) ? 1 : 0;
+           break;
+        }
+
+      if (rv <= 0) break;
+
+      if ((++recordCount % FACT_JOURNAL_BATCH_SIZE) == 0)
+        { CleanCurrentGarbageFrame(theEnv,NULL); }
+     }
+
+   /*=========================================================*/
+   /* A record which is incomplete or was damaged ends the    */
+   /* journal. It and any bytes following it are discarded   */
+   /* when the journal is compacted.                          */
+   /*=========================================================*/
+
+   if ((recordType < 0) || (rv == 0))
+     {
+      PrintWarningID(theEnv,"FACTJRNL",1,false);
+      WriteString(theEnv,STDWRN,"The fact journal '");
+      WriteString(theEnv,STDWRN,fileName);
+      if (ReadJournalByte(theReader) == EOF)
+        { WriteString(theEnv,STDWRN,"' ends with an incomplete record which was ignored.\n"); }
+      else
+        { WriteString(theEnv,STDWRN,"' has a damaged record. It and the rest of the journal were ignored.\n"); }
+     }
+
+   GenClose(theEnv,fp);
+
+   if (rv < 0)
+     {
+      FreeJournalReplay(theEnv,&theReplay);
+      factCount = -1;
+     }
+   else
+     { factCount = AssertJournalFacts(theEnv,&theReplay); }
+
+   GCBlockEnd(theEnv,&gcb);
+
+   if (theReader->payload != NULL)
+     { rm(theEnv,theReader->payload,theReader->payloadMax); }
+   rm(theEnv,theReader,sizeof(struct journalReader));
+
+   return factCount;
+  }
+
+/****************************************************/
+/* ReadJournalByte: Returns the next byte from the  */
+/*   block buffer of the reader, or EOF.            */
+/****************************************************/
+static int ReadJournalByte(
+  struct journalReader *theReader)
+  {
+   if (theReader->bufferPosition == theReader->bufferLength)
+     {
+      theReader->bufferLength = fread(theReader->buffer,1,FACT_JOURNAL_BUFFER_SIZE,theReader->filePtr);
+      theReader->bufferPosition = 0;
+      if (theReader->bufferLength == 0)
+        { return EOF; }
+     }
+
+   return theReader->buffer[theReader->bufferPosition++];
+  }
+
+/***************************************************************/
+/* ReadJournalRecord: Reads the next record into the payload   */
+/*   buffer and returns its type. Returns 0 at the end of the  */
+/*   journal and -1 if the record is incomplete or damaged.    */
+/*   The payload buffer grows only as the contents are read,   */
+/*   so a damaged length can not cause a large allocation.     */
+/***************************************************************/
+static int ReadJournalRecord(
+  Environment *theEnv,
+  struct journalReader *theReader)
+  {
+   int recordType, inchar, shift;
+   size_t length, available, newMax;
+   unsigned char *newPayload, theType;
+   unsigned long checksum, stored;
+
+   if ((recordType = ReadJournalByte(theReader)) == EOF)
+     { return 0; }
+
+   if ((recordType != ASSERT_RECORD) &&
+       (recordType != RETRACT_RECORD) &&
+       (recordType != MODIFY_RECORD))
+     { return -1; }
+
+   /*=========================================*/
+   /* Read the length of the record contents. */
+   /*=========================================*/
+
+   length = 0;
+   for (shift = 0; ; shift += 7)
+     {
+      if ((inchar = ReadJournalByte(theReader)) == EOF)
+        { return -1; }
+      if (shift > 56)
+        { return -1; }
+      length |= ((size_t) (inchar & 0x7F)) << shift;
+      if ((inchar & 0x80) == 0) break;
+     }
+
+   /*============================*/
+   /* Read the record contents.  */
+   /*============================*/
+
+   theReader->payloadLength = 0;
+   while (theReader->payloadLength < length)
+     {
+      if (theReader->bufferPosition == theReader->bufferLength)
+        {
+         theReader->bufferLength = fread(theReader->buffer,1,FACT_JOURNAL_BUFFER_SIZE,theReader->filePtr);
+         theReader->bufferPosition = 0;
+         if (theReader->bufferLength == 0)
+           { return -1; }
+        }
+
+      available = theReader->bufferLength - theReader->bufferPosition;
+      if (available > length - theReader->payloadLength)
+        { available = length - theReader->payloadLength; }
+
+      if (theReader->payloadLength + available > theReader->payloadMax)
+        {
+         newMax = theReader->payloadMax * 2;
+         if (newMax < FACT_JOURNAL_BUFFER_SIZE)
+           { newMax = FACT_JOURNAL_BUFFER_SIZE; }
+         while (newMax < theReader->payloadLength + available)
+           { newMax *= 2; }
+
+         newPayload = (unsigned char *) gm2(theEnv,newMax);
+         if (theReader->payload != NULL)
+           {
+            memcpy(newPayload,theReader->payload,theReader->payloadLength);
+            rm(theEnv,theReader->payload,theReader->payloadMax);
+           }
+         theReader->payload = newPayload;
+         theReader->payloadMax = newMax;
+        }
+
+      memcpy(theReader->payload + theReader->payloadLength,
+             theReader->buffer + theReader->bufferPosition,available);
+      theReader->payloadLength += available;
+      theReader->bufferPosition += available;
+     }
+
+   /*=========================*/
+   /* Compare the checksums.  */
+   /*=========================*/
+
+   stored = 0;
+   for (shift = 0; shift < 32; shift += 8)
+     {
+      if ((inchar = ReadJournalByte(theReader)) == EOF)
+        { return -1; }
+      stored |= ((unsigned long) inchar) << shift;
+     }
+
+   theType = (unsigned char) recordType;
+   checksum = JournalChecksum(2166136261UL,&theType,1);
+   checksum = JournalChecksum(checksum,theReader->payload,theReader->payloadLength);
+
+   if (checksum != stored)
+     { return -1; }
+
+   return recordType;
+  }
+
+/*****************************************************/
+/* GetJournalNumber: Reads an unsigned number from   */
+/*   the contents of the current record.             */
+/*****************************************************/
+static bool GetJournalNumber(
+  struct journalReader *theReader,
+  unsigned long long *theNumber)
+  {
+   unsigned long long value = 0;
+   unsigned char theByte;
+   int shift;
+
+   for (shift = 0; shift <= 63; shift += 7)
+     {
+      if (theReader->position >= theReader->payloadLength)
+        { break; }
+
+      theByte = theReader->payload[theReader->position++];
+      value |= ((unsigned long long) (theByte & 0x7F)) << shift;
+      if ((theByte & 0x80) == 0)
+        {
+         *theNumber = value;
+         return true;
+        }
+     }
+
+   theReader->error = true;
+   return false;
+  }
+
+/*****************************************************/
+/* GetJournalString: Returns a string stored in the  */
+/*   contents of the current record, or NULL.        */
+/*****************************************************/
+static const char *GetJournalString(
+  struct journalReader *theReader)
+  {
+   unsigned long long length;
+   const char *theString;
+
+   if (! GetJournalNumber(theReader,&length))
+     { return NULL; }
+
+   if ((length >= theReader->payloadLength - theReader->position) ||
+       (theReader->payload[theReader->position + length] != '\0'))
+     {
+      theReader->error = true;
+      return NULL;
+     }
+
+   theString = (const char *) theReader->payload + theReader->position;
+   theReader->position += (size_t) length + 1;
+
+   return theString;
+  }
+
+/*************************************************************/
+/* GetJournalValue: Reads a value from the contents of the   */
+/*   current record. A multifield value is returned as an    */
+/*   unmanaged multifield to be stored in a fact.            */
+/*************************************************************/
+static bool GetJournalValue(
+  Environment *theEnv,
+  struct journalReader *theReader,
+  CLIPSValue *returnValue,
+  bool allowMultifield)
+  {
+   unsigned long long theNumber, length;
+   const char *theString;
+   Multifield *theMultifield;
+   double theFloat;
+   size_t i;
+
+   if (theReader->position >= theReader->payloadLength)
+     {
+      theReader->error = true;
+      return false;
+     }
+
+   switch (theReader->payload[theReader->position++])
+     {
+      case SYMBOL_CODE:
+        if ((theString = GetJournalString(theReader)) == NULL) return false;
+        returnValue->lexemeValue = CreateSymbol(theEnv,theString);
+        return true;
+
+      case STRING_CODE:
+        if ((theString = GetJournalString(theReader)) == NULL) return false;
+        returnValue->lexemeValue = CreateString(theEnv,theString);
+        return true;
+
+      case INSTANCE_NAME_CODE:
+        if ((theString = GetJournalString(theReader)) == NULL) return false;
+        returnValue->lexemeValue = CreateInstanceName(theEnv,theString);
+        return true;
+
+      case INTEGER_CODE:
+        if (! GetJournalNumber(theReader,&theNumber)) return false;
+        returnValue->integerValue = CreateInteger(theEnv,(long long) ((theNumber >> 1) ^ (~(theNumber & 1) + 1)));
+        return true;
+
+      case FLOAT_CODE:
+        if (theReader->payloadLength - theReader->position < sizeof(double))
+          { break; }
+        memcpy(&theFloat,theReader->payload + theReader->position,sizeof(double));
+        theReader->position += sizeof(double);
+        returnValue->floatValue = CreateFloat(theEnv,theFloat);
+        return true;
+
+      case MULTIFIELD_CODE:
+        if ((! allowMultifield) || (! GetJournalNumber(theReader,&length)))
+          { break; }
+
+        /*==============================================*/
+        /* Each value takes at least two bytes, which   */
+        /* bounds the size of a damaged multifield.     */
+        /*==============================================*/
+
+        if (length > (theReader->payloadLength - theReader->position) / 2)
+          { break; }
+
+        theMultifield = CreateUnmanagedMultifield(theEnv,(size_t) length);
+        for (i = 0; i < length; i++)
+          {
+           if (! GetJournalValue(theEnv,theReader,&theMultifield->contents[i],false))
+             {
+              ReturnMultifield(theEnv,theMultifield);
+              return false;
+             }
+          }
+        returnValue->multifieldValue = theMultifield;
+        return true;
+     }
+
+   theReader->error = true;
+   return false;
+  }
+
+/****************************************************************/
+/* ReplayAssertRecord: Builds the fact of an assert record.     */
+/*   Returns 1 if the record was read, 0 if it is damaged, and  */
+/*   -1 if its deftemplate does not exist or has other slots.   */
+/****************************************************************/
+static int ReplayAssertRecord(
+  Environment *theEnv,
+  struct journalReader *theReader,
+  struct journalReplay *theReplay)
+  {
+   unsigned long long id, slotCount;
+   const char *moduleName, *templateName;
+   Deftemplate *theDeftemplate;
+   struct templateSlot *theSlot;
+   Fact *theFact;
+   CLIPSValue *theContents;
+   bool implied;
+   size_t i;
+
+   if ((! GetJournalNumber(theReader,&id)) ||
+       ((moduleName = GetJournalString(theReader)) == NULL) ||
+       ((templateName = GetJournalString(theReader)) == NULL) ||
+       (theReader->position >= theReader->payloadLength))
+     { return 0; }
+
+   implied = (theReader->payload[theReader->position++] != 0);
+
+   if (! GetJournalNumber(theReader,&slotCount))
+     { return 0; }
+
+   theDeftemplate = FindJournalDeftemplate(theEnv,moduleName,templateName,implied);
+   if (theDeftemplate == NULL)
+     {
+      JournalFormatError(theEnv,theReplay->fileName,moduleName,templateName,"which does not exist");
+      return -1;
+     }
+
+   if ((theDeftemplate->implied != implied) ||
+       (slotCount != (implied ? 1 : theDeftemplate->numberOfSlots)))
+     {
+      JournalFormatError(theEnv,theReplay->fileName,moduleName,templateName,"with different slots");
+      return -1;
+     }
+
+   /*=====================================================*/
+   /* Build the fact. Its values are retained until it is */
+   /* asserted or discarded.                              */
+   /*=====================================================*/
+
+   theFact = CreateFact(theDeftemplate);
+   theContents = theFact->theProposition.contents;
+
+   if (implied)
+     {
+      ReturnMultifield(theEnv,theContents[0].multifieldValue);
+      theContents[0].voidValue = VoidConstant(theEnv);
+     }
+
+   for (i = 0, theSlot = theDeftemplate->slotList;
+        i < slotCount;
+        i++, theSlot = (theSlot != NULL) ? theSlot->next : NULL)
+     {
+      if ((! GetJournalValue(theEnv,theReader,&theContents[i],true)) ||
+          ((theContents[i].header->type == MULTIFIELD_TYPE) != (implied || theSlot->multislot)))
+        {
+         if ((! theReader->error) && (theContents[i].header->type == MULTIFIELD_TYPE))
+           { ReturnMultifield(theEnv,theContents[i].multifieldValue); }
+         theContents[i].voidValue = VoidConstant(theEnv);
+         DiscardJournalFact(theEnv,theFact);
+         return 0;
+        }
+
+      Retain(theEnv,theContents[i].header);
+     }
+
+   AddJournalEntry(theEnv,theReplay,(long long) id,theFact);
+
+   return 1;
+  }
+
+/*******************************************************/
+/* ReplayRetractRecord: Discards the fact of a retract */
+/*   record. Returns false if the record is damaged.   */
+/*******************************************************/
+static bool ReplayRetractRecord(
+  Environment *theEnv,
+  struct journalReader *theReader,
+  struct journalReplay *theReplay)
+  {
+   unsigned long long id;
+   struct journalEntry **theLink, *theEntry;
+
+   if (! GetJournalNumber(theReader,&id))
+     { return false; }
+
+   theLink = FindJournalEntry(theReplay,(long long) id);
+   if ((theEntry = *theLink) == NULL)
+     { return true; }
+
+   *theLink = theEntry->next;
+   theReplay->count--;
+
+   DiscardJournalFact(theEnv,theEntry->theFact);
+   rtn_struct(theEnv,journalEntry,theEntry);
+
+   return true;
+  }
+
+/*****************************************************/
+/* ReplayModifyRecord: Replaces the changed slots of */
+/*   the fact of a modify record. Returns false if   */
+/*   the record is damaged.                          */
+/*****************************************************/
+static bool ReplayModifyRecord(
+  Environment *theEnv,
+  struct journalReader *theReader,
+  struct journalReplay *theReplay)
+  {
+   unsigned long long id, changed, position;
+   struct journalEntry *theEntry;
+   Fact *theFact;
+   CLIPSValue *theSlotValue, theValue;
+   struct templateSlot *theSlot;
+   bool multislot;
+   unsigned long long i, j;
+
+   if ((! GetJournalNumber(theReader,&id)) ||
+       (! GetJournalNumber(theReader,&changed)))
+     { return false; }
+
+   if ((theEntry = *FindJournalEntry(theReplay,(long long) id)) == NULL)
+     { return true; }
+
+   theFact = theEntry->theFact;
+
+   for (i = 0; i < changed; i++)
+     {
+      if ((! GetJournalNumber(theReader,&position)) ||
+          (position >= theFact->theProposition.length))
+        { return false; }
+
+      if (theFact->whichDeftemplate->implied)
+        { multislot = true; }
+      else
+        {
+         for (j = 0, theSlot = theFact->whichDeftemplate->slotList;
+              j < position;
+              j++, theSlot = theSlot->next)
+           { /* Do Nothing */ }
+         multislot = theSlot->multislot;
+        }
+
+      if (! GetJournalValue(theEnv,theReader,&theValue,true))
+        { return false; }
+
+      if ((theValue.header->type == MULTIFIELD_TYPE) != multislot)
+        {
+         if (theValue.header->type == MULTIFIELD_TYPE)
+           { ReturnMultifield(theEnv,theValue.multifieldValue); }
+         return false;
+        }
+
+      theSlotValue = &theFact->theProposition.contents[position];
+      Release(theEnv,theSlotValue->header);
+      if (theSlotValue->header->type == MULTIFIELD_TYPE)
+        { ReturnMultifield(theEnv,theSlotValue->multifieldValue); }
+
+      theSlotValue->value = theValue.value;
+      Retain(theEnv,theSlotValue->header);
+     }
+
+   return true;
+  }
+
+/***************************************************************/
+/* FindJournalDeftemplate: Finds the deftemplate of an assert  */
+/*   record in its module, creating it if it is an implied     */
+/*   deftemplate which does not exist.                         */
+/***************************************************************/
+static Deftemplate *FindJournalDeftemplate(
+  Environment *theEnv,
+  const char *moduleName,
+  const char *templateName,
+  bool implied)
+  {
+   Defmodule *theModule, *saveModule;
+   Deftemplate *theDeftemplate;
+
+   if ((theModule = FindDefmodule(theEnv,moduleName)) == NULL)
+     { return NULL; }
+
+   saveModule = GetCurrentModule(theEnv);
+   SetCurrentModule(theEnv,theModule);
+
+   theDeftemplate = FindDeftemplateInModule(theEnv,templateName);
+
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   if ((theDeftemplate == NULL) && implied)
+     {
+#if BLOAD || BLOAD_AND_BSAVE
+      if (! Bloaded(theEnv))
+#endif
+        { theDeftemplate = CreateImpliedDeftemplate(theEnv,CreateSymbol(theEnv,templateName),true); }
+     }
+#endif
+
+   SetCurrentModule(theEnv,saveModule);
+
+   return theDeftemplate;
+  }
+
+/*****************************************************/
+/* FindJournalEntry: Returns the link to the entry   */
+/*   with the specified fact index in the hash table */
+/*   (which links to NULL if there is none).         */
+/*****************************************************/
+static struct journalEntry **FindJournalEntry(
+  struct journalReplay *theReplay,
+  long long id)
+  {
+   struct journalEntry **theLink;
+
+   theLink = &theReplay->table[(unsigned long long) id % theReplay->tableSize];
+   while ((*theLink != NULL) && ((*theLink)->id != id))
+     { theLink = &(*theLink)->next; }
+
+   return theLink;
+  }
+
+/***************************************************************/
+/* AddJournalEntry: Adds a fact to the hash table, replacing   */
+/*   any fact with the same index. The table is doubled when   */
+/*   it holds more entries than buckets.                       */
+/***************************************************************/
+static void AddJournalEntry(
+  Environment *theEnv,
+  struct journalReplay *theReplay,
+  long long id,
+  Fact *theFact)
+  {
+   struct journalEntry **theLink, *theEntry, **newTable, *nextEntry;
+   unsigned long newSize, i;
+
+   theLink = FindJournalEntry(theReplay,id);
+   if ((theEntry = *theLink) != NULL)
+     {
+      DiscardJournalFact(theEnv,theEntry->theFact);
+      theEntry->theFact = theFact;
+      return;
+     }
+
+   if (theReplay->count >= theReplay->tableSize)
+     {
+      newSize = theReplay->tableSize * 2 + 1;
+      newTable = (struct journalEntry **) gm2(theEnv,sizeof(struct journalEntry *) * newSize);
+      memset(newTable,0,sizeof(struct journalEntry *) * newSize);
+
+      for (i = 0; i < theReplay->tableSize; i++)
+        {
+         for (theEntry = theReplay->table[i]; theEntry != NULL; theEntry = nextEntry)
+           {
+            nextEntry = theEntry->next;
+            theEntry->next = newTable[(unsigned long long) theEntry->id % newSize];
+            newTable[(unsigned long long) theEntry->id % newSize] = theEntry;
+           }
+        }
+
+      rm(theEnv,theReplay->table,sizeof(struct journalEntry *) * theReplay->tableSize);
+      theReplay->table = newTable;
+      theReplay->tableSize = newSize;
+      theLink = FindJournalEntry(theReplay,id);
+     }
+
+   theEntry = get_struct(theEnv,journalEntry);
+   theEntry->id = id;
+   theEntry->theFact = theFact;
+   theEntry->next = NULL;
+   *theLink = theEntry;
+   theReplay->count++;
+  }
+
+/**************************************************/
+/* DiscardJournalFact: Releases the values of a   */
+/*   fact which was not asserted and returns it.  */
+/**************************************************/
+static void DiscardJournalFact(
+  Environment *theEnv,
+  Fact *theFact)
+  {
+   size_t i;
+   CLIPSValue *theContents = theFact->theProposition.contents;
+
+   for (i = 0; i < theFact->theProposition.length; i++)
+     {
+      if (theContents[i].voidValue != VoidConstant(theEnv))
+        { Release(theEnv,theContents[i].header); }
+     }
+
+   ReturnFact(theEnv,theFact);
+  }
+
+/****************************************************************/
+/* AssertJournalFacts: Asserts the facts remaining at the end   */
+/*   of the journal in the order of their original fact index,  */
+/*   and returns the number of facts asserted.                  */
+/****************************************************************/
+static long AssertJournalFacts(
+  Environment *theEnv,
+  struct journalReplay *theReplay)
+  {
+   struct journalEntry **theEntries, *theEntry;
+   unsigned long i, count = 0, entryCount = theReplay->count;
+   CLIPSValue *theContents;
+   Fact *theFact;
+   size_t j;
+   long factCount = 0;
+
+   if (entryCount > 0)
+     {
+      theEntries = (struct journalEntry **) gm2(theEnv,sizeof(struct journalEntry *) * entryCount);
+      for (i = 0; i < theReplay->tableSize; i++)
+        {
+         for (theEntry = theReplay->table[i]; theEntry != NULL; theEntry = theEntry->next)
+           { theEntries[count++] = theEntry; }
+        }
+
+      qsort(theEntries,entryCount,sizeof(struct journalEntry *),CompareJournalEntries);
+
+      for (i = 0; i < entryCount; i++)
+        {
+         theFact = theEntries[i]->theFact;
+         theContents = theFact->theProposition.contents;
+         for (j = 0; j < theFact->theProposition.length; j++)
+           { Release(theEnv,theContents[j].header); }
+
+         theEntries[i]->theFact = NULL;
+         if (Assert(theFact) != NULL)
+           { factCount++; }
+
+         if (((i + 1) % FACT_JOURNAL_BATCH_SIZE) == 0)
+           { CleanCurrentGarbageFrame(theEnv,NULL); }
+        }
+
+      rm(theEnv,theEntries,sizeof(struct journalEntry *) * entryCount);
+     }
+
+   FreeJournalReplay(theEnv,theReplay);
+
+   return factCount;
+  }
+
+/****************************************************/
+/* FreeJournalReplay: Discards the facts which were */
+/*   not asserted and releases the hash table.      */
+/****************************************************/
+static void FreeJournalReplay(
+  Environment *theEnv,
+  struct journalReplay *theReplay)
+  {
+   struct journalEntry *theEntry, *nextEntry;
+   unsigned long i;
+
+   for (i = 0; i < theReplay->tableSize; i++)
+     {
+      for (theEntry = theReplay->table[i]; theEntry != NULL; theEntry = nextEntry)
+        {
+         nextEntry = theEntry->next;
+         if (theEntry->theFact != NULL)
+           { DiscardJournalFact(theEnv,theEntry->theFact); }
+         rtn_struct(theEnv,journalEntry,theEntry);
+        }
+     }
+
+   rm(theEnv,theReplay->table,sizeof(struct journalEntry *) * theReplay->tableSize);
+  }
+
+/****************************************************/
+/* CompareJournalEntries: Orders entries by their   */
+/*   original fact index for qsort.                 */
+/****************************************************/
+static int CompareJournalEntries(
+  const void *theFirst,
+  const void *theSecond)
+  {
+   long long firstID = (*(struct journalEntry * const *) theFirst)->id;
+   long long secondID = (*(struct journalEntry * const *) theSecond)->id;
+
+   if (firstID < secondID) return -1;
+   if (firstID > secondID) return 1;
+   return 0;
+  }
+
+/***************************************************/
+/* JournalFormatError: Prints the error for a fact */
+/*   whose deftemplate can not be used.            */
+/***************************************************/
+static void JournalFormatError(
+  Environment *theEnv,
+  const char *fileName,
+  const char *moduleName,
+  const char *templateName,
+  const char *problem)
+  {
+   PrintErrorID(theEnv,"FACTJRNL",1,false);
+   WriteString(theEnv,STDERR,"The fact journal '");
+   WriteString(theEnv,STDERR,fileName);
+   WriteString(theEnv,STDERR,"' contains facts of the deftemplate ");
+   WriteString(theEnv,STDERR,moduleName);
+   WriteString(theEnv,STDERR,"::");
+   WriteString(theEnv,STDERR,templateName);
+   WriteString(theEnv,STDERR," ");
+   WriteString(theEnv,STDERR,problem);
+   WriteString(theEnv,STDERR,".\n");
+  }
+
+#endif /* FACT_JOURNAL_FUNCTIONS */
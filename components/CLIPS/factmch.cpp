@@ -65,6 +65,8 @@
 #include "factrete.h"
 #include "incrrset.h"
 #include "memalloc.h"
+#include "pattern.h"
+#include "prdctfun.h"
 #include "prntutil.h"
 #include "reteutil.h"
 #include "router.h"
@@ -73,6 +75,15 @@
 
 #include "factmch.h"
 
+#if FACT_BATCH_FUNCTIONS
+#define BATCH_GREATER_THAN     0
+#define BATCH_LESS_THAN        1
+#define BATCH_GREATER_OR_EQUAL 2
+#define BATCH_LESS_OR_EQUAL    3
+#define BATCH_EQUAL            4
+#define BATCH_NOT_EQUAL        5
+#endif
+
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
@@ -81,12 +92,21 @@
    static void                     TraceErrorToJoin(Environment *,struct factPatternNode *,bool);
    static void                     ProcessFactAlphaMatch(Environment *,Fact *,struct multifieldMarker *,struct factPatternNode *);
    static struct factPatternNode  *GetNextFactPatternNode(Environment *,bool,struct factPatternNode *);
+   static struct factPatternNode  *NextFactPatternNode(bool,struct factPatternNode *);
    static bool                     SkipFactPatternNode(Environment *,struct factPatternNode *);
    static void                     ProcessMultifieldNode(Environment *,
                                                          struct factPatternNode *,
                                                          struct multifieldMarker *,
                                                          struct multifieldMarker *,size_t,size_t);
    static void                     PatternNetErrorMessage(Environment *,struct factPatternNode *);
+#if FACT_BATCH_FUNCTIONS
+   static bool                     AddFactAlphaMatch(struct factAlphaMatches *,struct factPatternNode *);
+   static bool                     BatchPatternTest(Environment *,Fact *,struct expr *,bool *);
+   static bool                     BatchPatternPrimitive(Fact *,struct expr *,bool *);
+   static bool                     BatchPatternValue(Environment *,Fact *,struct expr *,CLIPSValue *);
+   static bool                     BatchPatternFunction(Environment *,Fact *,struct expr *,CLIPSValue *);
+   static bool                     BatchNumericCompare(Environment *,Fact *,struct expr *,int,bool,CLIPSValue *);
+#endif
 
 /*************************************************************************/
 /* FactPatternMatch: Implements the core loop for fact pattern matching. */
@@ -481,6 +501,19 @@ static struct factPatternNode *GetNextFactPatternNode(
   {
    EvaluationData(theEnv)->EvaluationError = false;
 
+   return NextFactPatternNode(finishedMatching,thePattern);
+  }
+
+/*****************************************************/
+/* NextFactPatternNode: Computes the next node for   */
+/*   GetNextFactPatternNode without touching the     */
+/*   environment, so the traversal can also be made  */
+/*   by the threads matching a batch of facts.       */
+/*****************************************************/
+static struct factPatternNode *NextFactPatternNode(
+  bool finishedMatching,
+  struct factPatternNode *thePattern)
+  {
    /*===================================================*/
    /* If pattern matching was successful at the current */
    /* node in the tree and it's possible to go deeper   */
@@ -556,6 +589,17 @@ static void ProcessFactAlphaMatch(
    struct joinNode *listOfJoins;
    unsigned long hashValue;
 
+  /*=====================================================*/
+  /* When only some of the slots of a slot specific fact */
+  /* have been modified, the matches of patterns which   */
+  /* do not reference a changed slot were retained, so   */
+  /* the pattern doesn't need to be matched again.       */
+  /*=====================================================*/
+
+  if ((FactData(theEnv)->CurrentPatternChangeMap != NULL) &&
+      (! FactPatternNodeChanged(thePattern,FactData(theEnv)->CurrentPatternChangeMap)))
+    { return; }
+
   /*============================================*/
   /* Create the hash value for the alpha match. */
   /*============================================*/
@@ -589,6 +633,30 @@ static void ProcessFactAlphaMatch(
      { NetworkAssert(theEnv,theMatch,listOfJoins); }
   }
 
+/***************************************************************/
+/* FactPatternNodeChanged: Returns true if any of the slots in */
+/*   a change map are referenced by the patterns ending at the */
+/*   specified stop node. A node without a slot bitmap is      */
+/*   considered to be affected by every change.                */
+/***************************************************************/
+bool FactPatternNodeChanged(
+  struct factPatternNode *thePattern,
+  const char *changeMap)
+  {
+   unsigned short i;
+
+   if ((changeMap == NULL) || (thePattern->slotBitMap == NULL))
+     { return true; }
+
+   for (i = 0; i < thePattern->slotBitMap->size; i++)
+     {
+      if (thePattern->slotBitMap->contents[i] & changeMap[i])
+        { return true; }
+     }
+
+   return false;
+  }
+
 /*****************************************************************/
 /* EvaluatePatternExpression: Performs a faster evaluation for   */
 /*   fact pattern network expressions than if EvaluateExpression */
@@ -901,5 +969,540 @@ void FactsIncrementalReset(
      }
   }
 
+#if FACT_BATCH_FUNCTIONS
+
+/*******************************************************************/
+/* CollectFactAlphaMatches: Traverses the pattern network of a     */
+/*   fact which has not been asserted yet in the same order as     */
+/*   FactPatternMatch and records the stop nodes it reaches. The   */
+/*   environment is only read, so several threads can collect the  */
+/*   matches of different facts at the same time. Returns false    */
+/*   if the fact must be matched by FactPatternMatch instead:      */
+/*   patterns with multifield wildcards or variables, expressions  */
+/*   other than the comparisons and boolean functions evaluated    */
+/*   here, and values which would cause an evaluation error.       */
+/*******************************************************************/
+bool CollectFactAlphaMatches(
+  Environment *theEnv,
+  Fact *theFact,
+  struct factAlphaMatches *theMatches)
+  {
+   struct factPatternNode *patternPtr, *tempPtr;
+   CLIPSValue theResult;
+   bool satisfied;
+   size_t i;
+
+   theMatches->theFact = theFact;
+   theMatches->count = 0;
+
+   /*=======================================================*/
+   /* Void values are replaced with nil by the assert, so a */
+   /* fact containing them can't be matched in advance.     */
+   /*=======================================================*/
+
+   for (i = 0; i < theFact->theProposition.length; i++)
+     {
+      if (theFact->theProposition.contents[i].value == VoidConstant(theEnv))
+        { return false; }
+     }
+
+   patternPtr = theFact->whichDeftemplate->patternNetwork;
+
+   while (patternPtr != NULL)
+     {
+      if (patternPtr->header.multifieldNode)
+        { return false; }
+
+      if (patternPtr->header.selector)
+        {
+         if (! BatchPatternTest(theEnv,theFact,patternPtr->networkTest->nextArg,&satisfied))
+           { return false; }
+
+         tempPtr = NULL;
+         if (satisfied)
+           {
+            if (! BatchPatternValue(theEnv,theFact,patternPtr->networkTest,&theResult))
+              { return false; }
+
+            tempPtr = (struct factPatternNode *) FindHashedPatternNode(theEnv,patternPtr,theResult.header->type,theResult.value);
+           }
+
+         if (tempPtr != NULL)
+           {
+            if (tempPtr->header.stopNode && (! AddFactAlphaMatch(theMatches,tempPtr)))
+              { return false; }
+
+            patternPtr = NextFactPatternNode(false,tempPtr);
+           }
+         else
+           { patternPtr = NextFactPatternNode(true,patternPtr); }
+        }
+      else
+        {
+         if (! BatchPatternTest(theEnv,theFact,patternPtr->networkTest,&satisfied))
+           { return false; }
+
+         if (satisfied)
+           {
+            if (patternPtr->header.stopNode && (! AddFactAlphaMatch(theMatches,patternPtr)))
+              { return false; }
+
+            patternPtr = NextFactPatternNode(false,patternPtr);
+           }
+         else
+           { patternPtr = NextFactPatternNode(true,patternPtr); }
+        }
+     }
+
+   return true;
+  }
+
+/******************************************************************/
+/* ReplayFactAlphaMatches: Called by AssertDriver in place of     */
+/*   FactPatternMatch for a fact whose alpha matches have already */
+/*   been collected. The matches are processed in the order they  */
+/*   were found, so the alpha memories and the join network are   */
+/*   updated exactly as FactPatternMatch would have updated them. */
+/******************************************************************/
+void ReplayFactAlphaMatches(
+  Environment *theEnv,
+  Fact *theFact,
+  struct factAlphaMatches *theMatches)
+  {
+   size_t i;
+
+   FactData(theEnv)->CurrentPatternFact = theFact;
+   FactData(theEnv)->CurrentPatternMarks = NULL;
+
+   for (i = 0; i < theMatches->count; i++)
+     {
+      ProcessFactAlphaMatch(theEnv,theFact,NULL,theMatches->nodes[i]);
+      EvaluationData(theEnv)->EvaluationError = false;
+     }
+  }
+
+/*************************************************************/
+/* AddFactAlphaMatch: Appends a stop node to the matches of  */
+/*   a fact. The array is allocated with malloc since it is  */
+/*   grown by the matching threads and is kept for reuse.    */
+/*************************************************************/
+static bool AddFactAlphaMatch(
+  struct factAlphaMatches *theMatches,
+  struct factPatternNode *thePattern)
+  {
+   struct factPatternNode **newNodes;
+   size_t newMax;
+
+   if (theMatches->count == theMatches->max)
+     {
+      newMax = (theMatches->max == 0) ? 8 : (theMatches->max * 2);
+      newNodes = (struct factPatternNode **)
+                 realloc(theMatches->nodes,sizeof(struct factPatternNode *) * newMax);
+      if (newNodes == NULL)
+        { return false; }
+
+      theMatches->nodes = newNodes;
+      theMatches->max = newMax;
+     }
+
+   theMatches->nodes[theMatches->count++] = thePattern;
+
+   return true;
+  }
+
+/*****************************************************************/
+/* BatchPatternTest: Thread safe version of the evaluation made  */
+/*   by EvaluatePatternExpression. Returns false if the test can */
+/*   only be evaluated by EvaluatePatternExpression.             */
+/*****************************************************************/
+static bool BatchPatternTest(
+  Environment *theEnv,
+  Fact *theFact,
+  struct expr *theTest,
+  bool *satisfied)
+  {
+   CLIPSValue theResult;
+
+   if (theTest == NULL)
+     {
+      *satisfied = true;
+      return true;
+     }
+
+   switch(theTest->type)
+     {
+      case FACT_PN_CONSTANT1:
+      case FACT_PN_CONSTANT2:
+      case FACT_SLOT_LENGTH:
+        return BatchPatternPrimitive(theFact,theTest,satisfied);
+     }
+
+   if ((theTest->value == ExpressionData(theEnv)->PTR_OR) ||
+       (theTest->value == ExpressionData(theEnv)->PTR_AND))
+     {
+      bool isOr = (theTest->value == ExpressionData(theEnv)->PTR_OR);
+
+      for (theTest = theTest->argList;
+           theTest != NULL;
+           theTest = theTest->nextArg)
+        {
+         if (! BatchPatternTest(theEnv,theFact,theTest,satisfied))
+           { return false; }
+
+         if (*satisfied == isOr)
+           { return true; }
+        }
+
+      *satisfied = ! isOr;
+      return true;
+     }
+
+   if (! BatchPatternValue(theEnv,theFact,theTest,&theResult))
+     { return false; }
+
+   *satisfied = (theResult.value != FalseSymbol(theEnv));
+
+   return true;
+  }
+
+/******************************************************************/
+/* BatchPatternPrimitive: Evaluates the constant comparisons and  */
+/*   the slot length test of the fact pattern network for a fact  */
+/*   without using CurrentPatternFact (see FactPNConstant1,       */
+/*   FactPNConstant2, and FactSlotLength). There are no           */
+/*   multifield markers since multifield nodes are not matched    */
+/*   in batches.                                                  */
+/******************************************************************/
+static bool BatchPatternPrimitive(
+  Fact *theFact,
+  struct expr *theTest,
+  bool *satisfied)
+  {
+   const struct factConstantPN1Call *hack1;
+   const struct factConstantPN2Call *hack2;
+   const struct factCheckLengthPNCall *hack3;
+   CLIPSValue *fieldPtr;
+   Multifield *segmentPtr;
+
+   switch(theTest->type)
+     {
+      case FACT_PN_CONSTANT1:
+        hack1 = (const struct factConstantPN1Call *) theTest->bitMapValue->contents;
+        fieldPtr = &theFact->theProposition.contents[hack1->whichSlot];
+        *satisfied = ((theTest->argList->value == fieldPtr->value) == (bool) hack1->testForEquality);
+        return true;
+
+      case FACT_PN_CONSTANT2:
+        hack2 = (const struct factConstantPN2Call *) theTest->bitMapValue->contents;
+        fieldPtr = &theFact->theProposition.contents[hack2->whichSlot];
+        if (fieldPtr->header->type == MULTIFIELD_TYPE)
+          {
+           segmentPtr = fieldPtr->multifieldValue;
+           if (hack2->fromBeginning)
+             { fieldPtr = &segmentPtr->contents[hack2->offset]; }
+           else
+             { fieldPtr = &segmentPtr->contents[segmentPtr->length - (hack2->offset + 1)]; }
+          }
+        *satisfied = ((theTest->argList->value == fieldPtr->value) == (bool) hack2->testForEquality);
+        return true;
+
+      case FACT_SLOT_LENGTH:
+        hack3 = (const struct factCheckLengthPNCall *) theTest->bitMapValue->contents;
+        segmentPtr = theFact->theProposition.contents[hack3->whichSlot].multifieldValue;
+        if (segmentPtr->length < hack3->minLength)
+          { *satisfied = false; }
+        else if (hack3->exactly && (segmentPtr->length > hack3->minLength))
+          { *satisfied = false; }
+        else
+          { *satisfied = true; }
+        return true;
+     }
+
+   return false;
+  }
+
+/*******************************************************************/
+/* BatchPatternValue: Thread safe version of EvaluateExpression    */
+/*   for the expressions found in the fact pattern network: atoms, */
+/*   the variable retrieval and comparison primitives, and calls   */
+/*   to the functions handled by BatchPatternFunction. Multifield  */
+/*   values are not handled.                                       */
+/*******************************************************************/
+static bool BatchPatternValue(
+  Environment *theEnv,
+  Fact *theFact,
+  struct expr *theExpression,
+  CLIPSValue *returnValue)
+  {
+   const struct factGetVarPN1Call *hack1;
+   const struct factGetVarPN2Call *hack2;
+   const struct factGetVarPN3Call *hack3;
+   const struct factCompVarsPN1Call *hack4;
+   CLIPSValue *fieldPtr;
+   Multifield *segmentPtr;
+   bool satisfied;
+
+   switch (theExpression->type)
+     {
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+      case INTEGER_TYPE:
+      case FLOAT_TYPE:
+        returnValue->value = theExpression->value;
+        return true;
+
+      case FACT_PN_VAR1:
+        hack1 = (const struct factGetVarPN1Call *) theExpression->bitMapValue->contents;
+        if (hack1->factAddress)
+          {
+           returnValue->factValue = theFact;
+           return true;
+          }
+
+        fieldPtr = &theFact->theProposition.contents[hack1->whichSlot];
+        if (! hack1->allFields)
+          { fieldPtr = &fieldPtr->multifieldValue->contents[hack1->whichField]; }
+        break;
+
+      case FACT_PN_VAR2:
+        hack2 = (const struct factGetVarPN2Call *) theExpression->bitMapValue->contents;
+        fieldPtr = &theFact->theProposition.contents[hack2->whichSlot];
+        break;
+
+      case FACT_PN_VAR3:
+        hack3 = (const struct factGetVarPN3Call *) theExpression->bitMapValue->contents;
+        if (hack3->fromBeginning && hack3->fromEnd)
+          { return false; }
+
+        segmentPtr = theFact->theProposition.contents[hack3->whichSlot].multifieldValue;
+        if (hack3->fromBeginning)
+          { fieldPtr = &segmentPtr->contents[hack3->beginOffset]; }
+        else
+          { fieldPtr = &segmentPtr->contents[segmentPtr->length - (hack3->endOffset + 1)]; }
+        break;
+
+      case FACT_PN_CMP1:
+        hack4 = (const struct factCompVarsPN1Call *) theExpression->bitMapValue->contents;
+        if (theFact->theProposition.contents[hack4->field1].value !=
+            theFact->theProposition.contents[hack4->field2].value)
+          { satisfied = (bool) hack4->fail; }
+        else
+          { satisfied = (bool) hack4->pass; }
+        returnValue->lexemeValue = CreateBoolean(theEnv,satisfied);
+        return true;
+
+      case FACT_PN_CONSTANT1:
+      case FACT_PN_CONSTANT2:
+      case FACT_SLOT_LENGTH:
+        if (! BatchPatternPrimitive(theFact,theExpression,&satisfied))
+          { return false; }
+        returnValue->lexemeValue = CreateBoolean(theEnv,satisfied);
+        return true;
+
+      case FCALL:
+        return BatchPatternFunction(theEnv,theFact,theExpression,returnValue);
+
+      default:
+        return false;
+     }
+
+   if (fieldPtr->header->type == MULTIFIELD_TYPE)
+     { return false; }
+
+   returnValue->value = fieldPtr->value;
+
+   return true;
+  }
+
+/*****************************************************************/
+/* BatchPatternFunction: Evaluates a call to one of the system   */
+/*   predicates commonly used in pattern constraints (eq, neq,   */
+/*   the numeric comparisons, and, or, and not) with the same    */
+/*   semantics as the function, including the order in which the */
+/*   arguments are evaluated. Returns false for other functions  */
+/*   and for arguments which would cause an evaluation error.    */
+/*****************************************************************/
+static bool BatchPatternFunction(
+  Environment *theEnv,
+  Fact *theFact,
+  struct expr *theExpression,
+  CLIPSValue *returnValue)
+  {
+   void (*theFunction)(Environment *,UDFContext *,UDFValue *);
+   struct expr *theArgument;
+   CLIPSValue item, nextItem;
+   bool isEq;
+
+   theFunction = ExpressionFunctionPointer(theExpression);
+   theArgument = theExpression->argList;
+
+   if ((theFunction == EqFunction) || (theFunction == NeqFunction))
+     {
+      isEq = (theFunction == EqFunction);
+
+      if (theArgument == NULL)
+        {
+         returnValue->lexemeValue = FalseSymbol(theEnv);
+         return true;
+        }
+
+      if (! BatchPatternValue(theEnv,theFact,theArgument,&item))
+        { return false; }
+
+      for (theArgument = theArgument->nextArg;
+           theArgument != NULL;
+           theArgument = theArgument->nextArg)
+        {
+         if (! BatchPatternValue(theEnv,theFact,theArgument,&nextItem))
+           { return false; }
+
+         if (isEq &&
+             ((nextItem.header->type != item.header->type) ||
+              (nextItem.value != item.value)))
+           {
+            returnValue->lexemeValue = FalseSymbol(theEnv);
+            return true;
+           }
+
+         if ((! isEq) && (nextItem.value == item.value))
+           {
+            returnValue->lexemeValue = FalseSymbol(theEnv);
+            return true;
+           }
+        }
+
+      returnValue->lexemeValue = TrueSymbol(theEnv);
+      return true;
+     }
+
+   if (theFunction == NotFunction)
+     {
+      if ((theArgument == NULL) ||
+          (! BatchPatternValue(theEnv,theFact,theArgument,&item)))
+        { return false; }
+
+      returnValue->lexemeValue = CreateBoolean(theEnv,(item.value == FalseSymbol(theEnv)));
+      return true;
+     }
+
+   if ((theFunction == AndFunction) || (theFunction == OrFunction))
+     {
+      isEq = (theFunction == OrFunction);
+
+      for (;
+           theArgument != NULL;
+           theArgument = theArgument->nextArg)
+        {
+         if (! BatchPatternValue(theEnv,theFact,theArgument,&item))
+           { return false; }
+
+         if ((item.value != FalseSymbol(theEnv)) == isEq)
+           {
+            returnValue->lexemeValue = CreateBoolean(theEnv,isEq);
+            return true;
+           }
+        }
+
+      returnValue->lexemeValue = CreateBoolean(theEnv,! isEq);
+      return true;
+     }
+
+   if (theFunction == GreaterThanFunction)
+     { return BatchNumericCompare(theEnv,theFact,theArgument,BATCH_GREATER_THAN,false,returnValue); }
+   if (theFunction == LessThanFunction)
+     { return BatchNumericCompare(theEnv,theFact,theArgument,BATCH_LESS_THAN,false,returnValue); }
+   if (theFunction == GreaterThanOrEqualFunction)
+     { return BatchNumericCompare(theEnv,theFact,theArgument,BATCH_GREATER_OR_EQUAL,false,returnValue); }
+   if (theFunction == LessThanOrEqualFunction)
+     { return BatchNumericCompare(theEnv,theFact,theArgument,BATCH_LESS_OR_EQUAL,false,returnValue); }
+   if (theFunction == NumericEqualFunction)
+     { return BatchNumericCompare(theEnv,theFact,theArgument,BATCH_EQUAL,true,returnValue); }
+   if (theFunction == NumericNotEqualFunction)
+     { return BatchNumericCompare(theEnv,theFact,theArgument,BATCH_NOT_EQUAL,true,returnValue); }
+
+   return false;
+  }
+
+/*****************************************************************/
+/* BatchNumericCompare: Evaluates the numeric comparisons. Each  */
+/*   argument is compared to its predecessor, or to the first    */
+/*   argument for = and <>, and the comparison fails under the   */
+/*   same conditions as in the functions (so that the result is  */
+/*   the same for NaN values).                                   */
+/*****************************************************************/
+static bool BatchNumericCompare(
+  Environment *theEnv,
+  Fact *theFact,
+  struct expr *theArgument,
+  int relation,
+  bool toFirst,
+  CLIPSValue *returnValue)
+  {
+   CLIPSValue rv1, rv2;
+   long long i1, i2;
+   double d1, d2;
+   bool fails;
+
+   if ((theArgument == NULL) ||
+       (! BatchPatternValue(theEnv,theFact,theArgument,&rv1)) ||
+       ((rv1.header->type != INTEGER_TYPE) && (rv1.header->type != FLOAT_TYPE)))
+     { return false; }
+
+   for (theArgument = theArgument->nextArg;
+        theArgument != NULL;
+        theArgument = theArgument->nextArg)
+     {
+      if ((! BatchPatternValue(theEnv,theFact,theArgument,&rv2)) ||
+          ((rv2.header->type != INTEGER_TYPE) && (rv2.header->type != FLOAT_TYPE)))
+        { return false; }
+
+      if ((rv1.header->type == INTEGER_TYPE) && (rv2.header->type == INTEGER_TYPE))
+        {
+         i1 = rv1.integerValue->contents;
+         i2 = rv2.integerValue->contents;
+
+         switch (relation)
+           {
+            case BATCH_GREATER_THAN: fails = (i1 <= i2); break;
+            case BATCH_LESS_THAN: fails = (i1 >= i2); break;
+            case BATCH_GREATER_OR_EQUAL: fails = (i1 < i2); break;
+            case BATCH_LESS_OR_EQUAL: fails = (i1 > i2); break;
+            case BATCH_EQUAL: fails = (i1 != i2); break;
+            default: fails = (i1 == i2); break;
+           }
+        }
+      else
+        {
+         d1 = (rv1.header->type == INTEGER_TYPE) ? (double) rv1.integerValue->contents : rv1.floatValue->contents;
+         d2 = (rv2.header->type == INTEGER_TYPE) ? (double) rv2.integerValue->contents : rv2.floatValue->contents;
+
+         switch (relation)
+           {
+            case BATCH_GREATER_THAN: fails = (d1 <= d2); break;
+            case BATCH_LESS_THAN: fails = (d1 >= d2); break;
+            case BATCH_GREATER_OR_EQUAL: fails = (d1 < d2); break;
+            case BATCH_LESS_OR_EQUAL: fails = (d1 > d2); break;
+            case BATCH_EQUAL: fails = (d1 != d2); break;
+            default: fails = (d1 == d2); break;
+           }
+        }
+
+      if (fails)
+        {
+         returnValue->lexemeValue = FalseSymbol(theEnv);
+         return true;
+        }
+
+      if (! toFirst)
+        { rv1.value = rv2.value; }
+     }
+
+   returnValue->lexemeValue = TrueSymbol(theEnv);
+   return true;
+  }
+
+#endif /* FACT_BATCH_FUNCTIONS */
+
 #endif /* DEFTEMPLATE_CONSTRUCT && DEFRULE_CONSTRUCT */
 
@@ -140,6 +140,9 @@
 #include "commline.h"
 #include "default.h"
 #include "engine.h"
+#if EVENT_TRACE_FUNCTIONS
+#include "evtrace.h"
+#endif
 #include "factbin.h"
 #include "factcmp.h"
 #include "factcom.h"
@@ -173,6 +176,8 @@
    static bool                    ClearFactsReady(Environment *,void *);
    static void                    DeallocateFactData(Environment *);
    static bool                    RetractCallback(Fact *,Environment *);
+   static struct patternMatch    *RetractChangedFactMatches(Environment *,struct patternMatch *,const char *);
+   static void                    RetractRetainedFactMatches(Environment *,Fact *);
 
 /**************************************************************/
 /* InitializeFacts: Initializes the fact data representation. */
@@ -529,6 +534,7 @@ RetractError RetractDriver(
   {
    Deftemplate *theTemplate = theFact->whichDeftemplate;
    struct callFunctionItemWithArg *theRetractFunction;
+   bool retainMatches;
 
    FactData(theEnv)->retractError = RE_NO_ERROR;
 
@@ -599,6 +605,12 @@ RetractError RetractDriver(
      }
 #endif
 
+#if EVENT_TRACE_FUNCTIONS
+   if (EventTraceData(theEnv)->Tracing &&
+       (! ConstructData(theEnv)->ClearInProgress))
+     { RecordTraceEvent(theEnv,TRACE_RETRACT,theFact->factIndex,theFact->whichDeftemplate); }
+#endif
+
    /*==================================*/
    /* Set the change flag to indicate  */
    /* the fact-list has been modified. */
@@ -660,9 +672,22 @@ RetractError RetractDriver(
         { theFact->nextFact->previousFact = theFact->previousFact; }
      }
 
+   /*===============================================*/
+   /* Matches are retained by a modify of a slot    */
+   /* specific fact for the patterns which don't    */
+   /* reference one of the changed slots.           */
+   /*===============================================*/
+
+   retainMatches = modifyOperation && (changeMap != NULL) && theTemplate->slotSpecific;
+
    /*===================================================*/
    /* Add the fact to the fact garbage list unless this */
    /* fact is being retract as part of a modify action. */
+   /* If matches are being retained, the fact can't be  */
+   /* flagged as deleted until the changed matches have */
+   /* been retracted, otherwise partial matches which   */
+   /* are unblocked by the retraction would be treated  */
+   /* as being deleted as well.                         */
    /*===================================================*/
 
    if (! modifyOperation)
@@ -670,7 +695,8 @@ RetractError RetractDriver(
    else
      {
       theFact->nextFact = NULL;
-      theFact->garbage = true;
+      if (! retainMatches)
+        { theFact->garbage = true; }
      }
 
    /*===================================================*/
@@ -683,12 +709,25 @@ RetractError RetractDriver(
    /*===========================================*/
    /* Loop through the list of all the patterns */
    /* that matched the fact and process the     */
-   /* retract operation for each one.           */
+   /* retract operation for each one. If a slot */
+   /* specific fact is being modified, only the */
+   /* patterns referencing a changed slot are   */
+   /* retracted. The remaining matches are kept */
+   /* and the assert of the modified fact will  */
+   /* not match those patterns again.           */
    /*===========================================*/
 
    EngineData(theEnv)->JoinOperationInProgress = true;
-   NetworkRetract(theEnv,(struct patternMatch *) theFact->list);
-   theFact->list = NULL;
+   if (retainMatches)
+     {
+      theFact->list = RetractChangedFactMatches(theEnv,(struct patternMatch *) theFact->list,changeMap);
+      theFact->garbage = true;
+     }
+   else
+     {
+      NetworkRetract(theEnv,(struct patternMatch *) theFact->list);
+      theFact->list = NULL;
+     }
    EngineData(theEnv)->JoinOperationInProgress = false;
 
    /*=========================================*/
@@ -727,6 +766,73 @@ RetractError RetractDriver(
    return RE_NO_ERROR;
   }
 
+/*************************************************************/
+/* RetractChangedFactMatches: Retracts the pattern matches   */
+/*   of a fact for the patterns which reference a slot in    */
+/*   the change map. Returns the list of retained matches.   */
+/*************************************************************/
+static struct patternMatch *RetractChangedFactMatches(
+  Environment *theEnv,
+  struct patternMatch *listOfMatches,
+  const char *changeMap)
+  {
+   struct patternMatch *theMatch, *nextMatch;
+   struct patternMatch *retainedMatches = NULL, *lastRetained = NULL;
+   struct patternMatch *changedMatches = NULL, *lastChanged = NULL;
+
+   for (theMatch = listOfMatches;
+        theMatch != NULL;
+        theMatch = nextMatch)
+     {
+      nextMatch = theMatch->next;
+      theMatch->next = NULL;
+
+      if (FactPatternNodeChanged((struct factPatternNode *) theMatch->matchingPattern,changeMap))
+        {
+         if (lastChanged == NULL)
+           { changedMatches = theMatch; }
+         else
+           { lastChanged->next = theMatch; }
+         lastChanged = theMatch;
+        }
+      else
+        {
+         if (lastRetained == NULL)
+           { retainedMatches = theMatch; }
+         else
+           { lastRetained->next = theMatch; }
+         lastRetained = theMatch;
+        }
+     }
+
+   NetworkRetract(theEnv,changedMatches);
+
+   return retainedMatches;
+  }
+
+/**************************************************************/
+/* RetractRetainedFactMatches: Retracts the pattern matches   */
+/*   retained by a slot specific modify when the modified     */
+/*   fact could not be asserted (for example, because it      */
+/*   duplicates an existing fact).                            */
+/**************************************************************/
+static void RetractRetainedFactMatches(
+  Environment *theEnv,
+  Fact *theFact)
+  {
+   if (theFact->list == NULL) return;
+
+   EngineData(theEnv)->JoinOperationInProgress = true;
+   NetworkRetract(theEnv,(struct patternMatch *) theFact->list);
+   theFact->list = NULL;
+   EngineData(theEnv)->JoinOperationInProgress = false;
+
+   if (EngineData(theEnv)->ExecutingRule == NULL)
+     { FlushGarbagePartialMatches(theEnv); }
+
+   ForceLogicalRetractions(theEnv);
+  }
+
 /*******************/
 /* RetractCallback */
 /*******************/
@@ -881,7 +987,12 @@ Fact *AssertDriver(
    /*========================================================*/
 
    hashValue = HandleFactDuplication(theEnv,theFact,&duplicate,reuseIndex);
-   if (duplicate != NULL) return duplicate;
+   if (duplicate != NULL)
+     {
+      if (reuseIndex != 0)
+        { RetractRetainedFactMatches(theEnv,theFact); }
+      return duplicate;
+     }
 
    /*==========================================================*/
    /* If necessary, add logical dependency links between the   */
@@ -893,7 +1004,10 @@ Fact *AssertDriver(
       if (reuseIndex == 0)
         { ReturnFact(theEnv,theFact); }
       else
-        { AddToGarbageFactList(theEnv,theFact); }
+        {
+         RetractRetainedFactMatches(theEnv,theFact);
+         AddToGarbageFactList(theEnv,theFact);
+        }
         
       FactData(theEnv)->assertError = AE_COULD_NOT_ASSERT_ERROR;
       return NULL;
@@ -1011,6 +1125,12 @@ Fact *AssertDriver(
      }
 #endif
 
+#if EVENT_TRACE_FUNCTIONS
+   if (EventTraceData(theEnv)->Tracing &&
+       (! ConstructData(theEnv)->ClearInProgress))
+     { RecordTraceEvent(theEnv,TRACE_ASSERT,theFact->factIndex,theFact->whichDeftemplate); }
+#endif
+
    /*==================================*/
    /* Set the change flag to indicate  */
    /* the fact-list has been modified. */
@@ -1031,13 +1151,25 @@ Fact *AssertDriver(
 
    SetEvaluationError(theEnv,false);
 
-   /*=============================================*/
-   /* Pattern match the fact using the associated */
-   /* deftemplate's pattern network.              */
-   /*=============================================*/
+   /*==============================================*/
+   /* Pattern match the fact using the associated  */
+   /* deftemplate's pattern network (or replay the */
+   /* alpha matches found for it in a batch).      */
+   /*==============================================*/
 
    EngineData(theEnv)->JoinOperationInProgress = true;
+   if ((reuseIndex != 0) && (changeMap != NULL) && theFact->whichDeftemplate->slotSpecific)
+     { FactData(theEnv)->CurrentPatternChangeMap = changeMap; }
+#if FACT_BATCH_FUNCTIONS
+   if ((FactData(theEnv)->CurrentAlphaMatches != NULL) &&
+       (FactData(theEnv)->CurrentAlphaMatches->theFact == theFact))
+     { ReplayFactAlphaMatches(theEnv,theFact,FactData(theEnv)->CurrentAlphaMatches); }
+   else
+     { FactPatternMatch(theEnv,theFact,theFact->whichDeftemplate->patternNetwork,0,0,NULL,NULL); }
+#else
    FactPatternMatch(theEnv,theFact,theFact->whichDeftemplate->patternNetwork,0,0,NULL,NULL);
+#endif
+   FactData(theEnv)->CurrentPatternChangeMap = NULL;
    EngineData(theEnv)->JoinOperationInProgress = false;
 
    /*===================================================*/
@@ -1064,6 +1196,49 @@ Fact *AssertDriver(
    return theFact;
   }
 
+/*****************************************************************/
+/* InstallRestoredFact: Adds a fact restored from a working      */
+/*   memory snapshot to the fact hash table, the fact list and   */
+/*   the fact list of its deftemplate. The fact index and time   */
+/*   tag have already been set by the caller. The fact isn't     */
+/*   pattern matched since the partial matches of the rule       */
+/*   network are restored along with the fact.                   */
+/*****************************************************************/
+void InstallRestoredFact(
+  Environment *theEnv,
+  Fact *theFact)
+  {
+   size_t i;
+
+   AddHashedFact(theEnv,theFact,HashFact(theFact));
+
+   theFact->nextFact = NULL;
+   theFact->previousFact = FactData(theEnv)->LastFact;
+   if (FactData(theEnv)->LastFact == NULL)
+     { FactData(theEnv)->FactList = theFact; }
+   else
+     { FactData(theEnv)->LastFact->nextFact = theFact; }
+   FactData(theEnv)->LastFact = theFact;
+
+   theFact->nextTemplateFact = NULL;
+   theFact->previousTemplateFact = theFact->whichDeftemplate->lastFact;
+   if (theFact->whichDeftemplate->lastFact == NULL)
+     { theFact->whichDeftemplate->factList = theFact; }
+   else
+     { theFact->whichDeftemplate->lastFact->nextTemplateFact = theFact; }
+   theFact->whichDeftemplate->lastFact = theFact;
+
+   FactInstall(theEnv,theFact);
+
+   for (i = 0 ; i < theFact->theProposition.length ; i++)
+     {
+      AtomInstall(theEnv,theFact->theProposition.contents[i].header->type,
+                  theFact->theProposition.contents[i].value);
+     }
+
+   FactData(theEnv)->ChangeToFactList = true;
+  }
+
 /*****************************************************/
 /* Assert: C access routine for the assert function. */
 /*****************************************************/
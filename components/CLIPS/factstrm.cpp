@@ -0,0 +1,1229 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                 FACT STREAM MODULE                  */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Reads and writes the text format used by the     */
+/*   load-facts and save-facts commands through fixed size   */
+/*   buffers.                                                */
+/*                                                           */
+/*   The loader reads the file in blocks, tokenizes each     */
+/*   fact with the same rules used by the scanner, and       */
+/*   builds the fact directly from the constants it reads:   */
+/*   no expressions are parsed and no assert function call   */
+/*   is evaluated. The checks made by the assert parser for  */
+/*   constant facts (slot names, duplicate slots, slot       */
+/*   cardinality, and constraints) are made with the same    */
+/*   error messages. The writer formats each fact directly   */
+/*   into its buffer instead of creating symbols for the     */
+/*   printed forms of strings and floats. The memory used    */
+/*   is bounded by the size of the largest fact rather than  */
+/*   by the size of the file.                                */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if DEFTEMPLATE_CONSTRUCT
+
+#if BLOAD || BLOAD_AND_BSAVE || BLOAD_ONLY
+#include "bload.h"
+#endif
+#include "constant.h"
+#include "cstrcpsr.h"
+#include "cstrnchk.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#if FACT_BATCH_FUNCTIONS
+#include "factbtch.h"
+#endif
+#include "factmngr.h"
+#include "memalloc.h"
+#include "modulpsr.h"
+#include "modulutl.h"
+#include "multifld.h"
+#include "pattern.h"
+#include "prntutil.h"
+#include "router.h"
+#include "scanner.h"
+#include "sysdep.h"
+#include "tmpltdef.h"
+#include "tmpltutl.h"
+#include "utility.h"
+
+#include "factstrm.h"
+
+#define NO_PUSHBACK -2
+
+/***************************************************************/
+/* factStreamReader: The state of a load. The block buffer and */
+/*   the token and value buffers are reused for every fact.    */
+/***************************************************************/
+struct factStreamReader
+  {
+   FILE *filePtr;
+   const char *theString;
+   size_t stringPosition;
+   size_t stringMax;
+   size_t bufferPosition;
+   size_t bufferLength;
+   int pushback;
+   char *text;
+   size_t textPosition;
+   size_t textMax;
+   CLIPSValue *values;
+   size_t valueCount;
+   size_t valueMax;
+#if FACT_BATCH_FUNCTIONS
+   Fact *batch[FACT_BATCH_SIZE];
+   size_t batchCount;
+#endif
+   char buffer[FACT_STREAM_BUFFER_SIZE];
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static int                     StreamReadChar(struct factStreamReader *);
+   static void                    StreamUnreadChar(struct factStreamReader *,int);
+   static void                    StreamGetToken(Environment *,struct factStreamReader *,struct token *);
+   static void                    StreamScanAtom(Environment *,struct factStreamReader *,int,struct token *);
+   static bool                    StreamScanNumber(Environment *,struct factStreamReader *,struct token *);
+   static void                    StreamScanString(Environment *,struct factStreamReader *,struct token *);
+   static bool                    StreamConstantToken(struct token *);
+   static void                    StreamAddValue(Environment *,struct factStreamReader *,struct token *);
+   static int                     StreamLoadFact(Environment *,struct factStreamReader *);
+   static Fact                   *StreamLoadTemplateFact(Environment *,struct factStreamReader *,Deftemplate *);
+   static bool                    StreamLoadSlot(Environment *,struct factStreamReader *,Fact *,
+                                                 struct templateSlot *,unsigned short);
+   static Deftemplate            *StreamFindDeftemplate(Environment *,CLIPSLexeme *);
+   static Multifield             *StreamValuesToMultifield(Environment *,struct factStreamReader *);
+#if FACT_BATCH_FUNCTIONS
+   static void                    StreamAssertBatch(Environment *,struct factStreamReader *);
+#endif
+#if BLOAD || BLOAD_AND_BSAVE || BLOAD_ONLY || RUN_TIME
+   static void                    StreamNoSuchTemplateError(Environment *,const char *);
+#endif
+   static void                    StreamWriteString(FactStreamWriter *,const char *);
+   static void                    StreamWriteChar(FactStreamWriter *,char);
+   static void                    StreamWriteAtom(FactStreamWriter *,unsigned short,void *);
+   static void                    StreamWriteMultifield(FactStreamWriter *,Multifield *);
+
+/*******************************************************/
+/* StreamLoadFacts: Loads facts from a file (if        */
+/*   filePtr is not NULL) or from at most theMax       */
+/*   characters of a string and returns the number of  */
+/*   facts read. Loading stops at the first token that */
+/*   does not begin a fact or at the first error.      */
+/*******************************************************/
+long StreamLoadFacts(
+  Environment *theEnv,
+  FILE *filePtr,
+  const char *theString,
+  size_t theMax)
+  {
+   struct factStreamReader *theReader;
+   GCBlock gcb;
+   long factCount = 0;
+   int rv;
+#if FACT_BATCH_FUNCTIONS
+   bool halted, failed;
+#endif
+
+   theReader = (struct factStreamReader *) gm2(theEnv,sizeof(struct factStreamReader));
+   theReader->filePtr = filePtr;
+   theReader->theString = theString;
+   theReader->stringPosition = 0;
+   theReader->stringMax = theMax;
+   theReader->bufferPosition = 0;
+   theReader->bufferLength = 0;
+   theReader->pushback = NO_PUSHBACK;
+   theReader->text = NULL;
+   theReader->textPosition = 0;
+   theReader->textMax = 0;
+   theReader->values = NULL;
+   theReader->valueCount = 0;
+   theReader->valueMax = 0;
+#if FACT_BATCH_FUNCTIONS
+   theReader->batchCount = 0;
+#endif
+
+   /*==========================================================*/
+   /* Values read for a fact are garbage until the fact is     */
+   /* asserted, so the frame is cleaned after each fact rather */
+   /* than once at the end of the load. When facts are         */
+   /* asserted in batches, it's cleaned after each batch.      */
+   /*==========================================================*/
+
+   GCBlockStart(theEnv,&gcb);
+
+   while ((rv = StreamLoadFact(theEnv,theReader)) > 0)
+     {
+      factCount++;
+#if FACT_BATCH_FUNCTIONS
+      if (theReader->batchCount < FACT_BATCH_SIZE) continue;
+      StreamAssertBatch(theEnv,theReader);
+#endif
+      CleanCurrentGarbageFrame(theEnv,NULL);
+      if (EvaluationData(theEnv)->HaltExecution) break;
+     }
+
+#if FACT_BATCH_FUNCTIONS
+   /*========================================================*/
+   /* An error reading a fact halts execution, but the facts */
+   /* read before it were asserted one at a time by the      */
+   /* serial loader, so the pending batch is asserted as if  */
+   /* the error had not happened yet.                        */
+   /*========================================================*/
+
+   if (rv < 0)
+     {
+      halted = EvaluationData(theEnv)->HaltExecution;
+      failed = EvaluationData(theEnv)->EvaluationError;
+      EvaluationData(theEnv)->HaltExecution = false;
+      StreamAssertBatch(theEnv,theReader);
+      if (halted) EvaluationData(theEnv)->HaltExecution = true;
+      if (failed) EvaluationData(theEnv)->EvaluationError = true;
+     }
+   else
+     { StreamAssertBatch(theEnv,theReader); }
+#endif
+
+   if (rv < 0)
+     {
+      WriteString(theEnv,STDERR,"Function load-facts encountered an error\n");
+      SetEvaluationError(theEnv,true);
+     }
+
+   GCBlockEnd(theEnv,&gcb);
+
+   /*=====================*/
+   /* Release the reader. */
+   /*=====================*/
+
+   if (theReader->text != NULL)
+     { rm(theEnv,theReader->text,theReader->textMax); }
+
+   if (theReader->values != NULL)
+     { rm(theEnv,theReader->values,sizeof(CLIPSValue) * theReader->valueMax); }
+
+   rm(theEnv,theReader,sizeof(struct factStreamReader));
+
+   return factCount;
+  }
+
+/****************************************************/
+/* StreamLoadFact: Reads and asserts a single fact. */
+/*   Returns 1 if a fact was read, 0 if the input   */
+/*   does not continue with a fact, and -1 if an    */
+/*   error occurred.                                */
+/****************************************************/
+static int StreamLoadFact(
+  Environment *theEnv,
+  struct factStreamReader *theReader)
+  {
+   struct token theToken;
+   Deftemplate *theDeftemplate;
+   Fact *newFact;
+
+   StreamGetToken(theEnv,theReader,&theToken);
+   if (theToken.tknType != LEFT_PARENTHESIS_TOKEN) return 0;
+
+   /*======================================================*/
+   /* The first field of an asserted fact must be a symbol */
+   /* (but not = or : which have special significance).    */
+   /*======================================================*/
+
+   StreamGetToken(theEnv,theReader,&theToken);
+   if ((theToken.tknType != SYMBOL_TOKEN) ||
+       (strcmp(theToken.lexemeValue->contents,"=") == 0) ||
+       (strcmp(theToken.lexemeValue->contents,":") == 0))
+     {
+      SyntaxErrorMessage(theEnv,"first field of a RHS pattern");
+      return -1;
+     }
+
+   theDeftemplate = StreamFindDeftemplate(theEnv,theToken.lexemeValue);
+   if (theDeftemplate == NULL) return -1;
+
+   /*===================================*/
+   /* Read the slots of a template fact */
+   /* or the values of an ordered fact. */
+   /*===================================*/
+
+   if (theDeftemplate->implied == false)
+     {
+      newFact = StreamLoadTemplateFact(theEnv,theReader,theDeftemplate);
+      if (newFact == NULL) return -1;
+     }
+   else
+     {
+      theReader->valueCount = 0;
+      StreamGetToken(theEnv,theReader,&theToken);
+      while (theToken.tknType != RIGHT_PARENTHESIS_TOKEN)
+        {
+         if (! StreamConstantToken(&theToken))
+           {
+            SyntaxErrorMessage(theEnv,"RHS patterns");
+            return -1;
+           }
+
+         StreamAddValue(theEnv,theReader,&theToken);
+         StreamGetToken(theEnv,theReader,&theToken);
+        }
+
+      newFact = CreateFactBySize(theEnv,1);
+      newFact->whichDeftemplate = theDeftemplate;
+      newFact->theProposition.contents[0].multifieldValue = StreamValuesToMultifield(theEnv,theReader);
+     }
+
+   /*================================*/
+   /* Add the fact to the fact-list. */
+   /*================================*/
+
+#if FACT_BATCH_FUNCTIONS
+   theReader->batch[theReader->batchCount++] = newFact;
+#else
+   Assert(newFact);
+#endif
+
+   return 1;
+  }
+
+#if FACT_BATCH_FUNCTIONS
+
+/*************************************************************/
+/* StreamAssertBatch: Asserts the facts read since the last  */
+/*   batch was asserted.                                     */
+/*************************************************************/
+static void StreamAssertBatch(
+  Environment *theEnv,
+  struct factStreamReader *theReader)
+  {
+   if (theReader->batchCount == 0) return;
+
+   AssertFactBatch(theEnv,theReader->batch,theReader->batchCount);
+   theReader->batchCount = 0;
+  }
+
+#endif
+
+/************************************************************/
+/* StreamFindDeftemplate: Finds the deftemplate for a fact, */
+/*   creating an implied deftemplate if none exists, with   */
+/*   the checks made by GetRHSPattern.                      */
+/************************************************************/
+static Deftemplate *StreamFindDeftemplate(
+  Environment *theEnv,
+  CLIPSLexeme *templateName)
+  {
+   Deftemplate *theDeftemplate;
+   unsigned int count;
+
+   if (ReservedPatternSymbol(theEnv,templateName->contents,NULL))
+     {
+      ReservedPatternSymbolErrorMsg(theEnv,templateName->contents,"a relation name");
+      return NULL;
+     }
+
+   if (FindModuleSeparator(templateName->contents))
+     {
+      IllegalModuleSpecifierMessage(theEnv);
+      return NULL;
+     }
+
+   theDeftemplate = (Deftemplate *)
+                    FindImportedConstruct(theEnv,"deftemplate",NULL,templateName->contents,
+                                          &count,true,NULL);
+
+   if (count > 1)
+     {
+      AmbiguousReferenceErrorMessage(theEnv,"deftemplate",templateName->contents);
+      return NULL;
+     }
+
+   if (theDeftemplate != NULL) return theDeftemplate;
+
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+#if BLOAD || BLOAD_AND_BSAVE
+   if (Bloaded(theEnv))
+     {
+      StreamNoSuchTemplateError(theEnv,templateName->contents);
+      return NULL;
+     }
+#endif
+#if DEFMODULE_CONSTRUCT
+   if (FindImportExportConflict(theEnv,"deftemplate",GetCurrentModule(theEnv),templateName->contents))
+     {
+      ImportExportConflictMessage(theEnv,"implied deftemplate",templateName->contents,NULL,NULL);
+      return NULL;
+     }
+#endif
+   return CreateImpliedDeftemplate(theEnv,templateName,true);
+#else
+   StreamNoSuchTemplateError(theEnv,templateName->contents);
+   return NULL;
+#endif
+  }
+
+/**************************************************************/
+/* StreamLoadTemplateFact: Reads the slots of a template fact */
+/*   and returns the fact with its default values assigned,   */
+/*   or NULL if an error occurred.                            */
+/**************************************************************/
+static Fact *StreamLoadTemplateFact(
+  Environment *theEnv,
+  struct factStreamReader *theReader,
+  Deftemplate *theDeftemplate)
+  {
+   struct token theToken;
+   struct templateSlot *slotPtr;
+   unsigned short position;
+   Fact *newFact;
+#if FACT_BATCH_FUNCTIONS
+   bool dynamicDefaults = false;
+#endif
+
+   newFact = CreateFact(theDeftemplate);
+
+   /*==============================================*/
+   /* Read each of the slots. A slot begins with a */
+   /* left parenthesis followed by the slot name.  */
+   /*==============================================*/
+
+   StreamGetToken(theEnv,theReader,&theToken);
+   while (theToken.tknType != RIGHT_PARENTHESIS_TOKEN)
+     {
+      if (theToken.tknType != LEFT_PARENTHESIS_TOKEN)
+        {
+         SyntaxErrorMessage(theEnv,"deftemplate pattern");
+         ReturnFact(theEnv,newFact);
+         return NULL;
+        }
+
+      StreamGetToken(theEnv,theReader,&theToken);
+      if (theToken.tknType != SYMBOL_TOKEN)
+        {
+         SyntaxErrorMessage(theEnv,"deftemplate pattern");
+         ReturnFact(theEnv,newFact);
+         return NULL;
+        }
+
+      if ((slotPtr = FindSlot(theDeftemplate,theToken.lexemeValue,&position)) == NULL)
+        {
+         InvalidDeftemplateSlotMessage(theEnv,theToken.lexemeValue->contents,
+                                       theDeftemplate->header.name->contents,true);
+         ReturnFact(theEnv,newFact);
+         return NULL;
+        }
+
+      if (newFact->theProposition.contents[position].value != VoidConstant(theEnv))
+        {
+         AlreadyParsedErrorMessage(theEnv,"slot ",slotPtr->slotName->contents);
+         ReturnFact(theEnv,newFact);
+         return NULL;
+        }
+
+      if (! StreamLoadSlot(theEnv,theReader,newFact,slotPtr,position))
+        {
+         ReturnFact(theEnv,newFact);
+         return NULL;
+        }
+
+      StreamGetToken(theEnv,theReader,&theToken);
+     }
+
+   /*=================================================*/
+   /* A slot with the (default ?NONE) attribute must  */
+   /* be given a value. The other slots which weren't */
+   /* given a value get their default values.         */
+   /*=================================================*/
+
+   for (slotPtr = theDeftemplate->slotList, position = 0;
+        slotPtr != NULL;
+        slotPtr = slotPtr->next, position++)
+     {
+#if FACT_BATCH_FUNCTIONS
+      if (slotPtr->defaultDynamic &&
+          (newFact->theProposition.contents[position].value == VoidConstant(theEnv)))
+        { dynamicDefaults = true; }
+#endif
+
+      if (slotPtr->noDefault &&
+          (newFact->theProposition.contents[position].value == VoidConstant(theEnv)))
+        {
+         PrintErrorID(theEnv,"TMPLTRHS",1,true);
+         WriteString(theEnv,STDERR,"Slot '");
+         WriteString(theEnv,STDERR,slotPtr->slotName->contents);
+         WriteString(theEnv,STDERR,"' requires a value because of its (default ?NONE) attribute.\n");
+         ReturnFact(theEnv,newFact);
+         return NULL;
+        }
+     }
+
+#if FACT_BATCH_FUNCTIONS
+   /*=====================================================*/
+   /* Dynamic defaults may depend on the fact-list, so    */
+   /* they're evaluated once the facts read before this   */
+   /* one have been asserted.                             */
+   /*=====================================================*/
+
+   if (dynamicDefaults)
+     { StreamAssertBatch(theEnv,theReader); }
+#endif
+
+   AssignFactSlotDefaults(newFact);
+
+   return newFact;
+  }
+
+/************************************************************/
+/* StreamLoadSlot: Reads the values of a slot, checks them  */
+/*   against the constraints of the slot, and stores them   */
+/*   in the fact. The slot name has already been read.      */
+/************************************************************/
+static bool StreamLoadSlot(
+  Environment *theEnv,
+  struct factStreamReader *theReader,
+  Fact *theFact,
+  struct templateSlot *slotPtr,
+  unsigned short position)
+  {
+   struct token theToken;
+   ConstraintViolationType vCode = NO_VIOLATION;
+   size_t i;
+
+   theReader->valueCount = 0;
+
+   /*=====================================================*/
+   /* A single field slot must contain exactly one value. */
+   /*=====================================================*/
+
+   if (slotPtr->multislot == false)
+     {
+      StreamGetToken(theEnv,theReader,&theToken);
+      if (theToken.tknType == RIGHT_PARENTHESIS_TOKEN)
+        {
+         SingleFieldSlotCardinalityError(theEnv,slotPtr->slotName->contents);
+         return false;
+        }
+
+      if (! StreamConstantToken(&theToken))
+        {
+         SyntaxErrorMessage(theEnv,"deftemplate pattern");
+         return false;
+        }
+
+      StreamAddValue(theEnv,theReader,&theToken);
+
+      StreamGetToken(theEnv,theReader,&theToken);
+      if (theToken.tknType != RIGHT_PARENTHESIS_TOKEN)
+        {
+         SingleFieldSlotCardinalityError(theEnv,slotPtr->slotName->contents);
+         return false;
+        }
+     }
+
+   /*=======================================*/
+   /* A multifield slot contains any number */
+   /* of values (including none).           */
+   /*=======================================*/
+
+   else
+     {
+      StreamGetToken(theEnv,theReader,&theToken);
+      while (theToken.tknType != RIGHT_PARENTHESIS_TOKEN)
+        {
+         if (! StreamConstantToken(&theToken))
+           {
+            SyntaxErrorMessage(theEnv,"deftemplate pattern");
+            return false;
+           }
+
+         StreamAddValue(theEnv,theReader,&theToken);
+         StreamGetToken(theEnv,theReader,&theToken);
+        }
+     }
+
+   /*============================================*/
+   /* Check to see if the values to be stored in */
+   /* the slot violate the slot's constraints.   */
+   /*============================================*/
+
+   if (! CheckCardinalityConstraint(theEnv,theReader->valueCount,slotPtr->constraints))
+     { vCode = CARDINALITY_VIOLATION; }
+
+   for (i = 0; (i < theReader->valueCount) && (vCode == NO_VIOLATION); i++)
+     {
+      vCode = ConstraintCheckValue(theEnv,theReader->values[i].header->type,
+                                   theReader->values[i].value,slotPtr->constraints);
+     }
+
+   if (vCode != NO_VIOLATION)
+     {
+      ConstraintViolationErrorMessage(theEnv,
+                                      (vCode == CARDINALITY_VIOLATION) ? "Literal slot values" :
+                                                                         "A literal slot value",
+                                      "assert",true,0,slotPtr->slotName,0,vCode,
+                                      slotPtr->constraints,true);
+      return false;
+     }
+
+   /*===============================*/
+   /* Store the values in the fact. */
+   /*===============================*/
+
+   if (slotPtr->multislot == false)
+     { theFact->theProposition.contents[position].value = theReader->values[0].value; }
+   else
+     { theFact->theProposition.contents[position].multifieldValue = StreamValuesToMultifield(theEnv,theReader); }
+
+   return true;
+  }
+
+/*****************************************************/
+/* StreamConstantToken: Returns true if the token is */
+/*   a constant which can be stored in a fact.       */
+/*****************************************************/
+static bool StreamConstantToken(
+  struct token *theToken)
+  {
+   switch (theToken->tknType)
+     {
+      case SYMBOL_TOKEN:
+        return (strcmp(theToken->lexemeValue->contents,"=") != 0);
+
+      case STRING_TOKEN:
+      case FLOAT_TOKEN:
+      case INTEGER_TOKEN:
+#if OBJECT_SYSTEM
+      case INSTANCE_NAME_TOKEN:
+#endif
+        return true;
+
+      default:
+        return false;
+     }
+  }
+
+/*******************************************************/
+/* StreamAddValue: Adds the value of a token to the    */
+/*   values read for the current slot or ordered fact. */
+/*******************************************************/
+static void StreamAddValue(
+  Environment *theEnv,
+  struct factStreamReader *theReader,
+  struct token *theToken)
+  {
+   CLIPSValue *newValues;
+   size_t newMax;
+
+   if (theReader->valueCount == theReader->valueMax)
+     {
+      newMax = (theReader->valueMax == 0) ? 8 : (theReader->valueMax * 2);
+      newValues = (CLIPSValue *) gm2(theEnv,sizeof(CLIPSValue) * newMax);
+
+      if (theReader->values != NULL)
+        {
+         memcpy(newValues,theReader->values,sizeof(CLIPSValue) * theReader->valueCount);
+         rm(theEnv,theReader->values,sizeof(CLIPSValue) * theReader->valueMax);
+        }
+
+      theReader->values = newValues;
+      theReader->valueMax = newMax;
+     }
+
+   theReader->values[theReader->valueCount].value = theToken->value;
+   theReader->valueCount++;
+  }
+
+/******************************************************/
+/* StreamValuesToMultifield: Copies the values read   */
+/*   into an unmanaged multifield to be stored in the */
+/*   fact.                                            */
+/******************************************************/
+static Multifield *StreamValuesToMultifield(
+  Environment *theEnv,
+  struct factStreamReader *theReader)
+  {
+   Multifield *theMultifield;
+   size_t i;
+
+   theMultifield = CreateUnmanagedMultifield(theEnv,theReader->valueCount);
+   for (i = 0; i < theReader->valueCount; i++)
+     { theMultifield->contents[i].value = theReader->values[i].value; }
+
+   return theMultifield;
+  }
+
+/*******************************************************/
+/* StreamReadChar: Returns the next character from the */
+/*   file block buffer or the string, or EOF.          */
+/*******************************************************/
+static int StreamReadChar(
+  struct factStreamReader *theReader)
+  {
+   int inchar;
+
+   if (theReader->pushback != NO_PUSHBACK)
+     {
+      inchar = theReader->pushback;
+      theReader->pushback = NO_PUSHBACK;
+      return inchar;
+     }
+
+   if (theReader->filePtr == NULL)
+     {
+      if ((theReader->stringPosition >= theReader->stringMax) ||
+          (theReader->theString[theReader->stringPosition] == EOS))
+        { return EOF; }
+
+      return (unsigned char) theReader->theString[theReader->stringPosition++];
+     }
+
+   if (theReader->bufferPosition == theReader->bufferLength)
+     {
+      theReader->bufferLength = fread(theReader->buffer,1,FACT_STREAM_BUFFER_SIZE,theReader->filePtr);
+      theReader->bufferPosition = 0;
+      if (theReader->bufferLength == 0) return EOF;
+     }
+
+   return (unsigned char) theReader->buffer[theReader->bufferPosition++];
+  }
+
+/******************************************************/
+/* StreamUnreadChar: Returns the last character read. */
+/******************************************************/
+static void StreamUnreadChar(
+  struct factStreamReader *theReader,
+  int inchar)
+  {
+   theReader->pushback = inchar;
+  }
+
+/*********************************************************/
+/* StreamGetToken: Reads the next token. The tokens are  */
+/*   those returned by GetToken, except that variables   */
+/*   and constraint characters (which can't appear in a  */
+/*   fact file) are all returned as unknown tokens.      */
+/*********************************************************/
+static void StreamGetToken(
+  Environment *theEnv,
+  struct factStreamReader *theReader,
+  struct token *theToken)
+  {
+   int inchar;
+
+   theToken->tknType = UNKNOWN_VALUE_TOKEN;
+   theToken->value = NULL;
+   theToken->printForm = "unknown";
+
+   /*========================================*/
+   /* Skip white space and comment lines.    */
+   /*========================================*/
+
+   inchar = StreamReadChar(theReader);
+   while ((inchar == ' ') || (inchar == '\n') || (inchar == '\f') ||
+          (inchar == '\r') || (inchar == ';') || (inchar == '\t'))
+     {
+      if (inchar == ';')
+        {
+         inchar = StreamReadChar(theReader);
+         while ((inchar != '\n') && (inchar != '\r') && (inchar != EOF))
+           { inchar = StreamReadChar(theReader); }
+        }
+      inchar = StreamReadChar(theReader);
+     }
+
+   switch (inchar)
+     {
+      case EOF:
+      case 0:
+      case 3:
+        theToken->tknType = STOP_TOKEN;
+        break;
+
+      case '(':
+        theToken->tknType = LEFT_PARENTHESIS_TOKEN;
+        break;
+
+      case ')':
+        theToken->tknType = RIGHT_PARENTHESIS_TOKEN;
+        break;
+
+      case '"':
+        StreamScanString(theEnv,theReader,theToken);
+        break;
+
+      case '?':
+      case '~':
+      case '|':
+      case '&':
+        break;
+
+      case '$':
+        inchar = StreamReadChar(theReader);
+        if (inchar == '?') break;
+        StreamUnreadChar(theReader,inchar);
+        StreamScanAtom(theEnv,theReader,'$',theToken);
+        break;
+
+      default:
+        if (isprint(inchar) || IsUTF8MultiByteStart(inchar))
+          { StreamScanAtom(theEnv,theReader,inchar,theToken); }
+        break;
+     }
+  }
+
+/***********************************************************/
+/* StreamScanAtom: Reads a symbol, number, or instance     */
+/*   name beginning with the given character. The atom     */
+/*   ends at the delimiters used by the scanner's symbols. */
+/***********************************************************/
+static void StreamScanAtom(
+  Environment *theEnv,
+  struct factStreamReader *theReader,
+  int inchar,
+  struct token *theToken)
+  {
+   theReader->textPosition = 0;
+
+   do
+     {
+      theReader->text = ExpandStringWithChar(theEnv,inchar,theReader->text,&theReader->textPosition,
+                                             &theReader->textMax,theReader->textMax+80);
+      inchar = StreamReadChar(theReader);
+     }
+   while ((inchar != '<') && (inchar != '"') &&
+          (inchar != '(') && (inchar != ')') &&
+          (inchar != '&') && (inchar != '|') && (inchar != '~') &&
+          (inchar != ' ') && (inchar != ';') &&
+          (IsUTF8MultiByteStart(inchar) ||
+           IsUTF8MultiByteContinuation(inchar) ||
+           isprint(inchar)));
+
+   StreamUnreadChar(theReader,inchar);
+
+   /*=================================================*/
+   /* Atoms beginning with a digit, sign, or decimal  */
+   /* point are numbers if they have a number's form. */
+   /*=================================================*/
+
+   inchar = theReader->text[0];
+   if ((isdigit(inchar) || (inchar == '+') || (inchar == '-') || (inchar == '.')) &&
+       StreamScanNumber(theEnv,theReader,theToken))
+     { return; }
+
+#if OBJECT_SYSTEM
+   if ((theReader->textPosition > 2) &&
+       (theReader->text[0] == '[') &&
+       (theReader->text[theReader->textPosition-1] == ']'))
+     {
+      theReader->text[theReader->textPosition-1] = EOS;
+      theToken->tknType = INSTANCE_NAME_TOKEN;
+      theToken->lexemeValue = CreateInstanceName(theEnv,theReader->text+1);
+      theReader->text[theReader->textPosition-1] = ']';
+      return;
+     }
+#endif
+
+   theToken->tknType = SYMBOL_TOKEN;
+   theToken->lexemeValue = CreateSymbol(theEnv,theReader->text);
+  }
+
+/***********************************************************/
+/* StreamScanNumber: Converts the atom which has been read */
+/*   to a number using the phases of the scanner's number  */
+/*   recognizer. Returns false if the atom is a symbol.    */
+/***********************************************************/
+static bool StreamScanNumber(
+  Environment *theEnv,
+  struct factStreamReader *theReader,
+  struct token *theToken)
+  {
+   int phase = -1;
+   bool digitFound = false;
+   bool processFloat = false;
+   long long lvalue;
+   size_t i;
+   int inchar;
+
+   /* Phases:              */
+   /*  -1 = sign           */
+   /*   0 = integral       */
+   /*   1 = decimal        */
+   /*   2 = exponent-begin */
+   /*   3 = exponent-value */
+
+   for (i = 0; i < theReader->textPosition; i++)
+     {
+      inchar = theReader->text[i];
+
+      if (isdigit(inchar))
+        {
+         if (phase <= 1) digitFound = true;
+         if ((phase == -1) || (phase == 2)) phase = (phase == -1) ? 0 : 3;
+        }
+      else if ((inchar == '+') || (inchar == '-'))
+        {
+         if (phase == -1) phase = 0;
+         else if (phase == 2) phase = 3;
+         else return false;
+        }
+      else if (inchar == '.')
+        {
+         if (phase > 0) return false;
+         processFloat = true;
+         phase = 1;
+        }
+      else if ((inchar == 'e') || (inchar == 'E'))
+        {
+         if (phase > 1) return false;
+         processFloat = true;
+         phase = 2;
+        }
+      else
+        { return false; }
+     }
+
+   if (phase == 2) digitFound = false;
+   else if ((phase == 3) &&
+            ((theReader->text[theReader->textPosition-1] == '+') ||
+             (theReader->text[theReader->textPosition-1] == '-')))
+     { digitFound = false; }
+
+   if (! digitFound) return false;
+
+   if (processFloat)
+     {
+      theToken->tknType = FLOAT_TOKEN;
+      theToken->floatValue = CreateFloat(theEnv,atof(theReader->text));
+      return true;
+     }
+
+   errno = 0;
+#if WIN_MVC
+   lvalue = _strtoi64(theReader->text,NULL,10);
+#else
+   lvalue = strtoll(theReader->text,NULL,10);
+#endif
+   if (errno)
+     {
+      PrintWarningID(theEnv,"SCANNER",1,false);
+      WriteString(theEnv,STDWRN,"Over or underflow of long long integer.\n");
+     }
+
+   theToken->tknType = INTEGER_TOKEN;
+   theToken->integerValue = CreateInteger(theEnv,lvalue);
+   return true;
+  }
+
+/****************************************************/
+/* StreamScanString: Reads a string. The opening "  */
+/*   has been read. A \ escapes the next character. */
+/****************************************************/
+static void StreamScanString(
+  Environment *theEnv,
+  struct factStreamReader *theReader,
+  struct token *theToken)
+  {
+   int inchar;
+
+   theReader->textPosition = 0;
+
+   inchar = StreamReadChar(theReader);
+   while ((inchar != '"') && (inchar != EOF))
+     {
+      if (inchar == '\\')
+        { inchar = StreamReadChar(theReader); }
+
+      theReader->text = ExpandStringWithChar(theEnv,inchar,theReader->text,&theReader->textPosition,
+                                             &theReader->textMax,theReader->textMax+80);
+      inchar = StreamReadChar(theReader);
+     }
+
+   if (inchar == EOF)
+     {
+      PrintErrorID(theEnv,"SCANNER",1,true);
+      WriteString(theEnv,STDERR,"Encountered End-Of-File while scanning a string\n");
+     }
+
+   theToken->tknType = STRING_TOKEN;
+   if (theReader->textPosition == 0)
+     { theToken->lexemeValue = CreateString(theEnv,""); }
+   else
+     { theToken->lexemeValue = CreateString(theEnv,theReader->text); }
+  }
+
+#if BLOAD || BLOAD_AND_BSAVE || BLOAD_ONLY || RUN_TIME
+
+/***********************************************************/
+/* StreamNoSuchTemplateError: Prints the error message for */
+/*   a fact that would need a new implied deftemplate.     */
+/***********************************************************/
+static void StreamNoSuchTemplateError(
+  Environment *theEnv,
+  const char *templateName)
+  {
+   PrintErrorID(theEnv,"FACTRHS",1,false);
+   WriteString(theEnv,STDERR,"Implied deftemplate '");
+   WriteString(theEnv,STDERR,templateName);
+   WriteString(theEnv,STDERR,"' cannot be created with binary load in effect.\n");
+  }
+
+#endif
+
+/*****************************************************/
+/* CreateFactStreamWriter: Creates a writer for the  */
+/*   save-facts format. The file must also be the    */
+/*   "fast save" file of the environment, since the  */
+/*   values of address types are written with their  */
+/*   print functions.                                */
+/*****************************************************/
+FactStreamWriter *CreateFactStreamWriter(
+  Environment *theEnv,
+  FILE *filePtr)
+  {
+   FactStreamWriter *theWriter;
+
+   theWriter = (FactStreamWriter *) gm2(theEnv,sizeof(FactStreamWriter));
+   theWriter->fswEnv = theEnv;
+   theWriter->filePtr = filePtr;
+   theWriter->position = 0;
+   theWriter->error = false;
+
+   return theWriter;
+  }
+
+/*****************************************************/
+/* StreamSaveFact: Writes a fact followed by a new   */
+/*   line in the format printed by save-facts.       */
+/*****************************************************/
+void StreamSaveFact(
+  FactStreamWriter *theWriter,
+  Fact *theFact)
+  {
+   Deftemplate *theDeftemplate = theFact->whichDeftemplate;
+   struct templateSlot *slotPtr;
+   CLIPSValue *theValue;
+   Multifield *theMultifield;
+
+   StreamWriteChar(theWriter,'(');
+   StreamWriteString(theWriter,theDeftemplate->header.name->contents);
+
+   /*========================*/
+   /* Write an ordered fact. */
+   /*========================*/
+
+   if (theDeftemplate->implied)
+     {
+      theMultifield = theFact->theProposition.contents[0].multifieldValue;
+      if (theMultifield->length != 0)
+        {
+         StreamWriteChar(theWriter,' ');
+         StreamWriteMultifield(theWriter,theMultifield);
+        }
+     }
+
+   /*=========================*/
+   /* Write a template fact.  */
+   /*=========================*/
+
+   else
+     {
+      for (slotPtr = theDeftemplate->slotList, theValue = theFact->theProposition.contents;
+           slotPtr != NULL;
+           slotPtr = slotPtr->next, theValue++)
+        {
+         StreamWriteString(theWriter," (");
+         StreamWriteString(theWriter,slotPtr->slotName->contents);
+
+         if (slotPtr->multislot == false)
+           {
+            StreamWriteChar(theWriter,' ');
+            StreamWriteAtom(theWriter,theValue->header->type,theValue->value);
+           }
+         else if (theValue->multifieldValue->length > 0)
+           {
+            StreamWriteChar(theWriter,' ');
+            StreamWriteMultifield(theWriter,theValue->multifieldValue);
+           }
+
+         StreamWriteChar(theWriter,')');
+        }
+     }
+
+   StreamWriteString(theWriter,")\n");
+  }
+
+/*******************************************************/
+/* FlushFactStreamWriter: Writes the buffered text to  */
+/*   the file. Returns false if a write has failed.    */
+/*******************************************************/
+bool FlushFactStreamWriter(
+  FactStreamWriter *theWriter)
+  {
+   if (theWriter->position > 0)
+     {
+      if (fwrite(theWriter->buffer,1,theWriter->position,theWriter->filePtr) != theWriter->position)
+        { theWriter->error = true; }
+      theWriter->position = 0;
+     }
+
+   return ! theWriter->error;
+  }
+
+/*******************************************************/
+/* DeleteFactStreamWriter: Flushes and deletes a       */
+/*   writer. Returns false if a write has failed,      */
+/*   including the writes buffered by the file.        */
+/*******************************************************/
+bool DeleteFactStreamWriter(
+  FactStreamWriter *theWriter)
+  {
+   bool rv;
+
+   rv = FlushFactStreamWriter(theWriter);
+   if (fflush(theWriter->filePtr) != 0) rv = false;
+   rm(theWriter->fswEnv,theWriter,sizeof(FactStreamWriter));
+
+   return rv;
+  }
+
+/*****************************************************/
+/* StreamWriteChar: Adds a character to the buffer.  */
+/*****************************************************/
+static void StreamWriteChar(
+  FactStreamWriter *theWriter,
+  char theChar)
+  {
+   if (theWriter->position == FACT_STREAM_BUFFER_SIZE)
+     { FlushFactStreamWriter(theWriter); }
+
+   theWriter->buffer[theWriter->position++] = theChar;
+  }
+
+/****************************************************/
+/* StreamWriteString: Adds a string to the buffer.  */
+/****************************************************/
+static void StreamWriteString(
+  FactStreamWriter *theWriter,
+  const char *theString)
+  {
+   size_t length, space;
+
+   length = strlen(theString);
+   while (length > 0)
+     {
+      if (theWriter->position == FACT_STREAM_BUFFER_SIZE)
+        { FlushFactStreamWriter(theWriter); }
+
+      space = FACT_STREAM_BUFFER_SIZE - theWriter->position;
+      if (space > length) space = length;
+
+      memcpy(theWriter->buffer + theWriter->position,theString,space);
+      theWriter->position += space;
+      theString += space;
+      length -= space;
+     }
+  }
+
+/**********************************************************/
+/* StreamWriteMultifield: Writes the values of a          */
+/*   multifield separated by spaces, without parentheses. */
+/**********************************************************/
+static void StreamWriteMultifield(
+  FactStreamWriter *theWriter,
+  Multifield *theMultifield)
+  {
+   size_t i;
+
+   for (i = 0; i < theMultifield->length; i++)
+     {
+      if (i > 0) StreamWriteChar(theWriter,' ');
+      StreamWriteAtom(theWriter,theMultifield->contents[i].header->type,
+                      theMultifield->contents[i].value);
+     }
+  }
+
+/**********************************************************/
+/* StreamWriteAtom: Writes a value as PrintAtom does with */
+/*   escaped characters preserved, addresses written as   */
+/*   strings, and instance addresses written as names.    */
+/**********************************************************/
+static void StreamWriteAtom(
+  FactStreamWriter *theWriter,
+  unsigned short type,
+  void *value)
+  {
+   Environment *theEnv = theWriter->fswEnv;
+   char numberBuffer[40];
+   const char *theString;
+
+   switch (type)
+     {
+      case SYMBOL_TYPE:
+        StreamWriteString(theWriter,((CLIPSLexeme *) value)->contents);
+        break;
+
+      case STRING_TYPE:
+        StreamWriteChar(theWriter,'"');
+        for (theString = ((CLIPSLexeme *) value)->contents; *theString != EOS; theString++)
+          {
+           if ((*theString == '"') || (*theString == '\\'))
+             { StreamWriteChar(theWriter,'\\'); }
+           StreamWriteChar(theWriter,*theString);
+          }
+        StreamWriteChar(theWriter,'"');
+        break;
+
+      case INTEGER_TYPE:
+        gensnprintf(numberBuffer,sizeof(numberBuffer),"%lld",((CLIPSInteger *) value)->contents);
+        StreamWriteString(theWriter,numberBuffer);
+        break;
+
+      case FLOAT_TYPE:
+        gensnprintf(numberBuffer,sizeof(numberBuffer),"%.15g",((CLIPSFloat *) value)->contents);
+        StreamWriteString(theWriter,numberBuffer);
+        if ((strchr(numberBuffer,'.') == NULL) && (strchr(numberBuffer,'e') == NULL))
+          { StreamWriteString(theWriter,".0"); }
+        break;
+
+#if OBJECT_SYSTEM
+      case INSTANCE_NAME_TYPE:
+        StreamWriteChar(theWriter,'[');
+        StreamWriteString(theWriter,((CLIPSLexeme *) value)->contents);
+        StreamWriteChar(theWriter,']');
+        break;
+#endif
+
+      /*=====================================================*/
+      /* Addresses are rare in saved facts, so they're       */
+      /* written through the router by their print functions */
+      /* after the buffered text has been written.           */
+      /*=====================================================*/
+
+      default:
+        FlushFactStreamWriter(theWriter);
+        PrintAtom(theEnv,(const char *) theWriter->filePtr,type,value);
+        break;
+     }
+  }
+
+#endif /* DEFTEMPLATE_CONSTRUCT */
@@ -289,6 +289,7 @@ bool OpenAFile(
 
    newRouter->next = FileRouterData(theEnv)->ListOfFileRouters;
    FileRouterData(theEnv)->ListOfFileRouters = newRouter;
+   InvalidateRouterCache(theEnv);
 
    /*==================================*/
    /* Return true to indicate the file */
@@ -322,6 +323,7 @@ bool CloseFile(
          else
            { prev->next = fptr->next; }
          rm(theEnv,fptr,sizeof(struct fileRouter));
+         InvalidateRouterCache(theEnv);
 
          return true;
         }
@@ -356,6 +358,7 @@ bool CloseAllFiles(
      }
 
    FileRouterData(theEnv)->ListOfFileRouters = NULL;
+   InvalidateRouterCache(theEnv);
 
    return true;
   }
@@ -73,7 +73,8 @@
 
    static void                    ExtractAnds(Environment *,struct lhsParseNode *,bool,
                                               struct expr **,struct expr **,struct expr **,
-                                              struct expr **,struct nandFrame *);
+                                              struct expr **,bool *,struct nandFrame *);
+   static bool                    ConstantInList(struct expr *,struct expr *);
    static void                    ExtractFieldTest(Environment *,struct lhsParseNode *,bool,
                                                    struct expr **,struct expr **,struct expr **,
                                                    struct expr **,struct nandFrame *);
@@ -112,6 +113,8 @@ void FieldConversion(
    struct expr *joinNetTest = NULL;
    struct expr *constantSelector = NULL;
    struct expr *constantValue = NULL;
+   bool extraTests = false;
+   bool hashable = true;
 
    /*==================================================*/
    /* Consider a NULL pointer to be an internal error. */
@@ -155,32 +158,48 @@ void FieldConversion(
       /*=============================================*/
 
       ExtractAnds(theEnv,patternPtr,testInPatternNetwork,&patternNetTest,&joinNetTest,
-                  &constantSelector,&constantValue,theNandFrames);
-
-      /*=============================================================*/
-      /* Constant hashing is only used in the pattern network if the */
-      /* field doesn't contain an or'ed constraint. For example, the */
-      /* constaint "red | blue" can not use hashing.                 */
-      /*=============================================================*/
-
-      if (constantSelector != NULL)
+                  &constantSelector,&constantValue,&extraTests,theNandFrames);
+
+      /*==============================================================*/
+      /* Constant hashing is used in the pattern network if the field */
+      /* contains a constant constraint and no other pattern network  */
+      /* tests. The hashed node only tests the constant, so a field   */
+      /* such as ?x&red&:(f ?x) is tested without hashing. An or'ed   */
+      /* constraint such as "red | blue" can be hashed if each of the */
+      /* or'ed constraints is such a constant constraint: the pattern */
+      /* node is then hashed under each of the constant values.       */
+      /*==============================================================*/
+
+      if ((constantSelector == NULL) || extraTests || (! hashable))
+        { hashable = false; }
+      else if (patternPtr == theField->bottom)
         {
-         if ((patternPtr == theField->bottom) &&
-             (patternPtr->bottom == NULL))
-           {
-            theField->constantSelector = constantSelector;
-            theField->constantValue = constantValue;
-           }
-         else
+         theField->constantSelector = constantSelector;
+         theField->constantValue = constantValue;
+         constantSelector = NULL;
+         constantValue = NULL;
+        }
+      else if (IdenticalExpression(constantSelector,theField->constantSelector))
+        {
+         if (! ConstantInList(constantValue,theField->constantValue))
            {
-            ReturnExpression(theEnv,constantSelector);
-            ReturnExpression(theEnv,constantValue);
-            ReturnExpression(theEnv,theField->constantSelector);
-            ReturnExpression(theEnv,theField->constantValue);
-            theField->constantSelector = NULL;
-            theField->constantValue = NULL;
+            theField->constantValue = AppendExpressions(theField->constantValue,constantValue);
+            constantValue = NULL;
            }
         }
+      else
+        { hashable = false; }
+
+      ReturnExpression(theEnv,constantSelector);
+      ReturnExpression(theEnv,constantValue);
+
+      if (! hashable)
+        {
+         ReturnExpression(theEnv,theField->constantSelector);
+         ReturnExpression(theEnv,theField->constantValue);
+         theField->constantSelector = NULL;
+         theField->constantValue = NULL;
+        }
 
       /*=====================================================*/
       /* Add the new pattern network expressions to the list */
@@ -250,10 +269,17 @@ void FieldConversion(
       /*================================================================*/
       /* If the previous variable reference is within the same pattern, */
       /* then the variable comparison can occur in the pattern network. */
+      /* The comparison is another test on the field, so the field's    */
+      /* constant can no longer be hashed.                              */
       /*================================================================*/
 
       if (theField->referringNode->pattern == theField->pattern)
         {
+         ReturnExpression(theEnv,theField->constantSelector);
+         ReturnExpression(theEnv,theField->constantValue);
+         theField->constantSelector = NULL;
+         theField->constantValue = NULL;
+
          tempExpression = GenPNVariableComparison(theEnv,theField,theField->referringNode);
          headOfPNExpression = CombineExpressions(theEnv,tempExpression,headOfPNExpression);
         }
@@ -319,6 +345,7 @@ static void ExtractAnds(
   struct expr **joinNetTest,
   struct expr **constantSelector,
   struct expr **constantValue,
+  bool *extraTests,
   struct nandFrame *theNandFrames)
   {
    struct expr *newPNTest, *newJNTest, *newConstantSelector, *newConstantValue;
@@ -332,6 +359,7 @@ static void ExtractAnds(
    *joinNetTest = NULL;
    *constantSelector = NULL;
    *constantValue = NULL;
+   *extraTests = false;
 
    /*=========================================*/
    /* Loop through each of the subfields tied */
@@ -350,6 +378,25 @@ static void ExtractAnds(
       ExtractFieldTest(theEnv,andField,testInPatternNetwork,&newPNTest,&newJNTest,
                        &newConstantSelector,&newConstantValue,theNandFrames);
 
+      /*=====================================================*/
+      /* Only the first constant constraint can be used for  */
+      /* hashing. Note if any of the other subfields has a   */
+      /* pattern network test, since the field then can't be */
+      /* hashed.                                             */
+      /*=====================================================*/
+
+      if ((newConstantSelector != NULL) && (*constantSelector == NULL))
+        {
+         *constantSelector = newConstantSelector;
+         *constantValue = newConstantValue;
+        }
+      else
+        {
+         ReturnExpression(theEnv,newConstantSelector);
+         ReturnExpression(theEnv,newConstantValue);
+         if (newPNTest != NULL) *extraTests = true;
+        }
+
       /*=================================================*/
       /* Add the new expressions to the list of pattern  */
       /* and join network expressions being constructed. */
@@ -357,11 +404,29 @@ static void ExtractAnds(
 
       *patternNetTest = CombineExpressions(theEnv,*patternNetTest,newPNTest);
       *joinNetTest = CombineExpressions(theEnv,*joinNetTest,newJNTest);
-      *constantSelector = CombineExpressions(theEnv,*constantSelector,newConstantSelector);
-      *constantValue = CombineExpressions(theEnv,*constantValue,newConstantValue);
      }
   }
 
+/*******************************************************/
+/* ConstantInList: Returns true if the constant value  */
+/*   is contained in a list of constant values.        */
+/*******************************************************/
+static bool ConstantInList(
+  struct expr *theConstant,
+  struct expr *theList)
+  {
+   for (;
+        theList != NULL;
+        theList = theList->nextArg)
+     {
+      if ((theList->type == theConstant->type) &&
+          (theList->value == theConstant->value))
+        { return true; }
+     }
+
+   return false;
+  }
+
 /************************************************************************/
 /* ExtractFieldTest: Generates the pattern or join network expression   */
 /*   associated with the basic field constraints: constants, predicate, */
@@ -50,6 +50,7 @@
 #include "genrccom.h"
 #include "memalloc.h"
 #include "modulbin.h"
+#include "userdata.h"
 #if OBJECT_SYSTEM
 #include "objbin.h"
 #else
@@ -172,6 +173,10 @@ static void DeallocateDefgenericBinaryData(
   {
 #if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
    size_t space;
+   unsigned long i;
+
+   for (i = 0; i < DefgenericBinaryData(theEnv)->MethodCount; i++)
+     { ClearUserDataList(theEnv,DefgenericBinaryData(theEnv)->MethodArray[i].header.usrData); }
 
    space = DefgenericBinaryData(theEnv)->GenericCount * sizeof(Defgeneric);
    if (space != 0) genfree(theEnv,DefgenericBinaryData(theEnv)->DefgenericArray,space);
@@ -798,6 +803,9 @@ static void UpdateMethod(
    DefgenericBinaryData(theEnv)->MethodArray[obji].localVarCount = bmth->localVarCount;
    DefgenericBinaryData(theEnv)->MethodArray[obji].system = bmth->system;
    DefgenericBinaryData(theEnv)->MethodArray[obji].restrictions = RestrictionPointer(bmth->restrictions);
+#if (! BLOAD_ONLY)
+   DefgenericBinaryData(theEnv)->MethodArray[obji].lazyBody = NULL;
+#endif
    DefgenericBinaryData(theEnv)->MethodArray[obji].actions = ExpressionPointer(bmth->actions);
    
    UpdateConstructHeader(theEnv,&bmth->header,&DefgenericBinaryData(theEnv)->MethodArray[obji].header,DEFMETHOD,
@@ -872,6 +880,9 @@ static void ClearBloadGenerics(
    DefgenericBinaryData(theEnv)->DefgenericArray = NULL;
    DefgenericBinaryData(theEnv)->GenericCount = 0L;
 
+   for (i = 0 ; i < DefgenericBinaryData(theEnv)->MethodCount ; i++)
+     ClearUserDataList(theEnv,DefgenericBinaryData(theEnv)->MethodArray[i].header.usrData);
+
    space = (sizeof(Defmethod) * DefgenericBinaryData(theEnv)->MethodCount);
    if (space == 0L)
      return;
@@ -264,6 +264,7 @@ void SetupGenericFunctions(
      ================================================================ */
    AddSaveFunction(theEnv,"defgeneric",SaveDefgenerics,1000,NULL);
    AddSaveFunction(theEnv,"defmethod",SaveDefmethods,-1000,NULL);
+   AddLazyParseFunction(theEnv,"defmethods",ParseLazyMethods,0,NULL);
    AddUDF(theEnv,"undefgeneric","v",1,1,"y",UndefgenericCommand,"UndefgenericCommand",NULL);
    AddUDF(theEnv,"undefmethod","v",2,2,"*;y;ly",UndefmethodCommand,"UndefmethodCommand",NULL);
 #endif
@@ -1005,7 +1006,17 @@ void PPDefmethodCommand(
    gi = CheckMethodExists(theEnv,"ppdefmethod",gfunc,(unsigned short) theArg.integerValue->contents);
    if (gi == METHOD_NOT_FOUND)
      return;
-     
+
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   /* ===============================================
+      Actions deferred by lazy construct loading are
+      parsed first so that they are laid out as they
+      would have been by the parser.
+      =============================================== */
+   if (gfunc->methods[gi].lazyBody != NULL)
+     ParseLazyMethod(theEnv,gfunc,&gfunc->methods[gi]);
+#endif
+
    if (strcmp(logicalName,"nil") == 0)
      {
       if (gfunc->methods[gi].header.ppForm != NULL)
@@ -1055,7 +1066,8 @@ void ListDefmethodsCommand(
   INPUTS       : 1) Address of the generic function
                  2) Index of the method
   RETURNS      : Method ppform
-  SIDE EFFECTS : None
+  SIDE EFFECTS : Actions deferred by lazy construct
+                 loading are parsed
   NOTES        : None
  ***************************************************************/
 const char *DefmethodPPForm(
@@ -1067,7 +1079,13 @@ const char *DefmethodPPForm(
    mi = FindMethodByIndex(theDefgeneric,theIndex);
    
    if (mi != METHOD_NOT_FOUND)
-     { return theDefgeneric->methods[mi].header.ppForm; }
+     {
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+      if (theDefgeneric->methods[mi].lazyBody != NULL)
+        ParseLazyMethod(theDefgeneric->header.env,theDefgeneric,&theDefgeneric->methods[mi]);
+#endif
+      return theDefgeneric->methods[mi].header.ppForm;
+     }
      
    return "";
   }
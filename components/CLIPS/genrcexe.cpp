@@ -70,6 +70,9 @@
 #include "constrct.h"
 #include "envrnmnt.h"
 #include "genrccom.h"
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+#include "genrcpsr.h"
+#endif
 #include "prcdrfun.h"
 #include "prccode.h"
 #include "prntutil.h"
@@ -230,6 +233,11 @@ void GenericDispatch(
          
          ProceduralPrimitiveData(theEnv)->CurrentProcActions = oldActions;
         }
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+      else if ((DefgenericData(theEnv)->CurrentMethod->lazyBody != NULL) &&
+               (! ParseLazyMethod(theEnv,DefgenericData(theEnv)->CurrentGeneric,DefgenericData(theEnv)->CurrentMethod)))
+        { SetEvaluationError(theEnv,true); }
+#endif
       else
         {
 #if PROFILING_FUNCTIONS
@@ -238,9 +246,10 @@ void GenericDispatch(
                       ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-         EvaluateProcActions(theEnv,DefgenericData(theEnv)->CurrentGeneric->header.whichModule->theModule,
-                             DefgenericData(theEnv)->CurrentMethod->actions,DefgenericData(theEnv)->CurrentMethod->localVarCount,
-                             returnValue,UnboundMethodErr);
+         EvaluateConstructActions(theEnv,DefgenericData(theEnv)->CurrentGeneric->header.whichModule->theModule,
+                                  &DefgenericData(theEnv)->CurrentMethod->header.usrData,
+                                  DefgenericData(theEnv)->CurrentMethod->actions,DefgenericData(theEnv)->CurrentMethod->localVarCount,
+                                  returnValue,UnboundMethodErr);
 
 #if PROFILING_FUNCTIONS
          EndProfile(theEnv,&profileFrame);
@@ -470,6 +479,11 @@ void CallNextMethod(
       fcall.argList = GetProcParamExpressions(theEnv);
       EvaluateExpression(theEnv,&fcall,returnValue);
      }
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   else if ((DefgenericData(theEnv)->CurrentMethod->lazyBody != NULL) &&
+            (! ParseLazyMethod(theEnv,DefgenericData(theEnv)->CurrentGeneric,DefgenericData(theEnv)->CurrentMethod)))
+     { SetEvaluationError(theEnv,true); }
+#endif
    else
      {
 #if PROFILING_FUNCTIONS
@@ -478,9 +492,10 @@ void CallNextMethod(
                    ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-      EvaluateProcActions(theEnv,DefgenericData(theEnv)->CurrentGeneric->header.whichModule->theModule,
-                         DefgenericData(theEnv)->CurrentMethod->actions,DefgenericData(theEnv)->CurrentMethod->localVarCount,
-                         returnValue,UnboundMethodErr);
+      EvaluateConstructActions(theEnv,DefgenericData(theEnv)->CurrentGeneric->header.whichModule->theModule,
+                               &DefgenericData(theEnv)->CurrentMethod->header.usrData,
+                               DefgenericData(theEnv)->CurrentMethod->actions,DefgenericData(theEnv)->CurrentMethod->localVarCount,
+                               returnValue,UnboundMethodErr);
 
 #if PROFILING_FUNCTIONS
       EndProfile(theEnv,&profileFrame);
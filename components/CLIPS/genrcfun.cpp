@@ -411,6 +411,7 @@ void DeleteMethodInfo(
    SaveBusyCount(gfunc);
    ExpressionDeinstall(theEnv,meth->actions);
    ReturnPackedExpression(theEnv,meth->actions);
+   ReturnLazyConstructBody(theEnv,meth->lazyBody);
    ClearUserDataList(theEnv,meth->header.usrData);
    if (meth->header.ppForm != NULL)
      rm(theEnv,(void *) meth->header.ppForm,(sizeof(char) * (strlen(meth->header.ppForm)+1)));
@@ -459,6 +460,7 @@ void DestroyMethodInfo(
 #endif
 
    ReturnPackedExpression(theEnv,meth->actions);
+   ReturnLazyConstructBody(theEnv,meth->lazyBody);
 
    ClearUserDataList(theEnv,meth->header.usrData);
    if (meth->header.ppForm != NULL)
@@ -81,6 +81,10 @@
 #include "classcom.h"
 #endif
 
+#if EXPRESSION_BYTECODE
+#include "bytecode.h"
+#endif
+
 #include "cstrccom.h"
 #include "cstrcpsr.h"
 #include "envrnmnt.h"
@@ -241,6 +245,7 @@ bool ParseDefmethod(
    Defgeneric *gfunc;
    unsigned short theIndex;
    struct token genericInputToken;
+   struct lazyConstructBody *lazyBody = NULL;
 
    SetPPBufferStatus(theEnv,true);
    FlushPPBuffer(theEnv);
@@ -333,10 +338,26 @@ bool ParseDefmethod(
       DeleteTempRestricts(theEnv,params);
       goto DefmethodParseError;
      }
-   ExpressionData(theEnv)->ReturnContext = true;
-   actions = ParseProcActions(theEnv,"method",readSource,
-                              &genericInputToken,params,wildcard,
-                              NULL,NULL,&lvars,NULL);
+
+   /* ===============================================
+      In lazy construct loading mode the restrictions
+      are parsed, but the actions are only read here
+      and parsed when the method is first called.
+      =============================================== */
+   if (GetLazyConstructLoading(theEnv) && (! ConstructData(theEnv)->CheckSyntaxMode))
+     {
+      actions = NULL;
+      lvars = 0;
+      lazyBody = ReadLazyConstructBody(theEnv,readSource,&genericInputToken,"defmethod",
+                                       params,wildcard);
+     }
+   else
+     {
+      ExpressionData(theEnv)->ReturnContext = true;
+      actions = ParseProcActions(theEnv,"method",readSource,
+                                 &genericInputToken,params,wildcard,
+                                 NULL,NULL,&lvars,NULL);
+     }
 
    /*===========================================================*/
    /* Check for the closing right parenthesis of the defmethod. */
@@ -351,7 +372,7 @@ bool ParseDefmethod(
       goto DefmethodParseError;
      }
 
-   if (actions == NULL)
+   if ((actions == NULL) && (lazyBody == NULL))
      {
       DeleteTempRestricts(theEnv,params);
       goto DefmethodParseError;
@@ -385,6 +406,7 @@ bool ParseDefmethod(
 #else
    meth = AddMethod(theEnv,gfunc,meth,mposn,theIndex,params,rcnt,lvars,wildcard,actions,NULL,false);
 #endif
+   meth->lazyBody = lazyBody;
    DeleteTempRestricts(theEnv,params);
    if (GetPrintWhileLoading(theEnv) && GetCompilationsWatch(theEnv) &&
        (! ConstructData(theEnv)->CheckSyntaxMode))
@@ -495,10 +517,15 @@ Defmethod *AddMethod(
          ================================ */
       ExpressionDeinstall(theEnv,meth->actions);
       ReturnPackedExpression(theEnv,meth->actions);
+      ReturnLazyConstructBody(theEnv,meth->lazyBody);
       if (meth->header.ppForm != NULL)
         rm(theEnv,(void *) meth->header.ppForm,(sizeof(char) * (strlen(meth->header.ppForm)+1)));
+#if EXPRESSION_BYTECODE
+      DiscardBytecode(theEnv,&meth->header.usrData);
+#endif
      }
    meth->system = 0;
+   meth->lazyBody = NULL;
    meth->actions = actions;
    ExpressionInstall(theEnv,meth->actions);
    meth->header.ppForm = ppForm;
@@ -566,6 +593,106 @@ Defmethod *AddMethod(
    return(meth);
   }
 
+/***************************************************
+  NAME         : ParseLazyMethod
+  DESCRIPTION  : Parses the actions of a method
+                 loaded in lazy construct loading
+                 mode
+  INPUTS       : 1) The generic function
+                 2) The method
+  RETURNS      : True if successful, false otherwise
+  SIDE EFFECTS : Actions installed and text released
+  NOTES        : The busy count of the generic
+                 function is preserved since it can
+                 be executing when the method is
+                 parsed. The errors of actions which
+                 can not be parsed are only reported
+                 once.
+ ***************************************************/
+bool ParseLazyMethod(
+  Environment *theEnv,
+  Defgeneric *gfunc,
+  Defmethod *meth)
+  {
+   Expression *actions;
+   unsigned short lvars;
+
+   if (meth->lazyBody->parseFailed)
+     { return false; }
+
+   actions = ParseLazyProcActions(theEnv,"method",gfunc->header.whichModule->theModule,
+                                  meth->lazyBody,&meth->header,NULL,NULL,NULL,&lvars,NULL);
+   if (actions == NULL)
+     {
+      meth->lazyBody->parseFailed = true;
+      PrintErrorID(theEnv,"GENRCPSR",18,false);
+      WriteString(theEnv,STDERR,"The actions of generic function '");
+      WriteString(theEnv,STDERR,DefgenericName(gfunc));
+      WriteString(theEnv,STDERR,"' method #");
+      PrintUnsignedInteger(theEnv,STDERR,meth->index);
+      WriteString(theEnv,STDERR," could not be parsed.\n");
+      return false;
+     }
+
+   SaveBusyCount(gfunc);
+   ExpressionInstall(theEnv,actions);
+   RestoreBusyCount(gfunc);
+   meth->actions = actions;
+   meth->localVarCount = lvars;
+
+   ReturnLazyConstructBody(theEnv,meth->lazyBody);
+   meth->lazyBody = NULL;
+
+   return true;
+  }
+
+/***************************************************
+  NAME         : ParseLazyMethods
+  DESCRIPTION  : Parses the actions of all the
+                 methods which have not been called
+                 since they were loaded in lazy
+                 construct loading mode
+  INPUTS       : Not used
+  RETURNS      : False if the actions of any
+                 method contain errors
+  SIDE EFFECTS : Actions installed
+  NOTES        : Called by ParseLazyConstructs
+ ***************************************************/
+bool ParseLazyMethods(
+  Environment *theEnv,
+  void *context)
+  {
+   Defmodule *theModule;
+   Defgeneric *gfunc;
+   unsigned short i;
+   bool rv = true;
+#if MAC_XCD
+#pragma unused(context)
+#endif
+
+   SaveCurrentModule(theEnv);
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+      for (gfunc = GetNextDefgeneric(theEnv,NULL);
+           gfunc != NULL;
+           gfunc = GetNextDefgeneric(theEnv,gfunc))
+        {
+         for (i = 0 ; i < gfunc->mcnt ; i++)
+           {
+            if ((gfunc->methods[i].lazyBody != NULL) &&
+                (! ParseLazyMethod(theEnv,gfunc,&gfunc->methods[i])))
+              { rv = false; }
+           }
+        }
+     }
+   RestoreCurrentModule(theEnv);
+
+   return rv;
+  }
+
 /*****************************************************
   NAME         : PackRestrictionTypes
   DESCRIPTION  : Takes the restriction type list
@@ -125,6 +125,7 @@ struct agendaData
 /****************************************/
 
    void                    AddActivation(Environment *,Defrule *,PartialMatch *);
+   Activation             *RestoreActivation(Environment *,Defrule *,PartialMatch *,int,unsigned long long,int);
    void                    ClearRuleFromAgenda(Environment *,Defrule *);
    Activation             *GetNextActivation(Environment *,Activation *);
    struct partialMatch    *GetActivationBasis(Environment *,Activation *);
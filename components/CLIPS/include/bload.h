@@ -62,6 +62,17 @@
 
 #define BLOAD_DATA 38
 
+/*=======================================================*/
+/* Tables and records are converted directly from a      */
+/* binary image in memory, without a temporary buffer,   */
+/* when they are on this boundary. Otherwise they are    */
+/* copied to an aligned buffer as when reading a file.   */
+/*=======================================================*/
+
+#ifndef BLOAD_IMAGE_ALIGNMENT
+#define BLOAD_IMAGE_ALIGNMENT 8
+#endif
+
 struct bloadData
   {
    const char *BinaryPrefixID;
@@ -82,6 +93,8 @@ struct bloadData
    void                    InitializeBloadData(Environment *);
    void                    BloadCommand(Environment *,UDFContext *,UDFValue *);
    bool                    Bload(Environment *,const char *);
+   bool                    BloadImage(Environment *,const void *,size_t);
+   bool                    BloadOpenedBinary(Environment *,const char *);
    void                    BloadandRefresh(Environment *,unsigned long,size_t,void (*)(Environment *,void *,unsigned long));
    bool                    Bloaded(Environment *);
    void                    AddBeforeBloadFunction(Environment *,const char *,VoidCallFunction *,int,void *);
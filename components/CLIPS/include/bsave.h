@@ -106,6 +106,7 @@ struct bsaveData
    void                    BsaveCommand(Environment *,UDFContext *,UDFValue *);
 #if BLOAD_AND_BSAVE
    bool                    Bsave(Environment *,const char *);
+   void                    BsaveOpenedBinary(Environment *,FILE *);
    void                    MarkNeededItems(Environment *,struct expr *);
    void                    SaveBloadCount(Environment *,unsigned long);
    void                    RestoreBloadCount(Environment *,unsigned long *);
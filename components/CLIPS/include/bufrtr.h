@@ -0,0 +1,81 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*             BUFFERED ROUTER HEADER FILE             */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Output routers which collect the fragments       */
+/*   written to them in a ring buffer and pass them to a     */
+/*   sink function in bulk.                                  */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_bufrtr
+
+#pragma once
+
+#define _H_bufrtr
+
+#include <stddef.h>
+
+#include "entities.h"
+#include "router.h"
+
+#define BUFFERED_ROUTER_DATA 67
+
+#ifndef BUFFERED_ROUTER_CAPACITY
+#define BUFFERED_ROUTER_CAPACITY 1024
+#endif
+
+#ifndef BUFFERED_ROUTER_INTERVAL
+#define BUFFERED_ROUTER_INTERVAL 20
+#endif
+
+typedef enum
+  {
+   BUFFER_BLOCK,
+   BUFFER_DROP
+  } BufferPolicy;
+
+typedef struct bufferedRouter BufferedRouter;
+typedef size_t BufferedSinkFunction(Environment *,const char *,size_t,bool,void *);
+
+typedef struct bufferedRouterStats
+  {
+   unsigned long long writes;
+   unsigned long long bytes;
+   unsigned long long sinkCalls;
+   unsigned long long dropped;
+   double seconds;
+  } BufferedRouterStats;
+
+   void                           BufferedRouterCommandDefinitions(Environment *);
+   BufferedRouter                *AddBufferedRouter(Environment *,const char *,int,
+                                                    RouterQueryFunction *,BufferedSinkFunction *,
+                                                    size_t,BufferPolicy,void *);
+   bool                           DeleteBufferedRouter(Environment *,const char *);
+   BufferedRouter                *FindBufferedRouter(Environment *,const char *);
+   void                           SetBufferedRouterFlush(BufferedRouter *,bool,size_t,long);
+   BufferPolicy                   SetBufferedRouterPolicy(BufferedRouter *,BufferPolicy);
+   void                           GetBufferedRouterStats(BufferedRouter *,BufferedRouterStats *);
+   bool                           FlushBufferedRouter(Environment *,BufferedRouter *);
+   bool                           FlushBufferedOutput(Environment *,const char *);
+   void                           FlushAllBufferedRouters(Environment *);
+   void                           PollBufferedRouters(Environment *);
+   void                           BufferedOutputStatsCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetBufferedOutputPolicyCommand(Environment *,UDFContext *,UDFValue *);
+#if (LINUX || DARWIN) && (! defined(ESP_PLATFORM))
+   void                           OpenBufferedOutputCommand(Environment *,UDFContext *,UDFValue *);
+   void                           CloseBufferedOutputCommand(Environment *,UDFContext *,UDFValue *);
+#endif
+
+#endif /* _H_bufrtr */
@@ -0,0 +1,160 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                BYTECODE HEADER FILE                 */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Compiles the actions of deffunctions, methods,   */
+/*   message-handlers and the right hand side of rules into  */
+/*   a compact instruction sequence which is run by a small  */
+/*   stack machine instead of walking the expression tree.   */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_bytecode
+
+#pragma once
+
+#define _H_bytecode
+
+#include "entities.h"
+#include "expressn.h"
+#include "userdata.h"
+
+#define BYTECODE_DATA 6
+
+/*=================================================*/
+/* The number of values a pure expression may keep */
+/* on the stack and the number of while loops one  */
+/* program may nest before the remaining ones are  */
+/* left to the interpreter.                        */
+/*=================================================*/
+
+#ifndef BYTECODE_STACK_SIZE
+#define BYTECODE_STACK_SIZE 8
+#endif
+
+#ifndef BYTECODE_LOOP_DEPTH
+#define BYTECODE_LOOP_DEPTH 4
+#endif
+
+/*===================================================*/
+/* GCC and Clang can jump to the next instruction    */
+/* through a table of label addresses rather than a  */
+/* switch statement.                                 */
+/*===================================================*/
+
+#ifndef BYTECODE_THREADED_DISPATCH
+#if defined(__GNUC__)
+#define BYTECODE_THREADED_DISPATCH 1
+#else
+#define BYTECODE_THREADED_DISPATCH 0
+#endif
+#endif
+
+typedef enum
+  {
+   BC_EVALUATE,
+   BC_CONSTANT,
+   BC_FALSE,
+   BC_STORE_LOCAL,
+   BC_JUMP,
+   BC_JUMP_IF_FALSE,
+   BC_JUMP_IF_HALTED,
+   BC_JUMP_IF_STOPPED,
+   BC_FALSE_IF_HALTED,
+   BC_FALSE_IF_STOPPED,
+   BC_FALSE_IF_ERROR,
+   BC_LOOP_BEGIN,
+   BC_LOOP_STEP,
+   BC_LOOP_END,
+   BC_PURE_BEGIN,
+   BC_PURE_END,
+   BC_PUSH_CONSTANT,
+   BC_PUSH_LOCAL,
+   BC_PUSH_PARAMETER,
+   BC_ADD,
+   BC_SUBTRACT,
+   BC_MULTIPLY,
+   BC_DIVIDE,
+   BC_NUMERIC_EQUAL,
+   BC_NUMERIC_NOT_EQUAL,
+   BC_LESS_THAN,
+   BC_LESS_THAN_OR_EQUAL,
+   BC_GREATER_THAN,
+   BC_GREATER_THAN_OR_EQUAL,
+   BC_EQ,
+   BC_NEQ,
+   BC_NOT,
+   BC_RETURN
+  } BytecodeOperation;
+
+/*=====================================================*/
+/* The operand is a jump target, a local variable or   */
+/* parameter index, or a loop depth. The node is the   */
+/* expression evaluated by the instruction, and the    */
+/* parent is the function call whose argument it is    */
+/* (NULL for the top level action).                    */
+/*=====================================================*/
+
+struct bytecodeInstruction
+  {
+   unsigned short operation;
+   unsigned int operand;
+   Expression *node;
+   Expression *parent;
+  };
+
+struct bytecodeProgram
+  {
+   struct userData usrData;
+   Expression *source;
+   struct bytecodeInstruction *code;
+   unsigned int length;
+  };
+
+/*=================================================*/
+/* A value on the stack of a pure expression. The  */
+/* value is NULL for a number computed by the      */
+/* machine, which is only created as an integer or */
+/* float when it leaves the expression.            */
+/*=================================================*/
+
+struct bytecodeSlot
+  {
+   unsigned short type;
+   void *value;
+   union
+     {
+      long long integer;
+      double real;
+     } number;
+  };
+
+struct bytecodeData
+  {
+   bool Enabled;
+   unsigned char ProgramDataID;
+   struct userDataRecord ProgramDataInfo;
+  };
+
+#define BytecodeData(theEnv) ((struct bytecodeData *) GetEnvironmentData(theEnv,BYTECODE_DATA))
+
+   void                           BytecodeDefinitions(Environment *);
+   bool                           EvaluateBytecode(Environment *,struct userData **,Expression *,UDFValue *);
+   void                           DiscardBytecode(Environment *,struct userData **);
+   bool                           SetBytecodeExecution(Environment *,bool);
+   bool                           GetBytecodeExecution(Environment *);
+   void                           SetBytecodeExecutionCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetBytecodeExecutionCommand(Environment *,UDFContext *,UDFValue *);
+
+#endif /* _H_bytecode */
@@ -46,6 +46,7 @@
 #include "commline.h"
 #include "symbol.h"
 
+#include "numconv.h"
 #include "prntutil.h"
 #include "router.h"
 #include "filertr.h"
@@ -72,6 +73,34 @@
 #include "bsave.h"
 #endif
 
+#if ENVIRONMENT_POOL_FUNCTIONS
+#include "envpool.h"
+#endif
+
+#if FACT_BATCH_FUNCTIONS
+#include "factbtch.h"
+#endif
+
+#if BUFFERED_ROUTER_FUNCTIONS
+#include "bufrtr.h"
+#endif
+
+#if JOIN_STATISTICS
+#include "joinstat.h"
+#endif
+
+#if RULE_LATENCY_FUNCTIONS
+#include "rulelat.h"
+#endif
+
+#if EVENT_TRACE_FUNCTIONS
+#include "evtrace.h"
+#endif
+
+#if EXPRESSION_BYTECODE
+#include "bytecode.h"
+#endif
+
 #if DEFRULE_CONSTRUCT
 #include "ruledef.h"
 #include "rulebsc.h"
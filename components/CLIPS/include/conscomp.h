@@ -106,6 +106,7 @@ struct constructCompilerData
    bool ExpressionHeader;
    unsigned long ExpressionCount;
    unsigned ExpressionVersion;
+   bool ExpressionFixups;
    unsigned CodeGeneratorCount;
    struct CodeGeneratorItem *ListOfCodeGeneratorItems;
   };
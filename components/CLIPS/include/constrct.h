@@ -87,6 +87,7 @@ typedef struct saveCallFunctionItem SaveCallFunctionItem;
 
 typedef void ParserErrorFunction(Environment *,const char *,const char *,const char *,long,void *);
 typedef bool BeforeResetFunction(Environment *);
+typedef bool ConstructLoadFilterFunction(Environment *,const char *,void *);
 
 #define CHS (ConstructHeader *)
 
@@ -147,6 +148,10 @@ struct constructData
    size_t CurWrnPos;
    ParserErrorFunction *ParserErrorCallback;
    void *ParserErrorContext;
+   bool LazyConstructLoading;
+   struct boolCallFunctionItem *ListOfLazyParseFunctions;
+   ConstructLoadFilterFunction *LoadFilter;
+   void *LoadFilterContext;
 #endif
    Construct *ListOfConstructs;
    struct voidCallFunctionItem *ListOfResetFunctions;
@@ -60,7 +60,21 @@
 
 #define _H_cstrcpsr
 
+#include "constrct.h"
+#include "expressn.h"
+#include "scanner.h"
 #include "strngfun.h"
+#include "utility.h"
+
+/*==========================================================*/
+/* Files up to this size are read into memory by load so    */
+/* that they can be scanned as a span. Larger files are     */
+/* read a character at a time. A limit of 0 turns this off. */
+/*==========================================================*/
+
+#ifndef LOAD_BUFFER_LIMIT
+#define LOAD_BUFFER_LIMIT 32768
+#endif
 
 typedef enum
   {
@@ -69,6 +83,25 @@ typedef enum
    LE_PARSING_ERROR,
   } LoadError;
 
+/*==========================================================*/
+/* The actions of a construct read in lazy construct        */
+/* loading mode, with the state of the pretty print buffer  */
+/* when they were read so that the pretty print form of the */
+/* construct can be laid out again when they are parsed.    */
+/* Actions which could not be parsed are marked so that     */
+/* their errors are only reported once.                     */
+/*==========================================================*/
+
+struct lazyConstructBody
+  {
+   char *text;
+   size_t ppOffset;
+   size_t ppBackupOnce;
+   size_t ppBackupTwice;
+   size_t indentationDepth;
+   bool parseFailed;
+  };
+
 #if (! RUN_TIME) && (! BLOAD_ONLY)
    LoadError                      Load(Environment *,const char *);
    bool                           LoadConstructsFromLogicalName(Environment *,const char *);
@@ -77,6 +110,7 @@ typedef enum
    void                           ImportExportConflictMessage(Environment *,const char *,const char *,
                                                               const char *,const char *);
    void                           FlushParsingMessages(Environment *);
+   ConstructLoadFilterFunction   *SetConstructLoadFilter(Environment *,ConstructLoadFilterFunction *,void *);
    char                          *GetParsingFileName(Environment *);
    void                           SetParsingFileName(Environment *,const char *);
    char                          *GetErrorFileName(Environment *);
@@ -85,6 +119,19 @@ typedef enum
    void                           SetWarningFileName(Environment *,const char *);
    void                           CreateErrorCaptureRouter(Environment *);
    void                           DeleteErrorCaptureRouter(Environment *);
+   bool                           GetLazyConstructLoading(Environment *);
+   bool                           SetLazyConstructLoading(Environment *,bool);
+   void                           GetLazyConstructLoadingCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetLazyConstructLoadingCommand(Environment *,UDFContext *,UDFValue *);
+   bool                           AddLazyParseFunction(Environment *,const char *,BoolCallFunction *,int,void *);
+   bool                           ParseLazyConstructs(Environment *);
+   struct lazyConstructBody      *ReadLazyConstructBody(Environment *,const char *,struct token *,const char *,
+                                                        Expression *,CLIPSLexeme *);
+   void                           ReturnLazyConstructBody(Environment *,struct lazyConstructBody *);
+#endif
+#if RUN_TIME
+   void                           GetLazyConstructLoadingCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetLazyConstructLoadingCommand(Environment *,UDFContext *,UDFValue *);
 #endif
 
 #endif
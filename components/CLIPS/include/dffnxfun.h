@@ -92,6 +92,9 @@ struct deffunction
    unsigned short minNumberOfParameters;
    unsigned short maxNumberOfParameters;
    unsigned short numberOfLocalVars;
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   struct lazyConstructBody *lazyBody;
+#endif
   };
 
 #define DEFFUNCTION_DATA 23
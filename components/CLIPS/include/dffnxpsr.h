@@ -46,7 +46,11 @@
 
 #if DEFFUNCTION_CONSTRUCT && (! BLOAD_ONLY) && (! RUN_TIME)
 
+#include "dffnxfun.h"
+
    bool                           ParseDeffunction(Environment *,const char *);
+   bool                           ParseLazyDeffunction(Environment *,Deffunction *);
+   bool                           ParseLazyDeffunctions(Environment *,void *);
 
 #endif /* DEFFUNCTION_CONSTRUCT && (! BLOAD_ONLY) && (! RUN_TIME) */
 
@@ -48,8 +48,26 @@
 #include "match.h"
 #include "network.h"
 
+/**************************************************************/
+/* JoinTestNumbers and JoinTestCompare: Used by the functions */
+/*   generated by constructs-to-c for the join network tests  */
+/*   to compare two numbers in the same way as the comparison */
+/*   functions: as integers if both are integers, otherwise   */
+/*   as floats. The operator given fails the comparison.      */
+/**************************************************************/
+
+#define JoinTestNumbers(v1,v2) \
+   ((((v1).header->type == INTEGER_TYPE) || ((v1).header->type == FLOAT_TYPE)) && \
+    (((v2).header->type == INTEGER_TYPE) || ((v2).header->type == FLOAT_TYPE)))
+
+#define JoinTestCompare(v1,v2,failOp) \
+   ((((v1).header->type == INTEGER_TYPE) && ((v2).header->type == INTEGER_TYPE)) ? \
+    (! ((v1).integerValue->contents failOp (v2).integerValue->contents)) : \
+    (! (CVCoerceToFloat(&(v1)) failOp CVCoerceToFloat(&(v2)))))
+
    void                           NetworkAssert(Environment *,struct partialMatch *,struct joinNode *);
    bool                           EvaluateJoinExpression(Environment *,struct expr *,struct joinNode *);
+   bool                           EvaluateJoinTest(Environment *,struct expr *,struct joinNode *,bool *);
    void                           NetworkAssertLeft(Environment *,struct partialMatch *,struct joinNode *,int);
    void                           NetworkAssertRight(Environment *,struct partialMatch *,struct joinNode *,int);
    void                           PPDrive(Environment *,struct partialMatch *,struct partialMatch *,struct joinNode *,int);
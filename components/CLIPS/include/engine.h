@@ -133,6 +133,8 @@ struct engineData
    struct partialMatch *GarbagePartialMatches;
    struct alphaMatch *GarbageAlphaMatches;
    bool AlreadyRunning;
+   long long RunDeadline;
+   bool RunSlicePending;
 #if DEVELOPER
    long leftToRightComparisons;
    long rightToLeftComparisons;
@@ -152,6 +154,8 @@ struct engineData
 #define MAX_PATTERNS_CHECKED 64
 
    long long               Run(Environment *,long long);
+   long long               RunFor(Environment *,long long);
+   bool                    RunSlicePending(Environment *);
    bool                    AddAfterRuleFiresFunction(Environment *,const char *,
                                                      RuleFiredFunction *,int,void *);
    bool                    RemoveAfterRuleFiresFunction(Environment *,const char *);
@@ -171,6 +175,7 @@ struct engineData
    void                    ShowBreaks(Environment *,const char *,Defmodule *);
    bool                    DefruleHasBreakpoint(Defrule *);
    void                    RunCommand(Environment *,UDFContext *,UDFValue *);
+   void                    RunForCommand(Environment *,UDFContext *,UDFValue *);
    void                    SetBreakCommand(Environment *,UDFContext *,UDFValue *);
    void                    RemoveBreakCommand(Environment *,UDFContext *,UDFValue *);
    void                    ShowBreaksCommand(Environment *,UDFContext *,UDFValue *);
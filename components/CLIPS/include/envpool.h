@@ -0,0 +1,54 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*            ENVIRONMENT POOL HEADER FILE             */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Runs a set of environments loaded from the same  */
+/*   binary image in worker threads pinned to the available  */
+/*   cores, dispatching tasks to them through work-stealing  */
+/*   queues.                                                 */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_envpool
+
+#pragma once
+
+#define _H_envpool
+
+#include <stddef.h>
+
+#include "entities.h"
+
+#ifndef ENVIRONMENT_POOL_STACK_SIZE
+#define ENVIRONMENT_POOL_STACK_SIZE 16384
+#endif
+
+#define POOL_ANY_WORKER -1
+
+typedef struct environmentPool EnvironmentPool;
+
+typedef bool EnvironmentPoolInitFunction(Environment *,void *);
+typedef void EnvironmentPoolTaskFunction(Environment *,void *);
+
+   EnvironmentPool               *CreateEnvironmentPool(unsigned int,const void *,size_t,
+                                                        EnvironmentPoolInitFunction *,void *,bool);
+   void                           DestroyEnvironmentPool(EnvironmentPool *);
+   bool                           SubmitPoolTask(EnvironmentPool *,int,EnvironmentPoolTaskFunction *,void *);
+   bool                           SubmitPoolFacts(EnvironmentPool *,int,const char *,size_t);
+   void                           WaitEnvironmentPool(EnvironmentPool *);
+   unsigned int                   GetEnvironmentPoolSize(EnvironmentPool *);
+   Environment                   *GetPoolEnvironment(EnvironmentPool *,unsigned int);
+   unsigned long                  GetPoolTasksStolen(EnvironmentPool *,unsigned int);
+
+#endif /* _H_envpool */
@@ -29,8 +29,10 @@
 
 #include "envrnmnt.h"
 #include "extnfunc.h"
+#include "symbol.h"
 
    Environment                   *CreateEnvironment(void);
+   Environment                   *CreateEnvironmentWithBase(SharedAtomBase *);
    Environment                   *CreateRuntimeEnvironment(CLIPSLexeme **,CLIPSFloat **,
                                                            CLIPSInteger **,CLIPSBitMap **,
                                                            struct functionDefinition *);
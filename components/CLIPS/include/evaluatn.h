@@ -140,6 +140,7 @@ struct evaluationData
    bool EvaluationError;
    bool HaltExecution;
    int CurrentEvaluationDepth;
+   int EvalStringDepth;
    int numberOfAddressTypes;
    struct entityRecord *PrimitivesArray[MAXIMUM_PRIMITIVES];
    struct externalAddressType *ExternalAddressTypes[MAXIMUM_EXTERNAL_ADDRESS_TYPES];
@@ -0,0 +1,83 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*               EVENT TRACE HEADER FILE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Records fact, activation and rule firing events  */
+/*   as fixed size binary records in a ring buffer which is  */
+/*   formatted by a separate consumer.                       */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_evtrace
+
+#pragma once
+
+#define _H_evtrace
+
+#include "entities.h"
+
+#define EVENT_TRACE_DATA 51
+
+/*=======================================*/
+/* The capacity must be a power of two.  */
+/*=======================================*/
+
+#ifndef EVENT_TRACE_CAPACITY
+#define EVENT_TRACE_CAPACITY 1024
+#endif
+
+typedef enum
+  {
+   TRACE_ASSERT = 1,
+   TRACE_RETRACT,
+   TRACE_ACTIVATE,
+   TRACE_DEACTIVATE,
+   TRACE_FIRE
+  } TraceEventType;
+
+typedef struct traceEvent TraceEvent;
+
+struct traceEvent
+  {
+   long long time;
+   long long id;
+   const void *construct;
+   unsigned short type;
+  };
+
+struct eventTraceData
+  {
+   bool Tracing;
+   TraceEvent *Ring;
+   unsigned long Head;
+   unsigned long Start;
+  };
+
+#define EventTraceData(theEnv) ((struct eventTraceData *) GetEnvironmentData(theEnv,EVENT_TRACE_DATA))
+
+   void                           EventTraceDefinitions(Environment *);
+   void                           RecordTraceEvent(Environment *,TraceEventType,long long,const void *);
+   size_t                         ReadTraceEvents(Environment *,unsigned long *,TraceEvent *,size_t);
+   void                           PrintTraceEvent(Environment *,const char *,TraceEvent *,long long);
+   unsigned long                  TraceEventCursor(Environment *,long long);
+   void                           ListTraceEvents(Environment *,const char *,long long);
+   void                           ResetEventTrace(Environment *);
+   bool                           SetEventTracing(Environment *,bool);
+   bool                           GetEventTracing(Environment *);
+   void                           EventTraceCommand(Environment *,UDFContext *,UDFValue *);
+   void                           EventTraceResetCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetEventTracingCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetEventTracingCommand(Environment *,UDFContext *,UDFValue *);
+
+#endif /* _H_evtrace */
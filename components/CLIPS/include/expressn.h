@@ -112,6 +112,12 @@ struct expressionData
    FunctionDefinition *PTR_EQ;
    FunctionDefinition *PTR_NEQ;
    FunctionDefinition *PTR_NOT;
+   FunctionDefinition *PTR_LT;
+   FunctionDefinition *PTR_LE;
+   FunctionDefinition *PTR_GT;
+   FunctionDefinition *PTR_GE;
+   FunctionDefinition *PTR_NUM_EQ;
+   FunctionDefinition *PTR_NUM_NEQ;
    EXPRESSION_HN **ExpressionHashTable;
 #if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE)
    unsigned long NumberOfExpressions;
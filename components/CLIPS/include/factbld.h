@@ -55,6 +55,7 @@ struct factPatternNode
    struct factPatternNode *lastLevel;
    struct factPatternNode *leftNode;
    struct factPatternNode *rightNode;
+   CLIPSBitMap *slotBitMap;
   };
 
    void                           InitializeFactPatterns(Environment *);
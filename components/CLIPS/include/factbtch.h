@@ -0,0 +1,48 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                FACT BATCH HEADER FILE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Asserts a batch of facts after matching them     */
+/*   against the fact pattern network in several threads.    */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_factbtch
+
+#pragma once
+
+#define _H_factbtch
+
+#include <stddef.h>
+
+#include "entities.h"
+
+#ifndef FACT_BATCH_SIZE
+#define FACT_BATCH_SIZE 64
+#endif
+
+#ifndef FACT_BATCH_STACK_SIZE
+#define FACT_BATCH_STACK_SIZE 4096
+#endif
+
+#define FACT_BATCH_DATA 66
+
+   void                           FactBatchCommandDefinitions(Environment *);
+   void                           SetFactBatchThreadsCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetFactBatchThreadsCommand(Environment *,UDFContext *,UDFValue *);
+   size_t                         AssertFactBatch(Environment *,Fact **,size_t);
+   unsigned int                   SetFactBatchThreads(Environment *,unsigned int);
+   unsigned int                   GetFactBatchThreads(Environment *);
+
+#endif /* _H_factbtch */
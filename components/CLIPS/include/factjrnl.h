@@ -0,0 +1,74 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*              FACT JOURNAL HEADER FILE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Keeps an append-only log of the changes made to  */
+/*   the fact-list so the facts can be restored after a      */
+/*   restart without saving the whole fact-list each time.   */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_factjrnl
+
+#pragma once
+
+#define _H_factjrnl
+
+#include <stdio.h>
+
+#include "entities.h"
+
+#ifndef FACT_JOURNAL_BUFFER_SIZE
+#define FACT_JOURNAL_BUFFER_SIZE 512
+#endif
+
+#ifndef FACT_JOURNAL_BATCH_SIZE
+#define FACT_JOURNAL_BATCH_SIZE 64
+#endif
+
+#ifndef FACT_JOURNAL_COMPACT_SIZE
+#define FACT_JOURNAL_COMPACT_SIZE 65536
+#endif
+
+#define FACT_JOURNAL_DATA 65
+
+struct factJournalData
+  {
+   char *fileName;
+   size_t fileNameLength;
+   FILE *filePtr;
+   unsigned char *record;
+   size_t recordLength;
+   size_t recordMax;
+   unsigned long baseSize;
+   unsigned long appendedSize;
+   Fact *modifiedFact;
+   long long modifiedIndex;
+   void **modifiedValues;
+   size_t modifiedMax;
+   bool resetInProgress;
+   bool callbacksAdded;
+  };
+
+#define FactJournalData(theEnv) ((struct factJournalData *) GetEnvironmentData(theEnv,FACT_JOURNAL_DATA))
+
+   void                           FactJournalCommandDefinitions(Environment *);
+   void                           JournalFactsCommand(Environment *,UDFContext *,UDFValue *);
+   void                           CloseFactJournalCommand(Environment *,UDFContext *,UDFValue *);
+   void                           CompactFactJournalCommand(Environment *,UDFContext *,UDFValue *);
+   long                           JournalFacts(Environment *,const char *);
+   bool                           CloseFactJournal(Environment *);
+   bool                           CompactFactJournal(Environment *);
+
+#endif /* _H_factjrnl */
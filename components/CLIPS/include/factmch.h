@@ -52,12 +52,35 @@
 #include "factbld.h"
 #include "factmngr.h"
 
+#if FACT_BATCH_FUNCTIONS
+
+/**************************************************************/
+/* factAlphaMatches: The stop nodes of the pattern network    */
+/*   reached by a fact which has not been asserted yet, in    */
+/*   the order in which FactPatternMatch would reach them.    */
+/**************************************************************/
+struct factAlphaMatches
+  {
+   Fact *theFact;
+   bool serial;
+   struct factPatternNode **nodes;
+   size_t count;
+   size_t max;
+  };
+
+#endif
+
    void                           FactPatternMatch(Environment *,Fact *,
                                                    struct factPatternNode *,size_t,size_t,
                                                    struct multifieldMarker *,
                                                    struct multifieldMarker *);
    void                           MarkFactPatternForIncrementalReset(Environment *,struct patternNodeHeader *,bool);
    void                           FactsIncrementalReset(Environment *);
+   bool                           FactPatternNodeChanged(struct factPatternNode *,const char *);
+#if FACT_BATCH_FUNCTIONS
+   bool                           CollectFactAlphaMatches(Environment *,Fact *,struct factAlphaMatches *);
+   void                           ReplayFactAlphaMatches(Environment *,Fact *,struct factAlphaMatches *);
+#endif
 
 #endif /* _H_factmch */
 
@@ -216,6 +216,10 @@ struct factsData
 #if DEFRULE_CONSTRUCT
    Fact                    *CurrentPatternFact;
    struct multifieldMarker *CurrentPatternMarks;
+   const char              *CurrentPatternChangeMap;
+#if FACT_BATCH_FUNCTIONS
+   struct factAlphaMatches *CurrentAlphaMatches;
+#endif
 #endif
    long LastModuleIndex;
    RetractError retractError;
@@ -230,6 +234,7 @@ struct factsData
    Fact                          *Assert(Fact *);
    AssertStringError              GetAssertStringError(Environment *);
    Fact                          *AssertDriver(Fact *,long long,Fact *,Fact *,char *);
+   void                           InstallRestoredFact(Environment *,Fact *);
    Fact                          *AssertString(Environment *,const char *);
    Fact                          *CreateFact(Deftemplate *);
    void                           ReleaseFact(Fact *);
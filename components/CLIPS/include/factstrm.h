@@ -0,0 +1,54 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*              FACT STREAM HEADER FILE                */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Reads and writes the text format used by the     */
+/*   load-facts and save-facts commands through fixed size   */
+/*   buffers, without building expressions or strings for    */
+/*   the facts.                                              */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_factstrm
+
+#pragma once
+
+#define _H_factstrm
+
+#include <stdio.h>
+
+#include "entities.h"
+
+#ifndef FACT_STREAM_BUFFER_SIZE
+#define FACT_STREAM_BUFFER_SIZE 512
+#endif
+
+typedef struct factStreamWriter FactStreamWriter;
+
+struct factStreamWriter
+  {
+   Environment *fswEnv;
+   FILE *filePtr;
+   size_t position;
+   bool error;
+   char buffer[FACT_STREAM_BUFFER_SIZE];
+  };
+
+   long                           StreamLoadFacts(Environment *,FILE *,const char *,size_t);
+   FactStreamWriter              *CreateFactStreamWriter(Environment *,FILE *);
+   void                           StreamSaveFact(FactStreamWriter *,Fact *);
+   bool                           FlushFactStreamWriter(FactStreamWriter *);
+   bool                           DeleteFactStreamWriter(FactStreamWriter *);
+
+#endif /* _H_factstrm */
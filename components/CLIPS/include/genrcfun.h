@@ -104,6 +104,9 @@ struct defmethod
    unsigned trace : 1;
    RESTRICTION *restrictions;
    Expression *actions;
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   struct lazyConstructBody *lazyBody;
+#endif
   };
 
 struct defgeneric
@@ -65,6 +65,8 @@
 
    bool                           ParseDefgeneric(Environment *,const char *);
    bool                           ParseDefmethod(Environment *,const char *);
+   bool                           ParseLazyMethod(Environment *,Defgeneric *,Defmethod *);
+   bool                           ParseLazyMethods(Environment *,void *);
    Defmethod                     *AddMethod(Environment *,Defgeneric *,Defmethod *,int,unsigned short,Expression *,
                                             unsigned short,unsigned short,CLIPSLexeme *,Expression *,char *,bool);
    void                           PackRestrictionTypes(Environment *,RESTRICTION *,Expression *);
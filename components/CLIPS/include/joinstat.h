@@ -0,0 +1,41 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*             JOIN STATISTICS HEADER FILE             */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Reports the counters kept for each join of the   */
+/*   rules and ranks the joins doing the most work.          */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_joinstat
+
+#pragma once
+
+#define _H_joinstat
+
+#include "entities.h"
+#include "network.h"
+
+#ifndef HOT_JOINS_DEFAULT
+#define HOT_JOINS_DEFAULT 10
+#endif
+
+   void                           JoinStatisticsCommandDefinitions(Environment *);
+   void                           ResetJoinStatistics(struct joinNode *);
+   void                           ListJoinStatistics(Environment *,const char *,Defrule *);
+   void                           ListHotJoins(Environment *,const char *,long long);
+   void                           JoinStatsCommand(Environment *,UDFContext *,UDFValue *);
+   void                           HotJoinsCommand(Environment *,UDFContext *,UDFValue *);
+
+#endif /* _H_joinstat */
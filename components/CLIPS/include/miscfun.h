@@ -94,6 +94,8 @@
    void                           SeedFunction(Environment *,UDFContext *,UDFValue *);
    void                           LengthFunction(Environment *,UDFContext *,UDFValue *);
    void                           ConserveMemCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetPPCaptureCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetPPCaptureCommand(Environment *,UDFContext *,UDFValue *);
    void                           ReleaseMemCommand(Environment *,UDFContext *,UDFValue *);
    void                           MemUsedCommand(Environment *,UDFContext *,UDFValue *);
    void                           MemRequestsCommand(Environment *,UDFContext *,UDFValue *);
@@ -63,6 +63,8 @@
 #include "object.h"
 
    bool             ParseDefmessageHandler(Environment *,const char *);
+   bool             ParseLazyHandler(Environment *,DefmessageHandler *);
+   bool             ParseLazyHandlers(Environment *,void *);
    void             CreateGetAndPutHandlers(Environment *,SlotDescriptor *);
 
 #endif /* OBJECT_SYSTEM && (! BLOAD_ONLY) && (! RUN_TIME) */
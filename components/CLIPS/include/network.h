@@ -35,11 +35,14 @@ struct alphaMemoryHash;
 struct betaMemory;
 struct joinLink;
 struct joinNode;
+struct joinRangeIndex;
 struct patternNodeHashEntry;
 typedef struct patternNodeHeader PatternNodeHeader;
 
 #include "entities.h"
 
+typedef bool JoinTestFunction(Environment *,struct joinNode *);
+
 struct patternNodeHeader
   {
    struct alphaMemoryHash *firstHash;
@@ -97,6 +100,19 @@ struct betaMemory
    struct partialMatch **last;
   };
 
+#if JOIN_STATISTICS
+struct joinStatistics
+  {
+   unsigned long long leftActivations;
+   unsigned long long rightActivations;
+   unsigned long long matchesOut;
+   unsigned long long memoryScans;
+   unsigned long longestScan;
+   unsigned long leftPeak;
+   unsigned long rightPeak;
+  };
+#endif
+
 struct joinLink
   {
    char enterDirection;
@@ -133,6 +149,11 @@ struct joinNode
    struct joinNode *lastLevel;
    struct joinNode *rightMatchNode;
    Defrule *ruleToActivate;
+   struct joinRangeIndex *rangeIndex;
+   JoinTestFunction *networkTestFunction;
+#if JOIN_STATISTICS
+   struct joinStatistics statistics;
+#endif
   };
 
 #endif /* _H_network */
@@ -0,0 +1,43 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*            NUMBER CONVERSION HEADER FILE            */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Converts integers and floats to and from text    */
+/*   without going through the C library's printf and        */
+/*   strtod families for the common cases.                   */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_numconv
+
+#pragma once
+
+#define _H_numconv
+
+#include <stddef.h>
+
+/*=================================================*/
+/* Large enough for any integer or for any float   */
+/* formatted with 15 significant digits.           */
+/*=================================================*/
+
+#define NUMBER_BUFFER_SIZE 32
+
+   size_t                         FormatInteger(long long,char *);
+   size_t                         FormatUnsignedInteger(unsigned long long,char *);
+   size_t                         FormatFloat(double,char *);
+   bool                           ParseInteger(const char *,long long *);
+   double                         ParseFloat(const char *);
+
+#endif /* _H_numconv */
@@ -235,6 +235,9 @@ struct defmessageHandler
    unsigned short maxParams;
    unsigned short localVarCount;
    Expression *actions;
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   struct lazyConstructBody *lazyBody;
+#endif
   };
 
 struct instanceBuilder
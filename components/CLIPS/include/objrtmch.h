@@ -150,6 +150,7 @@ typedef struct objectMatchAction
    void                  SetObjectNetworkPointer(Environment *,OBJECT_PATTERN_NODE *);
    void                  SetObjectNetworkTerminalPointer(Environment *,OBJECT_ALPHA_NODE *);
    void                  ObjectNetworkAction(Environment *,int,Instance *,int);
+   void                  DiscardObjectMatchActions(Environment *);
    void                  ResetObjectMatchTimeTags(Environment *);
 
 #endif /* DEFRULE_CONSTRUCT && OBJECT_SYSTEM */
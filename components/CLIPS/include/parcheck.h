@@ -0,0 +1,34 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*             PARALLEL CHECK HEADER FILE              */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Loads a file of constructs in several threads to */
+/*   report the errors found when the file is loaded.        */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_parcheck
+
+#pragma once
+
+#define _H_parcheck
+
+#include "cstrcpsr.h"
+#include "entities.h"
+
+   void                           ParallelCheckCommandDefinitions(Environment *);
+   void                           CheckConstructsCommand(Environment *,UDFContext *,UDFValue *);
+   LoadError                      CheckConstructs(Environment *,const char *,unsigned int);
+
+#endif /* _H_parcheck */
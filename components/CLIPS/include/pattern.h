@@ -150,6 +150,8 @@ struct patternData
    void                           AddHashedPatternNode(Environment *,void *,void *,unsigned short,void *);
    bool                           RemoveHashedPatternNode(Environment *,void *,void *,unsigned short,void *);
    void                          *FindHashedPatternNode(Environment *,void *,unsigned short,void *);
+   void                           AddHashedPatternNodes(Environment *,void *,void *,struct expr *);
+   void                           RemoveHashedPatternNodes(Environment *,void *,void *,struct expr *);
 
 #endif /* _H_pattern */
 
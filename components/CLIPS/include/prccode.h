@@ -79,6 +79,14 @@ typedef struct ProcParamStack
    struct ProcParamStack *nxt;
   } PROC_PARAM_STACK;
 
+typedef struct
+  {
+   unsigned firstFlag  : 1;
+   unsigned first      : 15;
+   unsigned secondFlag : 1;
+   unsigned second     : 15;
+  } PACKED_PROC_VAR;
+
 #define PROCEDURAL_PRIMITIVE_DATA 37
 
 struct proceduralPrimitiveData
@@ -122,6 +130,11 @@ struct proceduralPrimitiveData
                                                           int (*)(Environment *,Expression *,void *),
                                                           int (*)(Environment *,Expression *,void *),
                                                           unsigned short *,void *);
+   Expression                    *ParseLazyProcActions(Environment *,const char *,Defmodule *,struct lazyConstructBody *,
+                                                       ConstructHeader *,Expression *,
+                                                       int (*)(Environment *,Expression *,void *),
+                                                       int (*)(Environment *,Expression *,void *),
+                                                       unsigned short *,void *);
    int                            ReplaceProcVars(Environment *,const char *,Expression *,Expression *,CLIPSLexeme *,
                                                          int (*)(Environment *,Expression *,void *),void *);
 #if DEFGENERIC_CONSTRUCT
@@ -138,6 +151,8 @@ struct proceduralPrimitiveData
 
    void                           EvaluateProcActions(Environment *,Defmodule *,Expression *,unsigned short,
                                                       UDFValue *,void (*)(Environment *,const char *));
+   void                           EvaluateConstructActions(Environment *,Defmodule *,struct userData **,Expression *,
+                                                           unsigned short,UDFValue *,void (*)(Environment *,const char *));
    void                           PrintProcParamArray(Environment *,const char *);
    void                           GrabProcWildargs(Environment *,UDFValue *,unsigned int);
 
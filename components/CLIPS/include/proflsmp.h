@@ -0,0 +1,57 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*          SAMPLING PROFILER HEADER FILE              */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Samples the executing rule, procedure, function  */
+/*   and join from a periodic timer into a fixed histogram.  */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_proflsmp
+
+#pragma once
+
+#define _H_proflsmp
+
+#include "entities.h"
+
+#define PROFILE_SAMPLE_DATA 68
+
+#ifndef PROFILE_SAMPLE_SLOTS
+#define PROFILE_SAMPLE_SLOTS 512
+#endif
+
+#ifndef PROFILE_SAMPLE_INTERVAL
+#define PROFILE_SAMPLE_INTERVAL 1000
+#endif
+
+#define PROFILE_SAMPLE_MINIMUM 100
+
+   void                           ProfileSamplingDefinitions(Environment *);
+   bool                           StartProfileSampling(Environment *);
+   void                           StopProfileSampling(Environment *);
+   bool                           ProfileSamplingActive(Environment *);
+   void                           ResetProfileSamples(Environment *);
+   void                           OutputProfileSamples(Environment *,const char *,long long);
+   long                           SetProfileSampleInterval(Environment *,long);
+   long                           GetProfileSampleInterval(Environment *);
+   void                           ProfileSamplesCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetProfileSampleIntervalCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetProfileSampleIntervalCommand(Environment *,UDFContext *,UDFValue *);
+#if (LINUX || DARWIN) && (! defined(ESP_PLATFORM))
+   bool                           SaveProfileSamples(Environment *,const char *);
+   void                           SaveProfileSamplesCommand(Environment *,UDFContext *,UDFValue *);
+#endif
+
+#endif /* _H_proflsmp */
@@ -0,0 +1,106 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*              RANGE MEMORY HEADER FILE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Provides sorted (range) indices over the left    */
+/*   and right memories of joins whose tests compare a       */
+/*   numeric value from the RHS pattern against numeric      */
+/*   values from the LHS patterns.                           */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_rangemem
+
+#pragma once
+
+#define _H_rangemem
+
+struct joinRangeIndex;
+struct rangeEntry;
+struct rangeMemory;
+
+#include "expressn.h"
+#include "match.h"
+#include "network.h"
+
+/*****************************************************/
+/* rangeEntry: A partial match stored in a range     */
+/*   memory. The group is the hash value (left side) */
+/*   or the alpha memory bucket (right side) of the  */
+/*   partial match. Only entries in the group of the */
+/*   entering partial match are compared. The order  */
+/*   preserves the position of the partial match in  */
+/*   the memory it indexes.                          */
+/*****************************************************/
+struct rangeEntry
+  {
+   unsigned long group;
+   double key;
+   long long order;
+   struct partialMatch *theMatch;
+  };
+
+/*****************************************************/
+/* rangeMemory: The entries with a numeric key are   */
+/*   kept sorted by group and key. Entries for which */
+/*   the key is not a number are kept unsorted and   */
+/*   are always compared.                            */
+/*****************************************************/
+struct rangeMemory
+  {
+   bool built;
+   unsigned long count;
+   unsigned long size;
+   struct rangeEntry *entries;
+   unsigned long unkeyedCount;
+   unsigned long unkeyedSize;
+   struct rangeEntry *unkeyed;
+   long long firstOrder;
+   long long lastOrder;
+  };
+
+/*****************************************************/
+/* joinRangeIndex: The key of the RHS pattern is     */
+/*   compared against a lower and/or upper bound     */
+/*   computed from the LHS patterns. The left memory */
+/*   is sorted on the bound which appears first in   */
+/*   the join network test.                          */
+/*****************************************************/
+struct joinRangeIndex
+  {
+   Expression *rightKey;
+   Expression *lowerBound;
+   Expression *upperBound;
+   Expression *leftKey;
+   bool leftKeyIsLower;
+   struct rangeMemory leftMemory;
+   struct rangeMemory rightMemory;
+  };
+
+#ifndef RANGE_MEMORY_THRESHOLD
+#define RANGE_MEMORY_THRESHOLD 16
+#endif
+
+   struct joinRangeIndex         *CreateJoinRangeIndex(Environment *,struct joinNode *);
+   void                           ReturnJoinRangeIndex(Environment *,struct joinNode *);
+   void                           ReleaseJoinRangeMemories(Environment *,struct joinNode *);
+   void                           AddToLeftRangeMemory(Environment *,struct joinNode *,struct partialMatch *);
+   void                           RemoveFromLeftRangeMemory(Environment *,struct joinNode *,struct partialMatch *);
+   void                           AddToRightRangeMemories(Environment *,struct patternNodeHeader *,struct partialMatch *);
+   void                           RemoveFromRightRangeMemories(Environment *,struct patternNodeHeader *,struct partialMatch *);
+   bool                           GetRangeMemoryCandidates(Environment *,struct joinNode *,struct partialMatch *,int,
+                                                           struct rangeEntry **,unsigned long *);
+   void                           ReturnRangeMemoryCandidates(Environment *,struct rangeEntry *,unsigned long);
+
+#endif /* _H_rangemem */
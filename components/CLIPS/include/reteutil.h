@@ -89,6 +89,7 @@
    struct multifieldMarker       *CopyMultifieldMarkers(Environment *,struct multifieldMarker *);
    struct partialMatch           *CreateAlphaMatch(Environment *,void *,struct multifieldMarker *,
                                                           struct patternNodeHeader *,unsigned long);
+   void                           StoreAlphaMatch(Environment *,struct partialMatch *,struct patternNodeHeader *);
    void                           TraceErrorToRule(Environment *,struct joinNode *,const char *);
    void                           InitializePatternHeader(Environment *,struct patternNodeHeader *);
    void                           MarkRuleNetwork(Environment *,bool);
@@ -87,6 +87,16 @@ extern const char *STDWRN;
 
 #define ROUTER_DATA 46
 
+#ifndef LOGICAL_NAME_CACHE_SIZE
+#define LOGICAL_NAME_CACHE_SIZE 8
+#endif
+
+#define STDIN_ID 0
+#define STDOUT_ID 1
+#define STDERR_ID 2
+#define STDWRN_ID 3
+#define FIRST_LOGICAL_NAME_ID 4
+
 struct router
   {
    const char *name;
@@ -101,6 +111,18 @@ struct router
    Router *next;
   };
 
+struct logicalNameEntry
+  {
+   const char *name;
+   size_t nameSize;
+   unsigned long generation;
+   unsigned char resolved;
+   struct router *queryRouter;
+   struct router *writeRouter;
+   struct router *readRouter;
+   struct router *unreadRouter;
+  };
+
 struct routerData
   {
    size_t CommandBufferInputCount;
@@ -114,6 +136,10 @@ struct routerData
    FILE *FastLoadFilePtr;
    FILE *FastSaveFilePtr;
    bool Abort;
+   struct logicalNameEntry LogicalNames[LOGICAL_NAME_CACHE_SIZE];
+   unsigned short NextLogicalName;
+   unsigned long LogicalNameInsertions;
+   unsigned long RouterGeneration;
   };
 
 #define RouterData(theEnv) ((struct routerData *) GetEnvironmentData(theEnv,ROUTER_DATA))
@@ -124,6 +150,8 @@ struct routerData
    void                           Writeln(Environment *,const char *);
    int                            ReadRouter(Environment *,const char *);
    int                            UnreadRouter(Environment *,const char *,int);
+   const char                    *ReadRouterSpan(Environment *,const char *,size_t *);
+   void                           AdvanceRouterSpan(Environment *,const char *,const char *,size_t);
    void                           ExitRouter(Environment *,int);
    void                           AbortExit(Environment *);
    bool                           AddRouter(Environment *,const char *,int,
@@ -132,6 +160,8 @@ struct routerData
                                             RouterExitFunction *,void *);
    bool                           DeleteRouter(Environment *,const char *);
    bool                           QueryRouters(Environment *,const char *);
+   unsigned short                 LogicalNameID(Environment *,const char *);
+   void                           InvalidateRouterCache(Environment *);
    bool                           DeactivateRouter(Environment *,const char *);
    bool                           ActivateRouter(Environment *,const char *);
    void                           SetFastLoad(Environment *,FILE *);
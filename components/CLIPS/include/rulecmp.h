@@ -52,6 +52,7 @@
 
 #define JoinPrefix() ArbitraryPrefix(DefruleData(theEnv)->DefruleCodeItem,2)
 #define LinkPrefix() ArbitraryPrefix(DefruleData(theEnv)->DefruleCodeItem,3)
+#define JoinTestPrefix() ArbitraryPrefix(DefruleData(theEnv)->DefruleCodeItem,4)
 
    void                     DefruleCompilerSetup(Environment *);
    void                     DefruleCModuleReference(Environment *,FILE *,unsigned long,unsigned int,unsigned int);
@@ -92,6 +92,10 @@ typedef enum
    bool                           SetBetaMemoryResizing(Environment *,bool);
    void                           GetBetaMemoryResizingCommand(Environment *,UDFContext *,UDFValue *);
    void                           SetBetaMemoryResizingCommand(Environment *,UDFContext *,UDFValue *);
+   bool                           GetJoinRangeMemories(Environment *);
+   bool                           SetJoinRangeMemories(Environment *,bool);
+   void                           GetJoinRangeMemoriesCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetJoinRangeMemoriesCommand(Environment *,UDFContext *,UDFValue *);
    void                           Matches(Defrule *,Verbosity,CLIPSValue *);
    void                           JoinActivity(Environment *,Defrule *,int,UDFValue *);
    void                           DefruleCommands(Environment *);
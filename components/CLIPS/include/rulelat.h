@@ -0,0 +1,74 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*              RULE LATENCY HEADER FILE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Keeps a log-linear histogram of the time taken   */
+/*   by the firings of each rule and reports its             */
+/*   percentiles.                                            */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_rulelat
+
+#pragma once
+
+#define _H_rulelat
+
+#include "entities.h"
+#include "userdata.h"
+
+/*==========================================================*/
+/* Latencies below LATENCY_SUB_BUCKETS microseconds have a  */
+/* bucket each. Above them, each power of two is split into */
+/* LATENCY_SUB_BUCKETS / 2 buckets, so a recorded latency   */
+/* is within 1/8 of its bucket's value, up to 2^33 us.      */
+/*==========================================================*/
+
+#define LATENCY_SUB_BUCKETS 16
+#define LATENCY_BUCKETS 248
+
+struct ruleLatencyInfo
+  {
+   struct userData usrData;
+   unsigned long long count;
+   unsigned long long total;
+   unsigned long long maximum;
+   unsigned long buckets[LATENCY_BUCKETS];
+  };
+
+#define RULE_LATENCY_DATA 69
+
+struct ruleLatencyData
+  {
+   bool Tracking;
+   unsigned char LatencyDataID;
+   struct userDataRecord LatencyDataInfo;
+  };
+
+#define RuleLatencyData(theEnv) ((struct ruleLatencyData *) GetEnvironmentData(theEnv,RULE_LATENCY_DATA))
+
+   void                           RuleLatencyDefinitions(Environment *);
+   void                           RecordRuleLatency(Environment *,Defrule *,long long);
+   long long                      RuleLatencyPercentile(Environment *,Defrule *,double);
+   void                           ListRuleLatency(Environment *,const char *,Defrule *);
+   void                           ResetRuleLatency(Environment *);
+   bool                           SetRuleLatencyTracking(Environment *,bool);
+   bool                           GetRuleLatencyTracking(Environment *);
+   void                           RuleLatencyCommand(Environment *,UDFContext *,UDFValue *);
+   void                           RuleLatencyPercentileCommand(Environment *,UDFContext *,UDFValue *);
+   void                           RuleLatencyResetCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetRuleLatencyTrackingCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetRuleLatencyTrackingCommand(Environment *,UDFContext *,UDFValue *);
+
+#endif /* _H_rulelat */
@@ -84,6 +84,15 @@ struct token
 
 #define SCANNER_DATA 57
 
+/*=========================================================*/
+/* Character classes used to scan spans of input directly. */
+/*=========================================================*/
+
+#define WHITE_SPACE_CLASS 0x01
+#define COMMENT_CLASS     0x02
+#define SYMBOL_CLASS      0x04
+#define STRING_CLASS      0x08
+
 struct scannerData
   {
    char *GlobalString;
@@ -91,6 +100,7 @@ struct scannerData
    size_t GlobalPos;
    long LineCount;
    bool IgnoreCompletionErrors;
+   unsigned char CharacterClass[256];
   };
 
 #define ScannerData(theEnv) ((struct scannerData *) GetEnvironmentData(theEnv,SCANNER_DATA))
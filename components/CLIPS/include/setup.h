@@ -375,6 +375,105 @@
 #define BLOAD_AND_BSAVE 0
 #endif
 
+/*****************************************************************/
+/* SNAPSHOT_FUNCTIONS: Enables the save-snapshot and             */
+/*   load-snapshot commands which save the constructs and the    */
+/*   working memory (facts, instances, partial matches, agenda   */
+/*   and focus stack) and restore them without pattern matching. */
+/*****************************************************************/
+
+#ifndef SNAPSHOT_FUNCTIONS
+#define SNAPSHOT_FUNCTIONS 1
+#endif
+
+#if (! BLOAD_AND_BSAVE) || (! DEFRULE_CONSTRUCT) || (! DEFTEMPLATE_CONSTRUCT)
+#undef SNAPSHOT_FUNCTIONS
+#define SNAPSHOT_FUNCTIONS 0
+#endif
+
+/*****************************************************************/
+/* FACT_JOURNAL_FUNCTIONS: Enables the journal-facts,            */
+/*   close-fact-journal, and compact-fact-journal commands which */
+/*   log the changes made to the fact-list to a file as they are */
+/*   made and restore the facts from it after a restart.         */
+/*****************************************************************/
+
+#ifndef FACT_JOURNAL_FUNCTIONS
+#define FACT_JOURNAL_FUNCTIONS 1
+#endif
+
+#if (! DEFRULE_CONSTRUCT) || (! DEFTEMPLATE_CONSTRUCT)
+#undef FACT_JOURNAL_FUNCTIONS
+#define FACT_JOURNAL_FUNCTIONS 0
+#endif
+
+/*****************************************************************/
+/* PARALLEL_CHECK_FUNCTIONS: Enables the check-constructs        */
+/*   command which loads a file of constructs in several threads */
+/*   to report the errors found when it is loaded. Requires the  */
+/*   POSIX threads library, so it is only enabled by default on  */
+/*   hosts (the ESP-IDF build also defines LINUX).               */
+/*****************************************************************/
+
+#ifndef PARALLEL_CHECK_FUNCTIONS
+#if (LINUX || DARWIN) && (! defined(ESP_PLATFORM))
+#define PARALLEL_CHECK_FUNCTIONS 1
+#else
+#define PARALLEL_CHECK_FUNCTIONS 0
+#endif
+#endif
+
+#if RUN_TIME || BLOAD_ONLY
+#undef PARALLEL_CHECK_FUNCTIONS
+#define PARALLEL_CHECK_FUNCTIONS 0
+#endif
+
+/*****************************************************************/
+/* ENVIRONMENT_POOL_FUNCTIONS: Enables the environment pool API  */
+/*   which runs several environments loaded from the same bsave  */
+/*   image in threads pinned to the available cores. Requires    */
+/*   the POSIX threads library (provided by ESP-IDF).            */
+/*****************************************************************/
+
+#ifndef ENVIRONMENT_POOL_FUNCTIONS
+#define ENVIRONMENT_POOL_FUNCTIONS (LINUX || DARWIN)
+#endif
+
+#if RUN_TIME || (! DEFRULE_CONSTRUCT) || (! DEFTEMPLATE_CONSTRUCT)
+#undef ENVIRONMENT_POOL_FUNCTIONS
+#define ENVIRONMENT_POOL_FUNCTIONS 0
+#endif
+
+/*****************************************************************/
+/* FACT_BATCH_FUNCTIONS: Enables the AssertFactBatch function    */
+/*   (used by load-facts) which matches the facts of a batch     */
+/*   against the fact pattern network in several threads before  */
+/*   asserting them. Requires the POSIX threads library          */
+/*   (provided by ESP-IDF).                                      */
+/*****************************************************************/
+
+#ifndef FACT_BATCH_FUNCTIONS
+#define FACT_BATCH_FUNCTIONS (LINUX || DARWIN)
+#endif
+
+#if (! DEFRULE_CONSTRUCT) || (! DEFTEMPLATE_CONSTRUCT)
+#undef FACT_BATCH_FUNCTIONS
+#define FACT_BATCH_FUNCTIONS 0
+#endif
+
+/*****************************************************************/
+/* BUFFERED_ROUTER_FUNCTIONS: Enables output routers which keep  */
+/*   the fragments written to them in a ring buffer and pass     */
+/*   them to a sink function in bulk, along with the             */
+/*   buffered-output-stats and set-buffered-output-policy        */
+/*   commands (and open-buffered-output and                      */
+/*   close-buffered-output, which write to a file, on hosts).    */
+/*****************************************************************/
+
+#ifndef BUFFERED_ROUTER_FUNCTIONS
+#define BUFFERED_ROUTER_FUNCTIONS 1
+#endif
+
 /********************************************************************/
 /* CONSTRUCT COMPILER: If this flag is turned on, you can generate  */
 /*   C code representing the constructs in the current environment. */
@@ -437,6 +536,86 @@
 #define PROFILING_FUNCTIONS 1
 #endif
 
+/*****************************************************************/
+/* PROFILE_SAMPLING_FUNCTIONS: Enables the samples mode of the   */
+/*   profile command, which counts the executing rule,           */
+/*   procedure, function and join from a periodic timer instead  */
+/*   of timing every call, along with the profile-samples,       */
+/*   set-profile-sample-interval and get-profile-sample-interval */
+/*   commands (and save-profile-samples, which writes collapsed  */
+/*   stacks to a file, on hosts).                                */
+/*****************************************************************/
+
+#ifndef PROFILE_SAMPLING_FUNCTIONS
+#define PROFILE_SAMPLING_FUNCTIONS (LINUX || DARWIN)
+#endif
+
+#if ! PROFILING_FUNCTIONS
+#undef PROFILE_SAMPLING_FUNCTIONS
+#define PROFILE_SAMPLING_FUNCTIONS 0
+#endif
+
+/*****************************************************************/
+/* JOIN_STATISTICS: Keeps counters for each join of the rules    */
+/*   (activations entering from each side, partial matches sent  */
+/*   on, scans of the opposite memory and peak memory sizes),    */
+/*   along with the join-stats and hot-joins commands. The       */
+/*   counters are updated on every join activation, so they are  */
+/*   off by default.                                             */
+/*****************************************************************/
+
+#ifndef JOIN_STATISTICS
+#define JOIN_STATISTICS 0
+#endif
+
+#if ! DEFRULE_CONSTRUCT
+#undef JOIN_STATISTICS
+#define JOIN_STATISTICS 0
+#endif
+
+/*****************************************************************/
+/* RULE_LATENCY_FUNCTIONS: Keeps a histogram of the time taken   */
+/*   by each firing of a rule, along with the rule-latency,      */
+/*   rule-latency-percentile, rule-latency-reset and             */
+/*   set-/get-rule-latency-tracking commands.                    */
+/*****************************************************************/
+
+#ifndef RULE_LATENCY_FUNCTIONS
+#define RULE_LATENCY_FUNCTIONS 1
+#endif
+
+#if ! DEFRULE_CONSTRUCT
+#undef RULE_LATENCY_FUNCTIONS
+#define RULE_LATENCY_FUNCTIONS 0
+#endif
+
+/*****************************************************************/
+/* EVENT_TRACE_FUNCTIONS: Records fact assertions and            */
+/*   retractions, activations and rule firings as binary records */
+/*   in a ring buffer, along with the event-trace,               */
+/*   event-trace-reset and set-/get-event-tracing commands.      */
+/*****************************************************************/
+
+#ifndef EVENT_TRACE_FUNCTIONS
+#define EVENT_TRACE_FUNCTIONS 1
+#endif
+
+#if (! DEFRULE_CONSTRUCT) || (! DEFTEMPLATE_CONSTRUCT)
+#undef EVENT_TRACE_FUNCTIONS
+#define EVENT_TRACE_FUNCTIONS 0
+#endif
+
+/*****************************************************************/
+/* EXPRESSION_BYTECODE: Compiles the actions of deffunctions,    */
+/*   methods, message-handlers and rules into bytecode run by a  */
+/*   stack machine, along with the set-/get-bytecode-execution   */
+/*   commands.                                                   */
+/*****************************************************************/
+
+#ifndef EXPRESSION_BYTECODE
+#define EXPRESSION_BYTECODE 1
+#endif
+
 /******************************************************/
 /* SYSTEM_FUNCTION: Enables code for system function. */
 /******************************************************/
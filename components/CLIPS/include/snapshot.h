@@ -0,0 +1,37 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                SNAPSHOT HEADER FILE                 */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Saves the constructs and the working memory of   */
+/*   an environment (facts, instances, partial matches,      */
+/*   agenda and focus stack) to a file and restores them     */
+/*   without pattern matching.                               */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_snapshot
+
+#pragma once
+
+#define _H_snapshot
+
+#include "entities.h"
+
+   void                           SnapshotCommandDefinitions(Environment *);
+   void                           SaveSnapshotCommand(Environment *,UDFContext *,UDFValue *);
+   void                           LoadSnapshotCommand(Environment *,UDFContext *,UDFValue *);
+   bool                           SaveSnapshot(Environment *,const char *);
+   bool                           LoadSnapshot(Environment *,const char *);
+
+#endif /* _H_snapshot */
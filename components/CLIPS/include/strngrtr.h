@@ -87,6 +87,8 @@ struct stringRouterData
    bool                           OpenStringSource(Environment *,const char *,const char *,size_t);
    bool                           OpenTextSource(Environment *,const char *,const char *,size_t,size_t);
    bool                           CloseStringSource(Environment *,const char *);
+   const char                    *StringRouterSpan(Environment *,struct router *,const char *,size_t *);
+   void                           AdvanceStringRouter(Environment *,const char *,size_t);
    bool                           OpenStringDestination(Environment *,const char *,char *,size_t);
    bool                           CloseStringDestination(Environment *,const char *);
    bool                           OpenStringBuilderDestination(Environment *,const char *,StringBuilder *);
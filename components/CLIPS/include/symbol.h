@@ -148,11 +148,29 @@ struct symbolMatch
    struct symbolMatch *next;
   };
 
-#define IncrementLexemeCount(theValue) (((CLIPSLexeme *) theValue)->count++)
-#define IncrementFloatCount(theValue) (((CLIPSFloat *) theValue)->count++)
-#define IncrementIntegerCount(theValue) (((CLIPSInteger *) theValue)->count++)
-#define IncrementBitMapCount(theValue) (((CLIPSBitMap *) theValue)->count++)
-#define IncrementExternalAddressCount(theValue) (((CLIPSExternalAddress *) theValue)->count++)
+/********************************************************/
+/* sharedAtomBase: A frozen copy of the atoms used by a */
+/*   template environment. Environments created with it */
+/*   look atoms up here before their own hash tables.   */
+/*   The shared atoms are permanent, so their counts    */
+/*   are never changed and they are never ephemeral.    */
+/********************************************************/
+typedef struct sharedAtomBase SharedAtomBase;
+
+struct sharedAtomBase
+  {
+   CLIPSLexeme **SymbolTable;
+   CLIPSFloat **FloatTable;
+   CLIPSInteger **IntegerTable;
+   CLIPSBitMap **BitMapTable;
+   unsigned long atomCount;
+  };
+
+#define IncrementLexemeCount(theValue) ((((CLIPSLexeme *) theValue)->permanent) ? 0 : ((CLIPSLexeme *) theValue)->count++)
+#define IncrementFloatCount(theValue) ((((CLIPSFloat *) theValue)->permanent) ? 0 : ((CLIPSFloat *) theValue)->count++)
+#define IncrementIntegerCount(theValue) ((((CLIPSInteger *) theValue)->permanent) ? 0 : ((CLIPSInteger *) theValue)->count++)
+#define IncrementBitMapCount(theValue) ((((CLIPSBitMap *) theValue)->permanent) ? 0 : ((CLIPSBitMap *) theValue)->count++)
+#define IncrementExternalAddressCount(theValue) ((((CLIPSExternalAddress *) theValue)->permanent) ? 0 : ((CLIPSExternalAddress *) theValue)->count++)
 
 /*==================*/
 /* ENVIRONMENT DATA */
@@ -170,6 +188,7 @@ struct symbolData
    CLIPSInteger **IntegerTable;
    CLIPSBitMap **BitMapTable;
    CLIPSExternalAddress **ExternalAddressTable;
+   SharedAtomBase *SharedBase;
 #if BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE || BLOAD_INSTANCES || BSAVE_INSTANCES
    unsigned long NumberOfSymbols;
    unsigned long NumberOfFloats;
@@ -188,7 +207,7 @@ struct symbolData
 
    void                           InitializeAtomTables(Environment *,CLIPSLexeme **,CLIPSFloat **,
                                                               CLIPSInteger **,CLIPSBitMap **,
-                                                              CLIPSExternalAddress **);
+                                                              CLIPSExternalAddress **,SharedAtomBase *);
    CLIPSLexeme                   *AddSymbol(Environment *,const char *,unsigned short);
    CLIPSLexeme                   *FindSymbolHN(Environment *,const char *,unsigned short);
    CLIPSFloat                    *CreateFloat(Environment *,double);
@@ -236,6 +255,9 @@ struct symbolData
    CLIPSLexeme                   *CreateInstanceName(Environment *,const char *);
    CLIPSLexeme                   *CreateBoolean(Environment *,bool);
    bool                           BitStringHasBitsSet(void *,unsigned);
+   SharedAtomBase                *CreateSharedAtomBase(Environment *);
+   void                           DestroySharedAtomBase(SharedAtomBase *);
+   bool                           SharedAtomBaseError(Environment *,const char *);
 
 #endif /* _H_symbol */
 
@@ -118,6 +118,7 @@
 #include <setjmp.h>
 
    double                      gentime(void);
+   long long                   genmicrotime(void);
 #if SYSTEM_FUNCTION
    int                         gensystem(Environment *,const char *);
 #endif
@@ -127,6 +128,8 @@
    void                        GenTellBinary(Environment *,long *);
    void                        GenCloseBinary(Environment *);
    size_t                      GenReadBinary(Environment *,void *,size_t);
+   bool                        GenOpenReadBinaryImage(Environment *,const void *,size_t);
+   const void                 *GenReadBinaryInPlace(Environment *,size_t,size_t);
    FILE                       *GenOpen(Environment *,const char *,const char *);
    int                         GenClose(Environment *,FILE *);
    int                         GenFlush(Environment *,FILE *);
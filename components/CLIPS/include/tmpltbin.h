@@ -48,6 +48,7 @@ struct bsaveTemplateSlot
    unsigned int noDefault : 1;
    unsigned int defaultPresent : 1;
    unsigned int defaultDynamic : 1;
+   unsigned int patternReferenced : 1;
    unsigned long constraints;
    unsigned long defaultList;
    unsigned long facetList;
@@ -64,6 +65,7 @@ struct bsaveDeftemplate
    struct bsaveConstructHeader header;
    unsigned long slotList;
    unsigned int implied : 1;
+   unsigned int slotSpecific : 1;
    unsigned int numberOfSlots : 15;
    unsigned long patternNetwork;
   };
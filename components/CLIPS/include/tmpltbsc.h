@@ -71,6 +71,10 @@
    void                           GetDeftemplateListFunction(Environment *,UDFContext *,UDFValue *);
    void                           GetDeftemplateList(Environment *,CLIPSValue *,Defmodule *);
    void                           DeftemplateModuleFunction(Environment *,UDFContext *,UDFValue *);
+   void                           GetDeftemplateSlotSpecificCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetDeftemplateSlotSpecificCommand(Environment *,UDFContext *,UDFValue *);
+   bool                           DeftemplateGetSlotSpecific(Deftemplate *);
+   void                           DeftemplateSetSlotSpecific(Deftemplate *,bool);
 #if DEBUGGING_FUNCTIONS
    void                           PPDeftemplateCommand(Environment *,UDFContext *,UDFValue *);
    bool                           PPDeftemplate(Environment *,const char *,const char *);
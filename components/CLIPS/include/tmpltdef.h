@@ -91,6 +91,7 @@ struct deftemplate
    unsigned int implied       : 1;
    unsigned int watch         : 1;
    unsigned int inScope       : 1;
+   unsigned int slotSpecific  : 1;
    unsigned short numberOfSlots;
    long busyCount;
    struct factPatternNode *patternNetwork;
@@ -105,6 +106,7 @@ struct templateSlot
    unsigned int noDefault : 1;
    unsigned int defaultPresent : 1;
    unsigned int defaultDynamic : 1;
+   unsigned int patternReferenced : 1;
    CONSTRAINT_RECORD *constraints;
    Expression *defaultList;
    Expression *facetList;
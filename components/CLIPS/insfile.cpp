@@ -110,6 +110,7 @@
 #include "router.h"
 #include "strngrtr.h"
 #include "symblbin.h"
+#include "symbol.h"
 #include "sysdep.h"
 #include "utility.h"
 
@@ -657,6 +658,9 @@ long BinarySaveInstancesDriver(
    if (EvaluationData(theEnv)->CurrentExpression == NULL)
      { ResetErrorFlags(theEnv); }
 
+   if (SharedAtomBaseError(theEnv,"bsave-instances"))
+     { return -1L; }
+
    classList = ProcessSaveClassList(theEnv,"bsave-instances",classExpressionList,
                                     saveCode,inheritFlag);
    if ((classList == NULL) && (classExpressionList != NULL))
@@ -128,6 +128,9 @@
 #include <string.h>
 
 #include "argacces.h"
+#if BUFFERED_ROUTER_FUNCTIONS
+#include "bufrtr.h"
+#endif
 #include "commline.h"
 #include "constant.h"
 #include "envrnmnt.h"
@@ -747,6 +750,7 @@ void FlushFunction(
   UDFValue *returnValue)
   {
    const char *logicalName;
+   bool flushed;
 
    /*=====================================================*/
    /* If no arguments are specified, then flush all files */
@@ -756,6 +760,9 @@ void FlushFunction(
 
    if (! UDFHasNextArgument(context))
      {
+#if BUFFERED_ROUTER_FUNCTIONS
+      FlushAllBufferedRouters(theEnv);
+#endif
       returnValue->lexemeValue = CreateBoolean(theEnv,FlushAllFiles(theEnv));
       return;
      }
@@ -780,7 +787,15 @@ void FlushFunction(
    /* otherwise false.                                        */
    /*=========================================================*/
 
-   returnValue->lexemeValue = CreateBoolean(theEnv,FlushFile(theEnv,logicalName));
+#if BUFFERED_ROUTER_FUNCTIONS
+   flushed = FlushBufferedOutput(theEnv,logicalName);
+   if (FlushFile(theEnv,logicalName))
+     { flushed = true; }
+#else
+   flushed = FlushFile(theEnv,logicalName);
+#endif
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,flushed);
   }
 
 /***************************************************************/
@@ -0,0 +1,528 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                JOIN STATISTICS MODULE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Reports the counters kept for each join of the   */
+/*   rules and ranks the joins doing the most work.          */
+/*                                                           */
+/*   The counters are updated by the join network as         */
+/*   partial matches enter a join from either side, are      */
+/*   sent on to the joins below it, and are compared with    */
+/*   the partial matches in the opposite memory. The number  */
+/*   of compares divided by the number of scans gives the    */
+/*   average length of the hash bucket scanned for each      */
+/*   partial match entering the join.                        */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if JOIN_STATISTICS
+
+#include "argacces.h"
+#include "envrnmnt.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "moduldef.h"
+#include "prntutil.h"
+#include "router.h"
+#include "ruledef.h"
+#include "sysdep.h"
+
+#include "joinstat.h"
+
+struct joinEntry
+  {
+   struct joinNode *join;
+   Defrule *rule;
+   int disjunct;
+  };
+
+struct joinList
+  {
+   struct joinEntry *entries;
+   size_t count;
+   size_t size;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    AddRuleJoins(Environment *,struct joinList *,Defrule *,Defrule *,int);
+   static void                    FreeJoinList(Environment *,struct joinList *);
+   static void                    ListJoinEntry(Environment *,const char *,struct joinNode *);
+   static unsigned long           RightMemoryCount(struct joinNode *);
+   static double                  AverageScanLength(struct joinNode *);
+   static int                     CompareJoinAddresses(const void *,const void *);
+   static int                     CompareJoinActivity(const void *,const void *);
+
+/**********************************************************/
+/* JoinStatisticsCommandDefinitions: Initializes the join */
+/*   statistics commands.                                 */
+/**********************************************************/
+void JoinStatisticsCommandDefinitions(
+  Environment *theEnv)
+  {
+#if ! RUN_TIME
+   AddUDF(theEnv,"join-stats","b",1,1,"y",JoinStatsCommand,"JoinStatsCommand",NULL);
+   AddUDF(theEnv,"hot-joins","v",0,1,"l",HotJoinsCommand,"HotJoinsCommand",NULL);
+#else
+#if MAC_XCD
+#pragma unused(theEnv)
+#endif
+#endif
+  }
+
+/*****************************************************/
+/* ResetJoinStatistics: Sets the counters of a join  */
+/*   back to 0. The peak memory sizes start again    */
+/*   from the current sizes.                         */
+/*****************************************************/
+void ResetJoinStatistics(
+  struct joinNode *theJoin)
+  {
+   memset(&theJoin->statistics,0,sizeof(struct joinStatistics));
+
+   if (theJoin->leftMemory != NULL)
+     { theJoin->statistics.leftPeak = theJoin->leftMemory->count; }
+
+   if (theJoin->joinFromTheRight && (theJoin->rightMemory != NULL))
+     { theJoin->statistics.rightPeak = theJoin->rightMemory->count; }
+  }
+
+/**********************************************************/
+/* AddRuleJoins: Adds the joins of a rule disjunct to a   */
+/*   list, from the last to the first, following the      */
+/*   joins of not/and groups from the right in the same   */
+/*   way as join-activity-reset. The disjunct number is   */
+/*   0 for a rule without disjuncts.                      */
+/**********************************************************/
+static void AddRuleJoins(
+  Environment *theEnv,
+  struct joinList *theList,
+  Defrule *theDisjunct,
+  Defrule *theRule,
+  int disjunctIndex)
+  {
+   struct joinNode *theJoin;
+   struct joinEntry *newEntries;
+   size_t newSize;
+
+   theJoin = theDisjunct->lastJoin;
+
+   while (theJoin != NULL)
+     {
+      if (theList->count == theList->size)
+        {
+         newSize = (theList->size == 0) ? 16 : (theList->size * 2);
+         newEntries = (struct joinEntry *) genalloc(theEnv,sizeof(struct joinEntry) * newSize);
+         if (theList->entries != NULL)
+           {
+            memcpy(newEntries,theList->entries,sizeof(struct joinEntry) * theList->count);
+            genfree(theEnv,theList->entries,sizeof(struct joinEntry) * theList->size);
+           }
+         theList->entries = newEntries;
+         theList->size = newSize;
+        }
+
+      theList->entries[theList->count].join = theJoin;
+      theList->entries[theList->count].rule = theRule;
+      theList->entries[theList->count].disjunct = disjunctIndex;
+      theList->count++;
+
+      if (theJoin->joinFromTheRight)
+        { theJoin = (struct joinNode *) theJoin->rightSideEntryStructure; }
+      else
+        { theJoin = theJoin->lastLevel; }
+     }
+  }
+
+/**************************************************/
+/* FreeJoinList: Returns the memory of a list of  */
+/*   joins.                                       */
+/**************************************************/
+static void FreeJoinList(
+  Environment *theEnv,
+  struct joinList *theList)
+  {
+   if (theList->entries != NULL)
+     { genfree(theEnv,theList->entries,sizeof(struct joinEntry) * theList->size); }
+
+   theList->entries = NULL;
+   theList->count = 0;
+   theList->size = 0;
+  }
+
+/**********************************************************/
+/* RightMemoryCount: Returns the number of partial        */
+/*   matches in the right memory of a join. A join        */
+/*   entered from a pattern uses the pattern's alpha      */
+/*   memory, which is counted bucket by bucket.           */
+/**********************************************************/
+static unsigned long RightMemoryCount(
+  struct joinNode *theJoin)
+  {
+   struct alphaMemoryHash *theHash;
+   struct partialMatch *theMatch;
+   unsigned long count = 0;
+
+   if (theJoin->joinFromTheRight || (theJoin->rightSideEntryStructure == NULL))
+     {
+      if (theJoin->rightMemory == NULL)
+        { return 0; }
+      return theJoin->rightMemory->count;
+     }
+
+   for (theHash = ((struct patternNodeHeader *) theJoin->rightSideEntryStructure)->firstHash;
+        theHash != NULL;
+        theHash = theHash->nextHash)
+     {
+      for (theMatch = theHash->alphaMemory;
+           theMatch != NULL;
+           theMatch = theMatch->nextInMemory)
+        { count++; }
+     }
+
+   return count;
+  }
+
+/*****************************************************/
+/* AverageScanLength: Returns the average number of  */
+/*   partial matches compared for each scan of the   */
+/*   opposite memory of a join.                      */
+/*****************************************************/
+static double AverageScanLength(
+  struct joinNode *theJoin)
+  {
+   if (theJoin->statistics.memoryScans == 0)
+     { return 0.0; }
+
+   return (double) theJoin->memoryCompares / (double) theJoin->statistics.memoryScans;
+  }
+
+/***********************************************************/
+/* ListJoinStatistics: Prints the counters of each join of */
+/*   a rule, from the first join to the one activating it. */
+/***********************************************************/
+void ListJoinStatistics(
+  Environment *theEnv,
+  const char *logicalName,
+  Defrule *theRule)
+  {
+   struct joinList theList = { NULL, 0, 0 };
+   Defrule *theDisjunct;
+   size_t i;
+   int disjunctIndex = 0;
+   char buffer[32];
+
+   for (theDisjunct = theRule;
+        theDisjunct != NULL;
+        theDisjunct = theDisjunct->disjunct)
+     {
+      disjunctIndex++;
+
+      if (theRule->disjunct != NULL)
+        {
+         gensnprintf(buffer,sizeof(buffer),"Disjunct #%d\n",disjunctIndex);
+         WriteString(theEnv,logicalName,buffer);
+        }
+
+      theList.count = 0;
+      AddRuleJoins(theEnv,&theList,theDisjunct,theRule,
+                   (theRule->disjunct != NULL) ? disjunctIndex : 0);
+
+      for (i = theList.count; i > 0; i--)
+        {
+         if (GetHaltExecution(theEnv) == true)
+           { break; }
+
+         ListJoinEntry(theEnv,logicalName,theList.entries[i-1].join);
+        }
+     }
+
+   FreeJoinList(theEnv,&theList);
+  }
+
+/*********************************************/
+/* ListJoinEntry: Prints the counters of one */
+/*   join for the join-stats command.        */
+/*********************************************/
+static void ListJoinEntry(
+  Environment *theEnv,
+  const char *logicalName,
+  struct joinNode *theJoin)
+  {
+   char buffer[100];
+
+   gensnprintf(buffer,sizeof(buffer),"Join %u",(unsigned) theJoin->depth);
+   WriteString(theEnv,logicalName,buffer);
+
+   if (theJoin->ruleToActivate != NULL)
+     { WriteString(theEnv,logicalName," (activates the rule)"); }
+   else if (theJoin->joinFromTheRight)
+     { WriteString(theEnv,logicalName," (from the right)"); }
+   else if (theJoin->patternIsExists)
+     { WriteString(theEnv,logicalName," (exists)"); }
+   else if (theJoin->patternIsNegated)
+     { WriteString(theEnv,logicalName," (not)"); }
+   WriteString(theEnv,logicalName,"\n");
+
+   gensnprintf(buffer,sizeof(buffer),"   Left activations:  %12llu\n",theJoin->statistics.leftActivations);
+   WriteString(theEnv,logicalName,buffer);
+   gensnprintf(buffer,sizeof(buffer),"   Right activations: %12llu\n",theJoin->statistics.rightActivations);
+   WriteString(theEnv,logicalName,buffer);
+   gensnprintf(buffer,sizeof(buffer),"   Matches out:       %12llu\n",theJoin->statistics.matchesOut);
+   WriteString(theEnv,logicalName,buffer);
+   gensnprintf(buffer,sizeof(buffer),"   Compares:          %12lld\n",theJoin->memoryCompares);
+   WriteString(theEnv,logicalName,buffer);
+   gensnprintf(buffer,sizeof(buffer),"   Memory scans:      %12llu\n",theJoin->statistics.memoryScans);
+   WriteString(theEnv,logicalName,buffer);
+   gensnprintf(buffer,sizeof(buffer),"   Average scan:      %12.2f\n",AverageScanLength(theJoin));
+   WriteString(theEnv,logicalName,buffer);
+   gensnprintf(buffer,sizeof(buffer),"   Longest scan:      %12lu\n",theJoin->statistics.longestScan);
+   WriteString(theEnv,logicalName,buffer);
+
+   gensnprintf(buffer,sizeof(buffer),"   Left memory:       %12lu (peak %lu)\n",
+               (theJoin->leftMemory == NULL) ? 0UL : theJoin->leftMemory->count,
+               theJoin->statistics.leftPeak);
+   WriteString(theEnv,logicalName,buffer);
+
+   if (theJoin->joinFromTheRight)
+     {
+      gensnprintf(buffer,sizeof(buffer),"   Right memory:      %12lu (peak %lu)\n",
+                  RightMemoryCount(theJoin),theJoin->statistics.rightPeak);
+     }
+   else
+     { gensnprintf(buffer,sizeof(buffer),"   Right memory:      %12lu\n",RightMemoryCount(theJoin)); }
+   WriteString(theEnv,logicalName,buffer);
+  }
+
+/************************************************************/
+/* ListHotJoins: Prints the joins of all the rules with the */
+/*   most compares, along with their average scan length,   */
+/*   the partial matches sent on and their memory sizes. A  */
+/*   join is named by its rule, the disjunct number if the  */
+/*   rule has disjuncts, and its depth. A join shared by    */
+/*   several rules is listed once, with the first of them.  */
+/*   A positive limit prints at most that many joins.       */
+/************************************************************/
+void ListHotJoins(
+  Environment *theEnv,
+  const char *logicalName,
+  long long limit)
+  {
+   struct joinList theList = { NULL, 0, 0 };
+   Defmodule *theModule;
+   Defrule *theRule, *theDisjunct;
+   struct joinNode *theJoin;
+   size_t i, unique;
+   int disjunctIndex;
+   long long printed = 0;
+   char buffer[100];
+
+   /*==========================================*/
+   /* Collect the joins of the rules from all  */
+   /* modules and drop the shared duplicates.  */
+   /*==========================================*/
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+
+      for (theRule = GetNextDefrule(theEnv,NULL);
+           theRule != NULL;
+           theRule = GetNextDefrule(theEnv,theRule))
+        {
+         disjunctIndex = 0;
+         for (theDisjunct = theRule;
+              theDisjunct != NULL;
+              theDisjunct = theDisjunct->disjunct)
+           {
+            if (theRule->disjunct != NULL)
+              { disjunctIndex++; }
+            AddRuleJoins(theEnv,&theList,theDisjunct,theRule,disjunctIndex);
+           }
+        }
+     }
+
+   RestoreCurrentModule(theEnv);
+
+   if (theList.count > 1)
+     {
+      qsort(theList.entries,theList.count,sizeof(struct joinEntry),CompareJoinAddresses);
+
+      for (i = 1, unique = 1; i < theList.count; i++)
+        {
+         if (theList.entries[i].join != theList.entries[unique-1].join)
+           { theList.entries[unique++] = theList.entries[i]; }
+        }
+      theList.count = unique;
+
+      qsort(theList.entries,theList.count,sizeof(struct joinEntry),CompareJoinActivity);
+     }
+
+   /*======================================*/
+   /* Print the joins with the most work.  */
+   /*======================================*/
+
+   WriteString(theEnv,logicalName,"    Compares  Avg scan  Max scan   Matches out  Left mem  Right mem  Join\n");
+   WriteString(theEnv,logicalName,"    --------  --------  --------   -----------  --------  ---------  ----\n");
+
+   for (i = 0; i < theList.count; i++)
+     {
+      if (((limit > 0) && (printed >= limit)) ||
+          (GetHaltExecution(theEnv) == true))
+        { break; }
+
+      theJoin = theList.entries[i].join;
+
+      if ((theJoin->memoryCompares == 0) &&
+          (theJoin->statistics.leftActivations == 0) &&
+          (theJoin->statistics.rightActivations == 0))
+        { break; }
+
+      gensnprintf(buffer,sizeof(buffer),"%12lld  %8.2f  %8lu  %12llu  %8lu  %9lu  ",
+                  theJoin->memoryCompares,AverageScanLength(theJoin),
+                  theJoin->statistics.longestScan,theJoin->statistics.matchesOut,
+                  (theJoin->leftMemory == NULL) ? 0UL : theJoin->leftMemory->count,
+                  RightMemoryCount(theJoin));
+      WriteString(theEnv,logicalName,buffer);
+
+      WriteString(theEnv,logicalName,DefruleModule(theList.entries[i].rule));
+      WriteString(theEnv,logicalName,"::");
+      WriteString(theEnv,logicalName,DefruleName(theList.entries[i].rule));
+      if (theList.entries[i].disjunct > 0)
+        {
+         gensnprintf(buffer,sizeof(buffer),"#%d",theList.entries[i].disjunct);
+         WriteString(theEnv,logicalName,buffer);
+        }
+      gensnprintf(buffer,sizeof(buffer),"/%u\n",(unsigned) theJoin->depth);
+      WriteString(theEnv,logicalName,buffer);
+
+      printed++;
+     }
+
+   FreeJoinList(theEnv,&theList);
+  }
+
+/**************************************************/
+/* CompareJoinAddresses: Orders join entries by   */
+/*   join address, and for the same join by the   */
+/*   order they were collected in, for qsort.     */
+/**************************************************/
+static int CompareJoinAddresses(
+  const void *theFirst,
+  const void *theSecond)
+  {
+   const struct joinEntry *firstEntry = (const struct joinEntry *) theFirst;
+   const struct joinEntry *secondEntry = (const struct joinEntry *) theSecond;
+
+   if (firstEntry->join < secondEntry->join) return -1;
+   if (firstEntry->join > secondEntry->join) return 1;
+   if (firstEntry < secondEntry) return -1;
+   if (firstEntry > secondEntry) return 1;
+   return 0;
+  }
+
+/*******************************************************/
+/* CompareJoinActivity: Orders join entries by falling */
+/*   compares, then by falling activations, for qsort. */
+/*******************************************************/
+static int CompareJoinActivity(
+  const void *theFirst,
+  const void *theSecond)
+  {
+   struct joinNode *firstJoin = ((const struct joinEntry *) theFirst)->join;
+   struct joinNode *secondJoin = ((const struct joinEntry *) theSecond)->join;
+   unsigned long long firstActivations, secondActivations;
+
+   if (firstJoin->memoryCompares > secondJoin->memoryCompares) return -1;
+   if (firstJoin->memoryCompares < secondJoin->memoryCompares) return 1;
+
+   firstActivations = firstJoin->statistics.leftActivations + firstJoin->statistics.rightActivations;
+   secondActivations = secondJoin->statistics.leftActivations + secondJoin->statistics.rightActivations;
+
+   if (firstActivations > secondActivations) return -1;
+   if (firstActivations < secondActivations) return 1;
+   return 0;
+  }
+
+/****************************************/
+/* JoinStatsCommand: H/L access routine */
+/*   for the join-stats command.        */
+/****************************************/
+void JoinStatsCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *ruleName;
+   Defrule *theRule;
+   UDFValue theArg;
+
+   if (! UDFFirstArgument(context,SYMBOL_BIT,&theArg))
+     { return; }
+
+   ruleName = theArg.lexemeValue->contents;
+
+   theRule = FindDefrule(theEnv,ruleName);
+   if (theRule == NULL)
+     {
+      CantFindItemErrorMessage(theEnv,"defrule",ruleName,true);
+      returnValue->lexemeValue = FalseSymbol(theEnv);
+      return;
+     }
+
+   ListJoinStatistics(theEnv,STDOUT,theRule);
+
+   returnValue->lexemeValue = TrueSymbol(theEnv);
+  }
+
+/***************************************/
+/* HotJoinsCommand: H/L access routine */
+/*   for the hot-joins command.        */
+/***************************************/
+void HotJoinsCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   long long limit = HOT_JOINS_DEFAULT;
+
+   if (UDFHasNextArgument(context))
+     {
+      if (! UDFFirstArgument(context,INTEGER_BIT,&theArg))
+        { return; }
+
+      limit = theArg.integerValue->contents;
+      if (limit < 0)
+        {
+         UDFInvalidArgumentMessage(context,"integer greater than or equal to 0");
+         return;
+        }
+     }
+
+   ListHotJoins(theEnv,STDOUT,limit);
+  }
+
+#endif /* JOIN_STATISTICS */
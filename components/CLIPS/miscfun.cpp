@@ -130,6 +130,7 @@
 #include "exprnpsr.h"
 #include "memalloc.h"
 #include "multifld.h"
+#include "pprint.h"
 #include "prntutil.h"
 #include "router.h"
 #include "sysdep.h"
@@ -195,6 +196,8 @@ void MiscFunctionDefinitions(
    AddUDF(theEnv,"random","l",0,2,"l",RandomFunction,"RandomFunction",NULL);
    AddUDF(theEnv,"seed","v",1,1,"l",SeedFunction,"SeedFunction",NULL);
    AddUDF(theEnv,"conserve-mem","v",1,1,"y",ConserveMemCommand,"ConserveMemCommand",NULL);
+   AddUDF(theEnv,"set-pp-capture","b",1,1,"y",SetPPCaptureCommand,"SetPPCaptureCommand",NULL);
+   AddUDF(theEnv,"get-pp-capture","b",0,0,NULL,GetPPCaptureCommand,"GetPPCaptureCommand",NULL);
    AddUDF(theEnv,"release-mem","l",0,0,NULL,ReleaseMemCommand,"ReleaseMemCommand",NULL);
 #if DEBUGGING_FUNCTIONS
    AddUDF(theEnv,"mem-used","l",0,0,NULL,MemUsedCommand,"MemUsedCommand",NULL);
@@ -556,6 +559,38 @@ void ConserveMemCommand(
    return;
   }
 
+/*************************************************/
+/* SetPPCaptureCommand: H/L access routine for   */
+/*   the set-pp-capture command. With capture    */
+/*   off, constructs are parsed without keeping  */
+/*   their pretty print form, so there's nothing */
+/*   for the pp commands or save to display.     */
+/*************************************************/
+void SetPPCaptureCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   if (! UDFFirstArgument(context,SYMBOL_BIT,&theArg))
+     { return; }
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,SetPPBufferEnabled(theEnv,theArg.value != FalseSymbol(theEnv)));
+  }
+
+/**********************************************/
+/* GetPPCaptureCommand: H/L access routine    */
+/*   for the get-pp-capture command.          */
+/**********************************************/
+void GetPPCaptureCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetPPBufferEnabled(theEnv));
+  }
+
 #if DEBUGGING_FUNCTIONS
 
 /****************************************/
@@ -83,6 +83,7 @@
 #include "classinf.h"
 #if (! BLOAD_ONLY) && (! RUN_TIME)
 #include "constrct.h"
+#include "cstrcpsr.h"
 #include "msgpsr.h"
 #endif
 #include "envrnmnt.h"
@@ -195,6 +196,7 @@ void SetupMessageHandlers(
 
    AddConstruct(theEnv,"defmessage-handler","defmessage-handlers",
                 ParseDefmessageHandler,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);
+   AddLazyParseFunction(theEnv,"defmessage-handlers",ParseLazyHandlers,0,NULL);
    AddUDF(theEnv,"undefmessage-handler","v",2,3,"y",UndefmessageHandlerCommand,"UndefmessageHandlerCommand",NULL);
 
 #endif
@@ -652,6 +654,16 @@ void PPDefmessageHandlerCommand(
       SetEvaluationError(theEnv,true);
       return;
      }
+
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   /* ===============================================
+      Actions deferred by lazy construct loading are
+      parsed first so that they are laid out as they
+      would have been by the parser.
+      =============================================== */
+   if (hnd->lazyBody != NULL)
+     ParseLazyHandler(theEnv,hnd);
+#endif
      
    if (strcmp(logicalName,"nil") == 0)
      {
@@ -739,13 +751,18 @@ void PreviewSendCommand(
   INPUTS       : 1) Address of the handler's class
                  2) Index of the handler
   RETURNS      : True if printable, false otherwise
-  SIDE EFFECTS : None
+  SIDE EFFECTS : Actions deferred by lazy construct
+                 loading are parsed
   NOTES        : None
  ********************************************************/
 const char *DefmessageHandlerPPForm(
   Defclass *theDefclass,
   unsigned theIndex)
   {
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   if (theDefclass->handlers[theIndex-1].lazyBody != NULL)
+     ParseLazyHandler(theDefclass->header.env,&theDefclass->handlers[theIndex-1]);
+#endif
    return theDefclass->handlers[theIndex-1].header.ppForm;
   }
 
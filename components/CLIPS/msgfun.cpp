@@ -63,6 +63,10 @@
 #include "insfun.h"
 #include "memalloc.h"
 #include "msgcom.h"
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+#include "cstrcpsr.h"
+#include "msgpsr.h"
+#endif
 #include "prccode.h"
 #include "prntutil.h"
 #include "router.h"
@@ -125,6 +129,9 @@ void PrintNoHandlerError(
   DESCRIPTION  : Verifies that the current argument
                    list satisfies the current
                    handler's parameter count restriction
+                   and parses the handler's actions if
+                   it was loaded in lazy construct
+                   loading mode
   INPUTS       : None
   RETURNS      : True if all OK, false otherwise
   SIDE EFFECTS : EvaluationError set on errors
@@ -163,6 +170,13 @@ bool CheckHandlerArgCount(
         
       return false;
      }
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+   if ((hnd->lazyBody != NULL) && (! ParseLazyHandler(theEnv,hnd)))
+     {
+      SetEvaluationError(theEnv,true);
+      return false;
+     }
+#endif
    return true;
   }
 
@@ -340,6 +354,9 @@ DefmessageHandler *InsertHandlerHeader(
    nhnd[cls->handlerCount].maxParams = 0;
    nhnd[cls->handlerCount].localVarCount = 0;
    nhnd[cls->handlerCount].actions = NULL;
+#if ! BLOAD_ONLY
+   nhnd[cls->handlerCount].lazyBody = NULL;
+#endif
    nhnd[cls->handlerCount].header.ppForm = NULL;
    nhnd[cls->handlerCount].header.usrData = NULL;
    nhnd[cls->handlerCount].header.constructType = DEFMESSAGE_HANDLER;
@@ -516,6 +533,7 @@ void DeallocateMarkedHandlers(
          ReleaseLexeme(theEnv,hnd->header.name);
          ExpressionDeinstall(theEnv,hnd->actions);
          ReturnPackedExpression(theEnv,hnd->actions);
+         ReturnLazyConstructBody(theEnv,hnd->lazyBody);
          ClearUserDataList(theEnv,hnd->header.usrData);
          if (hnd->header.ppForm != NULL)
            rm(theEnv,(void *) hnd->header.ppForm,
@@ -420,10 +420,11 @@ void CallNextHandler(
                          ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-            EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                               MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                               MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                               returnValue,UnboundHandlerErr);
+            EvaluateConstructActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                     &MessageHandlerData(theEnv)->CurrentCore->hnd->header.usrData,
+                                     MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                     MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                     returnValue,UnboundHandlerErr);
 #if PROFILING_FUNCTIONS
             EndProfile(theEnv,&profileFrame);
 #endif
@@ -452,10 +453,11 @@ void CallNextHandler(
                      ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-        EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                            returnValue,UnboundHandlerErr);
+        EvaluateConstructActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                 &MessageHandlerData(theEnv)->CurrentCore->hnd->header.usrData,
+                                 MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                 MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                 returnValue,UnboundHandlerErr);
 #if PROFILING_FUNCTIONS
          EndProfile(theEnv,&profileFrame);
 #endif
@@ -1122,10 +1124,11 @@ static bool PerformMessage(
 #endif
 
 
-           EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                               MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                               MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                               returnValue,UnboundHandlerErr);
+           EvaluateConstructActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                    &MessageHandlerData(theEnv)->CurrentCore->hnd->header.usrData,
+                                    MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                    MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                    returnValue,UnboundHandlerErr);
 
 
 #if PROFILING_FUNCTIONS
@@ -1280,10 +1283,11 @@ static void CallHandlers(
                       ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-         EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                            &temp,UnboundHandlerErr);
+         EvaluateConstructActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                  &MessageHandlerData(theEnv)->CurrentCore->hnd->header.usrData,
+                                  MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                  MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                  &temp,UnboundHandlerErr);
 
 
 #if PROFILING_FUNCTIONS
@@ -1320,10 +1324,11 @@ static void CallHandlers(
 #endif
 
 
-        EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                            returnValue,UnboundHandlerErr);
+        EvaluateConstructActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                 &MessageHandlerData(theEnv)->CurrentCore->hnd->header.usrData,
+                                 MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                 MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                 returnValue,UnboundHandlerErr);
 
 #if PROFILING_FUNCTIONS
          EndProfile(theEnv,&profileFrame);
@@ -1371,10 +1376,11 @@ static void CallHandlers(
 #endif
 
 
-         EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                            &temp,UnboundHandlerErr);
+         EvaluateConstructActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                  &MessageHandlerData(theEnv)->CurrentCore->hnd->header.usrData,
+                                  MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                  MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                  &temp,UnboundHandlerErr);
 
 #if PROFILING_FUNCTIONS
          EndProfile(theEnv,&profileFrame);
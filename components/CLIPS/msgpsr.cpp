@@ -65,6 +65,10 @@
 #include "bload.h"
 #endif
 
+#if EXPRESSION_BYTECODE
+#include "bytecode.h"
+#endif
+
 #include "classcom.h"
 #include "classfun.h"
 #include "constrct.h"
@@ -137,6 +141,7 @@ bool ParseDefmessageHandler(
    bool error;
    Expression *hndParams,*actions;
    DefmessageHandler *hnd;
+   struct lazyConstructBody *lazyBody = NULL;
 
    SetPPBufferStatus(theEnv,true);
    FlushPPBuffer(theEnv);
@@ -248,12 +253,28 @@ bool ParseDefmessageHandler(
    if (error)
      return true;
    PPCRAndIndent(theEnv);
-   ExpressionData(theEnv)->ReturnContext = true;
-   actions = ParseProcActions(theEnv,"message-handler",readSource,
-                              &DefclassData(theEnv)->ObjectParseToken,hndParams,wildcard,
-                              SlotReferenceVar,BindSlotReference,&lvars,
-                              cls);
-   if (actions == NULL)
+
+   /* ==================================================
+      In lazy construct loading mode the actions are
+      only read here and parsed when the handler is first
+      called. The ?self parameter is not saved with them.
+      ================================================== */
+   if (GetLazyConstructLoading(theEnv) && (! ConstructData(theEnv)->CheckSyntaxMode))
+     {
+      actions = NULL;
+      lvars = 0;
+      lazyBody = ReadLazyConstructBody(theEnv,readSource,&DefclassData(theEnv)->ObjectParseToken,
+                                       "defmessage-handler",hndParams->nextArg,wildcard);
+     }
+   else
+     {
+      ExpressionData(theEnv)->ReturnContext = true;
+      actions = ParseProcActions(theEnv,"message-handler",readSource,
+                                 &DefclassData(theEnv)->ObjectParseToken,hndParams,wildcard,
+                                 SlotReferenceVar,BindSlotReference,&lvars,
+                                 cls);
+     }
+   if ((actions == NULL) && (lazyBody == NULL))
      {
       ReturnExpression(theEnv,hndParams);
       return true;
@@ -263,6 +284,7 @@ bool ParseDefmessageHandler(
       SyntaxErrorMessage(theEnv,"defmessage-handler");
       ReturnExpression(theEnv,hndParams);
       ReturnPackedExpression(theEnv,actions);
+      ReturnLazyConstructBody(theEnv,lazyBody);
       return true;
      }
    PPBackup(theEnv);
@@ -286,9 +308,13 @@ bool ParseDefmessageHandler(
      {
       ExpressionDeinstall(theEnv,hnd->actions);
       ReturnPackedExpression(theEnv,hnd->actions);
+      ReturnLazyConstructBody(theEnv,hnd->lazyBody);
       if (hnd->header.ppForm != NULL)
         rm(theEnv,(void *) hnd->header.ppForm,
            (sizeof(char) * (strlen(hnd->header.ppForm)+1)));
+#if EXPRESSION_BYTECODE
+      DiscardBytecode(theEnv,&hnd->header.usrData);
+#endif
      }
    else
      {
@@ -301,6 +327,7 @@ bool ParseDefmessageHandler(
    hnd->maxParams = max;
    hnd->localVarCount = lvars;
    hnd->actions = actions;
+   hnd->lazyBody = lazyBody;
    ExpressionInstall(theEnv,hnd->actions);
 #if DEBUGGING_FUNCTIONS
 
@@ -425,6 +452,104 @@ void CreateGetAndPutHandlers(
    rm(theEnv,buf,bufsz);
   }
 
+/***************************************************
+  NAME         : ParseLazyHandler
+  DESCRIPTION  : Parses the actions of a message-
+                 handler loaded in lazy construct
+                 loading mode
+  INPUTS       : The message-handler
+  RETURNS      : True if successful, false otherwise
+  SIDE EFFECTS : Actions installed and text released
+  NOTES        : Slot references are checked against
+                 the class of the handler as when
+                 the handler is loaded. The errors
+                 of actions which can not be parsed
+                 are only reported once.
+ ***************************************************/
+bool ParseLazyHandler(
+  Environment *theEnv,
+  DefmessageHandler *hnd)
+  {
+   Expression *actions;
+   unsigned short lvars;
+
+   if (hnd->lazyBody->parseFailed)
+     { return false; }
+
+   actions = ParseLazyProcActions(theEnv,"message-handler",hnd->cls->header.whichModule->theModule,hnd->lazyBody,
+                                  &hnd->header,GenConstant(theEnv,SYMBOL_TYPE,MessageHandlerData(theEnv)->SELF_SYMBOL),
+                                  SlotReferenceVar,BindSlotReference,&lvars,hnd->cls);
+   if (actions == NULL)
+     {
+      hnd->lazyBody->parseFailed = true;
+      PrintErrorID(theEnv,"MSGPSR",9,false);
+      WriteString(theEnv,STDERR,"The actions of message-handler '");
+      WriteString(theEnv,STDERR,hnd->header.name->contents);
+      WriteString(theEnv,STDERR,"' ");
+      WriteString(theEnv,STDERR,MessageHandlerData(theEnv)->hndquals[hnd->type]);
+      WriteString(theEnv,STDERR," in class '");
+      WriteString(theEnv,STDERR,DefclassName(hnd->cls));
+      WriteString(theEnv,STDERR,"' could not be parsed.\n");
+      return false;
+     }
+
+   hnd->localVarCount = lvars;
+   hnd->actions = actions;
+   ExpressionInstall(theEnv,hnd->actions);
+
+   ReturnLazyConstructBody(theEnv,hnd->lazyBody);
+   hnd->lazyBody = NULL;
+
+   return true;
+  }
+
+/***************************************************
+  NAME         : ParseLazyHandlers
+  DESCRIPTION  : Parses the actions of all the
+                 message-handlers which have not
+                 been called since they were loaded
+                 in lazy construct loading mode
+  INPUTS       : Not used
+  RETURNS      : False if the actions of any
+                 message-handler contain errors
+  SIDE EFFECTS : Actions installed
+  NOTES        : Called by ParseLazyConstructs
+ ***************************************************/
+bool ParseLazyHandlers(
+  Environment *theEnv,
+  void *context)
+  {
+   Defmodule *theModule;
+   Defclass *cls;
+   unsigned short i;
+   bool rv = true;
+#if MAC_XCD
+#pragma unused(context)
+#endif
+
+   SaveCurrentModule(theEnv);
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+      for (cls = GetNextDefclass(theEnv,NULL);
+           cls != NULL;
+           cls = GetNextDefclass(theEnv,cls))
+        {
+         for (i = 0 ; i < cls->handlerCount ; i++)
+           {
+            if ((cls->handlers[i].lazyBody != NULL) &&
+                (! ParseLazyHandler(theEnv,&cls->handlers[i])))
+              { rv = false; }
+           }
+        }
+     }
+   RestoreCurrentModule(theEnv);
+
+   return rv;
+  }
+
 /* =========================================
    *****************************************
           INTERNALLY VISIBLE FUNCTIONS
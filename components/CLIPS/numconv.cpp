@@ -0,0 +1,585 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*               NUMBER CONVERSION MODULE              */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Converts integers and floats to and from text    */
+/*   without going through the C library's printf and        */
+/*   strtod families for the common cases. Floats are        */
+/*   formatted exactly as printf's "%.15g" would format      */
+/*   them and parsed exactly as atof would parse them; the   */
+/*   values which can't be converted exactly with integer    */
+/*   and double arithmetic are handed to the C library.      */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#include "sysdep.h"
+
+#include "numconv.h"
+
+#define FLOAT_DIGITS 15
+#define SCALE_LIMBS 8
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static size_t                  WriteDigits(unsigned long long,char *);
+   static int                     FloorLog10Pow2(int);
+   static bool                    ScaleToDigits(unsigned long long,int,int,unsigned long long *);
+   static bool                    ScaleUp(unsigned long long,int,int,unsigned long long *);
+   static bool                    ScaleDown(unsigned long long,int,int,unsigned long long *);
+
+/***************************************/
+/* LOCAL INTERNAL VARIABLE DEFINITIONS */
+/***************************************/
+
+   static const uint32_t          SmallPowersOfTen[] =
+     { 1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL,
+       10000000UL, 100000000UL, 1000000000UL };
+
+   static const double            ExactPowersOfTen[] =
+     { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+/*****************************************************/
+/* WriteDigits: Writes the decimal digits of number  */
+/*   to buffer (without a terminating null) and      */
+/*   returns their count. The number is split into   */
+/*   parts below 10^8 so that most of the divisions  */
+/*   are 32 bit ones.                                */
+/*****************************************************/
+static size_t WriteDigits(
+  unsigned long long number,
+  char *buffer)
+  {
+   char reversed[NUMBER_BUFFER_SIZE];
+   size_t count = 0, i;
+   uint32_t part;
+   int width;
+
+   while (true)
+     {
+      if (number >= 100000000ULL)
+        {
+         part = (uint32_t) (number % 100000000ULL);
+         number /= 100000000ULL;
+         width = 8;
+        }
+      else
+        {
+         part = (uint32_t) number;
+         number = 0;
+         width = 0;
+        }
+
+      do
+        {
+         reversed[count++] = (char) ('0' + (part % 10));
+         part /= 10;
+         width--;
+        }
+      while ((part != 0) || (width > 0));
+
+      if (number == 0) break;
+     }
+
+   for (i = 0; i < count; i++)
+     { buffer[i] = reversed[count - i - 1]; }
+
+   return count;
+  }
+
+/******************************************************/
+/* FormatInteger: Writes number to buffer as printf's */
+/*   "%lld" would and returns the length written.     */
+/******************************************************/
+size_t FormatInteger(
+  long long number,
+  char *buffer)
+  {
+   size_t length;
+
+   if (number < 0)
+     {
+      buffer[0] = '-';
+      length = 1 + WriteDigits(0ULL - (unsigned long long) number,&buffer[1]);
+     }
+   else
+     { length = WriteDigits((unsigned long long) number,buffer); }
+
+   buffer[length] = '\0';
+   return length;
+  }
+
+/*****************************************************/
+/* FormatUnsignedInteger: Writes number to buffer as */
+/*   printf's "%llu" would and returns the length    */
+/*   written.                                        */
+/*****************************************************/
+size_t FormatUnsignedInteger(
+  unsigned long long number,
+  char *buffer)
+  {
+   size_t length;
+
+   length = WriteDigits(number,buffer);
+   buffer[length] = '\0';
+   return length;
+  }
+
+/*****************************************************/
+/* FloorLog10Pow2: Returns floor(exponent * log10 2) */
+/*   for the range of double exponents, using the    */
+/*   approximation 78913 / 2^18 of log10 2.          */
+/*****************************************************/
+static int FloorLog10Pow2(
+  int exponent)
+  {
+   if (exponent >= 0)
+     { return (int) (((long) exponent * 78913L) >> 18); }
+
+   return - (int) ((((long) -exponent * 78913L) + (1L << 18) - 1) >> 18);
+  }
+
+/******************************************************/
+/* ScaleToDigits: Given a double equal to mantissa *  */
+/*   2^binaryExponent, computes the integer closest   */
+/*   to its value times 10^decimalScale, with ties    */
+/*   rounded to even as printf does. Returns false if */
+/*   the result can't be computed exactly here.       */
+/******************************************************/
+static bool ScaleToDigits(
+  unsigned long long mantissa,
+  int binaryExponent,
+  int decimalScale,
+  unsigned long long *digits)
+  {
+   if (decimalScale >= 0)
+     { return ScaleUp(mantissa,binaryExponent,decimalScale,digits); }
+
+   return ScaleDown(mantissa,binaryExponent,-decimalScale,digits);
+  }
+
+/*******************************************************/
+/* ScaleUp: Computes mantissa * 10^scale / 2^-exponent */
+/*   for a number below 10^15 (so exponent is always   */
+/*   negative) using a multiple precision product.     */
+/*******************************************************/
+static bool ScaleUp(
+  unsigned long long mantissa,
+  int binaryExponent,
+  int scale,
+  unsigned long long *digits)
+  {
+   uint32_t limbs[SCALE_LIMBS];
+   unsigned used = 2, i, shift, index, bit;
+   unsigned long long product, carry, value;
+   uint32_t factor, low, middle, high;
+   bool half, sticky;
+   int step;
+
+   if (binaryExponent >= 0) return false;
+
+   /*=====================================*/
+   /* Multiply the mantissa by 10^scale.  */
+   /*=====================================*/
+
+   limbs[0] = (uint32_t) mantissa;
+   limbs[1] = (uint32_t) (mantissa >> 32);
+
+   while (scale > 0)
+     {
+      step = (scale >= 9) ? 9 : scale;
+      factor = SmallPowersOfTen[step];
+      carry = 0;
+
+      for (i = 0; i < used; i++)
+        {
+         product = ((unsigned long long) limbs[i] * factor) + carry;
+         limbs[i] = (uint32_t) product;
+         carry = product >> 32;
+        }
+
+      if (carry != 0)
+        {
+         if (used == SCALE_LIMBS) return false;
+         limbs[used++] = (uint32_t) carry;
+        }
+
+      scale -= step;
+     }
+
+   /*=====================================================*/
+   /* Divide by 2^shift, keeping the bit below the result */
+   /* and whether any of the bits below it are set.       */
+   /*=====================================================*/
+
+   shift = (unsigned) -binaryExponent;
+   if (shift >= (used * 32)) return false;
+
+   index = shift / 32;
+   bit = shift % 32;
+
+   low = limbs[index];
+   middle = ((index + 1) < used) ? limbs[index + 1] : 0;
+   high = ((index + 2) < used) ? limbs[index + 2] : 0;
+
+   value = (((unsigned long long) middle) << 32) | low;
+   if (bit != 0)
+     {
+      value >>= bit;
+      value |= ((unsigned long long) high) << (64 - bit);
+      if ((high >> bit) != 0) return false;
+     }
+   else if (high != 0)
+     { return false; }
+
+   for (i = index + 3; i < used; i++)
+     { if (limbs[i] != 0) return false; }
+
+   index = (shift - 1) / 32;
+   bit = (shift - 1) % 32;
+   half = ((limbs[index] >> bit) & 1) != 0;
+   sticky = (limbs[index] & ((((uint32_t) 1) << bit) - 1)) != 0;
+   for (i = 0; (i < index) && (! sticky); i++)
+     { if (limbs[i] != 0) sticky = true; }
+
+   if (half && (sticky || ((value & 1) != 0)))
+     { value++; }
+
+   *digits = value;
+   return true;
+  }
+
+/*********************************************************/
+/* ScaleDown: Computes mantissa * 2^exponent / 10^scale  */
+/*   for a number of at least 10^15 when the numerator   */
+/*   and the denominator both fit in 64 bits.            */
+/*********************************************************/
+static bool ScaleDown(
+  unsigned long long mantissa,
+  int binaryExponent,
+  int scale,
+  unsigned long long *digits)
+  {
+   unsigned long long numerator, denominator, remainder, value;
+
+   if (scale > 9) return false;
+
+   numerator = mantissa;
+   denominator = SmallPowersOfTen[scale];
+
+   if (binaryExponent >= 0)
+     {
+      if ((binaryExponent > 63) || ((numerator >> (63 - binaryExponent)) != 0))
+        { return false; }
+      numerator <<= binaryExponent;
+     }
+   else
+     {
+      if ((-binaryExponent > 33) || ((denominator >> (63 + binaryExponent)) != 0))
+        { return false; }
+      denominator <<= -binaryExponent;
+     }
+
+   value = numerator / denominator;
+   remainder = numerator % denominator;
+
+   if (((remainder * 2) > denominator) ||
+       (((remainder * 2) == denominator) && ((value & 1) != 0)))
+     { value++; }
+
+   *digits = value;
+   return true;
+  }
+
+/******************************************************/
+/* FormatFloat: Writes number to buffer exactly as    */
+/*   printf's "%.15g" would and returns the length    */
+/*   written. The 15 significant digits are computed  */
+/*   with integer arithmetic and correctly rounded;   */
+/*   zero, infinities, NaNs and numbers too small or  */
+/*   too large for that are formatted with snprintf.  */
+/******************************************************/
+size_t FormatFloat(
+  double number,
+  char *buffer)
+  {
+   char digits[FLOAT_DIGITS];
+   unsigned long long scaled, mantissa;
+   double fraction;
+   int binaryExponent, decimalExponent, count, i, tries;
+   size_t length = 0;
+   char exponentDigits[8];
+   size_t exponentLength;
+
+   if ((number == 0.0) || (! isfinite(number)))
+     { return (size_t) gensnprintf(buffer,NUMBER_BUFFER_SIZE,"%.15g",number); }
+
+   /*=================================================*/
+   /* Split the magnitude into an integer mantissa of */
+   /* 53 bits and a power of two.                     */
+   /*=================================================*/
+
+   fraction = frexp(fabs(number),&binaryExponent);
+   mantissa = (unsigned long long) ldexp(fraction,53);
+
+   /*=====================================================*/
+   /* The decimal exponent is either the estimate made    */
+   /* from the binary exponent or one more. Rounding to   */
+   /* 15 digits can also carry into the next power of 10. */
+   /*=====================================================*/
+
+   decimalExponent = FloorLog10Pow2(binaryExponent - 1);
+
+   for (tries = 0; ; tries++)
+     {
+      if ((tries > 1) ||
+          (! ScaleToDigits(mantissa,binaryExponent - 53,(FLOAT_DIGITS - 1) - decimalExponent,&scaled)))
+        { return (size_t) gensnprintf(buffer,NUMBER_BUFFER_SIZE,"%.15g",number); }
+
+      if (scaled < 1000000000000000ULL) break;
+
+      if (scaled == 1000000000000000ULL)
+        {
+         scaled = 100000000000000ULL;
+         decimalExponent++;
+         break;
+        }
+
+      decimalExponent++;
+     }
+
+   if (scaled < 100000000000000ULL)
+     { return (size_t) gensnprintf(buffer,NUMBER_BUFFER_SIZE,"%.15g",number); }
+
+   WriteDigits(scaled,digits);
+
+   count = FLOAT_DIGITS;
+   while ((count > 1) && (digits[count - 1] == '0'))
+     { count--; }
+
+   if (number < 0.0)
+     { buffer[length++] = '-'; }
+
+   /*===============================================*/
+   /* Fixed notation is used for exponents from -4  */
+   /* to 14, otherwise the exponential notation.    */
+   /*===============================================*/
+
+   if ((decimalExponent >= -4) && (decimalExponent < FLOAT_DIGITS))
+     {
+      if (decimalExponent >= 0)
+        {
+         for (i = 0; i <= decimalExponent; i++)
+           { buffer[length++] = digits[i]; }
+
+         if (count > (decimalExponent + 1))
+           {
+            buffer[length++] = '.';
+            for (i = decimalExponent + 1; i < count; i++)
+              { buffer[length++] = digits[i]; }
+           }
+        }
+      else
+        {
+         buffer[length++] = '0';
+         buffer[length++] = '.';
+         for (i = -1; i > decimalExponent; i--)
+           { buffer[length++] = '0'; }
+         for (i = 0; i < count; i++)
+           { buffer[length++] = digits[i]; }
+        }
+     }
+   else
+     {
+      buffer[length++] = digits[0];
+      if (count > 1)
+        {
+         buffer[length++] = '.';
+         for (i = 1; i < count; i++)
+           { buffer[length++] = digits[i]; }
+        }
+
+      buffer[length++] = 'e';
+      if (decimalExponent < 0)
+        {
+         buffer[length++] = '-';
+         decimalExponent = -decimalExponent;
+        }
+      else
+        { buffer[length++] = '+'; }
+
+      if (decimalExponent < 10)
+        { buffer[length++] = '0'; }
+
+      exponentLength = WriteDigits((unsigned long long) decimalExponent,exponentDigits);
+      memcpy(&buffer[length],exponentDigits,exponentLength);
+      length += exponentLength;
+     }
+
+   buffer[length] = '\0';
+   return length;
+  }
+
+/******************************************************/
+/* ParseInteger: Converts a string of decimal digits  */
+/*   with an optional sign to a long long as strtoll  */
+/*   would. Returns false (with the value clamped to  */
+/*   the range of a long long) on overflow.           */
+/******************************************************/
+bool ParseInteger(
+  const char *str,
+  long long *value)
+  {
+   unsigned long long magnitude = 0, limit;
+   bool negative = false;
+   unsigned digit;
+
+   if ((*str == '-') || (*str == '+'))
+     {
+      negative = (*str == '-');
+      str++;
+     }
+
+   limit = negative ? (0ULL - (unsigned long long) LLONG_MIN) : (unsigned long long) LLONG_MAX;
+
+   while ((*str >= '0') && (*str <= '9'))
+     {
+      digit = (unsigned) (*str - '0');
+
+      if (magnitude > ((limit - digit) / 10))
+        {
+         *value = negative ? LLONG_MIN : LLONG_MAX;
+         return false;
+        }
+
+      magnitude = (magnitude * 10) + digit;
+      str++;
+     }
+
+   if (negative)
+     { *value = (long long) (0ULL - magnitude); }
+   else
+     { *value = (long long) magnitude; }
+
+   return true;
+  }
+
+/*******************************************************/
+/* ParseFloat: Converts a float in the scanner's form  */
+/*   (sign, digits, decimal point, exponent) to a      */
+/*   double with the same result as atof. When there   */
+/*   are at most 19 significant digits forming a value */
+/*   below 2^53 and a power of ten within 10^22, the   */
+/*   single multiplication or division by an exactly   */
+/*   represented power of ten is correctly rounded.    */
+/*   Anything else is passed to atof.                  */
+/*******************************************************/
+double ParseFloat(
+  const char *str)
+  {
+#if (! defined(FLT_EVAL_METHOD)) || (FLT_EVAL_METHOD == 0)
+   const char *p = str;
+   unsigned long long mantissa = 0;
+   int digitCount = 0, exponent = 0, exponentValue = 0, exponentDigits = 0;
+   bool negative = false, negativeExponent = false, fractionPart = false, anyDigits = false;
+   unsigned digit;
+   double value;
+
+   if ((*p == '-') || (*p == '+'))
+     {
+      negative = (*p == '-');
+      p++;
+     }
+
+   while (true)
+     {
+      if ((*p >= '0') && (*p <= '9'))
+        {
+         digit = (unsigned) (*p - '0');
+         anyDigits = true;
+
+         if ((mantissa != 0) || (digit != 0))
+           {
+            if (digitCount == 19) return atof(str);
+            mantissa = (mantissa * 10) + digit;
+            digitCount++;
+           }
+
+         if (fractionPart) exponent--;
+        }
+      else if ((*p == '.') && (! fractionPart))
+        { fractionPart = true; }
+      else
+        { break; }
+
+      p++;
+     }
+
+   if (! anyDigits) return atof(str);
+
+   if ((*p == 'e') || (*p == 'E'))
+     {
+      p++;
+      if ((*p == '-') || (*p == '+'))
+        {
+         negativeExponent = (*p == '-');
+         p++;
+        }
+
+      while ((*p >= '0') && (*p <= '9'))
+        {
+         if (exponentDigits == 4) return atof(str);
+         exponentValue = (exponentValue * 10) + (*p - '0');
+         exponentDigits++;
+         p++;
+        }
+
+      if (exponentDigits == 0) return atof(str);
+
+      exponent += negativeExponent ? -exponentValue : exponentValue;
+     }
+
+   if ((*p != '\0') || (mantissa > (1ULL << 53)))
+     { return atof(str); }
+
+   value = (double) mantissa;
+
+   if (mantissa != 0)
+     {
+      if ((exponent < -22) || (exponent > 22))
+        { return atof(str); }
+
+      if (exponent < 0)
+        { value /= ExactPowersOfTen[-exponent]; }
+      else
+        { value *= ExactPowersOfTen[exponent]; }
+     }
+
+   return negative ? -value : value;
+#else
+   return atof(str);
+#endif
+  }
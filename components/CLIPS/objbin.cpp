@@ -70,6 +70,7 @@
 #include "msgfun.h"
 #include "prntutil.h"
 #include "router.h"
+#include "userdata.h"
 
 #if DEFRULE_CONSTRUCT
 #include "objrtbin.h"
@@ -309,6 +310,9 @@ static void DeallocateObjectBinaryData(
 
    if (ObjectBinaryData(theEnv)->HandlerCount != 0L)
      {
+      for (i = 0L ; i < ObjectBinaryData(theEnv)->HandlerCount ; i++)
+        { ClearUserDataList(theEnv,ObjectBinaryData(theEnv)->HandlerArray[i].header.usrData); }
+
       space = (sizeof(DefmessageHandler) * ObjectBinaryData(theEnv)->HandlerCount);
       if (space != 0L)
         {
@@ -1387,6 +1391,9 @@ static void UpdateHandler(
    hnd->cls = DefclassPointer(bhnd->cls);
    //IncrementLexemeCount(hnd->header.name);
    hnd->actions = ExpressionPointer(bhnd->actions);
+#if (! BLOAD_ONLY)
+   hnd->lazyBody = NULL;
+#endif
    hnd->header.ppForm = NULL;
    hnd->busy = 0;
    hnd->mark = 0;
@@ -1503,7 +1510,7 @@ static void ClearBloadObjects(
    if (ObjectBinaryData(theEnv)->HandlerCount != 0L)
      {
       for (i = 0L ; i < ObjectBinaryData(theEnv)->HandlerCount ; i++)
-        ReleaseLexeme(theEnv,ObjectBinaryData(theEnv)->HandlerArray[i].header.name);
+        UnmarkConstructHeader(theEnv,&ObjectBinaryData(theEnv)->HandlerArray[i].header);
 
       space = (sizeof(DefmessageHandler) * ObjectBinaryData(theEnv)->HandlerCount);
       if (space != 0L)
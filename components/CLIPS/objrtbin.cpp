@@ -509,10 +509,9 @@ static void BloadObjectPatterns(
       if ((ObjectReteBinaryData(theEnv)->PatternArray[i].lastLevel != NULL) &&
           (ObjectReteBinaryData(theEnv)->PatternArray[i].lastLevel->selector))
         {
-         AddHashedPatternNode(theEnv,ObjectReteBinaryData(theEnv)->PatternArray[i].lastLevel,
-                                     &ObjectReteBinaryData(theEnv)->PatternArray[i],
-                                     ObjectReteBinaryData(theEnv)->PatternArray[i].networkTest->type,
-                                     ObjectReteBinaryData(theEnv)->PatternArray[i].networkTest->value);
+         AddHashedPatternNodes(theEnv,ObjectReteBinaryData(theEnv)->PatternArray[i].lastLevel,
+                               &ObjectReteBinaryData(theEnv)->PatternArray[i],
+                               ObjectReteBinaryData(theEnv)->PatternArray[i].networkTest);
         }
      }
 
@@ -655,10 +654,9 @@ static void ClearBloadObjectPatterns(
       if ((ObjectReteBinaryData(theEnv)->PatternArray[i].lastLevel != NULL) &&
           (ObjectReteBinaryData(theEnv)->PatternArray[i].lastLevel->selector))
         {
-         RemoveHashedPatternNode(theEnv,ObjectReteBinaryData(theEnv)->PatternArray[i].lastLevel,
-                                        &ObjectReteBinaryData(theEnv)->PatternArray[i],
-                                        ObjectReteBinaryData(theEnv)->PatternArray[i].networkTest->type,
-                                        ObjectReteBinaryData(theEnv)->PatternArray[i].networkTest->value);
+         RemoveHashedPatternNodes(theEnv,ObjectReteBinaryData(theEnv)->PatternArray[i].lastLevel,
+                                  &ObjectReteBinaryData(theEnv)->PatternArray[i],
+                                  ObjectReteBinaryData(theEnv)->PatternArray[i].networkTest);
         }
      }
 
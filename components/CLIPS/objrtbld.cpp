@@ -147,6 +147,8 @@
                                  *PlaceObjectPattern(Environment *,struct lhsParseNode *);
    static OBJECT_PATTERN_NODE    *FindObjectPatternNode(OBJECT_PATTERN_NODE *,struct lhsParseNode *,
                                                   OBJECT_PATTERN_NODE **,bool,bool);
+   static void                    VerifyObjectConstantSelector(Environment *,OBJECT_PATTERN_NODE *,
+                                                               struct lhsParseNode *,bool);
    static OBJECT_PATTERN_NODE    *CreateNewObjectPatternNode(Environment *,struct lhsParseNode *,OBJECT_PATTERN_NODE *,
                                                        OBJECT_PATTERN_NODE *,bool,bool);
    static void                    DetachObjectPattern(Environment *,struct patternNodeHeader *);
@@ -715,6 +717,13 @@ static struct patternNodeHeader *PlaceObjectPattern(
       else
         { endSlot = false; }
 
+      /*===============================================*/
+      /* Determine if the constant values of the field */
+      /* can be hashed under the selector node.        */
+      /*===============================================*/
+
+      VerifyObjectConstantSelector(theEnv,currentLevel,thePattern,endSlot);
+
       /*========================================*/
       /* Is there a node in the pattern network */
       /* that can be reused (shared)?           */
@@ -808,6 +817,58 @@ static struct patternNodeHeader *PlaceObjectPattern(
    return((struct patternNodeHeader *) newAlphaNode);
   }
 
+/************************************************************************
+  NAME         : VerifyObjectConstantSelector
+  DESCRIPTION  : Determines if the constant values of a pattern field
+                 can be hashed under the selector node shared with
+                 other patterns.
+  INPUTS       : 1) The current layer of nodes being examined in the
+                    object pattern network
+                 2) The intermediate parse representation of the pattern
+                    field being added
+                 3) An integer code indicating if this is the last
+                    field in a slot pattern or not
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : The constant selector of the field is removed if
+                 one of its values is already hashed to a node
+                 testing a different set of values
+  NOTES        : A value can only be hashed to one pattern node
+                 under a selector, so a field such as red | blue
+                 can't share the selector with a field testing red
+ ************************************************************************/
+static void VerifyObjectConstantSelector(
+  Environment *theEnv,
+  OBJECT_PATTERN_NODE *currentLevel,
+  struct lhsParseNode *thePattern,
+  bool endSlot)
+  {
+   OBJECT_PATTERN_NODE *selectorNode, *nodeSlotGroup, *hashedNode;
+   struct expr *theValue;
+
+   if (thePattern->constantSelector == NULL) return;
+
+   selectorNode = FindObjectPatternNode(currentLevel,thePattern,&nodeSlotGroup,endSlot,false);
+   if (selectorNode == NULL) return;
+
+   for (theValue = thePattern->constantValue;
+        theValue != NULL;
+        theValue = theValue->nextArg)
+     {
+      hashedNode = (OBJECT_PATTERN_NODE *)
+                   FindHashedPatternNode(theEnv,selectorNode,theValue->type,theValue->value);
+
+      if ((hashedNode != NULL) &&
+          (! IdenticalExpression(hashedNode->networkTest,thePattern->constantValue)))
+        {
+         ReturnExpression(theEnv,thePattern->constantSelector);
+         ReturnExpression(theEnv,thePattern->constantValue);
+         thePattern->constantSelector = NULL;
+         thePattern->constantValue = NULL;
+         return;
+        }
+     }
+  }
+
 /************************************************************************
   NAME         : FindObjectPatternNode
   DESCRIPTION  : Looks for a pattern node at a specified
@@ -959,7 +1020,7 @@ static OBJECT_PATTERN_NODE *CreateNewObjectPatternNode(
    newNode->lastLevel = upperLevel;
 
    if ((upperLevel != NULL) && (upperLevel->selector))
-     { AddHashedPatternNode(theEnv,upperLevel,newNode,newNode->networkTest->type,newNode->networkTest->value); }
+     { AddHashedPatternNodes(theEnv,upperLevel,newNode,newNode->networkTest); }
 
    /*==============================================*/
    /* If there are no nodes with this slot name on */
@@ -1196,7 +1257,7 @@ static void DetachObjectPattern(
          else
            {
            if (upperLevel->selector)
-              { RemoveHashedPatternNode(theEnv,upperLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+              { RemoveHashedPatternNodes(theEnv,upperLevel,patternPtr,patternPtr->networkTest); }
 
             upperLevel->nextLevel = NULL;
             if (upperLevel->alphaNode != NULL)
@@ -1218,7 +1279,7 @@ static void DetachObjectPattern(
 
          if ((patternPtr->lastLevel != NULL) &&
              (patternPtr->lastLevel->selector))
-           { RemoveHashedPatternNode(theEnv,patternPtr->lastLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+           { RemoveHashedPatternNodes(theEnv,patternPtr->lastLevel,patternPtr,patternPtr->networkTest); }
 
          upperLevel->leftNode->rightNode = upperLevel->rightNode;
          if (upperLevel->rightNode != NULL)
@@ -1243,7 +1304,7 @@ static void DetachObjectPattern(
          else
            {
             if (upperLevel->selector)
-              { RemoveHashedPatternNode(theEnv,upperLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+              { RemoveHashedPatternNodes(theEnv,upperLevel,patternPtr,patternPtr->networkTest); }
 
             upperLevel->nextLevel = patternPtr->rightNode;
            }
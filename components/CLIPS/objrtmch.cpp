@@ -359,6 +359,33 @@ void ObjectNetworkAction(
    if (EngineData(theEnv)->ExecutingRule == NULL) FlushGarbagePartialMatches(theEnv);
   }
 
+/***************************************************
+  NAME         : DiscardObjectMatchActions
+  DESCRIPTION  : Removes all pending Rete network
+                 updates without performing them
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Queue emptied and instances marked
+                 as synchronized with the Rete
+  NOTES        : Used when the matches of the
+                 instances are restored directly
+                 (e.g. from a snapshot)
+ ***************************************************/
+void DiscardObjectMatchActions(
+  Environment *theEnv)
+  {
+   OBJECT_MATCH_ACTION *cur;
+
+   while (ObjectReteData(theEnv)->ObjectMatchActionQueue != NULL)
+     {
+      cur = ObjectReteData(theEnv)->ObjectMatchActionQueue;
+      ObjectReteData(theEnv)->ObjectMatchActionQueue = cur->nxt;
+      cur->ins->reteSynchronized = true;
+      cur->ins->busy--;
+      ReturnObjectMatchAction(theEnv,cur);
+     }
+  }
+
 /* =========================================
    *****************************************
           INTERNALLY VISIBLE FUNCTIONS
@@ -0,0 +1,632 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                PARALLEL CHECK MODULE                */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Loads a file of constructs in several threads to */
+/*   report the errors found when the file is loaded.        */
+/*                                                           */
+/*   An environment is not safe to use from more than one    */
+/*   thread, so each thread loads the file into its own      */
+/*   environment. Every environment loads all of the         */
+/*   constructs other than defrules, in the order found in   */
+/*   the file, so each defrule sees the deftemplates,        */
+/*   deffunctions, defglobals, and modules it would see in a */
+/*   serial load. The defrules are divided among the threads */
+/*   in a round-robin fashion and each environment skips the */
+/*   defrules assigned to the other threads, so the parsing, */
+/*   analysis, and join network construction of the defrules */
+/*   is done concurrently.                                   */
+/*                                                           */
+/*   The output of each environment is captured and divided  */
+/*   by the construct being loaded when it was written. The  */
+/*   output for a defrule is kept from the environment which */
+/*   loaded it and the output for the other constructs from  */
+/*   the first environment. Once all the threads are done,   */
+/*   the output is written in the order of the constructs in */
+/*   the file.                                               */
+/*                                                           */
+/*   The constructs are only checked: the environment of the */
+/*   command is left unchanged and nothing is merged into    */
+/*   its join network. A few messages depend on the defrules */
+/*   loaded before a construct, so they can't be produced by */
+/*   an environment which skipped some of them. The join     */
+/*   sharing shown when compilations are watched depends on  */
+/*   every preceding defrule, so in that case the file is    */
+/*   loaded in a single environment. Other constructs, such  */
+/*   as a deftemplate which can't be redefined while a rule  */
+/*   uses it, are loaded by every environment and if their   */
+/*   output differs between environments, the file is loaded */
+/*   again in a single environment. In either case the       */
+/*   messages are the ones written by a serial load.         */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <string.h>
+
+#include "setup.h"
+
+#if PARALLEL_CHECK_FUNCTIONS
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "argacces.h"
+#include "commline.h"
+#include "constrct.h"
+#include "cstrcpsr.h"
+#include "envrnbld.h"
+#include "envrnmnt.h"
+#include "extnfunc.h"
+#include "fileutil.h"
+#include "memalloc.h"
+#include "router.h"
+#include "sysdep.h"
+#include "utility.h"
+#include "watch.h"
+
+#include "parcheck.h"
+
+#define PARALLEL_CHECK_MAX_THREADS 64
+
+/****************************************************************/
+/* checkSegment: Output written to one logical name while one   */
+/*   construct (or the text following it) was being loaded.     */
+/*   Slot 0 holds the output written before the first construct */
+/*   and slot n the output written from the beginning of the    */
+/*   nth construct to the beginning of the next one.            */
+/****************************************************************/
+struct checkSegment
+  {
+   size_t slot;
+   bool shared;
+   const char *logicalName;
+   char *text;
+   size_t length;
+   size_t maximum;
+   struct checkSegment *next;
+  };
+
+struct checkWorker
+  {
+   Environment *theEnv;
+   const char *fileName;
+   unsigned int id;
+   unsigned int count;
+   size_t slot;
+   size_t ruleCount;
+   bool owner;
+   bool shared;
+   LoadError result;
+   struct checkSegment *head;
+   struct checkSegment *tail;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static bool                    RunCheck(Environment *,const char *,unsigned int,bool,LoadError *);
+   static void                   *CheckConstructsThread(void *);
+   static void                    RunCheckWorker(struct checkWorker *);
+   static bool                    CheckLoadFilter(Environment *,const char *,void *);
+   static bool                    QueryCheckCallback(Environment *,const char *,void *);
+   static void                    WriteCheckCallback(Environment *,const char *,const char *,void *);
+   static bool                    CheckOutputAgrees(struct checkWorker *,struct checkWorker *);
+   static void                    WriteCheckOutput(Environment *,struct checkWorker *,unsigned int);
+   static void                    ReleaseCheckOutput(struct checkWorker *);
+   static unsigned int            DefaultThreadCount(void);
+
+/*****************************************************/
+/* ParallelCheckCommandDefinitions: Initializes the  */
+/*   check-constructs command.                       */
+/*****************************************************/
+void ParallelCheckCommandDefinitions(
+  Environment *theEnv)
+  {
+   AddUDF(theEnv,"check-constructs","b",1,2,";sy;l",CheckConstructsCommand,"CheckConstructsCommand",NULL);
+  }
+
+/*************************************************/
+/* CheckConstructsCommand: H/L access routine    */
+/*   for the check-constructs command.           */
+/*************************************************/
+void CheckConstructsCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *theFileName;
+   UDFValue theArg;
+   long long threadCount = 0;
+   LoadError rv;
+
+   if ((theFileName = GetFileName(context)) == NULL)
+     {
+      returnValue->lexemeValue = FalseSymbol(theEnv);
+      return;
+     }
+
+   if (UDFHasNextArgument(context))
+     {
+      if (! UDFNextArgument(context,INTEGER_BIT,&theArg))
+        {
+         returnValue->lexemeValue = FalseSymbol(theEnv);
+         return;
+        }
+
+      threadCount = theArg.integerValue->contents;
+      if ((threadCount < 1) || (threadCount > PARALLEL_CHECK_MAX_THREADS))
+        {
+         UDFInvalidArgumentMessage(context,"integer (between 1 and 64)");
+         SetEvaluationError(theEnv,true);
+         returnValue->lexemeValue = FalseSymbol(theEnv);
+         return;
+        }
+     }
+
+   if (CommandLineData(theEnv)->EvaluatingTopLevelCommand)
+     { SetPrintWhileLoading(theEnv,true); }
+
+   rv = CheckConstructs(theEnv,theFileName,(unsigned int) threadCount);
+
+   if (CommandLineData(theEnv)->EvaluatingTopLevelCommand)
+     { SetPrintWhileLoading(theEnv,false); }
+
+   if (rv == LE_OPEN_FILE_ERROR)
+     {
+      OpenErrorMessage(theEnv,"check-constructs",theFileName);
+      returnValue->lexemeValue = FalseSymbol(theEnv);
+      return;
+     }
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,(rv == LE_NO_ERROR));
+  }
+
+/*****************************************************************/
+/* CheckConstructs: C access routine for the check-constructs    */
+/*   command. Loads the file in threadCount threads (one thread  */
+/*   for each processor if threadCount is 0) and writes the      */
+/*   messages that loading the file would write. The constructs  */
+/*   in the environment are left unchanged. Returns the same     */
+/*   values as Load.                                             */
+/*****************************************************************/
+LoadError CheckConstructs(
+  Environment *theEnv,
+  const char *fileName,
+  unsigned int threadCount)
+  {
+   FILE *theFile;
+   bool watchCompilations;
+   LoadError rv;
+
+   /*=====================================*/
+   /* Make sure the file can be opened so */
+   /* the error is reported only once.    */
+   /*=====================================*/
+
+   if ((theFile = GenOpen(theEnv,fileName,"r")) == NULL)
+     { return LE_OPEN_FILE_ERROR; }
+   GenClose(theEnv,theFile);
+
+   if (threadCount == 0)
+     { threadCount = DefaultThreadCount(); }
+
+   if (threadCount > PARALLEL_CHECK_MAX_THREADS)
+     { threadCount = PARALLEL_CHECK_MAX_THREADS; }
+
+   /*=====================================================*/
+   /* The join sharing written for a watched defrule      */
+   /* depends on all of the defrules loaded before it, so */
+   /* only a single environment can write it.             */
+   /*=====================================================*/
+
+   watchCompilations = (GetWatchItem(theEnv,"compilations") == 1);
+   if (watchCompilations)
+     { threadCount = 1; }
+
+   /*====================================================*/
+   /* If the environments disagree about a construct     */
+   /* other than a defrule, it depends on a defrule that */
+   /* some of them skipped, so load the file again in a  */
+   /* single environment.                                */
+   /*====================================================*/
+
+   if (! RunCheck(theEnv,fileName,threadCount,watchCompilations,&rv))
+     { RunCheck(theEnv,fileName,1,watchCompilations,&rv); }
+
+   return rv;
+  }
+
+/**************************************************************/
+/* RunCheck: Loads the file in threadCount environments and   */
+/*   writes the messages of the load. Returns false without   */
+/*   writing anything if the environments wrote different     */
+/*   messages for a construct which they all loaded.          */
+/**************************************************************/
+static bool RunCheck(
+  Environment *theEnv,
+  const char *fileName,
+  unsigned int threadCount,
+  bool watchCompilations,
+  LoadError *rv)
+  {
+   struct checkWorker *workers;
+   pthread_t *threads;
+   bool *started;
+   unsigned int i, workerCount;
+   bool agrees = true;
+
+   workers = (struct checkWorker *) gm2(theEnv,sizeof(struct checkWorker) * threadCount);
+   threads = (pthread_t *) gm2(theEnv,sizeof(pthread_t) * threadCount);
+   started = (bool *) gm2(theEnv,sizeof(bool) * threadCount);
+
+   /*==============================================*/
+   /* Create the environments on this thread. The  */
+   /* environments are loaded in parallel, but are */
+   /* created and destroyed one at a time.         */
+   /*==============================================*/
+
+   for (workerCount = 0; workerCount < threadCount; workerCount++)
+     {
+      struct checkWorker *theWorker = &workers[workerCount];
+
+      theWorker->theEnv = CreateEnvironment();
+      if (theWorker->theEnv == NULL) break;
+
+      theWorker->fileName = fileName;
+      theWorker->id = workerCount;
+      theWorker->slot = 0;
+      theWorker->ruleCount = 0;
+      theWorker->owner = true;
+      theWorker->shared = true;
+      theWorker->result = LE_NO_ERROR;
+      theWorker->head = NULL;
+      theWorker->tail = NULL;
+
+      SetPrintWhileLoading(theWorker->theEnv,GetPrintWhileLoading(theEnv));
+      SetWatchItem(theWorker->theEnv,"compilations",watchCompilations,NULL);
+      AddRouter(theWorker->theEnv,"check-capture",50,
+                QueryCheckCallback,WriteCheckCallback,
+                NULL,NULL,NULL,theWorker);
+      SetConstructLoadFilter(theWorker->theEnv,CheckLoadFilter,theWorker);
+     }
+
+   if (workerCount == 0)
+     {
+      rm(theEnv,workers,sizeof(struct checkWorker) * threadCount);
+      rm(theEnv,threads,sizeof(pthread_t) * threadCount);
+      rm(theEnv,started,sizeof(bool) * threadCount);
+      *rv = LE_OPEN_FILE_ERROR;
+      return true;
+     }
+
+   for (i = 0; i < workerCount; i++)
+     { workers[i].count = workerCount; }
+
+   /*======================================================*/
+   /* The first environment is loaded on this thread. If a */
+   /* thread can't be started, its environment is loaded   */
+   /* once the other threads are done.                     */
+   /*======================================================*/
+
+   for (i = 1; i < workerCount; i++)
+     { started[i] = (pthread_create(&threads[i],NULL,CheckConstructsThread,&workers[i]) == 0); }
+
+   RunCheckWorker(&workers[0]);
+
+   for (i = 1; i < workerCount; i++)
+     {
+      if (started[i])
+        { pthread_join(threads[i],NULL); }
+      else
+        { RunCheckWorker(&workers[i]); }
+     }
+
+   /*===================================================*/
+   /* Write the captured output in the order the output */
+   /* would have been written by a serial load.         */
+   /*===================================================*/
+
+   for (i = 1; (i < workerCount) && agrees; i++)
+     { agrees = CheckOutputAgrees(&workers[0],&workers[i]); }
+
+   if (agrees)
+     { WriteCheckOutput(theEnv,workers,workerCount); }
+
+   *rv = LE_NO_ERROR;
+   for (i = 0; i < workerCount; i++)
+     {
+      if (workers[i].result != LE_NO_ERROR)
+        { *rv = LE_PARSING_ERROR; }
+
+      ReleaseCheckOutput(&workers[i]);
+      DestroyEnvironment(workers[i].theEnv);
+     }
+
+   rm(theEnv,workers,sizeof(struct checkWorker) * threadCount);
+   rm(theEnv,threads,sizeof(pthread_t) * threadCount);
+   rm(theEnv,started,sizeof(bool) * threadCount);
+
+   return agrees;
+  }
+
+/*****************************************************/
+/* CheckConstructsThread: Thread routine which loads */
+/*   the file into the environment of a worker.      */
+/*****************************************************/
+static void *CheckConstructsThread(
+  void *context)
+  {
+   RunCheckWorker((struct checkWorker *) context);
+   return NULL;
+  }
+
+/*********************************************/
+/* RunCheckWorker: Loads the file into the   */
+/*   environment of a worker.                */
+/*********************************************/
+static void RunCheckWorker(
+  struct checkWorker *theWorker)
+  {
+   theWorker->result = Load(theWorker->theEnv,theWorker->fileName);
+  }
+
+/*****************************************************************/
+/* CheckLoadFilter: Load filter which advances the output slot   */
+/*   of a worker for each construct and skips the defrules which */
+/*   are assigned to the other workers.                          */
+/*****************************************************************/
+static bool CheckLoadFilter(
+  Environment *theEnv,
+  const char *constructName,
+  void *context)
+  {
+#if MAC_XCD
+#pragma unused(theEnv)
+#endif
+   struct checkWorker *theWorker = (struct checkWorker *) context;
+
+   theWorker->slot++;
+
+   if (strcmp(constructName,"defrule") == 0)
+     {
+      theWorker->owner = ((theWorker->ruleCount % theWorker->count) == theWorker->id);
+      theWorker->shared = false;
+      theWorker->ruleCount++;
+      return theWorker->owner;
+     }
+
+   theWorker->owner = true;
+   theWorker->shared = true;
+   return true;
+  }
+
+/************************************************************/
+/* QueryCheckCallback: Query routine for the output capture */
+/*   router of a worker environment.                        */
+/************************************************************/
+static bool QueryCheckCallback(
+  Environment *theEnv,
+  const char *logicalName,
+  void *context)
+  {
+#if MAC_XCD
+#pragma unused(theEnv,context)
+#endif
+
+   if ((strcmp(logicalName,STDOUT) == 0) ||
+       (strcmp(logicalName,STDERR) == 0) ||
+       (strcmp(logicalName,STDWRN) == 0))
+     { return true; }
+
+   return false;
+  }
+
+/*************************************************************/
+/* WriteCheckCallback: Write routine for the output capture  */
+/*   router of a worker environment. Output is only kept if  */
+/*   the worker loads the construct currently being loaded.  */
+/*************************************************************/
+static void WriteCheckCallback(
+  Environment *theEnv,
+  const char *logicalName,
+  const char *str,
+  void *context)
+  {
+   struct checkWorker *theWorker = (struct checkWorker *) context;
+   struct checkSegment *theSegment;
+
+   if (! theWorker->owner) return;
+
+   if (strcmp(logicalName,STDOUT) == 0)
+     { logicalName = STDOUT; }
+   else if (strcmp(logicalName,STDERR) == 0)
+     { logicalName = STDERR; }
+   else
+     { logicalName = STDWRN; }
+
+   theSegment = theWorker->tail;
+   if ((theSegment == NULL) ||
+       (theSegment->slot != theWorker->slot) ||
+       (theSegment->logicalName != logicalName))
+     {
+      theSegment = get_struct(theEnv,checkSegment);
+      theSegment->slot = theWorker->slot;
+      theSegment->shared = theWorker->shared;
+      theSegment->logicalName = logicalName;
+      theSegment->text = NULL;
+      theSegment->length = 0;
+      theSegment->maximum = 0;
+      theSegment->next = NULL;
+
+      if (theWorker->tail == NULL)
+        { theWorker->head = theSegment; }
+      else
+        { theWorker->tail->next = theSegment; }
+      theWorker->tail = theSegment;
+     }
+
+   theSegment->text = AppendToString(theEnv,str,theSegment->text,
+                                     &theSegment->length,&theSegment->maximum);
+  }
+
+/***************************************************************/
+/* CheckOutputAgrees: Returns true if a worker captured the    */
+/*   same output as the first worker for each construct which  */
+/*   both of them loaded (any construct other than a defrule). */
+/***************************************************************/
+static bool CheckOutputAgrees(
+  struct checkWorker *firstWorker,
+  struct checkWorker *theWorker)
+  {
+   struct checkSegment *firstSegment, *theSegment;
+
+   firstSegment = firstWorker->head;
+   theSegment = theWorker->head;
+
+   while (true)
+     {
+      while ((firstSegment != NULL) && (! firstSegment->shared))
+        { firstSegment = firstSegment->next; }
+
+      while ((theSegment != NULL) && (! theSegment->shared))
+        { theSegment = theSegment->next; }
+
+      if ((firstSegment == NULL) || (theSegment == NULL))
+        { return (firstSegment == theSegment); }
+
+      if ((firstSegment->slot != theSegment->slot) ||
+          (firstSegment->logicalName != theSegment->logicalName) ||
+          (firstSegment->length != theSegment->length))
+        { return false; }
+
+      if ((firstSegment->length > 0) &&
+          (strcmp(firstSegment->text,theSegment->text) != 0))
+        { return false; }
+
+      firstSegment = firstSegment->next;
+      theSegment = theSegment->next;
+     }
+  }
+
+/***************************************************************/
+/* WriteCheckOutput: Merges the output captured by the workers */
+/*   by slot and writes it to the environment. The segments of */
+/*   each worker are already ordered by slot. A defrule slot   */
+/*   is owned by a single worker and the output for the other  */
+/*   slots is taken from the first worker.                     */
+/***************************************************************/
+static void WriteCheckOutput(
+  Environment *theEnv,
+  struct checkWorker *workers,
+  unsigned int workerCount)
+  {
+   struct checkWorker *nextWorker;
+   struct checkSegment *theSegment;
+   unsigned int i;
+
+   while (true)
+     {
+      nextWorker = NULL;
+      for (i = 0; i < workerCount; i++)
+        {
+         if (workers[i].head == NULL) continue;
+
+         if ((nextWorker == NULL) ||
+             (workers[i].head->slot < nextWorker->head->slot))
+           { nextWorker = &workers[i]; }
+        }
+
+      if (nextWorker == NULL) return;
+
+      theSegment = nextWorker->head;
+      nextWorker->head = theSegment->next;
+      if (nextWorker->head == NULL)
+        { nextWorker->tail = NULL; }
+
+      if ((theSegment->text != NULL) &&
+          ((! theSegment->shared) || (nextWorker == &workers[0])))
+        { WriteString(theEnv,theSegment->logicalName,theSegment->text); }
+
+      if (theSegment->text != NULL)
+        { rm(nextWorker->theEnv,theSegment->text,theSegment->maximum); }
+
+      rtn_struct(nextWorker->theEnv,checkSegment,theSegment);
+     }
+  }
+
+/****************************************************/
+/* ReleaseCheckOutput: Releases the output captured */
+/*   by a worker which hasn't been written.         */
+/****************************************************/
+static void ReleaseCheckOutput(
+  struct checkWorker *theWorker)
+  {
+   struct checkSegment *theSegment;
+
+   while (theWorker->head != NULL)
+     {
+      theSegment = theWorker->head;
+      theWorker->head = theSegment->next;
+
+      if (theSegment->text != NULL)
+        { rm(theWorker->theEnv,theSegment->text,theSegment->maximum); }
+
+      rtn_struct(theWorker->theEnv,checkSegment,theSegment);
+     }
+
+   theWorker->tail = NULL;
+  }
+
+/***************************************************/
+/* DefaultThreadCount: Returns the number of       */
+/*   processors available for loading the file.    */
+/***************************************************/
+static unsigned int DefaultThreadCount(void)
+  {
+   long processors;
+
+   processors = sysconf(_SC_NPROCESSORS_ONLN);
+   if (processors < 1)
+     { return 1; }
+
+   return (unsigned int) processors;
+  }
+
+#endif /* PARALLEL_CHECK_FUNCTIONS */
+
+#if RUN_TIME
+
+#include "envrnmnt.h"
+#include "parcheck.h"
+#include "symbol.h"
+
+/************************************************************/
+/* CheckConstructsCommand: Run-time version of the command. */
+/*   A constructs-to-c image made on a host with the        */
+/*   command refers to it although constructs can't be      */
+/*   loaded into a run-time program.                        */
+/************************************************************/
+void CheckConstructsCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+#if MAC_XCD
+#pragma unused(context)
+#endif
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+  }
+
+#endif /* RUN_TIME */
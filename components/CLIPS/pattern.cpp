@@ -197,7 +197,9 @@ bool RemoveHashedPatternNode(
         hptr != NULL;
         hptr = hptr->next)
      {
-      if (hptr->child == child)
+      if ((hptr->child == child) &&
+          (hptr->type == keyType) &&
+          (hptr->value == keyValue))
         {
          if (prev == NULL)
            {
@@ -247,6 +249,41 @@ void *FindHashedPatternNode(
    return NULL;
   }
 
+/*************************************************************/
+/* AddHashedPatternNodes: Adds a pattern node to the pattern */
+/*   node hash table using each value in a list of constant  */
+/*   values (an or'ed constant constraint such as red | blue */
+/*   is hashed under each of its values).                    */
+/*************************************************************/
+void AddHashedPatternNodes(
+  Environment *theEnv,
+  void *parent,
+  void *child,
+  struct expr *keyList)
+  {
+   for (;
+        keyList != NULL;
+        keyList = keyList->nextArg)
+     { AddHashedPatternNode(theEnv,parent,child,keyList->type,keyList->value); }
+  }
+
+/*************************************************************/
+/* RemoveHashedPatternNodes: Removes the entries for each    */
+/*   value in a list of constant values from the pattern     */
+/*   node hash table.                                        */
+/*************************************************************/
+void RemoveHashedPatternNodes(
+  Environment *theEnv,
+  void *parent,
+  void *child,
+  struct expr *keyList)
+  {
+   for (;
+        keyList != NULL;
+        keyList = keyList->nextArg)
+     { RemoveHashedPatternNode(theEnv,parent,child,keyList->type,keyList->value); }
+  }
+
 /******************************************************************/
 /* AddReservedPatternSymbol: Adds a symbol to the list of symbols */
 /*  that are restricted for use in patterns. For example, the     */
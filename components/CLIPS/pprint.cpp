@@ -303,9 +303,12 @@ bool GetPPBufferStatus(
    return(PrettyPrintData(theEnv)->PPBufferStatus);
   }
 
-/***********************/
-/* SetPPBufferEnabled: */
-/***********************/
+/*****************************************************/
+/* SetPPBufferEnabled: Sets whether parsers capture  */
+/*   the pretty print representation of constructs.  */
+/*   When disabled, the buffer is released and no    */
+/*   pretty print forms are stored with constructs.  */
+/*****************************************************/
 bool SetPPBufferEnabled(
   Environment *theEnv,
   bool value)
@@ -314,12 +317,18 @@ bool SetPPBufferEnabled(
 
    oldValue = PrettyPrintData(theEnv)->PPBufferEnabled;
    PrettyPrintData(theEnv)->PPBufferEnabled = value;
+
+   if (! value)
+     { DestroyPPBuffer(theEnv); }
+
    return oldValue;
   }
 
-/***********************/
-/* GetPPBufferEnabled: */
-/***********************/
+/*************************************************/
+/* GetPPBufferEnabled: Returns whether parsers   */
+/*   capture the pretty print representation of  */
+/*   constructs.                                 */
+/*************************************************/
 bool GetPPBufferEnabled(
   Environment *theEnv)
   {
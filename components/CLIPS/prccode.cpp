@@ -70,10 +70,13 @@
 #include <stdio.h>
 
 #include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
 
 #include "memalloc.h"
 #include "constant.h"
+#include "cstrccom.h"
+#include "cstrcpsr.h"
 #include "envrnmnt.h"
 #if DEFGLOBAL_CONSTRUCT
 #include "globlpsr.h"
@@ -87,22 +90,14 @@
 #include "prcdrpsr.h"
 #include "prntutil.h"
 #include "router.h"
+#include "strngrtr.h"
 #include "utility.h"
 
-#include "prccode.h"
+#if EXPRESSION_BYTECODE
+#include "bytecode.h"
+#endif
 
-/* =========================================
-   *****************************************
-               MACROS AND TYPES
-   =========================================
-   ***************************************** */
-typedef struct
-  {
-   unsigned firstFlag  : 1;
-   unsigned first      : 15;
-   unsigned secondFlag : 1;
-   unsigned second     : 15;
-  } PACKED_PROC_VAR;
+#include "prccode.h"
 
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
@@ -452,6 +447,172 @@ Expression *ParseProcActions(
    return(pactions);
   }
 
+/*************************************************************************
+  NAME         : ParseLazyProcActions
+  DESCRIPTION  : Parses the actions of a deffunction, generic function
+                 method or message-handler which were read without
+                 being parsed in lazy construct loading mode
+  INPUTS       : 1) The environment
+                 2) The type of procedure body being parsed
+                 3) The module of the procedure
+                 4) The body saved by ReadLazyConstructBody
+                 5) The header of the procedure
+                 6) The partial list of parameters (can be NULL)
+                 7) - 10) See ParseProcActions
+  RETURNS      : A packed expression containing the body, NULL on
+                   errors.
+  SIDE EFFECTS : The partial list of parameters is deallocated.
+                 The pretty print form of the procedure is
+                 replaced by the one the parser would have made
+                 if the actions had not been deferred.
+  NOTES        : Can be called while other constructs are executing
+                 or being parsed, so the parsing state and the
+                 pretty print buffer are saved and restored
+*************************************************************************/
+Expression *ParseLazyProcActions(
+  Environment *theEnv,
+  const char *bodytype,
+  Defmodule *theModule,
+  struct lazyConstructBody *body,
+  ConstructHeader *theHeader,
+  Expression *params,
+  int (*altvarfunc)(Environment *,Expression *,void *),
+  int (*altbindfunc)(Environment *,Expression *,void *),
+  unsigned short *lvarcnt,
+  void *userBuffer)
+  {
+   Expression *actions = NULL,*lastOne,*nextOne;
+   CLIPSLexeme *wildcard = NULL;
+   struct token tkn;
+   struct BindInfo *oldBinds;
+   Defmodule *oldModule;
+   int danglingConstructs;
+   bool ov, oldReturnContext, oldBreakContext, layout;
+   struct prettyPrintData oldPPData;
+   const char *logicalName = "lazy-actions";
+
+   if (OpenStringSource(theEnv,logicalName,body->text,0) == false)
+     {
+      ReturnExpression(theEnv,params);
+      return NULL;
+     }
+
+   /* ===================================================
+      The actions were saved flat to the pretty print
+      form when they were read. To lay them out again,
+      the form is rebuilt in a pretty print buffer of its
+      own which starts as the buffer did before they
+      were read.
+      =================================================== */
+   layout = (theHeader->ppForm != NULL) && (body->ppOffset > 0) &&
+            (strlen(theHeader->ppForm) >= body->ppOffset) &&
+            GetPPBufferEnabled(theEnv);
+   if (layout)
+     {
+      oldPPData = *PrettyPrintData(theEnv);
+      PrettyPrintData(theEnv)->PPBufferPos = 0;
+      PrettyPrintData(theEnv)->PPBufferMax = 0;
+      PrettyPrintData(theEnv)->PrettyPrintBuffer =
+         AppendNToString(theEnv,theHeader->ppForm,NULL,body->ppOffset,
+                         &PrettyPrintData(theEnv)->PPBufferPos,
+                         &PrettyPrintData(theEnv)->PPBufferMax);
+      PrettyPrintData(theEnv)->PPBufferPos = body->ppOffset;
+      PrettyPrintData(theEnv)->PPBackupOnce = body->ppBackupOnce;
+      PrettyPrintData(theEnv)->PPBackupTwice = body->ppBackupTwice;
+      PrettyPrintData(theEnv)->IndentationDepth = body->indentationDepth;
+     }
+
+   /* ===========================================
+      Save the parsing state and parse the actions
+      in the module of the procedure.
+      =========================================== */
+   ov = GetPPBufferStatus(theEnv);
+   SetPPBufferStatus(theEnv,false);
+   oldBinds = GetParsedBindNames(theEnv);
+   SetParsedBindNames(theEnv,NULL);
+   danglingConstructs = ConstructData(theEnv)->DanglingConstructs;
+   oldReturnContext = ExpressionData(theEnv)->ReturnContext;
+   oldBreakContext = ExpressionData(theEnv)->BreakContext;
+   oldModule = GetCurrentModule(theEnv);
+   if (oldModule != theModule)
+     { SetCurrentModule(theEnv,theModule); }
+
+   /* ===================================================
+      The parameter names were checked when the construct
+      was loaded, so they only need to be collected here.
+      =================================================== */
+   lastOne = params;
+   while ((lastOne != NULL) && (lastOne->nextArg != NULL))
+     { lastOne = lastOne->nextArg; }
+   GetToken(theEnv,logicalName,&tkn);
+   if (tkn.tknType == LEFT_PARENTHESIS_TOKEN)
+     {
+      GetToken(theEnv,logicalName,&tkn);
+      while ((tkn.tknType == SF_VARIABLE_TOKEN) || (tkn.tknType == MF_VARIABLE_TOKEN))
+        {
+         nextOne = GenConstant(theEnv,SYMBOL_TYPE,tkn.value);
+         if (tkn.tknType == MF_VARIABLE_TOKEN)
+           { wildcard = tkn.lexemeValue; }
+         if (lastOne == NULL)
+           { params = nextOne; }
+         else
+           { lastOne->nextArg = nextOne; }
+         lastOne = nextOne;
+         GetToken(theEnv,logicalName,&tkn);
+        }
+     }
+
+   if (tkn.tknType == RIGHT_PARENTHESIS_TOKEN)
+     {
+      ExpressionData(theEnv)->ReturnContext = true;
+      SetPPBufferStatus(theEnv,layout);
+      actions = ParseProcActions(theEnv,bodytype,logicalName,&tkn,params,wildcard,
+                                 altvarfunc,altbindfunc,lvarcnt,userBuffer);
+      if ((actions != NULL) && (tkn.tknType != RIGHT_PARENTHESIS_TOKEN))
+        {
+         SyntaxErrorMessage(theEnv,bodytype);
+         ReturnPackedExpression(theEnv,actions);
+         actions = NULL;
+        }
+
+      /* ========================================
+         Reformat the closing token as the parser
+         of the construct does.
+         ======================================== */
+      if ((actions != NULL) && layout)
+        {
+         PPBackup(theEnv);
+         PPBackup(theEnv);
+         SavePPBuffer(theEnv,tkn.printForm);
+         SavePPBuffer(theEnv,"\n");
+         SetConstructPPForm(theEnv,theHeader,CopyPPBuffer(theEnv));
+        }
+     }
+   else
+     { SyntaxErrorMessage(theEnv,"parameter list"); }
+
+   /* ==========================
+      Restore the parsing state.
+      ========================== */
+   if (oldModule != theModule)
+     { SetCurrentModule(theEnv,oldModule); }
+   ExpressionData(theEnv)->ReturnContext = oldReturnContext;
+   ExpressionData(theEnv)->BreakContext = oldBreakContext;
+   ConstructData(theEnv)->DanglingConstructs = danglingConstructs;
+   ClearParsedBindNames(theEnv);
+   SetParsedBindNames(theEnv,oldBinds);
+   if (layout)
+     {
+      DestroyPPBuffer(theEnv);
+      *PrettyPrintData(theEnv) = oldPPData;
+     }
+   SetPPBufferStatus(theEnv,ov);
+   CloseStringSource(theEnv,logicalName);
+   ReturnExpression(theEnv,params);
+
+   return(actions);
+  }
+
 /*************************************************************************
   NAME         : ReplaceProcVars
   DESCRIPTION  : Examines an expression for variables
@@ -890,12 +1051,49 @@ void EvaluateProcActions(
   unsigned short lvarcnt,
   UDFValue *returnValue,
   void (*crtproc)(Environment *,const char *))
+  {
+   EvaluateConstructActions(theEnv,theModule,NULL,actions,lvarcnt,returnValue,crtproc);
+  }
+
+/***********************************************************
+  NAME         : EvaluateConstructActions
+  DESCRIPTION  : Evaluates the actions of a deffunction,
+                 generic function method, message-handler
+                 or rule, running them as bytecode
+                 compiled for the construct when possible.
+  INPUTS       : 1) The module where the actions should be
+                    executed
+                 2) The user data list of the construct
+                    (NULL if the actions are to be
+                    interpreted)
+                 3) The actions (linked by nextArg fields)
+                 4) The number of local variables to reserve
+                    space for.
+                 5) A buffer to hold the result of evaluating
+                    the actions.
+                 6) A function which prints out the name of
+                    the currently executing body for error
+                    messages (can be NULL).
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Allocates and deallocates space for
+                 local variable array.
+  NOTES        : None
+ ***********************************************************/
+void EvaluateConstructActions(
+  Environment *theEnv,
+  Defmodule *theModule,
+  struct userData **theList,
+  Expression *actions,
+  unsigned short lvarcnt,
+  UDFValue *returnValue,
+  void (*crtproc)(Environment *,const char *))
   {
    UDFValue *oldLocalVarArray;
    unsigned short i;
    Defmodule *oldModule;
    Expression *oldActions;
    struct trackedMemory *theTM;
+   bool evaluationError;
 
    oldLocalVarArray = ProceduralPrimitiveData(theEnv)->LocalVarArray;
    ProceduralPrimitiveData(theEnv)->LocalVarArray = (lvarcnt == 0) ? NULL :
@@ -915,7 +1113,14 @@ void EvaluateProcActions(
    oldActions = ProceduralPrimitiveData(theEnv)->CurrentProcActions;
    ProceduralPrimitiveData(theEnv)->CurrentProcActions = actions;
 
-   if (EvaluateExpression(theEnv,actions,returnValue))
+#if EXPRESSION_BYTECODE
+   if (theList != NULL)
+     { evaluationError = EvaluateBytecode(theEnv,theList,actions,returnValue); }
+   else
+#endif
+     { evaluationError = EvaluateExpression(theEnv,actions,returnValue); }
+
+   if (evaluationError)
      {
       returnValue->value = FalseSymbol(theEnv);
      }
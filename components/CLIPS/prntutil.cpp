@@ -87,6 +87,7 @@
 #include "insmngr.h"
 #include "memalloc.h"
 #include "multifun.h"
+#include "numconv.h"
 #include "router.h"
 #include "scanner.h"
 #include "strngrtr.h"
@@ -96,6 +97,12 @@
 
 #include "prntutil.h"
 
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    FormatKBFloat(double,char *);
+
 /*****************************************************/
 /* InitializePrintUtilityData: Allocates environment */
 /*    data for print utility routines.               */
@@ -114,10 +121,10 @@ void WriteFloat(
   const char *fileid,
   double number)
   {
-   const char *theString;
+   char floatString[NUMBER_BUFFER_SIZE];
 
-   theString = FloatToString(theEnv,number);
-   WriteString(theEnv,fileid,theString);
+   FormatKBFloat(number,floatString);
+   WriteString(theEnv,fileid,floatString);
   }
 
 /************************************************/
@@ -128,9 +135,9 @@ void WriteInteger(
   const char *logicalName,
   long long number)
   {
-   char printBuffer[32];
+   char printBuffer[NUMBER_BUFFER_SIZE];
 
-   gensnprintf(printBuffer,sizeof(printBuffer),"%lld",number);
+   FormatInteger(number,printBuffer);
    WriteString(theEnv,logicalName,printBuffer);
   }
 
@@ -143,9 +150,9 @@ void PrintUnsignedInteger(
   const char *logicalName,
   unsigned long long number)
   {
-   char printBuffer[32];
+   char printBuffer[NUMBER_BUFFER_SIZE];
 
-   gensnprintf(printBuffer,sizeof(printBuffer),"%llu",number);
+   FormatUnsignedInteger(number,printBuffer);
    WriteString(theEnv,logicalName,printBuffer);
   }
 
@@ -530,26 +537,38 @@ const char *FloatToString(
   Environment *theEnv,
   double number)
   {
-   char floatString[40];
-   int i;
-   char x;
+   char floatString[NUMBER_BUFFER_SIZE];
    CLIPSLexeme *thePtr;
 
-   gensnprintf(floatString,sizeof(floatString),"%.15g",number);
+   FormatKBFloat(number,floatString);
+
+   thePtr = CreateString(theEnv,floatString);
+   return thePtr->contents;
+  }
+
+/****************************************************/
+/* FormatKBFloat: Writes number to buffer in the KB */
+/*   string format, which is the "%.15g" format     */
+/*   followed by ".0" if there is neither a decimal */
+/*   point nor an exponent.                         */
+/****************************************************/
+static void FormatKBFloat(
+  double number,
+  char *buffer)
+  {
+   size_t i, length;
+
+   length = FormatFloat(number,buffer);
 
-   for (i = 0; (x = floatString[i]) != '\0'; i++)
+   for (i = 0; i < length; i++)
      {
-      if ((x == '.') || (x == 'e'))
-        {
-         thePtr = CreateString(theEnv,floatString);
-         return thePtr->contents;
-        }
+      if ((buffer[i] == '.') || (buffer[i] == 'e'))
+        { return; }
      }
 
-   genstrcat(floatString,".0");
-
-   thePtr = CreateString(theEnv,floatString);
-   return thePtr->contents;
+   buffer[length] = '.';
+   buffer[length+1] = '0';
+   buffer[length+2] = EOS;
   }
 
 /*******************************************************************/
@@ -559,10 +578,10 @@ const char *LongIntegerToString(
   Environment *theEnv,
   long long number)
   {
-   char buffer[50];
+   char buffer[NUMBER_BUFFER_SIZE];
    CLIPSLexeme *thePtr;
 
-   gensnprintf(buffer,sizeof(buffer),"%lld",number);
+   FormatInteger(number,buffer);
 
    thePtr = CreateString(theEnv,buffer);
    return thePtr->contents;
@@ -70,11 +70,16 @@
 
 #include "proflfun.h"
 
+#if PROFILE_SAMPLING_FUNCTIONS
+#include "proflsmp.h"
+#endif
+
 #include <string.h>
 
 #define NO_PROFILE      0
 #define USER_FUNCTIONS  1
 #define CONSTRUCTS_CODE 2
+#define SAMPLED_CODE    3
 
 #define OUTPUT_STRING "%-40s %7ld %15.6f  %8.2f%%  %15.6f  %8.2f%%\n"
 
@@ -107,6 +112,10 @@ void ConstructProfilingFunctionDefinitions(
    ProfileFunctionData(theEnv)->PercentThreshold = 0.0;
    ProfileFunctionData(theEnv)->OutputString = OUTPUT_STRING;
 
+#if PROFILE_SAMPLING_FUNCTIONS
+   ProfileSamplingDefinitions(theEnv);
+#endif
+
 #if ! RUN_TIME
    AddUDF(theEnv,"profile","v",1,1,"y",ProfileCommand,"ProfileCommand",NULL);
    AddUDF(theEnv,"profile-info","v",0,0,NULL, ProfileInfoCommand,"ProfileInfoCommand",NULL);
@@ -169,7 +178,12 @@ void ProfileCommand(
 
    if (! Profile(theEnv,argument))
      {
+#if PROFILE_SAMPLING_FUNCTIONS
+      if (! GetEvaluationError(theEnv))
+        { UDFInvalidArgumentMessage(context,"symbol with value constructs, user-functions, samples, or off"); }
+#else
       UDFInvalidArgumentMessage(context,"symbol with value constructs, user-functions, or off");
+#endif
       return;
      }
 
@@ -189,11 +203,16 @@ bool Profile(
    /* user-defined functions should be profiled. If the    */
    /* argument is the symbol "constructs", then            */
    /* deffunctions, generic functions, message-handlers,   */
-   /* and rule RHS actions are profiled.                   */
+   /* and rule RHS actions are profiled. If the argument   */
+   /* is the symbol "samples", then the code being         */
+   /* executed is sampled from a timer.                    */
    /*======================================================*/
 
    if (strcmp(argument,"user-functions") == 0)
      {
+#if PROFILE_SAMPLING_FUNCTIONS
+      StopProfileSampling(theEnv);
+#endif
       ProfileFunctionData(theEnv)->ProfileStartTime = gentime();
       ProfileFunctionData(theEnv)->ProfileUserFunctions = true;
       ProfileFunctionData(theEnv)->ProfileConstructs = false;
@@ -202,12 +221,28 @@ bool Profile(
 
    else if (strcmp(argument,"constructs") == 0)
      {
+#if PROFILE_SAMPLING_FUNCTIONS
+      StopProfileSampling(theEnv);
+#endif
       ProfileFunctionData(theEnv)->ProfileStartTime = gentime();
       ProfileFunctionData(theEnv)->ProfileUserFunctions = false;
       ProfileFunctionData(theEnv)->ProfileConstructs = true;
       ProfileFunctionData(theEnv)->LastProfileInfo = CONSTRUCTS_CODE;
      }
 
+#if PROFILE_SAMPLING_FUNCTIONS
+   else if (strcmp(argument,"samples") == 0)
+     {
+      if (! StartProfileSampling(theEnv))
+        { return false; }
+
+      ProfileFunctionData(theEnv)->ProfileStartTime = gentime();
+      ProfileFunctionData(theEnv)->ProfileUserFunctions = false;
+      ProfileFunctionData(theEnv)->ProfileConstructs = false;
+      ProfileFunctionData(theEnv)->LastProfileInfo = SAMPLED_CODE;
+     }
+#endif
+
    /*======================================================*/
    /* Otherwise, if the argument is the symbol "off", then */
    /* don't profile constructs and user-defined functions. */
@@ -215,6 +250,9 @@ bool Profile(
 
    else if (strcmp(argument,"off") == 0)
      {
+#if PROFILE_SAMPLING_FUNCTIONS
+      StopProfileSampling(theEnv);
+#endif
       ProfileFunctionData(theEnv)->ProfileEndTime = gentime();
       ProfileFunctionData(theEnv)->ProfileTotalTime += (ProfileFunctionData(theEnv)->ProfileEndTime - ProfileFunctionData(theEnv)->ProfileStartTime);
       ProfileFunctionData(theEnv)->ProfileUserFunctions = false;
@@ -248,7 +286,11 @@ void ProfileInfoCommand(
    /* update the profile end time.     */
    /*==================================*/
 
-   if (ProfileFunctionData(theEnv)->ProfileUserFunctions || ProfileFunctionData(theEnv)->ProfileConstructs)
+   if (ProfileFunctionData(theEnv)->ProfileUserFunctions || ProfileFunctionData(theEnv)->ProfileConstructs
+#if PROFILE_SAMPLING_FUNCTIONS
+       || ProfileSamplingActive(theEnv)
+#endif
+      )
      {
       ProfileFunctionData(theEnv)->ProfileEndTime = gentime();
       ProfileFunctionData(theEnv)->ProfileTotalTime += (ProfileFunctionData(theEnv)->ProfileEndTime - ProfileFunctionData(theEnv)->ProfileStartTime);
@@ -264,6 +306,14 @@ void ProfileInfoCommand(
                       ProfileFunctionData(theEnv)->ProfileTotalTime);
       WriteString(theEnv,STDOUT,buffer);
 
+#if PROFILE_SAMPLING_FUNCTIONS
+      if (ProfileFunctionData(theEnv)->LastProfileInfo == SAMPLED_CODE)
+        {
+         OutputProfileSamples(theEnv,STDOUT,0);
+         return;
+        }
+#endif
+
       if (ProfileFunctionData(theEnv)->LastProfileInfo == USER_FUNCTIONS)
         { WriteString(theEnv,STDOUT,"Function Name                            "); }
       else if (ProfileFunctionData(theEnv)->LastProfileInfo == CONSTRUCTS_CODE)
@@ -457,6 +507,10 @@ void ProfileResetCommand(
    ProfileFunctionData(theEnv)->ProfileTotalTime = 0.0;
    ProfileFunctionData(theEnv)->LastProfileInfo = NO_PROFILE;
 
+#if PROFILE_SAMPLING_FUNCTIONS
+   ResetProfileSamples(theEnv);
+#endif
+
    for (theFunction = GetFunctionList(theEnv);
         theFunction != NULL;
         theFunction = theFunction->next)
@@ -0,0 +1,1582 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*               SAMPLING PROFILER MODULE              */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Samples the executing rule, procedure, function  */
+/*   and join from a periodic timer into a fixed histogram.  */
+/*                                                           */
+/*   The engine already keeps the rule being fired, the      */
+/*   generic function and procedure actions being run, the   */
+/*   expression being evaluated and the join being driven    */
+/*   in its environment data, so taking a sample only copies */
+/*   those pointers and counts the tuple in an open          */
+/*   addressing table allocated when sampling is started.    */
+/*   Nothing is added to the evaluation path. On hosts the   */
+/*   timer is ITIMER_PROF and the sample is taken in the     */
+/*   SIGPROF handler, so only one environment can be sampled */
+/*   at a time; on the ESP32 it is an esp_timer callback,    */
+/*   which runs in another task. No pointer is followed when */
+/*   the sample is taken. When the samples are reported,     */
+/*   each pointer is first found among the current rules,    */
+/*   procedures, joins and the expressions of the constructs */
+/*   and only then used to name a frame.                     */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if PROFILE_SAMPLING_FUNCTIONS
+
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#define PROFILE_SAMPLE_FILES 0
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#define PROFILE_SAMPLE_FILES 1
+#endif
+
+#include "argacces.h"
+#include "commline.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "moduldef.h"
+#include "prccode.h"
+#include "prntutil.h"
+#include "proflfun.h"
+#include "router.h"
+#include "sysdep.h"
+#include "utility.h"
+
+#if DEFRULE_CONSTRUCT
+#include "engine.h"
+#include "network.h"
+#include "ruledef.h"
+#endif
+
+#if DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT
+#include "factbld.h"
+#include "tmpltdef.h"
+#endif
+
+#if DEFFUNCTION_CONSTRUCT
+#include "dffnxfun.h"
+#endif
+
+#if DEFGENERIC_CONSTRUCT
+#include "genrccom.h"
+#include "genrcfun.h"
+#endif
+
+#if OBJECT_SYSTEM
+#include "classcom.h"
+#include "msgcom.h"
+#include "msgpass.h"
+#endif
+
+#if DEFRULE_CONSTRUCT && OBJECT_SYSTEM
+#include "objrtmch.h"
+#endif
+
+#include "proflsmp.h"
+
+#define PROFILE_SAMPLE_PROBES 8
+
+#define PROFILE_UNKNOWN_RULE      0x01
+#define PROFILE_UNKNOWN_PROCEDURE 0x02
+#define PROFILE_UNKNOWN_JOIN      0x04
+#define PROFILE_UNKNOWN_FUNCTION  0x08
+
+/*====================================================*/
+/* A sample holds the pointers as read by the timer.  */
+/* They are only followed once they have been found   */
+/* among the current constructs, when the samples are */
+/* resolved into stacks for a report.                 */
+/*====================================================*/
+
+struct profileSample
+  {
+   struct defrule *rule;
+   struct defgeneric *generic;
+   Expression *actions;
+   Expression *expression;
+   struct joinNode *join;
+   unsigned long count;
+  };
+
+struct profileStack
+  {
+   ConstructHeader *rule;
+   ConstructHeader *procedure;
+   struct defrule *joinRule;
+   unsigned short joinDepth;
+   struct functionDefinition *function;
+   unsigned int unknown;
+   unsigned long count;
+  };
+
+struct sampledExpression
+  {
+   Expression *expression;
+   struct functionDefinition *function;
+   bool found;
+  };
+
+struct profileSampleData
+  {
+   struct profileSample *Samples;
+   unsigned long long SamplesTaken;
+   unsigned long long SamplesDropped;
+   long SampleInterval;
+   bool Sampling;
+   volatile bool Suspended;
+#if defined(ESP_PLATFORM)
+   esp_timer_handle_t SampleTimer;
+#endif
+  };
+
+#define ProfileSampleData(theEnv) ((struct profileSampleData *) GetEnvironmentData(theEnv,PROFILE_SAMPLE_DATA))
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    DeallocateProfileSampleData(Environment *);
+   static bool                    StartSampleTimer(Environment *);
+   static void                    StopSampleTimer(Environment *);
+   static void                    RecordProfileSample(Environment *);
+   static size_t                  HashProfileSample(struct defrule *,struct defgeneric *,
+                                                    Expression *,Expression *,struct joinNode *);
+   static struct profileStack    *ResolveProfileSamples(Environment *,size_t *,size_t *);
+   static bool                    SameProfileStack(struct profileStack *,struct profileStack *);
+   static int                     CompareProfileStacks(const void *,const void *);
+   static int                     CompareSampledExpressions(const void *,const void *);
+   static void                    FindSampledExpressions(Environment *,struct sampledExpression *,size_t);
+   static void                    FindSampledExpression(Expression *,struct sampledExpression *,size_t);
+   static void                    AppendSampleStack(Environment *,StringBuilder *,struct profileStack *);
+   static void                    AppendConstructFrame(Environment *,StringBuilder *,ConstructHeader *);
+   static bool                    SampledProcedure(Environment *,struct profileSample *,ConstructHeader **);
+   static bool                    SampledProcedureInModule(Environment *,struct profileSample *,ConstructHeader **);
+#if DEFRULE_CONSTRUCT
+   static ConstructHeader        *SampledRule(Environment *,struct defrule *);
+   static Defrule                *SampledJoinRule(Environment *,struct joinNode *);
+   static bool                    SampledJoinInNetwork(struct joinNode *,struct joinNode *);
+   static void                    FindSampledJoinExpressions(struct joinNode *,struct sampledExpression *,size_t);
+#endif
+#if DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT
+   static void                    FindSampledFactPatternExpressions(struct factPatternNode *,struct sampledExpression *,size_t);
+#endif
+#if DEFRULE_CONSTRUCT && OBJECT_SYSTEM
+   static void                    FindSampledObjectPatternExpressions(OBJECT_PATTERN_NODE *,struct sampledExpression *,size_t);
+#endif
+#if (! RUN_TIME)
+   static void                    ProfileSampleClearFunction(Environment *,void *);
+#endif
+#if defined(ESP_PLATFORM)
+   static void                    SampleTimerCallback(void *);
+#else
+   static void                    SampleSignalHandler(int);
+#endif
+
+/***************************************/
+/* LOCAL INTERNAL VARIABLE DEFINITIONS */
+/***************************************/
+
+#if ! defined(ESP_PLATFORM)
+   static Environment * volatile  SampledEnvironment = NULL;
+   static pthread_t               SampledThread;
+#endif
+
+/********************************************************/
+/* ProfileSamplingDefinitions: Initializes the data and */
+/*   the commands used by the sampling profiler.        */
+/********************************************************/
+void ProfileSamplingDefinitions(
+  Environment *theEnv)
+  {
+   AllocateEnvironmentData(theEnv,PROFILE_SAMPLE_DATA,sizeof(struct profileSampleData),DeallocateProfileSampleData);
+
+   ProfileSampleData(theEnv)->SampleInterval = PROFILE_SAMPLE_INTERVAL;
+
+#if ! RUN_TIME
+   AddUDF(theEnv,"profile-samples","v",0,1,"l",ProfileSamplesCommand,"ProfileSamplesCommand",NULL);
+   AddUDF(theEnv,"set-profile-sample-interval","l",1,1,"l",SetProfileSampleIntervalCommand,"SetProfileSampleIntervalCommand",NULL);
+   AddUDF(theEnv,"get-profile-sample-interval","l",0,0,NULL,GetProfileSampleIntervalCommand,"GetProfileSampleIntervalCommand",NULL);
+#if PROFILE_SAMPLE_FILES
+   AddUDF(theEnv,"save-profile-samples","b",1,1,"sy",SaveProfileSamplesCommand,"SaveProfileSamplesCommand",NULL);
+#endif
+
+   AddClearFunction(theEnv,"profile-samples",ProfileSampleClearFunction,0,NULL);
+#endif
+  }
+
+/*******************************************************/
+/* DeallocateProfileSampleData: Stops the timer and    */
+/*   deallocates the histogram of the sampler.         */
+/*******************************************************/
+static void DeallocateProfileSampleData(
+  Environment *theEnv)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+
+   StopProfileSampling(theEnv);
+
+#if defined(ESP_PLATFORM)
+   if (theData->SampleTimer != NULL)
+     { esp_timer_delete(theData->SampleTimer); }
+#endif
+
+   if (theData->Samples != NULL)
+     { genfree(theEnv,theData->Samples,sizeof(struct profileSample) * PROFILE_SAMPLE_SLOTS); }
+  }
+
+/********************************************************/
+/* StartProfileSampling: Allocates the histogram if it  */
+/*   does not exist yet and starts the sample timer.    */
+/********************************************************/
+bool StartProfileSampling(
+  Environment *theEnv)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+
+   if (theData->Sampling)
+     { return true; }
+
+   if (theData->Samples == NULL)
+     {
+      theData->Samples = (struct profileSample *)
+                         genalloc(theEnv,sizeof(struct profileSample) * PROFILE_SAMPLE_SLOTS);
+      memset(theData->Samples,0,sizeof(struct profileSample) * PROFILE_SAMPLE_SLOTS);
+     }
+
+   if (! StartSampleTimer(theEnv))
+     {
+      PrintErrorID(theEnv,"PROFLSMP",1,false);
+#if defined(ESP_PLATFORM)
+      WriteString(theEnv,STDERR,"The profile sample timer could not be started.\n");
+#else
+      WriteString(theEnv,STDERR,"Another environment is already being sampled.\n");
+#endif
+      SetEvaluationError(theEnv,true);
+      return false;
+     }
+
+   theData->Sampling = true;
+
+   return true;
+  }
+
+/**************************************************/
+/* StopProfileSampling: Stops the sample timer.   */
+/*   The samples are kept until they are reset.   */
+/**************************************************/
+void StopProfileSampling(
+  Environment *theEnv)
+  {
+   if (! ProfileSampleData(theEnv)->Sampling)
+     { return; }
+
+   StopSampleTimer(theEnv);
+   ProfileSampleData(theEnv)->Sampling = false;
+  }
+
+/***************************************************/
+/* ProfileSamplingActive: Returns true if the      */
+/*   sample timer is running for the environment.  */
+/***************************************************/
+bool ProfileSamplingActive(
+  Environment *theEnv)
+  {
+   return ProfileSampleData(theEnv)->Sampling;
+  }
+
+/**********************************************/
+/* ResetProfileSamples: Empties the histogram */
+/*   and the sample counters.                 */
+/**********************************************/
+void ResetProfileSamples(
+  Environment *theEnv)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+
+   theData->Suspended = true;
+
+   if (theData->Samples != NULL)
+     { memset(theData->Samples,0,sizeof(struct profileSample) * PROFILE_SAMPLE_SLOTS); }
+
+   theData->SamplesTaken = 0;
+   theData->SamplesDropped = 0;
+
+   theData->Suspended = false;
+  }
+
+#if (! RUN_TIME)
+/**********************************************************/
+/* ProfileSampleClearFunction: Clear routine for the      */
+/*   sampler. The samples refer to the constructs and     */
+/*   joins being removed, so they are discarded as well.  */
+/**********************************************************/
+static void ProfileSampleClearFunction(
+  Environment *theEnv,
+  void *context)
+  {
+   ResetProfileSamples(theEnv);
+  }
+#endif
+
+/**********************************************************/
+/* SetProfileSampleInterval: Sets the number of           */
+/*   microseconds between samples, restarting the timer   */
+/*   if it is running. Returns the previous interval.     */
+/**********************************************************/
+long SetProfileSampleInterval(
+  Environment *theEnv,
+  long interval)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+   long oldInterval = theData->SampleInterval;
+
+   if (interval < PROFILE_SAMPLE_MINIMUM)
+     { interval = PROFILE_SAMPLE_MINIMUM; }
+
+   theData->SampleInterval = interval;
+
+   if (theData->Sampling)
+     {
+      StopSampleTimer(theEnv);
+      if (! StartSampleTimer(theEnv))
+        { theData->Sampling = false; }
+     }
+
+   return oldInterval;
+  }
+
+/*******************************************************/
+/* GetProfileSampleInterval: Returns the number of     */
+/*   microseconds between samples.                     */
+/*******************************************************/
+long GetProfileSampleInterval(
+  Environment *theEnv)
+  {
+   return ProfileSampleData(theEnv)->SampleInterval;
+  }
+
+#if defined(ESP_PLATFORM)
+
+/********************************************************/
+/* StartSampleTimer: Starts a periodic esp_timer which  */
+/*   samples the environment from the timer task.       */
+/********************************************************/
+static bool StartSampleTimer(
+  Environment *theEnv)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+   esp_timer_create_args_t timerArgs;
+
+   if (theData->SampleTimer == NULL)
+     {
+      memset(&timerArgs,0,sizeof(esp_timer_create_args_t));
+      timerArgs.callback = SampleTimerCallback;
+      timerArgs.arg = theEnv;
+      timerArgs.dispatch_method = ESP_TIMER_TASK;
+      timerArgs.name = "clips-profile";
+
+      if (esp_timer_create(&timerArgs,&theData->SampleTimer) != ESP_OK)
+        {
+         theData->SampleTimer = NULL;
+         return false;
+        }
+     }
+
+   return (esp_timer_start_periodic(theData->SampleTimer,(uint64_t) theData->SampleInterval) == ESP_OK);
+  }
+
+/**********************************************/
+/* StopSampleTimer: Stops the esp_timer. The  */
+/*   timer is kept for the next start.        */
+/**********************************************/
+static void StopSampleTimer(
+  Environment *theEnv)
+  {
+   if (ProfileSampleData(theEnv)->SampleTimer != NULL)
+     { esp_timer_stop(ProfileSampleData(theEnv)->SampleTimer); }
+  }
+
+/************************************************************/
+/* SampleTimerCallback: Runs in the esp_timer task while    */
+/*   the environment runs in the loop task. The pointers    */
+/*   read may be changing or already released, so they are  */
+/*   only copied here and not followed until the engine     */
+/*   thread finds them among its constructs when reporting. */
+/************************************************************/
+static void SampleTimerCallback(
+  void *context)
+  {
+   RecordProfileSample((Environment *) context);
+  }
+
+#else
+
+/**********************************************************/
+/* StartSampleTimer: Installs the SIGPROF handler and     */
+/*   starts the profiling interval timer, which counts    */
+/*   the processor time used by the process. The signal   */
+/*   may be delivered to any thread, so the handler only  */
+/*   samples when it interrupts the thread which started  */
+/*   the timer.                                           */
+/**********************************************************/
+static bool StartSampleTimer(
+  Environment *theEnv)
+  {
+   struct sigaction theAction;
+   struct itimerval theTimer;
+   long interval = ProfileSampleData(theEnv)->SampleInterval;
+
+   if ((SampledEnvironment != NULL) && (SampledEnvironment != theEnv))
+     { return false; }
+
+   SampledThread = pthread_self();
+   SampledEnvironment = theEnv;
+
+   memset(&theAction,0,sizeof(struct sigaction));
+   theAction.sa_handler = SampleSignalHandler;
+   theAction.sa_flags = SA_RESTART;
+   sigemptyset(&theAction.sa_mask);
+
+   if (sigaction(SIGPROF,&theAction,NULL) != 0)
+     {
+      SampledEnvironment = NULL;
+      return false;
+     }
+
+   theTimer.it_interval.tv_sec = interval / 1000000;
+   theTimer.it_interval.tv_usec = interval % 1000000;
+   theTimer.it_value = theTimer.it_interval;
+
+   if (setitimer(ITIMER_PROF,&theTimer,NULL) != 0)
+     {
+      SampledEnvironment = NULL;
+      return false;
+     }
+
+   return true;
+  }
+
+/**********************************************************/
+/* StopSampleTimer: Stops the interval timer. A signal    */
+/*   which is already pending is ignored rather than      */
+/*   given its default action of ending the process.      */
+/**********************************************************/
+static void StopSampleTimer(
+  Environment *theEnv)
+  {
+   struct itimerval theTimer;
+
+   if (SampledEnvironment != theEnv)
+     { return; }
+
+   memset(&theTimer,0,sizeof(struct itimerval));
+   setitimer(ITIMER_PROF,&theTimer,NULL);
+   signal(SIGPROF,SIG_IGN);
+
+   SampledEnvironment = NULL;
+  }
+
+/*******************************************************/
+/* SampleSignalHandler: Samples the environment if the */
+/*   signal interrupted the thread running it. Only    */
+/*   reads pointers and updates the histogram, so it   */
+/*   is safe to run inside the interrupted code.       */
+/*******************************************************/
+static void SampleSignalHandler(
+  int theSignal)
+  {
+   Environment *theEnv = SampledEnvironment;
+   int savedErrno = errno;
+
+   if ((theEnv != NULL) && pthread_equal(pthread_self(),SampledThread))
+     { RecordProfileSample(theEnv); }
+
+   errno = savedErrno;
+  }
+
+#endif
+
+/*************************************************************/
+/* RecordProfileSample: Counts the rule, generic function,   */
+/*   procedure actions, expression and join the environment  */
+/*   is executing. Only the pointers kept in the environment */
+/*   data are read. A tuple which finds no free slot within  */
+/*   a few probes is counted as dropped rather than          */
+/*   displacing an existing one.                             */
+/*************************************************************/
+static void RecordProfileSample(
+  Environment *theEnv)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+   struct profileSample *theSample;
+   struct defrule *theRule = NULL;
+   struct defgeneric *theGeneric = NULL;
+   struct joinNode *theJoin = NULL;
+   Expression *theActions, *theExpression;
+   size_t slot;
+   unsigned int probe;
+
+   if ((theData->Samples == NULL) || theData->Suspended)
+     { return; }
+
+#if DEFRULE_CONSTRUCT
+   theRule = EngineData(theEnv)->ExecutingRule;
+   theJoin = EngineData(theEnv)->GlobalJoin;
+#endif
+
+#if DEFGENERIC_CONSTRUCT
+   theGeneric = DefgenericData(theEnv)->CurrentGeneric;
+#endif
+
+   theActions = ProceduralPrimitiveData(theEnv)->CurrentProcActions;
+   theExpression = EvaluationData(theEnv)->CurrentExpression;
+
+   /*=====================================*/
+   /* Count the tuple in the first slot   */
+   /* holding it or the first empty slot. */
+   /*=====================================*/
+
+   theData->SamplesTaken++;
+
+   slot = HashProfileSample(theRule,theGeneric,theActions,theExpression,theJoin);
+
+   for (probe = 0; probe < PROFILE_SAMPLE_PROBES; probe++)
+     {
+      theSample = &theData->Samples[(slot + probe) % PROFILE_SAMPLE_SLOTS];
+
+      if (theSample->count == 0)
+        {
+         theSample->rule = theRule;
+         theSample->generic = theGeneric;
+         theSample->actions = theActions;
+         theSample->expression = theExpression;
+         theSample->join = theJoin;
+         theSample->count = 1;
+         return;
+        }
+
+      if ((theSample->rule == theRule) &&
+          (theSample->generic == theGeneric) &&
+          (theSample->actions == theActions) &&
+          (theSample->expression == theExpression) &&
+          (theSample->join == theJoin))
+        {
+         theSample->count++;
+         return;
+        }
+     }
+
+   theData->SamplesDropped++;
+  }
+
+/*********************************************************/
+/* HashProfileSample: Combines the pointers of a sample. */
+/*   Their low bits are always zero, so they are shifted */
+/*   out before the pointers are mixed.                  */
+/*********************************************************/
+static size_t HashProfileSample(
+  struct defrule *theRule,
+  struct defgeneric *theGeneric,
+  Expression *theActions,
+  Expression *theExpression,
+  struct joinNode *theJoin)
+  {
+   size_t tally;
+
+   tally = ((size_t) theRule) >> 3;
+   tally = (tally * 31) + (((size_t) theGeneric) >> 3);
+   tally = (tally * 31) + (((size_t) theActions) >> 3);
+   tally = (tally * 31) + (((size_t) theExpression) >> 3);
+   tally = (tally * 31) + (((size_t) theJoin) >> 3);
+   tally ^= (tally >> 11);
+
+   return tally % PROFILE_SAMPLE_SLOTS;
+  }
+
+/*************************************************************/
+/* ResolveProfileSamples: Returns an array of the stacks of  */
+/*   the used slots of the histogram, most frequent first.   */
+/*   Each pointer of a sample is only followed once it has   */
+/*   been found among the current rules, procedures, joins   */
+/*   and expressions. Samples which resolve to the same      */
+/*   frames are merged. The caller frees the array, whose    */
+/*   allocated length is stored in stackSpace.               */
+/*************************************************************/
+static struct profileStack *ResolveProfileSamples(
+  Environment *theEnv,
+  size_t *stackCount,
+  size_t *stackSpace)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+   struct profileSample *theSample;
+   struct profileStack *theStacks, *theStack;
+   struct sampledExpression *theExpressions = NULL, *found;
+   struct sampledExpression key;
+   size_t i, j, count = 0, expressionCount = 0;
+
+   *stackCount = 0;
+   *stackSpace = 0;
+
+   if (theData->Samples == NULL)
+     { return NULL; }
+
+   for (i = 0; i < PROFILE_SAMPLE_SLOTS; i++)
+     {
+      if (theData->Samples[i].count != 0)
+        { count++; }
+     }
+
+   if (count == 0)
+     { return NULL; }
+
+   /*=================================================*/
+   /* Look up all of the sampled expressions with one */
+   /* walk of the expressions of the constructs.      */
+   /*=================================================*/
+
+   theExpressions = (struct sampledExpression *) genalloc(theEnv,sizeof(struct sampledExpression) * count);
+
+   for (i = 0; i < PROFILE_SAMPLE_SLOTS; i++)
+     {
+      theSample = &theData->Samples[i];
+      if ((theSample->count != 0) && (theSample->expression != NULL))
+        {
+         theExpressions[expressionCount].expression = theSample->expression;
+         theExpressions[expressionCount].function = NULL;
+         theExpressions[expressionCount].found = false;
+         expressionCount++;
+        }
+     }
+
+   qsort(theExpressions,expressionCount,sizeof(struct sampledExpression),CompareSampledExpressions);
+   FindSampledExpressions(theEnv,theExpressions,expressionCount);
+
+   /*=====================================*/
+   /* Resolve each sample into its frames */
+   /* and merge the identical stacks.     */
+   /*=====================================*/
+
+   theStacks = (struct profileStack *) genalloc(theEnv,sizeof(struct profileStack) * count);
+   memset(theStacks,0,sizeof(struct profileStack) * count);
+
+   *stackSpace = count;
+   count = 0;
+
+   for (i = 0; i < PROFILE_SAMPLE_SLOTS; i++)
+     {
+      theSample = &theData->Samples[i];
+      if (theSample->count == 0)
+        { continue; }
+
+      theStack = &theStacks[count];
+      theStack->count = theSample->count;
+
+#if DEFRULE_CONSTRUCT
+      if (theSample->rule != NULL)
+        {
+         theStack->rule = SampledRule(theEnv,theSample->rule);
+         if (theStack->rule == NULL)
+           { theStack->unknown |= PROFILE_UNKNOWN_RULE; }
+        }
+
+      if (theSample->join != NULL)
+        {
+         theStack->joinRule = SampledJoinRule(theEnv,theSample->join);
+         if (theStack->joinRule != NULL)
+           { theStack->joinDepth = theSample->join->depth; }
+         else
+           { theStack->unknown |= PROFILE_UNKNOWN_JOIN; }
+        }
+#endif
+
+      if (! SampledProcedure(theEnv,theSample,&theStack->procedure))
+        { theStack->unknown |= PROFILE_UNKNOWN_PROCEDURE; }
+
+      if (theSample->expression != NULL)
+        {
+         key.expression = theSample->expression;
+         found = (struct sampledExpression *)
+                 bsearch(&key,theExpressions,expressionCount,
+                         sizeof(struct sampledExpression),CompareSampledExpressions);
+         if ((found != NULL) && found->found)
+           { theStack->function = found->function; }
+         else
+           { theStack->unknown |= PROFILE_UNKNOWN_FUNCTION; }
+        }
+
+      for (j = 0; j < count; j++)
+        {
+         if (SameProfileStack(&theStacks[j],theStack))
+           {
+            theStacks[j].count += theStack->count;
+            break;
+           }
+        }
+
+      if (j == count)
+        { count++; }
+      else
+        { memset(theStack,0,sizeof(struct profileStack)); }
+     }
+
+   genfree(theEnv,theExpressions,sizeof(struct sampledExpression) * (*stackSpace));
+
+   qsort(theStacks,count,sizeof(struct profileStack),CompareProfileStacks);
+
+   *stackCount = count;
+
+   return theStacks;
+  }
+
+/****************************************************/
+/* SameProfileStack: Returns true if two stacks are */
+/*   made of the same frames.                       */
+/****************************************************/
+static bool SameProfileStack(
+  struct profileStack *theFirst,
+  struct profileStack *theSecond)
+  {
+   return ((theFirst->rule == theSecond->rule) &&
+           (theFirst->procedure == theSecond->procedure) &&
+           (theFirst->joinRule == theSecond->joinRule) &&
+           (theFirst->joinDepth == theSecond->joinDepth) &&
+           (theFirst->function == theSecond->function) &&
+           (theFirst->unknown == theSecond->unknown));
+  }
+
+/***************************************************/
+/* CompareProfileStacks: Orders stacks by falling  */
+/*   count for qsort.                              */
+/***************************************************/
+static int CompareProfileStacks(
+  const void *theFirst,
+  const void *theSecond)
+  {
+   unsigned long firstCount = ((const struct profileStack *) theFirst)->count;
+   unsigned long secondCount = ((const struct profileStack *) theSecond)->count;
+
+   if (firstCount > secondCount) return -1;
+   if (firstCount < secondCount) return 1;
+   return 0;
+  }
+
+/*******************************************************/
+/* CompareSampledExpressions: Orders the expressions   */
+/*   looked up for the samples by address for qsort    */
+/*   and bsearch.                                      */
+/*******************************************************/
+static int CompareSampledExpressions(
+  const void *theFirst,
+  const void *theSecond)
+  {
+   size_t firstAddress = (size_t) ((const struct sampledExpression *) theFirst)->expression;
+   size_t secondAddress = (size_t) ((const struct sampledExpression *) theSecond)->expression;
+
+   if (firstAddress < secondAddress) return -1;
+   if (firstAddress > secondAddress) return 1;
+   return 0;
+  }
+
+/************************************************************/
+/* OutputProfileSamples: Prints the sampled stacks, most    */
+/*   frequent first, which are above the profile percent    */
+/*   threshold. A positive limit prints at most that many.  */
+/************************************************************/
+void OutputProfileSamples(
+  Environment *theEnv,
+  const char *logicalName,
+  long long limit)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+   struct profileStack *theStacks;
+   size_t stackCount, stackSpace, i;
+   StringBuilder *theSB;
+   double percent;
+   long long printed = 0;
+   char buffer[128];
+
+   theData->Suspended = true;
+
+   gensnprintf(buffer,sizeof(buffer),"Samples taken = %llu, dropped = %llu, interval = %ld microseconds\n",
+               theData->SamplesTaken,theData->SamplesDropped,theData->SampleInterval);
+   WriteString(theEnv,logicalName,buffer);
+   WriteString(theEnv,logicalName,"Samples        %  Stack\n");
+   WriteString(theEnv,logicalName,"-------   ------  -----\n");
+
+   theStacks = ResolveProfileSamples(theEnv,&stackCount,&stackSpace);
+   theSB = CreateStringBuilder(theEnv,128);
+
+   for (i = 0; i < stackCount; i++)
+     {
+      if ((limit > 0) && (printed >= limit))
+        { break; }
+
+      percent = (theStacks[i].count * 100.0) / (double) theData->SamplesTaken;
+      if (percent < ProfileFunctionData(theEnv)->PercentThreshold)
+        { break; }
+
+      SBReset(theSB);
+      AppendSampleStack(theEnv,theSB,&theStacks[i]);
+
+      gensnprintf(buffer,sizeof(buffer),"%7lu  %6.2f%%  ",theStacks[i].count,percent);
+      WriteString(theEnv,logicalName,buffer);
+      WriteString(theEnv,logicalName,theSB->contents);
+      WriteString(theEnv,logicalName,"\n");
+      printed++;
+     }
+
+   SBDispose(theSB);
+   if (theStacks != NULL)
+     { genfree(theEnv,theStacks,sizeof(struct profileStack) * stackSpace); }
+
+   theData->Suspended = false;
+  }
+
+#if PROFILE_SAMPLE_FILES
+
+/************************************************************/
+/* SaveProfileSamples: Writes the samples to a file in the  */
+/*   collapsed stack format, one "frame;frame count" line   */
+/*   per stack, which flame graph tools read directly.      */
+/************************************************************/
+bool SaveProfileSamples(
+  Environment *theEnv,
+  const char *fileName)
+  {
+   struct profileSampleData *theData = ProfileSampleData(theEnv);
+   struct profileStack *theStacks;
+   size_t stackCount, stackSpace, i;
+   StringBuilder *theSB;
+   FILE *theFile;
+
+   if ((theFile = GenOpen(theEnv,fileName,"w")) == NULL)
+     { return false; }
+
+   theData->Suspended = true;
+
+   theStacks = ResolveProfileSamples(theEnv,&stackCount,&stackSpace);
+   theSB = CreateStringBuilder(theEnv,128);
+
+   for (i = 0; i < stackCount; i++)
+     {
+      SBReset(theSB);
+      AppendSampleStack(theEnv,theSB,&theStacks[i]);
+      fprintf(theFile,"%s %lu\n",theSB->contents,theStacks[i].count);
+     }
+
+   SBDispose(theSB);
+   if (theStacks != NULL)
+     { genfree(theEnv,theStacks,sizeof(struct profileStack) * stackSpace); }
+
+   theData->Suspended = false;
+
+   GenClose(theEnv,theFile);
+
+   return true;
+  }
+
+#endif
+
+/*************************************************************/
+/* AppendSampleStack: Appends the frames of a stack from     */
+/*   the outermost to the innermost, separated by ";". A     */
+/*   pointer which could not be found is shown as [unknown]  */
+/*   and a stack with no frames as [idle].                   */
+/*************************************************************/
+static void AppendSampleStack(
+  Environment *theEnv,
+  StringBuilder *theSB,
+  struct profileStack *theStack)
+  {
+#if DEFRULE_CONSTRUCT
+   char buffer[32];
+#endif
+
+   if (theStack->rule != NULL)
+     { AppendConstructFrame(theEnv,theSB,theStack->rule); }
+   else if (theStack->unknown & PROFILE_UNKNOWN_RULE)
+     { SBAppend(theSB,"[unknown]"); }
+
+   if ((theStack->procedure != NULL) || (theStack->unknown & PROFILE_UNKNOWN_PROCEDURE))
+     {
+      if (theSB->length > 0) SBAppend(theSB,";");
+      if (theStack->procedure != NULL)
+        { AppendConstructFrame(theEnv,theSB,theStack->procedure); }
+      else
+        { SBAppend(theSB,"[unknown]"); }
+     }
+
+#if DEFRULE_CONSTRUCT
+   if ((theStack->joinRule != NULL) || (theStack->unknown & PROFILE_UNKNOWN_JOIN))
+     {
+      if (theSB->length > 0) SBAppend(theSB,";");
+      if (theStack->joinRule != NULL)
+        {
+         SBAppend(theSB,"join ");
+         SBAppend(theSB,DefruleModule(theStack->joinRule));
+         SBAppend(theSB,"::");
+         SBAppend(theSB,DefruleName(theStack->joinRule));
+         gensnprintf(buffer,sizeof(buffer),"/%u",(unsigned) theStack->joinDepth);
+         SBAppend(theSB,buffer);
+        }
+      else
+        { SBAppend(theSB,"[unknown]"); }
+     }
+#endif
+
+   if ((theStack->function != NULL) || (theStack->unknown & PROFILE_UNKNOWN_FUNCTION))
+     {
+      if (theSB->length > 0) SBAppend(theSB,";");
+      if (theStack->function != NULL)
+        { SBAppend(theSB,theStack->function->callFunctionName->contents); }
+      else
+        { SBAppend(theSB,"[unknown]"); }
+     }
+
+   if (theSB->length == 0)
+     { SBAppend(theSB,"[idle]"); }
+  }
+
+/*****************************************************/
+/* AppendConstructFrame: Appends the construct type  */
+/*   and the module qualified name of a construct.   */
+/*****************************************************/
+static void AppendConstructFrame(
+  Environment *theEnv,
+  StringBuilder *theSB,
+  ConstructHeader *theConstruct)
+  {
+#if OBJECT_SYSTEM
+   DefmessageHandler *theHandler;
+
+   if (theConstruct->constructType == DEFMESSAGE_HANDLER)
+     {
+      theHandler = (DefmessageHandler *) theConstruct;
+      SBAppend(theSB,"defmessage-handler ");
+      SBAppend(theSB,theHandler->cls->header.whichModule->theModule->header.name->contents);
+      SBAppend(theSB,"::");
+      SBAppend(theSB,theHandler->cls->header.name->contents);
+      SBAppend(theSB," ");
+      SBAppend(theSB,theConstruct->name->contents);
+      SBAppend(theSB," ");
+      SBAppend(theSB,MessageHandlerData(theEnv)->hndquals[theHandler->type]);
+      return;
+     }
+#endif
+
+   switch (theConstruct->constructType)
+     {
+      case DEFRULE:
+        SBAppend(theSB,"defrule ");
+        break;
+
+      case DEFFUNCTION:
+        SBAppend(theSB,"deffunction ");
+        break;
+
+      case DEFGENERIC:
+        SBAppend(theSB,"defgeneric ");
+        break;
+
+      default:
+        break;
+     }
+
+   SBAppend(theSB,theConstruct->whichModule->theModule->header.name->contents);
+   SBAppend(theSB,"::");
+   SBAppend(theSB,theConstruct->name->contents);
+  }
+
+/**************************************************************/
+/* SampledProcedure: Finds the procedure of a sample from the */
+/*   actions being run, falling back to the generic function  */
+/*   for a method implemented by a system function, whose     */
+/*   actions are a call built on the stack. Stores NULL for   */
+/*   no procedure or for the actions of the sampled rule.     */
+/*   Returns false if the procedure could not be found.       */
+/**************************************************************/
+static bool SampledProcedure(
+  Environment *theEnv,
+  struct profileSample *theSample,
+  ConstructHeader **theProcedure)
+  {
+   Defmodule *theModule;
+   bool found = false;
+
+   *theProcedure = NULL;
+
+   if ((theSample->actions == NULL) && (theSample->generic == NULL))
+     { return true; }
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        (theModule != NULL) && (! found);
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+      found = SampledProcedureInModule(theEnv,theSample,theProcedure);
+     }
+
+   RestoreCurrentModule(theEnv);
+
+   return found;
+  }
+
+/***********************************************************/
+/* SampledProcedureInModule: Looks for the sampled actions */
+/*   among the rules, deffunctions, methods and handlers   */
+/*   of the current module and then for the sampled        */
+/*   generic function. Only pointers are compared.         */
+/***********************************************************/
+static bool SampledProcedureInModule(
+  Environment *theEnv,
+  struct profileSample *theSample,
+  ConstructHeader **theProcedure)
+  {
+#if DEFRULE_CONSTRUCT
+   Defrule *theRule, *theDisjunct;
+#endif
+#if DEFFUNCTION_CONSTRUCT
+   Deffunction *theDeffunction;
+#endif
+#if DEFGENERIC_CONSTRUCT
+   Defgeneric *theDefgeneric;
+   unsigned short m;
+#endif
+#if OBJECT_SYSTEM
+   Defclass *theDefclass;
+   unsigned short i;
+#endif
+
+   if (theSample->actions != NULL)
+     {
+#if DEFRULE_CONSTRUCT
+      for (theRule = GetNextDefrule(theEnv,NULL);
+           theRule != NULL;
+           theRule = GetNextDefrule(theEnv,theRule))
+        {
+         for (theDisjunct = theRule;
+              theDisjunct != NULL;
+              theDisjunct = theDisjunct->disjunct)
+           {
+            if (theDisjunct->actions == theSample->actions)
+              { return true; }
+           }
+        }
+#endif
+
+#if DEFFUNCTION_CONSTRUCT
+      for (theDeffunction = GetNextDeffunction(theEnv,NULL);
+           theDeffunction != NULL;
+           theDeffunction = GetNextDeffunction(theEnv,theDeffunction))
+        {
+         if (theDeffunction->code == theSample->actions)
+           {
+            *theProcedure = &theDeffunction->header;
+            return true;
+           }
+        }
+#endif
+
+#if DEFGENERIC_CONSTRUCT
+      for (theDefgeneric = GetNextDefgeneric(theEnv,NULL);
+           theDefgeneric != NULL;
+           theDefgeneric = GetNextDefgeneric(theEnv,theDefgeneric))
+        {
+         for (m = 0; m < theDefgeneric->mcnt; m++)
+           {
+            if (theDefgeneric->methods[m].actions == theSample->actions)
+              {
+               *theProcedure = &theDefgeneric->header;
+               return true;
+              }
+           }
+        }
+#endif
+
+#if OBJECT_SYSTEM
+      for (theDefclass = GetNextDefclass(theEnv,NULL);
+           theDefclass != NULL;
+           theDefclass = GetNextDefclass(theEnv,theDefclass))
+        {
+         for (i = 0; i < theDefclass->handlerCount; i++)
+           {
+            if (theDefclass->handlers[i].actions == theSample->actions)
+              {
+               *theProcedure = &theDefclass->handlers[i].header;
+               return true;
+              }
+           }
+        }
+#endif
+     }
+
+#if DEFGENERIC_CONSTRUCT
+   if (theSample->generic != NULL)
+     {
+      for (theDefgeneric = GetNextDefgeneric(theEnv,NULL);
+           theDefgeneric != NULL;
+           theDefgeneric = GetNextDefgeneric(theEnv,theDefgeneric))
+        {
+         if (theDefgeneric == theSample->generic)
+           {
+            *theProcedure = &theDefgeneric->header;
+            return true;
+           }
+        }
+     }
+#endif
+
+   return false;
+  }
+
+/************************************************************/
+/* FindSampledExpressions: Marks the sampled expressions    */
+/*   found in the actions, tests and pattern networks of    */
+/*   the constructs and in the command being executed, and  */
+/*   stores the function each one calls.                    */
+/************************************************************/
+static void FindSampledExpressions(
+  Environment *theEnv,
+  struct sampledExpression *theExpressions,
+  size_t count)
+  {
+   Defmodule *theModule;
+#if DEFRULE_CONSTRUCT
+   Defrule *theRule, *theDisjunct;
+#endif
+#if DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT
+   Deftemplate *theDeftemplate;
+#endif
+#if DEFRULE_CONSTRUCT && OBJECT_SYSTEM
+   OBJECT_ALPHA_NODE *theAlphaNode;
+#endif
+#if DEFFUNCTION_CONSTRUCT
+   Deffunction *theDeffunction;
+#endif
+#if DEFGENERIC_CONSTRUCT
+   Defgeneric *theDefgeneric;
+   unsigned short m, r;
+#endif
+#if OBJECT_SYSTEM
+   Defclass *theDefclass;
+   unsigned short i;
+#endif
+
+   if (count == 0)
+     { return; }
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+
+#if DEFRULE_CONSTRUCT
+      for (theRule = GetNextDefrule(theEnv,NULL);
+           theRule != NULL;
+           theRule = GetNextDefrule(theEnv,theRule))
+        {
+         for (theDisjunct = theRule;
+              theDisjunct != NULL;
+              theDisjunct = theDisjunct->disjunct)
+           {
+            FindSampledExpression(theDisjunct->actions,theExpressions,count);
+            FindSampledExpression(theDisjunct->dynamicSalience,theExpressions,count);
+            FindSampledJoinExpressions(theDisjunct->lastJoin,theExpressions,count);
+           }
+        }
+#endif
+
+#if DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT
+      for (theDeftemplate = GetNextDeftemplate(theEnv,NULL);
+           theDeftemplate != NULL;
+           theDeftemplate = GetNextDeftemplate(theEnv,theDeftemplate))
+        { FindSampledFactPatternExpressions(theDeftemplate->patternNetwork,theExpressions,count); }
+#endif
+
+#if DEFFUNCTION_CONSTRUCT
+      for (theDeffunction = GetNextDeffunction(theEnv,NULL);
+           theDeffunction != NULL;
+           theDeffunction = GetNextDeffunction(theEnv,theDeffunction))
+        { FindSampledExpression(theDeffunction->code,theExpressions,count); }
+#endif
+
+#if DEFGENERIC_CONSTRUCT
+      for (theDefgeneric = GetNextDefgeneric(theEnv,NULL);
+           theDefgeneric != NULL;
+           theDefgeneric = GetNextDefgeneric(theEnv,theDefgeneric))
+        {
+         for (m = 0; m < theDefgeneric->mcnt; m++)
+           {
+            FindSampledExpression(theDefgeneric->methods[m].actions,theExpressions,count);
+            for (r = 0; r < theDefgeneric->methods[m].restrictionCount; r++)
+              { FindSampledExpression(theDefgeneric->methods[m].restrictions[r].query,theExpressions,count); }
+           }
+        }
+#endif
+
+#if OBJECT_SYSTEM
+      for (theDefclass = GetNextDefclass(theEnv,NULL);
+           theDefclass != NULL;
+           theDefclass = GetNextDefclass(theEnv,theDefclass))
+        {
+         for (i = 0; i < theDefclass->handlerCount; i++)
+           { FindSampledExpression(theDefclass->handlers[i].actions,theExpressions,count); }
+        }
+#endif
+     }
+
+   RestoreCurrentModule(theEnv);
+
+#if DEFRULE_CONSTRUCT && OBJECT_SYSTEM
+   FindSampledObjectPatternExpressions(ObjectNetworkPointer(theEnv),theExpressions,count);
+
+   for (theAlphaNode = ObjectNetworkTerminalPointer(theEnv);
+        theAlphaNode != NULL;
+        theAlphaNode = theAlphaNode->nxtTerminal)
+     { FindSampledExpression(theAlphaNode->header.rightHash,theExpressions,count); }
+#endif
+
+#if ! RUN_TIME
+   FindSampledExpression(CommandLineData(theEnv)->CurrentCommand,theExpressions,count);
+#endif
+  }
+
+/*************************************************************/
+/* FindSampledExpression: Marks the nodes of an expression   */
+/*   which are among the sampled expressions. A node which   */
+/*   is not a function call is found but calls no function.  */
+/*************************************************************/
+static void FindSampledExpression(
+  Expression *theExpression,
+  struct sampledExpression *theExpressions,
+  size_t count)
+  {
+   struct sampledExpression key, *found;
+
+   for (;
+        theExpression != NULL;
+        theExpression = theExpression->nextArg)
+     {
+      key.expression = theExpression;
+      found = (struct sampledExpression *)
+              bsearch(&key,theExpressions,count,sizeof(struct sampledExpression),CompareSampledExpressions);
+
+      if (found != NULL)
+        {
+         found->found = true;
+         if (theExpression->type == FCALL)
+           { found->function = theExpression->functionValue; }
+        }
+
+      FindSampledExpression(theExpression->argList,theExpressions,count);
+     }
+  }
+
+#if DEFRULE_CONSTRUCT
+
+/***************************************************/
+/* SampledRule: Returns the header of the sampled  */
+/*   rule or disjunct, or NULL if it is not among  */
+/*   the rules of any module.                      */
+/***************************************************/
+static ConstructHeader *SampledRule(
+  Environment *theEnv,
+  struct defrule *theSampledRule)
+  {
+   Defmodule *theModule;
+   Defrule *theRule, *theDisjunct;
+   ConstructHeader *found = NULL;
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        (theModule != NULL) && (found == NULL);
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+
+      for (theRule = GetNextDefrule(theEnv,NULL);
+           (theRule != NULL) && (found == NULL);
+           theRule = GetNextDefrule(theEnv,theRule))
+        {
+         for (theDisjunct = theRule;
+              theDisjunct != NULL;
+              theDisjunct = theDisjunct->disjunct)
+           {
+            if (theDisjunct == theSampledRule)
+              {
+               found = &theDisjunct->header;
+               break;
+              }
+           }
+        }
+     }
+
+   RestoreCurrentModule(theEnv);
+
+   return found;
+  }
+
+/*******************************************************/
+/* SampledJoinRule: Returns the first rule whose join  */
+/*   network contains a sampled join, or NULL if the   */
+/*   join belongs to no current rule.                  */
+/*******************************************************/
+static Defrule *SampledJoinRule(
+  Environment *theEnv,
+  struct joinNode *theJoin)
+  {
+   Defmodule *theModule;
+   Defrule *theRule, *theDisjunct, *found = NULL;
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        (theModule != NULL) && (found == NULL);
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+
+      for (theRule = GetNextDefrule(theEnv,NULL);
+           (theRule != NULL) && (found == NULL);
+           theRule = GetNextDefrule(theEnv,theRule))
+        {
+         for (theDisjunct = theRule;
+              theDisjunct != NULL;
+              theDisjunct = theDisjunct->disjunct)
+           {
+            if (SampledJoinInNetwork(theDisjunct->lastJoin,theJoin))
+              {
+               found = theRule;
+               break;
+              }
+           }
+        }
+     }
+
+   RestoreCurrentModule(theEnv);
+
+   return found;
+  }
+
+/*********************************************************/
+/* SampledJoinInNetwork: Returns true if a join is found */
+/*   walking back from the last join of a rule, entering */
+/*   the joins of not/and subnetworks from the right.    */
+/*********************************************************/
+static bool SampledJoinInNetwork(
+  struct joinNode *theNetwork,
+  struct joinNode *theJoin)
+  {
+   for (;
+        theNetwork != NULL;
+        theNetwork = theNetwork->lastLevel)
+     {
+      if (theNetwork == theJoin)
+        { return true; }
+
+      if (theNetwork->joinFromTheRight &&
+          SampledJoinInNetwork((struct joinNode *) theNetwork->rightSideEntryStructure,theJoin))
+        { return true; }
+     }
+
+   return false;
+  }
+
+/***********************************************************/
+/* FindSampledJoinExpressions: Marks the sampled nodes of  */
+/*   the tests and hash expressions of the joins of a rule */
+/*   walked as in SampledJoinInNetwork.                    */
+/***********************************************************/
+static void FindSampledJoinExpressions(
+  struct joinNode *theNetwork,
+  struct sampledExpression *theExpressions,
+  size_t count)
+  {
+   for (;
+        theNetwork != NULL;
+        theNetwork = theNetwork->lastLevel)
+     {
+      FindSampledExpression(theNetwork->networkTest,theExpressions,count);
+      FindSampledExpression(theNetwork->secondaryNetworkTest,theExpressions,count);
+      FindSampledExpression(theNetwork->leftHash,theExpressions,count);
+      FindSampledExpression(theNetwork->rightHash,theExpressions,count);
+
+      if (theNetwork->joinFromTheRight)
+        { FindSampledJoinExpressions((struct joinNode *) theNetwork->rightSideEntryStructure,theExpressions,count); }
+     }
+  }
+
+#endif
+
+#if DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT
+
+/*************************************************************/
+/* FindSampledFactPatternExpressions: Marks the sampled      */
+/*   nodes of the tests of a deftemplate's pattern network.  */
+/*************************************************************/
+static void FindSampledFactPatternExpressions(
+  struct factPatternNode *thePattern,
+  struct sampledExpression *theExpressions,
+  size_t count)
+  {
+   for (;
+        thePattern != NULL;
+        thePattern = thePattern->rightNode)
+     {
+      FindSampledExpression(thePattern->networkTest,theExpressions,count);
+      FindSampledExpression(thePattern->header.rightHash,theExpressions,count);
+      FindSampledFactPatternExpressions(thePattern->nextLevel,theExpressions,count);
+     }
+  }
+
+#endif
+
+#if DEFRULE_CONSTRUCT && OBJECT_SYSTEM
+
+/*************************************************************/
+/* FindSampledObjectPatternExpressions: Marks the sampled    */
+/*   nodes of the tests of the object pattern network.       */
+/*************************************************************/
+static void FindSampledObjectPatternExpressions(
+  OBJECT_PATTERN_NODE *thePattern,
+  struct sampledExpression *theExpressions,
+  size_t count)
+  {
+   for (;
+        thePattern != NULL;
+        thePattern = thePattern->rightNode)
+     {
+      FindSampledExpression(thePattern->networkTest,theExpressions,count);
+      FindSampledObjectPatternExpressions(thePattern->nextLevel,theExpressions,count);
+     }
+  }
+
+#endif
+
+/*********************************************/
+/* ProfileSamplesCommand: H/L access routine */
+/*   for the profile-samples command.        */
+/*********************************************/
+void ProfileSamplesCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   long long limit = 0;
+
+   if (UDFHasNextArgument(context))
+     {
+      if (! UDFFirstArgument(context,INTEGER_BIT,&theArg))
+        { return; }
+
+      limit = theArg.integerValue->contents;
+      if (limit < 0)
+        {
+         UDFInvalidArgumentMessage(context,"integer greater than or equal to 0");
+         return;
+        }
+     }
+
+   OutputProfileSamples(theEnv,STDOUT,limit);
+  }
+
+/*******************************************************/
+/* SetProfileSampleIntervalCommand: H/L access routine */
+/*   for the set-profile-sample-interval command.      */
+/*******************************************************/
+void SetProfileSampleIntervalCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   long long interval;
+
+   if (! UDFFirstArgument(context,INTEGER_BIT,&theArg))
+     { return; }
+
+   interval = theArg.integerValue->contents;
+   if ((interval < PROFILE_SAMPLE_MINIMUM) || (interval > 1000000000LL))
+     {
+      UDFInvalidArgumentMessage(context,"integer in the range 100 to 1000000000");
+      returnValue->integerValue = CreateInteger(theEnv,-1);
+      return;
+     }
+
+   returnValue->integerValue = CreateInteger(theEnv,SetProfileSampleInterval(theEnv,(long) interval));
+  }
+
+/*******************************************************/
+/* GetProfileSampleIntervalCommand: H/L access routine */
+/*   for the get-profile-sample-interval command.      */
+/*******************************************************/
+void GetProfileSampleIntervalCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->integerValue = CreateInteger(theEnv,GetProfileSampleInterval(theEnv));
+  }
+
+#if PROFILE_SAMPLE_FILES
+
+/*************************************************/
+/* SaveProfileSamplesCommand: H/L access routine */
+/*   for the save-profile-samples command.       */
+/*************************************************/
+void SaveProfileSamplesCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   const char *fileName;
+
+   if (! UDFFirstArgument(context,LEXEME_BITS,&theArg))
+     { return; }
+   fileName = theArg.lexemeValue->contents;
+
+   if (! SaveProfileSamples(theEnv,fileName))
+     {
+      OpenErrorMessage(theEnv,"save-profile-samples",fileName);
+      returnValue->lexemeValue = FalseSymbol(theEnv);
+      return;
+     }
+
+   returnValue->lexemeValue = TrueSymbol(theEnv);
+  }
+
+#endif
+
+#endif /* PROFILE_SAMPLING_FUNCTIONS */
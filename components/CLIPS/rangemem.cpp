@@ -0,0 +1,1203 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                 RANGE MEMORY MODULE                 */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Provides sorted (range) indices over the left    */
+/*   and right memories of joins whose tests compare a       */
+/*   numeric value from the RHS pattern against numeric      */
+/*   values from the LHS patterns, such as the time window   */
+/*   (reading (t ?t&:(> ?t ?t0)&:(< ?t (+ ?t0 10)))). When   */
+/*   a partial match enters the join, only the partial       */
+/*   matches in the opposite memory whose key falls within   */
+/*   the bounds are compared rather than the entire memory.  */
+/*                                                           */
+/*   The index only removes partial matches for which the    */
+/*   join test is known to fail without an error: the        */
+/*   comparisons used must be preceded in the join test only */
+/*   by tests which cannot generate errors, and partial      */
+/*   matches whose key is not a number are always compared.  */
+/*   The remaining partial matches are compared in the same  */
+/*   order as they appear in the memory so that activations  */
+/*   are generated in the same order as with a full scan.    */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if DEFRULE_CONSTRUCT
+
+#include "bmathfun.h"
+#include "constant.h"
+#include "engine.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "factgen.h"
+#include "memalloc.h"
+#include "reteutil.h"
+#include "ruledef.h"
+
+#include "rangemem.h"
+
+#define RANGE_NO_SIDE   0
+#define RANGE_LEFT      1
+#define RANGE_RIGHT     2
+#define RANGE_INVALID   3
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static bool                    ErrorFreeJoinTest(Environment *,struct expr *);
+   static bool                    ErrorFreeArgument(struct expr *);
+   static int                     RangeKeySide(Environment *,struct joinNode *,struct expr *);
+#if DEFTEMPLATE_CONSTRUCT
+   static int                     GetterSide(struct joinNode *,struct expr *);
+#endif
+   static int                     CombineSides(int,int);
+   static bool                    IdenticalRangeKey(struct expr *,struct expr *);
+   static bool                    RangeKeyValue(Environment *,struct expr *,bool *,long long *,double *);
+   static bool                    EvaluateRangeKey(Environment *,struct joinNode *,struct expr *,
+                                                   struct partialMatch *,int,double *);
+   static void                    BuildLeftRangeMemory(Environment *,struct joinNode *);
+   static void                    BuildRightRangeMemory(Environment *,struct joinNode *);
+   static void                    AddRangeEntry(Environment *,struct rangeMemory *,struct partialMatch *,
+                                                unsigned long,bool,double,long long);
+   static void                    RemoveRangeEntry(struct rangeMemory *,struct partialMatch *,
+                                                   unsigned long,bool,double);
+   static void                    ReleaseRangeMemory(Environment *,struct rangeMemory *);
+   static unsigned long           LowerRangePosition(struct rangeMemory *,unsigned long,double);
+   static unsigned long           UpperRangePosition(struct rangeMemory *,unsigned long,double);
+   static int                     CompareRangeOrder(const void *,const void *);
+
+/*********************************************************/
+/* CreateJoinRangeIndex: Examines the network test of a  */
+/*   join to determine if a range index can be used for  */
+/*   its memories. The conjuncts of the test are scanned */
+/*   in order. Comparisons (<, <=, >, >=, or =) between  */
+/*   an expression of the RHS pattern and an expression  */
+/*   of the LHS patterns become the bounds of the index. */
+/*   The scan stops at the first conjunct which is not a */
+/*   usable comparison and which could generate an error */
+/*   since skipping the evaluation of that conjunct      */
+/*   would suppress the error message. Returns NULL if   */
+/*   no bounds were found.                               */
+/*********************************************************/
+struct joinRangeIndex *CreateJoinRangeIndex(
+  Environment *theEnv,
+  struct joinNode *theJoin)
+  {
+   struct expr *theTest, *arg1, *arg2, *rightKey, *leftKey;
+   struct expr *lowerBound = NULL, *upperBound = NULL, *firstBound = NULL;
+   FunctionDefinition *theFunction;
+   struct joinRangeIndex *theIndex;
+   int side1, side2;
+   bool lower, upper;
+
+   if (theJoin->firstJoin || theJoin->joinFromTheRight ||
+       (theJoin->networkTest == NULL))
+     { return NULL; }
+
+   /*=============================================*/
+   /* Get the list of conjuncts in the join test. */
+   /*=============================================*/
+
+   theTest = theJoin->networkTest;
+   if ((theTest->type == FCALL) &&
+       (theTest->value == ExpressionData(theEnv)->PTR_AND))
+     { theTest = theTest->argList; }
+
+   rightKey = NULL;
+
+   for (;
+        theTest != NULL;
+        theTest = theTest->nextArg)
+     {
+      /*=================================================*/
+      /* Tests which can't generate errors can be safely */
+      /* skipped over when the partial match is removed  */
+      /* from consideration by one of the later bounds.  */
+      /*=================================================*/
+
+      if (ErrorFreeJoinTest(theEnv,theTest))
+        { continue; }
+
+      /*======================================================*/
+      /* Determine if the test is a two argument comparison.  */
+      /*======================================================*/
+
+      if (theTest->type != FCALL)
+        { break; }
+
+      theFunction = theTest->functionValue;
+      arg1 = theTest->argList;
+      if ((arg1 == NULL) || (arg1->nextArg == NULL) || (arg1->nextArg->nextArg != NULL))
+        { break; }
+      arg2 = arg1->nextArg;
+
+      /*==========================================================*/
+      /* One argument must only reference the RHS pattern and     */
+      /* the other must only reference the LHS patterns. Flip     */
+      /* the comparison so that it is from the RHS point of view. */
+      /*==========================================================*/
+
+      side1 = RangeKeySide(theEnv,theJoin,arg1);
+      side2 = RangeKeySide(theEnv,theJoin,arg2);
+
+      if ((side1 == RANGE_RIGHT) && (side2 == RANGE_LEFT))
+        {
+         if ((theFunction == ExpressionData(theEnv)->PTR_GT) ||
+             (theFunction == ExpressionData(theEnv)->PTR_GE))
+           { lower = true; upper = false; }
+         else if ((theFunction == ExpressionData(theEnv)->PTR_LT) ||
+                  (theFunction == ExpressionData(theEnv)->PTR_LE))
+           { lower = false; upper = true; }
+         else if (theFunction == ExpressionData(theEnv)->PTR_NUM_EQ)
+           { lower = true; upper = true; }
+         else
+           { break; }
+
+         if (rightKey == NULL)
+           { rightKey = arg1; }
+         else if (! IdenticalRangeKey(rightKey,arg1))
+           { break; }
+
+         leftKey = arg2;
+        }
+      else if ((side1 == RANGE_LEFT) && (side2 == RANGE_RIGHT))
+        {
+         if ((theFunction == ExpressionData(theEnv)->PTR_LT) ||
+             (theFunction == ExpressionData(theEnv)->PTR_LE))
+           { lower = true; upper = false; }
+         else if ((theFunction == ExpressionData(theEnv)->PTR_GT) ||
+                  (theFunction == ExpressionData(theEnv)->PTR_GE))
+           { lower = false; upper = true; }
+         else if (theFunction == ExpressionData(theEnv)->PTR_NUM_EQ)
+           { lower = true; upper = true; }
+         else
+           { break; }
+
+         if (rightKey == NULL)
+           { rightKey = arg2; }
+         else if (! IdenticalRangeKey(rightKey,arg2))
+           { break; }
+
+         leftKey = arg1;
+        }
+      else
+        { break; }
+
+      /*===================================================*/
+      /* A second bound of the same kind is not used. The  */
+      /* scan stops since the comparison may fail with an  */
+      /* error for a non-numeric value of its LHS bound.   */
+      /*===================================================*/
+
+      if ((lower && (lowerBound != NULL)) ||
+          (upper && (upperBound != NULL)))
+        { break; }
+
+      if (lower) lowerBound = leftKey;
+      if (upper) upperBound = leftKey;
+      if (firstBound == NULL) firstBound = leftKey;
+
+      if ((lowerBound != NULL) && (upperBound != NULL))
+        { break; }
+     }
+
+   if (firstBound == NULL)
+     { return NULL; }
+
+   /*=========================*/
+   /* Create the range index. */
+   /*=========================*/
+
+   theIndex = get_struct(theEnv,joinRangeIndex);
+   memset(theIndex,0,sizeof(struct joinRangeIndex));
+
+   theIndex->rightKey = rightKey;
+   theIndex->lowerBound = lowerBound;
+   theIndex->upperBound = upperBound;
+   theIndex->leftKey = firstBound;
+   theIndex->leftKeyIsLower = (firstBound == lowerBound);
+
+   return theIndex;
+  }
+
+/*******************************************************/
+/* ReturnJoinRangeIndex: Returns the range index and   */
+/*   the range memories associated with a join.        */
+/*******************************************************/
+void ReturnJoinRangeIndex(
+  Environment *theEnv,
+  struct joinNode *theJoin)
+  {
+   if (theJoin->rangeIndex == NULL) return;
+
+   ReleaseRangeMemory(theEnv,&theJoin->rangeIndex->leftMemory);
+   ReleaseRangeMemory(theEnv,&theJoin->rangeIndex->rightMemory);
+   rtn_struct(theEnv,joinRangeIndex,theJoin->rangeIndex);
+   theJoin->rangeIndex = NULL;
+  }
+
+/*******************************************************/
+/* ReleaseJoinRangeMemories: Returns the range         */
+/*   memories of a join without returning its range    */
+/*   index. They are rebuilt from the left and right   */
+/*   memories of the join when next needed.            */
+/*******************************************************/
+void ReleaseJoinRangeMemories(
+  Environment *theEnv,
+  struct joinNode *theJoin)
+  {
+   if (theJoin->rangeIndex == NULL) return;
+
+   ReleaseRangeMemory(theEnv,&theJoin->rangeIndex->leftMemory);
+   ReleaseRangeMemory(theEnv,&theJoin->rangeIndex->rightMemory);
+  }
+
+/*****************************************************/
+/* ErrorFreeJoinTest: Determines if a conjunct of a  */
+/*   join test can be evaluated without generating   */
+/*   an error or other side effects.                 */
+/*****************************************************/
+static bool ErrorFreeJoinTest(
+  Environment *theEnv,
+  struct expr *theTest)
+  {
+   struct expr *theArg;
+
+   switch (theTest->type)
+     {
+      case FACT_JN_CMP1:
+      case FACT_JN_CMP2:
+#if OBJECT_SYSTEM
+      case OBJ_JN_CMP1:
+      case OBJ_JN_CMP2:
+      case OBJ_JN_CMP3:
+#endif
+        return true;
+
+      case FCALL:
+        if ((theTest->value != ExpressionData(theEnv)->PTR_EQ) &&
+            (theTest->value != ExpressionData(theEnv)->PTR_NEQ))
+          { return false; }
+
+        for (theArg = theTest->argList;
+             theArg != NULL;
+             theArg = theArg->nextArg)
+          {
+           if (! ErrorFreeArgument(theArg))
+             { return false; }
+          }
+
+        return true;
+
+      default:
+        return false;
+     }
+  }
+
+/***************************************************/
+/* ErrorFreeArgument: Determines if an argument to */
+/*   the eq or neq function is a constant or a     */
+/*   fact join network variable reference.         */
+/***************************************************/
+static bool ErrorFreeArgument(
+  struct expr *theArg)
+  {
+   switch (theArg->type)
+     {
+      case FLOAT_TYPE:
+      case INTEGER_TYPE:
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+      case FACT_JN_VAR1:
+      case FACT_JN_VAR2:
+      case FACT_JN_VAR3:
+        return true;
+
+      default:
+        return false;
+     }
+  }
+
+/******************************************************/
+/* RangeKeySide: Determines if an expression can be   */
+/*   used as the key of a range memory and returns    */
+/*   the side of the join (RANGE_LEFT or RANGE_RIGHT) */
+/*   whose partial matches it references. The key can */
+/*   be a fact variable reference or a numeric        */
+/*   constant, or the functions +, -, and * applied   */
+/*   to these.                                        */
+/******************************************************/
+static int RangeKeySide(
+  Environment *theEnv,
+  struct joinNode *theJoin,
+  struct expr *theExpr)
+  {
+   struct expr *theArg;
+   FunctionDefinition *theFunction;
+   int side;
+
+   switch (theExpr->type)
+     {
+      case FLOAT_TYPE:
+      case INTEGER_TYPE:
+        return RANGE_NO_SIDE;
+
+#if DEFTEMPLATE_CONSTRUCT
+      case FACT_JN_VAR1:
+      case FACT_JN_VAR2:
+      case FACT_JN_VAR3:
+        return GetterSide(theJoin,theExpr);
+#endif
+
+      case FCALL:
+        theFunction = theExpr->functionValue;
+        if ((theFunction->functionPointer != AdditionFunction) &&
+            (theFunction->functionPointer != SubtractionFunction) &&
+            (theFunction->functionPointer != MultiplicationFunction))
+          { return RANGE_INVALID; }
+
+        side = RANGE_NO_SIDE;
+        for (theArg = theExpr->argList;
+             theArg != NULL;
+             theArg = theArg->nextArg)
+          { side = CombineSides(side,RangeKeySide(theEnv,theJoin,theArg)); }
+
+        return side;
+
+      default:
+        return RANGE_INVALID;
+     }
+  }
+
+#if DEFTEMPLATE_CONSTRUCT
+
+/*******************************************************/
+/* GetterSide: Returns the side of the join referenced */
+/*   by a fact join network variable reference.        */
+/*******************************************************/
+static int GetterSide(
+  struct joinNode *theJoin,
+  struct expr *theExpr)
+  {
+   const void *theContents = ((CLIPSBitMap *) theExpr->value)->contents;
+   unsigned int lhs, rhs;
+   unsigned short whichPattern;
+
+   switch (theExpr->type)
+     {
+      case FACT_JN_VAR1:
+        if (((const struct factGetVarJN1Call *) theContents)->factAddress)
+          { return RANGE_INVALID; }
+        lhs = ((const struct factGetVarJN1Call *) theContents)->lhs;
+        rhs = ((const struct factGetVarJN1Call *) theContents)->rhs;
+        whichPattern = ((const struct factGetVarJN1Call *) theContents)->whichPattern;
+        break;
+
+      case FACT_JN_VAR2:
+        lhs = ((const struct factGetVarJN2Call *) theContents)->lhs;
+        rhs = ((const struct factGetVarJN2Call *) theContents)->rhs;
+        whichPattern = ((const struct factGetVarJN2Call *) theContents)->whichPattern;
+        break;
+
+      default:
+        lhs = ((const struct factGetVarJN3Call *) theContents)->lhs;
+        rhs = ((const struct factGetVarJN3Call *) theContents)->rhs;
+        whichPattern = ((const struct factGetVarJN3Call *) theContents)->whichPattern;
+        break;
+     }
+
+   if (lhs)
+     { return RANGE_LEFT; }
+   else if (rhs)
+     { return RANGE_RIGHT; }
+   else if ((theJoin->depth - 1) == whichPattern)
+     { return RANGE_RIGHT; }
+
+   return RANGE_LEFT;
+  }
+
+#endif /* DEFTEMPLATE_CONSTRUCT */
+
+/****************************************************/
+/* CombineSides: Combines the sides referenced by   */
+/*   two parts of a key expression. A key which     */
+/*   references both sides can't be used.           */
+/****************************************************/
+static int CombineSides(
+  int side1,
+  int side2)
+  {
+   if ((side1 == RANGE_INVALID) || (side2 == RANGE_INVALID))
+     { return RANGE_INVALID; }
+
+   if (side1 == RANGE_NO_SIDE) return side2;
+   if (side2 == RANGE_NO_SIDE) return side1;
+   if (side1 == side2) return side1;
+
+   return RANGE_INVALID;
+  }
+
+/*****************************************************/
+/* IdenticalRangeKey: Determines if two arguments of */
+/*   comparisons are the same expression. Unlike     */
+/*   IdenticalExpression, the arguments following    */
+/*   the two expressions are not compared.           */
+/*****************************************************/
+static bool IdenticalRangeKey(
+  struct expr *key1,
+  struct expr *key2)
+  {
+   if ((key1->type != key2->type) ||
+       (key1->value != key2->value))
+     { return false; }
+
+   return IdenticalExpression(key1->argList,key2->argList);
+  }
+
+/*******************************************************/
+/* RangeKeyValue: Computes the value of a key without  */
+/*   calling the arithmetic functions so that no error */
+/*   is generated for non-numeric values. Integer and  */
+/*   float arithmetic is performed in the same way as  */
+/*   the +, -, and * functions. Returns false if the   */
+/*   value is not a number.                            */
+/*******************************************************/
+static bool RangeKeyValue(
+  Environment *theEnv,
+  struct expr *theExpr,
+  bool *isInteger,
+  long long *integerValue,
+  double *floatValue)
+  {
+   UDFValue theResult;
+   struct expr *theArg, *oldArgument;
+   void (*theOperation)(Environment *,UDFContext *,UDFValue *);
+   bool argIsInteger, useFloat = false;
+   long long ltotal = 0, largValue;
+   double ftotal = 0.0, fargValue;
+
+   switch (theExpr->type)
+     {
+      case INTEGER_TYPE:
+        *isInteger = true;
+        *integerValue = theExpr->integerValue->contents;
+        return true;
+
+      case FLOAT_TYPE:
+        *isInteger = false;
+        *floatValue = theExpr->floatValue->contents;
+        return true;
+
+      case FACT_JN_VAR1:
+      case FACT_JN_VAR2:
+      case FACT_JN_VAR3:
+        oldArgument = EvaluationData(theEnv)->CurrentExpression;
+        EvaluationData(theEnv)->CurrentExpression = theExpr;
+        (*EvaluationData(theEnv)->PrimitivesArray[theExpr->type]->evaluateFunction)(theEnv,theExpr->value,&theResult);
+        EvaluationData(theEnv)->CurrentExpression = oldArgument;
+
+        if (theResult.header->type == INTEGER_TYPE)
+          {
+           *isInteger = true;
+           *integerValue = theResult.integerValue->contents;
+           return true;
+          }
+        else if (theResult.header->type == FLOAT_TYPE)
+          {
+           *isInteger = false;
+           *floatValue = theResult.floatValue->contents;
+           return true;
+          }
+
+        return false;
+
+      default:
+        break;
+     }
+
+   /*====================================================*/
+   /* The remaining expressions are calls to +, -, or *. */
+   /*====================================================*/
+
+   theOperation = theExpr->functionValue->functionPointer;
+
+   for (theArg = theExpr->argList;
+        theArg != NULL;
+        theArg = theArg->nextArg)
+     {
+      if (! RangeKeyValue(theEnv,theArg,&argIsInteger,&largValue,&fargValue))
+        { return false; }
+
+      if (theArg == theExpr->argList)
+        {
+         if (argIsInteger)
+           { ltotal = largValue; }
+         else
+           {
+            ftotal = fargValue;
+            useFloat = true;
+           }
+         continue;
+        }
+
+      if (useFloat)
+        {
+         if (argIsInteger) fargValue = (double) largValue;
+
+         if (theOperation == AdditionFunction)
+           { ftotal += fargValue; }
+         else if (theOperation == SubtractionFunction)
+           { ftotal -= fargValue; }
+         else
+           { ftotal *= fargValue; }
+        }
+      else if (argIsInteger)
+        {
+         if (theOperation == AdditionFunction)
+           { ltotal += largValue; }
+         else if (theOperation == SubtractionFunction)
+           { ltotal -= largValue; }
+         else
+           { ltotal *= largValue; }
+        }
+      else
+        {
+         if (theOperation == AdditionFunction)
+           { ftotal = (double) ltotal + fargValue; }
+         else if (theOperation == SubtractionFunction)
+           { ftotal = (double) ltotal - fargValue; }
+         else
+           { ftotal = (double) ltotal * fargValue; }
+         useFloat = true;
+        }
+     }
+
+   if (useFloat)
+     {
+      *isInteger = false;
+      *floatValue = ftotal;
+     }
+   else
+     {
+      *isInteger = true;
+      *integerValue = ltotal;
+     }
+
+   return true;
+  }
+
+/******************************************************/
+/* EvaluateRangeKey: Computes the key of a partial    */
+/*   match from the specified side of a join. Returns */
+/*   false if the key is not a number (or is NaN).    */
+/******************************************************/
+static bool EvaluateRangeKey(
+  Environment *theEnv,
+  struct joinNode *theJoin,
+  struct expr *theKey,
+  struct partialMatch *theMatch,
+  int side,
+  double *theValue)
+  {
+   struct partialMatch *oldLHSBinds, *oldRHSBinds;
+   struct joinNode *oldJoin;
+   bool isInteger, rv;
+   long long integerValue;
+   double floatValue;
+
+   oldLHSBinds = EngineData(theEnv)->GlobalLHSBinds;
+   oldRHSBinds = EngineData(theEnv)->GlobalRHSBinds;
+   oldJoin = EngineData(theEnv)->GlobalJoin;
+
+   if (side == LHS)
+     {
+      EngineData(theEnv)->GlobalLHSBinds = theMatch;
+      EngineData(theEnv)->GlobalRHSBinds = NULL;
+     }
+   else
+     {
+      EngineData(theEnv)->GlobalLHSBinds = NULL;
+      EngineData(theEnv)->GlobalRHSBinds = theMatch;
+     }
+   EngineData(theEnv)->GlobalJoin = theJoin;
+
+   rv = RangeKeyValue(theEnv,theKey,&isInteger,&integerValue,&floatValue);
+
+   EngineData(theEnv)->GlobalLHSBinds = oldLHSBinds;
+   EngineData(theEnv)->GlobalRHSBinds = oldRHSBinds;
+   EngineData(theEnv)->GlobalJoin = oldJoin;
+
+   if (! rv)
+     { return false; }
+
+   if (isInteger)
+     { *theValue = (double) integerValue; }
+   else
+     {
+      if (isnan(floatValue))
+        { return false; }
+      *theValue = floatValue;
+     }
+
+   return true;
+  }
+
+/*****************************************************/
+/* AddToLeftRangeMemory: Adds a partial match which  */
+/*   was placed at the front of the left memory of a */
+/*   join to the join's left range memory.           */
+/*****************************************************/
+void AddToLeftRangeMemory(
+  Environment *theEnv,
+  struct joinNode *theJoin,
+  struct partialMatch *theMatch)
+  {
+   struct rangeMemory *theMemory = &theJoin->rangeIndex->leftMemory;
+   double theKey = 0.0;
+   bool keyed;
+
+   if (! theMemory->built) return;
+
+   if (! DefruleData(theEnv)->JoinRangeMemoryFlag)
+     {
+      ReleaseRangeMemory(theEnv,theMemory);
+      return;
+     }
+
+   keyed = EvaluateRangeKey(theEnv,theJoin,theJoin->rangeIndex->leftKey,theMatch,LHS,&theKey);
+   AddRangeEntry(theEnv,theMemory,theMatch,theMatch->hashValue,keyed,theKey,--theMemory->firstOrder);
+  }
+
+/***********************************************************/
+/* RemoveFromLeftRangeMemory: Removes a partial match from */
+/*   the left range memory of a join.                      */
+/***********************************************************/
+void RemoveFromLeftRangeMemory(
+  Environment *theEnv,
+  struct joinNode *theJoin,
+  struct partialMatch *theMatch)
+  {
+   struct rangeMemory *theMemory = &theJoin->rangeIndex->leftMemory;
+   double theKey = 0.0;
+   bool keyed;
+
+   if (! theMemory->built) return;
+
+   if (! DefruleData(theEnv)->JoinRangeMemoryFlag)
+     {
+      ReleaseRangeMemory(theEnv,theMemory);
+      return;
+     }
+
+   keyed = EvaluateRangeKey(theEnv,theJoin,theJoin->rangeIndex->leftKey,theMatch,LHS,&theKey);
+   RemoveRangeEntry(theMemory,theMatch,theMatch->hashValue,keyed,theKey);
+  }
+
+/********************************************************/
+/* AddToRightRangeMemories: Adds an alpha match which   */
+/*   was placed at the end of an alpha memory to the    */
+/*   right range memories of the joins which enter from */
+/*   the pattern node.                                  */
+/********************************************************/
+void AddToRightRangeMemories(
+  Environment *theEnv,
+  struct patternNodeHeader *theHeader,
+  struct partialMatch *theMatch)
+  {
+   struct joinNode *theJoin;
+   struct rangeMemory *theMemory;
+   double theKey = 0.0;
+   bool keyed;
+
+   for (theJoin = theHeader->entryJoin;
+        theJoin != NULL;
+        theJoin = theJoin->rightMatchNode)
+     {
+      if (theJoin->rangeIndex == NULL) continue;
+
+      theMemory = &theJoin->rangeIndex->rightMemory;
+      if (! theMemory->built) continue;
+
+      if (! DefruleData(theEnv)->JoinRangeMemoryFlag)
+        {
+         ReleaseRangeMemory(theEnv,theMemory);
+         continue;
+        }
+
+      keyed = EvaluateRangeKey(theEnv,theJoin,theJoin->rangeIndex->rightKey,theMatch,RHS,&theKey);
+      AddRangeEntry(theEnv,theMemory,theMatch,get_nth_pm_match(theMatch,0)->bucket,
+                    keyed,theKey,theMemory->lastOrder++);
+     }
+  }
+
+/*************************************************************/
+/* RemoveFromRightRangeMemories: Removes an alpha match from */
+/*   the right range memories of the joins which enter from  */
+/*   the pattern node.                                       */
+/*************************************************************/
+void RemoveFromRightRangeMemories(
+  Environment *theEnv,
+  struct patternNodeHeader *theHeader,
+  struct partialMatch *theMatch)
+  {
+   struct joinNode *theJoin;
+   struct rangeMemory *theMemory;
+   double theKey = 0.0;
+   bool keyed;
+
+   for (theJoin = theHeader->entryJoin;
+        theJoin != NULL;
+        theJoin = theJoin->rightMatchNode)
+     {
+      if (theJoin->rangeIndex == NULL) continue;
+
+      theMemory = &theJoin->rangeIndex->rightMemory;
+      if (! theMemory->built) continue;
+
+      if (! DefruleData(theEnv)->JoinRangeMemoryFlag)
+        {
+         ReleaseRangeMemory(theEnv,theMemory);
+         continue;
+        }
+
+      keyed = EvaluateRangeKey(theEnv,theJoin,theJoin->rangeIndex->rightKey,theMatch,RHS,&theKey);
+      RemoveRangeEntry(theMemory,theMatch,get_nth_pm_match(theMatch,0)->bucket,keyed,theKey);
+     }
+  }
+
+/*********************************************************/
+/* GetRangeMemoryCandidates: Retrieves the partial       */
+/*   matches from the memory opposite the side a partial */
+/*   match entered a join which need to be compared with */
+/*   it. The candidates are returned in memory order.    */
+/*   Returns false if the range memory can't be used, in */
+/*   which case the entire memory should be scanned.     */
+/*********************************************************/
+bool GetRangeMemoryCandidates(
+  Environment *theEnv,
+  struct joinNode *theJoin,
+  struct partialMatch *theMatch,
+  int side,
+  struct rangeEntry **candidates,
+  unsigned long *candidateCount)
+  {
+   struct joinRangeIndex *theIndex = theJoin->rangeIndex;
+   struct rangeMemory *theMemory;
+   struct partialMatch *alphaList;
+   unsigned long group, first, last, i, count, total;
+   double lowerValue = -INFINITY, upperValue = INFINITY, theKey;
+   struct rangeEntry *theArray;
+
+   *candidates = NULL;
+   *candidateCount = 0;
+
+   if (! DefruleData(theEnv)->JoinRangeMemoryFlag)
+     { return false; }
+
+   /*==========================================================*/
+   /* A partial match entering from the LHS is compared with   */
+   /* the alpha memory. The bounds are computed from the LHS.  */
+   /*==========================================================*/
+
+   if (side == LHS)
+     {
+      if (theJoin->rightSideEntryStructure == NULL)
+        { return false; }
+
+      theMemory = &theIndex->rightMemory;
+      if (! theMemory->built)
+        { BuildRightRangeMemory(theEnv,theJoin); }
+
+      if ((theMemory->count + theMemory->unkeyedCount) < RANGE_MEMORY_THRESHOLD)
+        { return false; }
+
+      alphaList = GetAlphaMemory(theEnv,(struct patternNodeHeader *) theJoin->rightSideEntryStructure,theMatch->hashValue);
+      if (alphaList == NULL)
+        { return true; }
+      group = get_nth_pm_match(alphaList,0)->bucket;
+
+      if ((theIndex->lowerBound != NULL) &&
+          (! EvaluateRangeKey(theEnv,theJoin,theIndex->lowerBound,theMatch,LHS,&lowerValue)))
+        { return false; }
+
+      if ((theIndex->upperBound != NULL) &&
+          (! EvaluateRangeKey(theEnv,theJoin,theIndex->upperBound,theMatch,LHS,&upperValue)))
+        { return false; }
+     }
+
+   /*=========================================================*/
+   /* A partial match entering from the RHS is compared with  */
+   /* the left memory. The left memory is keyed on one bound. */
+   /*=========================================================*/
+
+   else
+     {
+      if (theJoin->leftMemory->count < RANGE_MEMORY_THRESHOLD)
+        { return false; }
+
+      theMemory = &theIndex->leftMemory;
+      if (! theMemory->built)
+        { BuildLeftRangeMemory(theEnv,theJoin); }
+
+      group = theMatch->hashValue;
+
+      if (! EvaluateRangeKey(theEnv,theJoin,theIndex->rightKey,theMatch,RHS,&theKey))
+        { return false; }
+
+      if (theIndex->leftKeyIsLower)
+        { upperValue = theKey; }
+      else
+        { lowerValue = theKey; }
+     }
+
+   /*====================================================*/
+   /* The comparisons are non-strict so that no partial  */
+   /* match is excluded because of the rounding of large */
+   /* integers to floats. The join test is still used.   */
+   /*====================================================*/
+
+   first = LowerRangePosition(theMemory,group,lowerValue);
+   last = UpperRangePosition(theMemory,group,upperValue);
+   if (last < first) last = first;
+
+   count = last - first;
+   for (i = 0; i < theMemory->unkeyedCount; i++)
+     {
+      if (theMemory->unkeyed[i].group == group)
+        { count++; }
+     }
+
+   /*===================================================*/
+   /* If most of the memory must be compared, a scan    */
+   /* of the memory is faster than sorting the matches. */
+   /*===================================================*/
+
+   total = theMemory->count + theMemory->unkeyedCount;
+   if (count > (total / 2))
+     { return false; }
+
+   if (count == 0)
+     { return true; }
+
+   theArray = (struct rangeEntry *) genalloc(theEnv,sizeof(struct rangeEntry) * count);
+
+   memcpy(theArray,&theMemory->entries[first],sizeof(struct rangeEntry) * (last - first));
+   count = last - first;
+   for (i = 0; i < theMemory->unkeyedCount; i++)
+     {
+      if (theMemory->unkeyed[i].group == group)
+        { theArray[count++] = theMemory->unkeyed[i]; }
+     }
+
+   qsort(theArray,count,sizeof(struct rangeEntry),CompareRangeOrder);
+
+   *candidates = theArray;
+   *candidateCount = count;
+
+   return true;
+  }
+
+/************************************************************/
+/* ReturnRangeMemoryCandidates: Returns the array allocated */
+/*   by GetRangeMemoryCandidates.                           */
+/************************************************************/
+void ReturnRangeMemoryCandidates(
+  Environment *theEnv,
+  struct rangeEntry *candidates,
+  unsigned long candidateCount)
+  {
+   if (candidates == NULL) return;
+
+   genfree(theEnv,candidates,sizeof(struct rangeEntry) * candidateCount);
+  }
+
+/*******************************************************/
+/* BuildLeftRangeMemory: Creates the left range memory */
+/*   of a join from the contents of its left memory.   */
+/*   The partial matches in each bucket are numbered   */
+/*   in the order in which they appear.                */
+/*******************************************************/
+static void BuildLeftRangeMemory(
+  Environment *theEnv,
+  struct joinNode *theJoin)
+  {
+   struct rangeMemory *theMemory = &theJoin->rangeIndex->leftMemory;
+   struct partialMatch *theMatch;
+   unsigned long b;
+   long long order = 0;
+   double theKey = 0.0;
+   bool keyed;
+
+   theMemory->built = true;
+   theMemory->firstOrder = 0;
+
+   for (b = 0; b < theJoin->leftMemory->size; b++)
+     {
+      for (theMatch = theJoin->leftMemory->beta[b];
+           theMatch != NULL;
+           theMatch = theMatch->nextInMemory)
+        {
+         keyed = EvaluateRangeKey(theEnv,theJoin,theJoin->rangeIndex->leftKey,theMatch,LHS,&theKey);
+         AddRangeEntry(theEnv,theMemory,theMatch,theMatch->hashValue,keyed,theKey,order++);
+        }
+     }
+
+   theMemory->lastOrder = order;
+  }
+
+/*********************************************************/
+/* BuildRightRangeMemory: Creates the right range memory */
+/*   of a join from the contents of the alpha memories   */
+/*   of the pattern node entering the join.              */
+/*********************************************************/
+static void BuildRightRangeMemory(
+  Environment *theEnv,
+  struct joinNode *theJoin)
+  {
+   struct rangeMemory *theMemory = &theJoin->rangeIndex->rightMemory;
+   struct patternNodeHeader *theHeader;
+   struct alphaMemoryHash *theAlphaMemory;
+   struct partialMatch *theMatch;
+   long long order = 0;
+   double theKey = 0.0;
+   bool keyed;
+
+   theMemory->built = true;
+   theMemory->firstOrder = 0;
+
+   theHeader = (struct patternNodeHeader *) theJoin->rightSideEntryStructure;
+
+   for (theAlphaMemory = theHeader->firstHash;
+        theAlphaMemory != NULL;
+        theAlphaMemory = theAlphaMemory->nextHash)
+     {
+      for (theMatch = theAlphaMemory->alphaMemory;
+           theMatch != NULL;
+           theMatch = theMatch->nextInMemory)
+        {
+         keyed = EvaluateRangeKey(theEnv,theJoin,theJoin->rangeIndex->rightKey,theMatch,RHS,&theKey);
+         AddRangeEntry(theEnv,theMemory,theMatch,theAlphaMemory->bucket,keyed,theKey,order++);
+        }
+     }
+
+   theMemory->lastOrder = order;
+  }
+
+/**************************************************/
+/* AddRangeEntry: Adds an entry to a range memory */
+/*   growing the arrays of entries as needed.     */
+/**************************************************/
+static void AddRangeEntry(
+  Environment *theEnv,
+  struct rangeMemory *theMemory,
+  struct partialMatch *theMatch,
+  unsigned long group,
+  bool keyed,
+  double theKey,
+  long long order)
+  {
+   struct rangeEntry **theArray, *newArray;
+   unsigned long *theCount, *theSize, position, newSize;
+
+   if (keyed)
+     {
+      theArray = &theMemory->entries;
+      theCount = &theMemory->count;
+      theSize = &theMemory->size;
+     }
+   else
+     {
+      theArray = &theMemory->unkeyed;
+      theCount = &theMemory->unkeyedCount;
+      theSize = &theMemory->unkeyedSize;
+     }
+
+   if (*theCount == *theSize)
+     {
+      newSize = (*theSize == 0) ? 8 : (*theSize * 2);
+      newArray = (struct rangeEntry *) genalloc(theEnv,sizeof(struct rangeEntry) * newSize);
+      if (*theArray != NULL)
+        {
+         memcpy(newArray,*theArray,sizeof(struct rangeEntry) * *theCount);
+         genfree(theEnv,*theArray,sizeof(struct rangeEntry) * *theSize);
+        }
+      *theArray = newArray;
+      *theSize = newSize;
+     }
+
+   if (keyed)
+     {
+      position = UpperRangePosition(theMemory,group,theKey);
+      memmove(&theMemory->entries[position+1],&theMemory->entries[position],
+              sizeof(struct rangeEntry) * (theMemory->count - position));
+     }
+   else
+     { position = theMemory->unkeyedCount; }
+
+   (*theArray)[position].group = group;
+   (*theArray)[position].key = theKey;
+   (*theArray)[position].order = order;
+   (*theArray)[position].theMatch = theMatch;
+   (*theCount)++;
+  }
+
+/********************************************************/
+/* RemoveRangeEntry: Removes the entry for a partial    */
+/*   match from a range memory. The key of the partial  */
+/*   match is used to locate the entry. If the key has  */
+/*   changed since the entry was added, the entire      */
+/*   memory is searched.                                */
+/********************************************************/
+static void RemoveRangeEntry(
+  struct rangeMemory *theMemory,
+  struct partialMatch *theMatch,
+  unsigned long group,
+  bool keyed,
+  double theKey)
+  {
+   unsigned long i, last;
+
+   if (keyed)
+     {
+      last = UpperRangePosition(theMemory,group,theKey);
+      for (i = LowerRangePosition(theMemory,group,theKey); i < last; i++)
+        {
+         if (theMemory->entries[i].theMatch == theMatch)
+           {
+            memmove(&theMemory->entries[i],&theMemory->entries[i+1],
+                    sizeof(struct rangeEntry) * (theMemory->count - (i + 1)));
+            theMemory->count--;
+            return;
+           }
+        }
+     }
+
+   for (i = 0; i < theMemory->unkeyedCount; i++)
+     {
+      if (theMemory->unkeyed[i].theMatch == theMatch)
+        {
+         theMemory->unkeyed[i] = theMemory->unkeyed[theMemory->unkeyedCount - 1];
+         theMemory->unkeyedCount--;
+         return;
+        }
+     }
+
+   for (i = 0; i < theMemory->count; i++)
+     {
+      if (theMemory->entries[i].theMatch == theMatch)
+        {
+         memmove(&theMemory->entries[i],&theMemory->entries[i+1],
+                 sizeof(struct rangeEntry) * (theMemory->count - (i + 1)));
+         theMemory->count--;
+         return;
+        }
+     }
+  }
+
+/*****************************************************/
+/* ReleaseRangeMemory: Returns the arrays of a range */
+/*   memory. It will be rebuilt when next needed.    */
+/*****************************************************/
+static void ReleaseRangeMemory(
+  Environment *theEnv,
+  struct rangeMemory *theMemory)
+  {
+   if (theMemory->entries != NULL)
+     { genfree(theEnv,theMemory->entries,sizeof(struct rangeEntry) * theMemory->size); }
+
+   if (theMemory->unkeyed != NULL)
+     { genfree(theEnv,theMemory->unkeyed,sizeof(struct rangeEntry) * theMemory->unkeyedSize); }
+
+   memset(theMemory,0,sizeof(struct rangeMemory));
+  }
+
+/*****************************************************/
+/* LowerRangePosition: Returns the position of the   */
+/*   first sorted entry not less than group and key. */
+/*****************************************************/
+static unsigned long LowerRangePosition(
+  struct rangeMemory *theMemory,
+  unsigned long group,
+  double theKey)
+  {
+   unsigned long low = 0, high = theMemory->count, middle;
+   struct rangeEntry *theEntry;
+
+   while (low < high)
+     {
+      middle = low + ((high - low) / 2);
+      theEntry = &theMemory->entries[middle];
+
+      if ((theEntry->group < group) ||
+          ((theEntry->group == group) && (theEntry->key < theKey)))
+        { low = middle + 1; }
+      else
+        { high = middle; }
+     }
+
+   return low;
+  }
+
+/*****************************************************/
+/* UpperRangePosition: Returns the position of the   */
+/*   first sorted entry greater than group and key.  */
+/*****************************************************/
+static unsigned long UpperRangePosition(
+  struct rangeMemory *theMemory,
+  unsigned long group,
+  double theKey)
+  {
+   unsigned long low = 0, high = theMemory->count, middle;
+   struct rangeEntry *theEntry;
+
+   while (low < high)
+     {
+      middle = low + ((high - low) / 2);
+      theEntry = &theMemory->entries[middle];
+
+      if ((theEntry->group < group) ||
+          ((theEntry->group == group) && (theEntry->key <= theKey)))
+        { low = middle + 1; }
+      else
+        { high = middle; }
+     }
+
+   return low;
+  }
+
+/*****************************************************/
+/* CompareRangeOrder: Comparison function for qsort  */
+/*   used to put candidates back into memory order.  */
+/*****************************************************/
+static int CompareRangeOrder(
+  const void *p1,
+  const void *p2)
+  {
+   long long o1 = ((const struct rangeEntry *) p1)->order;
+   long long o2 = ((const struct rangeEntry *) p2)->order;
+
+   if (o1 < o2) return -1;
+   if (o1 > o2) return 1;
+   return 0;
+  }
+
+#endif /* DEFRULE_CONSTRUCT */
@@ -76,6 +76,7 @@
 #include "moduldef.h"
 #include "pattern.h"
 #include "prntutil.h"
+#include "rangemem.h"
 #include "retract.h"
 #include "router.h"
 #include "rulecom.h"
@@ -238,6 +239,9 @@ void UpdateBetaPMLinks(
       if (theMemory->beta[betaLocation] != NULL)
         { theMemory->beta[betaLocation]->prevInMemory = thePM; }
       theMemory->beta[betaLocation] = thePM;
+
+      if (join->rangeIndex != NULL)
+        { AddToLeftRangeMemory(theEnv,join,thePM); }
      }
    else
      {
@@ -258,6 +262,13 @@ void UpdateBetaPMLinks(
    else
     { join->memoryRightAdds++; }
 
+#if JOIN_STATISTICS
+   if ((side == LHS) && (theMemory->count > join->statistics.leftPeak))
+     { join->statistics.leftPeak = theMemory->count; }
+   else if ((side == RHS) && (theMemory->count > join->statistics.rightPeak))
+     { join->statistics.rightPeak = theMemory->count; }
+#endif
+
    thePM->owner = join;
 
    /*======================================*/
@@ -361,6 +372,9 @@ void UnlinkBetaPMFromNodeAndLineage(
    /* Update the nextInMemory/prevInMemory links. */
    /*=============================================*/
 
+   if ((side == LHS) && (join->rangeIndex != NULL))
+     { RemoveFromLeftRangeMemory(theEnv,join,thePM); }
+
    theMemory->count--;
 
    if (side == LHS)
@@ -419,6 +433,9 @@ void UnlinkNonLeftLineage(
    /* Update the nextInMemory/prevInMemory links. */
    /*=============================================*/
 
+   if ((side == LHS) && (join->rangeIndex != NULL))
+     { RemoveFromLeftRangeMemory(theEnv,join,thePM); }
+
    theMemory->count--;
 
    if (side == LHS)
@@ -673,8 +690,6 @@ struct partialMatch *CreateAlphaMatch(
   {
    struct partialMatch *theMatch;
    struct alphaMatch *afbtemp;
-   unsigned long hashValue;
-   struct alphaMemoryHash *theAlphaMemory;
 
    /*==================================================*/
    /* Create the alpha match and intialize its values. */
@@ -699,13 +714,40 @@ struct partialMatch *CreateAlphaMatch(
 
    theMatch->binds[0].gm.theMatch = afbtemp;
 
+   /*====================================*/
+   /* Store the alpha match in the alpha */
+   /* memory of the pattern node.        */
+   /*====================================*/
+
+   StoreAlphaMatch(theEnv,theMatch,theHeader);
+
+   /*===================================================*/
+   /* Return a pointer to the newly create alpha match. */
+   /*===================================================*/
+
+   return(theMatch);
+  }
+
+/****************************************************************/
+/* StoreAlphaMatch: Places an alpha match at the end of the     */
+/*   alpha memory of a pattern node which corresponds to its    */
+/*   hash value, creating the alpha memory if it doesn't exist. */
+/****************************************************************/
+void StoreAlphaMatch(
+  Environment *theEnv,
+  struct partialMatch *theMatch,
+  struct patternNodeHeader *theHeader)
+  {
+   unsigned long hashValue;
+   struct alphaMemoryHash *theAlphaMemory;
+
    /*============================================*/
    /* Find the alpha memory of the pattern node. */
    /*============================================*/
 
-   hashValue = AlphaMemoryHashValue(theHeader,hashOffset);
+   hashValue = AlphaMemoryHashValue(theHeader,theMatch->hashValue);
    theAlphaMemory = FindAlphaMemory(theEnv,theHeader,hashValue);
-   afbtemp->bucket = hashValue;
+   theMatch->binds[0].gm.theMatch->bucket = hashValue;
 
    /*============================================*/
    /* Create an alpha memory if it wasn't found. */
@@ -746,8 +788,8 @@ struct partialMatch *CreateAlphaMatch(
    /* memory of the pattern node.        */
    /*====================================*/
 
-    theMatch->prevInMemory = theAlphaMemory->endOfQueue;
-    if (theAlphaMemory->endOfQueue == NULL)
+   theMatch->prevInMemory = theAlphaMemory->endOfQueue;
+   if (theAlphaMemory->endOfQueue == NULL)
      {
       theAlphaMemory->alphaMemory = theMatch;
       theAlphaMemory->endOfQueue = theMatch;
@@ -758,11 +800,8 @@ struct partialMatch *CreateAlphaMatch(
       theAlphaMemory->endOfQueue = theMatch;
      }
 
-   /*===================================================*/
-   /* Return a pointer to the newly create alpha match. */
-   /*===================================================*/
-
-   return(theMatch);
+   if (theHeader->entryJoin != NULL)
+     { AddToRightRangeMemories(theEnv,theHeader,theMatch); }
   }
 
 /*******************************************/
@@ -1102,6 +1141,8 @@ void ReturnLeftMemory(
   Environment *theEnv,
   struct joinNode *theJoin)
   {
+   ReturnJoinRangeIndex(theEnv,theJoin);
+
    if (theJoin->leftMemory == NULL) return;
    genfree(theEnv,theJoin->leftMemory->beta,sizeof(struct partialMatch *) * theJoin->leftMemory->size);
    rtn_struct(theEnv,betaMemory,theJoin->leftMemory);
@@ -1218,6 +1259,9 @@ void RemoveAlphaMemoryMatches(
    struct alphaMemoryHash *theAlphaMemory = NULL;
    unsigned long hashValue;
 
+   if (theHeader->entryJoin != NULL)
+     { RemoveFromRightRangeMemories(theEnv,theHeader,theMatch); }
+
    if ((theMatch->prevInMemory == NULL) || (theMatch->nextInMemory == NULL))
      {
       hashValue = theAlphaMatch->bucket;
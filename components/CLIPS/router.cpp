@@ -90,11 +90,21 @@
    const char                    *STDERR = "stderr";
    const char                    *STDWRN = "stdwrn";
 
+/***************/
+/* DEFINITIONS */
+/***************/
+
+#define RESOLVE_QUERY   0x01
+#define RESOLVE_WRITE   0x02
+#define RESOLVE_READ    0x04
+#define RESOLVE_UNREAD  0x08
+
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
 
    static bool                    QueryRouter(Environment *,const char *,struct router *);
+   static struct router          *ResolveRouter(Environment *,const char *,unsigned char);
    static void                    DeallocateRouterData(Environment *);
 
 /*********************************************************/
@@ -109,6 +119,13 @@ void InitializeDefaultRouters(
    RouterData(theEnv)->InputUngets = 0;
    RouterData(theEnv)->AwaitingInput = true;
 
+   RouterData(theEnv)->LogicalNames[STDIN_ID].name = STDIN;
+   RouterData(theEnv)->LogicalNames[STDOUT_ID].name = STDOUT;
+   RouterData(theEnv)->LogicalNames[STDERR_ID].name = STDERR;
+   RouterData(theEnv)->LogicalNames[STDWRN_ID].name = STDWRN;
+   RouterData(theEnv)->NextLogicalName = FIRST_LOGICAL_NAME_ID;
+   RouterData(theEnv)->RouterGeneration = 1;
+
    InitializeFileRouter(theEnv);
    InitializeStringRouter(theEnv);
   }
@@ -121,6 +138,16 @@ static void DeallocateRouterData(
   Environment *theEnv)
   {
    struct router *tmpPtr, *nextPtr;
+   unsigned short i;
+
+   for (i = FIRST_LOGICAL_NAME_ID; i < LOGICAL_NAME_CACHE_SIZE; i++)
+     {
+      if (RouterData(theEnv)->LogicalNames[i].nameSize != 0)
+        {
+         genfree(theEnv,(void *) RouterData(theEnv)->LogicalNames[i].name,
+                 RouterData(theEnv)->LogicalNames[i].nameSize);
+        }
+     }
 
    tmpPtr = RouterData(theEnv)->ListOfRouters;
    while (tmpPtr != NULL)
@@ -139,20 +166,10 @@ bool PrintRouterExists(
   Environment *theEnv,
   const char *logicalName)
   {
-   struct router *currentPtr;
-   
    if (((char *) RouterData(theEnv)->FastSaveFilePtr) == logicalName)
      { return true; }
-     
-   currentPtr = RouterData(theEnv)->ListOfRouters;
-   while (currentPtr != NULL)
-     {
-      if ((currentPtr->writeCallback != NULL) ? QueryRouter(theEnv,logicalName,currentPtr) : false)
-        { return true; }
-      currentPtr = currentPtr->next;
-     }
-     
-   return false;
+
+   return (ResolveRouter(theEnv,logicalName,RESOLVE_WRITE) != NULL);
   }
 
 /**********************************/
@@ -201,20 +218,15 @@ void WriteString(
       return;
      }
 
-   /*==============================================*/
-   /* Search through the list of routers until one */
-   /* is found that will handle the print request. */
-   /*==============================================*/
+   /*=================================================*/
+   /* Find the router that handles the print request. */
+   /*=================================================*/
 
-   currentPtr = RouterData(theEnv)->ListOfRouters;
-   while (currentPtr != NULL)
+   currentPtr = ResolveRouter(theEnv,logicalName,RESOLVE_WRITE);
+   if (currentPtr != NULL)
      {
-      if ((currentPtr->writeCallback != NULL) ? QueryRouter(theEnv,logicalName,currentPtr) : false)
-        {
-         (*currentPtr->writeCallback)(theEnv,logicalName,str,currentPtr->context);
-         return;
-        }
-      currentPtr = currentPtr->next;
+      (*currentPtr->writeCallback)(theEnv,logicalName,str,currentPtr->context);
+      return;
      }
 
    /*=====================================================*/
@@ -261,17 +273,19 @@ int ReadRouter(
    /* If the "fast string get" option is being used */
    /* for the specified logical name, then bypass   */
    /* the router system and extract the character   */
-   /* directly from the fast get string.            */
+   /* directly from the fast get string. The index  */
+   /* stays on the terminating null, so reading     */
+   /* past the end keeps returning EOF.             */
    /*===============================================*/
 
    if (RouterData(theEnv)->FastCharGetRouter == logicalName)
      {
       inchar = (unsigned char) RouterData(theEnv)->FastCharGetString[RouterData(theEnv)->FastCharGetIndex];
 
-      RouterData(theEnv)->FastCharGetIndex++;
-
       if (inchar == '\0') return(EOF);
 
+      RouterData(theEnv)->FastCharGetIndex++;
+
       if (inchar == '\n')
         {
          if (RouterData(theEnv)->FastCharGetRouter == RouterData(theEnv)->LineCountRouter)
@@ -281,28 +295,23 @@ int ReadRouter(
       return(inchar);
      }
 
-   /*==============================================*/
-   /* Search through the list of routers until one */
-   /* is found that will handle the getc request.  */
-   /*==============================================*/
+   /*================================================*/
+   /* Find the router that handles the getc request. */
+   /*================================================*/
 
-   currentPtr = RouterData(theEnv)->ListOfRouters;
-   while (currentPtr != NULL)
+   currentPtr = ResolveRouter(theEnv,logicalName,RESOLVE_READ);
+   if (currentPtr != NULL)
      {
-      if ((currentPtr->readCallback != NULL) ? QueryRouter(theEnv,logicalName,currentPtr) : false)
-        {
-         inchar = (*currentPtr->readCallback)(theEnv,logicalName,currentPtr->context);
+      inchar = (*currentPtr->readCallback)(theEnv,logicalName,currentPtr->context);
 
-         if (inchar == '\n')
-           {
-            if ((RouterData(theEnv)->LineCountRouter != NULL) &&
-                (strcmp(logicalName,RouterData(theEnv)->LineCountRouter) == 0))
-              { IncrementLineCount(theEnv); }
-           }
-
-         return(inchar);
+      if (inchar == '\n')
+        {
+         if ((RouterData(theEnv)->LineCountRouter != NULL) &&
+             (strcmp(logicalName,RouterData(theEnv)->LineCountRouter) == 0))
+           { IncrementLineCount(theEnv); }
         }
-      currentPtr = currentPtr->next;
+
+      return(inchar);
      }
 
    /*=====================================================*/
@@ -345,11 +354,15 @@ int UnreadRouter(
    /* If the "fast string get" option is being used */
    /* for the specified logical name, then bypass   */
    /* the router system and unget the character     */
-   /* directly from the fast get string.            */
+   /* directly from the fast get string. An EOF     */
+   /* didn't advance the index, so it isn't backed  */
+   /* up for one either.                            */
    /*===============================================*/
 
    if (RouterData(theEnv)->FastCharGetRouter == logicalName)
      {
+      if (ch == EOF) return ch;
+
       if (ch == '\n')
         {
          if (RouterData(theEnv)->FastCharGetRouter == RouterData(theEnv)->LineCountRouter)
@@ -360,27 +373,21 @@ int UnreadRouter(
       return ch;
      }
 
-   /*===============================================*/
-   /* Search through the list of routers until one  */
-   /* is found that will handle the ungetc request. */
-   /*===============================================*/
+   /*==================================================*/
+   /* Find the router that handles the ungetc request. */
+   /*==================================================*/
 
-   currentPtr = RouterData(theEnv)->ListOfRouters;
-   while (currentPtr != NULL)
+   currentPtr = ResolveRouter(theEnv,logicalName,RESOLVE_UNREAD);
+   if (currentPtr != NULL)
      {
-      if ((currentPtr->unreadCallback != NULL) ? QueryRouter(theEnv,logicalName,currentPtr) : false)
+      if (ch == '\n')
         {
-         if (ch == '\n')
-           {
-            if ((RouterData(theEnv)->LineCountRouter != NULL) &&
-                (strcmp(logicalName,RouterData(theEnv)->LineCountRouter) == 0))
-              { DecrementLineCount(theEnv); }
-           }
-
-         return (*currentPtr->unreadCallback)(theEnv,logicalName,ch,currentPtr->context);
+         if ((RouterData(theEnv)->LineCountRouter != NULL) &&
+             (strcmp(logicalName,RouterData(theEnv)->LineCountRouter) == 0))
+           { DecrementLineCount(theEnv); }
         }
 
-      currentPtr = currentPtr->next;
+      return (*currentPtr->unreadCallback)(theEnv,logicalName,ch,currentPtr->context);
      }
 
    /*=====================================================*/
@@ -391,6 +398,95 @@ int UnreadRouter(
    return -1;
   }
 
+/******************************************************/
+/* ReadRouterSpan: Returns the characters which can   */
+/*   be read from the input source of a logical name  */
+/*   as a contiguous span, without a call to          */
+/*   ReadRouter for each one. The span ends after     */
+/*   length characters or at the first null character */
+/*   within it, whichever comes first. NULL is        */
+/*   returned if the source doesn't have a span.      */
+/******************************************************/
+const char *ReadRouterSpan(
+  Environment *theEnv,
+  const char *logicalName,
+  size_t *length)
+  {
+   struct router *currentPtr;
+   const char *fastString;
+   long fastIndex;
+
+   if (((char *) RouterData(theEnv)->FastLoadFilePtr) == logicalName)
+     { return NULL; }
+
+   /*============================================*/
+   /* A fast get string ends at its null, so the */
+   /* span is unbounded. There is no span once   */
+   /* the index has reached the null.            */
+   /*============================================*/
+
+   if (RouterData(theEnv)->FastCharGetRouter == logicalName)
+     {
+      fastString = RouterData(theEnv)->FastCharGetString;
+      fastIndex = RouterData(theEnv)->FastCharGetIndex;
+
+      if (fastString[fastIndex] == '\0')
+        { return NULL; }
+
+      *length = SIZE_MAX;
+      return &fastString[fastIndex];
+     }
+
+   currentPtr = ResolveRouter(theEnv,logicalName,RESOLVE_READ);
+   if (currentPtr == NULL)
+     { return NULL; }
+
+   return StringRouterSpan(theEnv,currentPtr,logicalName,length);
+  }
+
+/****************************************************/
+/* AdvanceRouterSpan: Consumes the first count      */
+/*   characters of the span returned by             */
+/*   ReadRouterSpan, counting the newlines among    */
+/*   them as ReadRouter would.                      */
+/****************************************************/
+void AdvanceRouterSpan(
+  Environment *theEnv,
+  const char *logicalName,
+  const char *span,
+  size_t count)
+  {
+   const char *newline, *end;
+   bool countLines;
+   long lines = 0;
+
+   if (count == 0) return;
+
+   if (RouterData(theEnv)->FastCharGetRouter == logicalName)
+     {
+      RouterData(theEnv)->FastCharGetIndex += (long) count;
+      countLines = (RouterData(theEnv)->LineCountRouter == logicalName);
+     }
+   else
+     {
+      AdvanceStringRouter(theEnv,logicalName,count);
+      countLines = ((RouterData(theEnv)->LineCountRouter != NULL) &&
+                    (strcmp(logicalName,RouterData(theEnv)->LineCountRouter) == 0));
+     }
+
+   if (! countLines) return;
+
+   end = span + count;
+   while ((newline = (const char *) memchr(span,'\n',(size_t) (end - span))) != NULL)
+     {
+      lines++;
+      span = newline + 1;
+     }
+
+   if (lines != 0)
+     { SetLineCount(theEnv,GetLineCount(theEnv) + lines); }
+  }
+
 /********************************************/
 /* ExitRouter: Generic exit function. Calls */
 /*   all of the router exit functions.      */
@@ -475,6 +571,8 @@ bool AddRouter(
    newPtr->unreadCallback = unreadFunction;
    newPtr->next = NULL;
 
+   InvalidateRouterCache(theEnv);
+
    if (RouterData(theEnv)->ListOfRouters == NULL)
      {
       RouterData(theEnv)->ListOfRouters = newPtr;
@@ -519,6 +617,7 @@ bool DeleteRouter(
      {
       if (strcmp(currentPtr->name,routerName) == 0)
         {
+         InvalidateRouterCache(theEnv);
          genfree(theEnv,(void *) currentPtr->name,strlen(currentPtr->name) + 1);
          if (lastPtr == NULL)
            {
@@ -544,16 +643,161 @@ bool QueryRouters(
   Environment *theEnv,
   const char *logicalName)
   {
+   return (ResolveRouter(theEnv,logicalName,RESOLVE_QUERY) != NULL);
+  }
+
+/*************************************************************/
+/* LogicalNameID: Returns the index of a logical name in the */
+/*   logical name cache, adding the name if it isn't already */
+/*   present. The standard logical names have the fixed IDs  */
+/*   STDIN_ID through STDWRN_ID. The IDs of other names are  */
+/*   only valid until the name is displaced from the cache.  */
+/*************************************************************/
+unsigned short LogicalNameID(
+  Environment *theEnv,
+  const char *logicalName)
+  {
+   struct logicalNameEntry *theEntry;
+   unsigned short i;
+   size_t nameSize;
+   char *nameCopy;
+
+   /*===============================================*/
+   /* Most calls pass the STDOUT, STDIN, STDERR and */
+   /* STDWRN constants, so compare pointers first.  */
+   /*===============================================*/
+
+   for (i = 0; i < LOGICAL_NAME_CACHE_SIZE; i++)
+     {
+      if (RouterData(theEnv)->LogicalNames[i].name == logicalName)
+        { return i; }
+     }
+
+   for (i = 0; i < LOGICAL_NAME_CACHE_SIZE; i++)
+     {
+      theEntry = &RouterData(theEnv)->LogicalNames[i];
+      if ((theEntry->name != NULL) &&
+          (strcmp(theEntry->name,logicalName) == 0))
+        { return i; }
+     }
+
+   /*=================================================*/
+   /* Otherwise the name replaces the oldest entry in */
+   /* the part of the cache not used by the standard  */
+   /* logical names.                                  */
+   /*=================================================*/
+
+   i = RouterData(theEnv)->NextLogicalName;
+   theEntry = &RouterData(theEnv)->LogicalNames[i];
+
+   if (theEntry->nameSize != 0)
+     { genfree(theEnv,(void *) theEntry->name,theEntry->nameSize); }
+
+   nameSize = strlen(logicalName) + 1;
+   nameCopy = (char *) genalloc(theEnv,nameSize);
+   genstrcpy(nameCopy,logicalName);
+
+   theEntry->name = nameCopy;
+   theEntry->nameSize = nameSize;
+   theEntry->generation = 0;
+   theEntry->resolved = 0;
+
+   RouterData(theEnv)->LogicalNameInsertions++;
+   if (++RouterData(theEnv)->NextLogicalName >= LOGICAL_NAME_CACHE_SIZE)
+     { RouterData(theEnv)->NextLogicalName = FIRST_LOGICAL_NAME_ID; }
+
+   return i;
+  }
+
+/***************************************************************/
+/* InvalidateRouterCache: Discards the routers remembered for  */
+/*   each logical name. Called whenever a router is added,     */
+/*   removed, activated, or deactivated, and by routers whose  */
+/*   query function changes the names it recognizes (such as   */
+/*   the file and string routers when a name is opened).       */
+/***************************************************************/
+void InvalidateRouterCache(
+  Environment *theEnv)
+  {
+   RouterData(theEnv)->RouterGeneration++;
+  }
+
+/***************************************************************/
+/* ResolveRouter: Returns the first active router recognizing  */
+/*   a logical name which has the callback needed for a query, */
+/*   write, read, or unread request. The answer is kept with   */
+/*   the logical name until the router cache is invalidated.   */
+/***************************************************************/
+static struct router *ResolveRouter(
+  Environment *theEnv,
+  const char *logicalName,
+  unsigned char request)
+  {
+   struct logicalNameEntry *theEntry;
    struct router *currentPtr;
+   unsigned long generation, insertions;
 
-   currentPtr = RouterData(theEnv)->ListOfRouters;
-   while (currentPtr != NULL)
+   generation = RouterData(theEnv)->RouterGeneration;
+   theEntry = &RouterData(theEnv)->LogicalNames[LogicalNameID(theEnv,logicalName)];
+
+   if (theEntry->generation != generation)
      {
-      if (QueryRouter(theEnv,logicalName,currentPtr) == true) return true;
-      currentPtr = currentPtr->next;
+      theEntry->generation = generation;
+      theEntry->resolved = 0;
+     }
+   else if (theEntry->resolved & request)
+     {
+      switch (request)
+        {
+         case RESOLVE_QUERY: return theEntry->queryRouter;
+         case RESOLVE_WRITE: return theEntry->writeRouter;
+         case RESOLVE_READ: return theEntry->readRouter;
+         default: return theEntry->unreadRouter;
+        }
      }
 
-   return false;
+   /*==============================================*/
+   /* Search through the list of routers until one */
+   /* is found that will handle the request.       */
+   /*==============================================*/
+
+   insertions = RouterData(theEnv)->LogicalNameInsertions;
+
+   for (currentPtr = RouterData(theEnv)->ListOfRouters;
+        currentPtr != NULL;
+        currentPtr = currentPtr->next)
+     {
+      if ((request == RESOLVE_WRITE) && (currentPtr->writeCallback == NULL))
+        { continue; }
+      if ((request == RESOLVE_READ) && (currentPtr->readCallback == NULL))
+        { continue; }
+      if ((request == RESOLVE_UNREAD) && (currentPtr->unreadCallback == NULL))
+        { continue; }
+
+      if (QueryRouter(theEnv,logicalName,currentPtr))
+        { break; }
+     }
+
+   /*===================================================*/
+   /* Only remember the answer if none of the query     */
+   /* functions changed the routers or the cache entry. */
+   /*===================================================*/
+
+   if ((generation != RouterData(theEnv)->RouterGeneration) ||
+       (insertions != RouterData(theEnv)->LogicalNameInsertions))
+     { return currentPtr; }
+
+   switch (request)
+     {
+      case RESOLVE_QUERY: theEntry->queryRouter = currentPtr; break;
+      case RESOLVE_WRITE: theEntry->writeRouter = currentPtr; break;
+      case RESOLVE_READ: theEntry->readRouter = currentPtr; break;
+      default: theEntry->unreadRouter = currentPtr; break;
+     }
+
+   theEntry->resolved |= request;
+
+   return currentPtr;
   }
 
 /************************************************/
@@ -604,7 +848,11 @@ bool DeactivateRouter(
      {
       if (strcmp(currentPtr->name,routerName) == 0)
         {
-         currentPtr->active = false;
+         if (currentPtr->active)
+           {
+            currentPtr->active = false;
+            InvalidateRouterCache(theEnv);
+           }
          return true;
         }
       currentPtr = currentPtr->next;
@@ -628,7 +876,11 @@ bool ActivateRouter(
      {
       if (strcmp(currentPtr->name,routerName) == 0)
         {
-         currentPtr->active = true;
+         if (! currentPtr->active)
+           {
+            currentPtr->active = true;
+            InvalidateRouterCache(theEnv);
+           }
          return true;
         }
       currentPtr = currentPtr->next;
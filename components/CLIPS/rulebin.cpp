@@ -58,6 +58,7 @@
 #include "reteutil.h"
 #include "retract.h"
 #include "rulebsc.h"
+#include "userdata.h"
 
 #include "rulebin.h"
 
@@ -123,6 +124,9 @@ static void DeallocateDefruleBloadData(
    struct activation *theActivation, *tmpActivation;
    struct salienceGroup *theGroup, *tmpGroup;
 
+   for (i = 0; i < DefruleBinaryData(theEnv)->NumberOfDefrules; i++)
+     { ClearUserDataList(theEnv,DefruleBinaryData(theEnv)->DefruleArray[i].header.usrData); }
+
    for (i = 0; i < DefruleBinaryData(theEnv)->NumberOfJoins; i++)
      {
       DestroyBetaMemory(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i],LHS);
@@ -980,6 +984,11 @@ static void UpdateJoin(
    DefruleBinaryData(theEnv)->JoinArray[obji].bsaveID = 0L;
    DefruleBinaryData(theEnv)->JoinArray[obji].leftMemory = NULL;
    DefruleBinaryData(theEnv)->JoinArray[obji].rightMemory = NULL;
+   DefruleBinaryData(theEnv)->JoinArray[obji].rangeIndex = NULL;
+   DefruleBinaryData(theEnv)->JoinArray[obji].networkTestFunction = NULL;
+#if JOIN_STATISTICS
+   memset(&DefruleBinaryData(theEnv)->JoinArray[obji].statistics,0,sizeof(struct joinStatistics));
+#endif
 
    AddBetaMemoriesToJoin(theEnv,&DefruleBinaryData(theEnv)->JoinArray[obji]);
   }
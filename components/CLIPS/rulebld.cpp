@@ -61,6 +61,7 @@
 #include "memalloc.h"
 #include "pattern.h"
 #include "prntutil.h"
+#include "rangemem.h"
 #include "reteutil.h"
 #include "router.h"
 #include "rulebld.h"
@@ -1194,6 +1195,9 @@ static struct joinNode *CreateNewJoin(
    newJoin->memoryLeftDeletes = 0;
    newJoin->memoryRightDeletes = 0;
    newJoin->memoryCompares = 0;
+#if JOIN_STATISTICS
+   memset(&newJoin->statistics,0,sizeof(struct joinStatistics));
+#endif
 
    /*==============================================*/
    /* Install the expressions used to determine    */
@@ -1267,6 +1271,14 @@ static struct joinNode *CreateNewJoin(
 
    newJoin->rightSideEntryStructure = rhsEntryStruct;
 
+   /*=====================================================*/
+   /* Determine if the memories of the join can be sorted */
+   /* on the values compared by the join's network test.  */
+   /*=====================================================*/
+
+   newJoin->rangeIndex = CreateJoinRangeIndex(theEnv,newJoin);
+   newJoin->networkTestFunction = NULL;
+
    if (rhsEntryStruct == NULL)
      {
       if (newJoin->firstJoin)
@@ -144,7 +144,8 @@ void DefruleBasicCommands(
 /*   the reset command. Sets the current entity time */
 /*   tag (used by the conflict resolution strategies */
 /*   for recency) to zero. The focus stack is also   */
-/*   cleared.                                        */
+/*   cleared and a time sliced run left pending is   */
+/*   ended.                                          */
 /*****************************************************/
 static void ResetDefrules(
   Environment *theEnv,
@@ -155,6 +156,7 @@ static void ResetDefrules(
    struct partialMatch *notParent;
 
    DefruleData(theEnv)->CurrentEntityTimeTag = 1L;
+   EngineData(theEnv)->RunSlicePending = false;
    ClearFocusStack(theEnv);
    theModule = FindDefmodule(theEnv,"MAIN");
    Focus(theModule);
@@ -251,7 +253,8 @@ static bool ClearDefrulesReady(
   }
 
 /***************************************************************/
-/* ClearDefrules: Pushes the MAIN module as the current focus. */
+/* ClearDefrules: Pushes the MAIN module as the current focus  */
+/*   and ends a time sliced run left pending.                  */
 /***************************************************************/
 static void ClearDefrules(
   Environment *theEnv,
@@ -259,6 +262,8 @@ static void ClearDefrules(
   {
    Defmodule *theModule;
 
+   EngineData(theEnv)->RunSlicePending = false;
+
    theModule = FindDefmodule(theEnv,"MAIN");
    Focus(theModule);
   }
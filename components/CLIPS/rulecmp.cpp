@@ -52,10 +52,13 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "constant.h"
 #include "envrnmnt.h"
+#include "expressn.h"
 #include "factbld.h"
 #include "pattern.h"
 #include "reteutil.h"
+#include "sysdep.h"
 
 #include "rulecmp.h"
 
@@ -69,16 +72,25 @@
    static void                    LinkToCode(Environment *,FILE *,struct joinLink *,unsigned int,unsigned int);
    static void                    DefruleModuleToCode(Environment *,FILE *,Defmodule *,unsigned int,unsigned int,unsigned int);
    static void                    DefruleToCode(Environment *,FILE *,Defrule *,unsigned int,unsigned int,unsigned int);
-   static void                    CloseDefruleFiles(Environment *,FILE *,FILE *,FILE *,FILE*,unsigned int);
+   static void                    CloseDefruleFiles(Environment *,FILE *,FILE *,FILE *,FILE *,FILE *,unsigned int);
    static void                    BeforeDefrulesCode(Environment *);
    static void                    InitDefruleCode(Environment *,FILE *,unsigned int,unsigned int);
    static bool                    RuleCompilerTraverseJoins(Environment *,struct joinNode *,const char *,
                                                             const char *,char *,unsigned int,FILE *,
-                                                            unsigned int,unsigned int,FILE **,FILE **,
-                                                            unsigned int *,unsigned int *,unsigned int *,unsigned int *,unsigned int *);
+                                                            unsigned int,unsigned int,FILE **,FILE **,FILE **,
+                                                            unsigned int *,unsigned int *,unsigned int *,unsigned int *,
+                                                            unsigned int *,unsigned int *);
    static bool                    TraverseJoinLinks(Environment *,struct joinLink *,const char *,const char *,
                                                     char *,unsigned int,FILE *,unsigned int,unsigned int,
                                                     FILE **,unsigned int *,unsigned int *,unsigned int *);
+   static bool                    JoinTestFunctionToCode(Environment *,struct joinNode *,const char *,const char *,
+                                                         char *,unsigned int,FILE *,unsigned int,unsigned int,
+                                                         FILE **,unsigned int *,unsigned int *);
+   static bool                    JoinTestCanBeCompiled(Environment *,struct expr *);
+   static bool                    JoinTermCanBeCompiled(Environment *,struct expr *);
+   static bool                    JoinComparisonArgumentCanBeCompiled(struct expr *,bool);
+   static void                    JoinTermToCode(Environment *,FILE *,struct expr *);
+   static void                    JoinComparisonArgumentToCode(FILE *,struct expr *,const char *,const char *);
 
 /***********************************************************/
 /* DefruleCompilerSetup: Initializes the defrule construct */
@@ -88,7 +100,7 @@ void DefruleCompilerSetup(
   Environment *theEnv)
   {
    DefruleData(theEnv)->DefruleCodeItem = AddCodeGeneratorItem(theEnv,"defrules",0,BeforeDefrulesCode,
-                                          InitDefruleCode,ConstructToCode,4);
+                                          InitDefruleCode,ConstructToCode,5);
   }
 
 /**************************************************************/
@@ -125,7 +137,9 @@ static bool ConstructToCode(
    unsigned int linkArrayCount = 0, linkArrayVersion = 1;
    unsigned int moduleCount = 0, moduleArrayCount = 0, moduleArrayVersion = 1;
    unsigned int defruleArrayCount = 0, defruleArrayVersion = 1;
+   unsigned int testCount = 0;
    FILE *joinFile = NULL, *moduleFile = NULL, *defruleFile = NULL, *linkFile = NULL;
+   FILE *testFile = NULL;
 
    /*==============================================*/
    /* Include the appropriate defrule header file. */
@@ -140,14 +154,14 @@ static bool ConstructToCode(
    if (! TraverseJoinLinks(theEnv,DefruleData(theEnv)->LeftPrimeJoins,fileName,pathName,fileNameBuffer,fileID,headerFP,imageID,
                            maxIndices,&linkFile,&fileCount,&linkArrayVersion,&linkArrayCount))
      {
-      CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,maxIndices);
+      CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,testFile,maxIndices);
       return false;
      }
 
    if (! TraverseJoinLinks(theEnv,DefruleData(theEnv)->RightPrimeJoins,fileName,pathName,fileNameBuffer,fileID,headerFP,imageID,
                            maxIndices,&linkFile,&fileCount,&linkArrayVersion,&linkArrayCount))
      {
-      CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,maxIndices);
+      CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,testFile,maxIndices);
       return false;
      }
 
@@ -178,7 +192,7 @@ static bool ConstructToCode(
 
       if (moduleFile == NULL)
         {
-         CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,maxIndices);
+         CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,testFile,maxIndices);
          return false;
         }
 
@@ -209,7 +223,7 @@ static bool ConstructToCode(
                                            false,NULL);
             if (defruleFile == NULL)
               {
-               CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,maxIndices);
+               CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,testFile,maxIndices);
                return false;
               }
 
@@ -224,10 +238,10 @@ static bool ConstructToCode(
             /*================================*/
 
             if (! RuleCompilerTraverseJoins(theEnv,theDisjunct->lastJoin,fileName,pathName,fileNameBuffer,fileID,headerFP,imageID,
-                                            maxIndices,&joinFile,&linkFile,&fileCount,&joinArrayVersion,&joinArrayCount,
-                                            &linkArrayVersion,&linkArrayCount))
+                                            maxIndices,&joinFile,&linkFile,&testFile,&fileCount,&joinArrayVersion,&joinArrayCount,
+                                            &linkArrayVersion,&linkArrayCount,&testCount))
               {
-               CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,maxIndices);
+               CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,testFile,maxIndices);
                return false;
               }
            }
@@ -237,7 +251,7 @@ static bool ConstructToCode(
       moduleArrayCount++;
      }
 
-   CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,maxIndices);
+   CloseDefruleFiles(theEnv,moduleFile,defruleFile,joinFile,linkFile,testFile,maxIndices);
 
    return true;
   }
@@ -257,11 +271,13 @@ static bool RuleCompilerTraverseJoins(
   unsigned int maxIndices,
   FILE **joinFile,
   FILE **linkFile,
+  FILE **testFile,
   unsigned int *fileCount,
   unsigned int *joinArrayVersion,
   unsigned int *joinArrayCount,
   unsigned int *linkArrayVersion,
-  unsigned int *linkArrayCount)
+  unsigned int *linkArrayCount,
+  unsigned int *testCount)
   {
    for (;
         joinPtr != NULL;
@@ -280,6 +296,9 @@ static bool RuleCompilerTraverseJoins(
          *joinFile = CloseFileIfNeeded(theEnv,*joinFile,joinArrayCount,joinArrayVersion,
                                        maxIndices,NULL,NULL);
 
+         if (! JoinTestFunctionToCode(theEnv,joinPtr,fileName,pathName,fileNameBuffer,fileID,headerFP,imageID,
+                                      maxIndices,testFile,fileCount,testCount))
+           { return false; }
 
          if (! TraverseJoinLinks(theEnv,joinPtr->nextLinks,fileName,pathName,fileNameBuffer,fileID,headerFP,imageID,
                                  maxIndices,linkFile,fileCount,linkArrayVersion,linkArrayCount))
@@ -289,9 +308,9 @@ static bool RuleCompilerTraverseJoins(
       if (joinPtr->joinFromTheRight)
         {
          if (RuleCompilerTraverseJoins(theEnv,(struct joinNode *) joinPtr->rightSideEntryStructure,fileName,pathName,
-                                       fileNameBuffer,fileID,headerFP,imageID,maxIndices,joinFile,linkFile,fileCount,
+                                       fileNameBuffer,fileID,headerFP,imageID,maxIndices,joinFile,linkFile,testFile,fileCount,
                                        joinArrayVersion,joinArrayCount,
-                                       linkArrayVersion,linkArrayCount) == false)
+                                       linkArrayVersion,linkArrayCount,testCount) == false)
            { return false; }
         }
      }
@@ -348,11 +367,15 @@ static void CloseDefruleFiles(
   FILE *defruleFile,
   FILE *joinFile,
   FILE *linkFile,
+  FILE *testFile,
   unsigned int maxIndices)
   {
    unsigned int count = maxIndices;
    unsigned int arrayVersion = 0;
 
+   if (testFile != NULL)
+     { GenClose(theEnv,testFile); }
+
    if (linkFile != NULL)
      {
       count = maxIndices;
@@ -617,13 +640,28 @@ static void JoinToCode(
    /*==================*/
 
    if (theJoin->ruleToActivate == NULL)
-     { fprintf(joinFile,"NULL}"); }
+     { fprintf(joinFile,"NULL,"); }
    else
      {
-      fprintf(joinFile,"&%s%d_%ld[%ld]}",ConstructPrefix(DefruleData(theEnv)->DefruleCodeItem),imageID,
+      fprintf(joinFile,"&%s%d_%ld[%ld],",ConstructPrefix(DefruleData(theEnv)->DefruleCodeItem),imageID,
                                     (theJoin->ruleToActivate->header.bsaveID / maxIndices) + 1,
                                     theJoin->ruleToActivate->header.bsaveID % maxIndices);
      }
+
+   /*=============*/
+   /* Range Index */
+   /*=============*/
+
+   fprintf(joinFile,"NULL,");
+
+   /*=======================*/
+   /* Network Test Function */
+   /*=======================*/
+
+   if (JoinTestCanBeCompiled(theEnv,theJoin->networkTest))
+     { fprintf(joinFile,"%s%u_%lu}",JoinTestPrefix(),imageID,theJoin->bsaveID); }
+   else
+     { fprintf(joinFile,"NULL}"); }
   }
 
 /***************************************************/
@@ -676,6 +714,368 @@ static void LinkToCode(
    fprintf(theFile,"0}");
   }
 
+/*************************************************************/
+/* JoinTestFunctionToCode: Writes a C function which         */
+/*   evaluates the network test of a join to the join test   */
+/*   file, if the test has any part which can be compiled.   */
+/*   The run-time join calls the function in place of the    */
+/*   EvaluateJoinExpression function. The expressions of the */
+/*   test are still reached through the join, so that parts  */
+/*   which are not compiled can be evaluated as before.      */
+/*************************************************************/
+static bool JoinTestFunctionToCode(
+  Environment *theEnv,
+  struct joinNode *theJoin,
+  const char *fileName,
+  const char *pathName,
+  char *fileNameBuffer,
+  unsigned int fileID,
+  FILE *headerFP,
+  unsigned int imageID,
+  unsigned int maxIndices,
+  FILE **testFile,
+  unsigned int *fileCount,
+  unsigned int *testCount)
+  {
+   struct expr *theTest, *theTerm;
+   bool andLogic, comparisons = false;
+
+   if (! JoinTestCanBeCompiled(theEnv,theJoin->networkTest))
+     { return true; }
+
+   /*=========================================*/
+   /* Open a new join test file if necessary. */
+   /*=========================================*/
+
+   if (*testFile == NULL)
+     {
+      *testFile = NewCFile(theEnv,fileName,pathName,fileNameBuffer,fileID,*fileCount,false);
+      if (*testFile == NULL)
+        { return false; }
+      (*fileCount)++;
+
+      fprintf(*testFile,"#include \"drive.h\"\n");
+      fprintf(*testFile,"#include \"evaluatn.h\"\n");
+#if DEFTEMPLATE_CONSTRUCT
+      fprintf(*testFile,"#include \"factrete.h\"\n");
+#endif
+     }
+
+   fprintf(headerFP,"extern bool %s%u_%lu(Environment *,struct joinNode *);\n",
+                    JoinTestPrefix(),imageID,theJoin->bsaveID);
+
+   /*===========================================*/
+   /* Write the beginning of the function. A    */
+   /* top level and/or is evaluated inline with */
+   /* the same short cut evaluation performed   */
+   /* by the EvaluateJoinExpression function.   */
+   /*===========================================*/
+
+   theTest = theJoin->networkTest;
+
+   fprintf(*testFile,"\nbool %s%u_%lu(\n",JoinTestPrefix(),imageID,theJoin->bsaveID);
+   fprintf(*testFile,"  Environment *theEnv,\n");
+   fprintf(*testFile,"  struct joinNode *theJoin)\n");
+   fprintf(*testFile,"  {\n");
+
+   if ((theTest->value == ExpressionData(theEnv)->PTR_AND) ||
+       (theTest->value == ExpressionData(theEnv)->PTR_OR))
+     {
+      andLogic = (theTest->value == ExpressionData(theEnv)->PTR_AND);
+      fprintf(*testFile,"   struct expr *theTest = theJoin->networkTest->argList;\n");
+      theTest = theTest->argList;
+     }
+   else
+     {
+      andLogic = true;
+      fprintf(*testFile,"   struct expr *theTest = theJoin->networkTest;\n");
+     }
+
+   for (theTerm = theTest;
+        theTerm != NULL;
+        theTerm = theTerm->nextArg)
+     {
+      if ((theTerm->type == FCALL) && JoinTermCanBeCompiled(theEnv,theTerm))
+        { comparisons = true; }
+     }
+
+   if (comparisons)
+     { fprintf(*testFile,"   UDFValue v1, v2;\n"); }
+   else
+     { fprintf(*testFile,"   UDFValue v1;\n"); }
+   fprintf(*testFile,"   bool result = %s;\n",andLogic ? "true" : "false");
+
+   /*===========================*/
+   /* Write the code evaluating */
+   /* each part of the test.    */
+   /*===========================*/
+
+   for (;
+        theTest != NULL;
+        theTest = theTest->nextArg)
+     {
+      fprintf(*testFile,"\n");
+      JoinTermToCode(theEnv,*testFile,theTest);
+
+      if (andLogic)
+        { fprintf(*testFile,"   if (result == false) return false;\n"); }
+      else
+        { fprintf(*testFile,"   if (result == true) return true;\n"); }
+
+      if (theTest->nextArg != NULL)
+        { fprintf(*testFile,"   theTest = theTest->nextArg;\n"); }
+     }
+
+   fprintf(*testFile,"\n   return result;\n");
+   fprintf(*testFile,"  }\n");
+
+   /*==================================================*/
+   /* Start a new file if this one holds the maximum   */
+   /* number of functions allowed in a generated file. */
+   /*==================================================*/
+
+   (*testCount)++;
+   if (*testCount >= maxIndices)
+     {
+      GenClose(theEnv,*testFile);
+      *testFile = NULL;
+      *testCount = 0;
+     }
+
+   return true;
+  }
+
+/*************************************************************/
+/* JoinTestCanBeCompiled: Determines if a C function is to   */
+/*   be generated for a join network test, which is the case */
+/*   if at least one part of the test (or the test itself    */
+/*   when it isn't an and/or) can be evaluated by compiled   */
+/*   code.                                                   */
+/*************************************************************/
+static bool JoinTestCanBeCompiled(
+  Environment *theEnv,
+  struct expr *theTest)
+  {
+   if (theTest == NULL)
+     { return false; }
+
+   if ((theTest->value != ExpressionData(theEnv)->PTR_AND) &&
+       (theTest->value != ExpressionData(theEnv)->PTR_OR))
+     { return JoinTermCanBeCompiled(theEnv,theTest); }
+
+   for (theTest = theTest->argList;
+        theTest != NULL;
+        theTest = theTest->nextArg)
+     {
+      if (JoinTermCanBeCompiled(theEnv,theTest))
+        { return true; }
+     }
+
+   return false;
+  }
+
+/*************************************************************/
+/* JoinTermCanBeCompiled: Determines if one part of a join   */
+/*   network test can be evaluated by compiled code. These   */
+/*   are the fact variable comparisons of the join network   */
+/*   and the comparisons handled directly by the             */
+/*   EvaluateJoinExpression function: eq, neq, and numeric   */
+/*   comparisons of two constants or fact variables.         */
+/*************************************************************/
+static bool JoinTermCanBeCompiled(
+  Environment *theEnv,
+  struct expr *theTerm)
+  {
+   FunctionDefinition *theFunction;
+   bool numeric;
+
+#if DEFTEMPLATE_CONSTRUCT
+   if ((theTerm->type == FACT_JN_CMP1) || (theTerm->type == FACT_JN_CMP2))
+     { return true; }
+#endif
+
+   if (theTerm->type != FCALL)
+     { return false; }
+
+   theFunction = theTerm->functionValue;
+
+   if ((theFunction == ExpressionData(theEnv)->PTR_EQ) ||
+       (theFunction == ExpressionData(theEnv)->PTR_NEQ))
+     { numeric = false; }
+   else if ((theFunction == ExpressionData(theEnv)->PTR_LT) ||
+            (theFunction == ExpressionData(theEnv)->PTR_LE) ||
+            (theFunction == ExpressionData(theEnv)->PTR_GT) ||
+            (theFunction == ExpressionData(theEnv)->PTR_GE) ||
+            (theFunction == ExpressionData(theEnv)->PTR_NUM_EQ) ||
+            (theFunction == ExpressionData(theEnv)->PTR_NUM_NEQ))
+     { numeric = true; }
+   else
+     { return false; }
+
+   if ((theTerm->argList == NULL) ||
+       (theTerm->argList->nextArg == NULL) ||
+       (theTerm->argList->nextArg->nextArg != NULL))
+     { return false; }
+
+   return (JoinComparisonArgumentCanBeCompiled(theTerm->argList,numeric) &&
+           JoinComparisonArgumentCanBeCompiled(theTerm->argList->nextArg,numeric));
+  }
+
+/***************************************************************/
+/* JoinComparisonArgumentCanBeCompiled: Determines if compiled */
+/*   code can retrieve an argument of a comparison. Constants  */
+/*   compared with a numeric comparison must be numbers.       */
+/***************************************************************/
+static bool JoinComparisonArgumentCanBeCompiled(
+  struct expr *theArgument,
+  bool numeric)
+  {
+   switch (theArgument->type)
+     {
+      case INTEGER_TYPE:
+      case FLOAT_TYPE:
+        return true;
+
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+        return ! numeric;
+
+#if DEFTEMPLATE_CONSTRUCT
+      case FACT_JN_VAR1:
+      case FACT_JN_VAR2:
+      case FACT_JN_VAR3:
+        return true;
+#endif
+
+      default:
+        return false;
+     }
+  }
+
+/*************************************************************/
+/* JoinTermToCode: Writes the code which evaluates one part  */
+/*   of a join network test, pointed to by theTest, and      */
+/*   stores its value in result. Parts which aren't compiled */
+/*   and values which the compiled comparisons don't handle  */
+/*   (such as a symbol compared with a number, which is an   */
+/*   error) are evaluated by the EvaluateJoinTest function.  */
+/*************************************************************/
+static void JoinTermToCode(
+  Environment *theEnv,
+  FILE *theFile,
+  struct expr *theTerm)
+  {
+   FunctionDefinition *theFunction;
+   const char *failOp;
+
+   if (! JoinTermCanBeCompiled(theEnv,theTerm))
+     {
+      fprintf(theFile,"   if (! EvaluateJoinTest(theEnv,theTest,theJoin,&result))\n");
+      fprintf(theFile,"     { return false; }\n");
+      return;
+     }
+
+#if DEFTEMPLATE_CONSTRUCT
+   if (theTerm->type == FACT_JN_CMP1)
+     {
+      fprintf(theFile,"   result = FactJNCompVars1(theEnv,theTest->value,&v1);\n");
+      return;
+     }
+
+   if (theTerm->type == FACT_JN_CMP2)
+     {
+      fprintf(theFile,"   result = FactJNCompVars2(theEnv,theTest->value,&v1);\n");
+      return;
+     }
+#endif
+
+   /*===============================*/
+   /* Retrieve the compared values. */
+   /*===============================*/
+
+   JoinComparisonArgumentToCode(theFile,theTerm->argList,"v1","theTest->argList");
+   JoinComparisonArgumentToCode(theFile,theTerm->argList->nextArg,"v2","theTest->argList->nextArg");
+
+   /*===============================================*/
+   /* The eq and neq functions compare the values.  */
+   /* Multifield values are left to the functions.  */
+   /*===============================================*/
+
+   theFunction = theTerm->functionValue;
+
+   if ((theFunction == ExpressionData(theEnv)->PTR_EQ) ||
+       (theFunction == ExpressionData(theEnv)->PTR_NEQ))
+     {
+      fprintf(theFile,"   if ((v1.header->type != MULTIFIELD_TYPE) && (v2.header->type != MULTIFIELD_TYPE))\n");
+      fprintf(theFile,"     { result = (v1.value %s v2.value); }\n",
+                      (theFunction == ExpressionData(theEnv)->PTR_EQ) ? "==" : "!=");
+     }
+
+   /*==============================================*/
+   /* The numeric comparisons are written with the */
+   /* negated operator, as in the functions, so    */
+   /* that comparisons with NaN give the same      */
+   /* results.                                     */
+   /*==============================================*/
+
+   else
+     {
+      if (theFunction == ExpressionData(theEnv)->PTR_LT)
+        { failOp = ">="; }
+      else if (theFunction == ExpressionData(theEnv)->PTR_LE)
+        { failOp = ">"; }
+      else if (theFunction == ExpressionData(theEnv)->PTR_GT)
+        { failOp = "<="; }
+      else if (theFunction == ExpressionData(theEnv)->PTR_GE)
+        { failOp = "<"; }
+      else if (theFunction == ExpressionData(theEnv)->PTR_NUM_EQ)
+        { failOp = "!="; }
+      else
+        { failOp = "=="; }
+
+      fprintf(theFile,"   if (JoinTestNumbers(v1,v2))\n");
+      fprintf(theFile,"     { result = JoinTestCompare(v1,v2,%s); }\n",failOp);
+     }
+
+   fprintf(theFile,"   else if (! EvaluateJoinTest(theEnv,theTest,theJoin,&result))\n");
+   fprintf(theFile,"     { return false; }\n");
+  }
+
+/*************************************************************/
+/* JoinComparisonArgumentToCode: Writes the code retrieving  */
+/*   an argument of a compiled comparison. The fact variable */
+/*   retrieval functions are called directly instead of      */
+/*   through the primitives array.                           */
+/*************************************************************/
+static void JoinComparisonArgumentToCode(
+  FILE *theFile,
+  struct expr *theArgument,
+  const char *theValue,
+  const char *theExpression)
+  {
+   switch (theArgument->type)
+     {
+#if DEFTEMPLATE_CONSTRUCT
+      case FACT_JN_VAR1:
+        fprintf(theFile,"   FactJNGetVar1(theEnv,%s->value,&%s);\n",theExpression,theValue);
+        break;
+
+      case FACT_JN_VAR2:
+        fprintf(theFile,"   FactJNGetVar2(theEnv,%s->value,&%s);\n",theExpression,theValue);
+        break;
+
+      case FACT_JN_VAR3:
+        fprintf(theFile,"   FactJNGetVar3(theEnv,%s->value,&%s);\n",theExpression,theValue);
+        break;
+#endif
+
+      default:
+        fprintf(theFile,"   %s.value = %s->value;\n",theValue,theExpression);
+        break;
+     }
+  }
+
 /*************************************************************/
 /* DefruleCModuleReference: Writes the C code representation */
 /*   of a reference to a defrule module data structure.      */
@@ -108,6 +108,10 @@
 #include "rulebin.h"
 #endif
 
+#if JOIN_STATISTICS
+#include "joinstat.h"
+#endif
+
 #include "rulecom.h"
 
 /***************************************/
@@ -139,6 +143,7 @@ void DefruleCommands(
   {
 #if ! RUN_TIME
    AddUDF(theEnv,"run","v",0,1,"l",RunCommand,"RunCommand",NULL);
+   AddUDF(theEnv,"run-for","l",1,1,"l",RunForCommand,"RunForCommand",NULL);
    AddUDF(theEnv,"halt","v",0,0,NULL,HaltCommand,"HaltCommand",NULL);
    AddUDF(theEnv,"focus","b",1,UNBOUNDED,"y",FocusCommand,"FocusCommand",NULL);
    AddUDF(theEnv,"clear-focus-stack","v",0,0,NULL,ClearFocusStackCommand,"ClearFocusStackCommand",NULL);
@@ -162,6 +167,9 @@ void DefruleCommands(
    AddUDF(theEnv,"get-beta-memory-resizing","b",0,0,NULL,GetBetaMemoryResizingCommand,"GetBetaMemoryResizingCommand",NULL);
    AddUDF(theEnv,"set-beta-memory-resizing","b",1,1,NULL,SetBetaMemoryResizingCommand,"SetBetaMemoryResizingCommand",NULL);
 
+   AddUDF(theEnv,"get-join-range-memories","b",0,0,NULL,GetJoinRangeMemoriesCommand,"GetJoinRangeMemoriesCommand",NULL);
+   AddUDF(theEnv,"set-join-range-memories","b",1,1,NULL,SetJoinRangeMemoriesCommand,"SetJoinRangeMemoriesCommand",NULL);
+
    AddUDF(theEnv,"get-strategy","y",0,0,NULL,GetStrategyCommand,"GetStrategyCommand",NULL);
    AddUDF(theEnv,"set-strategy","y",1,1,"y",SetStrategyCommand,"SetStrategyCommand",NULL);
 
@@ -247,6 +255,72 @@ void GetBetaMemoryResizingCommand(
    returnValue->lexemeValue = CreateBoolean(theEnv,GetBetaMemoryResizing(theEnv));
   }
 
+/**********************************************/
+/* GetJoinRangeMemories: C access routine     */
+/*   for the get-join-range-memories command. */
+/**********************************************/
+bool GetJoinRangeMemories(
+  Environment *theEnv)
+  {
+   return DefruleData(theEnv)->JoinRangeMemoryFlag;
+  }
+
+/**********************************************/
+/* SetJoinRangeMemories: C access routine     */
+/*   for the set-join-range-memories command. */
+/**********************************************/
+bool SetJoinRangeMemories(
+  Environment *theEnv,
+  bool value)
+  {
+   bool ov;
+
+   ov = DefruleData(theEnv)->JoinRangeMemoryFlag;
+
+   DefruleData(theEnv)->JoinRangeMemoryFlag = value;
+
+   return(ov);
+  }
+
+/***************************************************/
+/* SetJoinRangeMemoriesCommand: H/L access routine */
+/*   for the set-join-range-memories command.      */
+/***************************************************/
+void SetJoinRangeMemoriesCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetJoinRangeMemories(theEnv));
+
+   /*================================================*/
+   /* The symbol FALSE disables join range memories. */
+   /* Any other value enables join range memories.   */
+   /*================================================*/
+
+   if (! UDFFirstArgument(context,ANY_TYPE_BITS,&theArg))
+     { return; }
+
+   if (theArg.value == FalseSymbol(theEnv))
+     { SetJoinRangeMemories(theEnv,false); }
+   else
+     { SetJoinRangeMemories(theEnv,true); }
+  }
+
+/***************************************************/
+/* GetJoinRangeMemoriesCommand: H/L access routine */
+/*   for the get-join-range-memories command.      */
+/***************************************************/
+void GetJoinRangeMemoriesCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetJoinRangeMemories(theEnv));
+  }
+
 /******************************************/
 /* GetFocusFunction: H/L access routine   */
 /*   for the get-focus function.          */
@@ -1267,21 +1341,31 @@ static void JoinActivityReset(
 #if MAC_XCD
 #pragma unused(buffer)
 #endif
-   Defrule *theDefrule = (Defrule *) theConstruct;
-   struct joinNode *theJoin = theDefrule->lastJoin;
+   Defrule *theDefrule;
+   struct joinNode *theJoin;
 
-   while (theJoin != NULL)
+   for (theDefrule = (Defrule *) theConstruct;
+        theDefrule != NULL;
+        theDefrule = theDefrule->disjunct)
      {
-      theJoin->memoryCompares = 0;
-      theJoin->memoryLeftAdds = 0;
-      theJoin->memoryRightAdds = 0;
-      theJoin->memoryLeftDeletes = 0;
-      theJoin->memoryRightDeletes = 0;
+      theJoin = theDefrule->lastJoin;
 
-      if (theJoin->joinFromTheRight)
-        { theJoin = (struct joinNode *) theJoin->rightSideEntryStructure; }
-      else
-        { theJoin = theJoin->lastLevel; }
+      while (theJoin != NULL)
+        {
+         theJoin->memoryCompares = 0;
+         theJoin->memoryLeftAdds = 0;
+         theJoin->memoryRightAdds = 0;
+         theJoin->memoryLeftDeletes = 0;
+         theJoin->memoryRightDeletes = 0;
+#if JOIN_STATISTICS
+         ResetJoinStatistics(theJoin);
+#endif
+
+         if (theJoin->joinFromTheRight)
+           { theJoin = (struct joinNode *) theJoin->rightSideEntryStructure; }
+         else
+           { theJoin = theJoin->lastLevel; }
+        }
      }
   }
 
@@ -78,6 +78,7 @@
 #include "envrnmnt.h"
 #include "memalloc.h"
 #include "pattern.h"
+#include "rangemem.h"
 #include "retract.h"
 #include "reteutil.h"
 #include "rulebsc.h"
@@ -153,6 +154,7 @@ void InitializeDefrules(
    for (i = 0; i < ALPHA_MEMORY_HASH_SIZE; i++) DefruleData(theEnv)->AlphaMemoryTable[i] = NULL;
 
    DefruleData(theEnv)->BetaMemoryResizingFlag = true;
+   DefruleData(theEnv)->JoinRangeMemoryFlag = true;
 
    DefruleData(theEnv)->RightPrimeJoins = NULL;
    DefruleData(theEnv)->LeftPrimeJoins = NULL;
@@ -461,6 +463,9 @@ void AddBetaMemoriesToJoin(
    if ((theNode->leftMemory != NULL) || (theNode->rightMemory != NULL))
      { return; }
 
+   if (theNode->rangeIndex == NULL)
+     { theNode->rangeIndex = CreateJoinRangeIndex(theEnv,theNode); }
+
    if ((! theNode->firstJoin) || theNode->patternIsExists || theNode-> patternIsNegated || theNode->joinFromTheRight)
      {
       if (theNode->leftHash == NULL)
@@ -0,0 +1,471 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                 RULE LATENCY MODULE                 */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Keeps a log-linear histogram of the time taken   */
+/*   by the firings of each rule and reports its             */
+/*   percentiles.                                            */
+/*                                                           */
+/*   The histogram is attached to the rule as user data when */
+/*   the rule first fires with tracking enabled. Each bucket */
+/*   counts the firings whose time, in microseconds, falls   */
+/*   within its range, so the memory used by a rule does not */
+/*   grow with the number of firings and a percentile is     */
+/*   found by walking the buckets.                           */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <string.h>
+
+#include "setup.h"
+
+#if RULE_LATENCY_FUNCTIONS
+
+#include "argacces.h"
+#include "cstrccom.h"
+#include "envrnmnt.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "prntutil.h"
+#include "router.h"
+#include "ruledef.h"
+#include "sysdep.h"
+
+#include "rulelat.h"
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                   *CreateRuleLatencyData(Environment *);
+   static void                    DeleteRuleLatencyData(Environment *,void *);
+   static unsigned int            LatencyBucket(unsigned long long);
+   static unsigned long long      LatencyBucketValue(unsigned int);
+   static void                    ListRuleLatencyAction(Environment *,ConstructHeader *,void *);
+   static void                    ResetRuleLatencyAction(Environment *,ConstructHeader *,void *);
+
+/******************************************************/
+/* RuleLatencyDefinitions: Initializes the rule       */
+/*   latency histograms and commands.                 */
+/******************************************************/
+void RuleLatencyDefinitions(
+  Environment *theEnv)
+  {
+   struct userDataRecord latencyDataInfo = { 0, CreateRuleLatencyData, DeleteRuleLatencyData };
+
+   AllocateEnvironmentData(theEnv,RULE_LATENCY_DATA,sizeof(struct ruleLatencyData),NULL);
+
+   memcpy(&RuleLatencyData(theEnv)->LatencyDataInfo,&latencyDataInfo,sizeof(struct userDataRecord));
+   RuleLatencyData(theEnv)->LatencyDataID = InstallUserDataRecord(theEnv,&RuleLatencyData(theEnv)->LatencyDataInfo);
+
+#if ! RUN_TIME
+   AddUDF(theEnv,"rule-latency","v",0,1,"y",RuleLatencyCommand,"RuleLatencyCommand",NULL);
+   AddUDF(theEnv,"rule-latency-percentile","lb",2,2,";y;ld",RuleLatencyPercentileCommand,"RuleLatencyPercentileCommand",NULL);
+   AddUDF(theEnv,"rule-latency-reset","v",0,0,NULL,RuleLatencyResetCommand,"RuleLatencyResetCommand",NULL);
+   AddUDF(theEnv,"set-rule-latency-tracking","b",1,1,NULL,SetRuleLatencyTrackingCommand,"SetRuleLatencyTrackingCommand",NULL);
+   AddUDF(theEnv,"get-rule-latency-tracking","b",0,0,NULL,GetRuleLatencyTrackingCommand,"GetRuleLatencyTrackingCommand",NULL);
+#endif
+  }
+
+/*****************************************************/
+/* CreateRuleLatencyData: Allocates an empty latency */
+/*   histogram for a rule.                           */
+/*****************************************************/
+static void *CreateRuleLatencyData(
+  Environment *theEnv)
+  {
+   struct ruleLatencyInfo *theInfo;
+
+   theInfo = (struct ruleLatencyInfo *) genalloc(theEnv,sizeof(struct ruleLatencyInfo));
+   memset(theInfo,0,sizeof(struct ruleLatencyInfo));
+
+   return theInfo;
+  }
+
+/*************************************************/
+/* DeleteRuleLatencyData: Returns the memory of  */
+/*   the latency histogram of a rule.            */
+/*************************************************/
+static void DeleteRuleLatencyData(
+  Environment *theEnv,
+  void *theData)
+  {
+   genfree(theEnv,theData,sizeof(struct ruleLatencyInfo));
+  }
+
+/********************************************************/
+/* LatencyBucket: Returns the bucket counting a latency */
+/*   of the given number of microseconds.               */
+/********************************************************/
+static unsigned int LatencyBucket(
+  unsigned long long value)
+  {
+   unsigned int shift = 0;
+   unsigned int bucket;
+
+   if (value < LATENCY_SUB_BUCKETS)
+     { return (unsigned int) value; }
+
+   while ((value >> shift) >= LATENCY_SUB_BUCKETS)
+     { shift++; }
+
+   bucket = LATENCY_SUB_BUCKETS + ((shift - 1) * (LATENCY_SUB_BUCKETS / 2)) +
+            (unsigned int) ((value >> shift) - (LATENCY_SUB_BUCKETS / 2));
+
+   if (bucket >= LATENCY_BUCKETS)
+     { bucket = LATENCY_BUCKETS - 1; }
+
+   return bucket;
+  }
+
+/*********************************************************/
+/* LatencyBucketValue: Returns the highest latency, in   */
+/*   microseconds, counted by a bucket.                  */
+/*********************************************************/
+static unsigned long long LatencyBucketValue(
+  unsigned int bucket)
+  {
+   unsigned int shift;
+   unsigned long long subBucket;
+
+   if (bucket < LATENCY_SUB_BUCKETS)
+     { return bucket; }
+
+   shift = ((bucket - LATENCY_SUB_BUCKETS) / (LATENCY_SUB_BUCKETS / 2)) + 1;
+   subBucket = ((bucket - LATENCY_SUB_BUCKETS) % (LATENCY_SUB_BUCKETS / 2)) + (LATENCY_SUB_BUCKETS / 2);
+
+   return ((subBucket + 1) << shift) - 1;
+  }
+
+/***********************************************************/
+/* RecordRuleLatency: Adds the time taken by a firing of a */
+/*   rule (or of one of its disjuncts) to its histogram.   */
+/***********************************************************/
+void RecordRuleLatency(
+  Environment *theEnv,
+  Defrule *theRule,
+  long long microseconds)
+  {
+   struct ruleLatencyInfo *theInfo;
+
+   if (microseconds < 0)
+     { microseconds = 0; }
+
+   theInfo = (struct ruleLatencyInfo *)
+             FetchUserData(theEnv,RuleLatencyData(theEnv)->LatencyDataID,&theRule->header.usrData);
+
+   theInfo->count++;
+   theInfo->total += (unsigned long long) microseconds;
+   if ((unsigned long long) microseconds > theInfo->maximum)
+     { theInfo->maximum = (unsigned long long) microseconds; }
+
+   theInfo->buckets[LatencyBucket((unsigned long long) microseconds)]++;
+  }
+
+/************************************************************/
+/* RuleLatencyPercentile: Returns the latency, in           */
+/*   microseconds, at or below which the given percentage   */
+/*   of the firings of a rule and its disjuncts fell, or -1 */
+/*   if the rule has not fired while it was tracked.        */
+/************************************************************/
+long long RuleLatencyPercentile(
+  Environment *theEnv,
+  Defrule *theRule,
+  double percent)
+  {
+   Defrule *theDisjunct;
+   struct ruleLatencyInfo *theInfo;
+   unsigned long long count = 0, maximum = 0, target, seen = 0;
+   unsigned int i;
+   unsigned char theID = RuleLatencyData(theEnv)->LatencyDataID;
+
+   for (theDisjunct = theRule; theDisjunct != NULL; theDisjunct = theDisjunct->disjunct)
+     {
+      theInfo = (struct ruleLatencyInfo *) TestUserData(theID,theDisjunct->header.usrData);
+      if (theInfo == NULL) continue;
+
+      count += theInfo->count;
+      if (theInfo->maximum > maximum)
+        { maximum = theInfo->maximum; }
+     }
+
+   if (count == 0)
+     { return -1; }
+
+   if (percent >= 100.0)
+     { return (long long) maximum; }
+
+   target = (unsigned long long) ((percent * (double) count / 100.0) + 0.999999);
+   if (target < 1)
+     { target = 1; }
+
+   for (i = 0; i < LATENCY_BUCKETS; i++)
+     {
+      for (theDisjunct = theRule; theDisjunct != NULL; theDisjunct = theDisjunct->disjunct)
+        {
+         theInfo = (struct ruleLatencyInfo *) TestUserData(theID,theDisjunct->header.usrData);
+         if (theInfo != NULL)
+           { seen += theInfo->buckets[i]; }
+        }
+
+      if (seen >= target)
+        {
+         if (LatencyBucketValue(i) < maximum)
+           { return (long long) LatencyBucketValue(i); }
+         return (long long) maximum;
+        }
+     }
+
+   return (long long) maximum;
+  }
+
+/***************************************************************/
+/* ListRuleLatency: Prints the number of firings and the mean, */
+/*   median, 90th, 99th and 99.9th percentile and maximum time */
+/*   in microseconds of a rule, or of every rule which has     */
+/*   fired while tracked if the rule is NULL.                  */
+/***************************************************************/
+void ListRuleLatency(
+  Environment *theEnv,
+  const char *logicalName,
+  Defrule *theRule)
+  {
+   WriteString(theEnv,logicalName,"       Count      Mean       p50       p90       p99     p99.9       Max  Rule\n");
+   WriteString(theEnv,logicalName,"       -----      ----       ---       ---       ---     -----       ---  ----\n");
+
+   if (theRule != NULL)
+     { ListRuleLatencyAction(theEnv,&theRule->header,(void *) logicalName); }
+   else
+     {
+      DoForAllConstructs(theEnv,ListRuleLatencyAction,
+                         DefruleData(theEnv)->DefruleModuleIndex,true,(void *) logicalName);
+     }
+  }
+
+/*******************************************************/
+/* ListRuleLatencyAction: Prints the latency line of a */
+/*   rule for ListRuleLatency.                         */
+/*******************************************************/
+static void ListRuleLatencyAction(
+  Environment *theEnv,
+  ConstructHeader *theConstruct,
+  void *buffer)
+  {
+   const char *logicalName = (const char *) buffer;
+   Defrule *theRule = (Defrule *) theConstruct, *theDisjunct;
+   struct ruleLatencyInfo *theInfo;
+   unsigned long long count = 0, total = 0;
+   char printSpace[100];
+
+   for (theDisjunct = theRule; theDisjunct != NULL; theDisjunct = theDisjunct->disjunct)
+     {
+      theInfo = (struct ruleLatencyInfo *)
+                TestUserData(RuleLatencyData(theEnv)->LatencyDataID,theDisjunct->header.usrData);
+      if (theInfo == NULL) continue;
+
+      count += theInfo->count;
+      total += theInfo->total;
+     }
+
+   if (count == 0)
+     { return; }
+
+   gensnprintf(printSpace,sizeof(printSpace),"%12llu %9llu %9lld %9lld %9lld %9lld %9lld  ",
+               count,total / count,
+               RuleLatencyPercentile(theEnv,theRule,50.0),
+               RuleLatencyPercentile(theEnv,theRule,90.0),
+               RuleLatencyPercentile(theEnv,theRule,99.0),
+               RuleLatencyPercentile(theEnv,theRule,99.9),
+               RuleLatencyPercentile(theEnv,theRule,100.0));
+   WriteString(theEnv,logicalName,printSpace);
+
+   WriteString(theEnv,logicalName,DefruleModule(theRule));
+   WriteString(theEnv,logicalName,"::");
+   WriteString(theEnv,logicalName,DefruleName(theRule));
+   WriteString(theEnv,logicalName,"\n");
+  }
+
+/***************************************************/
+/* ResetRuleLatency: Empties the latency histogram */
+/*   of every rule.                                */
+/***************************************************/
+void ResetRuleLatency(
+  Environment *theEnv)
+  {
+   DoForAllConstructs(theEnv,ResetRuleLatencyAction,
+                      DefruleData(theEnv)->DefruleModuleIndex,false,NULL);
+  }
+
+/*********************************************************/
+/* ResetRuleLatencyAction: Returns the latency histogram */
+/*   of a rule and its disjuncts for ResetRuleLatency.   */
+/*********************************************************/
+static void ResetRuleLatencyAction(
+  Environment *theEnv,
+  ConstructHeader *theConstruct,
+  void *buffer)
+  {
+#if MAC_XCD
+#pragma unused(buffer)
+#endif
+   Defrule *theDisjunct;
+
+   for (theDisjunct = (Defrule *) theConstruct;
+        theDisjunct != NULL;
+        theDisjunct = theDisjunct->disjunct)
+     {
+      theDisjunct->header.usrData =
+         DeleteUserData(theEnv,RuleLatencyData(theEnv)->LatencyDataID,theDisjunct->header.usrData);
+     }
+  }
+
+/**************************************************/
+/* SetRuleLatencyTracking: C access routine for   */
+/*   the set-rule-latency-tracking command.       */
+/**************************************************/
+bool SetRuleLatencyTracking(
+  Environment *theEnv,
+  bool value)
+  {
+   bool oldValue;
+
+   oldValue = RuleLatencyData(theEnv)->Tracking;
+   RuleLatencyData(theEnv)->Tracking = value;
+
+   return oldValue;
+  }
+
+/**************************************************/
+/* GetRuleLatencyTracking: C access routine for   */
+/*   the get-rule-latency-tracking command.       */
+/**************************************************/
+bool GetRuleLatencyTracking(
+  Environment *theEnv)
+  {
+   return RuleLatencyData(theEnv)->Tracking;
+  }
+
+/******************************************/
+/* RuleLatencyCommand: H/L access routine */
+/*   for the rule-latency command.        */
+/******************************************/
+void RuleLatencyCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   Defrule *theRule = NULL;
+
+   if (UDFHasNextArgument(context))
+     {
+      if (! UDFFirstArgument(context,SYMBOL_BIT,&theArg))
+        { return; }
+
+      theRule = FindDefrule(theEnv,theArg.lexemeValue->contents);
+      if (theRule == NULL)
+        {
+         CantFindItemErrorMessage(theEnv,"defrule",theArg.lexemeValue->contents,true);
+         return;
+        }
+     }
+
+   ListRuleLatency(theEnv,STDOUT,theRule);
+  }
+
+/****************************************************/
+/* RuleLatencyPercentileCommand: H/L access routine */
+/*   for the rule-latency-percentile command.       */
+/****************************************************/
+void RuleLatencyPercentileCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   Defrule *theRule;
+   double percent;
+
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+
+   if (! UDFFirstArgument(context,SYMBOL_BIT,&theArg))
+     { return; }
+
+   theRule = FindDefrule(theEnv,theArg.lexemeValue->contents);
+   if (theRule == NULL)
+     {
+      CantFindItemErrorMessage(theEnv,"defrule",theArg.lexemeValue->contents,true);
+      return;
+     }
+
+   if (! UDFNextArgument(context,NUMBER_BITS,&theArg))
+     { return; }
+
+   percent = CVCoerceToFloat(&theArg);
+   if ((percent < 0.0) || (percent > 100.0))
+     {
+      UDFInvalidArgumentMessage(context,"number in the range 0 to 100");
+      return;
+     }
+
+   returnValue->integerValue = CreateInteger(theEnv,RuleLatencyPercentile(theEnv,theRule,percent));
+  }
+
+/***********************************************/
+/* RuleLatencyResetCommand: H/L access routine */
+/*   for the rule-latency-reset command.       */
+/***********************************************/
+void RuleLatencyResetCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   ResetRuleLatency(theEnv);
+  }
+
+/*****************************************************/
+/* SetRuleLatencyTrackingCommand: H/L access routine */
+/*   for the set-rule-latency-tracking command.      */
+/*****************************************************/
+void SetRuleLatencyTrackingCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetRuleLatencyTracking(theEnv));
+
+   if (! UDFFirstArgument(context,ANY_TYPE_BITS,&theArg))
+     { return; }
+
+   if (theArg.value == FalseSymbol(theEnv))
+     { SetRuleLatencyTracking(theEnv,false); }
+   else
+     { SetRuleLatencyTracking(theEnv,true); }
+  }
+
+/*****************************************************/
+/* GetRuleLatencyTrackingCommand: H/L access routine */
+/*   for the get-rule-latency-tracking command.      */
+/*****************************************************/
+void GetRuleLatencyTrackingCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetRuleLatencyTracking(theEnv));
+  }
+
+#endif /* RULE_LATENCY_FUNCTIONS */
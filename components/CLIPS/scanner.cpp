@@ -45,7 +45,6 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <string.h>
-#include <errno.h>
 #include <stdlib.h>
 
 #include "setup.h"
@@ -53,6 +52,7 @@
 #include "constant.h"
 #include "envrnmnt.h"
 #include "memalloc.h"
+#include "numconv.h"
 #include "pprint.h"
 #include "prntutil.h"
 #include "router.h"
@@ -69,6 +69,8 @@
    static CLIPSLexeme            *ScanSymbol(Environment *,const char *,int,TokenType *);
    static CLIPSLexeme            *ScanString(Environment *,const char *);
    static void                    ScanNumber(Environment *,const char *,struct token *);
+   static void                    SkipWhiteSpaceSpan(Environment *,const char *);
+   static void                    InitializeCharacterClasses(Environment *);
    static void                    DeallocateScannerData(Environment *);
 
 /************************************************/
@@ -79,6 +81,47 @@ void InitializeScannerData(
   Environment *theEnv)
   {
    AllocateEnvironmentData(theEnv,SCANNER_DATA,sizeof(struct scannerData),DeallocateScannerData);
+   InitializeCharacterClasses(theEnv);
+  }
+
+/******************************************************/
+/* InitializeCharacterClasses: Sets up the table used */
+/*   to classify characters when an input span is     */
+/*   scanned. The null character and backspace are    */
+/*   kept out of the classes that would consume them, */
+/*   so they are read a character at a time.          */
+/******************************************************/
+static void InitializeCharacterClasses(
+  Environment *theEnv)
+  {
+   int ch;
+   unsigned char theClass;
+
+   for (ch = 0; ch < 256; ch++)
+     {
+      theClass = 0;
+
+      if ((ch == ' ') || (ch == '\n') || (ch == '\f') ||
+          (ch == '\r') || (ch == '\t'))
+        { theClass |= WHITE_SPACE_CLASS; }
+
+      if ((ch != '\n') && (ch != '\r') && (ch != '\0'))
+        { theClass |= COMMENT_CLASS; }
+
+      if ((ch != '<') && (ch != '"') &&
+          (ch != '(') && (ch != ')') &&
+          (ch != '&') && (ch != '|') && (ch != '~') &&
+          (ch != ' ') && (ch != ';') &&
+          (IsUTF8MultiByteStart(ch) ||
+           IsUTF8MultiByteContinuation(ch) ||
+           isprint(ch)))
+        { theClass |= SYMBOL_CLASS; }
+
+      if ((ch != '"') && (ch != '\\') && (ch != '\b') && (ch != '\0'))
+        { theClass |= STRING_CLASS; }
+
+      ScannerData(theEnv)->CharacterClass[ch] = theClass;
+     }
   }
 
 /**************************************************/
@@ -123,6 +166,8 @@ void GetToken(
    /* GetToken() request.                          */
    /*==============================================*/
 
+   SkipWhiteSpaceSpan(theEnv,logicalName);
+
    inchar = ReadRouter(theEnv,logicalName);
    while ((inchar == ' ') || (inchar == '\n') || (inchar == '\f') ||
           (inchar == '\r') || (inchar == ';') || (inchar == '\t'))
@@ -424,6 +469,46 @@ void GetToken(
    return;
   }
 
+/*****************************************************/
+/* SkipWhiteSpaceSpan: Skips the white space and     */
+/*   comments at the start of the input span of a    */
+/*   logical name. Whatever can't be decided within  */
+/*   the span (such as a comment running to its end) */
+/*   is left to be read a character at a time.       */
+/*****************************************************/
+static void SkipWhiteSpaceSpan(
+  Environment *theEnv,
+  const char *logicalName)
+  {
+   const char *span;
+   const unsigned char *theClass = ScannerData(theEnv)->CharacterClass;
+   size_t length, i = 0, j;
+
+   span = ReadRouterSpan(theEnv,logicalName,&length);
+   if (span == NULL) return;
+
+   while (i < length)
+     {
+      if (theClass[(unsigned char) span[i]] & WHITE_SPACE_CLASS)
+        { i++; }
+      else if (span[i] == ';')
+        {
+         j = i + 1;
+         while ((j < length) && (theClass[(unsigned char) span[j]] & COMMENT_CLASS))
+           { j++; }
+
+         if ((j == length) || (span[j] == '\0'))
+           { break; }
+
+         i = j + 1;
+        }
+      else
+        { break; }
+     }
+
+   AdvanceRouterSpan(theEnv,logicalName,span,i);
+  }
+
 /*************************************/
 /* ScanSymbol: Scans a symbol token. */
 /*************************************/
@@ -434,10 +519,32 @@ static CLIPSLexeme *ScanSymbol(
   TokenType *type)
   {
    int inchar;
+   const char *span;
+   size_t length, i = 0;
 #if OBJECT_SYSTEM
    CLIPSLexeme *symbol;
 #endif
 
+   /*=================================================*/
+   /* If the input source has a span, take the symbol */
+   /* characters at its start in a single step.       */
+   /*=================================================*/
+
+   span = ReadRouterSpan(theEnv,logicalName,&length);
+   if (span != NULL)
+     {
+      while ((i < length) &&
+             (ScannerData(theEnv)->CharacterClass[(unsigned char) span[i]] & SYMBOL_CLASS))
+        { i++; }
+
+      if (i > 0)
+        {
+         ScannerData(theEnv)->GlobalString = AppendNToString(theEnv,span,ScannerData(theEnv)->GlobalString,i,&ScannerData(theEnv)->GlobalPos,&ScannerData(theEnv)->GlobalMax);
+         count += (int) i;
+         AdvanceRouterSpan(theEnv,logicalName,span,i);
+        }
+     }
+
    /*=====================================*/
    /* Scan characters and add them to the */
    /* symbol until a delimiter is found.  */
@@ -514,6 +621,39 @@ static CLIPSLexeme *ScanString(
    size_t max = 0;
    char *theString = NULL;
    CLIPSLexeme *thePtr;
+   const char *span;
+   const unsigned char *theClass = ScannerData(theEnv)->CharacterClass;
+   size_t length, i = 0, start;
+
+   /*==================================================*/
+   /* If the input source has a span, take the string  */
+   /* characters and escapes at its start in bulk. The */
+   /* closing delimiter is left for the loop below.    */
+   /*==================================================*/
+
+   span = ReadRouterSpan(theEnv,logicalName,&length);
+   if (span != NULL)
+     {
+      while (true)
+        {
+         start = i;
+         while ((i < length) && (theClass[(unsigned char) span[i]] & STRING_CLASS))
+           { i++; }
+
+         if (i > start)
+           { theString = AppendNToString(theEnv,&span[start],theString,i - start,&pos,&max); }
+
+         if ((i + 1 < length) && (span[i] == '\\') && (span[i+1] != '\0'))
+           {
+            theString = ExpandStringWithChar(theEnv,(unsigned char) span[i+1],theString,&pos,&max,max+80);
+            i += 2;
+           }
+         else
+           { break; }
+        }
+
+      AdvanceRouterSpan(theEnv,logicalName,span,i);
+     }
 
    /*============================================*/
    /* Scan characters and add them to the string */
@@ -770,20 +910,14 @@ static void ScanNumber(
 
    if (processFloat)
      {
-      fvalue = atof(ScannerData(theEnv)->GlobalString);
+      fvalue = ParseFloat(ScannerData(theEnv)->GlobalString);
       theToken->tknType = FLOAT_TOKEN;
       theToken->floatValue = CreateFloat(theEnv,fvalue);
       theToken->printForm = FloatToString(theEnv,theToken->floatValue->contents);
      }
    else
      {
-      errno = 0;
-#if WIN_MVC
-      lvalue = _strtoi64(ScannerData(theEnv)->GlobalString,NULL,10);
-#else
-      lvalue = strtoll(ScannerData(theEnv)->GlobalString,NULL,10);
-#endif
-      if (errno)
+      if (! ParseInteger(ScannerData(theEnv)->GlobalString,&lvalue))
         {
          PrintWarningID(theEnv,"SCANNER",1,false);
          WriteString(theEnv,STDWRN,"Over or underflow of long long integer.\n");
@@ -0,0 +1,3430 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*                   SNAPSHOT MODULE                   */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Saves the constructs and the working memory of   */
+/*   an environment to a file and restores them without      */
+/*   pattern matching, so that a restarted application can   */
+/*   continue from the state it had when it was saved.       */
+/*                                                           */
+/*   The file begins with the binary image of the constructs */
+/*   (the same image written by bsave), followed by the      */
+/*   facts, instances, partial matches, activations, focus   */
+/*   stack, and defglobal values. Their size and checksum    */
+/*   are in the header and are verified before anything is   */
+/*   replaced by load-snapshot. If the constructs were       */
+/*   loaded with bload, only the working memory is saved     */
+/*   and the snapshot can only be restored into the same     */
+/*   constructs. Partial matches are stored by position:     */
+/*   the joins and pattern nodes of the rule network are     */
+/*   numbered in the order they are found from the rules of  */
+/*   each module, and a fingerprint of the network is        */
+/*   checked before anything is restored. Partial matches    */
+/*   are then linked exactly as they were saved, so the      */
+/*   agenda, blocked partial matches, and logical support    */
+/*   are restored rather than recomputed.                    */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if SNAPSHOT_FUNCTIONS
+
+#include "agenda.h"
+#include "argacces.h"
+#include "bload.h"
+#include "bsave.h"
+#include "constant.h"
+#include "cstrcpsr.h"
+#include "drive.h"
+#include "engine.h"
+#include "envrnmnt.h"
+#if FACT_JOURNAL_FUNCTIONS
+#include "factjrnl.h"
+#endif
+#include "factmngr.h"
+#include "lgcldpnd.h"
+#include "memalloc.h"
+#include "moduldef.h"
+#include "multifld.h"
+#include "network.h"
+#include "prntutil.h"
+#include "rangemem.h"
+#include "reteutil.h"
+#include "retract.h"
+#include "router.h"
+#include "ruledef.h"
+#include "symbol.h"
+#include "sysdep.h"
+#include "tmpltdef.h"
+#include "tmpltutl.h"
+#include "utility.h"
+
+#if OBJECT_SYSTEM
+#include "classcom.h"
+#include "inscom.h"
+#include "insfun.h"
+#include "insmngr.h"
+#include "object.h"
+#include "objrtfnx.h"
+#include "objrtmch.h"
+#endif
+
+#if DEFGLOBAL_CONSTRUCT
+#include "globldef.h"
+#endif
+
+#include "snapshot.h"
+
+#define SNAPSHOT_PREFIX_ID "\1\2\3\4CLIPS-SNAPSHOT"
+
+#define SNAPSHOT_NO_MEMORY          0
+#define SNAPSHOT_MEMORY             1
+#define SNAPSHOT_SEED_MEMORY        2
+
+#define SNAPSHOT_NO_MARKER          0
+#define SNAPSHOT_MATCH_MARKER       1
+#define SNAPSHOT_ACTIVATION_MARKER  2
+
+#define SNAPSHOT_RECOMPUTE_HASH     0x01
+
+#define SNAPSHOT_LINK_COUNT         10
+
+#define SNAPSHOT_CHECKSUM_SEED      2166136261UL
+#define SNAPSHOT_CHECK_BUFFER_SIZE  256
+
+/***************************************************/
+/* snapshotTable: Numbers the items of one kind in */
+/*   the order they are added (starting with 1).   */
+/*   The optional index finds the number of an     */
+/*   item from its address.                        */
+/***************************************************/
+struct snapshotTable
+  {
+   void **items;
+   unsigned long count;
+   unsigned long arraySize;
+   unsigned long *index;
+   unsigned long indexSize;
+   bool indexed;
+  };
+
+struct snapshotData
+  {
+   struct snapshotTable rules;
+   struct snapshotTable joins;
+   struct snapshotTable nodes;
+   struct snapshotTable templates;
+   struct snapshotTable classes;
+   struct snapshotTable entities;
+   unsigned long factCount;
+   struct snapshotTable matches;
+   struct snapshotTable alphaMatches;
+   unsigned long alphaCount;
+   struct snapshotTable activations;
+   bool factsInstalled;
+  };
+
+struct snapshotWriter
+  {
+   FILE *fp;
+   unsigned long size;
+   bool error;
+  };
+
+struct snapshotReader
+  {
+   const char *data;
+   size_t size;
+   size_t position;
+   bool error;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    InitSnapshotTable(struct snapshotTable *,bool);
+   static unsigned long           AddSnapshotItem(Environment *,struct snapshotTable *,void *);
+   static unsigned long           FindSnapshotItem(struct snapshotTable *,void *);
+   static unsigned long           InternSnapshotItem(Environment *,struct snapshotTable *,void *);
+   static void                    IndexSnapshotItem(struct snapshotTable *,unsigned long);
+   static void                    FreeSnapshotTable(Environment *,struct snapshotTable *);
+   static void                    InitSnapshotData(struct snapshotData *);
+   static void                    FreeSnapshotData(Environment *,struct snapshotData *);
+   static bool                    SnapshotAllowed(Environment *);
+   static void                    CollectSnapshotNetwork(Environment *,struct snapshotData *);
+   static void                    CollectSnapshotJoin(Environment *,struct snapshotData *,struct joinNode *);
+   static int                     SnapshotMemoryKind(struct joinNode *,int);
+   static struct betaMemory      *SnapshotMemory(struct joinNode *,int);
+   static unsigned char           SnapshotJoinFlags(struct joinNode *);
+   static unsigned long           SnapshotSeedCount(struct betaMemory *);
+   static void                    CollectSnapshotEntities(Environment *,struct snapshotData *);
+   static void                    CollectSnapshotMatches(Environment *,struct snapshotData *);
+   static void                    CollectSnapshotActivations(Environment *,struct snapshotData *);
+   static unsigned long           SnapshotChecksum(unsigned long,const void *,size_t);
+   static bool                    WriteSnapshotChecksum(Environment *,FILE *,long long);
+   static bool                    CheckSnapshotContents(Environment *,unsigned long,unsigned long);
+   static void                    WriteSnapshotBytes(struct snapshotWriter *,const void *,size_t);
+   static void                    WriteSnapshotString(struct snapshotWriter *,const char *);
+   static bool                    WriteSnapshotValue(Environment *,struct snapshotData *,struct snapshotWriter *,
+                                                     unsigned short,void *);
+   static bool                    WriteSnapshotWorkingMemory(Environment *,struct snapshotData *,struct snapshotWriter *);
+   static void                    WriteSnapshotFingerprint(struct snapshotData *,struct snapshotWriter *);
+   static bool                    WriteSnapshotEntities(Environment *,struct snapshotData *,struct snapshotWriter *);
+   static bool                    WriteSnapshotAlphaMatches(Environment *,struct snapshotData *,struct snapshotWriter *);
+   static bool                    WriteSnapshotBetaMatches(Environment *,struct snapshotData *,struct snapshotWriter *);
+   static bool                    WriteSnapshotLinks(Environment *,struct snapshotData *,struct snapshotWriter *);
+   static bool                    WriteSnapshotEntityLinks(Environment *,struct snapshotData *,struct snapshotWriter *);
+   static bool                    WriteSnapshotGlobals(Environment *,struct snapshotData *,struct snapshotWriter *);
+   static unsigned long           SnapshotAlphaHash(Environment *,struct snapshotData *,struct partialMatch *,
+                                                    struct patternNodeHeader *,unsigned long);
+   static bool                    ReadSnapshotBytes(struct snapshotReader *,void *,size_t);
+   static const char             *ReadSnapshotString(struct snapshotReader *);
+   static bool                    ReadSnapshotCount(struct snapshotReader *,unsigned long *,size_t);
+   static bool                    ReadSnapshotID(struct snapshotReader *,unsigned long *,unsigned long);
+   static bool                    ReadSnapshotValue(Environment *,struct snapshotData *,struct snapshotReader *,
+                                                    bool,bool,CLIPSValue *);
+   static bool                    RestoreSnapshotWorkingMemory(Environment *,const char *,struct snapshotReader *);
+   static bool                    CheckSnapshotFingerprint(struct snapshotData *,struct snapshotReader *);
+   static bool                    ReadSnapshotConstructs(Environment *,struct snapshotData *,struct snapshotReader *);
+   static Defmodule              *ReadSnapshotModule(Environment *,struct snapshotReader *);
+   static void                    ClearSnapshotWorkingMemory(Environment *,struct snapshotData *);
+   static void                    ClearSnapshotMemory(Environment *,struct joinNode *,int);
+   static void                    ReturnSnapshotPatternMatches(Environment *,struct patternMatch *);
+   static void                    ReturnSnapshotDependencies(Environment *,struct dependency *);
+   static void                    ReturnSnapshotFacts(Environment *,struct snapshotData *);
+   static bool                    RestoreSnapshotEntities(Environment *,struct snapshotData *,struct snapshotReader *);
+   static bool                    RestoreSnapshotAlphaMatches(Environment *,struct snapshotData *,struct snapshotReader *);
+   static bool                    RestoreSnapshotBetaMatches(Environment *,struct snapshotData *,struct snapshotReader *);
+   static bool                    RestoreSnapshotMemory(Environment *,struct snapshotData *,struct snapshotReader *,
+                                                        struct joinNode *,int);
+   static bool                    RestoreSnapshotActivations(Environment *,struct snapshotData *,struct snapshotReader *);
+   static bool                    RestoreSnapshotLinks(Environment *,struct snapshotData *,struct snapshotReader *);
+   static bool                    RestoreSnapshotEntityLinks(Environment *,struct snapshotData *,struct snapshotReader *);
+   static bool                    RestoreSnapshotFocus(Environment *,struct snapshotData *,struct snapshotReader *);
+   static bool                    RestoreSnapshotGlobals(Environment *,struct snapshotData *,struct snapshotReader *);
+   static struct dependency      *RestoreSnapshotDependencies(Environment *,struct snapshotData *,
+                                                              struct snapshotReader *,bool);
+   static struct partialMatch   **SnapshotMatchList(struct snapshotData *);
+
+/*********************************************************/
+/* SnapshotCommandDefinitions: Initializes the snapshot  */
+/*   commands.                                           */
+/*********************************************************/
+void SnapshotCommandDefinitions(
+  Environment *theEnv)
+  {
+#if ! RUN_TIME
+   AddUDF(theEnv,"save-snapshot","b",1,1,"sy",SaveSnapshotCommand,"SaveSnapshotCommand",NULL);
+   AddUDF(theEnv,"load-snapshot","b",1,1,"sy",LoadSnapshotCommand,"LoadSnapshotCommand",NULL);
+#else
+#if MAC_XCD
+#pragma unused(theEnv)
+#endif
+#endif
+  }
+
+/**********************************************/
+/* SaveSnapshotCommand: H/L access routine    */
+/*   for the save-snapshot command.           */
+/**********************************************/
+void SaveSnapshotCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *fileName;
+
+   fileName = GetFileName(context);
+   if ((fileName != NULL) && SaveSnapshot(theEnv,fileName))
+     { returnValue->lexemeValue = TrueSymbol(theEnv); }
+   else
+     { returnValue->lexemeValue = FalseSymbol(theEnv); }
+  }
+
+/**********************************************/
+/* LoadSnapshotCommand: H/L access routine    */
+/*   for the load-snapshot command.           */
+/**********************************************/
+void LoadSnapshotCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *fileName;
+
+   fileName = GetFileName(context);
+   if ((fileName != NULL) && LoadSnapshot(theEnv,fileName))
+     { returnValue->lexemeValue = TrueSymbol(theEnv); }
+   else
+     { returnValue->lexemeValue = FalseSymbol(theEnv); }
+  }
+
+/**************************************************************/
+/* SaveSnapshot: C access routine for the save-snapshot       */
+/*   command. The snapshot is written to a temporary file     */
+/*   which replaces the named file once it is complete, so    */
+/*   an interrupted save leaves the previous snapshot intact. */
+/**************************************************************/
+bool SaveSnapshot(
+  Environment *theEnv,
+  const char *fileName)
+  {
+   struct snapshotData theData;
+   struct snapshotWriter theWriter;
+   FILE *fp;
+   char *tempName;
+   size_t tempLength;
+   long long contentsPosition;
+   unsigned char withConstructs;
+   unsigned long placeHolder = 0;
+   bool rv;
+
+   /*=====================================*/
+   /* If embedded, clear the error flags. */
+   /*=====================================*/
+
+   if (EvaluationData(theEnv)->CurrentExpression == NULL)
+     { ResetErrorFlags(theEnv); }
+
+   if (! SnapshotAllowed(theEnv))
+     { return false; }
+
+#if OBJECT_SYSTEM
+   if (ObjectReteData(theEnv)->ObjectMatchActionQueue != NULL)
+     {
+      PrintErrorID(theEnv,"SNAPSHOT",2,false);
+      WriteString(theEnv,STDERR,"A snapshot cannot be saved while object pattern matching is delayed.\n");
+      return false;
+     }
+#endif
+
+   /*=================================================*/
+   /* The actions of constructs loaded in lazy mode   */
+   /* which have not been called yet must be parsed.  */
+   /*=================================================*/
+
+   if ((! Bloaded(theEnv)) && (! ParseLazyConstructs(theEnv)))
+     { return false; }
+
+   /*=================================================*/
+   /* Constructs are saved with the binary image, for */
+   /* which the atoms are marked and renumbered.      */
+   /*=================================================*/
+
+   if ((! Bloaded(theEnv)) && SharedAtomBaseError(theEnv,"save-snapshot"))
+     { return false; }
+
+   /*====================================================*/
+   /* Number the rules, joins, pattern nodes, entities,  */
+   /* partial matches, and activations to be saved.      */
+   /*====================================================*/
+
+   InitSnapshotData(&theData);
+   CollectSnapshotNetwork(theEnv,&theData);
+   CollectSnapshotEntities(theEnv,&theData);
+   CollectSnapshotMatches(theEnv,&theData);
+   CollectSnapshotActivations(theEnv,&theData);
+
+   /*==========================*/
+   /* Open the temporary file. */
+   /*==========================*/
+
+   tempLength = strlen(fileName) + 5;
+   tempName = (char *) genalloc(theEnv,tempLength);
+   gensnprintf(tempName,tempLength,"%s.tmp",fileName);
+
+   if ((fp = GenOpen(theEnv,tempName,"w+b")) == NULL)
+     {
+      OpenErrorMessage(theEnv,"save-snapshot",tempName);
+      genfree(theEnv,tempName,tempLength);
+      FreeSnapshotData(theEnv,&theData);
+      return false;
+     }
+
+   /*=====================================================*/
+   /* Write the header and, unless the constructs were    */
+   /* loaded with bload, the binary image of constructs.  */
+   /*=====================================================*/
+
+   GenWrite((void *) SNAPSHOT_PREFIX_ID,strlen(SNAPSHOT_PREFIX_ID) + 1,fp);
+   GenWrite((void *) BloadData(theEnv)->BinaryVersionID,strlen(BloadData(theEnv)->BinaryVersionID) + 1,fp);
+   GenWrite((void *) BloadData(theEnv)->BinarySizes,strlen(BloadData(theEnv)->BinarySizes) + 1,fp);
+
+   withConstructs = Bloaded(theEnv) ? 0 : 1;
+   GenWrite(&withConstructs,sizeof(unsigned char),fp);
+
+   /*==========================================================*/
+   /* The size of the contents which follow the header, the    */
+   /* size of the working memory at their end, and a checksum  */
+   /* of the contents are filled in once they are written, so  */
+   /* that a truncated or damaged snapshot is found before any */
+   /* of the current constructs or facts are replaced.         */
+   /*==========================================================*/
+
+   contentsPosition = GenTell(theEnv,fp);
+   GenWrite(&placeHolder,sizeof(unsigned long),fp);
+   GenWrite(&placeHolder,sizeof(unsigned long),fp);
+   GenWrite(&placeHolder,sizeof(unsigned long),fp);
+
+   if (withConstructs)
+     { BsaveOpenedBinary(theEnv,fp); }
+
+   /*===========================*/
+   /* Write the working memory. */
+   /*===========================*/
+
+   theWriter.fp = fp;
+   theWriter.size = 0;
+   theWriter.error = false;
+
+   rv = WriteSnapshotWorkingMemory(theEnv,&theData,&theWriter);
+
+   if (rv && (! theWriter.error))
+     {
+      GenSeek(theEnv,fp,(long) contentsPosition + (long) sizeof(unsigned long),SEEK_SET);
+      GenWrite(&theWriter.size,sizeof(unsigned long),fp);
+
+      if (! WriteSnapshotChecksum(theEnv,fp,contentsPosition))
+        { theWriter.error = true; }
+     }
+
+   if (GenClose(theEnv,fp) != 0)
+     { theWriter.error = true; }
+
+   /*=====================================================*/
+   /* Replace the snapshot file with the temporary file.  */
+   /*=====================================================*/
+
+   if (rv && theWriter.error)
+     {
+      PrintErrorID(theEnv,"SNAPSHOT",3,false);
+      WriteString(theEnv,STDERR,"Unable to write the snapshot file '");
+      WriteString(theEnv,STDERR,tempName);
+      WriteString(theEnv,STDERR,"'.\n");
+      rv = false;
+     }
+
+   if (rv)
+     {
+      genremove(theEnv,fileName);
+      if (! genrename(theEnv,tempName,fileName))
+        {
+         OpenErrorMessage(theEnv,"save-snapshot",fileName);
+         rv = false;
+        }
+     }
+
+   if (! rv)
+     { genremove(theEnv,tempName); }
+
+   genfree(theEnv,tempName,tempLength);
+   FreeSnapshotData(theEnv,&theData);
+
+   return rv;
+  }
+
+/***********************************************************/
+/* LoadSnapshot: C access routine for the load-snapshot    */
+/*   command. The current facts, instances, and agenda are */
+/*   replaced by those saved in the snapshot. If the file  */
+/*   contains constructs, they replace the current         */
+/*   constructs as with bload.                             */
+/***********************************************************/
+bool LoadSnapshot(
+  Environment *theEnv,
+  const char *fileName)
+  {
+   char idBuffer[20];
+   unsigned char withConstructs;
+   unsigned long contentsSize, wmSize, checksum;
+   long position, wmPosition = 0;
+   struct snapshotReader theReader;
+   char *buffer = NULL;
+   bool rv;
+
+   /*=====================================*/
+   /* If embedded, clear the error flags. */
+   /*=====================================*/
+
+   if (EvaluationData(theEnv)->CurrentExpression == NULL)
+     { ResetErrorFlags(theEnv); }
+
+   if (! SnapshotAllowed(theEnv))
+     { return false; }
+
+   if (GenOpenReadBinary(theEnv,"load-snapshot",fileName) == false)
+     {
+      OpenErrorMessage(theEnv,"load-snapshot",fileName);
+      return false;
+     }
+
+   /*=======================================*/
+   /* Determine if this is a snapshot file  */
+   /* written by a compatible version.      */
+   /*=======================================*/
+
+   memset(idBuffer,0,sizeof(idBuffer));
+   if ((GenReadBinary(theEnv,idBuffer,strlen(SNAPSHOT_PREFIX_ID) + 1) != strlen(SNAPSHOT_PREFIX_ID) + 1) ||
+       (strcmp(idBuffer,SNAPSHOT_PREFIX_ID) != 0))
+     {
+      GenCloseBinary(theEnv);
+      PrintErrorID(theEnv,"SNAPSHOT",4,false);
+      WriteString(theEnv,STDERR,"File '");
+      WriteString(theEnv,STDERR,fileName);
+      WriteString(theEnv,STDERR,"' is not a snapshot file.\n");
+      return false;
+     }
+
+   memset(idBuffer,0,sizeof(idBuffer));
+   GenReadBinary(theEnv,idBuffer,strlen(BloadData(theEnv)->BinaryVersionID) + 1);
+   rv = (strcmp(idBuffer,BloadData(theEnv)->BinaryVersionID) == 0);
+
+   memset(idBuffer,0,sizeof(idBuffer));
+   GenReadBinary(theEnv,idBuffer,strlen(BloadData(theEnv)->BinarySizes) + 1);
+   if (strcmp(idBuffer,BloadData(theEnv)->BinarySizes) != 0)
+     { rv = false; }
+
+   if (! rv)
+     {
+      GenCloseBinary(theEnv);
+      PrintErrorID(theEnv,"SNAPSHOT",4,false);
+      WriteString(theEnv,STDERR,"File '");
+      WriteString(theEnv,STDERR,fileName);
+      WriteString(theEnv,STDERR,"' is an incompatible snapshot file.\n");
+      return false;
+     }
+
+   /*==============================================*/
+   /* Verify that the contents of the snapshot are */
+   /* complete and undamaged before the current    */
+   /* constructs or working memory are replaced.   */
+   /*==============================================*/
+
+   rv = (GenReadBinary(theEnv,&withConstructs,sizeof(unsigned char)) == sizeof(unsigned char)) &&
+        (withConstructs <= 1) &&
+        (GenReadBinary(theEnv,&contentsSize,sizeof(unsigned long)) == sizeof(unsigned long)) &&
+        (GenReadBinary(theEnv,&wmSize,sizeof(unsigned long)) == sizeof(unsigned long)) &&
+        (GenReadBinary(theEnv,&checksum,sizeof(unsigned long)) == sizeof(unsigned long)) &&
+        (wmSize <= contentsSize);
+
+   if (rv)
+     {
+      GenTellBinary(theEnv,&position);
+      wmPosition = position + (long) (contentsSize - wmSize);
+      rv = CheckSnapshotContents(theEnv,contentsSize,checksum);
+     }
+
+   /*===================================================*/
+   /* Load the constructs saved with the image. They    */
+   /* must end where the working memory begins.         */
+   /*===================================================*/
+
+   if (rv && (withConstructs == 1))
+     {
+      if (BloadOpenedBinary(theEnv,fileName) == false)
+        {
+         GenCloseBinary(theEnv);
+         return false;
+        }
+
+      GenTellBinary(theEnv,&position);
+      rv = (position == wmPosition);
+     }
+
+   /*==========================*/
+   /* Read the working memory. */
+   /*==========================*/
+
+   if (rv)
+     {
+      GetSeekSetBinary(theEnv,wmPosition);
+      theReader.data = (const char *) GenReadBinaryInPlace(theEnv,wmSize,1);
+      if (theReader.data == NULL)
+        {
+         buffer = (char *) genalloc(theEnv,wmSize + 1);
+         if (GenReadBinary(theEnv,buffer,wmSize) == wmSize)
+           { theReader.data = buffer; }
+         else
+           { rv = false; }
+        }
+     }
+
+   if (! rv)
+     {
+      PrintErrorID(theEnv,"SNAPSHOT",5,false);
+      WriteString(theEnv,STDERR,"The snapshot file '");
+      WriteString(theEnv,STDERR,fileName);
+      WriteString(theEnv,STDERR,"' is damaged.\n");
+     }
+   else
+     {
+      theReader.size = wmSize;
+      theReader.position = 0;
+      theReader.error = false;
+      rv = RestoreSnapshotWorkingMemory(theEnv,fileName,&theReader);
+     }
+
+   if (buffer != NULL)
+     { genfree(theEnv,buffer,wmSize + 1); }
+
+   GenCloseBinary(theEnv);
+
+   /*=====================================================*/
+   /* The facts are replaced without the assert and       */
+   /* retract functions being called, so an open fact     */
+   /* journal is given a new base for the restored facts. */
+   /*=====================================================*/
+
+#if FACT_JOURNAL_FUNCTIONS
+   if (rv)
+     { CompactFactJournal(theEnv); }
+#endif
+
+   return rv;
+  }
+
+/**********************************************************/
+/* SnapshotAllowed: Snapshots can't be saved or loaded    */
+/*   while a rule is firing or a pattern is being matched */
+/*   since partial matches are then being created or      */
+/*   deleted.                                             */
+/**********************************************************/
+static bool SnapshotAllowed(
+  Environment *theEnv)
+  {
+   if ((EngineData(theEnv)->ExecutingRule == NULL) &&
+       (! EngineData(theEnv)->JoinOperationInProgress))
+     { return true; }
+
+   PrintErrorID(theEnv,"SNAPSHOT",1,false);
+   WriteString(theEnv,STDERR,"Snapshots cannot be saved or loaded while rules are executing.\n");
+   return false;
+  }
+
+/*###########################################################*/
+/* The numbering of rules, joins, entities, and matches.    */
+/*###########################################################*/
+
+/************************/
+/* InitSnapshotTable:   */
+/************************/
+static void InitSnapshotTable(
+  struct snapshotTable *theTable,
+  bool indexed)
+  {
+   theTable->items = NULL;
+   theTable->count = 0;
+   theTable->arraySize = 0;
+   theTable->index = NULL;
+   theTable->indexSize = 0;
+   theTable->indexed = indexed;
+  }
+
+/******************************************************/
+/* AddSnapshotItem: Adds an item to a table and       */
+/*   returns its number. The item must not already be */
+/*   in the table.                                    */
+/******************************************************/
+static unsigned long AddSnapshotItem(
+  Environment *theEnv,
+  struct snapshotTable *theTable,
+  void *theItem)
+  {
+   void **newItems;
+   unsigned long newSize, i;
+
+   if (theTable->count == theTable->arraySize)
+     {
+      newSize = (theTable->arraySize == 0) ? 64 : (theTable->arraySize * 2);
+      newItems = (void **) genalloc(theEnv,sizeof(void *) * newSize);
+      if (theTable->items != NULL)
+        {
+         memcpy(newItems,theTable->items,sizeof(void *) * theTable->count);
+         genfree(theEnv,theTable->items,sizeof(void *) * theTable->arraySize);
+        }
+      theTable->items = newItems;
+      theTable->arraySize = newSize;
+     }
+
+   theTable->items[theTable->count++] = theItem;
+
+   if (! theTable->indexed)
+     { return theTable->count; }
+
+   /*================================================*/
+   /* Keep the index at most half full, rebuilding   */
+   /* it with twice the number of buckets as needed. */
+   /*================================================*/
+
+   if ((theTable->count * 2) > theTable->indexSize)
+     {
+      if (theTable->index != NULL)
+        { genfree(theEnv,theTable->index,sizeof(unsigned long) * theTable->indexSize); }
+
+      theTable->indexSize = (theTable->indexSize == 0) ? 128 : (theTable->indexSize * 2);
+      theTable->index = (unsigned long *) genalloc(theEnv,sizeof(unsigned long) * theTable->indexSize);
+      memset(theTable->index,0,sizeof(unsigned long) * theTable->indexSize);
+
+      for (i = 1; i <= theTable->count; i++)
+        { IndexSnapshotItem(theTable,i); }
+     }
+   else
+     { IndexSnapshotItem(theTable,theTable->count); }
+
+   return theTable->count;
+  }
+
+/*************************************************/
+/* IndexSnapshotItem: Places the number of an    */
+/*   item in the first free bucket of the index. */
+/*************************************************/
+static void IndexSnapshotItem(
+  struct snapshotTable *theTable,
+  unsigned long itemNumber)
+  {
+   unsigned long bucket;
+
+   bucket = (unsigned long) ((((uintptr_t) theTable->items[itemNumber - 1]) >> 3) * 2654435761UL) &
+            (theTable->indexSize - 1);
+
+   while (theTable->index[bucket] != 0)
+     { bucket = (bucket + 1) & (theTable->indexSize - 1); }
+
+   theTable->index[bucket] = itemNumber;
+  }
+
+/***************************************************/
+/* FindSnapshotItem: Returns the number of an item */
+/*   in an indexed table or 0 if it isn't there.   */
+/***************************************************/
+static unsigned long FindSnapshotItem(
+  struct snapshotTable *theTable,
+  void *theItem)
+  {
+   unsigned long bucket;
+
+   if ((theItem == NULL) || (theTable->indexSize == 0))
+     { return 0; }
+
+   bucket = (unsigned long) ((((uintptr_t) theItem) >> 3) * 2654435761UL) &
+            (theTable->indexSize - 1);
+
+   while (theTable->index[bucket] != 0)
+     {
+      if (theTable->items[theTable->index[bucket] - 1] == theItem)
+        { return theTable->index[bucket]; }
+      bucket = (bucket + 1) & (theTable->indexSize - 1);
+     }
+
+   return 0;
+  }
+
+/*********************************************************/
+/* InternSnapshotItem: Returns the number of an item,    */
+/*   adding it to the table if it isn't already there.   */
+/*********************************************************/
+static unsigned long InternSnapshotItem(
+  Environment *theEnv,
+  struct snapshotTable *theTable,
+  void *theItem)
+  {
+   unsigned long itemNumber;
+
+   itemNumber = FindSnapshotItem(theTable,theItem);
+   if (itemNumber != 0)
+     { return itemNumber; }
+
+   return AddSnapshotItem(theEnv,theTable,theItem);
+  }
+
+/************************/
+/* FreeSnapshotTable:   */
+/************************/
+static void FreeSnapshotTable(
+  Environment *theEnv,
+  struct snapshotTable *theTable)
+  {
+   if (theTable->items != NULL)
+     { genfree(theEnv,theTable->items,sizeof(void *) * theTable->arraySize); }
+
+   if (theTable->index != NULL)
+     { genfree(theEnv,theTable->index,sizeof(unsigned long) * theTable->indexSize); }
+
+   InitSnapshotTable(theTable,theTable->indexed);
+  }
+
+/***********************/
+/* InitSnapshotData:   */
+/***********************/
+static void InitSnapshotData(
+  struct snapshotData *theData)
+  {
+   InitSnapshotTable(&theData->rules,false);
+   InitSnapshotTable(&theData->joins,true);
+   InitSnapshotTable(&theData->nodes,true);
+   InitSnapshotTable(&theData->templates,true);
+   InitSnapshotTable(&theData->classes,true);
+   InitSnapshotTable(&theData->entities,true);
+   InitSnapshotTable(&theData->matches,true);
+   InitSnapshotTable(&theData->alphaMatches,true);
+   InitSnapshotTable(&theData->activations,true);
+   theData->factCount = 0;
+   theData->alphaCount = 0;
+   theData->factsInstalled = false;
+  }
+
+/***********************/
+/* FreeSnapshotData:   */
+/***********************/
+static void FreeSnapshotData(
+  Environment *theEnv,
+  struct snapshotData *theData)
+  {
+   FreeSnapshotTable(theEnv,&theData->rules);
+   FreeSnapshotTable(theEnv,&theData->joins);
+   FreeSnapshotTable(theEnv,&theData->nodes);
+   FreeSnapshotTable(theEnv,&theData->templates);
+   FreeSnapshotTable(theEnv,&theData->classes);
+   FreeSnapshotTable(theEnv,&theData->entities);
+   FreeSnapshotTable(theEnv,&theData->matches);
+   FreeSnapshotTable(theEnv,&theData->alphaMatches);
+   FreeSnapshotTable(theEnv,&theData->activations);
+  }
+
+/***************************************************************/
+/* CollectSnapshotNetwork: Numbers the rules (and disjuncts)   */
+/*   of each module, and the joins and terminal pattern nodes  */
+/*   used by them. The joins of a rule are numbered after the  */
+/*   joins they are entered from.                              */
+/***************************************************************/
+static void CollectSnapshotNetwork(
+  Environment *theEnv,
+  struct snapshotData *theData)
+  {
+   Defmodule *theModule;
+   Defrule *theRule, *theDisjunct;
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+
+      for (theRule = GetNextDefrule(theEnv,NULL);
+           theRule != NULL;
+           theRule = GetNextDefrule(theEnv,theRule))
+        {
+         for (theDisjunct = theRule;
+              theDisjunct != NULL;
+              theDisjunct = theDisjunct->disjunct)
+           {
+            AddSnapshotItem(theEnv,&theData->rules,theDisjunct);
+            CollectSnapshotJoin(theEnv,theData,theDisjunct->lastJoin);
+           }
+        }
+     }
+
+   RestoreCurrentModule(theEnv);
+  }
+
+/************************/
+/* CollectSnapshotJoin: */
+/************************/
+static void CollectSnapshotJoin(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct joinNode *theJoin)
+  {
+   if (theJoin == NULL) return;
+
+   if (FindSnapshotItem(&theData->joins,theJoin) != 0)
+     { return; }
+
+   CollectSnapshotJoin(theEnv,theData,theJoin->lastLevel);
+
+   if (theJoin->joinFromTheRight)
+     { CollectSnapshotJoin(theEnv,theData,(struct joinNode *) theJoin->rightSideEntryStructure); }
+   else if (theJoin->rightSideEntryStructure != NULL)
+     { InternSnapshotItem(theEnv,&theData->nodes,theJoin->rightSideEntryStructure); }
+
+   AddSnapshotItem(theEnv,&theData->joins,theJoin);
+  }
+
+/***************************************************************/
+/* SnapshotMemoryKind: The left memory of the first join of a  */
+/*   rule and the right memory of a join without a pattern     */
+/*   (such as the join for a test CE) each hold one empty      */
+/*   partial match which is created with the join. These seed  */
+/*   partial matches are kept when working memory is cleared.  */
+/*   A join entered from a pattern uses the alpha memory of    */
+/*   the pattern, so its right memory (which bload creates     */
+/*   before the pattern is attached) is never used.            */
+/***************************************************************/
+static int SnapshotMemoryKind(
+  struct joinNode *theJoin,
+  int side)
+  {
+   if (side == LHS)
+     {
+      if (theJoin->leftMemory == NULL)
+        { return SNAPSHOT_NO_MEMORY; }
+      if (theJoin->firstJoin)
+        { return SNAPSHOT_SEED_MEMORY; }
+      return SNAPSHOT_MEMORY;
+     }
+
+   if (theJoin->rightMemory == NULL)
+     { return SNAPSHOT_NO_MEMORY; }
+   if (theJoin->joinFromTheRight)
+     { return SNAPSHOT_MEMORY; }
+   if (theJoin->rightSideEntryStructure == NULL)
+     { return SNAPSHOT_SEED_MEMORY; }
+   return SNAPSHOT_NO_MEMORY;
+  }
+
+/*******************/
+/* SnapshotMemory: */
+/*******************/
+static struct betaMemory *SnapshotMemory(
+  struct joinNode *theJoin,
+  int side)
+  {
+   if (side == LHS)
+     { return theJoin->leftMemory; }
+
+   return theJoin->rightMemory;
+  }
+
+/***********************************************************/
+/* SnapshotSeedCount: Returns the number of seed partial   */
+/*   matches in a memory. The count of the memory isn't    */
+/*   used since bload doesn't include the seed in it.      */
+/***********************************************************/
+static unsigned long SnapshotSeedCount(
+  struct betaMemory *theMemory)
+  {
+   unsigned long b, count = 0;
+   struct partialMatch *theMatch;
+
+   for (b = 0; b < theMemory->size; b++)
+     {
+      for (theMatch = theMemory->beta[b];
+           theMatch != NULL;
+           theMatch = theMatch->nextInMemory)
+        { count++; }
+     }
+
+   return count;
+  }
+
+/*************************************************************/
+/* SnapshotJoinFlags: Summarizes the structure of a join for */
+/*   the network fingerprint.                                */
+/*************************************************************/
+static unsigned char SnapshotJoinFlags(
+  struct joinNode *theJoin)
+  {
+   unsigned char flags = 0;
+
+   if (theJoin->firstJoin) flags |= 0x01;
+   if (theJoin->joinFromTheRight) flags |= 0x02;
+   if (theJoin->patternIsNegated) flags |= 0x04;
+   if (theJoin->patternIsExists) flags |= 0x08;
+   if (theJoin->logicalJoin) flags |= 0x10;
+   if (SnapshotMemoryKind(theJoin,LHS) != SNAPSHOT_NO_MEMORY) flags |= 0x20;
+   if (SnapshotMemoryKind(theJoin,RHS) != SNAPSHOT_NO_MEMORY) flags |= 0x40;
+   if (theJoin->ruleToActivate != NULL) flags |= 0x80;
+
+   return flags;
+  }
+
+/************************************************************/
+/* CollectSnapshotEntities: Numbers the facts, followed by  */
+/*   the instances, along with their deftemplates and       */
+/*   defclasses.                                            */
+/************************************************************/
+static void CollectSnapshotEntities(
+  Environment *theEnv,
+  struct snapshotData *theData)
+  {
+   Fact *theFact;
+#if OBJECT_SYSTEM
+   Instance *theInstance;
+#endif
+
+   for (theFact = FactData(theEnv)->FactList;
+        theFact != NULL;
+        theFact = theFact->nextFact)
+     {
+      AddSnapshotItem(theEnv,&theData->entities,theFact);
+      InternSnapshotItem(theEnv,&theData->templates,theFact->whichDeftemplate);
+     }
+
+   theData->factCount = theData->entities.count;
+
+#if OBJECT_SYSTEM
+   for (theInstance = InstanceData(theEnv)->InstanceList;
+        theInstance != NULL;
+        theInstance = theInstance->nxtList)
+     {
+      if (theInstance->garbage) continue;
+      AddSnapshotItem(theEnv,&theData->entities,theInstance);
+      InternSnapshotItem(theEnv,&theData->classes,theInstance->cls);
+     }
+#endif
+  }
+
+/*************************************************************/
+/* CollectSnapshotMatches: Numbers the partial matches. The  */
+/*   alpha memories of the pattern nodes come first, so the  */
+/*   alpha matches referenced by the beta partial matches    */
+/*   can be numbered the same way.                           */
+/*************************************************************/
+static void CollectSnapshotMatches(
+  Environment *theEnv,
+  struct snapshotData *theData)
+  {
+   unsigned long i, b;
+   int side;
+   struct patternNodeHeader *theHeader;
+   struct alphaMemoryHash *theAlphaMemory;
+   struct partialMatch *theMatch;
+   struct betaMemory *theMemory;
+
+   for (i = 0; i < theData->nodes.count; i++)
+     {
+      theHeader = (struct patternNodeHeader *) theData->nodes.items[i];
+
+      for (theAlphaMemory = theHeader->firstHash;
+           theAlphaMemory != NULL;
+           theAlphaMemory = theAlphaMemory->nextHash)
+        {
+         for (theMatch = theAlphaMemory->alphaMemory;
+              theMatch != NULL;
+              theMatch = theMatch->nextInMemory)
+           {
+            AddSnapshotItem(theEnv,&theData->matches,theMatch);
+            AddSnapshotItem(theEnv,&theData->alphaMatches,theMatch->binds[0].gm.theMatch);
+           }
+        }
+     }
+
+   theData->alphaCount = theData->matches.count;
+
+   for (i = 0; i < theData->joins.count; i++)
+     {
+      for (side = LHS; side <= RHS; side++)
+        {
+         if (SnapshotMemoryKind((struct joinNode *) theData->joins.items[i],side) == SNAPSHOT_NO_MEMORY)
+           { continue; }
+         theMemory = SnapshotMemory((struct joinNode *) theData->joins.items[i],side);
+
+         for (b = 0; b < theMemory->size; b++)
+           {
+            for (theMatch = theMemory->beta[b];
+                 theMatch != NULL;
+                 theMatch = theMatch->nextInMemory)
+              { AddSnapshotItem(theEnv,&theData->matches,theMatch); }
+           }
+        }
+     }
+  }
+
+/****************************************************************/
+/* CollectSnapshotActivations: Numbers the activations of each  */
+/*   module in agenda order.                                    */
+/****************************************************************/
+static void CollectSnapshotActivations(
+  Environment *theEnv,
+  struct snapshotData *theData)
+  {
+   Defmodule *theModule;
+   Activation *theActivation;
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      for (theActivation = GetDefruleModuleItem(theEnv,theModule)->agenda;
+           theActivation != NULL;
+           theActivation = theActivation->next)
+        { AddSnapshotItem(theEnv,&theData->activations,theActivation); }
+     }
+  }
+
+/*###########################################################*/
+/* Saving the working memory.                               */
+/*###########################################################*/
+
+/********************************************************/
+/* SnapshotChecksum: Adds data to an FNV-1a checksum of */
+/*   the contents of a snapshot.                        */
+/********************************************************/
+static unsigned long SnapshotChecksum(
+  unsigned long checksum,
+  const void *theData,
+  size_t size)
+  {
+   const unsigned char *theBytes = (const unsigned char *) theData;
+   size_t i;
+
+   for (i = 0; i < size; i++)
+     {
+      checksum ^= theBytes[i];
+      checksum = (checksum * 16777619UL) & 0xFFFFFFFFUL;
+     }
+
+   return checksum;
+  }
+
+/************************************************************/
+/* WriteSnapshotChecksum: Reads back the contents written   */
+/*   after the size fields at the specified position of a   */
+/*   snapshot file and fills in their size and checksum.    */
+/************************************************************/
+static bool WriteSnapshotChecksum(
+  Environment *theEnv,
+  FILE *fp,
+  long long contentsPosition)
+  {
+   unsigned char theBuffer[SNAPSHOT_CHECK_BUFFER_SIZE];
+   unsigned long contentsSize = 0;
+   unsigned long checksum = SNAPSHOT_CHECKSUM_SEED;
+   size_t count;
+
+   if (GenSeek(theEnv,fp,(long) contentsPosition + (long) (sizeof(unsigned long) * 3),SEEK_SET) != 0)
+     { return false; }
+
+   while ((count = fread(theBuffer,1,SNAPSHOT_CHECK_BUFFER_SIZE,fp)) > 0)
+     {
+      checksum = SnapshotChecksum(checksum,theBuffer,count);
+      contentsSize += (unsigned long) count;
+     }
+
+   if (ferror(fp) ||
+       (GenSeek(theEnv,fp,(long) contentsPosition,SEEK_SET) != 0))
+     { return false; }
+
+   if (GenWrite(&contentsSize,sizeof(unsigned long),fp) != sizeof(unsigned long))
+     { return false; }
+
+   GenSeek(theEnv,fp,(long) contentsPosition + (long) (sizeof(unsigned long) * 2),SEEK_SET);
+
+   if (GenWrite(&checksum,sizeof(unsigned long),fp) != sizeof(unsigned long))
+     { return false; }
+
+   return true;
+  }
+
+/************************************************************/
+/* CheckSnapshotContents: Reads the contents of a snapshot  */
+/*   from the current position of the binary file and       */
+/*   returns true if they have the expected size and        */
+/*   checksum. The position is then restored.               */
+/************************************************************/
+static bool CheckSnapshotContents(
+  Environment *theEnv,
+  unsigned long contentsSize,
+  unsigned long checksum)
+  {
+   unsigned char theBuffer[SNAPSHOT_CHECK_BUFFER_SIZE];
+   unsigned long computed = SNAPSHOT_CHECKSUM_SEED;
+   unsigned long remaining = contentsSize;
+   size_t count;
+   long position;
+   bool rv = true;
+
+   GenTellBinary(theEnv,&position);
+
+   while (rv && (remaining > 0))
+     {
+      count = (remaining < SNAPSHOT_CHECK_BUFFER_SIZE) ? (size_t) remaining : SNAPSHOT_CHECK_BUFFER_SIZE;
+
+      if (GenReadBinary(theEnv,theBuffer,count) != count)
+        { rv = false; }
+      else
+        {
+         computed = SnapshotChecksum(computed,theBuffer,count);
+         remaining -= (unsigned long) count;
+        }
+     }
+
+   GetSeekSetBinary(theEnv,position);
+
+   return rv && (computed == checksum);
+  }
+
+/**********************************************************/
+/* WriteSnapshotBytes: Writes data to the working memory  */
+/*   section of the snapshot, updating its size.          */
+/**********************************************************/
+static void WriteSnapshotBytes(
+  struct snapshotWriter *theWriter,
+  const void *theData,
+  size_t size)
+  {
+   if (GenWrite((void *) theData,size,theWriter->fp) != size)
+     { theWriter->error = true; }
+
+   theWriter->size += (unsigned long) size;
+  }
+
+/************************************************************/
+/* WriteSnapshotString: Writes the length of a string and   */
+/*   its characters including the terminating null so that  */
+/*   the string can be used in place when it is read.       */
+/************************************************************/
+static void WriteSnapshotString(
+  struct snapshotWriter *theWriter,
+  const char *theString)
+  {
+   unsigned long length;
+
+   length = (unsigned long) strlen(theString);
+   WriteSnapshotBytes(theWriter,&length,sizeof(unsigned long));
+   WriteSnapshotBytes(theWriter,theString,length + 1);
+  }
+
+/*************************************************************/
+/* WriteSnapshotValue: Writes the type of a value followed   */
+/*   by its contents. Fact and instance addresses are saved  */
+/*   as entity numbers (0 for an entity which no longer      */
+/*   exists). External addresses cannot be saved.            */
+/*************************************************************/
+static bool WriteSnapshotValue(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter,
+  unsigned short theType,
+  void *theValue)
+  {
+   Multifield *theSegment;
+   unsigned long i, entityID;
+
+   WriteSnapshotBytes(theWriter,&theType,sizeof(unsigned short));
+
+   switch (theType)
+     {
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+        WriteSnapshotString(theWriter,((CLIPSLexeme *) theValue)->contents);
+        return true;
+
+      case INTEGER_TYPE:
+        WriteSnapshotBytes(theWriter,&((CLIPSInteger *) theValue)->contents,sizeof(long long));
+        return true;
+
+      case FLOAT_TYPE:
+        WriteSnapshotBytes(theWriter,&((CLIPSFloat *) theValue)->contents,sizeof(double));
+        return true;
+
+      case FACT_ADDRESS_TYPE:
+#if OBJECT_SYSTEM
+      case INSTANCE_ADDRESS_TYPE:
+#endif
+        entityID = FindSnapshotItem(&theData->entities,theValue);
+        WriteSnapshotBytes(theWriter,&entityID,sizeof(unsigned long));
+        return true;
+
+      case VOID_TYPE:
+        return true;
+
+      case MULTIFIELD_TYPE:
+        theSegment = (Multifield *) theValue;
+        i = (unsigned long) theSegment->length;
+        WriteSnapshotBytes(theWriter,&i,sizeof(unsigned long));
+        for (i = 0; i < theSegment->length; i++)
+          {
+           if ((theSegment->contents[i].header->type == MULTIFIELD_TYPE) ||
+               (! WriteSnapshotValue(theEnv,theData,theWriter,
+                                     theSegment->contents[i].header->type,
+                                     theSegment->contents[i].value)))
+             { return false; }
+          }
+        return true;
+     }
+
+   PrintErrorID(theEnv,"SNAPSHOT",6,false);
+   WriteString(theEnv,STDERR,"External addresses cannot be saved in a snapshot.\n");
+   return false;
+  }
+
+/*******************************************************/
+/* WriteSnapshotWorkingMemory: Writes the sections of  */
+/*   the working memory in the order they are read.    */
+/*******************************************************/
+static bool WriteSnapshotWorkingMemory(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter)
+  {
+   unsigned long i, theID;
+   Activation *theActivation;
+   FocalModule *theFocus;
+
+   WriteSnapshotFingerprint(theData,theWriter);
+
+   WriteSnapshotBytes(theWriter,&FactData(theEnv)->NextFactIndex,sizeof(long long));
+   WriteSnapshotBytes(theWriter,&DefruleData(theEnv)->CurrentEntityTimeTag,sizeof(unsigned long long));
+   WriteSnapshotBytes(theWriter,&AgendaData(theEnv)->CurrentTimetag,sizeof(unsigned long long));
+
+   if (! WriteSnapshotEntities(theEnv,theData,theWriter))
+     { return false; }
+
+   if (! WriteSnapshotAlphaMatches(theEnv,theData,theWriter))
+     { return false; }
+
+   if (! WriteSnapshotBetaMatches(theEnv,theData,theWriter))
+     { return false; }
+
+   /*=======================*/
+   /* Save the activations. */
+   /*=======================*/
+
+   WriteSnapshotBytes(theWriter,&theData->activations.count,sizeof(unsigned long));
+   for (i = 0; i < theData->activations.count; i++)
+     {
+      theActivation = (Activation *) theData->activations.items[i];
+
+      for (theID = 0; theID < theData->rules.count; theID++)
+        { if (theData->rules.items[theID] == theActivation->theRule) break; }
+      theID = (theID < theData->rules.count) ? (theID + 1) : 0;
+      WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+
+      theID = FindSnapshotItem(&theData->matches,theActivation->basis);
+      if (theID <= theData->alphaCount)
+        { theID = 0; }
+      WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+
+      WriteSnapshotBytes(theWriter,&theActivation->salience,sizeof(int));
+      WriteSnapshotBytes(theWriter,&theActivation->timetag,sizeof(unsigned long long));
+      WriteSnapshotBytes(theWriter,&theActivation->randomID,sizeof(int));
+     }
+
+   if (! WriteSnapshotLinks(theEnv,theData,theWriter))
+     { return false; }
+
+   if (! WriteSnapshotEntityLinks(theEnv,theData,theWriter))
+     { return false; }
+
+   /*==========================================*/
+   /* Save the focus stack from top to bottom  */
+   /* and the current module.                  */
+   /*==========================================*/
+
+   for (i = 0, theFocus = EngineData(theEnv)->CurrentFocus;
+        theFocus != NULL;
+        theFocus = theFocus->next)
+     { i++; }
+
+   WriteSnapshotBytes(theWriter,&i,sizeof(unsigned long));
+   for (theFocus = EngineData(theEnv)->CurrentFocus;
+        theFocus != NULL;
+        theFocus = theFocus->next)
+     { WriteSnapshotString(theWriter,theFocus->theModule->header.name->contents); }
+
+   WriteSnapshotString(theWriter,GetCurrentModule(theEnv)->header.name->contents);
+
+   return WriteSnapshotGlobals(theEnv,theData,theWriter);
+  }
+
+/**************************************************************/
+/* WriteSnapshotFingerprint: Writes the names of the rules    */
+/*   and the structure of the joins so that a snapshot is     */
+/*   only restored into the rule network it was saved from.   */
+/**************************************************************/
+static void WriteSnapshotFingerprint(
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter)
+  {
+   unsigned long i;
+   Defrule *theRule;
+   struct joinNode *theJoin;
+   unsigned char flags;
+   unsigned short depth;
+
+   WriteSnapshotBytes(theWriter,&theData->rules.count,sizeof(unsigned long));
+   for (i = 0; i < theData->rules.count; i++)
+     {
+      theRule = (Defrule *) theData->rules.items[i];
+      WriteSnapshotString(theWriter,theRule->header.whichModule->theModule->header.name->contents);
+      WriteSnapshotString(theWriter,theRule->header.name->contents);
+     }
+
+   WriteSnapshotBytes(theWriter,&theData->joins.count,sizeof(unsigned long));
+   for (i = 0; i < theData->joins.count; i++)
+     {
+      theJoin = (struct joinNode *) theData->joins.items[i];
+      flags = SnapshotJoinFlags(theJoin);
+      depth = (unsigned short) theJoin->depth;
+      WriteSnapshotBytes(theWriter,&flags,sizeof(unsigned char));
+      WriteSnapshotBytes(theWriter,&depth,sizeof(unsigned short));
+     }
+
+   WriteSnapshotBytes(theWriter,&theData->nodes.count,sizeof(unsigned long));
+  }
+
+/***********************************************************/
+/* WriteSnapshotEntities: Writes the deftemplates and      */
+/*   defclasses used, then the facts and instances without */
+/*   their values, then their values (which may refer to   */
+/*   any other fact or instance).                          */
+/***********************************************************/
+static bool WriteSnapshotEntities(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter)
+  {
+   unsigned long i, theID, length;
+   size_t j;
+   Deftemplate *theDeftemplate;
+   Fact *theFact;
+   unsigned char implied;
+#if OBJECT_SYSTEM
+   Defclass *theDefclass;
+   Instance *theInstance;
+   unsigned short slotCount, k;
+   unsigned char initSlotsCalled;
+#endif
+
+   WriteSnapshotBytes(theWriter,&theData->templates.count,sizeof(unsigned long));
+   for (i = 0; i < theData->templates.count; i++)
+     {
+      theDeftemplate = (Deftemplate *) theData->templates.items[i];
+      WriteSnapshotString(theWriter,theDeftemplate->header.whichModule->theModule->header.name->contents);
+      WriteSnapshotString(theWriter,theDeftemplate->header.name->contents);
+      implied = theDeftemplate->implied;
+      WriteSnapshotBytes(theWriter,&implied,sizeof(unsigned char));
+     }
+
+   WriteSnapshotBytes(theWriter,&theData->classes.count,sizeof(unsigned long));
+#if OBJECT_SYSTEM
+   for (i = 0; i < theData->classes.count; i++)
+     {
+      theDefclass = (Defclass *) theData->classes.items[i];
+      WriteSnapshotString(theWriter,theDefclass->header.whichModule->theModule->header.name->contents);
+      WriteSnapshotString(theWriter,theDefclass->header.name->contents);
+     }
+#endif
+
+   /*=======================*/
+   /* Save the fact shells. */
+   /*=======================*/
+
+   WriteSnapshotBytes(theWriter,&theData->factCount,sizeof(unsigned long));
+   for (i = 0; i < theData->factCount; i++)
+     {
+      theFact = (Fact *) theData->entities.items[i];
+      theID = FindSnapshotItem(&theData->templates,theFact->whichDeftemplate);
+      length = (unsigned long) theFact->theProposition.length;
+      WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+      WriteSnapshotBytes(theWriter,&theFact->factIndex,sizeof(long long));
+      WriteSnapshotBytes(theWriter,&theFact->patternHeader.timeTag,sizeof(unsigned long long));
+      WriteSnapshotBytes(theWriter,&length,sizeof(unsigned long));
+     }
+
+   /*===========================*/
+   /* Save the instance shells. */
+   /*===========================*/
+
+   length = theData->entities.count - theData->factCount;
+   WriteSnapshotBytes(theWriter,&length,sizeof(unsigned long));
+#if OBJECT_SYSTEM
+   for (i = theData->factCount; i < theData->entities.count; i++)
+     {
+      theInstance = (Instance *) theData->entities.items[i];
+      theID = FindSnapshotItem(&theData->classes,theInstance->cls);
+      initSlotsCalled = theInstance->initSlotsCalled;
+      slotCount = theInstance->cls->instanceSlotCount;
+      WriteSnapshotString(theWriter,theInstance->name->contents);
+      WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+      WriteSnapshotBytes(theWriter,&theInstance->patternHeader.timeTag,sizeof(unsigned long long));
+      WriteSnapshotBytes(theWriter,&initSlotsCalled,sizeof(unsigned char));
+      WriteSnapshotBytes(theWriter,&slotCount,sizeof(unsigned short));
+     }
+#endif
+
+   /*========================================*/
+   /* Save the slot values of the facts and  */
+   /* instances.                             */
+   /*========================================*/
+
+   for (i = 0; i < theData->factCount; i++)
+     {
+      theFact = (Fact *) theData->entities.items[i];
+      for (j = 0; j < theFact->theProposition.length; j++)
+        {
+         if (! WriteSnapshotValue(theEnv,theData,theWriter,
+                                  theFact->theProposition.contents[j].header->type,
+                                  theFact->theProposition.contents[j].value))
+           { return false; }
+        }
+     }
+
+#if OBJECT_SYSTEM
+   for (i = theData->factCount; i < theData->entities.count; i++)
+     {
+      theInstance = (Instance *) theData->entities.items[i];
+      for (k = 0; k < theInstance->cls->instanceSlotCount; k++)
+        {
+         WriteSnapshotString(theWriter,theInstance->slotAddresses[k]->desc->slotName->name->contents);
+         if (! WriteSnapshotValue(theEnv,theData,theWriter,
+                                  theInstance->slotAddresses[k]->type,
+                                  theInstance->slotAddresses[k]->value))
+           { return false; }
+        }
+     }
+#endif
+
+   return true;
+  }
+
+/*************************************************************/
+/* SnapshotAlphaHash: Computes the hash value of an alpha    */
+/*   match from the entity it matches, as the pattern        */
+/*   network does when the entity is asserted.               */
+/*************************************************************/
+static unsigned long SnapshotAlphaHash(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct partialMatch *theMatch,
+  struct patternNodeHeader *theHeader,
+  unsigned long entityID)
+  {
+   unsigned long hashValue;
+   Fact *oldFact;
+   struct multifieldMarker *oldMarks;
+#if OBJECT_SYSTEM
+   Instance *oldInstance;
+#endif
+
+   if (theHeader->rightHash == NULL)
+     { return 0; }
+
+   if (entityID <= theData->factCount)
+     {
+      oldFact = FactData(theEnv)->CurrentPatternFact;
+      oldMarks = FactData(theEnv)->CurrentPatternMarks;
+      FactData(theEnv)->CurrentPatternFact = (Fact *) theData->entities.items[entityID - 1];
+      FactData(theEnv)->CurrentPatternMarks = theMatch->binds[0].gm.theMatch->markers;
+      hashValue = ComputeRightHashValue(theEnv,theHeader);
+      FactData(theEnv)->CurrentPatternFact = oldFact;
+      FactData(theEnv)->CurrentPatternMarks = oldMarks;
+      return hashValue;
+     }
+
+#if OBJECT_SYSTEM
+   oldInstance = ObjectReteData(theEnv)->CurrentPatternObject;
+   oldMarks = ObjectReteData(theEnv)->CurrentPatternObjectMarks;
+   ObjectReteData(theEnv)->CurrentPatternObject = (Instance *) theData->entities.items[entityID - 1];
+   ObjectReteData(theEnv)->CurrentPatternObjectMarks = theMatch->binds[0].gm.theMatch->markers;
+   hashValue = ComputeRightHashValue(theEnv,theHeader);
+   ObjectReteData(theEnv)->CurrentPatternObject = oldInstance;
+   ObjectReteData(theEnv)->CurrentPatternObjectMarks = oldMarks;
+   return hashValue;
+#else
+   return 0;
+#endif
+  }
+
+/****************************************************************/
+/* WriteSnapshotAlphaMatches: Writes the alpha memory of each   */
+/*   pattern node. Hash values which can be computed again from */
+/*   the entity are flagged to be recomputed when restored, so  */
+/*   values hashed by address (such as a fact address stored in */
+/*   a slot) are placed in the right alpha memory.              */
+/****************************************************************/
+static bool WriteSnapshotAlphaMatches(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter)
+  {
+   unsigned long i, count, entityID, position;
+   struct patternNodeHeader *theHeader;
+   struct alphaMemoryHash *theAlphaMemory;
+   struct partialMatch *theMatch;
+   struct multifieldMarker *theMarker;
+   unsigned char flags;
+   unsigned short markerCount;
+
+   position = 0;
+
+   for (i = 0; i < theData->nodes.count; i++)
+     {
+      theHeader = (struct patternNodeHeader *) theData->nodes.items[i];
+
+      for (count = 0, theAlphaMemory = theHeader->firstHash;
+           theAlphaMemory != NULL;
+           theAlphaMemory = theAlphaMemory->nextHash)
+        {
+         for (theMatch = theAlphaMemory->alphaMemory;
+              theMatch != NULL;
+              theMatch = theMatch->nextInMemory)
+           { count++; }
+        }
+
+      WriteSnapshotBytes(theWriter,&count,sizeof(unsigned long));
+
+      for (; count > 0; count--)
+        {
+         theMatch = (struct partialMatch *) theData->matches.items[position++];
+
+         entityID = FindSnapshotItem(&theData->entities,theMatch->binds[0].gm.theMatch->matchingItem);
+         if (entityID == 0)
+           {
+            PrintErrorID(theEnv,"SNAPSHOT",7,false);
+            WriteString(theEnv,STDERR,"A partial match refers to an entity which is not in working memory.\n");
+            return false;
+           }
+
+         flags = 0;
+         if ((theHeader->rightHash != NULL) &&
+             (SnapshotAlphaHash(theEnv,theData,theMatch,theHeader,entityID) == theMatch->hashValue))
+           { flags |= SNAPSHOT_RECOMPUTE_HASH; }
+
+         for (markerCount = 0, theMarker = theMatch->binds[0].gm.theMatch->markers;
+              theMarker != NULL;
+              theMarker = theMarker->next)
+           { markerCount++; }
+
+         WriteSnapshotBytes(theWriter,&entityID,sizeof(unsigned long));
+         WriteSnapshotBytes(theWriter,&flags,sizeof(unsigned char));
+         WriteSnapshotBytes(theWriter,&theMatch->hashValue,sizeof(unsigned long));
+         WriteSnapshotBytes(theWriter,&markerCount,sizeof(unsigned short));
+
+         for (theMarker = theMatch->binds[0].gm.theMatch->markers;
+              theMarker != NULL;
+              theMarker = theMarker->next)
+           {
+            WriteSnapshotBytes(theWriter,&theMarker->whichField,sizeof(unsigned short));
+            if (entityID <= theData->factCount)
+              { WriteSnapshotBytes(theWriter,&theMarker->where.whichSlotNumber,sizeof(unsigned short)); }
+            else
+              { WriteSnapshotString(theWriter,((CLIPSLexeme *) theMarker->where.whichSlot)->contents); }
+            WriteSnapshotBytes(theWriter,&theMarker->startPosition,sizeof(size_t));
+            WriteSnapshotBytes(theWriter,&theMarker->range,sizeof(size_t));
+           }
+        }
+     }
+
+   return true;
+  }
+
+/****************************************************************/
+/* WriteSnapshotBetaMatches: Writes the left and right beta     */
+/*   memories of each join. For the memories holding a seed     */
+/*   partial match, only the number of partial matches is       */
+/*   written since the seed partial matches aren't recreated.   */
+/****************************************************************/
+static bool WriteSnapshotBetaMatches(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter)
+  {
+   unsigned long i, b, theID;
+   unsigned short j;
+   int side;
+   unsigned char kind, flags;
+   struct joinNode *theJoin;
+   struct betaMemory *theMemory;
+   struct partialMatch *theMatch;
+   struct expr *hashExpr;
+
+   for (i = 0; i < theData->joins.count; i++)
+     {
+      theJoin = (struct joinNode *) theData->joins.items[i];
+
+      for (side = LHS; side <= RHS; side++)
+        {
+         kind = (unsigned char) SnapshotMemoryKind(theJoin,side);
+         WriteSnapshotBytes(theWriter,&kind,sizeof(unsigned char));
+         if (kind == SNAPSHOT_NO_MEMORY) continue;
+
+         theMemory = SnapshotMemory(theJoin,side);
+         if (kind == SNAPSHOT_SEED_MEMORY)
+           {
+            theID = SnapshotSeedCount(theMemory);
+            WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+            continue;
+           }
+
+         hashExpr = (side == LHS) ? theJoin->leftHash : theJoin->rightHash;
+
+         WriteSnapshotBytes(theWriter,&theMemory->size,sizeof(unsigned long));
+         WriteSnapshotBytes(theWriter,&theMemory->count,sizeof(unsigned long));
+
+         for (b = 0; b < theMemory->size; b++)
+           {
+            for (theMatch = theMemory->beta[b];
+                 theMatch != NULL;
+                 theMatch = theMatch->nextInMemory)
+              {
+               flags = 0;
+               if ((hashExpr != NULL) &&
+                   ((theMatch->bcount > 1) || (theMatch->binds[0].gm.theMatch != NULL)) &&
+                   (BetaMemoryHashValue(theEnv,hashExpr,theMatch,NULL,theJoin) == theMatch->hashValue))
+                 { flags |= SNAPSHOT_RECOMPUTE_HASH; }
+
+               WriteSnapshotBytes(theWriter,&theMatch->bcount,sizeof(unsigned short));
+               WriteSnapshotBytes(theWriter,&flags,sizeof(unsigned char));
+               WriteSnapshotBytes(theWriter,&theMatch->hashValue,sizeof(unsigned long));
+
+               for (j = 0; j < theMatch->bcount; j++)
+                 {
+                  if (theMatch->binds[j].gm.theMatch == NULL)
+                    { theID = 0; }
+                  else
+                    {
+                     theID = FindSnapshotItem(&theData->alphaMatches,theMatch->binds[j].gm.theMatch);
+                     if (theID == 0)
+                       {
+                        PrintErrorID(theEnv,"SNAPSHOT",7,false);
+                        WriteString(theEnv,STDERR,"A partial match refers to an alpha match which is not in an alpha memory.\n");
+                        return false;
+                       }
+                    }
+                  WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+                 }
+              }
+           }
+        }
+     }
+
+   return true;
+  }
+
+/*************************************************************/
+/* WriteSnapshotLinks: Writes the links of each partial      */
+/*   match to the other partial matches, to its activation,  */
+/*   and to the entities it logically supports.              */
+/*************************************************************/
+static bool WriteSnapshotLinks(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter)
+  {
+   unsigned long i, j, theID, count;
+   struct partialMatch *theMatch;
+   struct partialMatch *theLinks[SNAPSHOT_LINK_COUNT];
+   struct dependency *theDependency;
+   unsigned char tag;
+
+   WriteSnapshotBytes(theWriter,&theData->matches.count,sizeof(unsigned long));
+
+   for (i = 0; i < theData->matches.count; i++)
+     {
+      theMatch = (struct partialMatch *) theData->matches.items[i];
+
+      /*=====================================================*/
+      /* The marker is either the activation of the partial  */
+      /* match or the partial match blocking it.             */
+      /*=====================================================*/
+
+      if (theMatch->marker == NULL)
+        {
+         tag = SNAPSHOT_NO_MARKER;
+         theID = 0;
+        }
+      else if ((theID = FindSnapshotItem(&theData->activations,theMatch->marker)) != 0)
+        { tag = SNAPSHOT_ACTIVATION_MARKER; }
+      else if ((theID = FindSnapshotItem(&theData->matches,theMatch->marker)) != 0)
+        { tag = SNAPSHOT_MATCH_MARKER; }
+      else
+        {
+         PrintErrorID(theEnv,"SNAPSHOT",7,false);
+         WriteString(theEnv,STDERR,"A partial match is blocked by a partial match which is not in a memory.\n");
+         return false;
+        }
+
+      WriteSnapshotBytes(theWriter,&tag,sizeof(unsigned char));
+      WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+
+      theLinks[0] = theMatch->children;
+      theLinks[1] = theMatch->rightParent;
+      theLinks[2] = theMatch->nextRightChild;
+      theLinks[3] = theMatch->prevRightChild;
+      theLinks[4] = theMatch->leftParent;
+      theLinks[5] = theMatch->nextLeftChild;
+      theLinks[6] = theMatch->prevLeftChild;
+      theLinks[7] = theMatch->blockList;
+      theLinks[8] = theMatch->nextBlocked;
+      theLinks[9] = theMatch->prevBlocked;
+
+      for (j = 0; j < SNAPSHOT_LINK_COUNT; j++)
+        {
+         theID = FindSnapshotItem(&theData->matches,theLinks[j]);
+         if ((theID == 0) && (theLinks[j] != NULL))
+           {
+            PrintErrorID(theEnv,"SNAPSHOT",7,false);
+            WriteString(theEnv,STDERR,"A partial match is linked to a partial match which is not in a memory.\n");
+            return false;
+           }
+         WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+        }
+
+      for (count = 0, theDependency = (struct dependency *) theMatch->dependents;
+           theDependency != NULL;
+           theDependency = theDependency->next)
+        { count++; }
+
+      WriteSnapshotBytes(theWriter,&count,sizeof(unsigned long));
+      for (theDependency = (struct dependency *) theMatch->dependents;
+           theDependency != NULL;
+           theDependency = theDependency->next)
+        {
+         theID = FindSnapshotItem(&theData->entities,theDependency->dPtr);
+         WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+        }
+     }
+
+   return true;
+  }
+
+/************************************************************/
+/* WriteSnapshotEntityLinks: Writes the alpha matches of    */
+/*   each fact and instance and the partial matches which   */
+/*   logically support it.                                  */
+/************************************************************/
+static bool WriteSnapshotEntityLinks(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter)
+  {
+   unsigned long i, theID, count;
+   struct patternEntity *theEntity;
+   struct patternMatch *theList, *thePatternMatch;
+   struct dependency *theDependency;
+
+   for (i = 0; i < theData->entities.count; i++)
+     {
+      theEntity = (struct patternEntity *) theData->entities.items[i];
+
+      if (i < theData->factCount)
+        { theList = (struct patternMatch *) ((Fact *) theEntity)->list; }
+#if OBJECT_SYSTEM
+      else
+        { theList = (struct patternMatch *) ((Instance *) theEntity)->partialMatchList; }
+#else
+      else
+        { theList = NULL; }
+#endif
+
+      for (count = 0, thePatternMatch = theList;
+           thePatternMatch != NULL;
+           thePatternMatch = thePatternMatch->next)
+        { count++; }
+
+      WriteSnapshotBytes(theWriter,&count,sizeof(unsigned long));
+      for (thePatternMatch = theList;
+           thePatternMatch != NULL;
+           thePatternMatch = thePatternMatch->next)
+        {
+         theID = FindSnapshotItem(&theData->matches,thePatternMatch->theMatch);
+         if ((theID == 0) || (theID > theData->alphaCount))
+           {
+            PrintErrorID(theEnv,"SNAPSHOT",7,false);
+            WriteString(theEnv,STDERR,"An entity refers to an alpha match which is not in an alpha memory.\n");
+            return false;
+           }
+         WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+         theID = FindSnapshotItem(&theData->nodes,thePatternMatch->matchingPattern);
+         WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+        }
+
+      for (count = 0, theDependency = (struct dependency *) theEntity->dependents;
+           theDependency != NULL;
+           theDependency = theDependency->next)
+        { count++; }
+
+      WriteSnapshotBytes(theWriter,&count,sizeof(unsigned long));
+      for (theDependency = (struct dependency *) theEntity->dependents;
+           theDependency != NULL;
+           theDependency = theDependency->next)
+        {
+         theID = FindSnapshotItem(&theData->matches,theDependency->dPtr);
+         WriteSnapshotBytes(theWriter,&theID,sizeof(unsigned long));
+        }
+     }
+
+   return true;
+  }
+
+/****************************************************/
+/* WriteSnapshotGlobals: Writes the current values  */
+/*   of the defglobals of every module.             */
+/****************************************************/
+static bool WriteSnapshotGlobals(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotWriter *theWriter)
+  {
+   unsigned long count = 0;
+#if DEFGLOBAL_CONSTRUCT
+   Defmodule *theModule;
+   Defglobal *theGlobal;
+   int pass;
+   bool rv = true;
+
+   SaveCurrentModule(theEnv);
+
+   for (pass = 0; (pass < 2) && rv; pass++)
+     {
+      if (pass == 1)
+        { WriteSnapshotBytes(theWriter,&count,sizeof(unsigned long)); }
+
+      for (theModule = GetNextDefmodule(theEnv,NULL);
+           (theModule != NULL) && rv;
+           theModule = GetNextDefmodule(theEnv,theModule))
+        {
+         SetCurrentModule(theEnv,theModule);
+
+         for (theGlobal = GetNextDefglobal(theEnv,NULL);
+              (theGlobal != NULL) && rv;
+              theGlobal = GetNextDefglobal(theEnv,theGlobal))
+           {
+            if (pass == 0)
+              {
+               count++;
+               continue;
+              }
+
+            WriteSnapshotString(theWriter,theModule->header.name->contents);
+            WriteSnapshotString(theWriter,theGlobal->header.name->contents);
+            rv = WriteSnapshotValue(theEnv,theData,theWriter,
+                                    theGlobal->current.header->type,
+                                    theGlobal->current.value);
+           }
+        }
+     }
+
+   RestoreCurrentModule(theEnv);
+
+   return rv;
+#else
+#if MAC_XCD
+#pragma unused(theEnv,theData)
+#endif
+   WriteSnapshotBytes(theWriter,&count,sizeof(unsigned long));
+   return true;
+#endif
+  }
+
+/*###########################################################*/
+/* Restoring the working memory.                            */
+/*###########################################################*/
+
+/****************************************************/
+/* ReadSnapshotBytes: Reads data from the working   */
+/*   memory section, failing if it would read past  */
+/*   the end of the section.                        */
+/****************************************************/
+static bool ReadSnapshotBytes(
+  struct snapshotReader *theReader,
+  void *theData,
+  size_t size)
+  {
+   if (theReader->error ||
+       (size > (theReader->size - theReader->position)))
+     {
+      theReader->error = true;
+      return false;
+     }
+
+   memcpy(theData,theReader->data + theReader->position,size);
+   theReader->position += size;
+   return true;
+  }
+
+/*****************************************************/
+/* ReadSnapshotString: Returns a string stored in    */
+/*   the working memory section without copying it.  */
+/*****************************************************/
+static const char *ReadSnapshotString(
+  struct snapshotReader *theReader)
+  {
+   unsigned long length;
+   const char *theString;
+
+   if (! ReadSnapshotBytes(theReader,&length,sizeof(unsigned long)))
+     { return NULL; }
+
+   if ((length >= (theReader->size - theReader->position)) ||
+       (theReader->data[theReader->position + length] != '\0'))
+     {
+      theReader->error = true;
+      return NULL;
+     }
+
+   theString = theReader->data + theReader->position;
+   theReader->position += length + 1;
+   return theString;
+  }
+
+/************************************************************/
+/* ReadSnapshotCount: Reads a count of items, each of which */
+/*   uses at least the specified number of bytes, so that a */
+/*   damaged count doesn't cause a large allocation.        */
+/************************************************************/
+static bool ReadSnapshotCount(
+  struct snapshotReader *theReader,
+  unsigned long *theCount,
+  size_t itemSize)
+  {
+   if (! ReadSnapshotBytes(theReader,theCount,sizeof(unsigned long)))
+     { return false; }
+
+   if ((itemSize != 0) &&
+       (*theCount > ((theReader->size - theReader->position) / itemSize)))
+     {
+      theReader->error = true;
+      return false;
+     }
+
+   return true;
+  }
+
+/*****************************************************/
+/* ReadSnapshotID: Reads the number of an item which */
+/*   must not be greater than the maximum given.     */
+/*****************************************************/
+static bool ReadSnapshotID(
+  struct snapshotReader *theReader,
+  unsigned long *theID,
+  unsigned long maximum)
+  {
+   if (! ReadSnapshotBytes(theReader,theID,sizeof(unsigned long)))
+     { return false; }
+
+   if (*theID > maximum)
+     {
+      theReader->error = true;
+      return false;
+     }
+
+   return true;
+  }
+
+/*************************************************************/
+/* ReadSnapshotValue: Reads a value written by               */
+/*   WriteSnapshotValue. Multifield values of facts are      */
+/*   created unmanaged since they belong to the fact.        */
+/*************************************************************/
+static bool ReadSnapshotValue(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader,
+  bool unmanaged,
+  bool nested,
+  CLIPSValue *theValue)
+  {
+   unsigned short theType;
+   const char *theString;
+   long long theInteger;
+   double theFloat;
+   unsigned long entityID, length, i;
+   Multifield *theSegment;
+
+   if (! ReadSnapshotBytes(theReader,&theType,sizeof(unsigned short)))
+     { return false; }
+
+   switch (theType)
+     {
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+        if ((theString = ReadSnapshotString(theReader)) == NULL)
+          { return false; }
+        if (theType == SYMBOL_TYPE)
+          { theValue->lexemeValue = CreateSymbol(theEnv,theString); }
+        else if (theType == STRING_TYPE)
+          { theValue->lexemeValue = CreateString(theEnv,theString); }
+        else
+          { theValue->lexemeValue = CreateInstanceName(theEnv,theString); }
+        return true;
+
+      case INTEGER_TYPE:
+        if (! ReadSnapshotBytes(theReader,&theInteger,sizeof(long long)))
+          { return false; }
+        theValue->integerValue = CreateInteger(theEnv,theInteger);
+        return true;
+
+      case FLOAT_TYPE:
+        if (! ReadSnapshotBytes(theReader,&theFloat,sizeof(double)))
+          { return false; }
+        theValue->floatValue = CreateFloat(theEnv,theFloat);
+        return true;
+
+      case FACT_ADDRESS_TYPE:
+        if (! ReadSnapshotID(theReader,&entityID,theData->factCount))
+          { return false; }
+        if (entityID == 0)
+          { theValue->lexemeValue = FalseSymbol(theEnv); }
+        else
+          { theValue->value = theData->entities.items[entityID - 1]; }
+        return true;
+
+#if OBJECT_SYSTEM
+      case INSTANCE_ADDRESS_TYPE:
+        if (! ReadSnapshotID(theReader,&entityID,theData->entities.count))
+          { return false; }
+        if (entityID == 0)
+          { theValue->lexemeValue = FalseSymbol(theEnv); }
+        else if (entityID <= theData->factCount)
+          {
+           theReader->error = true;
+           return false;
+          }
+        else
+          { theValue->value = theData->entities.items[entityID - 1]; }
+        return true;
+#endif
+
+      case VOID_TYPE:
+        theValue->voidValue = VoidConstant(theEnv);
+        return true;
+
+      case MULTIFIELD_TYPE:
+        if (nested || (! ReadSnapshotCount(theReader,&length,sizeof(unsigned short))))
+          {
+           theReader->error = true;
+           return false;
+          }
+
+        if (unmanaged)
+          { theSegment = CreateUnmanagedMultifield(theEnv,length); }
+        else
+          { theSegment = CreateMultifield(theEnv,length); }
+
+        for (i = 0; i < length; i++)
+          { theSegment->contents[i].lexemeValue = FalseSymbol(theEnv); }
+
+        theValue->multifieldValue = theSegment;
+
+        for (i = 0; i < length; i++)
+          {
+           if (! ReadSnapshotValue(theEnv,theData,theReader,unmanaged,true,&theSegment->contents[i]))
+             { return false; }
+          }
+        return true;
+     }
+
+   theReader->error = true;
+   return false;
+  }
+
+/**************************************************************/
+/* RestoreSnapshotWorkingMemory: Checks that the snapshot was */
+/*   saved from the current rule network, then replaces the   */
+/*   working memory with the one saved in the snapshot.       */
+/**************************************************************/
+static bool RestoreSnapshotWorkingMemory(
+  Environment *theEnv,
+  const char *fileName,
+  struct snapshotReader *theReader)
+  {
+   struct snapshotData theData;
+   long long nextFactIndex;
+   unsigned long long entityTimeTag, agendaTimeTag;
+   GCBlock gcb;
+   bool rv;
+#if OBJECT_SYSTEM
+   bool oldMessages, oldDelay;
+#endif
+
+   InitSnapshotData(&theData);
+   CollectSnapshotNetwork(theEnv,&theData);
+
+   if (! CheckSnapshotFingerprint(&theData,theReader))
+     {
+      if (! theReader->error)
+        {
+         PrintErrorID(theEnv,"SNAPSHOT",8,false);
+         WriteString(theEnv,STDERR,"The snapshot file '");
+         WriteString(theEnv,STDERR,fileName);
+         WriteString(theEnv,STDERR,"' was not saved from the current rules.\n");
+        }
+      rv = false;
+     }
+   else
+     {
+      rv = ReadSnapshotBytes(theReader,&nextFactIndex,sizeof(long long)) &&
+           ReadSnapshotBytes(theReader,&entityTimeTag,sizeof(unsigned long long)) &&
+           ReadSnapshotBytes(theReader,&agendaTimeTag,sizeof(unsigned long long)) &&
+           ReadSnapshotConstructs(theEnv,&theData,theReader);
+     }
+
+   if ((! rv) && (! theReader->error))
+     {
+      FreeSnapshotData(theEnv,&theData);
+      return false;
+     }
+
+   /*=========================================*/
+   /* Replace the current working memory with */
+   /* the working memory of the snapshot.     */
+   /*=========================================*/
+
+   GCBlockStart(theEnv,&gcb);
+
+   if (rv)
+     {
+      ClearSnapshotWorkingMemory(theEnv,&theData);
+
+#if OBJECT_SYSTEM
+      oldMessages = InstanceData(theEnv)->MkInsMsgPass;
+      oldDelay = ObjectReteData(theEnv)->DelayObjectPatternMatching;
+      InstanceData(theEnv)->MkInsMsgPass = false;
+      ObjectReteData(theEnv)->DelayObjectPatternMatching = true;
+#endif
+
+      rv = RestoreSnapshotEntities(theEnv,&theData,theReader) &&
+           RestoreSnapshotAlphaMatches(theEnv,&theData,theReader) &&
+           RestoreSnapshotBetaMatches(theEnv,&theData,theReader) &&
+           RestoreSnapshotActivations(theEnv,&theData,theReader) &&
+           RestoreSnapshotLinks(theEnv,&theData,theReader) &&
+           RestoreSnapshotEntityLinks(theEnv,&theData,theReader) &&
+           RestoreSnapshotFocus(theEnv,&theData,theReader) &&
+           RestoreSnapshotGlobals(theEnv,&theData,theReader);
+
+      if (! rv)
+        {
+         ReturnSnapshotFacts(theEnv,&theData);
+         ClearSnapshotWorkingMemory(theEnv,&theData);
+        }
+
+      /*======================================================*/
+      /* The instances were created and their slots set with  */
+      /* pattern matching delayed. The delayed actions are    */
+      /* discarded since the partial matches were restored.   */
+      /*======================================================*/
+
+#if OBJECT_SYSTEM
+      DiscardObjectMatchActions(theEnv);
+      ObjectReteData(theEnv)->DelayObjectPatternMatching = oldDelay;
+      InstanceData(theEnv)->MkInsMsgPass = oldMessages;
+#endif
+     }
+
+   if (rv)
+     {
+      FactData(theEnv)->NextFactIndex = nextFactIndex;
+      DefruleData(theEnv)->CurrentEntityTimeTag = entityTimeTag;
+      AgendaData(theEnv)->CurrentTimetag = agendaTimeTag;
+      FactData(theEnv)->ChangeToFactList = true;
+      AgendaData(theEnv)->AgendaChanged = true;
+#if OBJECT_SYSTEM
+      InstanceData(theEnv)->ChangesToInstances = true;
+#endif
+     }
+   else
+     {
+      PrintErrorID(theEnv,"SNAPSHOT",5,false);
+      WriteString(theEnv,STDERR,"The snapshot file '");
+      WriteString(theEnv,STDERR,fileName);
+      WriteString(theEnv,STDERR,"' is damaged. Working memory has been cleared.\n");
+     }
+
+   GCBlockEnd(theEnv,&gcb);
+
+   FreeSnapshotData(theEnv,&theData);
+
+   return rv;
+  }
+
+/************************************************************/
+/* CheckSnapshotFingerprint: Compares the rules and joins   */
+/*   saved in the snapshot with the current rule network.   */
+/************************************************************/
+static bool CheckSnapshotFingerprint(
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long i, count;
+   Defrule *theRule;
+   struct joinNode *theJoin;
+   const char *moduleName, *ruleName;
+   unsigned char flags;
+   unsigned short depth;
+
+   if ((! ReadSnapshotBytes(theReader,&count,sizeof(unsigned long))) ||
+       (count != theData->rules.count))
+     { return false; }
+
+   for (i = 0; i < count; i++)
+     {
+      theRule = (Defrule *) theData->rules.items[i];
+      if (((moduleName = ReadSnapshotString(theReader)) == NULL) ||
+          ((ruleName = ReadSnapshotString(theReader)) == NULL) ||
+          (strcmp(moduleName,theRule->header.whichModule->theModule->header.name->contents) != 0) ||
+          (strcmp(ruleName,theRule->header.name->contents) != 0))
+        { return false; }
+     }
+
+   if ((! ReadSnapshotBytes(theReader,&count,sizeof(unsigned long))) ||
+       (count != theData->joins.count))
+     { return false; }
+
+   for (i = 0; i < count; i++)
+     {
+      theJoin = (struct joinNode *) theData->joins.items[i];
+      if ((! ReadSnapshotBytes(theReader,&flags,sizeof(unsigned char))) ||
+          (! ReadSnapshotBytes(theReader,&depth,sizeof(unsigned short))) ||
+          (flags != SnapshotJoinFlags(theJoin)) ||
+          (depth != theJoin->depth))
+        { return false; }
+     }
+
+   if ((! ReadSnapshotBytes(theReader,&count,sizeof(unsigned long))) ||
+       (count != theData->nodes.count))
+     { return false; }
+
+   return true;
+  }
+
+/*********************************************************/
+/* ReadSnapshotModule: Reads a module name and returns   */
+/*   the module, or NULL if it doesn't exist.            */
+/*********************************************************/
+static Defmodule *ReadSnapshotModule(
+  Environment *theEnv,
+  struct snapshotReader *theReader)
+  {
+   const char *moduleName;
+
+   if ((moduleName = ReadSnapshotString(theReader)) == NULL)
+     { return NULL; }
+
+   return FindDefmodule(theEnv,moduleName);
+  }
+
+/***********************************************************/
+/* ReadSnapshotConstructs: Finds the deftemplates and      */
+/*   defclasses of the saved facts and instances. The      */
+/*   implied deftemplates of ordered facts are created if  */
+/*   they don't exist.                                     */
+/***********************************************************/
+static bool ReadSnapshotConstructs(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long i, count;
+   Defmodule *theModule;
+   const char *theName;
+   unsigned char implied;
+   Deftemplate *theDeftemplate;
+#if OBJECT_SYSTEM
+   Defclass *theDefclass;
+#endif
+
+   if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long)))
+     { return false; }
+
+   for (i = 0; i < count; i++)
+     {
+      theModule = ReadSnapshotModule(theEnv,theReader);
+      if (((theName = ReadSnapshotString(theReader)) == NULL) ||
+          (! ReadSnapshotBytes(theReader,&implied,sizeof(unsigned char))))
+        { return false; }
+
+      theDeftemplate = NULL;
+      if (theModule != NULL)
+        {
+         SaveCurrentModule(theEnv);
+         SetCurrentModule(theEnv,theModule);
+         theDeftemplate = FindDeftemplateInModule(theEnv,theName);
+         if ((theDeftemplate == NULL) && implied && (! Bloaded(theEnv)))
+           { theDeftemplate = CreateImpliedDeftemplate(theEnv,CreateSymbol(theEnv,theName),true); }
+         RestoreCurrentModule(theEnv);
+        }
+
+      if ((theDeftemplate == NULL) || (theDeftemplate->implied != implied))
+        {
+         PrintErrorID(theEnv,"SNAPSHOT",8,false);
+         WriteString(theEnv,STDERR,"The snapshot contains facts of deftemplate '");
+         WriteString(theEnv,STDERR,theName);
+         WriteString(theEnv,STDERR,"' which is not defined.\n");
+         return false;
+        }
+
+      AddSnapshotItem(theEnv,&theData->templates,theDeftemplate);
+     }
+
+   if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long)))
+     { return false; }
+
+#if OBJECT_SYSTEM
+   for (i = 0; i < count; i++)
+     {
+      theModule = ReadSnapshotModule(theEnv,theReader);
+      if ((theName = ReadSnapshotString(theReader)) == NULL)
+        { return false; }
+
+      theDefclass = NULL;
+      if (theModule != NULL)
+        {
+         SaveCurrentModule(theEnv);
+         SetCurrentModule(theEnv,theModule);
+         theDefclass = FindDefclassInModule(theEnv,theName);
+         RestoreCurrentModule(theEnv);
+        }
+
+      if (theDefclass == NULL)
+        {
+         PrintErrorID(theEnv,"SNAPSHOT",8,false);
+         WriteString(theEnv,STDERR,"The snapshot contains instances of defclass '");
+         WriteString(theEnv,STDERR,theName);
+         WriteString(theEnv,STDERR,"' which is not defined.\n");
+         return false;
+        }
+
+      AddSnapshotItem(theEnv,&theData->classes,theDefclass);
+     }
+#else
+   if (count != 0)
+     {
+      theReader->error = true;
+      return false;
+     }
+#endif
+
+   return true;
+  }
+
+/**************************************************************/
+/* ClearSnapshotWorkingMemory: Removes all activations,       */
+/*   partial matches, facts, and instances. The partial       */
+/*   matches are returned directly rather than retracted      */
+/*   through the join network, and the seed partial matches   */
+/*   of the joins are unlinked from the others.               */
+/**************************************************************/
+static void ClearSnapshotWorkingMemory(
+  Environment *theEnv,
+  struct snapshotData *theData)
+  {
+   Defmodule *theModule;
+   struct joinNode *theJoin;
+   Fact *theFact;
+   unsigned long i;
+#if OBJECT_SYSTEM
+   Instance *theInstance;
+   struct patternMatch *thePatternMatch;
+   bool oldMessages;
+#endif
+
+   SaveCurrentModule(theEnv);
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+      RemoveAllActivations(theEnv);
+     }
+   RestoreCurrentModule(theEnv);
+
+   for (i = 0; i < theData->joins.count; i++)
+     {
+      theJoin = (struct joinNode *) theData->joins.items[i];
+      ClearSnapshotMemory(theEnv,theJoin,LHS);
+      ClearSnapshotMemory(theEnv,theJoin,RHS);
+      ReleaseJoinRangeMemories(theEnv,theJoin);
+     }
+
+   for (i = 0; i < theData->nodes.count; i++)
+     { DestroyAlphaMemory(theEnv,(struct patternNodeHeader *) theData->nodes.items[i],true); }
+
+   /*================================================*/
+   /* Remove the links from the entities to the now  */
+   /* deleted partial matches before deleting them.  */
+   /*================================================*/
+
+   for (theFact = FactData(theEnv)->FactList;
+        theFact != NULL;
+        theFact = theFact->nextFact)
+     {
+      ReturnSnapshotPatternMatches(theEnv,(struct patternMatch *) theFact->list);
+      theFact->list = NULL;
+      ReturnSnapshotDependencies(theEnv,(struct dependency *) theFact->patternHeader.dependents);
+      theFact->patternHeader.dependents = NULL;
+     }
+
+   RetractAllFacts(theEnv);
+
+#if OBJECT_SYSTEM
+   for (theInstance = InstanceData(theEnv)->InstanceList;
+        theInstance != NULL;
+        theInstance = theInstance->nxtList)
+     {
+      for (thePatternMatch = (struct patternMatch *) theInstance->partialMatchList;
+           thePatternMatch != NULL;
+           thePatternMatch = thePatternMatch->next)
+        { theInstance->busy--; }
+      ReturnSnapshotPatternMatches(theEnv,(struct patternMatch *) theInstance->partialMatchList);
+      theInstance->partialMatchList = NULL;
+      ReturnSnapshotDependencies(theEnv,(struct dependency *) theInstance->patternHeader.dependents);
+      theInstance->patternHeader.dependents = NULL;
+     }
+
+   oldMessages = InstanceData(theEnv)->MkInsMsgPass;
+   InstanceData(theEnv)->MkInsMsgPass = false;
+   DeleteAllInstances(theEnv);
+   InstanceData(theEnv)->MkInsMsgPass = oldMessages;
+#endif
+
+   ClearFocusStack(theEnv);
+  }
+
+/*************************************************************/
+/* ClearSnapshotMemory: Returns the partial matches in a     */
+/*   beta memory, other than the seed partial match.         */
+/*************************************************************/
+static void ClearSnapshotMemory(
+  Environment *theEnv,
+  struct joinNode *theJoin,
+  int side)
+  {
+   struct betaMemory *theMemory;
+   struct partialMatch *theMatch;
+   unsigned long b;
+
+   theMemory = SnapshotMemory(theJoin,side);
+
+   switch (SnapshotMemoryKind(theJoin,side))
+     {
+      case SNAPSHOT_MEMORY:
+        DestroyBetaMemory(theEnv,theJoin,side);
+        memset(theMemory->beta,0,sizeof(struct partialMatch *) * theMemory->size);
+        if (theMemory->last != NULL)
+          { memset(theMemory->last,0,sizeof(struct partialMatch *) * theMemory->size); }
+        theMemory->count = 0;
+        break;
+
+      case SNAPSHOT_SEED_MEMORY:
+        for (b = 0; b < theMemory->size; b++)
+          {
+           for (theMatch = theMemory->beta[b];
+                theMatch != NULL;
+                theMatch = theMatch->nextInMemory)
+             {
+              theMatch->marker = NULL;
+              theMatch->children = NULL;
+              theMatch->blockList = NULL;
+              theMatch->nextBlocked = NULL;
+              theMatch->prevBlocked = NULL;
+              if (theMatch->dependents != NULL)
+                { DestroyPMDependencies(theEnv,theMatch); }
+             }
+          }
+        break;
+     }
+  }
+
+/**********************************/
+/* ReturnSnapshotPatternMatches:  */
+/**********************************/
+static void ReturnSnapshotPatternMatches(
+  Environment *theEnv,
+  struct patternMatch *theList)
+  {
+   struct patternMatch *nextMatch;
+
+   while (theList != NULL)
+     {
+      nextMatch = theList->next;
+      rtn_struct(theEnv,patternMatch,theList);
+      theList = nextMatch;
+     }
+  }
+
+/********************************/
+/* ReturnSnapshotDependencies:  */
+/********************************/
+static void ReturnSnapshotDependencies(
+  Environment *theEnv,
+  struct dependency *theList)
+  {
+   struct dependency *nextDependency;
+
+   while (theList != NULL)
+     {
+      nextDependency = theList->next;
+      rtn_struct(theEnv,dependency,theList);
+      theList = nextDependency;
+     }
+  }
+
+/**********************************************************/
+/* ReturnSnapshotFacts: Returns the facts created from a  */
+/*   snapshot which failed to load before they were added */
+/*   to the fact list.                                    */
+/**********************************************************/
+static void ReturnSnapshotFacts(
+  Environment *theEnv,
+  struct snapshotData *theData)
+  {
+   unsigned long i;
+
+   if (theData->factsInstalled)
+     { return; }
+
+   for (i = 0; i < theData->factCount; i++)
+     { ReturnFact(theEnv,(Fact *) theData->entities.items[i]); }
+
+   theData->factCount = 0;
+   theData->entities.count = 0;
+  }
+
+/*************************************************************/
+/* RestoreSnapshotEntities: Creates the facts and instances, */
+/*   sets their values, and adds the facts to the fact list. */
+/*************************************************************/
+static bool RestoreSnapshotEntities(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long i, count, templateID, length, j;
+   Fact *theFact;
+   long long factIndex;
+   unsigned long long timeTag;
+#if OBJECT_SYSTEM
+   unsigned long classID;
+   const char *theName;
+   unsigned char initSlotsCalled;
+   unsigned short slotCount, k;
+   Instance *theInstance;
+   CLIPSValue theValue;
+   UDFValue slotValue, junkValue;
+#endif
+
+   /*=========================*/
+   /* Create the fact shells. */
+   /*=========================*/
+
+   if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long)))
+     { return false; }
+
+   for (i = 0; i < count; i++)
+     {
+      if ((! ReadSnapshotID(theReader,&templateID,theData->templates.count)) ||
+          (templateID == 0) ||
+          (! ReadSnapshotBytes(theReader,&factIndex,sizeof(long long))) ||
+          (! ReadSnapshotBytes(theReader,&timeTag,sizeof(unsigned long long))) ||
+          (! ReadSnapshotCount(theReader,&length,sizeof(unsigned short))))
+        {
+         theReader->error = true;
+         return false;
+        }
+
+      theFact = CreateFactBySize(theEnv,length);
+      theFact->whichDeftemplate = (Deftemplate *) theData->templates.items[templateID - 1];
+      theFact->factIndex = factIndex;
+      theFact->patternHeader.timeTag = timeTag;
+      for (j = 0; j < length; j++)
+        { theFact->theProposition.contents[j].lexemeValue = FalseSymbol(theEnv); }
+
+      AddSnapshotItem(theEnv,&theData->entities,theFact);
+      theData->factCount++;
+
+      if ((! theFact->whichDeftemplate->implied) &&
+          (length != theFact->whichDeftemplate->numberOfSlots))
+        {
+         theReader->error = true;
+         return false;
+        }
+     }
+
+   /*===================================*/
+   /* Create the instances. Their slots */
+   /* are set once all entities exist.  */
+   /*===================================*/
+
+   if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long)))
+     { return false; }
+
+#if OBJECT_SYSTEM
+   for (i = 0; i < count; i++)
+     {
+      if (((theName = ReadSnapshotString(theReader)) == NULL) ||
+          (! ReadSnapshotID(theReader,&classID,theData->classes.count)) ||
+          (classID == 0) ||
+          (! ReadSnapshotBytes(theReader,&timeTag,sizeof(unsigned long long))) ||
+          (! ReadSnapshotBytes(theReader,&initSlotsCalled,sizeof(unsigned char))) ||
+          (! ReadSnapshotBytes(theReader,&slotCount,sizeof(unsigned short))) ||
+          (slotCount != ((Defclass *) theData->classes.items[classID - 1])->instanceSlotCount))
+        {
+         theReader->error = true;
+         return false;
+        }
+
+      theInstance = BuildInstance(theEnv,CreateInstanceName(theEnv,theName),
+                                  (Defclass *) theData->classes.items[classID - 1],false);
+      if (theInstance == NULL)
+        {
+         theReader->error = true;
+         return false;
+        }
+
+      theInstance->patternHeader.timeTag = timeTag;
+      theInstance->initSlotsCalled = initSlotsCalled;
+      AddSnapshotItem(theEnv,&theData->entities,theInstance);
+     }
+#else
+   if (count != 0)
+     {
+      theReader->error = true;
+      return false;
+     }
+#endif
+
+   /*===================================*/
+   /* Set the slot values of the facts. */
+   /*===================================*/
+
+   for (i = 0; i < theData->factCount; i++)
+     {
+      theFact = (Fact *) theData->entities.items[i];
+      for (j = 0; j < theFact->theProposition.length; j++)
+        {
+         if (! ReadSnapshotValue(theEnv,theData,theReader,true,false,
+                                 &theFact->theProposition.contents[j]))
+           { return false; }
+        }
+     }
+
+   for (i = 0; i < theData->factCount; i++)
+     { InstallRestoredFact(theEnv,(Fact *) theData->entities.items[i]); }
+
+   theData->factsInstalled = true;
+
+   /*=======================================*/
+   /* Set the slot values of the instances. */
+   /*=======================================*/
+
+#if OBJECT_SYSTEM
+   for (i = theData->factCount; i < theData->entities.count; i++)
+     {
+      theInstance = (Instance *) theData->entities.items[i];
+      for (k = 0; k < theInstance->cls->instanceSlotCount; k++)
+        {
+         if (((theName = ReadSnapshotString(theReader)) == NULL) ||
+             (strcmp(theName,theInstance->slotAddresses[k]->desc->slotName->name->contents) != 0) ||
+             (! ReadSnapshotValue(theEnv,theData,theReader,false,false,&theValue)))
+           {
+            theReader->error = true;
+            return false;
+           }
+
+         CLIPSToUDFValue(&theValue,&slotValue);
+         if (DirectPutSlotValue(theEnv,theInstance,theInstance->slotAddresses[k],&slotValue,&junkValue) != PSE_NO_ERROR)
+           {
+            theReader->error = true;
+            return false;
+           }
+        }
+     }
+#endif
+
+   return true;
+  }
+
+/*************************************************************/
+/* RestoreSnapshotAlphaMatches: Recreates the alpha memories */
+/*   of the pattern nodes.                                   */
+/*************************************************************/
+static bool RestoreSnapshotAlphaMatches(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long i, count, entityID;
+   unsigned char flags;
+   unsigned short markerCount, m;
+   struct patternNodeHeader *theHeader;
+   struct partialMatch *theMatch;
+   struct alphaMatch *theAlphaMatch;
+   struct multifieldMarker *theMarker, *lastMarker;
+   const char *slotName;
+
+   for (i = 0; i < theData->nodes.count; i++)
+     {
+      theHeader = (struct patternNodeHeader *) theData->nodes.items[i];
+
+      if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long) * 2))
+        { return false; }
+
+      for (; count > 0; count--)
+        {
+         if ((! ReadSnapshotID(theReader,&entityID,theData->entities.count)) ||
+             (entityID == 0))
+           {
+            theReader->error = true;
+            return false;
+           }
+
+         theMatch = get_struct(theEnv,partialMatch);
+         memset(theMatch,0,sizeof(struct partialMatch));
+         theMatch->betaMemory = false;
+         theMatch->bcount = 1;
+         theMatch->owner = theHeader;
+
+         theAlphaMatch = get_struct(theEnv,alphaMatch);
+         theAlphaMatch->matchingItem = (struct patternEntity *) theData->entities.items[entityID - 1];
+         theAlphaMatch->markers = NULL;
+         theAlphaMatch->next = NULL;
+         theAlphaMatch->bucket = 0;
+         theMatch->binds[0].gm.theMatch = theAlphaMatch;
+
+         /*===================================================*/
+         /* The alpha match is stored in the alpha memory     */
+         /* before its markers are read so that it's          */
+         /* returned with the alpha memory if the read fails. */
+         /*===================================================*/
+
+         if ((! ReadSnapshotBytes(theReader,&flags,sizeof(unsigned char))) ||
+             (! ReadSnapshotBytes(theReader,&theMatch->hashValue,sizeof(unsigned long))) ||
+             (! ReadSnapshotBytes(theReader,&markerCount,sizeof(unsigned short))))
+           {
+            StoreAlphaMatch(theEnv,theMatch,theHeader);
+            AddSnapshotItem(theEnv,&theData->matches,theMatch);
+            return false;
+           }
+
+         for (m = 0, lastMarker = NULL; m < markerCount; m++)
+           {
+            theMarker = get_struct(theEnv,multifieldMarker);
+            theMarker->next = NULL;
+            theMarker->where.whichSlot = NULL;
+            theMarker->startPosition = 0;
+            theMarker->range = 0;
+            if (lastMarker == NULL)
+              { theAlphaMatch->markers = theMarker; }
+            else
+              { lastMarker->next = theMarker; }
+            lastMarker = theMarker;
+
+            if (! ReadSnapshotBytes(theReader,&theMarker->whichField,sizeof(unsigned short)))
+              { break; }
+
+            if (entityID <= theData->factCount)
+              {
+               if (! ReadSnapshotBytes(theReader,&theMarker->where.whichSlotNumber,sizeof(unsigned short)))
+                 { break; }
+              }
+            else
+              {
+               if ((slotName = ReadSnapshotString(theReader)) == NULL)
+                 { break; }
+               theMarker->where.whichSlot = CreateSymbol(theEnv,slotName);
+              }
+
+            if ((! ReadSnapshotBytes(theReader,&theMarker->startPosition,sizeof(size_t))) ||
+                (! ReadSnapshotBytes(theReader,&theMarker->range,sizeof(size_t))))
+              { break; }
+           }
+
+         if ((! theReader->error) && (flags & SNAPSHOT_RECOMPUTE_HASH))
+           { theMatch->hashValue = SnapshotAlphaHash(theEnv,theData,theMatch,theHeader,entityID); }
+
+         StoreAlphaMatch(theEnv,theMatch,theHeader);
+         AddSnapshotItem(theEnv,&theData->matches,theMatch);
+
+         if (theReader->error)
+           { return false; }
+        }
+     }
+
+   theData->alphaCount = theData->matches.count;
+
+   return true;
+  }
+
+/************************************************************/
+/* RestoreSnapshotBetaMatches: Recreates the left and right */
+/*   beta memories of the joins.                            */
+/************************************************************/
+static bool RestoreSnapshotBetaMatches(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long i;
+
+   for (i = 0; i < theData->joins.count; i++)
+     {
+      if ((! RestoreSnapshotMemory(theEnv,theData,theReader,(struct joinNode *) theData->joins.items[i],LHS)) ||
+          (! RestoreSnapshotMemory(theEnv,theData,theReader,(struct joinNode *) theData->joins.items[i],RHS)))
+        { return false; }
+     }
+
+   return true;
+  }
+
+/**************************************************************/
+/* RestoreSnapshotMemory: Recreates the partial matches of a  */
+/*   beta memory in their saved order. The memory is given    */
+/*   the number of buckets it had when it was saved. The seed */
+/*   partial matches of the memory are numbered in place.     */
+/**************************************************************/
+static bool RestoreSnapshotMemory(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader,
+  struct joinNode *theJoin,
+  int side)
+  {
+   unsigned char kind, flags;
+   unsigned long size, count, b, theID;
+   unsigned short bcount, j;
+   struct betaMemory *theMemory;
+   struct partialMatch *theMatch, **tails;
+   struct expr *hashExpr;
+   unsigned long hashValue;
+
+   if ((! ReadSnapshotBytes(theReader,&kind,sizeof(unsigned char))) ||
+       (kind != SnapshotMemoryKind(theJoin,side)))
+     {
+      theReader->error = true;
+      return false;
+     }
+
+   if (kind == SNAPSHOT_NO_MEMORY)
+     { return true; }
+
+   theMemory = SnapshotMemory(theJoin,side);
+
+   if (kind == SNAPSHOT_SEED_MEMORY)
+     {
+      if ((! ReadSnapshotBytes(theReader,&count,sizeof(unsigned long))) ||
+          (count != SnapshotSeedCount(theMemory)))
+        {
+         theReader->error = true;
+         return false;
+        }
+
+      for (b = 0; b < theMemory->size; b++)
+        {
+         for (theMatch = theMemory->beta[b];
+              theMatch != NULL;
+              theMatch = theMatch->nextInMemory)
+           { AddSnapshotItem(theEnv,&theData->matches,theMatch); }
+        }
+
+      return true;
+     }
+
+   if ((! ReadSnapshotBytes(theReader,&size,sizeof(unsigned long))) ||
+       (size == 0) ||
+       (! ReadSnapshotCount(theReader,&count,sizeof(unsigned short) + sizeof(unsigned long) * 2)))
+     {
+      theReader->error = true;
+      return false;
+     }
+
+   /*==============================================*/
+   /* Give the memory the saved number of buckets. */
+   /*==============================================*/
+
+   if (size != theMemory->size)
+     {
+      if (size > (theReader->size / sizeof(unsigned long)) + INITIAL_BETA_HASH_SIZE)
+        {
+         theReader->error = true;
+         return false;
+        }
+
+      genfree(theEnv,theMemory->beta,sizeof(struct partialMatch *) * theMemory->size);
+      theMemory->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * size);
+      memset(theMemory->beta,0,sizeof(struct partialMatch *) * size);
+
+      if (theMemory->last != NULL)
+        {
+         genfree(theEnv,theMemory->last,sizeof(struct partialMatch *) * theMemory->size);
+         theMemory->last = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * size);
+         memset(theMemory->last,0,sizeof(struct partialMatch *) * size);
+        }
+
+      theMemory->size = size;
+     }
+
+   if (theMemory->last != NULL)
+     { tails = theMemory->last; }
+   else
+     {
+      tails = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * size);
+      memset(tails,0,sizeof(struct partialMatch *) * size);
+     }
+
+   hashExpr = (side == LHS) ? theJoin->leftHash : theJoin->rightHash;
+
+   for (; count > 0; count--)
+     {
+      if ((! ReadSnapshotBytes(theReader,&bcount,sizeof(unsigned short))) ||
+          (bcount == 0) ||
+          (! ReadSnapshotBytes(theReader,&flags,sizeof(unsigned char))) ||
+          (! ReadSnapshotBytes(theReader,&hashValue,sizeof(unsigned long))))
+        {
+         theReader->error = true;
+         break;
+        }
+
+      theMatch = get_var_struct(theEnv,partialMatch,sizeof(struct genericMatch) * (bcount - 1));
+      memset(theMatch,0,sizeof(struct partialMatch) + sizeof(struct genericMatch) * (bcount - 1));
+      theMatch->betaMemory = true;
+      theMatch->rhsMemory = (side == RHS);
+      theMatch->bcount = bcount;
+      theMatch->owner = theJoin;
+
+      for (j = 0; j < bcount; j++)
+        {
+         if (! ReadSnapshotID(theReader,&theID,theData->alphaCount))
+           { break; }
+
+         if (theID != 0)
+           {
+            theMatch->binds[j].gm.theMatch =
+               ((struct partialMatch *) theData->matches.items[theID - 1])->binds[0].gm.theMatch;
+           }
+        }
+
+      if ((! theReader->error) && (flags & SNAPSHOT_RECOMPUTE_HASH) && (hashExpr != NULL))
+        { hashValue = BetaMemoryHashValue(theEnv,hashExpr,theMatch,NULL,theJoin); }
+
+      theMatch->hashValue = hashValue;
+
+      /*=============================================*/
+      /* Append the partial match to its bucket so   */
+      /* the saved order of the memory is preserved. */
+      /*=============================================*/
+
+      b = hashValue % size;
+      theMatch->prevInMemory = tails[b];
+      if (tails[b] == NULL)
+        { theMemory->beta[b] = theMatch; }
+      else
+        { tails[b]->nextInMemory = theMatch; }
+      tails[b] = theMatch;
+      theMemory->count++;
+
+      AddSnapshotItem(theEnv,&theData->matches,theMatch);
+
+      if (theReader->error)
+        { break; }
+     }
+
+   if (tails != theMemory->last)
+     { genfree(theEnv,tails,sizeof(struct partialMatch *) * size); }
+
+   return ! theReader->error;
+  }
+
+/**************************************************************/
+/* RestoreSnapshotActivations: Recreates the activations in   */
+/*   agenda order.                                            */
+/**************************************************************/
+static bool RestoreSnapshotActivations(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long count, ruleID, basisID;
+   int salience, randomID;
+   unsigned long long timetag;
+   Activation *theActivation;
+
+   if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long) * 2))
+     { return false; }
+
+   for (; count > 0; count--)
+     {
+      if ((! ReadSnapshotID(theReader,&ruleID,theData->rules.count)) ||
+          (! ReadSnapshotID(theReader,&basisID,theData->matches.count)) ||
+          (ruleID == 0) ||
+          (basisID <= theData->alphaCount) ||
+          (! ReadSnapshotBytes(theReader,&salience,sizeof(int))) ||
+          (! ReadSnapshotBytes(theReader,&timetag,sizeof(unsigned long long))) ||
+          (! ReadSnapshotBytes(theReader,&randomID,sizeof(int))))
+        {
+         theReader->error = true;
+         return false;
+        }
+
+      theActivation = RestoreActivation(theEnv,(Defrule *) theData->rules.items[ruleID - 1],
+                                        (struct partialMatch *) theData->matches.items[basisID - 1],
+                                        salience,timetag,randomID);
+      AddSnapshotItem(theEnv,&theData->activations,theActivation);
+     }
+
+   return true;
+  }
+
+/*********************************************************/
+/* SnapshotMatchList: Returns the restored partial       */
+/*   matches as an array indexed by number - 1.          */
+/*********************************************************/
+static struct partialMatch **SnapshotMatchList(
+  struct snapshotData *theData)
+  {
+   return (struct partialMatch **) theData->matches.items;
+  }
+
+/**************************************************************/
+/* RestoreSnapshotDependencies: Reads a list of entities (or  */
+/*   partial matches) and returns it as a dependency list in  */
+/*   the saved order.                                         */
+/**************************************************************/
+static struct dependency *RestoreSnapshotDependencies(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader,
+  bool entityList)
+  {
+   unsigned long count, theID;
+   struct dependency *theList = NULL, *lastDependency = NULL, *newDependency;
+
+   if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long)))
+     { return NULL; }
+
+   for (; count > 0; count--)
+     {
+      if (! ReadSnapshotID(theReader,&theID,entityList ? theData->entities.count : theData->matches.count))
+        { break; }
+
+      if (theID == 0) continue;
+
+      newDependency = get_struct(theEnv,dependency);
+      newDependency->next = NULL;
+      if (entityList)
+        { newDependency->dPtr = theData->entities.items[theID - 1]; }
+      else
+        { newDependency->dPtr = theData->matches.items[theID - 1]; }
+
+      if (lastDependency == NULL)
+        { theList = newDependency; }
+      else
+        { lastDependency->next = newDependency; }
+      lastDependency = newDependency;
+     }
+
+   return theList;
+  }
+
+/**************************************************************/
+/* RestoreSnapshotLinks: Restores the links of each partial   */
+/*   match to the other partial matches, to its activation,   */
+/*   and to the entities it logically supports.               */
+/**************************************************************/
+static bool RestoreSnapshotLinks(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long i, j, count, theID;
+   struct partialMatch **theMatches, *theMatch;
+   struct partialMatch *theLinks[SNAPSHOT_LINK_COUNT];
+   unsigned char tag;
+
+   if ((! ReadSnapshotBytes(theReader,&count,sizeof(unsigned long))) ||
+       (count != theData->matches.count))
+     {
+      theReader->error = true;
+      return false;
+     }
+
+   theMatches = SnapshotMatchList(theData);
+
+   for (i = 0; i < count; i++)
+     {
+      theMatch = theMatches[i];
+
+      if (! ReadSnapshotBytes(theReader,&tag,sizeof(unsigned char)))
+        { return false; }
+
+      switch (tag)
+        {
+         case SNAPSHOT_NO_MARKER:
+           if (! ReadSnapshotID(theReader,&theID,0))
+             { return false; }
+           theMatch->marker = NULL;
+           break;
+
+         case SNAPSHOT_MATCH_MARKER:
+           if ((! ReadSnapshotID(theReader,&theID,theData->matches.count)) || (theID == 0))
+             {
+              theReader->error = true;
+              return false;
+             }
+           theMatch->marker = theMatches[theID - 1];
+           break;
+
+         case SNAPSHOT_ACTIVATION_MARKER:
+           if ((! ReadSnapshotID(theReader,&theID,theData->activations.count)) || (theID == 0))
+             {
+              theReader->error = true;
+              return false;
+             }
+           theMatch->marker = theData->activations.items[theID - 1];
+           break;
+
+         default:
+           theReader->error = true;
+           return false;
+        }
+
+      for (j = 0; j < SNAPSHOT_LINK_COUNT; j++)
+        {
+         if (! ReadSnapshotID(theReader,&theID,theData->matches.count))
+           { return false; }
+         theLinks[j] = (theID == 0) ? NULL : theMatches[theID - 1];
+        }
+
+      theMatch->children = theLinks[0];
+      theMatch->rightParent = theLinks[1];
+      theMatch->nextRightChild = theLinks[2];
+      theMatch->prevRightChild = theLinks[3];
+      theMatch->leftParent = theLinks[4];
+      theMatch->nextLeftChild = theLinks[5];
+      theMatch->prevLeftChild = theLinks[6];
+      theMatch->blockList = theLinks[7];
+      theMatch->nextBlocked = theLinks[8];
+      theMatch->prevBlocked = theLinks[9];
+
+      theMatch->dependents = RestoreSnapshotDependencies(theEnv,theData,theReader,true);
+      if (theReader->error)
+        { return false; }
+     }
+
+   return true;
+  }
+
+/*************************************************************/
+/* RestoreSnapshotEntityLinks: Restores the alpha matches of */
+/*   each fact and instance and the partial matches which    */
+/*   logically support it.                                   */
+/*************************************************************/
+static bool RestoreSnapshotEntityLinks(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long i, count, matchID, nodeID;
+   struct patternEntity *theEntity;
+   struct patternMatch *theList, *lastMatch, *newMatch;
+
+   for (i = 0; i < theData->entities.count; i++)
+     {
+      theEntity = (struct patternEntity *) theData->entities.items[i];
+
+      if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long) * 2))
+        { return false; }
+
+      for (theList = NULL, lastMatch = NULL; count > 0; count--)
+        {
+         if ((! ReadSnapshotID(theReader,&matchID,theData->alphaCount)) ||
+             (! ReadSnapshotID(theReader,&nodeID,theData->nodes.count)) ||
+             (matchID == 0) || (nodeID == 0))
+           {
+            theReader->error = true;
+            break;
+           }
+
+         newMatch = get_struct(theEnv,patternMatch);
+         newMatch->next = NULL;
+         newMatch->theMatch = (struct partialMatch *) theData->matches.items[matchID - 1];
+         newMatch->matchingPattern = (struct patternNodeHeader *) theData->nodes.items[nodeID - 1];
+
+         if (lastMatch == NULL)
+           { theList = newMatch; }
+         else
+           { lastMatch->next = newMatch; }
+         lastMatch = newMatch;
+
+#if OBJECT_SYSTEM
+         if (i >= theData->factCount)
+           { ((Instance *) theEntity)->busy++; }
+#endif
+        }
+
+      if (i < theData->factCount)
+        { ((Fact *) theEntity)->list = theList; }
+#if OBJECT_SYSTEM
+      else
+        { ((Instance *) theEntity)->partialMatchList = theList; }
+#endif
+
+      if (theReader->error)
+        { return false; }
+
+      theEntity->dependents = RestoreSnapshotDependencies(theEnv,theData,theReader,false);
+      if (theReader->error)
+        { return false; }
+     }
+
+   return true;
+  }
+
+/**************************************************************/
+/* RestoreSnapshotFocus: Restores the focus stack (which was  */
+/*   saved from top to bottom) and the current module.        */
+/**************************************************************/
+static bool RestoreSnapshotFocus(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long count, i;
+   Defmodule **theModules;
+   Defmodule *currentModule;
+   bool rv = true;
+
+   if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long)))
+     { return false; }
+
+   if (count == 0)
+     { theModules = NULL; }
+   else
+     { theModules = (Defmodule **) genalloc(theEnv,sizeof(Defmodule *) * count); }
+
+   for (i = 0; i < count; i++)
+     {
+      if ((theModules[i] = ReadSnapshotModule(theEnv,theReader)) == NULL)
+        {
+         theReader->error = true;
+         rv = false;
+         break;
+        }
+     }
+
+   if (rv)
+     {
+      for (i = count; i > 0; i--)
+        { Focus(theModules[i - 1]); }
+     }
+
+   if (theModules != NULL)
+     { genfree(theEnv,theModules,sizeof(Defmodule *) * count); }
+
+   if (! rv)
+     { return false; }
+
+   if ((currentModule = ReadSnapshotModule(theEnv,theReader)) == NULL)
+     {
+      theReader->error = true;
+      return false;
+     }
+
+   SetCurrentModule(theEnv,currentModule);
+
+   return true;
+  }
+
+/*************************************************************/
+/* RestoreSnapshotGlobals: Restores the values of the        */
+/*   defglobals. Defglobals which no longer exist are        */
+/*   ignored.                                                */
+/*************************************************************/
+static bool RestoreSnapshotGlobals(
+  Environment *theEnv,
+  struct snapshotData *theData,
+  struct snapshotReader *theReader)
+  {
+   unsigned long count;
+   Defmodule *theModule;
+   const char *theName;
+   CLIPSValue theValue;
+#if DEFGLOBAL_CONSTRUCT
+   Defglobal *theGlobal;
+   UDFValue globalValue;
+#endif
+
+   if (! ReadSnapshotCount(theReader,&count,sizeof(unsigned long)))
+     { return false; }
+
+   for (; count > 0; count--)
+     {
+      theModule = ReadSnapshotModule(theEnv,theReader);
+      if (((theName = ReadSnapshotString(theReader)) == NULL) ||
+          (! ReadSnapshotValue(theEnv,theData,theReader,false,false,&theValue)))
+        {
+         theReader->error = true;
+         return false;
+        }
+
+#if DEFGLOBAL_CONSTRUCT
+      if (theModule == NULL) continue;
+
+      SaveCurrentModule(theEnv);
+      SetCurrentModule(theEnv,theModule);
+      theGlobal = FindDefglobalInModule(theEnv,theName);
+      RestoreCurrentModule(theEnv);
+
+      if (theGlobal != NULL)
+        {
+         CLIPSToUDFValue(&theValue,&globalValue);
+         QSetDefglobalValue(theEnv,theGlobal,&globalValue,false);
+        }
+#endif
+     }
+
+   return true;
+  }
+
+#endif /* SNAPSHOT_FUNCTIONS */
+
+#if RUN_TIME && DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT
+
+#include "envrnmnt.h"
+#include "snapshot.h"
+#include "symbol.h"
+
+/*********************************************************/
+/* SaveSnapshotCommand: Run-time version of the command. */
+/*   A constructs-to-c image made with snapshots enabled */
+/*   refers to it even though snapshots need bsave.      */
+/*********************************************************/
+void SaveSnapshotCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+#if MAC_XCD
+#pragma unused(context)
+#endif
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+  }
+
+/*********************************************************/
+/* LoadSnapshotCommand: Run-time version of the command. */
+/*********************************************************/
+void LoadSnapshotCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+#if MAC_XCD
+#pragma unused(context)
+#endif
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+  }
+
+#endif /* RUN_TIME && DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT */
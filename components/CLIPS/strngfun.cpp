@@ -856,7 +856,6 @@ EvalError Eval(
   {
    struct expr *top;
    bool ov;
-   static int depth = 0;
    char logicalNameBuffer[20];
    struct BindInfo *oldBinds;
    int danglingConstructs;
@@ -882,8 +881,8 @@ EvalError Eval(
    /* for use each time the eval function is called.       */
    /*======================================================*/
 
-   depth++;
-   gensnprintf(logicalNameBuffer,sizeof(logicalNameBuffer),"Eval-%d",depth);
+   EvaluationData(theEnv)->EvalStringDepth++;
+   gensnprintf(logicalNameBuffer,sizeof(logicalNameBuffer),"Eval-%d",EvaluationData(theEnv)->EvalStringDepth);
    if (OpenStringSource(theEnv,logicalNameBuffer,theString,0) == 0)
      {
       SystemError(theEnv,"STRNGFUN",1);
@@ -926,7 +925,7 @@ EvalError Eval(
       GCBlockEnd(theEnv,&gcb);
       if (returnValue != NULL)
         { returnValue->lexemeValue = FalseSymbol(theEnv); }
-      depth--;
+      EvaluationData(theEnv)->EvalStringDepth--;
       ConstructData(theEnv)->DanglingConstructs = danglingConstructs;
       return EE_PARSING_ERROR;
      }
@@ -946,7 +945,7 @@ EvalError Eval(
       GCBlockEnd(theEnv,&gcb);
       if (returnValue != NULL)
         { returnValue->lexemeValue = FalseSymbol(theEnv); }
-      depth--;
+      EvaluationData(theEnv)->EvalStringDepth--;
       ConstructData(theEnv)->DanglingConstructs = danglingConstructs;
       return EE_PARSING_ERROR;
      }
@@ -960,7 +959,7 @@ EvalError Eval(
    EvaluateExpression(theEnv,top,&evalResult);
    ExpressionDeinstall(theEnv,top);
 
-   depth--;
+   EvaluationData(theEnv)->EvalStringDepth--;
    ReturnExpression(theEnv,top);
    CloseStringSource(theEnv,logicalNameBuffer);
 
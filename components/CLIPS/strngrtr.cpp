@@ -223,6 +223,50 @@ static int UnreadStringCallback(
    return 1;
   }
 
+/*****************************************************/
+/* StringRouterSpan: Returns the unread part of a    */
+/*   string source as a contiguous span if theRouter */
+/*   is the string router, otherwise NULL.           */
+/*****************************************************/
+const char *StringRouterSpan(
+  Environment *theEnv,
+  struct router *theRouter,
+  const char *logicalName,
+  size_t *length)
+  {
+   struct stringRouter *head;
+
+   if (theRouter->readCallback != ReadStringCallback)
+     { return NULL; }
+
+   head = FindStringRouter(theEnv,logicalName);
+   if ((head == NULL) ||
+       (head->readWriteType != READ_STRING) ||
+       (head->currentPosition >= head->maximumPosition))
+     { return NULL; }
+
+   *length = head->maximumPosition - head->currentPosition;
+   return &head->readString[head->currentPosition];
+  }
+
+/***************************************************/
+/* AdvanceStringRouter: Consumes count characters  */
+/*   of the span returned by StringRouterSpan.     */
+/***************************************************/
+void AdvanceStringRouter(
+  Environment *theEnv,
+  const char *logicalName,
+  size_t count)
+  {
+   struct stringRouter *head;
+
+   head = FindStringRouter(theEnv,logicalName);
+   if ((head == NULL) || (head->readWriteType != READ_STRING))
+     { return; }
+
+   head->currentPosition += count;
+  }
+
 /************************************************/
 /* OpenStringSource: Opens a new string router. */
 /************************************************/
@@ -291,6 +335,7 @@ static bool CreateReadStringSource(
    newStringRouter->maximumPosition = maximumPosition;
    newStringRouter->next = StringRouterData(theEnv)->ListOfStringRouters;
    StringRouterData(theEnv)->ListOfStringRouters = newStringRouter;
+   InvalidateRouterCache(theEnv);
 
    return true;
   }
@@ -310,6 +355,7 @@ bool CloseStringSource(
      {
       if (strcmp(head->name,name) == 0)
         {
+         InvalidateRouterCache(theEnv);
          if (last == NULL)
            {
             StringRouterData(theEnv)->ListOfStringRouters = head->next;
@@ -357,6 +403,7 @@ bool OpenStringDestination(
    newStringRouter->maximumPosition = maximumPosition;
    newStringRouter->next = StringRouterData(theEnv)->ListOfStringRouters;
    StringRouterData(theEnv)->ListOfStringRouters = newStringRouter;
+   InvalidateRouterCache(theEnv);
 
    return true;
   }
@@ -412,6 +459,7 @@ bool OpenStringBuilderDestination(
    newStringRouter->SBR = theSB;
    newStringRouter->next = StringRouterData(theEnv)->ListOfStringBuilderRouters;
    StringRouterData(theEnv)->ListOfStringBuilderRouters = newStringRouter;
+   InvalidateRouterCache(theEnv);
 
    return true;
   }
@@ -432,6 +480,7 @@ bool CloseStringBuilderDestination(
      {
       if (strcmp(head->name,name) == 0)
         {
+         InvalidateRouterCache(theEnv);
          if (last == NULL)
            {
             StringRouterData(theEnv)->ListOfStringBuilderRouters = head->next;
@@ -422,9 +422,11 @@ void ReadNeededAtomicValues(
 void ReadNeededSymbols(
   Environment *theEnv)
   {
-   char *symbolNames, *namePtr;
+   char *symbolNames = NULL;
+   const char *namePtr;
    unsigned long space;
-   unsigned short *types;
+   unsigned short *types = NULL;
+   const unsigned short *typesPtr;
    unsigned long i;
 
    /*=================================================*/
@@ -444,11 +446,28 @@ void ReadNeededSymbols(
    /* Allocate area for strings to be read. */
    /*=======================================*/
    
-   types = (unsigned short *) gm2(theEnv,sizeof(unsigned short) * SymbolData(theEnv)->NumberOfSymbols);
-   GenReadBinary(theEnv,types,sizeof(unsigned short) * SymbolData(theEnv)->NumberOfSymbols);
+   /*===================================================*/
+   /* If the binary image is in memory, the symbols are */
+   /* created from the types and names in the image     */
+   /* rather than from a temporary copy of them.        */
+   /*===================================================*/
+
+   typesPtr = (const unsigned short *)
+              GenReadBinaryInPlace(theEnv,sizeof(unsigned short) * SymbolData(theEnv)->NumberOfSymbols,sizeof(unsigned short));
+   if (typesPtr == NULL)
+     {
+      types = (unsigned short *) gm2(theEnv,sizeof(unsigned short) * SymbolData(theEnv)->NumberOfSymbols);
+      GenReadBinary(theEnv,types,sizeof(unsigned short) * SymbolData(theEnv)->NumberOfSymbols);
+      typesPtr = types;
+     }
 
-   symbolNames = (char *) gm2(theEnv,space);
-   GenReadBinary(theEnv,symbolNames,space);
+   namePtr = (const char *) GenReadBinaryInPlace(theEnv,space,1);
+   if (namePtr == NULL)
+     {
+      symbolNames = (char *) gm2(theEnv,space);
+      GenReadBinary(theEnv,symbolNames,space);
+      namePtr = symbolNames;
+     }
 
    /*================================================*/
    /* Store the symbol pointers in the symbol array. */
@@ -456,12 +475,11 @@ void ReadNeededSymbols(
 
    SymbolData(theEnv)->SymbolArray = (CLIPSLexeme **)
                  gm2(theEnv,sizeof(CLIPSLexeme *) * SymbolData(theEnv)->NumberOfSymbols);
-   namePtr = symbolNames;
    for (i = 0; i < SymbolData(theEnv)->NumberOfSymbols; i++)
      {
-      if (types[i] == SYMBOL_TYPE)
+      if (typesPtr[i] == SYMBOL_TYPE)
         { SymbolData(theEnv)->SymbolArray[i] = CreateSymbol(theEnv,namePtr); }
-      else if (types[i] == STRING_TYPE)
+      else if (typesPtr[i] == STRING_TYPE)
         { SymbolData(theEnv)->SymbolArray[i] = CreateString(theEnv,namePtr); }
       else
         { SymbolData(theEnv)->SymbolArray[i] = CreateInstanceName(theEnv,namePtr); }
@@ -473,8 +491,10 @@ void ReadNeededSymbols(
    /* Free the name buffer. */
    /*=======================*/
 
-   rm(theEnv,types,sizeof(unsigned short) * SymbolData(theEnv)->NumberOfSymbols);
-   rm(theEnv,symbolNames,space);
+   if (types != NULL)
+     { rm(theEnv,types,sizeof(unsigned short) * SymbolData(theEnv)->NumberOfSymbols); }
+   if (symbolNames != NULL)
+     { rm(theEnv,symbolNames,space); }
   }
 
 /*****************************************/
@@ -484,7 +504,8 @@ void ReadNeededSymbols(
 void ReadNeededFloats(
   Environment *theEnv)
   {
-   double *floatValues;
+   double *floatValues = NULL;
+   const double *valuePtr;
    unsigned long i;
 
    /*============================================*/
@@ -502,8 +523,14 @@ void ReadNeededFloats(
    /* Allocate area for the floats. */
    /*===============================*/
 
-   floatValues = (double *) gm2(theEnv,sizeof(double) * SymbolData(theEnv)->NumberOfFloats);
-   GenReadBinary(theEnv,floatValues,(sizeof(double) * SymbolData(theEnv)->NumberOfFloats));
+   valuePtr = (const double *)
+              GenReadBinaryInPlace(theEnv,sizeof(double) * SymbolData(theEnv)->NumberOfFloats,sizeof(double));
+   if (valuePtr == NULL)
+     {
+      floatValues = (double *) gm2(theEnv,sizeof(double) * SymbolData(theEnv)->NumberOfFloats);
+      GenReadBinary(theEnv,floatValues,(sizeof(double) * SymbolData(theEnv)->NumberOfFloats));
+      valuePtr = floatValues;
+     }
 
    /*======================================*/
    /* Store the floats in the float array. */
@@ -512,13 +539,14 @@ void ReadNeededFloats(
    SymbolData(theEnv)->FloatArray = (CLIPSFloat **)
                gm2(theEnv,sizeof(CLIPSFloat *) * SymbolData(theEnv)->NumberOfFloats);
    for (i = 0; i < SymbolData(theEnv)->NumberOfFloats; i++)
-     { SymbolData(theEnv)->FloatArray[i] = CreateFloat(theEnv,floatValues[i]); }
+     { SymbolData(theEnv)->FloatArray[i] = CreateFloat(theEnv,valuePtr[i]); }
 
    /*========================*/
    /* Free the float buffer. */
    /*========================*/
 
-   rm(theEnv,floatValues,(sizeof(double) * SymbolData(theEnv)->NumberOfFloats));
+   if (floatValues != NULL)
+     { rm(theEnv,floatValues,(sizeof(double) * SymbolData(theEnv)->NumberOfFloats)); }
   }
 
 /*********************************************/
@@ -528,7 +556,8 @@ void ReadNeededFloats(
 void ReadNeededIntegers(
   Environment *theEnv)
   {
-   long long *integerValues;
+   long long *integerValues = NULL;
+   const long long *valuePtr;
    unsigned long i;
 
    /*==============================================*/
@@ -546,8 +575,14 @@ void ReadNeededIntegers(
    /* Allocate area for the integers. */
    /*=================================*/
 
-   integerValues = (long long *) gm2(theEnv,(sizeof(long long) * SymbolData(theEnv)->NumberOfIntegers));
-   GenReadBinary(theEnv,integerValues,(sizeof(long long) * SymbolData(theEnv)->NumberOfIntegers));
+   valuePtr = (const long long *)
+              GenReadBinaryInPlace(theEnv,sizeof(long long) * SymbolData(theEnv)->NumberOfIntegers,sizeof(long long));
+   if (valuePtr == NULL)
+     {
+      integerValues = (long long *) gm2(theEnv,(sizeof(long long) * SymbolData(theEnv)->NumberOfIntegers));
+      GenReadBinary(theEnv,integerValues,(sizeof(long long) * SymbolData(theEnv)->NumberOfIntegers));
+      valuePtr = integerValues;
+     }
 
    /*==========================================*/
    /* Store the integers in the integer array. */
@@ -556,13 +591,14 @@ void ReadNeededIntegers(
    SymbolData(theEnv)->IntegerArray = (CLIPSInteger **)
            gm2(theEnv,(sizeof(CLIPSInteger *) * SymbolData(theEnv)->NumberOfIntegers));
    for (i = 0; i < SymbolData(theEnv)->NumberOfIntegers; i++)
-     { SymbolData(theEnv)->IntegerArray[i] = CreateInteger(theEnv,integerValues[i]); }
+     { SymbolData(theEnv)->IntegerArray[i] = CreateInteger(theEnv,valuePtr[i]); }
 
    /*==========================*/
    /* Free the integer buffer. */
    /*==========================*/
 
-   rm(theEnv,integerValues,(sizeof(long long) * SymbolData(theEnv)->NumberOfIntegers));
+   if (integerValues != NULL)
+     { rm(theEnv,integerValues,(sizeof(long long) * SymbolData(theEnv)->NumberOfIntegers)); }
   }
 
 /*******************************************/
@@ -78,8 +78,10 @@
 
 #include "argacces.h"
 #include "constant.h"
+#include "constrct.h"
 #include "envrnmnt.h"
 #include "memalloc.h"
+#include "moduldef.h"
 #include "multifld.h"
 #include "prntutil.h"
 #include "router.h"
@@ -114,6 +116,8 @@
    static const char             *StringWithinString(const char *,const char *);
    static size_t                  CommonPrefixLength(const char *,const char *);
    static void                    DeallocateSymbolData(Environment *);
+   static void                    FreeSharedAtomBase(SharedAtomBase *);
+   static void                    MarkConstructNames(Environment *,bool);
 
 /*******************************************************/
 /* InitializeAtomTables: Initializes the SymbolTable,  */
@@ -126,7 +130,8 @@ void InitializeAtomTables(
   CLIPSFloat **floatTable,
   CLIPSInteger **integerTable,
   CLIPSBitMap **bitmapTable,
-  CLIPSExternalAddress **externalAddressTable)
+  CLIPSExternalAddress **externalAddressTable,
+  SharedAtomBase *sharedBase)
   {
 #if MAC_XCD
 #pragma unused(symbolTable)
@@ -139,6 +144,14 @@ void InitializeAtomTables(
 
    AllocateEnvironmentData(theEnv,SYMBOL_DATA,sizeof(struct symbolData),DeallocateSymbolData);
 
+   /*=====================================================*/
+   /* The shared base layer must be in place before the   */
+   /* predefined atoms are created so that they're found  */
+   /* there rather than duplicated in this environment.   */
+   /*=====================================================*/
+
+   SymbolData(theEnv)->SharedBase = sharedBase;
+
 #if ! RUN_TIME
    /*=========================*/
    /* Create the hash tables. */
@@ -401,6 +414,24 @@ CLIPSLexeme *AddSymbol(
       }
 
     tally = HashSymbol(str,SYMBOL_HASH_SIZE);
+
+    /*==================================================*/
+    /* Strings in the base layer shared with the other  */
+    /* environments are found before the local entries. */
+    /*==================================================*/
+
+    if (SymbolData(theEnv)->SharedBase != NULL)
+      {
+       for (peek = SymbolData(theEnv)->SharedBase->SymbolTable[tally];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if ((peek->header.type == theType) &&
+              (strcmp(str,peek->contents) == 0))
+            { return peek; }
+         }
+      }
+
     peek = SymbolData(theEnv)->SymbolTable[tally];
 
     /*==================================================*/
@@ -467,6 +498,18 @@ CLIPSLexeme *FindSymbolHN(
 
     tally = HashSymbol(str,SYMBOL_HASH_SIZE);
 
+    if (SymbolData(theEnv)->SharedBase != NULL)
+      {
+       for (peek = SymbolData(theEnv)->SharedBase->SymbolTable[tally];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if (((1 << peek->header.type) & expectedType) &&
+              (strcmp(str,peek->contents) == 0))
+            { return peek; }
+         }
+      }
+
     for (peek = SymbolData(theEnv)->SymbolTable[tally];
          peek != NULL;
          peek = peek->next)
@@ -497,6 +540,15 @@ CLIPSFloat *CreateFloat(
     /*====================================*/
 
     tally = HashFloat(number,FLOAT_HASH_SIZE);
+
+    if (SymbolData(theEnv)->SharedBase != NULL)
+      {
+       for (peek = SymbolData(theEnv)->SharedBase->FloatTable[tally];
+            peek != NULL;
+            peek = peek->next)
+         { if (number == peek->contents) return peek; }
+      }
+
     peek = SymbolData(theEnv)->FloatTable[tally];
 
     /*==================================================*/
@@ -563,6 +615,15 @@ CLIPSInteger *CreateInteger(
     /*==================================*/
 
     tally = HashInteger(number,INTEGER_HASH_SIZE);
+
+    if (SymbolData(theEnv)->SharedBase != NULL)
+      {
+       for (peek = SymbolData(theEnv)->SharedBase->IntegerTable[tally];
+            peek != NULL;
+            peek = peek->next)
+         { if (number == peek->contents) return peek; }
+      }
+
     peek = SymbolData(theEnv)->IntegerTable[tally];
 
     /*================================================*/
@@ -623,6 +684,14 @@ CLIPSInteger *FindLongHN(
 
    tally = HashInteger(theLong,INTEGER_HASH_SIZE);
 
+   if (SymbolData(theEnv)->SharedBase != NULL)
+     {
+      for (peek = SymbolData(theEnv)->SharedBase->IntegerTable[tally];
+           peek != NULL;
+           peek = peek->next)
+        { if (peek->contents == theLong) return(peek); }
+     }
+
    for (peek = SymbolData(theEnv)->IntegerTable[tally];
         peek != NULL;
         peek = peek->next)
@@ -659,6 +728,19 @@ void *AddBitMap(
       }
 
     tally = HashBitMap(theBitMap,BITMAP_HASH_SIZE,size);
+
+    if (SymbolData(theEnv)->SharedBase != NULL)
+      {
+       for (peek = SymbolData(theEnv)->SharedBase->BitMapTable[tally];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if ((peek->size == size) &&
+              (memcmp(peek->contents,theBitMap,size) == 0))
+            { return((void *) peek); }
+         }
+      }
+
     peek = SymbolData(theEnv)->BitMapTable[tally];
 
     /*==================================================*/
@@ -941,6 +1023,8 @@ void RetainLexeme(
   Environment *theEnv,
   CLIPSLexeme *theValue)
   {
+   if (theValue->permanent) return;
+
    theValue->count++;
   }
 
@@ -953,6 +1037,8 @@ void ReleaseLexeme(
   Environment *theEnv,
   CLIPSLexeme *theValue)
   {
+   if (theValue->permanent) return;
+
    if (theValue->count < 0)
      {
       SystemError(theEnv,"SYMBOL",3);
@@ -988,6 +1074,8 @@ void RetainFloat(
   Environment *theEnv,
   CLIPSFloat *theValue)
   {
+   if (theValue->permanent) return;
+
    theValue->count++;
   }
 
@@ -1000,6 +1088,8 @@ void ReleaseFloat(
   Environment *theEnv,
   CLIPSFloat *theValue)
   {
+   if (theValue->permanent) return;
+
    if (theValue->count <= 0)
      {
       SystemError(theEnv,"SYMBOL",5);
@@ -1029,6 +1119,8 @@ void RetainInteger(
   Environment *theEnv,
   CLIPSInteger *theValue)
   {
+   if (theValue->permanent) return;
+
    theValue->count++;
   }
 
@@ -1041,6 +1133,8 @@ void ReleaseInteger(
   Environment *theEnv,
   CLIPSInteger *theValue)
   {
+   if (theValue->permanent) return;
+
    if (theValue->count <= 0)
      {
       SystemError(theEnv,"SYMBOL",6);
@@ -1070,6 +1164,8 @@ void IncrementBitMapReferenceCount(
   Environment *theEnv,
   CLIPSBitMap *theValue)
   {
+   if (theValue->permanent) return;
+
    theValue->count++;
   }
 
@@ -1082,6 +1178,8 @@ void DecrementBitMapReferenceCount(
   Environment *theEnv,
   CLIPSBitMap *theValue)
   {
+   if (theValue->permanent) return;
+
    if (theValue->count < 0)
      {
       SystemError(theEnv,"SYMBOL",7);
@@ -1117,6 +1215,8 @@ void RetainExternalAddress(
   Environment *theEnv,
   CLIPSExternalAddress *theValue)
   {
+   if (theValue->permanent) return;
+
    theValue->count++;
   }
 
@@ -1129,6 +1229,8 @@ void ReleaseExternalAddress(
   Environment *theEnv,
   CLIPSExternalAddress *theValue)
   {
+   if (theValue->permanent) return;
+
    if (theValue->count < 0)
      {
       SystemError(theEnv,"SYMBOL",9);
@@ -1322,7 +1424,7 @@ void EphemerateValue(
       case INSTANCE_NAME_TYPE:
 #endif
         theSymbol = (CLIPSLexeme *) theValue;
-        if (theSymbol->markedEphemeral) return;
+        if (theSymbol->permanent || theSymbol->markedEphemeral) return;
         AddEphemeralHashNode(theEnv,(GENERIC_HN *) theValue,
                              &UtilityData(theEnv)->CurrentGarbageFrame->ephemeralSymbolList,
                              sizeof(CLIPSLexeme),AVERAGE_STRING_SIZE,false);
@@ -1331,7 +1433,7 @@ void EphemerateValue(
 
       case FLOAT_TYPE:
         theFloat = (CLIPSFloat *) theValue;
-        if (theFloat->markedEphemeral) return;
+        if (theFloat->permanent || theFloat->markedEphemeral) return;
         AddEphemeralHashNode(theEnv,(GENERIC_HN *) theValue,
                              &UtilityData(theEnv)->CurrentGarbageFrame->ephemeralFloatList,
                              sizeof(CLIPSFloat),0,false);
@@ -1340,7 +1442,7 @@ void EphemerateValue(
 
       case INTEGER_TYPE:
         theInteger = (CLIPSInteger *) theValue;
-        if (theInteger->markedEphemeral) return;
+        if (theInteger->permanent || theInteger->markedEphemeral) return;
         AddEphemeralHashNode(theEnv,(GENERIC_HN *) theValue,
                              &UtilityData(theEnv)->CurrentGarbageFrame->ephemeralIntegerList,
                              sizeof(CLIPSInteger),0,false);
@@ -1349,7 +1451,7 @@ void EphemerateValue(
 
       case EXTERNAL_ADDRESS_TYPE:
         theExternalAddress = (CLIPSExternalAddress *) theValue;
-        if (theExternalAddress->markedEphemeral) return;
+        if (theExternalAddress->permanent || theExternalAddress->markedEphemeral) return;
         AddEphemeralHashNode(theEnv,(GENERIC_HN *) theValue,
                              &UtilityData(theEnv)->CurrentGarbageFrame->ephemeralExternalAddressList,
                              sizeof(CLIPSExternalAddress),sizeof(long),false);
@@ -1959,3 +2061,356 @@ void RestoreAtomicValueBuckets(
   }
 
 #endif /* BLOAD_AND_BSAVE || CONSTRUCT_COMPILER || BSAVE_INSTANCES */
+
+/************************************************************/
+/* CreateSharedAtomBase: Creates a frozen copy of the atoms */
+/*   in use by a template environment. Environments created */
+/*   with CreateEnvironmentWithBase find these atoms before */
+/*   their own, so the atoms of the constructs loaded into  */
+/*   each environment are only stored once. The copies are  */
+/*   marked permanent: their counts are never changed, so   */
+/*   the base can be read by several threads at once.       */
+/*   Construct names are left out: the count of a name is   */
+/*   used to tell quickly that a construct doesn't exist,   */
+/*   and that only works for atoms with their own counts.   */
+/************************************************************/
+SharedAtomBase *CreateSharedAtomBase(
+  Environment *theEnv)
+  {
+   SharedAtomBase *theBase;
+   CLIPSLexeme *symbolPtr, *newSymbol, **symbolTables[2];
+   CLIPSFloat *floatPtr, *newFloat, **floatTables[2];
+   CLIPSInteger *integerPtr, *newInteger, **integerTables[2];
+   CLIPSBitMap *bitMapPtr, *newBitMap, **bitMapTables[2];
+   char *contents;
+   size_t length;
+   unsigned long i;
+   unsigned int t, tableCount = 1;
+
+   theBase = (SharedAtomBase *) malloc(sizeof(SharedAtomBase));
+   if (theBase == NULL) return NULL;
+
+   theBase->SymbolTable = (CLIPSLexeme **) calloc(SYMBOL_HASH_SIZE,sizeof(CLIPSLexeme *));
+   theBase->FloatTable = (CLIPSFloat **) calloc(FLOAT_HASH_SIZE,sizeof(CLIPSFloat *));
+   theBase->IntegerTable = (CLIPSInteger **) calloc(INTEGER_HASH_SIZE,sizeof(CLIPSInteger *));
+   theBase->BitMapTable = (CLIPSBitMap **) calloc(BITMAP_HASH_SIZE,sizeof(CLIPSBitMap *));
+   theBase->atomCount = 0;
+
+   if ((theBase->SymbolTable == NULL) || (theBase->FloatTable == NULL) ||
+       (theBase->IntegerTable == NULL) || (theBase->BitMapTable == NULL))
+     {
+      FreeSharedAtomBase(theBase);
+      return NULL;
+     }
+
+   /*===================================================*/
+   /* If the template environment uses a base layer of  */
+   /* its own, those atoms are copied too so that the   */
+   /* new base doesn't depend on the one it was built   */
+   /* on and can outlive it.                            */
+   /*===================================================*/
+
+   symbolTables[0] = SymbolData(theEnv)->SymbolTable;
+   floatTables[0] = SymbolData(theEnv)->FloatTable;
+   integerTables[0] = SymbolData(theEnv)->IntegerTable;
+   bitMapTables[0] = SymbolData(theEnv)->BitMapTable;
+
+   if (SymbolData(theEnv)->SharedBase != NULL)
+     {
+      symbolTables[1] = SymbolData(theEnv)->SharedBase->SymbolTable;
+      floatTables[1] = SymbolData(theEnv)->SharedBase->FloatTable;
+      integerTables[1] = SymbolData(theEnv)->SharedBase->IntegerTable;
+      bitMapTables[1] = SymbolData(theEnv)->SharedBase->BitMapTable;
+      tableCount = 2;
+     }
+
+   /*=================================================*/
+   /* The needed flags of the symbols may be left set */
+   /* by a binary save, so they're cleared first.     */
+   /*=================================================*/
+
+   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+     {
+      for (symbolPtr = SymbolData(theEnv)->SymbolTable[i]; symbolPtr != NULL; symbolPtr = symbolPtr->next)
+        { symbolPtr->neededSymbol = false; }
+     }
+
+   MarkConstructNames(theEnv,true);
+
+   /*=======================================================*/
+   /* Copy the atoms still in use. Ephemeral atoms with a   */
+   /* count of zero are garbage and aren't worth sharing.   */
+   /* The buckets are the same size as the environment hash */
+   /* tables, so a lookup hashes the value only once.       */
+   /*=======================================================*/
+
+   for (t = 0; t < tableCount; t++)
+     {
+      for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+        {
+         for (symbolPtr = symbolTables[t][i]; symbolPtr != NULL; symbolPtr = symbolPtr->next)
+           {
+            if ((t == 0) &&
+                ((symbolPtr->count == 0) || symbolPtr->neededSymbol))
+              { continue; }
+
+            length = strlen(symbolPtr->contents) + 1;
+            newSymbol = (CLIPSLexeme *) malloc(sizeof(CLIPSLexeme));
+            contents = (char *) malloc(length);
+            if ((newSymbol == NULL) || (contents == NULL))
+              {
+               free(newSymbol);
+               free(contents);
+               FreeSharedAtomBase(theBase);
+               return NULL;
+              }
+
+            memcpy(contents,symbolPtr->contents,length);
+            *newSymbol = *symbolPtr;
+            newSymbol->contents = contents;
+            newSymbol->count = 0;
+            newSymbol->permanent = true;
+            newSymbol->markedEphemeral = false;
+            newSymbol->neededSymbol = false;
+            newSymbol->bucket = (unsigned int) i;
+            newSymbol->next = theBase->SymbolTable[i];
+            theBase->SymbolTable[i] = newSymbol;
+            theBase->atomCount++;
+           }
+        }
+
+      for (i = 0; i < FLOAT_HASH_SIZE; i++)
+        {
+         for (floatPtr = floatTables[t][i]; floatPtr != NULL; floatPtr = floatPtr->next)
+           {
+            if ((t == 0) && (floatPtr->count == 0)) continue;
+
+            if ((newFloat = (CLIPSFloat *) malloc(sizeof(CLIPSFloat))) == NULL)
+              {
+               FreeSharedAtomBase(theBase);
+               return NULL;
+              }
+
+            *newFloat = *floatPtr;
+            newFloat->count = 0;
+            newFloat->permanent = true;
+            newFloat->markedEphemeral = false;
+            newFloat->neededFloat = false;
+            newFloat->bucket = (unsigned int) i;
+            newFloat->next = theBase->FloatTable[i];
+            theBase->FloatTable[i] = newFloat;
+            theBase->atomCount++;
+           }
+        }
+
+      for (i = 0; i < INTEGER_HASH_SIZE; i++)
+        {
+         for (integerPtr = integerTables[t][i]; integerPtr != NULL; integerPtr = integerPtr->next)
+           {
+            if ((t == 0) && (integerPtr->count == 0)) continue;
+
+            if ((newInteger = (CLIPSInteger *) malloc(sizeof(CLIPSInteger))) == NULL)
+              {
+               FreeSharedAtomBase(theBase);
+               return NULL;
+              }
+
+            *newInteger = *integerPtr;
+            newInteger->count = 0;
+            newInteger->permanent = true;
+            newInteger->markedEphemeral = false;
+            newInteger->neededInteger = false;
+            newInteger->bucket = (unsigned int) i;
+            newInteger->next = theBase->IntegerTable[i];
+            theBase->IntegerTable[i] = newInteger;
+            theBase->atomCount++;
+           }
+        }
+
+      for (i = 0; i < BITMAP_HASH_SIZE; i++)
+        {
+         for (bitMapPtr = bitMapTables[t][i]; bitMapPtr != NULL; bitMapPtr = bitMapPtr->next)
+           {
+            if ((t == 0) && (bitMapPtr->count == 0)) continue;
+
+            newBitMap = (CLIPSBitMap *) malloc(sizeof(CLIPSBitMap));
+            contents = (char *) malloc(bitMapPtr->size);
+            if ((newBitMap == NULL) || (contents == NULL))
+              {
+               free(newBitMap);
+               free(contents);
+               FreeSharedAtomBase(theBase);
+               return NULL;
+              }
+
+            memcpy(contents,bitMapPtr->contents,bitMapPtr->size);
+            *newBitMap = *bitMapPtr;
+            newBitMap->contents = contents;
+            newBitMap->count = 0;
+            newBitMap->permanent = true;
+            newBitMap->markedEphemeral = false;
+            newBitMap->neededBitMap = false;
+            newBitMap->bucket = (unsigned int) i;
+            newBitMap->next = theBase->BitMapTable[i];
+            theBase->BitMapTable[i] = newBitMap;
+            theBase->atomCount++;
+           }
+        }
+     }
+
+   MarkConstructNames(theEnv,false);
+
+   return theBase;
+  }
+
+/*************************************************************/
+/* MarkConstructNames: Sets (or clears) the needed flag of   */
+/*   the module and construct names of an environment. Names */
+/*   found in a shared base of the environment are skipped,  */
+/*   since they can't be written to.                         */
+/*************************************************************/
+static void MarkConstructNames(
+  Environment *theEnv,
+  bool value)
+  {
+   Defmodule *theModule;
+   Construct *constructClass;
+   ConstructHeader *theConstruct;
+   CLIPSLexeme *theName;
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      if (! theModule->header.name->permanent)
+        { theModule->header.name->neededSymbol = value; }
+
+      SetCurrentModule(theEnv,theModule);
+
+      for (constructClass = ConstructData(theEnv)->ListOfConstructs;
+           constructClass != NULL;
+           constructClass = constructClass->next)
+        {
+         if ((constructClass->getNextItemFunction == NULL) ||
+             (constructClass->getConstructNameFunction == NULL))
+           { continue; }
+
+         for (theConstruct = (*constructClass->getNextItemFunction)(theEnv,NULL);
+              theConstruct != NULL;
+              theConstruct = (*constructClass->getNextItemFunction)(theEnv,theConstruct))
+           {
+            theName = (*constructClass->getConstructNameFunction)(theConstruct);
+            if (! theName->permanent)
+              { theName->neededSymbol = value; }
+           }
+        }
+     }
+
+   RestoreCurrentModule(theEnv);
+  }
+
+/***********************************************************/
+/* DestroySharedAtomBase: Frees a base layer of atoms. The */
+/*   environments created with it must be destroyed first. */
+/***********************************************************/
+void DestroySharedAtomBase(
+  SharedAtomBase *theBase)
+  {
+   if (theBase == NULL) return;
+
+   FreeSharedAtomBase(theBase);
+  }
+
+/*****************************************************/
+/* FreeSharedAtomBase: Frees the atoms and the hash  */
+/*   tables of a base layer, including one which was */
+/*   only partially built.                           */
+/*****************************************************/
+static void FreeSharedAtomBase(
+  SharedAtomBase *theBase)
+  {
+   unsigned long i;
+   CLIPSLexeme *symbolPtr, *nextSymbol;
+   CLIPSFloat *floatPtr, *nextFloat;
+   CLIPSInteger *integerPtr, *nextInteger;
+   CLIPSBitMap *bitMapPtr, *nextBitMap;
+
+   if (theBase->SymbolTable != NULL)
+     {
+      for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+        {
+         for (symbolPtr = theBase->SymbolTable[i]; symbolPtr != NULL; symbolPtr = nextSymbol)
+           {
+            nextSymbol = symbolPtr->next;
+            free((void *) symbolPtr->contents);
+            free(symbolPtr);
+           }
+        }
+      free(theBase->SymbolTable);
+     }
+
+   if (theBase->FloatTable != NULL)
+     {
+      for (i = 0; i < FLOAT_HASH_SIZE; i++)
+        {
+         for (floatPtr = theBase->FloatTable[i]; floatPtr != NULL; floatPtr = nextFloat)
+           {
+            nextFloat = floatPtr->next;
+            free(floatPtr);
+           }
+        }
+      free(theBase->FloatTable);
+     }
+
+   if (theBase->IntegerTable != NULL)
+     {
+      for (i = 0; i < INTEGER_HASH_SIZE; i++)
+        {
+         for (integerPtr = theBase->IntegerTable[i]; integerPtr != NULL; integerPtr = nextInteger)
+           {
+            nextInteger = integerPtr->next;
+            free(integerPtr);
+           }
+        }
+      free(theBase->IntegerTable);
+     }
+
+   if (theBase->BitMapTable != NULL)
+     {
+      for (i = 0; i < BITMAP_HASH_SIZE; i++)
+        {
+         for (bitMapPtr = theBase->BitMapTable[i]; bitMapPtr != NULL; bitMapPtr = nextBitMap)
+           {
+            nextBitMap = bitMapPtr->next;
+            free((void *) bitMapPtr->contents);
+            free(bitMapPtr);
+           }
+        }
+      free(theBase->BitMapTable);
+     }
+
+   free(theBase);
+  }
+
+/************************************************************/
+/* SharedAtomBaseError: Prints an error message and returns */
+/*   true if the environment uses a shared base layer of    */
+/*   atoms. Binary saves and the constructs compiler mark   */
+/*   and renumber the atoms in place, which can't be done   */
+/*   to atoms other environments are reading.               */
+/************************************************************/
+bool SharedAtomBaseError(
+  Environment *theEnv,
+  const char *functionName)
+  {
+   if (SymbolData(theEnv)->SharedBase == NULL)
+     { return false; }
+
+   PrintErrorID(theEnv,"SYMBOL",1,false);
+   WriteString(theEnv,STDERR,"Function '");
+   WriteString(theEnv,STDERR,functionName);
+   WriteString(theEnv,STDERR,"' can't be used in an environment sharing a base layer of atoms.\n");
+   return true;
+  }
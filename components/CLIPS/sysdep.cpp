@@ -141,6 +141,7 @@
 #include <stdarg.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdint.h>
 
 #if MAC_XCD
 #include <sys/time.h>
@@ -167,6 +168,19 @@
 #include <unistd.h>
 #endif
 
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#endif
+
+#if   (UNIX_V || LINUX || DARWIN || MAC_XCD) && (! defined(ESP_PLATFORM))
+#define MAPPED_BINARY_FILES 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#define MAPPED_BINARY_FILES 0
+#endif
+
 #include "envrnmnt.h"
 #include "memalloc.h"
 #include "sysdep.h"
@@ -188,6 +202,10 @@ struct systemDependentData
 #if (! WIN_MVC)
    FILE *BinaryFP;
 #endif
+   const char *BinaryImage;
+   size_t BinaryImageSize;
+   size_t BinaryImagePosition;
+   bool BinaryImageMapped;
    int (*BeforeOpenFunction)(Environment *);
    int (*AfterOpenFunction)(Environment *);
    jmp_buf *jmpBuffer;
@@ -195,6 +213,14 @@ struct systemDependentData
 
 #define SystemDependentData(theEnv) ((struct systemDependentData *) GetEnvironmentData(theEnv,SYSTEM_DEPENDENT_DATA))
 
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+#if MAPPED_BINARY_FILES
+   static bool                 MapBinaryFile(Environment *,const char *);
+#endif
+
 /********************************************************/
 /* InitializeSystemDependentData: Allocates environment */
 /*    data for system dependent routines.               */
@@ -232,6 +258,25 @@ double gentime(void)
 #endif
   }
 
+/*********************************************************/
+/* genmicrotime: Returns the number of microseconds from */
+/*   a clock which is not changed when the time of day   */
+/*   is set. Used internally for time slicing the run    */
+/*   command and timing rule firings.                    */
+/*********************************************************/
+long long genmicrotime(void)
+  {
+#if defined(ESP_PLATFORM)
+   return (long long) esp_timer_get_time();
+#elif LINUX || DARWIN
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC,&now);
+   return ((long long) now.tv_sec * 1000000LL) + (now.tv_nsec / 1000);
+#else
+   return (long long) (gentime() * 1000000.0);
+#endif
+  }
+
 #if SYSTEM_FUNCTION
 /*****************************************************/
 /* gensystem: Generic routine for passing a string   */
@@ -749,6 +794,22 @@ bool GenOpenReadBinary(
    if (SystemDependentData(theEnv)->BeforeOpenFunction != NULL)
      { (*SystemDependentData(theEnv)->BeforeOpenFunction)(theEnv); }
 
+   /*====================================================*/
+   /* Where supported, the file is mapped into memory so */
+   /* that reads are copies from the image, and tables   */
+   /* read with GenReadBinaryInPlace need no temporary   */
+   /* buffer.                                            */
+   /*====================================================*/
+
+#if MAPPED_BINARY_FILES
+   if (MapBinaryFile(theEnv,fileName))
+     {
+      if (SystemDependentData(theEnv)->AfterOpenFunction != NULL)
+        { (*SystemDependentData(theEnv)->AfterOpenFunction)(theEnv); }
+      return true;
+     }
+#endif
+
 #if WIN_MVC
    SystemDependentData(theEnv)->BinaryFileHandle = _open(fileName,O_RDONLY | O_BINARY);
    if (SystemDependentData(theEnv)->BinaryFileHandle == -1)
@@ -786,7 +847,19 @@ size_t GenReadBinary(
 #if WIN_MVC
    char *tempPtr;
    size_t rv = 0;
+#endif
 
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      if (size > (SystemDependentData(theEnv)->BinaryImageSize - SystemDependentData(theEnv)->BinaryImagePosition))
+        { size = SystemDependentData(theEnv)->BinaryImageSize - SystemDependentData(theEnv)->BinaryImagePosition; }
+
+      memcpy(dataPtr,SystemDependentData(theEnv)->BinaryImage + SystemDependentData(theEnv)->BinaryImagePosition,size);
+      SystemDependentData(theEnv)->BinaryImagePosition += size;
+      return size;
+     }
+
+#if WIN_MVC
    tempPtr = (char *) dataPtr;
    while (size > INT_MAX)
      {
@@ -802,7 +875,7 @@ size_t GenReadBinary(
 #endif
 
 #if (! WIN_MVC)
-   return fread(dataPtr,size,1,SystemDependentData(theEnv)->BinaryFP);
+   return fread(dataPtr,1,size,SystemDependentData(theEnv)->BinaryFP);
 #endif
   }
 
@@ -814,6 +887,12 @@ void GetSeekCurBinary(
   Environment *theEnv,
   long offset)
   {
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      GetSeekSetBinary(theEnv,(long) SystemDependentData(theEnv)->BinaryImagePosition + offset);
+      return;
+     }
+
 #if WIN_MVC
    _lseek(SystemDependentData(theEnv)->BinaryFileHandle,offset,SEEK_CUR);
 #endif
@@ -831,6 +910,17 @@ void GetSeekSetBinary(
   Environment *theEnv,
   long offset)
   {
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      if (offset < 0)
+        { SystemDependentData(theEnv)->BinaryImagePosition = 0; }
+      else if ((size_t) offset > SystemDependentData(theEnv)->BinaryImageSize)
+        { SystemDependentData(theEnv)->BinaryImagePosition = SystemDependentData(theEnv)->BinaryImageSize; }
+      else
+        { SystemDependentData(theEnv)->BinaryImagePosition = (size_t) offset; }
+      return;
+     }
+
 #if WIN_MVC
    _lseek(SystemDependentData(theEnv)->BinaryFileHandle,offset,SEEK_SET);
 #endif
@@ -848,6 +938,12 @@ void GenTellBinary(
   Environment *theEnv,
   long *offset)
   {
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      *offset = (long) SystemDependentData(theEnv)->BinaryImagePosition;
+      return;
+     }
+
 #if WIN_MVC
    *offset = _lseek(SystemDependentData(theEnv)->BinaryFileHandle,0,SEEK_CUR);
 #endif
@@ -867,18 +963,131 @@ void GenCloseBinary(
    if (SystemDependentData(theEnv)->BeforeOpenFunction != NULL)
      { (*SystemDependentData(theEnv)->BeforeOpenFunction)(theEnv); }
 
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+#if MAPPED_BINARY_FILES
+      if (SystemDependentData(theEnv)->BinaryImageMapped)
+        {
+         munmap((void *) SystemDependentData(theEnv)->BinaryImage,
+                SystemDependentData(theEnv)->BinaryImageSize);
+        }
+#endif
+      SystemDependentData(theEnv)->BinaryImage = NULL;
+      SystemDependentData(theEnv)->BinaryImageSize = 0;
+      SystemDependentData(theEnv)->BinaryImagePosition = 0;
+      SystemDependentData(theEnv)->BinaryImageMapped = false;
+     }
+   else
+     {
 #if WIN_MVC
-   _close(SystemDependentData(theEnv)->BinaryFileHandle);
+      _close(SystemDependentData(theEnv)->BinaryFileHandle);
 #endif
 
 #if (! WIN_MVC)
-   fclose(SystemDependentData(theEnv)->BinaryFP);
+      fclose(SystemDependentData(theEnv)->BinaryFP);
 #endif
+     }
 
    if (SystemDependentData(theEnv)->AfterOpenFunction != NULL)
      { (*SystemDependentData(theEnv)->AfterOpenFunction)(theEnv); }
   }
 
+/***********************************************************/
+/* GenOpenReadBinaryImage: Opens a binary image which is   */
+/*   already in memory (for example a flash partition      */
+/*   mapped into the address space) for reading with the   */
+/*   same routines used for binary files. The image must   */
+/*   remain valid until GenCloseBinary is called.          */
+/***********************************************************/
+bool GenOpenReadBinaryImage(
+  Environment *theEnv,
+  const void *theImage,
+  size_t imageSize)
+  {
+   if (theImage == NULL) return false;
+
+   SystemDependentData(theEnv)->BinaryImage = (const char *) theImage;
+   SystemDependentData(theEnv)->BinaryImageSize = imageSize;
+   SystemDependentData(theEnv)->BinaryImagePosition = 0;
+   SystemDependentData(theEnv)->BinaryImageMapped = false;
+
+   return true;
+  }
+
+/************************************************************/
+/* GenReadBinaryInPlace: Returns a pointer to the next size */
+/*   bytes of a binary image in memory and advances past    */
+/*   them without copying. Returns NULL (and does not       */
+/*   advance) if the binary file is not in memory, if fewer */
+/*   than size bytes remain, or if the data is not on the   */
+/*   specified alignment boundary.                          */
+/************************************************************/
+const void *GenReadBinaryInPlace(
+  Environment *theEnv,
+  size_t size,
+  size_t alignment)
+  {
+   const char *thePtr;
+
+   if (SystemDependentData(theEnv)->BinaryImage == NULL)
+     { return NULL; }
+
+   if (size > (SystemDependentData(theEnv)->BinaryImageSize - SystemDependentData(theEnv)->BinaryImagePosition))
+     { return NULL; }
+
+   thePtr = SystemDependentData(theEnv)->BinaryImage + SystemDependentData(theEnv)->BinaryImagePosition;
+
+   if ((alignment > 1) && (((uintptr_t) thePtr % alignment) != 0))
+     { return NULL; }
+
+   SystemDependentData(theEnv)->BinaryImagePosition += size;
+
+   return thePtr;
+  }
+
+#if MAPPED_BINARY_FILES
+
+/**********************************************************/
+/* MapBinaryFile: Maps a binary file read only into       */
+/*   memory. Returns false if the file can't be mapped,   */
+/*   in which case it is read using the stdio functions.  */
+/**********************************************************/
+static bool MapBinaryFile(
+  Environment *theEnv,
+  const char *fileName)
+  {
+   int fd;
+   struct stat fileInfo;
+   void *theImage;
+
+   fd = open(fileName,O_RDONLY);
+   if (fd == -1)
+     { return false; }
+
+   if ((fstat(fd,&fileInfo) != 0) ||
+       (! S_ISREG(fileInfo.st_mode)) ||
+       (fileInfo.st_size <= 0))
+     {
+      close(fd);
+      return false;
+     }
+
+   theImage = mmap(NULL,(size_t) fileInfo.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+   close(fd);
+
+   if (theImage == MAP_FAILED)
+     { return false; }
+
+   SystemDependentData(theEnv)->BinaryImage = (const char *) theImage;
+   SystemDependentData(theEnv)->BinaryImageSize = (size_t) fileInfo.st_size;
+   SystemDependentData(theEnv)->BinaryImagePosition = 0;
+   SystemDependentData(theEnv)->BinaryImageMapped = true;
+
+   return true;
+  }
+
+#endif /* MAPPED_BINARY_FILES */
+
 /***********************************************/
 /* GenWrite: Generic routine for writing to a  */
 /*   file. No machine specific code as of yet. */
@@ -0,0 +1,132 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*               LOAD FACTS CHECK MODULE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Host program which checks that load-facts keeps  */
+/*   the facts read before a syntax error in the middle of   */
+/*   its input, as the serial loader did before facts were   */
+/*   asserted in batches. The syntax error messages printed  */
+/*   while it runs are expected.                             */
+/*                                                           */
+/*   Build and run from this directory with:                 */
+/*                                                           */
+/*     g++ -std=c++11 -DLINUX -I../include ../*.cpp          */
+/*         load_facts_check.cpp -lm -lpthread                */
+/*     ./a.out                                               */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <stdio.h>
+#include <string>
+
+#include "clips.h"
+
+   static long                    CountFacts(Environment *);
+   static bool                    CheckLoad(Environment *,unsigned int,long);
+
+/***********************************************/
+/* main: Loads facts with an error after none  */
+/*   or one fact, a batch less one, a batch, a */
+/*   batch plus one and several batches of     */
+/*   facts, with one and with several threads. */
+/***********************************************/
+int main()
+  {
+   Environment *theEnv;
+   long sizes[] = { 0, 1, 63, 64, 65, 200, 1000 };
+   unsigned int threads[] = { 1, 4 };
+   size_t i, j;
+   int failures = 0;
+
+   theEnv = CreateEnvironment();
+
+   for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+     {
+      for (j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++)
+        {
+         if (! CheckLoad(theEnv,threads[i],sizes[j]))
+           { failures++; }
+        }
+     }
+
+   DestroyEnvironment(theEnv);
+
+   if (failures > 0)
+     {
+      printf("%d load-facts checks failed\n",failures);
+      return 1;
+     }
+
+   printf("load-facts checks passed\n");
+   return 0;
+  }
+
+/************************************************/
+/* CheckLoad: Loads count facts followed by one */
+/*   which has a syntax error and more facts,   */
+/*   then checks that exactly the first count   */
+/*   facts were asserted.                       */
+/************************************************/
+static bool CheckLoad(
+  Environment *theEnv,
+  unsigned int threadCount,
+  long count)
+  {
+   std::string input;
+   long i, loaded, asserted;
+
+   Clear(theEnv);
+#if FACT_BATCH_FUNCTIONS
+   SetFactBatchThreads(theEnv,threadCount);
+#else
+   if (threadCount > 1) return true;
+#endif
+
+   for (i = 0; i < count; i++)
+     { input += "(item " + std::to_string(i) + ")\n"; }
+
+   input += "(= bad)\n";
+
+   for (i = 0; i < 10; i++)
+     { input += "(item " + std::to_string(count + i) + ")\n"; }
+
+   loaded = LoadFactsFromString(theEnv,input.c_str(),input.length());
+   asserted = CountFacts(theEnv);
+
+   if ((loaded == -1) && (asserted == count))
+     { return true; }
+
+   printf("%u threads, error after %ld facts: returned %ld, asserted %ld\n",
+          threadCount,count,loaded,asserted);
+
+   return false;
+  }
+
+/**********************************************/
+/* CountFacts: Returns the number of facts in */
+/*   working memory.                          */
+/**********************************************/
+static long CountFacts(
+  Environment *theEnv)
+  {
+   Fact *theFact;
+   long count = 0;
+
+   for (theFact = GetNextFact(theEnv,NULL);
+        theFact != NULL;
+        theFact = GetNextFact(theEnv,theFact))
+     { count++; }
+
+   return count;
+  }
@@ -0,0 +1,462 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  10/18/26            */
+   /*                                                     */
+   /*            NUMBER CONVERSION CHECK MODULE           */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Host program which compares the number           */
+/*   conversions of numconv with the C library functions     */
+/*   they replace: FormatFloat with printf's "%.15g",        */
+/*   ParseFloat with atof and ParseInteger with strtoll.     */
+/*   Each is checked against edge cases and against random   */
+/*   values drawn from a fixed seed, so failures can be      */
+/*   reproduced. An optional seed and number of random       */
+/*   values can be given as arguments.                       */
+/*                                                           */
+/*   Build and run from this directory with:                 */
+/*                                                           */
+/*     g++ -std=c++11 -DLINUX -I../include ../*.cpp          */
+/*         numconv_check.cpp -lm -lpthread                   */
+/*     ./a.out [seed [count]]                                */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clips.h"
+#include "numconv.h"
+
+#define MAX_REPORTED 10
+
+   static unsigned long long      NextRandom(void);
+   static double                  RandomDouble(void);
+   static bool                    CheckFormatFloat(double);
+   static bool                    CheckParseFloat(const char *);
+   static bool                    CheckParseInteger(const char *);
+   static long                    FormatFloatEdgeCases(void);
+   static long                    ParseFloatEdgeCases(void);
+   static long                    ParseIntegerEdgeCases(void);
+   static long                    FormatFloatRandom(long);
+   static long                    ParseFloatRandom(long);
+   static long                    ParseIntegerRandom(long);
+   static void                    Report(const char *,long);
+
+   static unsigned long long      RandomState = 0x9E3779B97F4A7C15ULL;
+   static long                    Mismatches = 0;
+
+/*************************************************/
+/* main: Runs the edge case and the random value */
+/*   checks of each conversion.                  */
+/*************************************************/
+int main(
+  int argc,
+  char *argv[])
+  {
+   long count = 1000000;
+
+   if (argc > 1)
+     { RandomState = strtoull(argv[1],NULL,10) | 1; }
+   if (argc > 2)
+     { count = atol(argv[2]); }
+
+   Report("FormatFloat edge cases",FormatFloatEdgeCases());
+   Report("FormatFloat random values",FormatFloatRandom(count));
+   Report("ParseFloat edge cases",ParseFloatEdgeCases());
+   Report("ParseFloat random values",ParseFloatRandom(count));
+   Report("ParseInteger edge cases",ParseIntegerEdgeCases());
+   Report("ParseInteger random values",ParseIntegerRandom(count));
+
+   if (Mismatches > 0)
+     {
+      printf("%ld number conversion checks failed\n",Mismatches);
+      return 1;
+     }
+
+   printf("number conversion checks passed\n");
+   return 0;
+  }
+
+/**********************************************/
+/* Report: Prints the number of values tested */
+/*   by one of the checks.                    */
+/**********************************************/
+static void Report(
+  const char *checkName,
+  long tested)
+  {
+   printf("%-28s %ld values\n",checkName,tested);
+  }
+
+/******************************************************/
+/* NextRandom: Returns the next value of an xorshift  */
+/*   generator, the same on every host for one seed.  */
+/******************************************************/
+static unsigned long long NextRandom()
+  {
+   RandomState ^= RandomState << 13;
+   RandomState ^= RandomState >> 7;
+   RandomState ^= RandomState << 17;
+   return RandomState;
+  }
+
+/*****************************************************/
+/* RandomDouble: Returns a finite double with random */
+/*   bits, so that every exponent is as likely.      */
+/*****************************************************/
+static double RandomDouble()
+  {
+   unsigned long long bits;
+   double value;
+
+   do
+     {
+      bits = NextRandom();
+      memcpy(&value,&bits,sizeof(double));
+     }
+   while (! isfinite(value));
+
+   return value;
+  }
+
+/**************************************************/
+/* CheckFormatFloat: Compares FormatFloat with    */
+/*   "%.15g" for one value, including the length. */
+/**************************************************/
+static bool CheckFormatFloat(
+  double value)
+  {
+   char expected[NUMBER_BUFFER_SIZE * 2], actual[NUMBER_BUFFER_SIZE];
+   size_t length;
+
+   snprintf(expected,sizeof(expected),"%.15g",value);
+   length = FormatFloat(value,actual);
+
+   if ((strcmp(expected,actual) == 0) && (length == strlen(expected)))
+     { return true; }
+
+   if (Mismatches++ < MAX_REPORTED)
+     {
+      printf("FormatFloat(%.17g): \"%s\" (length %lu), %%.15g: \"%s\"\n",
+             value,actual,(unsigned long) length,expected);
+     }
+
+   return false;
+  }
+
+/***************************************************/
+/* CheckParseFloat: Compares the bits of the value */
+/*   returned by ParseFloat and by atof.           */
+/***************************************************/
+static bool CheckParseFloat(
+  const char *str)
+  {
+   double expected, actual;
+
+   expected = atof(str);
+   actual = ParseFloat(str);
+
+   if (memcmp(&expected,&actual,sizeof(double)) == 0)
+     { return true; }
+
+   if (Mismatches++ < MAX_REPORTED)
+     { printf("ParseFloat(\"%s\"): %.17g, atof: %.17g\n",str,actual,expected); }
+
+   return false;
+  }
+
+/*********************************************************/
+/* CheckParseInteger: Compares the value and overflow    */
+/*   result of ParseInteger with the value and ERANGE of */
+/*   strtoll.                                            */
+/*********************************************************/
+static bool CheckParseInteger(
+  const char *str)
+  {
+   long long expected, actual;
+   bool expectedOk, actualOk;
+
+   errno = 0;
+   expected = strtoll(str,NULL,10);
+   expectedOk = (errno != ERANGE);
+   actualOk = ParseInteger(str,&actual);
+
+   if ((expected == actual) && (expectedOk == actualOk))
+     { return true; }
+
+   if (Mismatches++ < MAX_REPORTED)
+     {
+      printf("ParseInteger(\"%s\"): %lld (%s), strtoll: %lld (%s)\n",str,
+             actual,actualOk ? "ok" : "overflow",
+             expected,expectedOk ? "ok" : "overflow");
+     }
+
+   return false;
+  }
+
+/*****************************************************/
+/* FormatFloatEdgeCases: Checks zeros, infinities,   */
+/*   NaN, the limits of the fast path and of double, */
+/*   subnormals, powers of two and ten with their    */
+/*   neighbours, and values halfway between two      */
+/*   15 digit results. Returns the count tested.     */
+/*****************************************************/
+static long FormatFloatEdgeCases()
+  {
+   static const double values[] =
+     { 0.0, 1.0, 0.1, 0.2, 0.3, 0.1 + 0.2, 1.0 / 3.0, 2.0 / 3.0, 0.5, 1.5, 2.5,
+       100.0, 1e15, 1e16, 1e17, 123456789012345.0, 1234567890123456.0,
+       999999999999999.0, 9999999999999995.0, 0.000099999999999999995,
+       1e-5, 1e-4, 9.99999999999999e-5, 1e-45, 1e-46, 9e18, 9.3e18, 1e19,
+       4.9e-324, 2.2250738585072014e-308, 2.2250738585072009e-308,
+       DBL_MAX, DBL_MIN, DBL_EPSILON, 9007199254740992.0, 9007199254740993.0,
+       3.141592653589793, 2.718281828459045, 6.02214076e23, 1.602176634e-19 };
+   char buffer[64];
+   long tested = 0;
+   size_t i;
+   int e, d;
+   double value;
+
+   for (i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+     {
+      CheckFormatFloat(values[i]);
+      CheckFormatFloat(-values[i]);
+      CheckFormatFloat(nextafter(values[i],0.0));
+      CheckFormatFloat(nextafter(values[i],HUGE_VAL));
+      tested += 4;
+     }
+
+   CheckFormatFloat(-0.0);
+   CheckFormatFloat(HUGE_VAL);
+   CheckFormatFloat(-HUGE_VAL);
+   CheckFormatFloat(nan(""));
+   tested += 4;
+
+   for (e = -1074; e <= 1023; e++)
+     {
+      value = ldexp(1.0,e);
+      CheckFormatFloat(value);
+      CheckFormatFloat(nextafter(value,0.0));
+      CheckFormatFloat(nextafter(value,HUGE_VAL));
+      tested += 3;
+     }
+
+   for (e = -330; e <= 310; e++)
+     {
+      snprintf(buffer,sizeof(buffer),"1e%d",e);
+      value = strtod(buffer,NULL);
+      CheckFormatFloat(value);
+      CheckFormatFloat(nextafter(value,0.0));
+      CheckFormatFloat(nextafter(value,HUGE_VAL));
+      tested += 3;
+
+      /*==============================================*/
+      /* Values whose 16th digit is a 5 lie as close  */
+      /* as a double gets to a rounding tie.          */
+      /*==============================================*/
+
+      for (d = 1; d <= 9; d++)
+        {
+         snprintf(buffer,sizeof(buffer),"%d.000000000000005e%d",d,e);
+         value = strtod(buffer,NULL);
+         CheckFormatFloat(value);
+         CheckFormatFloat(nextafter(value,0.0));
+         CheckFormatFloat(nextafter(value,HUGE_VAL));
+         snprintf(buffer,sizeof(buffer),"%d.999999999999995e%d",d,e);
+         CheckFormatFloat(strtod(buffer,NULL));
+         tested += 4;
+        }
+     }
+
+   return tested;
+  }
+
+/****************************************************/
+/* FormatFloatRandom: Checks doubles with random    */
+/*   bits, random integers, and random decimals of  */
+/*   up to 17 digits. Returns the count tested.     */
+/****************************************************/
+static long FormatFloatRandom(
+  long count)
+  {
+   char buffer[64];
+   long i;
+
+   for (i = 0; i < count; i++)
+     {
+      CheckFormatFloat(RandomDouble());
+      CheckFormatFloat((double) (long long) (NextRandom() >> (NextRandom() % 64)));
+
+      snprintf(buffer,sizeof(buffer),"%llu.%llue%d",
+               NextRandom() % 100000000ULL,NextRandom() % 1000000000ULL,
+               (int) (NextRandom() % 80) - 50);
+      CheckFormatFloat(strtod(buffer,NULL));
+     }
+
+   return count * 3;
+  }
+
+/***************************************************/
+/* ParseFloatEdgeCases: Checks the forms read by   */
+/*   the scanner at the limits of the exact path:  */
+/*   19 and 20 digits, 2^53, powers of ten 22 and  */
+/*   23, long exponents and leading and trailing   */
+/*   zeros. Returns the count tested.              */
+/***************************************************/
+static long ParseFloatEdgeCases()
+  {
+   static const char *strings[] =
+     { "0.0", "-0.0", "+0.0", "0e0", "1.0", "-1.0", "+1.5", ".5", "5.", "-.5",
+       "0.1", "0.2", "0.3", "1e5", "1E5", "1e+5", "1e-5", "1.5e300", "1e400",
+       "-1e400", "1e-400", "4.9e-324", "2.4703282292062327e-324",
+       "2.2250738585072011e-308", "1.7976931348623157e308", "1.7976931348623159e308",
+       "9007199254740992.0", "9007199254740993.0", "9007199254740994.0",
+       "9007199254740992e1", "9007199254740993e-1", "1e22", "1e23", "1e-22",
+       "1e-23", "123456789e22", "123456789e-22", "1234567890123456789.0",
+       "12345678901234567890.0", "9999999999999999999.0", "1.234567890123456789",
+       "0.000000000000000000000000000001", "100000000000000000000000.0",
+       "00000000000000000000000000001.5", "1.50000000000000000000000000000",
+       "3.141592653589793238462643383279", "2.718281828459045", "1e0000", "1e00022",
+       "1e-00022", "1e10000", "1e-10000", "0e10000", "6.02214076e23",
+       "1.602176634e-19", "0.1e1", "10.0e-1", "1e", "1e+", "-", "." };
+   char buffer[64];
+   long tested = 0;
+   size_t i;
+   int e;
+
+   for (i = 0; i < sizeof(strings) / sizeof(strings[0]); i++)
+     {
+      CheckParseFloat(strings[i]);
+      tested++;
+     }
+
+   for (e = -30; e <= 30; e++)
+     {
+      snprintf(buffer,sizeof(buffer),"1e%d",e);
+      CheckParseFloat(buffer);
+      snprintf(buffer,sizeof(buffer),"9007199254740991e%d",e);
+      CheckParseFloat(buffer);
+      snprintf(buffer,sizeof(buffer),"-123.456e%d",e);
+      CheckParseFloat(buffer);
+      tested += 3;
+     }
+
+   return tested;
+  }
+
+/***************************************************/
+/* ParseFloatRandom: Checks random doubles printed */
+/*   with 17, 15 and 6 significant digits and      */
+/*   random decimal strings with up to 25 digits.  */
+/*   Returns the count tested.                     */
+/***************************************************/
+static long ParseFloatRandom(
+  long count)
+  {
+   char buffer[64];
+   long i;
+   int j, digits, point;
+   double value;
+
+   for (i = 0; i < count; i++)
+     {
+      value = RandomDouble();
+      snprintf(buffer,sizeof(buffer),"%.17g",value);
+      CheckParseFloat(buffer);
+      snprintf(buffer,sizeof(buffer),"%.15g",value);
+      CheckParseFloat(buffer);
+      snprintf(buffer,sizeof(buffer),"%.6e",value);
+      CheckParseFloat(buffer);
+
+      digits = 1 + (int) (NextRandom() % 25);
+      point = (int) (NextRandom() % (unsigned long long) (digits + 1));
+      j = 0;
+      if (NextRandom() % 2)
+        { buffer[j++] = '-'; }
+      for (; digits > 0; digits--)
+        {
+         if (point-- == 0)
+           { buffer[j++] = '.'; }
+         buffer[j++] = (char) ('0' + (NextRandom() % 10));
+        }
+      if (NextRandom() % 2)
+        { j += snprintf(&buffer[j],sizeof(buffer) - (size_t) j,"e%d",(int) (NextRandom() % 61) - 30); }
+      buffer[j] = '\0';
+      CheckParseFloat(buffer);
+     }
+
+   return count * 4;
+  }
+
+/******************************************************/
+/* ParseIntegerEdgeCases: Checks signs, leading zeros */
+/*   and the values around the limits of a long long. */
+/*   Returns the count tested.                        */
+/******************************************************/
+static long ParseIntegerEdgeCases()
+  {
+   static const char *strings[] =
+     { "0", "-0", "+0", "1", "-1", "+1", "000000000000000000000000042",
+       "-000000000000000000000000042", "9223372036854775806", "9223372036854775807",
+       "9223372036854775808", "9223372036854775809", "9223372036854775810",
+       "-9223372036854775807", "-9223372036854775808", "-9223372036854775809",
+       "-9223372036854775810", "18446744073709551615", "18446744073709551616",
+       "-18446744073709551616", "99999999999999999999999999999",
+       "-99999999999999999999999999999", "922337203685477580", "9223372036854775799" };
+   size_t i;
+
+   for (i = 0; i < sizeof(strings) / sizeof(strings[0]); i++)
+     { CheckParseInteger(strings[i]); }
+
+   return (long) (sizeof(strings) / sizeof(strings[0]));
+  }
+
+/****************************************************/
+/* ParseIntegerRandom: Checks random long longs of  */
+/*   every length, with and without a sign, and     */
+/*   random strings of 18 to 21 digits around the   */
+/*   overflow limit. Returns the count tested.      */
+/****************************************************/
+static long ParseIntegerRandom(
+  long count)
+  {
+   char buffer[64];
+   long i;
+   int j, digits;
+   long long value;
+
+   for (i = 0; i < count; i++)
+     {
+      value = (long long) (NextRandom() >> (NextRandom() % 64));
+      if (NextRandom() % 2)
+        { value = -value; }
+      snprintf(buffer,sizeof(buffer),(NextRandom() % 4) ? "%lld" : "%+lld",value);
+      CheckParseInteger(buffer);
+
+      digits = 18 + (int) (NextRandom() % 4);
+      j = 0;
+      if (NextRandom() % 2)
+        { buffer[j++] = '-'; }
+      buffer[j++] = (char) ('1' + (NextRandom() % 9));
+      for (digits--; digits > 0; digits--)
+        { buffer[j++] = (char) ('0' + (NextRandom() % 10)); }
+      buffer[j] = '\0';
+      CheckParseInteger(buffer);
+     }
+
+   return count * 2;
+  }
@@ -283,6 +283,7 @@ static void BsaveBinaryItem(
          AssignBsaveConstructHeaderVals(&tempDeftemplate.header,
                                           &theDeftemplate->header);
          tempDeftemplate.implied = theDeftemplate->implied;
+         tempDeftemplate.slotSpecific = theDeftemplate->slotSpecific;
          tempDeftemplate.numberOfSlots = theDeftemplate->numberOfSlots;
          tempDeftemplate.patternNetwork = BsaveFactPatternIndex(theDeftemplate->patternNetwork);
 
@@ -321,6 +322,7 @@ static void BsaveBinaryItem(
             tempTemplateSlot.noDefault = theSlot->noDefault;
             tempTemplateSlot.defaultPresent = theSlot->defaultPresent;
             tempTemplateSlot.defaultDynamic = theSlot->defaultDynamic;
+            tempTemplateSlot.patternReferenced = theSlot->patternReferenced;
             tempTemplateSlot.defaultList = HashedExpressionIndex(theEnv,theSlot->defaultList);
             tempTemplateSlot.facetList = HashedExpressionIndex(theEnv,theSlot->facetList);
 
@@ -505,6 +507,7 @@ static void UpdateDeftemplate(
    theDeftemplate->watch = FactData(theEnv)->WatchFacts;
 #endif
    theDeftemplate->inScope = false;
+   theDeftemplate->slotSpecific = bdtPtr->slotSpecific;
    theDeftemplate->numberOfSlots = bdtPtr->numberOfSlots;
    theDeftemplate->factList = NULL;
    theDeftemplate->lastFact = NULL;
@@ -535,6 +538,7 @@ static void UpdateDeftemplateSlot(
    theSlot->noDefault = btsPtr->noDefault;
    theSlot->defaultPresent = btsPtr->defaultPresent;
    theSlot->defaultDynamic = btsPtr->defaultDynamic;
+   theSlot->patternReferenced = btsPtr->patternReferenced;
 
    if (btsPtr->next != ULONG_MAX)
      { theSlot->next = (struct templateSlot *) &DeftemplateBinaryData(theEnv)->SlotArray[obji + 1]; }
@@ -83,6 +83,7 @@
 #if CONSTRUCT_COMPILER && (! RUN_TIME)
 #include "tmpltcmp.h"
 #endif
+#include "prntutil.h"
 #include "tmpltdef.h"
 #include "tmpltpsr.h"
 #include "tmpltutl.h"
@@ -107,6 +108,8 @@ void DeftemplateBasicCommands(
    AddUDF(theEnv,"get-deftemplate-list","m",0,1,"y",GetDeftemplateListFunction,"GetDeftemplateListFunction",NULL);
    AddUDF(theEnv,"undeftemplate","v",1,1,"y",UndeftemplateCommand,"UndeftemplateCommand",NULL);
    AddUDF(theEnv,"deftemplate-module","y",1,1,"y",DeftemplateModuleFunction,"DeftemplateModuleFunction",NULL);
+   AddUDF(theEnv,"get-deftemplate-slot-specific","b",1,1,"y",GetDeftemplateSlotSpecificCommand,"GetDeftemplateSlotSpecificCommand",NULL);
+   AddUDF(theEnv,"set-deftemplate-slot-specific","b",2,2,";y;*",SetDeftemplateSlotSpecificCommand,"SetDeftemplateSlotSpecificCommand",NULL);
 
 #if DEBUGGING_FUNCTIONS
    AddUDF(theEnv,"list-deftemplates","v",0,1,"y",ListDeftemplatesCommand,"ListDeftemplatesCommand",NULL);
@@ -211,6 +214,114 @@ void DeftemplateModuleFunction(
    returnValue->value = GetConstructModuleCommand(context,"deftemplate-module",DeftemplateData(theEnv)->DeftemplateConstruct);
   }
 
+/**********************************************************/
+/* GetDeftemplateSlotSpecificCommand: H/L access routine  */
+/*   for the get-deftemplate-slot-specific command.       */
+/**********************************************************/
+void GetDeftemplateSlotSpecificCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *deftemplateName;
+   Deftemplate *theDeftemplate;
+
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+
+   deftemplateName = GetConstructName(context,"get-deftemplate-slot-specific","deftemplate name");
+   if (deftemplateName == NULL) return;
+
+   theDeftemplate = FindDeftemplate(theEnv,deftemplateName);
+   if (theDeftemplate == NULL)
+     {
+      CantFindItemErrorMessage(theEnv,"deftemplate",deftemplateName,true);
+      return;
+     }
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,DeftemplateGetSlotSpecific(theDeftemplate));
+  }
+
+/**********************************************************/
+/* SetDeftemplateSlotSpecificCommand: H/L access routine  */
+/*   for the set-deftemplate-slot-specific command.       */
+/**********************************************************/
+void SetDeftemplateSlotSpecificCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   Deftemplate *theDeftemplate;
+
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+
+   /*=======================================*/
+   /* Get the reference to the deftemplate. */
+   /*=======================================*/
+
+   if (! UDFFirstArgument(context,SYMBOL_BIT,&theArg))
+     { return; }
+
+   theDeftemplate = FindDeftemplate(theEnv,theArg.lexemeValue->contents);
+   if (theDeftemplate == NULL)
+     {
+      CantFindItemErrorMessage(theEnv,"deftemplate",theArg.lexemeValue->contents,true);
+      return;
+     }
+
+   /*===========================================*/
+   /* Ordered facts are never modified in place */
+   /* since the modify command rejects them.    */
+   /*===========================================*/
+
+   if (theDeftemplate->implied)
+     {
+      ExpectedTypeError1(theEnv,"set-deftemplate-slot-specific",1,"deftemplate name");
+      return;
+     }
+
+   /*===========================================================*/
+   /* Return the old value of the flag. If the second argument  */
+   /* evaluated to false, then the flag is cleared, otherwise   */
+   /* it is set.                                                */
+   /*===========================================================*/
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,DeftemplateGetSlotSpecific(theDeftemplate));
+
+   if (! UDFNextArgument(context,ANY_TYPE_BITS,&theArg))
+     { return; }
+
+   DeftemplateSetSlotSpecific(theDeftemplate,theArg.value != FalseSymbol(theEnv));
+  }
+
+/******************************************************/
+/* DeftemplateGetSlotSpecific: C access routine for   */
+/*   retrieving the slot specific flag of a template. */
+/******************************************************/
+bool DeftemplateGetSlotSpecific(
+  Deftemplate *theTemplate)
+  {
+   return theTemplate->slotSpecific;
+  }
+
+/*******************************************************/
+/* DeftemplateSetSlotSpecific: C access routine for    */
+/*   setting the slot specific flag of a template.     */
+/*   When set, a modify that changes only slots which  */
+/*   are not referenced by any pattern updates the     */
+/*   fact in place rather than retracting and then     */
+/*   reasserting it.                                   */
+/*******************************************************/
+void DeftemplateSetSlotSpecific(
+  Deftemplate *theTemplate,
+  bool newState)
+  {
+   if (theTemplate->implied)
+     { return; }
+
+   theTemplate->slotSpecific = newState;
+  }
+
 #if DEBUGGING_FUNCTIONS
 
 /**********************************************/
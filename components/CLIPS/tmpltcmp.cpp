@@ -304,10 +304,12 @@ static void DeftemplateToCode(
 
    /*==========================================*/
    /* Implied Flag, Watch Flag, In Scope Flag, */
-   /* Number of Slots, and Busy Count.         */
+   /* Slot Specific Flag, Number of Slots, and */
+   /* Busy Count.                              */
    /*==========================================*/
 
-   fprintf(theFile,"%d,0,0,%d,%ld,",theTemplate->implied,theTemplate->numberOfSlots,theTemplate->busyCount);
+   fprintf(theFile,"%d,0,0,%d,%d,%ld,",theTemplate->implied,theTemplate->slotSpecific,
+                                       theTemplate->numberOfSlots,theTemplate->busyCount);
 
    /*=================*/
    /* Pattern Network */
@@ -345,12 +347,13 @@ static void SlotToCode(
    fprintf(theFile,"{");
    PrintSymbolReference(theEnv,theFile,theSlot->slotName);
 
-   /*=============================*/
-   /* Multislot and Default Flags */
-   /*=============================*/
+   /*==========================================*/
+   /* Multislot, Default, and Referenced Flags */
+   /*==========================================*/
 
-   fprintf(theFile,",%d,%d,%d,%d,",theSlot->multislot,theSlot->noDefault,
-                                   theSlot->defaultPresent,theSlot->defaultDynamic);
+   fprintf(theFile,",%d,%d,%d,%d,%d,",theSlot->multislot,theSlot->noDefault,
+                                      theSlot->defaultPresent,theSlot->defaultDynamic,
+                                      theSlot->patternReferenced);
 
    /*=============*/
    /* Constraints */
@@ -538,7 +538,7 @@ static void SearchForHashedPatternNodes(
     while (theNode != NULL)
       {
        if ((theNode->lastLevel != NULL) && (theNode->lastLevel->header.selector))
-        { AddHashedPatternNode(theEnv,theNode->lastLevel,theNode,theNode->networkTest->type,theNode->networkTest->value); }
+        { AddHashedPatternNodes(theEnv,theNode->lastLevel,theNode,theNode->networkTest); }
 
        SearchForHashedPatternNodes(theEnv,theNode->nextLevel);
 
@@ -113,8 +113,10 @@
 #include "constant.h"
 #include "cstrnchk.h"
 #include "default.h"
+#include "engine.h"
 #include "envrnmnt.h"
 #include "exprnpsr.h"
+#include "facthsh.h"
 #include "factmngr.h"
 #include "factrhs.h"
 #include "memalloc.h"
@@ -143,6 +145,7 @@
    static CLIPSLexeme            *CheckDeftemplateAndSlotArguments(UDFContext *,Deftemplate **);
    static void                    FreeTemplateValueArray(Environment *,CLIPSValue *,Deftemplate *);
    static struct expr            *ModAndDupParse(Environment *,struct expr *,const char *,const char *);
+   static bool                    ModifyFactInPlace(Environment *,Fact *,CLIPSValue *,char *);
 #if (! RUN_TIME) && (! BLOAD_ONLY)
    static CLIPSLexeme            *FindTemplateForFactAddress(CLIPSLexeme *,struct lhsParseNode *);
 #endif
@@ -548,52 +551,63 @@ Fact *ReplaceFact(
         }
      }
 
-   /*==========================================*/
-   /* Remember the position of the fact before */
-   /* it is retracted so this can be restored  */
-   /* when the modified fact is asserted.      */
-   /*==========================================*/
+   /*===================================================*/
+   /* If none of the changed slots can be seen by the   */
+   /* rule network, then a slot specific fact is simply */
+   /* updated without being retracted and reasserted.   */
+   /*===================================================*/
 
-   factListPosition = oldFact->previousFact;
-   templatePosition = oldFact->previousTemplateFact;
-   
-   /*===================*/
-   /* Retract the fact. */
-   /*===================*/
+   if (ModifyFactInPlace(theEnv,oldFact,theValueArray,changeMap))
+     { theFact = oldFact; }
+   else
+     {
+      /*==========================================*/
+      /* Remember the position of the fact before */
+      /* it is retracted so this can be restored  */
+      /* when the modified fact is asserted.      */
+      /*==========================================*/
 
-   RetractDriver(theEnv,oldFact,true,changeMap);
-   oldFact->garbage = false;
+      factListPosition = oldFact->previousFact;
+      templatePosition = oldFact->previousTemplateFact;
 
-   /*======================================*/
-   /* Copy the new values to the old fact. */
-   /*======================================*/
+      /*===================*/
+      /* Retract the fact. */
+      /*===================*/
 
-   for (i = 0; i < oldFact->theProposition.length; i++)
-     {
-      if (theValueArray[i].voidValue != VoidConstant(theEnv))
+      RetractDriver(theEnv,oldFact,true,changeMap);
+      oldFact->garbage = false;
+
+      /*======================================*/
+      /* Copy the new values to the old fact. */
+      /*======================================*/
+
+      for (i = 0; i < oldFact->theProposition.length; i++)
         {
-         AtomDeinstall(theEnv,oldFact->theProposition.contents[i].header->type,oldFact->theProposition.contents[i].value);
-         
-         if (oldFact->theProposition.contents[i].header->type == MULTIFIELD_TYPE)
+         if (theValueArray[i].voidValue != VoidConstant(theEnv))
            {
-            Multifield *theSegment = oldFact->theProposition.contents[i].multifieldValue;
-            if (theSegment->busyCount == 0)
-              { ReturnMultifield(theEnv,theSegment); }
-            else
-              { AddToMultifieldList(theEnv,theSegment); }
-           }
+            AtomDeinstall(theEnv,oldFact->theProposition.contents[i].header->type,oldFact->theProposition.contents[i].value);
 
-         oldFact->theProposition.contents[i].value = theValueArray[i].value;
-         
-         AtomInstall(theEnv,oldFact->theProposition.contents[i].header->type,oldFact->theProposition.contents[i].value);
+            if (oldFact->theProposition.contents[i].header->type == MULTIFIELD_TYPE)
+              {
+               Multifield *theSegment = oldFact->theProposition.contents[i].multifieldValue;
+               if (theSegment->busyCount == 0)
+                 { ReturnMultifield(theEnv,theSegment); }
+               else
+                 { AddToMultifieldList(theEnv,theSegment); }
+              }
+
+            oldFact->theProposition.contents[i].value = theValueArray[i].value;
+
+            AtomInstall(theEnv,oldFact->theProposition.contents[i].header->type,oldFact->theProposition.contents[i].value);
+           }
         }
-     }
 
-   /*======================*/
-   /* Assert the new fact. */
-   /*======================*/
+      /*======================*/
+      /* Assert the new fact. */
+      /*======================*/
 
-   theFact = AssertDriver(oldFact,oldFact->factIndex,factListPosition,templatePosition,changeMap);
+      theFact = AssertDriver(oldFact,oldFact->factIndex,factListPosition,templatePosition,changeMap);
+     }
 
    /*===============================================*/
    /* Call registered modify notification functions */
@@ -615,6 +629,138 @@ Fact *ReplaceFact(
    return theFact;
   }
 
+/**************************************************************/
+/* ModifyFactInPlace: Replaces the slot values of a fact that */
+/*   belongs to a slot specific deftemplate when none of the  */
+/*   slots being changed are referenced by a pattern. The     */
+/*   fact keeps its fact index, time tag, and partial matches */
+/*   since pattern matching would produce the same results.   */
+/*   Returns false if the fact must be retracted and then     */
+/*   reasserted to apply the change.                          */
+/**************************************************************/
+static bool ModifyFactInPlace(
+  Environment *theEnv,
+  Fact *theFact,
+  CLIPSValue *theValueArray,
+  char *changeMap)
+  {
+   Deftemplate *theTemplate = theFact->whichDeftemplate;
+   struct templateSlot *theSlot;
+   CLIPSValue *theContents = theFact->theProposition.contents;
+   CLIPSValue swapValue;
+   size_t i;
+
+   if ((! theTemplate->slotSpecific) ||
+       (theValueArray == NULL) ||
+       EngineData(theEnv)->JoinOperationInProgress)
+     { return false; }
+
+   /*==============================================*/
+   /* If a slot is referenced by a pattern, then a */
+   /* change to it must go through the network.    */
+   /*==============================================*/
+
+   for (i = 0, theSlot = theTemplate->slotList;
+        theSlot != NULL;
+        i++, theSlot = theSlot->next)
+     {
+      if ((theValueArray[i].voidValue != VoidConstant(theEnv)) &&
+          theSlot->patternReferenced)
+        { return false; }
+     }
+
+   /*==============================================*/
+   /* Remove the fact from the hash table using    */
+   /* its current values and then exchange the new */
+   /* values with the old values.                  */
+   /*==============================================*/
+
+   RemoveHashedFact(theEnv,theFact);
+
+   for (i = 0; i < theFact->theProposition.length; i++)
+     {
+      if (theValueArray[i].voidValue != VoidConstant(theEnv))
+        {
+         swapValue.value = theContents[i].value;
+         theContents[i].value = theValueArray[i].value;
+         theValueArray[i].value = swapValue.value;
+        }
+     }
+
+   /*===================================================*/
+   /* If the modified fact would duplicate an existing  */
+   /* fact, then restore the old values and let the     */
+   /* retract/assert cycle handle the duplication.      */
+   /*===================================================*/
+
+   if (! FactWillBeAsserted(theEnv,theFact))
+     {
+      for (i = 0; i < theFact->theProposition.length; i++)
+        {
+         if (theValueArray[i].voidValue != VoidConstant(theEnv))
+           {
+            swapValue.value = theContents[i].value;
+            theContents[i].value = theValueArray[i].value;
+            theValueArray[i].value = swapValue.value;
+           }
+        }
+
+      AddHashedFact(theEnv,theFact,HashFact(theFact));
+      return false;
+     }
+
+   AddHashedFact(theEnv,theFact,HashFact(theFact));
+
+   /*===================================================*/
+   /* Release the old values and leave the new values   */
+   /* in the value array as the retract/assert cycle    */
+   /* does, since the caller owns the array references. */
+   /*===================================================*/
+
+   for (i = 0; i < theFact->theProposition.length; i++)
+     {
+      if (theValueArray[i].voidValue == VoidConstant(theEnv))
+        { continue; }
+
+      AtomDeinstall(theEnv,theValueArray[i].header->type,theValueArray[i].value);
+
+      if (theValueArray[i].header->type == MULTIFIELD_TYPE)
+        {
+         if (theValueArray[i].multifieldValue->busyCount == 0)
+           { ReturnMultifield(theEnv,theValueArray[i].multifieldValue); }
+         else
+           { AddToMultifieldList(theEnv,theValueArray[i].multifieldValue); }
+        }
+
+      theValueArray[i].value = theContents[i].value;
+      AtomInstall(theEnv,theContents[i].header->type,theContents[i].value);
+     }
+
+   /*=================================*/
+   /* Print the modification if facts */
+   /* are being watched.              */
+   /*=================================*/
+
+#if DEBUGGING_FUNCTIONS
+   if (theTemplate->watch &&
+       (! ConstructData(theEnv)->ClearReadyInProgress) &&
+       (! ConstructData(theEnv)->ClearInProgress))
+     {
+      WriteString(theEnv,STDOUT,"<=> ");
+      PrintFactWithIdentifier(theEnv,STDOUT,theFact,changeMap);
+      WriteString(theEnv,STDOUT,"\n");
+     }
+#endif
+
+   FactData(theEnv)->ChangeToFactList = true;
+   FactData(theEnv)->assertError = AE_NO_ERROR;
+   FactData(theEnv)->retractError = RE_NO_ERROR;
+
+   CheckTemplateFact(theEnv,theFact);
+
+   return true;
+  }
+
 /*******************************************************************/
 /* DuplicateCommand: H/L access routine for the duplicate command. */
 /*******************************************************************/
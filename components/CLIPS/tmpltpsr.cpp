@@ -179,6 +179,7 @@ bool ParseDeftemplate(
    newDeftemplate->busyCount = 0;
    newDeftemplate->watch = 0;
    newDeftemplate->inScope = true;
+   newDeftemplate->slotSpecific = false;
    newDeftemplate->patternNetwork = NULL;
    newDeftemplate->factList = NULL;
    newDeftemplate->lastFact = NULL;
@@ -492,6 +493,7 @@ static struct templateSlot *DefinedSlots(
    newSlot->noDefault = false;
    newSlot->defaultPresent = false;
    newSlot->defaultDynamic = false;
+   newSlot->patternReferenced = false;
    newSlot->next = NULL;
 
    /*========================================*/
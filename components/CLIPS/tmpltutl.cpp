@@ -610,6 +610,7 @@ Deftemplate *CreateImpliedDeftemplate(
    newDeftemplate->implied = setFlag;
    newDeftemplate->numberOfSlots = 0;
    newDeftemplate->inScope = 1;
+   newDeftemplate->slotSpecific = false;
    newDeftemplate->patternNetwork = NULL;
    newDeftemplate->factList = NULL;
    newDeftemplate->lastFact = NULL;
@@ -455,19 +455,12 @@ void MqttPublishFunction(Environment *theEnv, UDFContext *context, UDFValue *ret
 
 bool QueryMqttReplyCallback(Environment *theEnv, const char *logicalName, void *context)
 {
-    if ((strcmp(logicalName, STDOUT) == 0) ||
-        (strcmp(logicalName, STDIN) == 0) ||
-        (strcmp(logicalName, STDERR) == 0) ||
-        (strcmp(logicalName, STDWRN) == 0))
-    {
-        return true;
-    }
-    return false;
+    return LogicalNameID(theEnv, logicalName) <= STDWRN_ID;
 }
 
 void WriteMqttReplyCallback(Environment *theEnv, const char *logicalName, const char *str, void *context)
 {
-    if ((strcmp(logicalName, STDOUT) == 0))
+    if (LogicalNameID(theEnv, logicalName) == STDOUT_ID)
     {
         if (!str || !context || context == nullptr)
         {
@@ -65,35 +65,33 @@ static bool QueryTraceCallback(
     const char *logicalName,
     void *context)
 {
-  if ((strcmp(logicalName, STDOUT) == 0) ||
-      (strcmp(logicalName, STDIN) == 0) ||
-      (strcmp(logicalName, STDERR) == 0) ||
-      (strcmp(logicalName, STDWRN) == 0))
-  {
-    return true;
-  }
-  return false;
+  return LogicalNameID(environment, logicalName) <= STDWRN_ID;
 }
 
-static void WriteTraceCallback(
+// Receives the output of the trace router in bulk (see bufrtr.h). With the
+// drop policy it must not wait for the host, so it only writes what fits in
+// the USB CDC transmit buffer.
+static size_t SerialSinkCallback(
     Environment *environment,
-    const char *logicalName,
-    const char *str,
+    const char *buffer,
+    size_t length,
+    bool mayBlock,
     void *context)
 {
-  if ((strcmp(logicalName, STDOUT) == 0) ||
-      (strcmp(logicalName, STDIN) == 0) ||
-      (strcmp(logicalName, STDERR) == 0) ||
-      (strcmp(logicalName, STDWRN) == 0))
+  if (!mayBlock)
   {
-    if (!str)
+    int room = Serial.availableForWrite();
+    if (room <= 0)
     {
-      ESP_LOGE("WriteTraceCallback", "Error: Null str pointer!");
-      return;
+      return 0;
+    }
+    if ((size_t)room < length)
+    {
+      length = (size_t)room;
     }
-
-    Serial.print(str);
   }
+
+  return Serial.write((const uint8_t *)buffer, length);
 }
 
 void setup()
@@ -136,15 +134,15 @@ void setup()
   // UtilityData(mainEnv)->YieldTimeFunction = yield; // esp32-hal.h
   // EnableYieldFunction(mainEnv, true);
 
-  AddRouter(mainEnv,
-            "trace",            /* Router name */
-            20,                 /* Priority */
-            QueryTraceCallback, /* Query function */
-            WriteTraceCallback, /* Write function */
-            NULL,               /* Read function */
-            NULL,               /* Unread function */
-            NULL,               /* Exit function */
-            NULL);              /* Context */
+  AddBufferedRouter(mainEnv,
+                    "trace",                  /* Router name */
+                    20,                       /* Priority */
+                    QueryTraceCallback,       /* Query function */
+                    SerialSinkCallback,       /* Sink function */
+                    BUFFERED_ROUTER_CAPACITY, /* Buffer size */
+                    BUFFER_BLOCK,             /* Wait for the host */
+                    NULL);                    /* Context */
+  SetAfterPromptFunction(mainEnv, FlushAllBufferedRouters);
 
   ActivateRouter(
       mainEnv,
@@ -170,6 +168,11 @@ void setup()
 
 void loop()
 {
+  if (mainEnv != NULL)
+  {
+    PollBufferedRouters(mainEnv);
+  }
+
   while (Serial.available())
   {
     stringInEdit.store(true);
@@ -198,6 +201,14 @@ void loop()
     ExecuteIfCommandComplete(mainEnv);
     stringInEdit.store(false);
   }
+
+  // A (run-for) which reached its deadline with activations left goes on
+  // firing them one slice per loop, so the serial input and the other tasks
+  // are still served while a long run is in progress.
+  if ((mainEnv != NULL) && RunSlicePending(mainEnv) && !stringInEdit.load())
+  {
+    RunFor(mainEnv, RUN_SLICE_MICROSECONDS);
+  }
 }
 
 void ArduninoInitFunction(Environment *theEnv, void *context)
@@ -33,6 +33,9 @@
 #include "clips.h"
 #include "UUID.h"
 
+// Time given to each slice of a (run-for) continued by loop().
+#define RUN_SLICE_MICROSECONDS 20000
+
 extern std::atomic<bool> stringInEdit;
 extern Environment *mainEnv;
 extern UUID uuid;